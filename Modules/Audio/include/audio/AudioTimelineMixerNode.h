@@ -148,7 +148,7 @@ public:
     /// @param requestedTimelineEndFrame
     /// 谱面物件决定的排除结束帧；最终结束帧还会
     ///        自动包含所有片段的实际结束位置。
-    /// @param maximumProcessFrames 回调内单次缓存读取的最大帧数。
+    /// @param maximumProcessFrames 回调内单次混音分段的最大帧数。
     /// @param keySoundControls 生命周期覆盖本节点的运行时 Key 音控制库。
     AudioTimelineMixerNode(
         std::vector<PreparedTimelineClip> clips,
@@ -166,7 +166,7 @@ public:
     /// @brief 在非实时线程准备并发布一份新的不可变调度状态。
     /// @param clips 已完整缓存的新片段。
     /// @param requestedTimelineEndFrame 谱面物件决定的排除结束帧。
-    /// @param maximumProcessFrames 回调内单次缓存读取的最大帧数。
+    /// @param maximumProcessFrames 回调内单次混音分段的最大帧数。
     /// @return 本次发布的单调调度代次。
     /// @warning
     /// 低频控制路径：允许分配和排序；音频线程只在下一个 block
@@ -301,7 +301,7 @@ private:
         /// @brief 构造已排序片段对应的预分配调度状态。
         /// @param preparedClips 已完成过滤和排序的片段。
         /// @param requestedTimelineEndFrame 谱面物件决定的排除结束帧。
-        /// @param maximumProcessFrames 单次缓存读取最大帧数。
+        /// @param maximumProcessFrames 单次混音分段最大帧数。
         /// @param scheduleGeneration 当前调度在节点内的单调代次。
         ScheduleState(std::vector<PreparedTimelineClip> preparedClips,
                       AudioTimelineFrame requestedTimelineEndFrame,
@@ -316,10 +316,8 @@ private:
         std::uint64_t generation{ 0U };
         /// @brief 谱面和采样共同决定的排除结束帧。
         AudioTimelineFrame timelineEndFrame{ 0 };
-        /// @brief 单次缓存读取允许的最大帧数。
+        /// @brief 单次混音分段允许的最大帧数。
         std::size_t maximumProcessFrames{ 1U };
-        /// @brief 回调外预分配的音频源读取缓存。
-        ice::AudioBuffer sourceScratch;
         /// @brief 回调外预分配的活跃片段结果缓存。
         std::vector<AudioTimelineActiveSpan> activeSpanScratch;
         /// @brief 音频线程退役栈中的下一个状态。
@@ -384,8 +382,8 @@ private:
     /// @brief 混合当前位置起始且不跨越循环或结束边界的一段输出。
     /// @param output 输出缓冲区。
     /// @param outputStartFrame 输出缓冲区内的起始偏移。
-    /// @param frameCount 本段帧数，必须不超过预分配缓存容量。
-    /// @warning 音频热路径；只读取完整缓存并写入预分配内存。
+    /// @param frameCount 本段帧数，必须不超过单次混音分段上限。
+    /// @warning 音频热路径；直接从完整缓存向量化累加到输出缓冲。
     void mixSegment(ice::AudioBuffer& output, std::size_t outputStartFrame,
                     std::size_t frameCount);
 
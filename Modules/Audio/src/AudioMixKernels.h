@@ -0,0 +1,405 @@
+#pragma once
+
+#include <algorithm>
+#include <cmath>
+#include <cstddef>
+#include <string_view>
+
+#if defined(__SSE2__) || defined(_M_X64) || \
+    (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#    include <immintrin.h>
+#    if defined(_MSC_VER)
+#        include <intrin.h>
+#    endif
+#    define MMM_AUDIO_MIX_X86 1
+#elif defined(__ARM_NEON) || defined(_M_ARM64)
+#    include <arm_neon.h>
+#    define MMM_AUDIO_MIX_NEON 1
+#endif
+
+/// @brief AVX 内核的函数属性：GCC/Clang 只为这些函数生成 AVX 指令，其余
+/// 代码仍按基线指令集编译；MSVC 无需额外属性即可使用 AVX 内建函数。
+#if defined(MMM_AUDIO_MIX_X86) && !defined(_MSC_VER)
+#    define MMM_AUDIO_MIX_AVX_TARGET __attribute__((target("avx")))
+#else
+#    define MMM_AUDIO_MIX_AVX_TARGET
+#endif
+
+/// @brief 时间线混音热路径使用的向量化 PCM 内核。
+///
+/// x86 上 SSE2 为基线，AVX 在进程启动时按 CPU 与操作系统支持检测后启用
+/// （以 -mavx 等编译时已保证 AVX 的目标直接使用 AVX）；ARM64 使用 NEON，
+/// 其余平台退回标量实现。所有内核只读写调用方给定的区间，不分配内存。
+namespace MMM::Audio::MixKernels
+{
+
+/// @brief 内核使用的指令集。
+/// @details SCALAR 必须为零值：静态初始化完成前读取到的零值安全地退回
+/// 标量实现。
+enum class KernelIsa { SCALAR = 0, SSE2, AVX, NEON };
+
+namespace Detail
+{
+
+#if defined(MMM_AUDIO_MIX_X86) && defined(_MSC_VER) && !defined(__AVX__)
+/// @brief 读取 XCR0，确认操作系统会保存 YMM 寄存器。
+#    if defined(__clang__)
+__attribute__((target("xsave")))
+#    endif
+inline unsigned long long readXcr0() noexcept
+{
+    return _xgetbv(0);
+}
+#endif
+
+/// @brief 检测当前进程可用的最优内核指令集。
+inline KernelIsa detectIsa() noexcept
+{
+#if defined(MMM_AUDIO_MIX_X86)
+#    if defined(__AVX__)
+    return KernelIsa::AVX;
+#    elif defined(_MSC_VER)
+    int info[4] = {};
+    __cpuid(info, 1);
+    const bool osxsave = (info[2] & (1 << 27)) != 0;
+    const bool avx     = (info[2] & (1 << 28)) != 0;
+    return osxsave && avx && (readXcr0() & 0x6U) == 0x6U ? KernelIsa::AVX
+                                                         : KernelIsa::SSE2;
+#    else
+    // 可能在其他静态初始化期间调用，需先初始化 CPU 信息。
+    __builtin_cpu_init();
+    return __builtin_cpu_supports("avx") ? KernelIsa::AVX : KernelIsa::SSE2;
+#    endif
+#elif defined(MMM_AUDIO_MIX_NEON)
+    return KernelIsa::NEON;
+#else
+    return KernelIsa::SCALAR;
+#endif
+}
+
+inline void mixScaledScalar(float* destination, const float* source,
+                            std::size_t frame, std::size_t frameCount,
+                            float gain) noexcept
+{
+    for ( ; frame < frameCount; ++frame ) {
+        destination[frame] += source[frame] * gain;
+    }
+}
+
+inline void mixScaledStereoScalar(float* left, float* right,
+                                  const float* leftSource,
+                                  const float* rightSource, std::size_t frame,
+                                  std::size_t frameCount, float gain) noexcept
+{
+    for ( ; frame < frameCount; ++frame ) {
+        left[frame] += leftSource[frame] * gain;
+        right[frame] += rightSource[frame] * gain;
+    }
+}
+
+inline float applyGainAndPeakScalar(float* data, std::size_t frame,
+                                    std::size_t frameCount, float gain,
+                                    float peak) noexcept
+{
+    for ( ; frame < frameCount; ++frame ) {
+        data[frame] *= gain;
+        peak = std::max(peak, std::abs(data[frame]));
+    }
+    return peak;
+}
+
+#if defined(MMM_AUDIO_MIX_X86)
+MMM_AUDIO_MIX_AVX_TARGET inline void mixScaledAvx(
+    float* destination, const float* source, std::size_t frameCount,
+    float gain) noexcept
+{
+    std::size_t  frame = 0U;
+    const __m256 gain8 = _mm256_set1_ps(gain);
+    for ( ; frame + 8U <= frameCount; frame += 8U ) {
+        const __m256 scaled =
+            _mm256_mul_ps(_mm256_loadu_ps(source + frame), gain8);
+        _mm256_storeu_ps(
+            destination + frame,
+            _mm256_add_ps(_mm256_loadu_ps(destination + frame), scaled));
+    }
+    mixScaledScalar(destination, source, frame, frameCount, gain);
+}
+
+inline void mixScaledSse2(float* destination, const float* source,
+                          std::size_t frameCount, float gain) noexcept
+{
+    std::size_t  frame = 0U;
+    const __m128 gain4 = _mm_set1_ps(gain);
+    for ( ; frame + 4U <= frameCount; frame += 4U ) {
+        const __m128 scaled = _mm_mul_ps(_mm_loadu_ps(source + frame), gain4);
+        _mm_storeu_ps(destination + frame,
+                      _mm_add_ps(_mm_loadu_ps(destination + frame), scaled));
+    }
+    mixScaledScalar(destination, source, frame, frameCount, gain);
+}
+
+MMM_AUDIO_MIX_AVX_TARGET inline void mixScaledStereoAvx(
+    float* left, float* right, const float* leftSource,
+    const float* rightSource, std::size_t frameCount, float gain) noexcept
+{
+    std::size_t  frame = 0U;
+    const __m256 gain8 = _mm256_set1_ps(gain);
+    for ( ; frame + 8U <= frameCount; frame += 8U ) {
+        const __m256 leftScaled =
+            _mm256_mul_ps(_mm256_loadu_ps(leftSource + frame), gain8);
+        const __m256 rightScaled =
+            _mm256_mul_ps(_mm256_loadu_ps(rightSource + frame), gain8);
+        _mm256_storeu_ps(
+            left + frame,
+            _mm256_add_ps(_mm256_loadu_ps(left + frame), leftScaled));
+        _mm256_storeu_ps(
+            right + frame,
+            _mm256_add_ps(_mm256_loadu_ps(right + frame), rightScaled));
+    }
+    mixScaledStereoScalar(
+        left, right, leftSource, rightSource, frame, frameCount, gain);
+}
+
+inline void mixScaledStereoSse2(float* left, float* right,
+                                const float* leftSource,
+                                const float* rightSource,
+                                std::size_t frameCount, float gain) noexcept
+{
+    std::size_t  frame = 0U;
+    const __m128 gain4 = _mm_set1_ps(gain);
+    for ( ; frame + 4U <= frameCount; frame += 4U ) {
+        const __m128 leftScaled =
+            _mm_mul_ps(_mm_loadu_ps(leftSource + frame), gain4);
+        const __m128 rightScaled =
+            _mm_mul_ps(_mm_loadu_ps(rightSource + frame), gain4);
+        _mm_storeu_ps(left + frame,
+                      _mm_add_ps(_mm_loadu_ps(left + frame), leftScaled));
+        _mm_storeu_ps(right + frame,
+                      _mm_add_ps(_mm_loadu_ps(right + frame), rightScaled));
+    }
+    mixScaledStereoScalar(
+        left, right, leftSource, rightSource, frame, frameCount, gain);
+}
+
+MMM_AUDIO_MIX_AVX_TARGET inline float applyGainAndPeakAvx(
+    float* data, std::size_t frameCount, float gain) noexcept
+{
+    std::size_t  frame    = 0U;
+    const __m256 gain8    = _mm256_set1_ps(gain);
+    const __m256 signMask = _mm256_set1_ps(-0.0F);
+    __m256       peak8    = _mm256_setzero_ps();
+    for ( ; frame + 8U <= frameCount; frame += 8U ) {
+        const __m256 scaled =
+            _mm256_mul_ps(_mm256_loadu_ps(data + frame), gain8);
+        _mm256_storeu_ps(data + frame, scaled);
+        peak8 = _mm256_max_ps(peak8, _mm256_andnot_ps(signMask, scaled));
+    }
+    __m128 peak4 = _mm_max_ps(_mm256_castps256_ps128(peak8),
+                              _mm256_extractf128_ps(peak8, 1));
+    peak4        = _mm_max_ps(peak4, _mm_movehl_ps(peak4, peak4));
+    peak4        = _mm_max_ss(peak4, _mm_shuffle_ps(peak4, peak4, 1));
+    return applyGainAndPeakScalar(
+        data, frame, frameCount, gain, _mm_cvtss_f32(peak4));
+}
+
+inline float applyGainAndPeakSse2(float* data, std::size_t frameCount,
+                                  float gain) noexcept
+{
+    std::size_t  frame    = 0U;
+    const __m128 gain4    = _mm_set1_ps(gain);
+    const __m128 signMask = _mm_set1_ps(-0.0F);
+    __m128       peak4    = _mm_setzero_ps();
+    for ( ; frame + 4U <= frameCount; frame += 4U ) {
+        const __m128 scaled = _mm_mul_ps(_mm_loadu_ps(data + frame), gain4);
+        _mm_storeu_ps(data + frame, scaled);
+        peak4 = _mm_max_ps(peak4, _mm_andnot_ps(signMask, scaled));
+    }
+    peak4 = _mm_max_ps(peak4, _mm_movehl_ps(peak4, peak4));
+    peak4 = _mm_max_ss(peak4, _mm_shuffle_ps(peak4, peak4, 1));
+    return applyGainAndPeakScalar(
+        data, frame, frameCount, gain, _mm_cvtss_f32(peak4));
+}
+#endif
+
+#if defined(MMM_AUDIO_MIX_NEON)
+inline void mixScaledNeon(float* destination, const float* source,
+                          std::size_t frameCount, float gain) noexcept
+{
+    std::size_t       frame = 0U;
+    const float32x4_t gain4 = vdupq_n_f32(gain);
+    for ( ; frame + 4U <= frameCount; frame += 4U ) {
+        vst1q_f32(destination + frame,
+                  vmlaq_f32(vld1q_f32(destination + frame),
+                            vld1q_f32(source + frame),
+                            gain4));
+    }
+    mixScaledScalar(destination, source, frame, frameCount, gain);
+}
+
+inline void mixScaledStereoNeon(float* left, float* right,
+                                const float* leftSource,
+                                const float* rightSource,
+                                std::size_t frameCount, float gain) noexcept
+{
+    std::size_t       frame = 0U;
+    const float32x4_t gain4 = vdupq_n_f32(gain);
+    for ( ; frame + 4U <= frameCount; frame += 4U ) {
+        vst1q_f32(left + frame,
+                  vmlaq_f32(vld1q_f32(left + frame),
+                            vld1q_f32(leftSource + frame),
+                            gain4));
+        vst1q_f32(right + frame,
+                  vmlaq_f32(vld1q_f32(right + frame),
+                            vld1q_f32(rightSource + frame),
+                            gain4));
+    }
+    mixScaledStereoScalar(
+        left, right, leftSource, rightSource, frame, frameCount, gain);
+}
+
+inline float applyGainAndPeakNeon(float* data, std::size_t frameCount,
+                                  float gain) noexcept
+{
+    std::size_t       frame = 0U;
+    const float32x4_t gain4 = vdupq_n_f32(gain);
+    float32x4_t       peak4 = vdupq_n_f32(0.0F);
+    for ( ; frame + 4U <= frameCount; frame += 4U ) {
+        const float32x4_t scaled = vmulq_f32(vld1q_f32(data + frame), gain4);
+        vst1q_f32(data + frame, scaled);
+        peak4 = vmaxq_f32(peak4, vabsq_f32(scaled));
+    }
+    float32x2_t peak2 = vpmax_f32(vget_low_f32(peak4), vget_high_f32(peak4));
+    peak2             = vpmax_f32(peak2, peak2);
+    return applyGainAndPeakScalar(
+        data, frame, frameCount, gain, vget_lane_f32(peak2, 0));
+}
+#endif
+
+}  // namespace Detail
+
+/// @brief 进程启动时检测一次的当前内核指令集；音频回调中只读取该值。
+inline const KernelIsa ACTIVE_ISA = Detail::detectIsa();
+
+/// @brief 指令集名称，供基准与日志输出。
+[[nodiscard]] constexpr std::string_view kernelName(KernelIsa isa) noexcept
+{
+    switch ( isa ) {
+    case KernelIsa::SSE2: return "sse2";
+    case KernelIsa::AVX: return "avx";
+    case KernelIsa::NEON: return "neon";
+    case KernelIsa::SCALAR: break;
+    }
+    return "scalar";
+}
+
+/// @brief 当前进程能否执行该指令集的内核。
+[[nodiscard]] inline bool isSupported(KernelIsa isa) noexcept
+{
+    switch ( isa ) {
+    case KernelIsa::SCALAR: return true;
+#if defined(MMM_AUDIO_MIX_X86)
+    case KernelIsa::SSE2: return true;
+    case KernelIsa::AVX: return ACTIVE_ISA == KernelIsa::AVX;
+#elif defined(MMM_AUDIO_MIX_NEON)
+    case KernelIsa::NEON: return true;
+#endif
+    default: return false;
+    }
+}
+
+/// @brief 将源区间乘以增益后累加到目标区间。
+/// @param destination 目标 PCM，长度至少为 frameCount。
+/// @param source 源 PCM，长度至少为 frameCount，不得与目标部分重叠。
+/// @param frameCount 处理帧数。
+/// @param gain 线性增益。
+/// @param isa 使用的指令集，必须满足 isSupported(isa)。
+/// @warning 音频回调热路径；禁止加入分配、锁或日志。
+inline void mixScaled(float* destination, const float* source,
+                      std::size_t frameCount, float gain,
+                      KernelIsa isa = ACTIVE_ISA) noexcept
+{
+    switch ( isa ) {
+#if defined(MMM_AUDIO_MIX_X86)
+    case KernelIsa::AVX:
+        Detail::mixScaledAvx(destination, source, frameCount, gain);
+        return;
+    case KernelIsa::SSE2:
+        Detail::mixScaledSse2(destination, source, frameCount, gain);
+        return;
+#elif defined(MMM_AUDIO_MIX_NEON)
+    case KernelIsa::NEON:
+        Detail::mixScaledNeon(destination, source, frameCount, gain);
+        return;
+#endif
+    default:
+        Detail::mixScaledScalar(destination, source, 0U, frameCount, gain);
+        return;
+    }
+}
+
+/// @brief 在同一遍循环内把两个源区间分别累加到两个目标声道。
+///
+/// 单声道源扩展到双声道时两个源指针相同，只需一次读取即可写入两个声道。
+/// @param left 左声道目标 PCM。
+/// @param right 右声道目标 PCM。
+/// @param leftSource 左声道源 PCM。
+/// @param rightSource 右声道源 PCM，可与 leftSource 相同。
+/// @param frameCount 处理帧数。
+/// @param gain 线性增益。
+/// @param isa 使用的指令集，必须满足 isSupported(isa)。
+/// @warning 音频回调热路径；禁止加入分配、锁或日志。
+inline void mixScaledStereo(float* left, float* right,
+                            const float* leftSource, const float* rightSource,
+                            std::size_t frameCount, float gain,
+                            KernelIsa isa = ACTIVE_ISA) noexcept
+{
+    switch ( isa ) {
+#if defined(MMM_AUDIO_MIX_X86)
+    case KernelIsa::AVX:
+        Detail::mixScaledStereoAvx(
+            left, right, leftSource, rightSource, frameCount, gain);
+        return;
+    case KernelIsa::SSE2:
+        Detail::mixScaledStereoSse2(
+            left, right, leftSource, rightSource, frameCount, gain);
+        return;
+#elif defined(MMM_AUDIO_MIX_NEON)
+    case KernelIsa::NEON:
+        Detail::mixScaledStereoNeon(
+            left, right, leftSource, rightSource, frameCount, gain);
+        return;
+#endif
+    default:
+        Detail::mixScaledStereoScalar(
+            left, right, leftSource, rightSource, 0U, frameCount, gain);
+        return;
+    }
+}
+
+/// @brief 原地应用增益并返回处理后的绝对值峰值。
+/// @param data 被处理的 PCM。
+/// @param frameCount 处理帧数。
+/// @param gain 线性增益。
+/// @param isa 使用的指令集，必须满足 isSupported(isa)。
+/// @return 处理后样本绝对值的最大值；空区间返回 0。
+/// @warning 音频回调热路径；禁止加入分配、锁或日志。
+[[nodiscard]] inline float applyGainAndPeak(float* data, std::size_t frameCount,
+                                            float     gain,
+                                            KernelIsa isa = ACTIVE_ISA) noexcept
+{
+    switch ( isa ) {
+#if defined(MMM_AUDIO_MIX_X86)
+    case KernelIsa::AVX:
+        return Detail::applyGainAndPeakAvx(data, frameCount, gain);
+    case KernelIsa::SSE2:
+        return Detail::applyGainAndPeakSse2(data, frameCount, gain);
+#elif defined(MMM_AUDIO_MIX_NEON)
+    case KernelIsa::NEON:
+        return Detail::applyGainAndPeakNeon(data, frameCount, gain);
+#endif
+    default:
+        return Detail::applyGainAndPeakScalar(data, 0U, frameCount, gain, 0.0F);
+    }
+}
+
+}  // namespace MMM::Audio::MixKernels
@@ -2,6 +2,8 @@
 
 #include "audio/KeySoundControl.h"
 
+#include "AudioMixKernels.h"
+
 #include <algorithm>
 #include <chrono>
 #include <cmath>
@@ -255,7 +257,6 @@ AudioTimelineMixerNode::ScheduleState::ScheduleState(
           clips, requestedTimelineEndFrame))
     , maximumProcessFrames(
           std::max<std::size_t>(requestedMaximumProcessFrames, 1U))
-    , sourceScratch(ice::ICEConfig::internal_format, maximumProcessFrames)
     , activeSpanScratch(clips.size())
 {
 }
@@ -978,24 +979,42 @@ void AudioTimelineMixerNode::mixSegment(ice::AudioBuffer& output,
         const float effectiveVolume = span.volume * runtimeGain;
         if ( effectiveVolume <= 0.0F ) continue;
 
-        schedule.sourceScratch.clear();
-        const auto requestedFrames = static_cast<std::size_t>(span.frameCount);
-        const auto readFrames      = std::min<std::size_t>(
-            clip.audio->read(schedule.sourceScratch,
-                             static_cast<std::size_t>(span.sourceStartFrame),
-                             requestedFrames),
-            requestedFrames);
+        const auto sourceStart =
+            static_cast<std::size_t>(span.sourceStartFrame);
+        const auto sourceFrames = clip.audio->numFrames();
+        if ( sourceStart >= sourceFrames ) continue;
+        const auto mixFrames =
+            std::min(static_cast<std::size_t>(span.frameCount),
+                     sourceFrames - sourceStart);
         const auto destinationStart =
             outputStartFrame + static_cast<std::size_t>(span.outputStartFrame);
-        const auto channels = std::min<std::size_t>(
-            outputChannels, schedule.sourceScratch.num_channels());
-
-        for ( std::size_t channel = 0U; channel < channels; ++channel ) {
-            float* destination  = output.raw_ptrs()[channel] + destinationStart;
-            const float* source = schedule.sourceScratch.raw_ptrs()[channel];
-            for ( std::size_t frame = 0U; frame < readFrames; ++frame ) {
-                destination[frame] += source[frame] * effectiveVolume;
-            }
+        auto destinations = output.raw_ptrs();
+
+        // 直接从冻结 PCM 累加，不经过复制缓存；单声道源扩展到全部输出声道。
+        const auto sourceChannels = clip.audio->numChannels();
+        const bool monoSource     = sourceChannels == 1U;
+        const auto channels =
+            monoSource ? outputChannels
+                       : std::min<std::size_t>(outputChannels, sourceChannels);
+        const auto source = [&](std::size_t channel) {
+            return clip.audio->channel(monoSource ? 0U : channel).data() +
+                   sourceStart;
+        };
+        std::size_t channel = 0U;
+        for ( ; channel + 2U <= channels; channel += 2U ) {
+            MixKernels::mixScaledStereo(
+                destinations[channel] + destinationStart,
+                destinations[channel + 1U] + destinationStart,
+                source(channel),
+                source(channel + 1U),
+                mixFrames,
+                effectiveVolume);
+        }
+        if ( channel < channels ) {
+            MixKernels::mixScaled(destinations[channel] + destinationStart,
+                                  source(channel),
+                                  mixFrames,
+                                  effectiveVolume);
         }
     }
 }
@@ -1015,12 +1034,8 @@ void AudioTimelineMixerNode::applyMasterGainAndPublishLevels(
     float             rightPeak = 0.0F;
 
     for ( std::size_t channel = 0U; channel < channels; ++channel ) {
-        float* channelData = output.raw_ptrs()[channel];
-        float  channelPeak = 0.0F;
-        for ( std::size_t frame = 0U; frame < output.num_frames(); ++frame ) {
-            channelData[frame] *= gain;
-            channelPeak = std::max(channelPeak, std::abs(channelData[frame]));
-        }
+        const float channelPeak = MixKernels::applyGainAndPeak(
+            output.raw_ptrs()[channel], output.num_frames(), gain);
         if ( channel == 0U ) {
             leftPeak = channelPeak;
         } else if ( channel == 1U ) {
@@ -0,0 +1,124 @@
+#include "AudioMixKernels.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstddef>
+#include <random>
+#include <vector>
+
+/**
+ * @brief 逐个校验当前机器支持的混音内核指令集与标量实现一致。
+ *
+ * 只依赖 AudioMixKernels.h，可在交叉编译环境中单独构建并在模拟器下运行，
+ * 用于覆盖本机无法执行的 NEON 路径。帧数从 0 递增到两个 AVX 向量宽度
+ * 以上，覆盖向量主循环与各种长度的标量尾部。
+ */
+
+namespace
+{
+
+using MMM::Audio::MixKernels::KernelIsa;
+
+/// @brief 向量化结果与标量参考的允许误差。
+constexpr float SAMPLE_EPSILON = 1.0e-5F;
+
+/// @brief 校验的最大帧数。
+constexpr std::size_t MAX_FRAMES = 37U;
+
+bool nearlyEqual(float lhs, float rhs)
+{
+    return std::abs(lhs - rhs) <= SAMPLE_EPSILON;
+}
+
+/// @brief 用给定指令集重复参考计算，并与标量结果逐样本比较。
+bool verifyIsa(KernelIsa isa, std::size_t frameCount, std::mt19937& random)
+{
+    namespace Kernels = MMM::Audio::MixKernels;
+    std::uniform_real_distribution<float> sample(-1.0F, 1.0F);
+    std::vector<float>                    source(frameCount);
+    std::vector<float>                    rightSource(frameCount);
+    std::vector<float>                    initial(frameCount);
+    for ( std::size_t frame = 0U; frame < frameCount; ++frame ) {
+        source[frame]      = sample(random);
+        rightSource[frame] = sample(random);
+        initial[frame]     = sample(random);
+    }
+
+    std::vector<float> expected = initial;
+    std::vector<float> actual   = initial;
+    Kernels::mixScaled(
+        expected.data(), source.data(), frameCount, 0.75F, KernelIsa::SCALAR);
+    Kernels::mixScaled(actual.data(), source.data(), frameCount, 0.75F, isa);
+
+    // 双声道分别覆盖独立源与单声道扩展（两个源指针相同）。
+    std::vector<float> expectedLeft  = initial;
+    std::vector<float> expectedRight = initial;
+    std::vector<float> actualLeft    = initial;
+    std::vector<float> actualRight   = initial;
+    Kernels::mixScaledStereo(expectedLeft.data(),
+                             expectedRight.data(),
+                             source.data(),
+                             rightSource.data(),
+                             frameCount,
+                             -0.5F,
+                             KernelIsa::SCALAR);
+    Kernels::mixScaledStereo(actualLeft.data(),
+                             actualRight.data(),
+                             source.data(),
+                             rightSource.data(),
+                             frameCount,
+                             -0.5F,
+                             isa);
+    std::vector<float> expectedMono = initial;
+    std::vector<float> actualMono   = initial;
+    Kernels::mixScaledStereo(expectedMono.data(),
+                             expectedLeft.data(),
+                             source.data(),
+                             source.data(),
+                             frameCount,
+                             1.25F,
+                             KernelIsa::SCALAR);
+    Kernels::mixScaledStereo(actualMono.data(),
+                             actualLeft.data(),
+                             source.data(),
+                             source.data(),
+                             frameCount,
+                             1.25F,
+                             isa);
+
+    const float expectedPeak = Kernels::applyGainAndPeak(
+        expected.data(), frameCount, -1.5F, KernelIsa::SCALAR);
+    const float actualPeak =
+        Kernels::applyGainAndPeak(actual.data(), frameCount, -1.5F, isa);
+    if ( !nearlyEqual(expectedPeak, actualPeak) ) return false;
+
+    for ( std::size_t frame = 0U; frame < frameCount; ++frame ) {
+        if ( !nearlyEqual(expected[frame], actual[frame]) ||
+             !nearlyEqual(expectedLeft[frame], actualLeft[frame]) ||
+             !nearlyEqual(expectedRight[frame], actualRight[frame]) ||
+             !nearlyEqual(expectedMono[frame], actualMono[frame]) ) {
+            return false;
+        }
+    }
+    return true;
+}
+
+}  // namespace
+
+/// @brief 覆盖全部受支持指令集在 0~MAX_FRAMES 帧下的三个内核。
+/// @return 所有断言通过时返回 0。
+int main()
+{
+    namespace Kernels = MMM::Audio::MixKernels;
+    std::mt19937 random(0x4d4958U);
+
+    bool ok = Kernels::isSupported(Kernels::ACTIVE_ISA);
+    for ( const KernelIsa isa :
+          { KernelIsa::SSE2, KernelIsa::AVX, KernelIsa::NEON } ) {
+        if ( !Kernels::isSupported(isa) ) continue;
+        for ( std::size_t frames = 0U; frames <= MAX_FRAMES; ++frames ) {
+            ok &= verifyIsa(isa, frames, random);
+        }
+    }
+    return ok ? 0 : 1;
+}
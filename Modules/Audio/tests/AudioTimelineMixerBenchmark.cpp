@@ -0,0 +1,251 @@
+#include "AudioMixKernels.h"
+#include "audio/AudioTimelineMixerNode.h"
+
+#include "log/colorful-log.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstddef>
+#include <cstdlib>
+#include <ice/config/config.hpp>
+#include <ice/manage/AudioBuffer.hpp>
+#include <memory>
+#include <random>
+#include <string>
+#include <vector>
+
+/**
+ * @brief 时间线混音内核与 AudioTimelineMixerNode 的实时耗时测量。
+ *
+ * 用法: AudioTimelineMixerBenchmark [block_count]
+ * 先以标量参考实现校验向量化内核并对比单 block 耗时，再按 1/8/32/128
+ * 个同时活跃片段测量节点 process 的每 block 纳秒数，并校验首个 block
+ * 与逐样本标量混音结果一致。片段循环播放，默认每个规模处理 2000 个 block。
+ */
+
+namespace
+{
+
+using Clock = std::chrono::steady_clock;
+
+/// @brief 每个音频 block 的帧数，对应常见的实时回调长度。
+constexpr std::size_t BLOCK_FRAMES = 512U;
+
+/// @brief 片段长度对应的 block 数，测量期间循环播放以限制内存占用。
+constexpr std::size_t CLIP_BLOCKS = 16U;
+
+/// @brief 向量化结果与标量参考的允许误差。
+constexpr float SAMPLE_EPSILON = 1.0e-4F;
+
+/// @brief 计算一段代码平均每次执行的纳秒数。
+template<typename Body>
+double nanosecondsPerCall(std::size_t calls, Body&& body)
+{
+    const auto begin = Clock::now();
+    for ( std::size_t call = 0U; call < calls; ++call ) body();
+    return std::chrono::duration<double, std::nano>(Clock::now() - begin)
+               .count() /
+           static_cast<double>(calls);
+}
+
+/// @brief 校验内核与标量参考一致，并对比单 block 耗时。
+bool runKernelBenchmark(std::size_t blockCount)
+{
+    std::mt19937                          random(0x5a17U);
+    std::uniform_real_distribution<float> sample(-1.0F, 1.0F);
+    // 多出 3 帧用于覆盖向量主循环之后的标量尾部。
+    constexpr std::size_t FRAMES = BLOCK_FRAMES + 3U;
+    std::vector<float>    source(FRAMES);
+    std::vector<float>    initial(FRAMES);
+    for ( std::size_t frame = 0U; frame < FRAMES; ++frame ) {
+        source[frame]  = sample(random);
+        initial[frame] = sample(random);
+    }
+
+    std::vector<float> expected     = initial;
+    std::vector<float> actual       = initial;
+    std::vector<float> left         = initial;
+    std::vector<float> right        = initial;
+    float              expectedPeak = 0.0F;
+    for ( std::size_t frame = 0U; frame < FRAMES; ++frame ) {
+        expected[frame] += source[frame] * 0.75F;
+        expected[frame] *= -1.5F;
+        expectedPeak = std::max(expectedPeak, std::abs(expected[frame]));
+    }
+    MMM::Audio::MixKernels::mixScaled(
+        actual.data(), source.data(), FRAMES, 0.75F);
+    MMM::Audio::MixKernels::mixScaledStereo(left.data(),
+                                            right.data(),
+                                            source.data(),
+                                            source.data(),
+                                            FRAMES,
+                                            0.75F);
+    const float actualPeak = MMM::Audio::MixKernels::applyGainAndPeak(
+        actual.data(), FRAMES, -1.5F);
+    static_cast<void>(
+        MMM::Audio::MixKernels::applyGainAndPeak(left.data(), FRAMES, -1.5F));
+    static_cast<void>(
+        MMM::Audio::MixKernels::applyGainAndPeak(right.data(), FRAMES, -1.5F));
+    for ( std::size_t frame = 0U; frame < FRAMES; ++frame ) {
+        if ( std::abs(actual[frame] - expected[frame]) > SAMPLE_EPSILON ||
+             std::abs(left[frame] - expected[frame]) > SAMPLE_EPSILON ||
+             std::abs(right[frame] - expected[frame]) > SAMPLE_EPSILON ) {
+            XERROR("Mix kernel mismatch at frame {}", frame);
+            return false;
+        }
+    }
+    if ( std::abs(actualPeak - expectedPeak) > SAMPLE_EPSILON ) {
+        XERROR("Peak kernel returned {}, expected {}",
+               actualPeak,
+               expectedPeak);
+        return false;
+    }
+
+    std::vector<float> destination(BLOCK_FRAMES, 0.0F);
+    volatile float     sink        = 0.0F;
+    const double       scalarMixNs = nanosecondsPerCall(blockCount, [&] {
+        float*       output = destination.data();
+        const float* input  = source.data();
+        for ( std::size_t frame = 0U; frame < BLOCK_FRAMES; ++frame ) {
+            output[frame] += input[frame] * 0.5F;
+        }
+        sink = output[0];
+    });
+    XINFO("Mix kernels (active {}): frames={} blocks={}",
+          MMM::Audio::MixKernels::kernelName(
+              MMM::Audio::MixKernels::ACTIVE_ISA),
+          BLOCK_FRAMES,
+          blockCount);
+    XINFO("  scalar mix   : {:.1f}ns/block", scalarMixNs);
+
+    // 本机支持的每种指令集分别计时，便于对比运行期选择的结果。
+    using MMM::Audio::MixKernels::KernelIsa;
+    for ( const KernelIsa isa :
+          { KernelIsa::SSE2, KernelIsa::AVX, KernelIsa::NEON } ) {
+        if ( !MMM::Audio::MixKernels::isSupported(isa) ) continue;
+        const double kernelMixNs = nanosecondsPerCall(blockCount, [&] {
+            MMM::Audio::MixKernels::mixScaled(
+                destination.data(), source.data(), BLOCK_FRAMES, 0.5F, isa);
+            sink = destination[0];
+        });
+        const double kernelPeakNs = nanosecondsPerCall(blockCount, [&] {
+            sink = MMM::Audio::MixKernels::applyGainAndPeak(
+                destination.data(), BLOCK_FRAMES, 0.5F, isa);
+        });
+        XINFO("  {:<6} mix   : {:.1f}ns/block",
+              MMM::Audio::MixKernels::kernelName(isa),
+              kernelMixNs);
+        XINFO("  {:<6} peak  : {:.1f}ns/block",
+              MMM::Audio::MixKernels::kernelName(isa),
+              kernelPeakNs);
+    }
+    static_cast<void>(sink);
+    return true;
+}
+
+/// @brief 生成确定性的片段 PCM；奇数片段为单声道以覆盖声道扩展。
+std::vector<std::vector<float>> makeClipChannels(std::size_t clipIndex,
+                                                 std::size_t frameCount)
+{
+    const std::size_t channelCount = clipIndex % 2U == 0U ? 2U : 1U;
+    std::vector<std::vector<float>> channels(channelCount);
+    for ( std::size_t channel = 0U; channel < channelCount; ++channel ) {
+        channels[channel].resize(frameCount);
+        for ( std::size_t frame = 0U; frame < frameCount; ++frame ) {
+            channels[channel][frame] = std::sin(
+                0.01F * static_cast<float>((frame + 1U) * (clipIndex + 1U)) +
+                static_cast<float>(channel));
+        }
+    }
+    return channels;
+}
+
+/// @brief 校验首个 block 与逐样本标量混音一致。
+bool verifyFirstBlock(
+    const ice::AudioBuffer&                              output,
+    const std::vector<MMM::Audio::PreparedTimelineClip>& clips)
+{
+    for ( std::size_t channel = 0U; channel < output.num_channels();
+          ++channel ) {
+        for ( std::size_t frame = 0U; frame < output.num_frames(); ++frame ) {
+            float expected = 0.0F;
+            for ( const auto& clip : clips ) {
+                const bool mono = clip.audio->numChannels() == 1U;
+                if ( !mono && channel >= clip.audio->numChannels() ) continue;
+                expected +=
+                    clip.audio->channel(mono ? 0U : channel)[frame] *
+                    clip.volume;
+            }
+            if ( std::abs(output.raw_ptrs()[channel][frame] - expected) >
+                 SAMPLE_EPSILON ) {
+                XERROR("Mixer output mismatch: channel={}, frame={}",
+                       channel,
+                       frame);
+                return false;
+            }
+        }
+    }
+    return true;
+}
+
+/// @brief 测量指定活跃片段数量下节点的每 block 耗时。
+bool runMixerBenchmark(std::size_t clipCount, std::size_t blockCount)
+{
+    constexpr std::size_t clipFrames = CLIP_BLOCKS * BLOCK_FRAMES;
+    std::vector<MMM::Audio::PreparedTimelineClip> clips;
+    clips.reserve(clipCount);
+    for ( std::size_t clipIndex = 0U; clipIndex < clipCount; ++clipIndex ) {
+        clips.push_back({
+            .eventId   = clipIndex + 1U,
+            .sourceKey = "clip" + std::to_string(clipIndex),
+            .volume    = 1.0F / static_cast<float>(clipCount),
+            .audio     = MMM::Audio::PreparedTimelineAudio::fromOwnedChannels(
+                makeClipChannels(clipIndex, clipFrames)),
+        });
+        if ( !clips.back().audio ) {
+            XERROR("Failed to prepare benchmark clip {}", clipIndex);
+            return false;
+        }
+    }
+
+    MMM::Audio::AudioTimelineMixerNode node(
+        clips,
+        static_cast<MMM::Audio::AudioTimelineFrame>(clipFrames),
+        BLOCK_FRAMES);
+    ice::AudioBuffer output(ice::ICEConfig::internal_format, BLOCK_FRAMES);
+    node.play();
+    node.process(output);
+    if ( !verifyFirstBlock(output, clips) ) return false;
+    // 循环边界与 block 对齐，测量期间所有片段始终处于活跃状态。
+    if ( !node.setLoop(
+             { 0, static_cast<MMM::Audio::AudioTimelineFrame>(clipFrames) }) ) {
+        XERROR("Failed to loop the benchmark timeline");
+        return false;
+    }
+
+    const double blockNs = nanosecondsPerCall(
+        blockCount, [&] { node.process(output); });
+    XINFO("  clips={:<4} : {:.1f}ns/block ({:.1f}ns/clip)",
+          clipCount,
+          blockNs,
+          blockNs / static_cast<double>(clipCount));
+    return true;
+}
+
+}  // namespace
+
+int main(int argc, char* argv[])
+{
+    std::size_t blockCount = 2000U;
+    if ( argc > 1 ) blockCount = std::strtoull(argv[1], nullptr, 10);
+    if ( blockCount == 0U || !runKernelBenchmark(blockCount) ) return 1;
+
+    XINFO("AudioTimelineMixerNode: frames={} blocks={}",
+          BLOCK_FRAMES,
+          blockCount);
+    for ( const std::size_t clipCount : { 1U, 8U, 32U, 128U } ) {
+        if ( !runMixerBenchmark(clipCount, blockCount) ) return 1;
+    }
+    return 0;
+}
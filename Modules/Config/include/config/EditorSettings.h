@@ -611,6 +611,9 @@ struct EditorSettings {
     /// @brief 最近打开项目的显示上限
     int recentProjectsLimit{ 10 };
 
+    /// @brief 撤销历史内存预算 (MB)；超出后压缩溢出到项目缓存目录。
+    int undoMemoryBudgetMB{ 256 };
+
     /// @brief 语言设置 (zh_cn, en_us)
     std::string language{ "zh_cn" };
 
@@ -633,6 +633,8 @@ void to_json(nlohmann::json& json, const EditorSettings& settings)
         { "objectPlacementSnapMode", settings.objectPlacementSnapMode },
         { "commonBeatDivisorMask", settings.commonBeatDivisorMask },
         { "recentProjectsLimit", settings.recentProjectsLimit },
+        { "undoMemoryBudgetMB",
+          std::clamp(settings.undoMemoryBudgetMB, 16, 4096) },
         { "language", settings.language },
         { "defaultCreator", normalizeCreatorIdentity(settings.defaultCreator) },
         { "frameLimit", settings.frameLimit },
@@ -734,6 +736,8 @@ void from_json(const nlohmann::json& json, EditorSettings& settings)
         json.value("commonBeatDivisorMask", COMMON_BEAT_DIVISOR_MASK_DEFAULT) &
         COMMON_BEAT_DIVISOR_MASK_ALL;
     settings.recentProjectsLimit = json.value("recentProjectsLimit", 10);
+    settings.undoMemoryBudgetMB =
+        std::clamp(json.value("undoMemoryBudgetMB", 256), 16, 4096);
     settings.language            = json.value("language", std::string("zh_cn"));
     settings.defaultCreator =
         normalizeCreatorIdentity(json.value("defaultCreator", std::string()));
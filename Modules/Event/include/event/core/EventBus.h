@@ -7,6 +7,7 @@
 #include <functional>
 #include <memory>
 #include <tuple>
+#include <type_traits>
 #include <vector>
 
 namespace MMM::Event
@@ -29,6 +30,54 @@ template<typename T> inline uint64_t getStaticTypeId()
 ///@brief 订阅令牌，用于取消订阅
 using SubscriptionID = uint64_t;
 
+/// @brief 单个事件类型的发布与处理计数。
+struct EventTypeStatistics {
+    /// @brief 事件类型 ID。
+    uint64_t typeId{ 0 };
+    /// @brief 以该类型发布的次数，可按采样间隔换算发布频率。
+    uint64_t publishCount{ 0 };
+    /// @brief 投递到延迟队列的回调次数。
+    uint64_t deferredCount{ 0 };
+    /// @brief 已执行的回调次数，包含同步回调与已排空的延迟回调。
+    uint64_t handlerCount{ 0 };
+    /// @brief 回调累计耗时，单位纳秒。
+    uint64_t handlerNanoseconds{ 0 };
+};
+
+class EventBus;
+
+/**
+ * @brief 延迟分发队列，由目标线程持有并在其循环的固定位置排空。
+ *
+ * 以该队列订阅的回调不在发布线程执行：发布时事件只复制一次并压入无锁队列，
+ * 目标线程调用 drain() 时按入队顺序执行。同一发布线程的事件保持顺序。
+ */
+class DeferredEventQueue
+{
+public:
+    DeferredEventQueue();
+    ~DeferredEventQueue();
+
+    DeferredEventQueue(const DeferredEventQueue&)            = delete;
+    DeferredEventQueue& operator=(const DeferredEventQueue&) = delete;
+
+    /// @brief 执行调用前已入队的延迟回调。
+    /// @return 本次执行的回调数量。
+    /// @warning 只能由持有队列的线程调用；回调中再次发布的事件留到下次排空。
+    std::size_t drain();
+
+    /// @brief 当前排队的近似回调数量。
+    [[nodiscard]] std::size_t approximateSize() const;
+
+private:
+    friend class EventBus;
+
+    /// @brief 无锁队列与关闭标记，订阅记录共享其所有权。
+    struct Impl;
+
+    std::shared_ptr<Impl> m_impl;
+};
+
 class EventBus
 {
 public:
@@ -55,11 +104,23 @@ public:
     template<typename EventType>
     SubscriptionID subscribe(std::function<void(const EventType&)> callback)
     {
-        return subscribeImpl(
-            detail::getStaticTypeId<EventType>(),
-            [callback](const void* eventPtr) {
-                callback(*static_cast<const EventType*>(eventPtr));
-            });
+        return subscribeImpl(detail::getStaticTypeId<EventType>(),
+                             eraseCallback(std::move(callback)),
+                             nullptr);
+    }
+
+    /**
+     * @brief 以延迟模式订阅事件，回调在 queue 排空时执行
+     * @param queue 目标线程持有的延迟队列，须在取消订阅后再销毁
+     * @return 返回订阅 ID，可用于取消订阅
+     */
+    template<typename EventType>
+    SubscriptionID subscribe(std::function<void(const EventType&)> callback,
+                             DeferredEventQueue&                   queue)
+    {
+        return subscribeImpl(detail::getStaticTypeId<EventType>(),
+                             eraseCallback(std::move(callback)),
+                             &queue);
     }
 
     /**
@@ -74,22 +135,60 @@ public:
     /**
      * @brief 发布事件
      * 自动分发给当前类型及其所有在 EventTraits 中注册的父类
+     * @warning 高频路径：只读取订阅快照，不加锁也不分配；仅在存在延迟订阅者
+     * 时复制一次事件。
      */
     template<typename EventType> void publish(const EventType& event)
     {
-        publishImpl(relatedTypeIds<EventType>(), &event);
+        publishImpl(relatedTypeIds<EventType>(), &event, &copyEvent<EventType>);
+    }
+
+    /// @brief 获取指定事件类型的发布与处理计数。
+    template<typename EventType> EventTypeStatistics statistics() const
+    {
+        return statisticsImpl(detail::getStaticTypeId<EventType>());
     }
 
+    /// @brief 获取所有发布或订阅过的事件类型的计数。
+    [[nodiscard]] std::vector<EventTypeStatistics> allStatistics() const;
+
 private:
-    /// @brief 隐藏订阅表、锁与订阅 ID 计数器。
+    /// @brief 把事件复制到共享所有权的堆对象，供延迟队列持有。
+    using EventCopier = std::shared_ptr<const void> (*)(const void*);
+
+    /// @brief 将类型化回调擦除为接收事件地址的回调。
+    template<typename EventType>
+    static std::function<void(const void*)> eraseCallback(
+        std::function<void(const EventType&)> callback)
+    {
+        return [callback = std::move(callback)](const void* eventPtr) {
+            callback(*static_cast<const EventType*>(eventPtr));
+        };
+    }
+
+    /// @brief 复制事件；不可复制的事件返回空，延迟订阅者改为同步执行。
+    template<typename EventType>
+    static std::shared_ptr<const void> copyEvent(const void* eventPtr)
+    {
+        if constexpr ( std::is_copy_constructible_v<EventType> ) {
+            return std::make_shared<const EventType>(
+                *static_cast<const EventType*>(eventPtr));
+        } else {
+            return nullptr;
+        }
+    }
+
+    /// @brief 隐藏订阅快照、写锁与订阅 ID 计数器。
     struct Impl;
 
     /// @brief 注册已类型擦除的订阅回调。
     /// @param typeId 事件类型 ID。
     /// @param callback 接收事件地址的回调。
+    /// @param queue 延迟队列；为空时在发布线程同步执行。
     /// @return 可用于取消订阅的 ID。
     SubscriptionID subscribeImpl(uint64_t                         typeId,
-                                 std::function<void(const void*)> callback);
+                                 std::function<void(const void*)> callback,
+                                 DeferredEventQueue*              queue);
 
     /// @brief 取消已类型擦除的订阅。
     /// @param typeId 事件类型 ID。
@@ -99,8 +198,12 @@ private:
     /// @brief 向相关事件类型的订阅者发布对象。
     /// @param relatedTypes 当前类型及所有注册父类的 ID。
     /// @param eventPtr 发布期间有效的事件地址。
+    /// @param copier 延迟订阅者需要时复制事件。
     void publishImpl(const std::vector<uint64_t>& relatedTypes,
-                     const void*                  eventPtr);
+                     const void* eventPtr, EventCopier copier);
+
+    /// @brief 读取单个事件类型的计数。
+    [[nodiscard]] EventTypeStatistics statisticsImpl(uint64_t typeId) const;
 
     /// @brief 获取事件类型及其所有注册父类的稳定 ID 列表。
     /// @return 首次使用时构建、之后复用的 ID 列表。
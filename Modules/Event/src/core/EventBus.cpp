@@ -2,11 +2,13 @@
 
 #include <algorithm>
 #include <atomic>
+#include <chrono>
+#include <concurrentqueue.h>
+#include <functional>
 #include <memory>
 #include <mutex>
-#include <shared_mutex>
-#include <unordered_map>
 #include <utility>
+#include <vector>
 
 namespace MMM::Event
 {
@@ -19,21 +21,162 @@ uint64_t nextStaticTypeId()
 }
 }  // namespace detail
 
+namespace
+{
+/// @brief 单个事件类型的原子计数，跨订阅快照共享。
+struct TypeCounters {
+    std::atomic<uint64_t> publishCount{ 0 };
+    std::atomic<uint64_t> deferredCount{ 0 };
+    std::atomic<uint64_t> handlerCount{ 0 };
+    std::atomic<uint64_t> handlerNanoseconds{ 0 };
+};
+
+struct DeferredQueueState;
+
+/// @brief 一条已类型擦除的订阅记录。
+struct Subscriber {
+    SubscriptionID                      id{ 0 };
+    std::function<void(const void*)>    callback;
+    /// @brief 延迟队列；为空时在发布线程同步执行。
+    std::shared_ptr<DeferredQueueState> queue;
+    /// @brief 取消订阅后置为 false，已入队或正在读取旧快照的发布据此跳过。
+    std::atomic<bool> active{ true };
+};
+
+using SubscriberList = std::vector<std::shared_ptr<Subscriber>>;
+
+/// @brief 单个事件类型的订阅列表与计数。
+struct TypeSlot {
+    std::shared_ptr<const SubscriberList> subscribers;
+    std::shared_ptr<TypeCounters>         counters;
+};
+
+/// @brief 不可变订阅快照，按稠密的事件类型 ID 直接索引。
+struct SubscriberTable {
+    std::vector<TypeSlot> slots;
+};
+
+/// @brief 一次待执行的延迟回调。
+struct DeferredDelivery {
+    std::shared_ptr<Subscriber>   subscriber;
+    std::shared_ptr<const void>   event;
+    std::shared_ptr<TypeCounters> counters;
+};
+
+/// @brief 延迟队列的共享状态，订阅记录与队列持有者共同持有。
+struct DeferredQueueState {
+    /// @brief 多生产者无锁队列，只由持有线程消费。
+    moodycamel::ConcurrentQueue<DeferredDelivery> deliveries;
+    /// @brief 队列持有者析构后置为 true，之后的发布不再入队。
+    std::atomic<bool> closed{ false };
+};
+
+/// @brief 记录一批回调的执行耗时。
+void recordHandlers(TypeCounters& counters, uint64_t handlerCount,
+                    std::chrono::steady_clock::time_point start)
+{
+    const auto elapsed = std::chrono::duration_cast<std::chrono::nanoseconds>(
+        std::chrono::steady_clock::now() - start);
+    counters.handlerCount.fetch_add(handlerCount, std::memory_order_relaxed);
+    counters.handlerNanoseconds.fetch_add(
+        static_cast<uint64_t>(elapsed.count()), std::memory_order_relaxed);
+}
+
+/// @brief 读取计数的当前值。
+EventTypeStatistics loadStatistics(uint64_t            typeId,
+                                   const TypeCounters& counters)
+{
+    return { typeId,
+             counters.publishCount.load(std::memory_order_relaxed),
+             counters.deferredCount.load(std::memory_order_relaxed),
+             counters.handlerCount.load(std::memory_order_relaxed),
+             counters.handlerNanoseconds.load(std::memory_order_relaxed) };
+}
+}  // namespace
+
+struct DeferredEventQueue::Impl : DeferredQueueState {};
+
+DeferredEventQueue::DeferredEventQueue() : m_impl(std::make_shared<Impl>()) {}
+
+DeferredEventQueue::~DeferredEventQueue()
+{
+    m_impl->closed.store(true, std::memory_order_release);
+}
+
+std::size_t DeferredEventQueue::drain()
+{
+    // 只执行本次调用前已入队的回调，避免回调再次发布时无限排空。
+    std::size_t      remaining = m_impl->deliveries.size_approx();
+    std::size_t      executed  = 0;
+    DeferredDelivery delivery;
+    while ( remaining > 0 && m_impl->deliveries.try_dequeue(delivery) ) {
+        --remaining;
+        if ( delivery.subscriber->active.load(std::memory_order_acquire) ) {
+            const auto start = std::chrono::steady_clock::now();
+            delivery.subscriber->callback(delivery.event.get());
+            recordHandlers(*delivery.counters, 1, start);
+            ++executed;
+        }
+        delivery = {};
+    }
+    return executed;
+}
+
+std::size_t DeferredEventQueue::approximateSize() const
+{
+    return m_impl->deliveries.size_approx();
+}
+
 struct EventBus::Impl {
-    /// @brief 一条已类型擦除的订阅记录。
-    struct SubscriberInfo {
-        SubscriptionID                   id;
-        std::function<void(const void*)> callback;
+    /// @brief 当前发布的订阅快照。
+    /// @warning 发布热路径 acquire 读取；写侧在持有 mutex 后复制、修改并
+    /// release 发布新快照。shared_ptr 所有权保证发布期间旧快照仍然有效。
+    std::shared_ptr<const SubscriberTable> table{
+        std::make_shared<const SubscriberTable>()
     };
 
-    /// @brief 按事件类型 ID 分组的订阅表。
-    std::unordered_map<uint64_t, std::vector<SubscriberInfo>> subscribers;
-
-    /// @brief 保护订阅表的读写锁。
-    std::shared_mutex mutex;
+    /// @brief 串行化订阅快照的写入。
+    std::mutex mutex;
 
     /// @brief 所有订阅共享的自增 ID。
     std::atomic<SubscriptionID> nextId{ 0 };
+
+    /// @brief 读取当前快照。
+    std::shared_ptr<const SubscriberTable> load() const
+    {
+        return std::atomic_load_explicit(&table, std::memory_order_acquire);
+    }
+
+    /// @brief 复制当前快照并保证 typeId 拥有计数槽，调用方须持有 mutex。
+    SubscriberTable copyWithSlot(uint64_t typeId) const
+    {
+        SubscriberTable next = *table;
+        if ( next.slots.size() <= typeId ) next.slots.resize(typeId + 1);
+        auto& slot = next.slots[typeId];
+        if ( !slot.counters ) slot.counters = std::make_shared<TypeCounters>();
+        return next;
+    }
+
+    /// @brief 发布新快照，调用方须持有 mutex。
+    std::shared_ptr<const SubscriberTable> store(SubscriberTable next)
+    {
+        auto published =
+            std::make_shared<const SubscriberTable>(std::move(next));
+        std::atomic_store_explicit(
+            &table, published, std::memory_order_release);
+        return published;
+    }
+
+    /// @brief 为首次发布的事件类型创建计数槽。
+    /// @warning 每个事件类型只在首次发布时加锁一次。
+    std::shared_ptr<const SubscriberTable> ensureCounters(uint64_t typeId)
+    {
+        std::lock_guard lock(mutex);
+        if ( typeId < table->slots.size() && table->slots[typeId].counters ) {
+            return table;
+        }
+        return store(copyWithSlot(typeId));
+    }
 };
 
 EventBus::EventBus() : m_impl(std::make_unique<Impl>()) {}
@@ -47,47 +190,119 @@ EventBus& EventBus::instance()
 }
 
 SubscriptionID EventBus::subscribeImpl(
-    uint64_t typeId, std::function<void(const void*)> callback)
+    uint64_t typeId, std::function<void(const void*)> callback,
+    DeferredEventQueue* queue)
 {
-    std::unique_lock     lock(m_impl->mutex);
-    const SubscriptionID id = ++m_impl->nextId;
-    m_impl->subscribers[typeId].push_back({ id, std::move(callback) });
-    return id;
+    auto subscriber      = std::make_shared<Subscriber>();
+    subscriber->callback = std::move(callback);
+    if ( queue ) subscriber->queue = queue->m_impl;
+
+    std::lock_guard lock(m_impl->mutex);
+    subscriber->id = ++m_impl->nextId;
+    auto  next     = m_impl->copyWithSlot(typeId);
+    auto& slot     = next.slots[typeId];
+    auto  list     = std::make_shared<SubscriberList>();
+    if ( slot.subscribers ) *list = *slot.subscribers;
+    list->push_back(subscriber);
+    slot.subscribers = std::move(list);
+    m_impl->store(std::move(next));
+    return subscriber->id;
 }
 
 void EventBus::unsubscribeImpl(uint64_t typeId, SubscriptionID id)
 {
-    std::unique_lock lock(m_impl->mutex);
-    const auto       subscriberIt = m_impl->subscribers.find(typeId);
-    if ( subscriberIt == m_impl->subscribers.end() ) return;
-
-    auto& subscribers = subscriberIt->second;
-    subscribers.erase(std::remove_if(subscribers.begin(),
-                                     subscribers.end(),
-                                     [id](const Impl::SubscriberInfo& info) {
-                                         return info.id == id;
-                                     }),
-                      subscribers.end());
+    std::lock_guard lock(m_impl->mutex);
+    const auto&     table = *m_impl->table;
+    if ( typeId >= table.slots.size() || !table.slots[typeId].subscribers ) {
+        return;
+    }
+
+    const auto& current = *table.slots[typeId].subscribers;
+    const auto  found   = std::find_if(
+        current.begin(), current.end(), [id](const auto& subscriber) {
+            return subscriber->id == id;
+        });
+    if ( found == current.end() ) return;
+    (*found)->active.store(false, std::memory_order_release);
+
+    auto list = std::make_shared<SubscriberList>();
+    list->reserve(current.size() - 1);
+    for ( const auto& subscriber : current ) {
+        if ( subscriber->id != id ) list->push_back(subscriber);
+    }
+
+    SubscriberTable next = table;
+    next.slots[typeId].subscribers =
+        list->empty() ? nullptr : std::move(list);
+    m_impl->store(std::move(next));
 }
 
 void EventBus::publishImpl(const std::vector<uint64_t>& relatedTypes,
-                           const void*                  eventPtr)
+                           const void* eventPtr, EventCopier copier)
 {
-    std::vector<Impl::SubscriberInfo> subscribersToCall;
-    {
-        std::shared_lock lock(m_impl->mutex);
-        for ( const uint64_t targetType : relatedTypes ) {
-            const auto subscriberIt = m_impl->subscribers.find(targetType);
-            if ( subscriberIt == m_impl->subscribers.end() ) continue;
-
-            subscribersToCall.insert(subscribersToCall.end(),
-                                     subscriberIt->second.begin(),
-                                     subscriberIt->second.end());
+    auto           table     = m_impl->load();
+    const uint64_t eventType = relatedTypes.front();
+    if ( eventType >= table->slots.size() ||
+         !table->slots[eventType].counters ) {
+        table = m_impl->ensureCounters(eventType);
+    }
+    const auto& counters = table->slots[eventType].counters;
+    counters->publishCount.fetch_add(1, std::memory_order_relaxed);
+
+    std::shared_ptr<const void>           deferredEvent;
+    bool                                  copyFailed   = false;
+    uint64_t                              handlerCount = 0;
+    std::chrono::steady_clock::time_point start;
+    for ( const uint64_t targetType : relatedTypes ) {
+        if ( targetType >= table->slots.size() ) continue;
+        const auto& subscribers = table->slots[targetType].subscribers;
+        if ( !subscribers ) continue;
+
+        for ( const auto& subscriber : *subscribers ) {
+            if ( !subscriber->active.load(std::memory_order_acquire) ) continue;
+
+            const auto& queue = subscriber->queue;
+            if ( queue && !copyFailed ) {
+                if ( queue->closed.load(std::memory_order_acquire) ) continue;
+                if ( !deferredEvent ) {
+                    deferredEvent = copier(eventPtr);
+                    copyFailed    = !deferredEvent;
+                }
+                if ( deferredEvent ) {
+                    queue->deliveries.enqueue(
+                        { subscriber, deferredEvent, counters });
+                    counters->deferredCount.fetch_add(
+                        1, std::memory_order_relaxed);
+                    continue;
+                }
+            }
+
+            if ( handlerCount == 0 ) start = std::chrono::steady_clock::now();
+            subscriber->callback(eventPtr);
+            ++handlerCount;
         }
     }
 
-    for ( const auto& subscriber : subscribersToCall ) {
-        subscriber.callback(eventPtr);
+    if ( handlerCount > 0 ) recordHandlers(*counters, handlerCount, start);
+}
+
+EventTypeStatistics EventBus::statisticsImpl(uint64_t typeId) const
+{
+    const auto table = m_impl->load();
+    if ( typeId >= table->slots.size() || !table->slots[typeId].counters ) {
+        return { typeId };
+    }
+    return loadStatistics(typeId, *table->slots[typeId].counters);
+}
+
+std::vector<EventTypeStatistics> EventBus::allStatistics() const
+{
+    const auto                       table = m_impl->load();
+    std::vector<EventTypeStatistics> statistics;
+    for ( uint64_t typeId = 0; typeId < table->slots.size(); ++typeId ) {
+        const auto& counters = table->slots[typeId].counters;
+        if ( counters ) statistics.push_back(loadStatistics(typeId, *counters));
     }
+    return statistics;
 }
 }  // namespace MMM::Event
@@ -0,0 +1,237 @@
+#include "event/core/EventBus.h"
+
+#include "event/core/BaseEvent.h"
+#include "log/colorful-log.h"
+
+#include <atomic>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace EventBusTest
+{
+/// @brief 携带负载的测试事件，注册 BaseEvent 为父类。
+struct ValueEvent : MMM::Event::BaseEvent {
+    int         value{ 0 };
+    std::string label;
+};
+
+/// @brief 不可复制的测试事件，延迟订阅者应退回同步执行。
+struct MoveOnlyEvent {
+    MoveOnlyEvent() = default;
+    MoveOnlyEvent(const MoveOnlyEvent&) = delete;
+    int value{ 0 };
+};
+}  // namespace EventBusTest
+
+EVENT_REGISTER_PARENTS(EventBusTest::ValueEvent, BaseEvent)
+
+namespace
+{
+
+using MMM::Event::BaseEvent;
+using MMM::Event::DeferredEventQueue;
+using MMM::Event::EventBus;
+using EventBusTest::MoveOnlyEvent;
+using EventBusTest::ValueEvent;
+
+/// @brief 验证同步订阅、父类分发与取消订阅。
+bool testSynchronousDispatch()
+{
+    EventBus bus;
+    int      valueCalls = 0;
+    int      baseCalls  = 0;
+    const auto valueId  = bus.subscribe<ValueEvent>(
+        [&](const ValueEvent& event) { valueCalls += event.value; });
+    bus.subscribe<BaseEvent>([&](const BaseEvent&) { ++baseCalls; });
+
+    ValueEvent event;
+    event.value = 3;
+    bus.publish(event);
+    bus.unsubscribe<ValueEvent>(valueId);
+    bus.publish(event);
+    if ( valueCalls != 3 || baseCalls != 2 ) {
+        XERROR("Synchronous dispatch or unsubscribe misbehaved");
+        return false;
+    }
+
+    const auto stats = bus.statistics<ValueEvent>();
+    if ( stats.publishCount != 2 || stats.handlerCount != 3 ||
+         stats.deferredCount != 0 ) {
+        XERROR("Event statistics did not count publishes and handlers");
+        return false;
+    }
+    return true;
+}
+
+/// @brief 验证回调内取消订阅与新增订阅不影响本次发布的快照。
+bool testMutationDuringPublish()
+{
+    EventBus                   bus;
+    int                        firstCalls  = 0;
+    int                        secondCalls = 0;
+    MMM::Event::SubscriptionID secondId    = 0;
+    bus.subscribe<ValueEvent>([&](const ValueEvent&) {
+        ++firstCalls;
+        bus.unsubscribe<ValueEvent>(secondId);
+        bus.subscribe<ValueEvent>([](const ValueEvent&) {});
+    });
+    secondId = bus.subscribe<ValueEvent>(
+        [&](const ValueEvent&) { ++secondCalls; });
+
+    bus.publish(ValueEvent{});
+    if ( firstCalls != 1 || secondCalls != 0 ) {
+        XERROR("Subscriber removed during publish was still invoked");
+        return false;
+    }
+    return true;
+}
+
+/// @brief 验证延迟订阅只在排空时执行，并持有事件副本。
+bool testDeferredDispatch()
+{
+    EventBus           bus;
+    DeferredEventQueue queue;
+    std::vector<int>   values;
+    std::string        label;
+    bus.subscribe<ValueEvent>(
+        [&](const ValueEvent& event) {
+            values.push_back(event.value);
+            label = event.label;
+        },
+        queue);
+    const auto droppedId = bus.subscribe<ValueEvent>(
+        [&](const ValueEvent&) { values.push_back(-1); }, queue);
+
+    std::thread publisher([&bus] {
+        for ( int index = 0; index < 4; ++index ) {
+            ValueEvent event;
+            event.value = index;
+            event.label = "deferred";
+            bus.publish(event);
+        }
+    });
+    publisher.join();
+    bus.unsubscribe<ValueEvent>(droppedId);
+
+    if ( !values.empty() || queue.approximateSize() != 8 ) {
+        XERROR("Deferred subscriber ran on the publishing thread");
+        return false;
+    }
+    if ( queue.drain() != 4 || values != std::vector<int>{ 0, 1, 2, 3 } ||
+         label != "deferred" ) {
+        XERROR("Deferred queue did not deliver copied events in order");
+        return false;
+    }
+    const auto stats = bus.statistics<ValueEvent>();
+    if ( stats.publishCount != 4 || stats.deferredCount != 8 ||
+         stats.handlerCount != 4 ) {
+        XERROR("Deferred statistics are wrong");
+        return false;
+    }
+    return true;
+}
+
+/// @brief 验证回调中再次发布的事件留到下一次排空。
+bool testDrainBoundary()
+{
+    EventBus           bus;
+    DeferredEventQueue queue;
+    int                calls = 0;
+    bus.subscribe<ValueEvent>(
+        [&](const ValueEvent& event) {
+            ++calls;
+            if ( event.value > 0 ) {
+                ValueEvent next;
+                next.value = event.value - 1;
+                bus.publish(next);
+            }
+        },
+        queue);
+
+    ValueEvent event;
+    event.value = 2;
+    bus.publish(event);
+    if ( queue.drain() != 1 || queue.drain() != 1 || queue.drain() != 1 ||
+         queue.drain() != 0 || calls != 3 ) {
+        XERROR("Drain executed events queued by its own callbacks");
+        return false;
+    }
+    return true;
+}
+
+/// @brief 验证不可复制事件的延迟订阅者退回同步执行。
+bool testMoveOnlyFallback()
+{
+    EventBus           bus;
+    DeferredEventQueue queue;
+    int                value = 0;
+    bus.subscribe<MoveOnlyEvent>(
+        [&](const MoveOnlyEvent& event) { value = event.value; }, queue);
+
+    MoveOnlyEvent event;
+    event.value = 7;
+    bus.publish(event);
+    if ( value != 7 || queue.approximateSize() != 0 ) {
+        XERROR("Non-copyable event was not delivered synchronously");
+        return false;
+    }
+    return true;
+}
+
+/// @brief 验证并发发布与订阅变更时已有订阅者不丢失事件。
+bool testConcurrentPublish()
+{
+    constexpr int PUBLISHER_COUNT = 4;
+    constexpr int PUBLISH_ROUNDS  = 20000;
+
+    EventBus         bus;
+    std::atomic<int> stableCalls{ 0 };
+    bus.subscribe<ValueEvent>([&](const ValueEvent&) {
+        stableCalls.fetch_add(1, std::memory_order_relaxed);
+    });
+
+    std::atomic<bool>        running{ true };
+    std::vector<std::thread> publishers;
+    for ( int index = 0; index < PUBLISHER_COUNT; ++index ) {
+        publishers.emplace_back([&bus] {
+            const ValueEvent event;
+            for ( int round = 0; round < PUBLISH_ROUNDS; ++round ) {
+                bus.publish(event);
+            }
+        });
+    }
+    std::thread churn([&] {
+        while ( running.load() ) {
+            const auto id =
+                bus.subscribe<ValueEvent>([](const ValueEvent&) {});
+            bus.unsubscribe<ValueEvent>(id);
+        }
+    });
+    for ( auto& publisher : publishers ) {
+        publisher.join();
+    }
+    running.store(false);
+    churn.join();
+
+    if ( stableCalls.load() != PUBLISHER_COUNT * PUBLISH_ROUNDS ||
+         bus.statistics<ValueEvent>().publishCount !=
+             static_cast<uint64_t>(PUBLISHER_COUNT * PUBLISH_ROUNDS) ) {
+        XERROR("Concurrent publish lost events while subscribers changed");
+        return false;
+    }
+    return true;
+}
+
+}  // namespace
+
+/// @brief 运行事件总线测试。
+/// @return 全部测试通过时返回 0。
+int main()
+{
+    const bool passed = testSynchronousDispatch() &&
+                        testMutationDuringPublish() && testDeferredDispatch() &&
+                        testDrainBoundary() && testMoveOnlyFallback() &&
+                        testConcurrentPublish();
+    return passed ? 0 : 1;
+}
@@ -207,6 +207,8 @@ private:
     int m_hoverLayerIndex{ 0 };
     /// @brief 当前鼠标下可切换的悬浮候选层数量。
     int m_hoverLayerCount{ 0 };
+    /// @brief 悬停拾取时复用的命中框下标缓冲，按最上层优先排列。
+    std::vector<std::uint32_t> m_hoverHitScratch;
     /// @brief 当前悬浮物件试听按钮的跨帧锚点。
     struct AudioPreviewOverlayState {
         /// @brief 是否持有有效物件与屏幕边界。
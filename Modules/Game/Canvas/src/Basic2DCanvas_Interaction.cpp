@@ -3657,32 +3657,43 @@ void Basic2DCanvasInteraction::handleInteractions(
     std::vector<HoverLayerCandidate> candidates;
     std::string                      layerSignature;
     if ( isHovered ) {
-        for ( auto it = currentSnapshot->hitboxes.rbegin();
-              it != currentSnapshot->hitboxes.rend();
-              ++it ) {
-            const auto hitbox = Logic::scaleInteractionHitbox(
-                *it,
-                currentSnapshot->interactionHitboxScaleX,
-                currentSnapshot->interactionHitboxScaleY);
-            if ( localMousePos.x >= hitbox.x &&
-                 localMousePos.x <= hitbox.x + hitbox.w &&
-                 localMousePos.y >= hitbox.y &&
-                 localMousePos.y <= hitbox.y + hitbox.h ) {
-                const bool appended = appendHoverLayerCandidate(
-                    candidates,
-                    { hitbox.entity,
-                      hitbox.kind,
-                      static_cast<std::uint8_t>(hitbox.part),
-                      hitbox.subIndex });
-                if ( !appended ) continue;
-                layerSignature +=
-                    std::to_string(static_cast<uint32_t>(
-                        entt::to_integral(hitbox.entity))) +
-                    ":" + std::to_string(static_cast<uint32_t>(hitbox.kind)) +
-                    ":" + std::to_string(static_cast<uint32_t>(hitbox.part)) +
-                    ":" + std::to_string(hitbox.subIndex) + ";";
+        const auto& hitboxes = currentSnapshot->hitboxes;
+        m_hoverHitScratch.clear();
+        if ( currentSnapshot->hitboxIndex.size() == hitboxes.size() ) {
+            currentSnapshot->hitboxIndex.queryPoint(
+                localMousePos.x, localMousePos.y, m_hoverHitScratch);
+        } else {
+            // 未经会话快照阶段构建索引的快照退回逆序线性扫描。
+            for ( std::size_t index = hitboxes.size(); index-- > 0; ) {
+                const auto hitbox = Logic::scaleInteractionHitbox(
+                    hitboxes[index],
+                    currentSnapshot->interactionHitboxScaleX,
+                    currentSnapshot->interactionHitboxScaleY);
+                if ( localMousePos.x >= hitbox.x &&
+                     localMousePos.x <= hitbox.x + hitbox.w &&
+                     localMousePos.y >= hitbox.y &&
+                     localMousePos.y <= hitbox.y + hitbox.h ) {
+                    m_hoverHitScratch.push_back(
+                        static_cast<std::uint32_t>(index));
+                }
             }
         }
+        for ( const std::uint32_t index : m_hoverHitScratch ) {
+            const auto& hitbox   = hitboxes[index];
+            const bool  appended = appendHoverLayerCandidate(
+                candidates,
+                { hitbox.entity,
+                  hitbox.kind,
+                  static_cast<std::uint8_t>(hitbox.part),
+                  hitbox.subIndex });
+            if ( !appended ) continue;
+            layerSignature +=
+                std::to_string(static_cast<uint32_t>(
+                    entt::to_integral(hitbox.entity))) +
+                ":" + std::to_string(static_cast<uint32_t>(hitbox.kind)) +
+                ":" + std::to_string(static_cast<uint32_t>(hitbox.part)) +
+                ":" + std::to_string(hitbox.subIndex) + ";";
+        }
     }
 
     if ( layerSignature != m_hoverLayerSignature ) {
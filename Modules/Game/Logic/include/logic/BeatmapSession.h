@@ -1,6 +1,7 @@
 #pragma once
 
 #include "common/LogicCommands.h"
+#include "logic/session/CommandCoalescer.h"
 #include "mmm/beatmap/BeatmapMutationObserver.h"
 #include <atomic>
 #include <concurrentqueue.h>
@@ -9,6 +10,7 @@
 #include <optional>
 #include <string>
 #include <unordered_map>
+#include <vector>
 
 namespace MMM::Config
 {
@@ -104,6 +106,13 @@ public:
     /// 限频判断会调用；只读取无锁队列近似长度。
     bool hasPendingCommands() const;
 
+    /// @brief 获取最近一次 processCommands 的命令计数。
+    /// @warning 逻辑线程专用：由 EditorEngine 在 update 后汇总诊断。
+    [[nodiscard]] const CommandQueueTickStats& getCommandTickStats() const
+    {
+        return m_commandTickStats;
+    }
+
     /// @brief 判断会话是否需要跳过后台限频并立即更新。
     /// @warning 逻辑热路径：每个 Session update
     /// 调度前调用；只读取会话热状态和队列近似长度。
@@ -185,6 +194,12 @@ private:
     /// 活跃画笔草稿以保持未结束手势。
     bool processCommands();
 
+    /// @brief 取出下一条待执行命令；当前批次耗尽时从队列取出新批次并合并。
+    /// @param cmd 接收命令。
+    /// @return 队列已空时返回 false。
+    /// @warning 逻辑热路径：复用批次缓冲，不为每条命令分配。
+    bool takeNextCommand(LogicCommand& cmd);
+
     /// @brief 在入队与消费边界统一拦截离线房间谱面的编辑命令。
     /// @param cmd 待检查命令。
     /// @return 命令已被拦截时返回 true。
@@ -264,6 +279,18 @@ private:
     moodycamel::ConcurrentQueue<LogicCommand>
         m_commandQueue;  ///< 跨线程无锁指令队列
 
+    /// @brief 从队列取出、等待逐条执行的当前批次。
+    std::vector<LogicCommand> m_commandBatch;
+
+    /// @brief 当前批次中下一条待执行命令的下标。
+    std::size_t m_commandBatchCursor{ 0 };
+
+    /// @brief 批次合并阶段。
+    CommandCoalescer m_commandCoalescer;
+
+    /// @brief 最近一次 processCommands 的命令计数。
+    CommandQueueTickStats m_commandTickStats;
+
     /// @brief 当前低频谱面变化观察者。
     /// @warning 跨线程 shared_ptr 原子：只在谱面发生实际变化或首次绑定时加载，
     /// 用于避免观察者在逻辑回调期间被 UI 线程销毁。
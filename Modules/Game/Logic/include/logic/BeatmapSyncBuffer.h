@@ -6,6 +6,7 @@
 #include "common/NoteColor.h"
 #include "common/UnicodeFontData.h"
 #include "graphic/imguivk/mesh/VKBasicVertex.h"
+#include "logic/HitboxIndex.h"
 #include "logic/PreviewDensity.h"
 #include "logic/ecs/components/NoteComponent.h"
 #include "logic/ecs/system/ScrollCache.h"
@@ -351,7 +352,9 @@ struct RenderSnapshot {
     /// @brief 普通悬浮拾取与调试显示使用的横向包围盒缩放。
     float interactionHitboxScaleX{ 1.0F };
     /// @brief 普通悬浮拾取与调试显示使用的纵向包围盒缩放。
-    float                                   interactionHitboxScaleY{ 1.0F };
+    float interactionHitboxScaleY{ 1.0F };
+    /// @brief hitboxes 的交互包围盒网格索引，快照生成结束时构建。
+    HitboxIndex                             hitboxIndex;
     std::vector<TimelineInteractiveElement> timelineElements;
     /// @brief 可选画布组件的逐实例渲染与布局边界。
     std::vector<CanvasComponentInstanceSnapshot> canvasComponentInstances;
@@ -432,6 +435,13 @@ struct RenderSnapshot {
     /// @brief 逻辑线程可见音符查询去重临时集合，UI 线程不读取。
     std::unordered_set<entt::entity> noteQuerySeenScratch;
 
+    /// @brief 逻辑线程音符 AbsY 分桶查询去重标记，UI 线程不读取。
+    /// @note 分桶索引由多个视口共享只读，去重状态随快照各自持有。
+    std::vector<std::uint32_t> noteBucketSeenScratch;
+
+    /// @brief noteBucketSeenScratch 对应的当前查询序号，clear() 不重置。
+    std::uint32_t noteBucketQuerySerial{ 0 };
+
     /// @brief 逻辑线程可见自动采样查询临时列表，UI 线程不读取。
     std::vector<entt::entity> sampleQueryScratch;
 
@@ -547,6 +557,8 @@ struct RenderSnapshot {
     double visibleTimeEnd{ 0.0 };    ///< 当前视口可见的时间范围终点
     size_t noteCount{ 0 };           ///< 当前谱面的可计数物件数量
     size_t maxCombo{ 0 };            ///< 当前谱面的最大连击数
+    size_t undoMemoryBytes{ 0 };     ///< 撤销历史占用的内存字节数
+    size_t undoSpilledBytes{ 0 };    ///< 撤销历史溢出到磁盘的字节数
 
     // 笔刷预览状态
     struct BrushSnapshot {
@@ -682,6 +694,7 @@ struct RenderSnapshot {
         hitboxes.clear();
         interactionHitboxScaleX = 1.0F;
         interactionHitboxScaleY = 1.0F;
+        hitboxIndex.clear();
         overlapMasks.clear();
         annotationMarkers.clear();
         timelineElements.clear();
@@ -755,6 +768,8 @@ struct RenderSnapshot {
         visibleTimeEnd     = 0.0;
         noteCount          = 0;
         maxCombo           = 0;
+        undoMemoryBytes    = 0;
+        undoSpilledBytes   = 0;
         bgmTrackCount      = 0;
         bmsEditingEnabled  = true;
         draftLanesEnabled  = false;
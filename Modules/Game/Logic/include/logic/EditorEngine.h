@@ -6,6 +6,7 @@
 #include "logic/ProjectTypes.h"
 #include "logic/RenderSyncRegistry.h"
 #include "logic/SessionRegistry.h"
+#include "logic/session/CommandCoalescer.h"
 #include <array>
 #include <atomic>
 #include <chrono>
@@ -447,6 +448,16 @@ public:
         return m_logicUps.load(std::memory_order_relaxed);
     }
 
+    /// @brief 获取最近一个 UPS 统计窗口内单 tick 命令计数的峰值。
+    /// @warning UI 热路径/原子：菜单栏诊断可每帧读取；三个计数各自独立
+    /// 发布，只用于展示，使用 relaxed。
+    CommandQueueTickStats getCommandQueuePeakStats() const
+    {
+        return { m_commandEnqueuedPeak.load(std::memory_order_relaxed),
+                 m_commandCoalescedPeak.load(std::memory_order_relaxed),
+                 m_commandAppliedPeak.load(std::memory_order_relaxed) };
+    }
+
     /// @brief 发布主渲染线程实时帧率。
     /// @param fps ImGui 或渲染循环统计出的当前 FPS。
     /// @warning UI/逻辑热路径原子：UI 线程每帧写入，逻辑线程每 update
@@ -690,6 +701,13 @@ private:
     /// 可每帧读取；仅用于展示，使用 relaxed。
     std::atomic<float> m_logicUps{ 0.0f };
 
+    /// @brief 上一个 UPS 窗口内单 tick 入队、合并与执行命令数的峰值。
+    /// @warning 逻辑/UI 热路径/原子：逻辑线程低频写入、UI 可每帧读取；
+    /// 仅用于展示，使用 relaxed。
+    std::atomic<std::uint32_t> m_commandEnqueuedPeak{ 0 };
+    std::atomic<std::uint32_t> m_commandCoalescedPeak{ 0 };
+    std::atomic<std::uint32_t> m_commandAppliedPeak{ 0 };
+
     /// @brief 主渲染线程实时刷新率 (FPS)。
     /// @warning UI/逻辑热路径/原子：UI 线程每帧写入、逻辑线程每 update
     /// 读取；仅用于展示和 RenderSnapshot 自适应预算，使用 relaxed。
@@ -728,6 +746,9 @@ private:
     /// @brief 逻辑线程更新计数器，用于 UPS 计算
     uint32_t m_logicUpdateCount{ 0 };
 
+    /// @brief 当前 UPS 窗口内单 tick 命令计数的峰值，窗口结束时发布。
+    CommandQueueTickStats m_commandStatsWindowPeak;
+
     /// @brief 上次统计 UPS 的单调时钟时间点。
     std::chrono::steady_clock::time_point m_lastUpsTime;
 };
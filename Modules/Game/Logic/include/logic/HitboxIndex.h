@@ -0,0 +1,92 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+namespace MMM::Logic
+{
+
+struct Hitbox;
+
+/**
+ * @brief 渲染快照命中框的均匀网格索引。
+ *
+ * 主画布快照生成结束后按交互缩放后的命中框构建一次，UI 线程悬停拾取时
+ * 只读查询；预览、时间线等不拾取的画布不构建。网格覆盖
+ * 全部有限命中框的并集，单元尺寸取命中框平均尺寸（并限制单轴单元数），
+ * 使每个命中框平均只落入常数个单元；单元内容以 CSR 形式连续存放。非有限
+ * 命中框单独列出，每次查询都逐个精确判断，保持与线性扫描相同的结果。
+ * 点查询只访问一个单元，为 O(1 + k)。
+ */
+class HitboxIndex
+{
+public:
+    /// @brief 以交互缩放后的包围盒重建索引。
+    /// @param hitboxes 快照命中框，下标即查询结果中的编号。
+    /// @param scaleX 交互拾取横向缩放，语义同 scaleInteractionHitbox。
+    /// @param scaleY 交互拾取纵向缩放，语义同 scaleInteractionHitbox。
+    /// @warning 快照热路径：每个主画布视口每次生成快照调用一次；线性两遍构建，
+    /// 复用已有容量，稳定后不分配。
+    void build(const std::vector<Hitbox>& hitboxes, float scaleX,
+               float scaleY);
+
+    /// @brief 清空索引并保留容量。
+    void clear();
+
+    /// @brief 构建时的命中框数量；与快照命中框数量不一致说明索引已过期。
+    [[nodiscard]] std::size_t size() const { return m_bounds.size(); }
+
+    /// @brief 查询包含给定点的命中框（边界闭区间）。
+    /// @param x 画布局部坐标 X。
+    /// @param y 画布局部坐标 Y。
+    /// @param out 输出命中框下标，按下标降序排列，即最上层在前；先清空。
+    /// @warning UI 热路径：每帧悬停拾取调用；out 由调用方复用。
+    void queryPoint(float x, float y, std::vector<std::uint32_t>& out) const;
+
+private:
+    /// @brief 交互缩放后的闭区间包围盒。
+    struct Bounds {
+        float minX{ 0.0F };
+        float minY{ 0.0F };
+        float maxX{ 0.0F };
+        float maxY{ 0.0F };
+    };
+
+    /// @brief 单轴最多划分的单元数，限制网格本身的内存。
+    static constexpr std::int32_t MAX_CELLS_PER_AXIS = 256;
+
+    /// @brief 坐标所在的列，越界时夹到边缘列。
+    [[nodiscard]] std::int32_t columnOf(float x) const;
+
+    /// @brief 坐标所在的行，越界时夹到边缘行。
+    [[nodiscard]] std::int32_t rowOf(float y) const;
+
+    /// @brief 包围盒是否包含给定点。
+    [[nodiscard]] static bool contains(const Bounds& bounds, float x, float y)
+    {
+        return x >= bounds.minX && x <= bounds.maxX && y >= bounds.minY &&
+               y <= bounds.maxY;
+    }
+
+    /// @brief 全部命中框的交互包围盒，下标与快照命中框一致。
+    std::vector<Bounds> m_bounds;
+
+    /// @brief 各单元在 m_cellItems 中的起始偏移，末尾多一项哨兵。
+    std::vector<std::uint32_t> m_cellStart;
+
+    /// @brief 按单元连续存放的命中框下标，单元内升序。
+    std::vector<std::uint32_t> m_cellItems;
+
+    /// @brief 含非有限坐标、无法放入网格的命中框下标，升序。
+    std::vector<std::uint32_t> m_unbounded;
+
+    float        m_originX{ 0.0F };
+    float        m_originY{ 0.0F };
+    float        m_invCellWidth{ 0.0F };
+    float        m_invCellHeight{ 0.0F };
+    std::int32_t m_columns{ 0 };
+    std::int32_t m_rows{ 0 };
+};
+
+}  // namespace MMM::Logic
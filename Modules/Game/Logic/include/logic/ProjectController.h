@@ -12,12 +12,18 @@
 
 #include <atomic>
 #include <filesystem>
+#include <functional>
 #include <memory>
 #include <mutex>
 #include <optional>
 #include <string>
 #include <vector>
 
+namespace MMM
+{
+class BeatmapIndex;
+}
+
 namespace MMM::Logic
 {
 
@@ -212,6 +218,8 @@ public:
     void stopDirectoryWatcher();
 
     /// @brief 消费项目目录监听器捕获到的变更标记。
+    /// @details 当前项目的谱面索引完成后台刷新后同样返回 true，使资源列表
+    /// 按刷新后的摘要重新同步。
     /// @return 有待处理目录变更时返回 true。
     bool consumeDirectoryChangePending();
 
@@ -281,6 +289,10 @@ private:
     void publishProjectSwitchNeedsCanvasClose(
         const std::filesystem::path& projectPathToOpen, bool closeOnly) const;
 
+    /// @brief 生成后台谱面索引刷新完成时的回调。
+    std::function<void()> beatmapIndexRefreshedCallback(
+        const BeatmapIndex* beatmapIndex);
+
     /// @brief 打开项目请求事件订阅 ID。
     Event::SubscriptionID m_openProjectSubscription{ 0 };
 
@@ -366,6 +378,11 @@ private:
     /// @warning 项目请求入口跨线程读取；仅协作生命周期变化时写入，使用
     /// acquire/release 保证请求队列清理对后续请求可见。
     std::atomic_bool m_localProjectOpeningBlockedByCollaboration{ false };
+
+    /// @brief 当前项目的谱面索引是否已完成后台刷新、等待资源重新同步。
+    /// @warning 逻辑热路径原子：后台刷新任务写入，loop 每次迭代随目录变更
+    /// 标记一起 exchange，使用 acquire/release。
+    std::atomic<bool> m_beatmapIndexRefreshed{ false };
 };
 
 }  // namespace MMM::Logic
@@ -15,6 +15,7 @@
 namespace MMM
 {
 class BeatMap;
+struct BeatmapSummary;
 }
 
 namespace MMM::Logic
@@ -169,6 +170,16 @@ public:
     static std::vector<BeatmapAudioReference> collectBeatmapAudioReferences(
         const BeatMap& beatMap, const std::string& beatmapPath);
 
+    /// @brief 从谱面摘要展开音频引用，结果与加载谱面后收集的引用一致。
+    /// @param project 谱面所属项目。
+    /// @param mapPath 摘要对应的谱面文件路径。
+    /// @param summary 谱面摘要。
+    /// @param beatmapPath 用于诊断和相对路径解析的具体谱面路径。
+    /// @return 歌曲提示、玩家物件绑定和自动采样引用列表。
+    static std::vector<BeatmapAudioReference> collectBeatmapAudioReferences(
+        const Project& project, const std::filesystem::path& mapPath,
+        const BeatmapSummary& summary, const std::string& beatmapPath);
+
     /// @brief 判断谱面音频引用是否指向指定项目资源。
     /// @param project 资源所属项目。
     /// @param reference 待匹配的谱面引用。
@@ -249,6 +260,15 @@ public:
         const Project& project, const BeatMap& beatMap,
         const std::filesystem::path& beatmapPath);
 
+    /// @brief 按谱面摘要选择默认音频资源，规则与完整谱面版本一致。
+    /// @param project 谱面所属项目。
+    /// @param summary 谱面摘要。
+    /// @param beatmapPath 谱面的项目相对或绝对路径。
+    /// @return 优先匹配歌曲提示和 Main 自动采样的项目资源。
+    static const AudioResource* findDefaultBeatmapAudioResource(
+        const Project& project, const BeatmapSummary& summary,
+        const std::filesystem::path& beatmapPath);
+
     /// @brief 将旧项目条目的单主音轨迁移为 MMM v2 自动采样。
     /// @param project 当前目录扫描和资源合并后的项目。
     /// @param persistedProject 从旧项目描述文件读取的项目。
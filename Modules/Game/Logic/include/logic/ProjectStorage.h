@@ -42,6 +42,14 @@ public:
     [[nodiscard]] static std::filesystem::path storageDirectory(
         const std::filesystem::path& projectRoot);
 
+    /// @brief 获取项目内谱面二进制缓存目录。
+    [[nodiscard]] static std::filesystem::path beatmapCacheDirectory(
+        const std::filesystem::path& projectRoot);
+
+    /// @brief 获取项目谱面摘要索引文件。
+    [[nodiscard]] static std::filesystem::path beatmapIndexPath(
+        const std::filesystem::path& projectRoot);
+
     /// @brief 获取新分片格式入口文件。
     [[nodiscard]] static std::filesystem::path manifestPath(
         const std::filesystem::path& projectRoot);
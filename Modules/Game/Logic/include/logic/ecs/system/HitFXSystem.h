@@ -50,8 +50,14 @@ public:
         int    trackOffset{ 0 };  // 用于 Flick 等偏移物件
         double duration;
         bool   isSubNote;
-        /// @brief 物件命中时触发的可选采样绑定；为空时使用内置音效。
-        std::optional<::MMM::AudioSampleBinding> sampleBinding;
+        /// @brief 绑定采样的驻留资源标识；为空时使用内置音效。
+        const std::string* sampleResource{ nullptr };
+        /// @brief 绑定采样的物件音量倍率；未绑定时为 1。
+        float sampleVolume{ 1.0F };
+        /// @brief 所属顶层音符实体，时间线按它增量维护。
+        entt::entity entity{ entt::null };
+        /// @brief 折线子物件下标；普通音符为 -1。
+        std::int32_t subIndex{ -1 };
 
         bool operator<(const HitEvent& other) const
         {
@@ -102,7 +108,7 @@ public:
 
     /// @brief 判断打击事件是否绑定了可用的物件音效资源。
     /// @param ev 待检查的打击事件。
-    /// @return 绑定存在且资源标识非空时返回 true。
+    /// @return 绑定了非空资源标识时返回 true。
     /// @warning 逻辑预测播放热路径：只读取事件内存，不得访问资源容器。
     [[nodiscard]] static bool hasBoundSoundEffect(const HitEvent& ev) noexcept;
 
@@ -3,6 +3,7 @@
 #include "config/EditorConfig.h"
 #include "logic/BeatmapSyncBuffer.h"
 #include "logic/ecs/components/NoteComponent.h"
+#include "logic/session/TimeIntervalIndex.h"
 #include <entt/entt.hpp>
 #include <vector>
 
@@ -16,6 +17,7 @@ namespace MMM::Logic::System
 
 struct Batcher;
 struct ScrollCache;
+struct RetainedNoteGeometryCache;
 
 /**
  * @brief 音符渲染快照生成系统
@@ -30,8 +32,7 @@ public:
      *
      * @param registry 音符注册表
      * @param sampleRegistry 自动采样注册表
-     * @param sortedSampleEntities 已按覆盖区间起点排序的自动采样实体
-     * @param sortedSampleMaxEndPrefix 自动采样覆盖区间终点前缀最大值
+     * @param sampleIndex 按覆盖区间起点排序的自动采样时间区间索引
      * @param timelineRegistry 时间线注册表 (用于坐标积分映射)
      * @param snapshot 目标渲染快照缓冲区
      * @param cameraId 视口 ID
@@ -44,23 +45,44 @@ public:
      * @param config 编辑器配置
      * @param mainViewportHeight 主画布视口高度 (用于预览区缩放对齐)
      * @param hitFXSystem 打击特效系统 (可选)
+     * @param noteGeometryCache 本视口的音符基础层保留几何缓存 (可选)
      * @warning
      * 热路径：逻辑线程为每个活动视口生成渲染快照时执行；禁止文件系统访问、完整
      * entt 遍历、完整排序、try/catch 和 shared_ptr 所有权复制。
      */
     static void generateSnapshot(
         entt::registry& registry, entt::registry& sampleRegistry,
-        const std::vector<entt::entity>&             sortedSampleEntities,
-        const std::vector<double>&                   sortedSampleMaxEndPrefix,
+        const TimeIntervalIndex&                     sampleIndex,
         const entt::registry&                        timelineRegistry,
         const std::vector<const TimelineComponent*>& bpmEvents,
         RenderSnapshot* snapshot, const std::string& cameraId,
         double currentTime, float viewportWidth, float viewportHeight,
         float judgmentLineY, int32_t trackCount, int32_t bgmTrackCount,
         const Config::EditorConfig& config, float mainViewportHeight = 1000.0f,
-        class HitFXSystem* hitFXSystem = nullptr);
+        class HitFXSystem*         hitFXSystem       = nullptr,
+        RetainedNoteGeometryCache* noteGeometryCache = nullptr);
+
+    /**
+     * @brief 准备一轮快照生成共享的注册表状态
+     *
+     * 预先创建快照路径访问的组件存储，写入 ScrollCache 上下文槽，并在版本
+     * 变化时重建音符 AbsY 分桶索引。调用后直到本轮快照全部生成完毕，
+     * generateSnapshot 对三个注册表只读，不同视口可以并发生成各自的快照。
+     *
+     * @param registry 音符注册表
+     * @param sampleRegistry 自动采样注册表
+     * @param timelineRegistry 时间线注册表
+     * @warning 逻辑线程在快照阶段开始前串行调用；调用期间不得有并发读者。
+     */
+    static void prepareSnapshotPhase(entt::registry&       registry,
+                                     entt::registry&       sampleRegistry,
+                                     const entt::registry& timelineRegistry);
 
 private:
+    /// @brief 按需重建音符 AbsY 分桶索引，供 prepareSnapshotPhase 调用。
+    /// @warning 仅在音符或 ScrollCache 版本变化时完整扫描音符。
+    static void prepareNoteQueryIndex(entt::registry& registry);
+
     // --- 内部逻辑拆分方法 ---
 
     /// @warning 热路径：Timeline
@@ -149,7 +171,8 @@ private:
                             const Config::EditorConfig& config,
                             Batcher& batcher, float leftX, float clipLeftX,
                             float rightX, float topY, float bottomY,
-                            float singleTrackW, float renderScaleY);
+                            float singleTrackW, float renderScaleY,
+                            RetainedNoteGeometryCache* noteGeometryCache);
 
     /// @warning
     /// 热路径：音符渲染前每次执行；只读取快照和缓存，不得触发资源生命周期变更。
@@ -190,7 +213,32 @@ private:
         const std::vector<entt::entity>& noteEntities, Batcher& batcher,
         float currentTime, float judgmentLineY, float leftX, float rightX,
         float topY, float bottomY, float singleTrackW, float renderScaleY,
-        int32_t trackCount, bool generateHitboxes, bool showBoundSampleLabels);
+        int32_t trackCount, bool generateHitboxes, bool showBoundSampleLabels,
+        RetainedNoteGeometryCache* noteGeometryCache);
+
+    /// @brief 按时间分桶复用预生成几何绘制基础层。
+    /// @return 缺少可见性索引或缩放动画进行中时返回 false，由调用方改走
+    /// 逐物件绘制；HS 变化、拖动等只让所在分桶逐物件绘制。
+    /// @warning 热路径：仅在分桶首次可见或所在分桶失效时生成几何。
+    static bool renderRetainedNoteBaseLayer(
+        entt::registry& registry, RenderSnapshot* snapshot,
+        const NoteRenderContext& ctx, const Config::EditorConfig& config,
+        const std::vector<entt::entity>& visibleEntities, Batcher& batcher,
+        RetainedNoteGeometryCache& geometry, float judgmentLineY, float leftX,
+        float rightX, float topY, float bottomY, float singleTrackW,
+        float renderScaleY, bool generateHitboxes);
+
+    /// @brief 绘制单个基础层音符。
+    /// @param applyInteractionState 为 false 时忽略拖动、剪切与擦除高亮，
+    /// 按静态外观生成可缓存几何。
+    /// @warning 热路径：基础层逐物件执行；不得分配 GPU 资源或访问文件系统。
+    static void drawBaseNote(
+        entt::registry& registry, RenderSnapshot* snapshot,
+        const NoteRenderContext& ctx, const Config::EditorConfig& config,
+        Batcher& batcher, entt::entity entity, float judgmentLineY,
+        float leftX, float rightX, float topY, float bottomY,
+        float singleTrackW, float renderScaleY, bool generateHitboxes,
+        bool applyInteractionState);
 
     /// @warning
     /// 热路径：悬浮发光层每次快照生成时执行；只扫描当前可见实体列表，禁止完整
@@ -203,6 +251,8 @@ private:
         float topY, float bottomY, float singleTrackW, float renderScaleY);
 
     /// @brief 生成并绘制当前快照中的重叠物件顶层遮罩。
+    /// @note 后台检测结果与当前音符修订号一致时按可见时间范围查询，
+    /// 否则对可见实体同步运行同一检测引擎。
     /// @warning
     /// 热路径：每次音符快照生成时执行；只允许处理已剔除的可见实体集合，不得全量遍历
     /// ECS 或访问文件系统。
@@ -15,6 +15,8 @@ namespace MMM::Logic::System
  * @brief 音符坐标计算系统
  *
  * 此系统通过 ScrollCache 将音符的 timestamp/duration 映射到相对 Y 坐标与高度。
+ * Y 坐标相对最近一次完整映射时的判定线；时间线增量重建只重新映射
+ * 受影响的后缀音符，沿用同一原点。
  */
 class NoteTransformSystem
 {
@@ -28,7 +30,8 @@ public:
      * @param config 编辑器配置
      * @param beatmap 当前 Session 绑定的谱面；为空时使用保守默认值。
      * @warning 逻辑热路径：由 BeatmapSession update 调用；完整 registry view
-     * 遍历只能在缓存脏或强制重建时执行，禁止在此处排序。
+     * 遍历只能在缓存脏或强制重建时执行，禁止在此处排序。时间线条目的
+     * 增删改由 ScrollCache 信号触发刷新，无需 forceRebuild。
      */
     static void update(entt::registry& registry,
                        entt::registry& timelineRegistry, double currentTime,
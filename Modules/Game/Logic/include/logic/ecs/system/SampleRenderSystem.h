@@ -2,6 +2,7 @@
 
 #include "logic/BeatmapSyncBuffer.h"
 #include "logic/session/CanvasCamera.h"
+#include "logic/session/TimeIntervalIndex.h"
 
 #include <entt/entt.hpp>
 #include <vector>
@@ -37,8 +38,7 @@ public:
 
     /// @brief 绘制当前视口可见的自动采样并生成拾取盒。
     /// @param registry 自动采样注册表。
-    /// @param sortedEntities 按采样覆盖区间起点排序的实体缓存。
-    /// @param maxEndPrefix 采样覆盖区间终点的前缀最大值。
+    /// @param sampleIndex 按采样覆盖区间起点排序的时间区间索引。
     /// @param snapshot 目标渲染快照。
     /// @param batcher 画布批处理器。
     /// @param projection 玩家区与 BGM 区统一轨道投影。
@@ -52,9 +52,8 @@ public:
     /// @param renderScaleY 纵向渲染倍率。
     /// @warning 主画布快照热路径：只能查询预排序采样索引并处理可见物件，
     /// 禁止完整遍历 Registry、排序或访问文件系统。
-    static void renderSamples(entt::registry&                  registry,
-                              const std::vector<entt::entity>& sortedEntities,
-                              const std::vector<double>&       maxEndPrefix,
+    static void renderSamples(entt::registry&          registry,
+                              const TimeIntervalIndex& sampleIndex,
                               RenderSnapshot* snapshot, Batcher& batcher,
                               const CanvasLaneProjection& projection,
                               const ScrollCache*          cache,
@@ -3,6 +3,8 @@
 #include <cstddef>
 #include <cstdint>
 #include <entt/entt.hpp>
+#include <span>
+#include <unordered_map>
 #include <utility>
 #include <vector>
 
@@ -67,7 +69,9 @@ constexpr uint32_t SCROLL_EFFECT_HS     = 1 << 3;
  * @brief 全局流速映射缓存类
  *
  * 存储在时间线 registry 的 context 中。通过监听时间线组件的增删改事件
- * 将 isDirty 设为 true，从而实现“修改时 O(T) 重建，查询时 O(log T)”的极速性能。
+ * 记录变更实体，refresh() 只重新积分首个变更之后的分段后缀；全局参数
+ * （缩放、线性映射、谱面倍率）或 BPM 变化时仍整体重建。查询为 O(log T)，
+ * 已排序的批量查询为 O(n + T)。
  */
 class ScrollCache
 {
@@ -83,6 +87,28 @@ public:
     void rebuild(const entt::registry&       timelineRegistry,
                  const Config::EditorConfig& config, MMM::BeatMap* beatmap);
 
+    /// @brief 按需刷新缓存：isDirty 时完整重建，仅有时间线实体变更时只
+    /// 重新积分首个变更之后的分段。
+    /// @param timelineRegistry 时间线注册表。
+    /// @param config 当前编辑器配置。
+    /// @param beatmap 当前 Session 绑定的谱面；为空时使用保守默认值。
+    /// @return 缓存内容发生变化时返回 true。
+    /// @warning 逻辑热路径：每个 Session update 调用；无变更时只做常量级判断。
+    bool refresh(const entt::registry&       timelineRegistry,
+                 const Config::EditorConfig& config, MMM::BeatMap* beatmap);
+
+    /// @brief 记录单个时间线实体的增删改，等待下一次 refresh 增量处理。
+    /// @param entity 发生变化的时间线实体。
+    /// @warning 由时间线注册表信号调用；只追加实体，不读取组件。
+    void markTimelineChanged(entt::entity entity);
+
+    /// @brief 是否存在待处理的完整或增量重建。
+    bool needsRebuild() const { return isDirty || !m_changedEntities.empty(); }
+
+    /// @brief 最近一次重建影响的最早时间；完整重建时为负无穷。
+    /// @return 该时间之前的分段与 AbsY 映射保持不变。
+    double getLastRebuildFromTime() const { return m_lastRebuildFromTime; }
+
     /// @brief 设置渲染用动画时间线缩放比例。
     /// @param scale 当前动画缩放相对缓存目标缩放的比例。
     /// @warning 逻辑/渲染热路径：每个 Session update 执行；只做常量级赋值。
@@ -105,6 +131,22 @@ public:
     /// @brief 获取给定绝对 Y 坐标对应的时间戳 (反向映射)
     double getTime(double absY) const;
 
+    /// @brief 批量获取时间戳对应的绝对 Y 坐标与 HS 倍率。
+    /// @param times 查询时间，按升序排列时合并遍历分段。
+    /// @param absYs 输出 AbsY，长度须与 times 相同。
+    /// @param hs 可选的 HS 输出；为空时跳过，否则长度须与 times 相同。
+    /// @warning 热路径：升序输入为 O(n + T)；乱序元素退化为单次二分查找。
+    void getAbsYBatch(std::span<const double> times, std::span<double> absYs,
+                      std::span<double> hs = {}) const;
+
+    /// @brief 批量获取绝对 Y 坐标对应的时间戳 (反向映射)。
+    /// @param absYs 查询 AbsY，按升序排列时合并遍历分段。
+    /// @param times 输出时间，长度须与 absYs 相同。
+    /// @warning 热路径：AbsY 单调的缓存上升序输入为 O(n + T)；存在倒流或
+    /// 负向 Jump 时逐个回退到 getTime。
+    void getTimeBatch(std::span<const double> absYs,
+                      std::span<double>       times) const;
+
     /// @brief 将动画 AbsY 还原为缓存重建时的原始 AbsY。
     /// @param animatedAbsY 已应用动画缩放的 AbsY。
     /// @return 原始 AbsY。
@@ -131,6 +173,9 @@ public:
     /// @brief 是否存在 Jump 效果，存在时可见物件集合不再是连续时间区间
     bool hasJumpEffects() const;
 
+    /// @brief 是否存在生效的 HS 效果，存在时显示 Y 不再只由 AbsY 决定。
+    bool hasHsEffects() const;
+
     /// @brief 判断给定播放窗口是否可以用当前瞬时速度做 UI 侧线性补间。
     /// @param startTime 播放窗口起点时间。
     /// @param duration 播放窗口持续时间。
@@ -173,6 +218,43 @@ private:
     /// @brief 记录最后一次 rebuild 使用的目标缩放。
     double m_lastZoom{ 1.0 };
 
+    /// @brief 最近一次完整重建使用的全局参数，变化时不能增量重建。
+    const MMM::BeatMap* m_lastBeatmap{ nullptr };
+    bool                m_lastLinearMapping{ false };
+    double              m_refBpm{ 120.0 };
+    double              m_sliderMultiplier{ 1.0 };
+    double              m_mapLength{ 0.0 };
+
+    /// @brief 最近一次重建影响的最早时间。
+    double m_lastRebuildFromTime{ 0.0 };
+
+    /// @brief 排序后的时间线条目键。
+    struct TimingKey {
+        double       timestamp{ 0.0 };
+        bool         isBpm{ false };
+        entt::entity entity{ entt::null };
+    };
+
+    /// @brief 按积分顺序排列的全部时间线条目，增量重建据此切分前缀。
+    std::vector<TimingKey> m_timingOrder;
+
+    /// @brief 实体到其最近一次参与积分时的键，用于定位修改前的位置。
+    std::unordered_map<entt::entity, TimingKey> m_timingKeyOf;
+
+    /// @brief 自上次 refresh 以来发生变化的实体。
+    std::vector<entt::entity> m_changedEntities;
+
+    /// @brief 顺序积分时的滚动状态。
+    struct IntegrationState {
+        double currentBpm{ 0.0 };
+        double activeScrollValue{ 1.0 };
+        double currentScrollMult{ 1.0 };
+        double currentHs{ 1.0 };
+        double currentSpeed{ 0.0 };
+        double currentAbsY{ 0.0 };
+        double lastTime{ 0.0 };
+    };
+
     /// @brief 当前动画缩放相对 m_lastZoom 的比例。
     double m_animatedZoomScale{ 1.0 };
 
@@ -194,6 +276,13 @@ private:
     /// @brief 当前缓存是否包含 Jump 断层。
     bool m_hasJumpEffects{ false };
 
+    /// @brief 当前缓存是否包含生效的 HS 倍率。
+    bool m_hasHsEffects{ false };
+
+    /// @brief 首个速度为负或 AbsY 回退的分段下标；不小于分段数表示 AbsY
+    /// 随时间单调不减，批量反向映射可以合并遍历。
+    std::size_t m_firstNonMonotonicSegment{ 0 };
+
     struct TimingEntry {
         entt::entity             entity;
         const TimelineComponent* component;
@@ -216,9 +305,29 @@ private:
     /// @brief 重建 AbsY 区间索引。
     void rebuildAbsYRangeIndex();
 
-    /// @brief 重建亚帧抵消脉冲窗口。
-    /// @warning 逻辑低频路径：仅在 ScrollCache rebuild 时完整扫描分段。
-    void rebuildMicroImpulseWindows();
+    /// @brief 只重建从 firstSegment 开始的 AbsY 区间索引项。
+    /// @warning 逻辑低频路径：线性过滤旧项，仅对后缀新项排序后归并。
+    void rebuildAbsYRangeIndexFrom(std::size_t firstSegment);
+
+    /// @brief 根据 BPM 与 SV 倍率计算积分速度。
+    double calcSpeed(double bpm, double scrollMult) const;
+
+    /// @brief 把单个时间线条目积分进 m_segments 末尾。
+    void integrateTimingEntry(IntegrationState& state, entt::entity entity,
+                              const TimelineComponent& timeline);
+
+    /// @brief 重新积分 m_changedEntities 之后的分段后缀。
+    /// @return 变更涉及 BPM 或分段起点等无法增量处理的情况时返回 false。
+    bool rebuildSuffix(const entt::registry& timelineRegistry);
+
+    /// @brief 重建完成后刷新派生索引；只处理 firstChangedSegment 之后的部分。
+    void finishRebuild(std::size_t firstChangedSegment);
+
+    /// @brief 重建 firstChangedSegment 之后的亚帧抵消脉冲窗口。
+    /// @param firstChangedSegment 首个可能变化的分段；为 0 时完整扫描。
+    /// @warning 逻辑低频路径：增量重建时只扫描后缀，并把
+    /// m_lastRebuildFromTime 前移到重新扫描的起点。
+    void rebuildMicroImpulseWindows(std::size_t firstChangedSegment);
 
     /// @brief 获取原始分段积分 AbsY，不应用动画缩放或亚帧脉冲窗口修正。
     /// @param t 查询时间。
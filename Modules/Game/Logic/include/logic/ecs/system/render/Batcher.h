@@ -10,6 +10,13 @@ namespace MMM::Logic::System
 using TextureID          = MMM::Logic::TextureID;
 using BackgroundFillMode = MMM::Config::BackgroundFillMode;
 
+/// @brief 预生成几何中共用同一纹理的一段连续索引。
+struct RetainedGeometryRun {
+    TextureID     texture{ TextureID::None };
+    std::uint32_t indexOffset{ 0 };
+    std::uint32_t indexCount{ 0 };
+};
+
 // 内部批处理器，负责根据 TextureID 自动切分 DrawCall
 struct Batcher {
     RenderSnapshot*                snapshot;
@@ -396,6 +403,40 @@ struct Batcher {
         pushArc(x + r, y - h + r, 0.5f * PI, PI);         // Bottom-Left
     }
 
+    /// @brief 追加一段预生成几何，所有顶点纵向平移 offsetY。
+    /// @param vertices 预生成顶点。
+    /// @param indices 相对 vertices 的局部下标。
+    /// @param runs 按纹理切分的绘制段。
+    /// @param offsetY 纵向平移量。
+    /// @warning 热路径：保留几何每帧只经过这里拷贝；禁止逐顶点查 UV。
+    void pushRetainedGeometry(
+        const std::vector<Graphic::Vertex::VKBasicVertex>& vertices,
+        const std::vector<std::uint32_t>&                  indices,
+        const std::vector<RetainedGeometryRun>& runs, float offsetY)
+    {
+        const auto baseIndex =
+            static_cast<std::uint32_t>(snapshot->vertices.size());
+        snapshot->vertices.reserve(snapshot->vertices.size() + vertices.size());
+        for ( auto vertex : vertices ) {
+            vertex.pos.y += offsetY;
+            snapshot->vertices.push_back(vertex);
+        }
+
+        snapshot->indices.reserve(snapshot->indices.size() + indices.size());
+        for ( const auto& run : runs ) {
+            setTexture(run.texture);
+            if ( currentCmd.indexCount == 0 ) {
+                currentCmd.indexOffset =
+                    static_cast<uint32_t>(snapshot->indices.size());
+            }
+            const auto begin = indices.begin() + run.indexOffset;
+            for ( auto it = begin; it != begin + run.indexCount; ++it ) {
+                snapshot->indices.push_back(baseIndex + *it);
+            }
+            currentCmd.indexCount += run.indexCount;
+        }
+    }
+
     void flush()
     {
         if ( currentCmd.indexCount > 0 ) {
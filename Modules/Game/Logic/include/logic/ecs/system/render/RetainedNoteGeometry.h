@@ -0,0 +1,130 @@
+#pragma once
+
+#include "logic/BeatmapSyncBuffer.h"
+#include "logic/ecs/system/render/Batcher.h"
+#include <cstdint>
+#include <glm/glm.hpp>
+#include <unordered_map>
+#include <vector>
+
+namespace MMM::Logic::System
+{
+
+/// @brief 保留几何时间分桶的跨度（秒）。
+constexpr double RETAINED_NOTE_CHUNK_SECONDS = 1.0;
+
+/// @brief 分桶连续多少个 tick 未被绘制后释放。
+constexpr std::uint64_t RETAINED_NOTE_CHUNK_IDLE_TICKS = 240;
+
+/**
+ * @brief 单个时间分桶内全部静态音符的预生成几何。
+ *
+ * 顶点 Y 相对分桶原点 originAbsY 记录，绘制时按分桶 HS 整体平移即可
+ * 得到当前卷轴位置的屏幕坐标。几何按静态外观生成：拖动、剪切与擦除
+ * 高亮不写入缓存，出现这些状态的分桶当帧改走逐物件绘制。
+ */
+struct RetainedNoteChunk {
+    /// @brief 生成几何时使用的动画 AbsY 原点。
+    double originAbsY{ 0.0 };
+
+    /// @brief 分桶覆盖范围内统一的 HS 倍率。
+    double hs{ 1.0 };
+
+    /// @brief 几何依赖的最晚时间：分桶终点与成员结束时间的较大者；
+    /// 滚动缓存从该时间之前开始重建时分桶失效。
+    double coverageEndTime{ 0.0 };
+
+    /// @brief 分桶几何顶点，Y 为相对原点的屏幕偏移。
+    std::vector<Graphic::Vertex::VKBasicVertex> vertices;
+
+    /// @brief 分桶内局部顶点下标。
+    std::vector<std::uint32_t> indices;
+
+    /// @brief 按纹理切分的绘制段。
+    std::vector<RetainedGeometryRun> runs;
+
+    /// @brief 最近一次被绘制时的 tick。
+    std::uint64_t lastUsedTick{ 0 };
+
+    /// @brief 分桶包含折线或覆盖范围内 HS 变化等不可整体平移的几何时为
+    /// false。
+    bool cacheable{ true };
+};
+
+/// @brief 决定音符基础层外观的全局输入；任一变化都会使缓存整体失效。
+/// 音符编辑与时间线增量重建按时间范围逐分桶失效，不在此列。
+struct RetainedNoteGeometryKey {
+    const ScrollCache* cache{ nullptr };
+    std::uint64_t      atlasUvRevision{ 0 };
+    std::size_t        uvCount{ 0 };
+    double             animatedZoomScale{ 1.0 };
+    float              leftX{ 0.0f };
+    float              singleTrackW{ 0.0f };
+    float              noteW{ 0.0f };
+    float              noteH{ 0.0f };
+    float              renderScaleY{ 0.0f };
+    glm::vec4          colorTap{ 0.0f };
+    glm::vec4          colorHead{ 0.0f };
+    glm::vec4          colorHold{ 0.0f };
+    glm::vec4          colorEnd{ 0.0f };
+    glm::vec4          colorArrow{ 0.0f };
+    BackgroundFillMode noteFillMode{ BackgroundFillMode::Stretch };
+    bool               enableDraftLanes{ false };
+
+    bool operator==(const RetainedNoteGeometryKey&) const = default;
+};
+
+/**
+ * @brief 单个视口的音符基础层保留几何缓存。
+ *
+ * 按音符时间戳以 RETAINED_NOTE_CHUNK_SECONDS 分桶，仅在分桶首次进入视口
+ * 时生成几何；播放滚动期间每帧只做平移拷贝。音符编辑只失效修改前后
+ * 起始时间所在的分桶，时间线增量重建只失效覆盖范围到达重建起点的分桶；
+ * 图集 UV、皮肤颜色、布局或目标缩放变化时整体失效。
+ * @warning 逻辑线程专用；并行生成快照时每个视口持有独立实例。
+ */
+struct RetainedNoteGeometryCache {
+    /// @brief 当前缓存内容对应的全局输入。
+    RetainedNoteGeometryKey key;
+
+    /// @brief 分桶已同步到的音符索引版本号。
+    std::uint64_t noteRevision{ 0 };
+
+    /// @brief 分桶已同步到的滚动缓存版本号。
+    std::uint64_t scrollRevision{ 0 };
+
+    /// @brief 上一帧的动画缩放比例；缩放动画进行中逐物件绘制，稳定后
+    /// 才按新缩放重建，避免每帧整体失效。
+    double lastZoomScale{ 1.0 };
+
+    /// @brief 分桶下标到预生成几何。
+    std::unordered_map<std::int64_t, RetainedNoteChunk> chunks;
+
+    /// @brief 每次使用缓存递增的 tick。
+    std::uint64_t tick{ 0 };
+
+    /// @brief 生成分桶几何使用的临时快照，只携带图集 UV。
+    RenderSnapshot buildSnapshot;
+
+    /// @brief 生成分桶时收集成员的临时列表。
+    std::vector<entt::entity> buildMembers;
+
+    /// @brief 当帧可见分桶的临时列表。
+    std::vector<std::int64_t> frameChunks;
+
+    /// @brief 当帧需要逐物件绘制的分桶。
+    std::vector<std::int64_t> frameDynamicChunks;
+
+    /// @brief 当前拖动手势途经的分桶，拖动结束时统一失效。
+    std::vector<std::int64_t> dragChunks;
+
+    /// @brief 丢弃全部分桶几何。
+    void invalidate()
+    {
+        chunks.clear();
+        dragChunks.clear();
+        buildSnapshot.uvMap.clear();
+    }
+};
+
+}  // namespace MMM::Logic::System
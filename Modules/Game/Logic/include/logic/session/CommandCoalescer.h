@@ -0,0 +1,81 @@
+#pragma once
+
+#include "common/LogicCommands.h"
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+namespace MMM::Logic
+{
+
+/// @brief 单个逻辑 tick 的命令队列计数。
+struct CommandQueueTickStats {
+    /// @brief 本 tick 从队列取出的命令数。
+    std::uint32_t enqueued{ 0 };
+
+    /// @brief 被后续同类命令覆盖或合并而跳过的命令数。
+    std::uint32_t coalesced{ 0 };
+
+    /// @brief 实际分派给控制器的命令数。
+    std::uint32_t applied{ 0 };
+};
+
+/**
+ * @brief 逻辑线程取出一批命令后的合并阶段。
+ *
+ * 高频交互（鼠标位置、悬停、拖动/框选更新、视口尺寸、进度条预览）是幂等
+ * 状态写入：同一屏障区间内同目标只保留最后一条，保持其原有位置。滚轮与
+ * 中键平移是增量变换：相邻的同目标命令累加为一条。其余命令均视为屏障，
+ * 不跨越它们合并，保证编辑、撤销与工具切换看到的状态与逐条执行一致。
+ * @warning 逻辑热路径：每个 Session update 调用；复用内部缓冲，不分配。
+ */
+class CommandCoalescer
+{
+public:
+    /// @brief 就地合并一批按入队顺序排列的命令。
+    /// @param batch 待合并命令，返回时只保留需要执行的命令。
+    /// @param scrollSnap 是否启用滚动吸附；吸附时每格滚轮按当前 BPM
+    /// 段独立取整，不再累加。
+    /// @return 被移除的命令数。
+    std::size_t coalesce(std::vector<LogicCommand>& batch, bool scrollSnap);
+
+private:
+    /// @brief 幂等命令的合并目标。
+    struct CommandKey {
+        std::size_t        kind{ 0 };
+        const std::string* cameraId{ nullptr };
+        std::uint32_t      flags{ 0 };
+
+        bool operator==(const CommandKey& other) const
+        {
+            return kind == other.kind && flags == other.flags &&
+                   (cameraId == other.cameraId ||
+                    (cameraId && other.cameraId &&
+                     *cameraId == *other.cameraId));
+        }
+    };
+
+    /// @brief 命令在合并阶段的角色。
+    enum class MergeRule : std::uint8_t {
+        Barrier,     ///< 不参与合并，也不允许跨越它合并
+        LastWins,    ///< 幂等状态写入，只保留最后一条
+        Accumulate,  ///< 增量变换，与相邻同目标命令累加
+    };
+
+    /// @brief 判断命令的合并角色，并为幂等命令填写合并目标。
+    static MergeRule classify(const LogicCommand& command, CommandKey& key);
+
+    /// @brief 尝试把增量命令 next 累加进紧邻的 into。
+    /// @return 合并成功、next 可丢弃时返回 true。
+    static bool accumulate(LogicCommand& into, const LogicCommand& next,
+                           bool scrollSnap);
+
+    /// @brief 命令是否保留的标记。
+    std::vector<std::uint8_t> m_keep;
+
+    /// @brief 逆序扫描时当前屏障区间内已保留的幂等目标。
+    std::vector<CommandKey> m_seenKeys;
+};
+
+}  // namespace MMM::Logic
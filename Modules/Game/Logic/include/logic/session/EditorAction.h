@@ -2,6 +2,10 @@
 
 #include "mmm/beatmap/BeatmapMutationObserver.h"
 
+#include <cstddef>
+#include <cstdint>
+#include <filesystem>
+#include <fstream>
 #include <memory>
 #include <string>
 #include <utility>
@@ -35,12 +39,34 @@ public:
 
     /// @brief 返回该操作执行、撤销或重做会修改的谱面数据类别。
     [[nodiscard]] virtual ::MMM::BeatmapMutationFlags mutationFlags() const = 0;
+
+    /// @brief 估算该操作在撤销历史中占用的字节数，包含堆上数据。
+    [[nodiscard]] virtual std::size_t memoryUsage() const;
 };
 
-/// @brief 操作栈管理器，维护撤销栈和重做栈。
+/**
+ * @brief 操作栈管理器，维护撤销栈和重做栈。
+ *
+ * 两个栈顶各保留 HOT_ENTRY_COUNT 条活跃操作；更早的操作经
+ * EditorActionCodec 编码为紧凑字节流。占用超出内存预算时，最旧的已编码
+ * 操作压缩后追加到溢出文件，深度撤销时再透明读回；不支持编码的操作或
+ * 未设置溢出文件时，从最旧的历史开始丢弃。
+ * @warning 逻辑线程专用；编码与溢出只发生在入栈、撤销与重做时。
+ */
 class EditorActionStack
 {
 public:
+    /// @brief 每个栈顶保持活跃、不参与编码的操作数量。
+    static constexpr std::size_t HOT_ENTRY_COUNT = 16;
+
+    /// @brief 溢出文件中失效记录超过该字节数且多于有效记录时压缩文件。
+    static constexpr std::size_t SPILL_COMPACT_MIN_BYTES = 64 * 1024;
+
+    EditorActionStack() = default;
+    EditorActionStack(const EditorActionStack&)            = delete;
+    EditorActionStack& operator=(const EditorActionStack&) = delete;
+    ~EditorActionStack();
+
     /// @brief 执行并推送新操作到栈中，同时清空重做栈
     /// @param action 要执行的操作
     /// @param ctx 会话上下文引用
@@ -55,9 +81,23 @@ public:
     /// @param ctx 会话上下文引用
     void redo(SessionContext& ctx);
 
-    /// @brief 清空所有栈
+    /// @brief 清空所有栈并删除溢出文件。
     void clear();
 
+    /// @brief 设置撤销历史内存预算；下一次入栈、撤销或重做时生效。
+    /// @param bytes 预算字节数；0 表示不限制。
+    void setMemoryBudget(std::size_t bytes) { m_memoryBudget = bytes; }
+
+    /// @brief 设置溢出文件路径；为空时超出预算的历史直接丢弃。
+    /// @warning 会删除旧溢出文件，调用前需确认其中历史已不再需要。
+    void setSpillPath(std::filesystem::path path);
+
+    /// @brief 获取撤销历史当前占用的内存字节数。
+    [[nodiscard]] std::size_t getMemoryUsage() const { return m_memoryUsage; }
+
+    /// @brief 获取溢出文件中仍被历史引用的压缩字节数。
+    [[nodiscard]] std::size_t getSpilledBytes() const { return m_spilledBytes; }
+
     /// @brief 是否有未保存的修改
     bool isDirty() const;
 
@@ -84,10 +124,80 @@ public:
     size_t getRedoStackSize() const { return m_redoStack.size(); }
 
 private:
-    std::vector<std::unique_ptr<IEditorAction>> m_undoStack;  ///< 撤销栈
-    std::vector<std::unique_ptr<IEditorAction>> m_redoStack;  ///< 重做栈
+    /// @brief 撤销历史条目；操作处于活跃、内存编码或溢出三种状态之一。
+    struct HistoryEntry {
+        /// @brief 活跃操作；已编码时为空。
+        std::unique_ptr<IEditorAction> action;
+
+        /// @brief 内存中的紧凑编码；溢出或活跃时为空。
+        std::string packed;
+
+        /// @brief 操作的数据类别，无需解码即可查询。
+        ::MMM::BeatmapMutationFlags flags{ ::MMM::BeatmapMutationFlags::None };
+
+        /// @brief 操作类型不支持紧凑编码时为 false，保持活跃。
+        bool packable{ true };
+
+        /// @brief 是否已写入溢出文件。
+        bool spilled{ false };
+
+        /// @brief 溢出记录在文件中的偏移。
+        std::uint64_t spillOffset{ 0 };
+
+        /// @brief 溢出记录的压缩字节数。
+        std::uint32_t spillBytes{ 0 };
+
+        /// @brief 溢出记录解压后的字节数。
+        std::uint32_t packedBytes{ 0 };
+
+        /// @brief 最近一次估算的内存占用。
+        std::size_t memoryBytes{ 0 };
+    };
+
+    /// @brief 将栈顶条目还原为活跃操作。
+    /// @return 编码或溢出记录损坏时返回 false。
+    bool restore(HistoryEntry& entry);
+
+    /// @brief 编码离开热区的条目，并按预算溢出或丢弃最旧历史。
+    void enforceMemoryBudget();
+
+    /// @brief 将已编码条目压缩写入溢出文件。
+    bool spill(HistoryEntry& entry);
+
+    /// @brief 丢弃撤销栈底部 count 条历史并修正保存位置。
+    void dropOldestUndo(std::size_t count);
+
+    /// @brief 重新统计内存与溢出占用；失效记录过多时压缩溢出文件。
+    void refreshUsage();
+
+    /// @brief 将仍被引用的溢出记录前移到文件开头并截断尾部。
+    void compactSpillFile();
+
+    /// @brief 估算单个条目的内存占用。
+    static std::size_t entryMemory(const HistoryEntry& entry);
+
+    std::vector<HistoryEntry> m_undoStack;  ///< 撤销栈
+    std::vector<HistoryEntry> m_redoStack;  ///< 重做栈
     size_t m_saveIndex{ 0 };  ///< 上次保存时的撤销栈深度
 
+    /// @brief 撤销历史内存预算；0 表示不限制。
+    std::size_t m_memoryBudget{ 0 };
+
+    /// @brief 最近一次统计的内存占用。
+    std::size_t m_memoryUsage{ 0 };
+
+    /// @brief 最近一次统计的溢出文件有效字节数。
+    std::size_t m_spilledBytes{ 0 };
+
+    /// @brief 溢出文件路径；为空时禁用溢出。
+    std::filesystem::path m_spillPath;
+
+    /// @brief 溢出文件句柄，首次溢出时打开。
+    std::fstream m_spillFile;
+
+    /// @brief 溢出文件下一条记录的写入偏移。
+    std::uint64_t m_spillEnd{ 0 };
+
     /// @brief 是否存在未进入撤销栈且尚未保存的编辑。
     bool m_hasNonUndoableChanges{ false };
 
@@ -125,7 +235,12 @@ public:
     /// @brief 合并全部子操作的数据类别。
     [[nodiscard]] ::MMM::BeatmapMutationFlags mutationFlags() const override;
 
+    /// @brief 累加全部子操作的占用。
+    [[nodiscard]] std::size_t memoryUsage() const override;
+
 private:
+    friend struct EditorActionCodecAccess;
+
     std::vector<std::unique_ptr<IEditorAction>> m_actions;  ///< 子操作。
     std::string                                 m_name;  ///< 用户可读操作名称。
 };
@@ -0,0 +1,47 @@
+#pragma once
+
+#include <cstddef>
+#include <memory>
+#include <string>
+#include <string_view>
+
+namespace MMM::Logic
+{
+
+class IEditorAction;
+struct NoteComponent;
+struct TimelineComponent;
+
+/**
+ * @brief 撤销历史的紧凑二进制编码。
+ *
+ * 离开撤销栈热区的操作被编码为字节流：新建/删除条目保存完整组件，更新
+ * 条目保存变更后组件与按字段掩码记录的变更前差异。批量重排、镜像与对齐
+ * 只改动时间与轨道，元数据、注释与折线子物件只保存一份。编码只在同一进程
+ * 内解码，不承担跨版本兼容。
+ * @warning 低频编辑路径：仅在操作入栈、撤销与重做时调用。
+ */
+class EditorActionCodec
+{
+public:
+    /// @brief 编码操作。
+    /// @param action 待编码操作。
+    /// @param out 接收字节流；失败时内容未定义。
+    /// @return 操作类型不支持紧凑编码时返回 false。
+    [[nodiscard]] static bool encode(const IEditorAction& action,
+                                     std::string&         out);
+
+    /// @brief 解码 encode 生成的字节流。
+    /// @return 字节流损坏时返回空。
+    [[nodiscard]] static std::unique_ptr<IEditorAction> decode(
+        std::string_view payload);
+
+    /// @brief 估算音符组件占用的字节数，包含堆上的元数据与子物件。
+    [[nodiscard]] static std::size_t estimateBytes(const NoteComponent& note);
+
+    /// @brief 估算时间线组件占用的字节数，包含堆上的元数据。
+    [[nodiscard]] static std::size_t estimateBytes(
+        const TimelineComponent& timeline);
+};
+
+}  // namespace MMM::Logic
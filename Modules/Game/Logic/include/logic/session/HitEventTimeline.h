@@ -0,0 +1,103 @@
+#pragma once
+
+#include "logic/ecs/components/NoteComponent.h"
+#include "logic/ecs/system/HitFXSystem.h"
+#include <cstddef>
+#include <entt/entt.hpp>
+#include <span>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+namespace MMM::Logic
+{
+
+/// @brief 把采样资源标识驻留到进程级字符串池。
+/// @param resourceId 采样资源标识。
+/// @return 进程生命周期内地址稳定的驻留字符串；空标识返回 nullptr。
+/// @warning 编辑路径调用：首次出现的资源会分配一次，之后只做一次哈希查找；
+/// 打击音效调度只解引用返回的指针，不复制字符串。
+const std::string* internSampleResource(std::string_view resourceId);
+
+/**
+ * @brief 按 (时间, 实体, 子物件下标) 排序的打击事件时间线。
+ *
+ * 事件保存在连续数组中，播放、预读与补建 Hold 的游标继续按下标推进。
+ * 每个顶层音符记录其事件的时间跨度，音符变更时只在该跨度内删除旧事件，
+ * 再按当前组件插入新事件；大批量变更改为一次过滤加一次归并。采样绑定以
+ * 驻留字符串指针保存，事件可按值复制而不触及堆内存。
+ */
+class HitEventTimeline
+{
+public:
+    using HitEvent = System::HitFXSystem::HitEvent;
+
+    /// @brief 超过该数量的变更改为整体过滤与归并，避免逐条搬移数组尾部。
+    static constexpr std::size_t SMALL_BATCH_SIZE = 16;
+
+    /// @brief 把一个正式顶层音符展开为打击事件追加到 out。
+    /// @param entity 音符实体。
+    /// @param note 音符组件；草稿与折线子物件实体不产生事件。
+    /// @param out 输出事件列表。
+    static void appendNoteEvents(entt::entity entity, const NoteComponent& note,
+                                 std::vector<HitEvent>& out);
+
+    /// @brief 按音符注册表整体重建。
+    /// @param noteRegistry 当前会话的音符注册表。
+    /// @return 正式音符的最晚结束时间（秒），没有音符时为 0。
+    /// @warning 低频路径：载入谱面或整体替换后调用，会遍历完整注册表。
+    double rebuild(const entt::registry& noteRegistry);
+
+    /// @brief 按实体当前组件刷新其事件；已销毁的实体只删除旧事件。
+    /// @param noteRegistry 当前会话的音符注册表。
+    /// @param entities 已完成 ECS 写入的变更实体，允许重复。
+    /// @return 重新插入音符的最晚结束时间（秒），没有插入时为 0。
+    /// @warning 逻辑编辑热路径：只访问变更实体，不遍历注册表。
+    double apply(const entt::registry&         noteRegistry,
+                 std::span<const entt::entity> entities);
+
+    /// @brief 清空全部事件。
+    void clear();
+
+    /// @brief 按触发时间升序排列的完整事件序列。
+    [[nodiscard]] const std::vector<HitEvent>& events() const
+    {
+        return m_events;
+    }
+
+    [[nodiscard]] std::size_t size() const { return m_events.size(); }
+    [[nodiscard]] bool        empty() const { return m_events.empty(); }
+
+    const HitEvent& operator[](std::size_t index) const
+    {
+        return m_events[index];
+    }
+
+    [[nodiscard]] std::vector<HitEvent>::const_iterator begin() const
+    {
+        return m_events.begin();
+    }
+    [[nodiscard]] std::vector<HitEvent>::const_iterator end() const
+    {
+        return m_events.end();
+    }
+
+    /// @brief 事件有序且实体时间跨度表与事件一致。
+    [[nodiscard]] bool isConsistent() const;
+
+private:
+    /// @brief 按 (时间, 实体, 子物件下标) 比较。
+    [[nodiscard]] static bool keyLess(const HitEvent& lhs,
+                                      const HitEvent& rhs);
+
+    /// @brief 记录新插入事件所属实体的时间跨度。
+    void recordSpans(std::span<const HitEvent> added);
+
+    std::vector<HitEvent> m_events;
+    /// @brief 各实体事件的最早与最晚触发时间，用于限定删除范围。
+    std::unordered_map<entt::entity, std::pair<double, double>> m_spanOf;
+};
+
+}  // namespace MMM::Logic
@@ -49,7 +49,12 @@ public:
         return ::MMM::BeatmapMutationFlags::Objects;
     }
 
+    /// @brief 估算变更前后两份音符数据的占用。
+    [[nodiscard]] std::size_t memoryUsage() const override;
+
 private:
+    friend struct EditorActionCodecAccess;
+
     Type                         m_type;    ///< 操作类型
     entt::entity                 m_entity;  ///< 实体 ID
     std::optional<NoteComponent> m_before;  ///< 变更前数据
@@ -108,7 +113,12 @@ public:
         return m_mutationFlags;
     }
 
+    /// @brief 估算全部条目的占用。
+    [[nodiscard]] std::size_t memoryUsage() const override;
+
 private:
+    friend struct EditorActionCodecAccess;
+
     std::vector<Entry> m_entries;  ///< 条目列表
     std::string        m_name;     ///< 操作名称
     /// @brief 该动作对协作同步声明的精确变更类别。
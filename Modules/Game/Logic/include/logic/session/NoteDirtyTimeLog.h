@@ -0,0 +1,76 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+
+namespace MMM::Logic
+{
+
+/**
+ * @brief 按音符索引版本号记录增量编辑触及的起始时间。
+ *
+ * 增量维护路径每次提交时写入受影响音符修改前后的起始时间，渲染侧的
+ * 保留几何缓存据此只重建对应的时间分桶。只保留最近 MAX_ENTRIES 条；
+ * 完整重建、剔除或条目溢出时推进完整起点，落后于它的读取方只能整体失效。
+ * @warning 逻辑线程写入；并行生成快照期间只读。
+ */
+class NoteDirtyTimeLog
+{
+public:
+    /// @brief 单条脏时间记录。
+    struct Entry {
+        /// @brief 编辑提交后的音符索引版本号。
+        std::uint64_t revision{ 0 };
+        /// @brief 受影响音符的起始时间（秒）。
+        double startTime{ 0.0 };
+    };
+
+    /// @brief 保留的最大记录数，超出时丢弃最旧的记录。
+    static constexpr std::size_t MAX_ENTRIES = 4096;
+
+    /// @brief 记录一次增量编辑触及的起始时间。
+    /// @param revision 编辑提交后的音符索引版本号，须单调不减。
+    /// @param startTime 受影响音符的起始时间（秒）。
+    void record(std::uint64_t revision, double startTime)
+    {
+        if ( m_entries.size() == MAX_ENTRIES ) {
+            m_completeAfter = m_entries.front().revision;
+            m_entries.pop_front();
+        }
+        m_entries.push_back({ revision, startTime });
+    }
+
+    /// @brief 记录无法给出时间范围的完整重建。
+    /// @param revision 重建后的音符索引版本号。
+    void recordFull(std::uint64_t revision)
+    {
+        m_entries.clear();
+        m_completeAfter = revision;
+    }
+
+    /// @brief 已处理到 revision 的读取方能否只按记录增量失效。
+    [[nodiscard]] bool canReplayAfter(std::uint64_t revision) const
+    {
+        return revision >= m_completeAfter;
+    }
+
+    /// @brief 对版本号晚于 revision 的每条记录调用 callback(startTime)。
+    /// @warning 调用前须以 canReplayAfter 确认记录完整。
+    template<typename Callback>
+    void forEachAfter(std::uint64_t revision, Callback&& callback) const
+    {
+        for ( auto it = m_entries.rbegin();
+              it != m_entries.rend() && it->revision > revision;
+              ++it ) {
+            callback(it->startTime);
+        }
+    }
+
+private:
+    std::deque<Entry> m_entries;
+    /// @brief 晚于该版本号的编辑都有完整记录。
+    std::uint64_t m_completeAfter{ 0 };
+};
+
+}  // namespace MMM::Logic
@@ -0,0 +1,170 @@
+#pragma once
+
+#include "logic/ecs/components/NoteComponent.h"
+#include <cstddef>
+#include <cstdint>
+#include <entt/entity/entity.hpp>
+#include <optional>
+#include <stop_token>
+#include <vector>
+
+namespace MMM::Logic
+{
+
+/// @brief 参与重叠检测的单个判定物件；折线按子物件逐段展开。
+struct OverlapItem {
+    /// @brief 判定物件类型（不会是 POLYLINE）。
+    ::MMM::NoteType type{ ::MMM::NoteType::NOTE };
+    /// @brief 起始时间，单位秒。
+    double startTime{ 0.0 };
+    /// @brief 结束时间，单位秒；只有 Hold 晚于起始时间。
+    double endTime{ 0.0 };
+    /// @brief 起始轨道。
+    std::int32_t track{ 0 };
+    /// @brief Flick 轨道增量。
+    std::int32_t dtrack{ 0 };
+    /// @brief 顶层物件实体；同一折线的子物件共享该实体，互不判为重叠。
+    entt::entity owner{ entt::null };
+    /// @brief 折线子物件下标；顶层物件为 -1。
+    std::int32_t subIndex{ -1 };
+    /// @brief 顶层物件的起始时间；增量合并按脏时间据此定位被编辑的物件。
+    double ownerTime{ 0.0 };
+};
+
+/// @brief 重叠区域在谱面空间中的形状，决定遮罩的绘制方式。
+enum class OverlapRegionShape : std::uint8_t {
+    Point,      ///< 判定点（含跨越时间窗口的点簇），按物件尺寸绘制
+    HoldBody,   ///< 多个长条身体在同一轨道上的重叠时段
+    FlickBody,  ///< 两个 Flick 横向身体在相近时间的重叠轨道段
+};
+
+/// @brief 谱面空间（时间 × 轨道）中的一个重叠区域。
+struct OverlapRegion {
+    /// @brief 区域形状。
+    OverlapRegionShape shape{ OverlapRegionShape::Point };
+    /// @brief Point 遮罩相对物件尺寸的缩放。
+    float scale{ 1.0F };
+    /// @brief 起始轨道；FlickBody 为重叠段左端。
+    std::int32_t trackBegin{ 0 };
+    /// @brief 结束轨道；FlickBody 为重叠段右端，其余与起始轨道相同。
+    std::int32_t trackEnd{ 0 };
+    /// @brief 区域起始时间，单位秒。
+    double timeBegin{ 0.0 };
+    /// @brief 区域结束时间，单位秒。
+    double timeEnd{ 0.0 };
+    /// @brief 区域内互不同属的物件数量，至少为 2。
+    std::int32_t objectCount{ 2 };
+    /// @brief 代表物件在 OverlapReport::regionItems 中的起始偏移。
+    std::uint32_t itemBegin{ 0 };
+    /// @brief 代表物件数量；每个顶层物件最多一个。
+    std::uint32_t itemCount{ 0 };
+};
+
+/// @brief 重叠检测窗口中的一行：同一轨道相近时间的区域合并结果。
+struct OverlapFinding {
+    /// @brief 最早的重叠时间，单位秒。
+    double time{ 0.0 };
+    /// @brief 重叠轨道。
+    std::int32_t track{ 0 };
+    /// @brief 合并后涉及的判定物件数量。
+    std::uint32_t objectCount{ 0 };
+    /// @brief 合并的区域数量；只有一个两物件区域时可逐个描述物件。
+    std::uint32_t regionCount{ 0 };
+    /// @brief 第一个代表物件在 OverlapReport::items 中的下标。
+    std::uint32_t firstItem{ 0 };
+    /// @brief 第二个代表物件在 OverlapReport::items 中的下标。
+    std::uint32_t secondItem{ 0 };
+};
+
+/// @brief 一次完整重叠检测的结果，供重叠检测窗口与重叠遮罩共同使用。
+struct OverlapReport {
+    /// @brief 参与检测的判定物件；后台检测服务的结果按 sortOverlapItems
+    /// 的顺序排列。
+    std::vector<OverlapItem> items;
+    /// @brief 全部重叠区域，按起始时间升序。
+    std::vector<OverlapRegion> regions;
+    /// @brief 各区域代表物件下标的连续存储。
+    std::vector<std::uint32_t> regionItems;
+    /// @brief 按（轨道, 时间）排序的窗口行。
+    std::vector<OverlapFinding> findings;
+    /// @brief 区域最长时间跨度，用于按时间范围查询时回退起点。
+    double maxRegionSpan{ 0.0 };
+    /// @brief 检测使用的时间窗口，单位秒。
+    double windowSeconds{ 0.0 };
+    /// @brief 检测时的音符索引修订号。
+    std::uint64_t revision{ 0 };
+
+    /// @brief 访问与时间范围相交的区域。
+    /// @param timeBegin 查询起始时间，单位秒。
+    /// @param timeEnd 查询结束时间，单位秒。
+    /// @param visit 对每个相交区域调用一次。
+    /// @warning 快照热路径：二分定位后只访问起点不晚于 timeEnd 的区域。
+    template <typename Visitor>
+    void forEachRegionInRange(double timeBegin, double timeEnd,
+                              Visitor&& visit) const
+    {
+        auto it = regionLowerBound(timeBegin - maxRegionSpan);
+        for ( ; it != regions.end() && it->timeBegin <= timeEnd; ++it ) {
+            if ( it->timeEnd >= timeBegin ) visit(*it);
+        }
+    }
+
+private:
+    /// @brief 第一个起始时间不早于 time 的区域。
+    std::vector<OverlapRegion>::const_iterator regionLowerBound(
+        double time) const;
+};
+
+/// @brief 把一个顶层物件展开为判定物件追加到 out。
+/// @param note 物件组件；折线子物件实体（m_isSubNote）直接跳过。
+/// @param entity 物件实体。
+/// @param out 输出判定物件列表。
+void appendOverlapItems(const NoteComponent& note, entt::entity entity,
+                        std::vector<OverlapItem>& out);
+
+/// @brief 按（起始时间, 顶层物件, 子物件下标）排序，即增量合并要求的顺序。
+void sortOverlapItems(std::vector<OverlapItem>& items);
+
+/**
+ * @brief 按轨道扫描线检测物件重叠。
+ *
+ * 规则与原重叠遮罩一致：同轨判定点在时间窗口内相邻成簇；同轨长条身体
+ * 重叠；判定点落在其他长条身体内部；判定点落在相近时间的 Flick 横向身体
+ * 上；两个相近时间的 Flick 横向身体交叠；Flick 横穿长条身体。判定点簇与
+ * Flick 配对按时间排序后线性扫描，长条相关规则按轨道维护活动长条集合，
+ * 总耗时 O(n log n + k)。
+ * @param items 判定物件，结果中的物件下标指向该列表。
+ * @param windowSeconds 视为重叠的最大时间差，单位秒。
+ * @param revision 写入结果的修订号。
+ * @param stop 后台取消令牌；请求停止后尽快返回空结果。
+ * @return 检测结果；被取消时返回 std::nullopt。
+ * @warning 全谱调用只允许在后台线程执行；快照路径只对可见物件调用。
+ */
+std::optional<OverlapReport> detectOverlaps(std::vector<OverlapItem> items,
+                                            double        windowSeconds,
+                                            std::uint64_t revision,
+                                            std::stop_token stop = {});
+
+/**
+ * @brief 把一批编辑增量合并到上一次检测结果。
+ *
+ * 移除顶层起始时间落在 dirtyTimes 中或顶层物件出现在 added 中的旧判定物件，
+ * 并入 added。新旧物件的时间覆盖被长于时间窗口的空隙切分为互不影响的岛，
+ * 只对含有改动物件的岛重新检测；其余区域沿用旧结果并重映射物件下标，最后
+ * 按全部区域重建窗口行。
+ * 结果与对新物件集合排序后完整检测等价。
+ * @param previous 上一次结果；物件须按 sortOverlapItems 的顺序排列。
+ * @param dirtyTimes 自 previous 以来编辑前后的顶层物件起始时间。
+ * @param added 当前起始时间落在 dirtyTimes 中的全部顶层物件的判定物件。
+ * @param revision 写入结果的修订号。
+ * @param stop 后台取消令牌；请求停止后尽快返回空结果。
+ * @return 合并结果，时间窗口沿用 previous；被取消时返回 std::nullopt。
+ * @warning 只允许在后台线程执行；除线性归并外只扫描受影响的岛。
+ */
+std::optional<OverlapReport> mergeOverlaps(const OverlapReport&     previous,
+                                           std::vector<double>      dirtyTimes,
+                                           std::vector<OverlapItem> added,
+                                           std::uint64_t            revision,
+                                           std::stop_token          stop = {});
+
+}  // namespace MMM::Logic
@@ -0,0 +1,74 @@
+#pragma once
+
+#include "logic/session/NoteDirtyTimeLog.h"
+#include "logic/session/OverlapDetector.h"
+#include "logic/session/TimeIntervalIndex.h"
+#include <atomic>
+#include <cstdint>
+#include <entt/entt.hpp>
+#include <memory>
+#include <mutex>
+#include <stop_token>
+
+namespace MMM::Logic
+{
+
+/**
+ * @brief 会话级后台重叠检测。
+ *
+ * 逻辑线程在音符索引修订号或时间窗口变化时提交到共享线程池；新的提交会
+ * 取消仍在运行的旧任务。完成的结果以不可变快照发布，重叠检测窗口与重叠
+ * 遮罩读取同一份结果。脏时间记录能覆盖最近发布的快照时，只查询脏时间上
+ * 的当前物件，连同该快照交给后台增量合并；首次提交、时间窗口变化或记录
+ * 不完整时才收集全部判定物件完整检测。
+ */
+class OverlapScanService
+{
+public:
+    OverlapScanService() = default;
+    ~OverlapScanService();
+
+    OverlapScanService(const OverlapScanService&)            = delete;
+    OverlapScanService& operator=(const OverlapScanService&) = delete;
+
+    /// @brief 在物件或时间窗口变化时提交新的后台检测。
+    /// @param noteRegistry 当前会话的音符注册表。
+    /// @param noteIndex 与当前修订号一致的音符可见性索引。
+    /// @param dirtyTimes 音符增量编辑的脏时间记录。
+    /// @param revision 当前音符索引修订号。
+    /// @param windowSeconds 当前重叠时间窗口，单位秒。
+    /// @warning 逻辑热路径：每个活动 Session update 调用；未变化时只比较两个
+    /// 数值，增量编辑只按脏时间查询索引，完整检测时线性收集一次判定物件。
+    void update(const entt::registry&    noteRegistry,
+                const TimeIntervalIndex& noteIndex,
+                const NoteDirtyTimeLog& dirtyTimes, std::uint64_t revision,
+                double windowSeconds);
+
+    /// @brief 最近一次完成的检测结果，可能落后于当前修订号。
+    /// @warning 逻辑线程与 UI 线程均可调用；只在复制共享指针时短暂加锁。
+    [[nodiscard]] std::shared_ptr<const OverlapReport> report() const;
+
+    /// @brief 最近一次提交的检测是否尚未完成。
+    [[nodiscard]] bool isScanning() const;
+
+private:
+    /// @brief 后台任务与服务共享的发布状态，任务持有其所有权。
+    struct SharedState {
+        std::mutex                           mutex;
+        std::shared_ptr<const OverlapReport> report;
+        /// @brief 当前 report 来自的任务编号，受 mutex 保护。
+        std::uint64_t publishedJob{ 0 };
+        /// @brief 最近一次提交的任务编号。
+        std::atomic<std::uint64_t> submitted{ 0 };
+        /// @brief 最近一次完成或取消的任务编号。
+        std::atomic<std::uint64_t> finished{ 0 };
+    };
+
+    std::shared_ptr<SharedState> m_state{ std::make_shared<SharedState>() };
+    std::stop_source             m_stopSource;
+    bool                         m_hasSubmitted{ false };
+    std::uint64_t                m_submittedRevision{ 0 };
+    double                       m_submittedWindow{ 0.0 };
+};
+
+}  // namespace MMM::Logic
@@ -38,11 +38,30 @@ bool applyNoteCacheMutationsIncrementally(
 
 /// @brief 将一个新建的普通正式音符直接追加到当前领域谱面。
 /// @param ctx 当前会话上下文。
+/// @param entity 音符所在实体，用于登记增量回写映射。
 /// @param note 已写入 ECS 且具有稳定协作标识的音符组件。
 /// @return 普通 Note、Hold 或 Flick 成功增量写回时返回 true。
 /// @warning 逻辑编辑热路径：单次放置调用；只允许追加一个领域对象并在引用索引
 /// 中二分插入，禁止完整 ECS 遍历或整谱重建。
-bool syncCreatedNoteToBeatmap(SessionContext& ctx, const NoteComponent& note);
+bool syncCreatedNoteToBeatmap(SessionContext& ctx, entt::entity entity,
+                              const NoteComponent& note);
+
+/// @brief 记录一个正式玩家物件实体的新建、修改或删除，等待增量回写。
+/// @param ctx 当前会话上下文。
+/// @param entity 变更的实体。
+/// @param before 变更前的音符组件；创建时为空。
+/// @param after 变更后的音符组件；删除时为空。
+/// @note 折线及其子物件无法逐实体回写，会转为下一次整体重建。
+void markNoteWriteBackDirty(SessionContext& ctx, entt::entity entity,
+                            const NoteComponent* before,
+                            const NoteComponent* after);
+
+/// @brief 标记正式物件需要整体重建回写，用于无法逐实体描述的批量变更。
+void markNotesFullSync(SessionContext& ctx);
+
+/// @brief 物件容器在 syncBeatmap 之外被整体替换后，丢弃实体到领域对象的
+/// 映射与待回写实体；下一次回写改为整体重建。
+void resetNoteWriteBack(SessionContext& ctx);
 
 /// @brief 判断音符是否允许在当前折线编辑模式下响应编辑操作。
 /// @param note 待判断的音符组件。
@@ -135,6 +154,14 @@ void markHitEventsDirty(SessionContext& ctx);
 /// 或索引同步前重建，禁止每次编辑 action 无条件调用。
 void ensureHitEvents(SessionContext& ctx);
 
+/// @brief 按已写入 ECS 的变更实体增量刷新打击事件序列。
+/// @param ctx 会话上下文引用
+/// @param entities 新增、修改或已销毁的顶层音符实体
+/// @warning 逻辑编辑热路径：只处理给定实体的事件；序列已标记为脏时直接返回，
+/// 由下次 ensureHitEvents 全量重建。
+void refreshHitEvents(SessionContext&               ctx,
+                      std::span<const entt::entity> entities);
+
 /// @brief 全量重建谱面的打击事件序列
 /// @param ctx 会话上下文引用
 void rebuildHitEvents(SessionContext& ctx);
@@ -211,6 +238,8 @@ void updateBackgroundSize(SessionContext& ctx, const MMM::BaseMapMeta& metadata,
 void loadBeatmap(SessionContext& ctx, std::shared_ptr<MMM::BeatMap> beatmap);
 
 /// @brief 将上下文中的 ECS 实体数据序列化写回到谱面对象中
+/// @details 正式物件只有逐实体标记的变更时，按 noteWriteBack 的脏实体集合
+/// 原地修补对应领域对象；批量变更、折线变更或映射失效时整体重建物件容器。
 /// @param ctx 会话上下文引用
 void syncBeatmap(SessionContext& ctx);
 
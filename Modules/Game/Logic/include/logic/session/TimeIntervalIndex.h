@@ -0,0 +1,254 @@
+#pragma once
+
+#include "logic/ecs/components/NoteComponent.h"
+#include "logic/ecs/components/SampleComponent.h"
+#include <cstddef>
+#include <entt/entt.hpp>
+#include <iterator>
+#include <optional>
+#include <unordered_map>
+#include <vector>
+
+namespace MMM::Logic
+{
+
+/**
+ * @brief 按 (起始时间, 实体) 排序的时间区间索引，用于音符与自动采样的
+ * 可见性查询。
+ *
+ * 条目内联保存起始与结束时间，排序比较不访问 ECS。条目存放在若干有序
+ * 分块中，每块不超过 MAX_CHUNK_SIZE 个；插入、删除与移动只改动所在分块。
+ * 每个分块记录块内最大结束时间，分块之上维护一棵最大值线段树。
+ *
+ * queryVisible() 沿线段树只进入最大结束时间不早于查询起点、且起始时间
+ * 不晚于查询终点的分块，耗时为 O(log n + 命中分块数 × 分块大小)。与前缀
+ * 最大结束时间不同，谱面开头的一条长条只会让它所在的分块参与查询，
+ * 不会迫使之后所有音符都被回溯扫描。
+ */
+class TimeIntervalIndex
+{
+public:
+    /// @brief 单个实体的时间区间条目。
+    struct Entry {
+        /// @brief 被索引的实体。
+        entt::entity entity{ entt::null };
+        /// @brief 起始时间（秒），排序主键。
+        double startTime{ 0.0 };
+        /// @brief 区间结束时间（秒）；音符取其子段的最晚结束时间。
+        double endTime{ 0.0 };
+    };
+
+    /// @brief 分块的条目上限；插入使分块超出时对半拆分。
+    static constexpr std::size_t MAX_CHUNK_SIZE = 256;
+
+    /// @brief 批量构建时每个分块的目标条目数，为后续插入留出余量。
+    static constexpr std::size_t FILL_CHUNK_SIZE = MAX_CHUNK_SIZE * 3 / 4;
+
+    /// @brief 顺序只读迭代器，按 (分块, 块内下标) 遍历。
+    class const_iterator
+    {
+    public:
+        using iterator_category = std::forward_iterator_tag;
+        using value_type        = Entry;
+        using difference_type   = std::ptrdiff_t;
+        using reference         = const Entry&;
+        using pointer           = const Entry*;
+
+        const_iterator() = default;
+        const_iterator(const TimeIntervalIndex* owner, std::size_t chunk,
+                       std::size_t offset)
+            : m_owner(owner), m_chunk(chunk), m_offset(offset)
+        {
+        }
+
+        reference operator*() const
+        {
+            return m_owner->m_chunks[m_chunk].entries[m_offset];
+        }
+        pointer operator->() const { return &**this; }
+
+        const_iterator& operator++()
+        {
+            if ( ++m_offset == m_owner->m_chunks[m_chunk].entries.size() ) {
+                ++m_chunk;
+                m_offset = 0;
+            }
+            return *this;
+        }
+        const_iterator operator++(int)
+        {
+            auto previous = *this;
+            ++*this;
+            return previous;
+        }
+
+        friend bool operator==(const const_iterator& lhs,
+                               const const_iterator& rhs)
+        {
+            return lhs.m_chunk == rhs.m_chunk && lhs.m_offset == rhs.m_offset;
+        }
+
+    private:
+        const TimeIntervalIndex* m_owner{ nullptr };
+        std::size_t              m_chunk{ 0 };
+        std::size_t              m_offset{ 0 };
+    };
+
+    /// @brief 音符及其折线子段的最晚结束时间（秒）。
+    [[nodiscard]] static double noteEndTime(const NoteComponent& note);
+
+    /// @brief 由音符组件生成条目。
+    [[nodiscard]] static Entry makeEntry(entt::entity         entity,
+                                         const NoteComponent& note);
+
+    /// @brief 由自动采样组件生成条目，区间为时间戳与生效时间之间。
+    [[nodiscard]] static Entry makeEntry(entt::entity           entity,
+                                         const SampleComponent& sample);
+
+    /**
+     * @brief 以 entries 整体重建索引。
+     * @details 只按内联键排序一次；同一实体出现多次时保留最后一条。
+     */
+    void assign(std::vector<Entry> entries);
+
+    /**
+     * @brief 插入实体条目；实体已存在时移动到新位置并更新结束时间。
+     * @warning 逻辑编辑热路径：只改动一个分块并更新线段树的一条路径。
+     */
+    void insert(const Entry& entry);
+
+    /**
+     * @brief 删除实体条目。
+     * @return 实体在索引中时返回 true。
+     */
+    bool erase(entt::entity entity);
+
+    /**
+     * @brief 删除所有满足 predicate(entity) 的条目并重建分块。
+     * @return 删除的条目数。
+     */
+    template<typename Predicate> std::size_t eraseIf(Predicate&& predicate)
+    {
+        std::vector<Entry> kept;
+        kept.reserve(m_size);
+        for ( const auto& chunk : m_chunks ) {
+            for ( const auto& entry : chunk.entries ) {
+                if ( !predicate(entry.entity) ) kept.push_back(entry);
+            }
+        }
+        const std::size_t removed = m_size - kept.size();
+        if ( removed > 0 ) assign(std::move(kept));
+        return removed;
+    }
+
+    /// @brief 清空全部条目。
+    void clear();
+
+    /// @brief 实体是否在索引中。
+    [[nodiscard]] bool contains(entt::entity entity) const
+    {
+        return m_startOf.contains(entity);
+    }
+
+    /// @brief 实体在索引中的起始时间；不在索引中时返回空。
+    [[nodiscard]] std::optional<double> findStartTime(
+        entt::entity entity) const
+    {
+        const auto found = m_startOf.find(entity);
+        if ( found == m_startOf.end() ) return std::nullopt;
+        return found->second;
+    }
+
+    [[nodiscard]] std::size_t size() const { return m_size; }
+    [[nodiscard]] bool        empty() const { return m_size == 0; }
+
+    const_iterator begin() const { return { this, 0, 0 }; }
+    const_iterator end() const { return { this, m_chunks.size(), 0 }; }
+
+    /**
+     * @brief 按排序顺序第一个结束时间不早于 time 的条目。
+     * @details 与原先在前缀最大结束时间上 lower_bound 的结果相同：
+     * 之前的条目都在 time 之前结束，不可能可见。
+     */
+    [[nodiscard]] const_iterator firstEndingAtOrAfter(double time) const;
+
+    /// @brief 第一个起始时间晚于 time 的条目。
+    [[nodiscard]] const_iterator upperBoundStart(double time) const;
+
+    /**
+     * @brief 按排序顺序对所有与 [startTime, endTime] 相交的条目调用
+     * callback(const Entry&)。
+     * @warning 渲染与框选热路径：不分配内存，跳过整段已结束的分块。
+     */
+    template<typename Callback>
+    void queryVisible(double startTime, double endTime,
+                      Callback&& callback) const
+    {
+        if ( m_treeLeaves == 0 || !(startTime <= endTime) ) return;
+        // 线段树节点按 (节点, 覆盖的首个分块, 覆盖的分块数) 深度优先遍历。
+        struct Frame {
+            std::size_t node;
+            std::size_t firstChunk;
+            std::size_t width;
+        };
+        Frame       stack[64];
+        std::size_t depth = 0;
+        stack[depth++]    = { 1, 0, m_treeLeaves };
+        while ( depth > 0 ) {
+            const Frame frame = stack[--depth];
+            if ( frame.firstChunk >= m_chunks.size() ||
+                 !(m_maxEndTree[frame.node] >= startTime) ||
+                 m_chunks[frame.firstChunk].entries.front().startTime >
+                     endTime ) {
+                continue;
+            }
+            if ( frame.width > 1 ) {
+                const std::size_t half = frame.width / 2;
+                stack[depth++] = { frame.node * 2 + 1,
+                                   frame.firstChunk + half,
+                                   half };
+                stack[depth++] = { frame.node * 2, frame.firstChunk, half };
+                continue;
+            }
+            for ( const auto& entry : m_chunks[frame.firstChunk].entries ) {
+                if ( entry.startTime > endTime ) break;
+                if ( entry.endTime >= startTime ) callback(entry);
+            }
+        }
+    }
+
+    /// @brief 分块有序、分块与线段树的最大结束时间及实体表一致。
+    [[nodiscard]] bool isConsistent() const;
+
+private:
+    /// @brief 有序分块。
+    struct Chunk {
+        std::vector<Entry> entries;
+        double             maxEnd{ 0.0 };
+    };
+
+    /// @brief 按 (起始时间, 实体) 比较。
+    [[nodiscard]] static bool keyLess(double lhsStart, entt::entity lhsEntity,
+                                      double rhsStart, entt::entity rhsEntity);
+
+    /// @brief 第一个末尾键不小于给定键的分块；都小于时返回最后一个分块。
+    [[nodiscard]] std::size_t chunkFor(double startTime,
+                                       entt::entity entity) const;
+
+    /// @brief 重新计算分块的最大结束时间并更新线段树。
+    void refreshChunk(std::size_t chunk);
+
+    /// @brief 分块数量变化后重建线段树。
+    void rebuildTree();
+
+    /// @brief 把分块的最大结束时间写入线段树叶子并向上更新。
+    void updateTreeLeaf(std::size_t chunk);
+
+    std::vector<Chunk>                       m_chunks;
+    std::vector<double>                      m_maxEndTree;
+    std::size_t                              m_treeLeaves{ 0 };
+    std::unordered_map<entt::entity, double> m_startOf;
+    std::size_t                              m_size{ 0 };
+};
+
+}  // namespace MMM::Logic
@@ -39,7 +39,12 @@ public:
         return ::MMM::BeatmapMutationFlags::Timelines;
     }
 
+    /// @brief 估算变更前后两份时间线数据的占用。
+    [[nodiscard]] std::size_t memoryUsage() const override;
+
 private:
+    friend struct EditorActionCodecAccess;
+
     Type                             m_type;    ///< 操作类型
     entt::entity                     m_entity;  ///< 实体 ID
     std::optional<TimelineComponent> m_before;  ///< 变更前数据
@@ -81,7 +86,12 @@ public:
         return ::MMM::BeatmapMutationFlags::Timelines;
     }
 
+    /// @brief 估算全部条目的占用。
+    [[nodiscard]] std::size_t memoryUsage() const override;
+
 private:
+    friend struct EditorActionCodecAccess;
+
     /// @brief 批量操作条目。
     std::vector<Entry> m_entries;
 
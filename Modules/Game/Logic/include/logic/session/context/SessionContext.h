@@ -9,9 +9,14 @@
 #include "logic/ecs/components/SampleComponent.h"
 #include "logic/ecs/components/TimelineComponent.h"
 #include "logic/ecs/system/HitFXSystem.h"
+#include "logic/ecs/system/render/RetainedNoteGeometry.h"
 #include "logic/session/AnnotationRenderData.h"
 #include "logic/session/ClipboardTypes.h"
 #include "logic/session/EditorAction.h"
+#include "logic/session/HitEventTimeline.h"
+#include "logic/session/NoteDirtyTimeLog.h"
+#include "logic/session/OverlapScanService.h"
+#include "logic/session/TimeIntervalIndex.h"
 #include <cstdint>
 #include <entt/entt.hpp>
 #include <glm/glm.hpp>
@@ -25,6 +30,7 @@
 namespace MMM
 {
 class BeatMap;
+class Note;
 class Project;
 }  // namespace MMM
 
@@ -32,6 +38,8 @@ namespace MMM::Logic
 {
 
 class BeatmapSyncBuffer;
+struct RenderSnapshot;
+struct CameraSnapshotDispatch;
 
 /// @brief 相机/视口信息
 struct CameraInfo {
@@ -51,12 +59,33 @@ struct MarqueeBox {
     std::string cameraId;            ///< 所属视口 ID
 };
 
+/// @brief 单个视口在快照生成阶段的待执行任务。
+/// @note 串行准备阶段填写，并行生成阶段只读，发布阶段按收集顺序提交。
+struct CameraSnapshotJob {
+    const std::string* cameraId{ nullptr };    ///< 视口 ID
+    const CameraInfo*  camera{ nullptr };      ///< 视口尺寸信息
+    BeatmapSyncBuffer* syncBuffer{ nullptr };  ///< 视口同步缓冲区
+    RenderSnapshot*    snapshot{ nullptr };    ///< 本轮工作快照
+    float              judgmentLineY{ 0.0f };  ///< 判定线位置 (视口空间)
+    float              mainViewportHeight{ 0.0f };  ///< 主画布视口高度
+    /// @brief 视口专属的音符基础层保留几何缓存；Timeline 视口为空。
+    System::RetainedNoteGeometryCache* noteGeometryCache{ nullptr };
+    /// @brief 开启渲染性能日志时记录的生成耗时，单位为毫秒。
+    double elapsedMs{ 0.0 };
+};
+
 /// @brief 提供给渲染系统的拖动中实体列表视图。
 struct DragRenderPinnedEntities {
     /// @brief 当前拖动手势中需要绕过静态可见性索引补充渲染的实体列表。
     const std::vector<entt::entity>* entities{ nullptr };
 };
 
+/// @brief 提供给渲染系统的后台重叠检测结果视图。
+struct OverlapReportView {
+    /// @brief 最近一次完成的检测结果；尚无结果时为空。
+    const OverlapReport* report{ nullptr };
+};
+
 /// @brief 共享的上下文状态，记录了当前会话的所有运行时数据，供各个 Controller
 /// 和 Tool 访问。
 struct SessionContext {
@@ -127,6 +156,20 @@ struct SessionContext {
     /// 逻辑热路径状态：播放时用于给辅助画布快照生成施加背压；只在逻辑线程读写。
     std::unordered_map<std::string, double> lastCameraSnapshotTimes;
 
+    /// @brief 本轮 update 待生成快照的视口任务，跨帧复用容量。
+    /// @warning 逻辑热路径临时缓冲：只在 updateECSAndRender 内部使用。
+    std::vector<CameraSnapshotJob> cameraSnapshotJobs;
+
+    /// @brief 多视口并行生成快照的调度状态。
+    /// @warning 仅在没有滞留的线程池任务持有时复用，避免每帧分配。
+    std::shared_ptr<CameraSnapshotDispatch> cameraSnapshotDispatch;
+
+    /// @brief 各画布的音符基础层保留几何缓存，按视口 ID 隔离。
+    /// @warning
+    /// 逻辑热路径状态：串行阶段创建条目，并行生成快照时每个视口只写自己的缓存。
+    std::unordered_map<std::string, System::RetainedNoteGeometryCache>
+        noteGeometryCaches;
+
     // --- 音频与播放状态 ---
     /// @brief 当前谱面的低频构建复合音频时间线描述符。
     AudioTimelineDescriptor audioTimelineDescriptor;
@@ -146,8 +189,8 @@ struct SessionContext {
     /// @brief 时间线自然结束后，下一次播放是否需要从零秒重新开始。
     bool restartPlaybackAfterFinishPending{ false };
 
-    std::vector<System::HitFXSystem::HitEvent>
-           hitEvents;                 ///< 当前谱面所有的打击事件序列
+    /// @brief 当前谱面所有的打击事件序列，按音符变更增量维护。
+    HitEventTimeline hitEvents;
     size_t nextHitIndex{ 0 };         ///< 下一个待触发的视觉打击事件索引
     size_t nextPredictHitIndex{ 0 };  ///< 下一个待触发的预读打击事件(音频)索引
     size_t nextBoundSoundPrefetchIndex{
@@ -165,15 +208,17 @@ struct SessionContext {
     bool isNotePruneDirty{ false };  ///< 音符排序缓存是否只需剔除失效实体
     bool isNoteStatsDirty{ true };   ///< 状态栏物件统计是否需要重算
     bool isTransformDirty{ true };   ///< 坐标转换缓存脏标记
-    std::vector<entt::entity>
-        sortedNoteEntities;  ///< 缓存并按时间排序后的音符实体列表
-    std::vector<double>
-        sortedNoteMaxEndPrefix;  ///< 排序音符列表的前缀最大结束时间缓存
+    /// @brief 按起始时间排序的音符可见性索引，条目内联保存起止时间。
+    TimeIntervalIndex noteVisibilityIndex;
     std::uint64_t noteVisibilityIndexRevision{ 0 };  ///< 音符可见性索引版本号
-    /// @brief 按可见区间起点排序的自动采样实体缓存。
-    std::vector<entt::entity> sortedSampleEntities;
-    /// @brief 自动采样缓存的前缀最大区间终点。
-    std::vector<double> sortedSampleMaxEndPrefix;
+    /// @brief 各索引版本增量编辑触及的起始时间，供保留几何按分桶失效。
+    NoteDirtyTimeLog noteDirtyTimes;
+    /// @brief 按音符索引修订号提交的后台重叠检测。
+    OverlapScanService overlapScan;
+    /// @brief 本轮 update 持有的检测结果，保证渲染视图指针在快照期间有效。
+    std::shared_ptr<const OverlapReport> overlapReport;
+    /// @brief 按可见区间起点排序的自动采样索引，区间为时间戳到生效时间。
+    TimeIntervalIndex sampleVisibilityIndex;
     /// @brief 自动采样可见性索引版本号。
     std::uint64_t sampleVisibilityIndexRevision{ 0 };
     /// @brief 自动采样排序缓存是否需要完整重建。
@@ -293,6 +338,22 @@ struct SessionContext {
     bool m_needsSamplesSync{ false };  ///< 自动采样实体有变更，需同步到 BeatMap
     bool m_needsTimingsSync{ false };  ///< 时间线实体有变更，需同步到 BeatMap
 
+    /// @brief 正式物件到 BeatMap 的增量回写状态，由 SessionUtils::syncBeatmap
+    /// 消费。
+    struct NoteWriteBackState {
+        /// @brief 自上次回写以来新建、修改或删除的正式玩家物件实体。
+        std::unordered_set<entt::entity> dirtyEntities;
+        /// @brief 变更无法逐实体表达（折线、批量替换、资源重映射等），
+        /// 下次回写整体重建物件容器。
+        bool needsFullRebuild{ false };
+        /// @brief 顶层 Note/Hold/Flick 实体到当前 BeatMap 领域对象的映射。
+        std::unordered_map<entt::entity, ::MMM::Note*> recordOfEntity;
+        /// @brief recordOfEntity 的反向映射，删除时搬移容器末尾对象使用。
+        std::unordered_map<const ::MMM::Note*, entt::entity> entityOfRecord;
+        /// @brief 映射是否与 currentBeatmap 的物件容器一致。
+        bool recordsValid{ false };
+    } noteWriteBack;
+
     // --- 编辑操作栈 ---
     EditorActionStack          actionStack;  ///< 撤销/重做操作栈
     std::vector<ClipboardItem> clipboard;    ///< 编辑器本地音符剪贴板回退。
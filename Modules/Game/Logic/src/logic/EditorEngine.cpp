@@ -199,7 +199,7 @@ void updateFollowerHitEffects(SessionContext& ctx, double previousAnimateTime,
     if ( resetHitIndex ) {
         SessionUtils::syncHitIndex(ctx);
         ctx.hitFXSystem.restoreActiveHoldEffects(
-            ctx.animateTime, ctx.hitEvents, config);
+            ctx.animateTime, ctx.hitEvents.events(), config);
         return;
     }
 
@@ -3097,7 +3097,14 @@ void EditorEngine::loop()
             m_logicUps.store(
                 static_cast<float>(m_logicUpdateCount / upsElapsed.count()),
                 std::memory_order_relaxed);
-            m_logicUpdateCount = 0;
+            m_commandEnqueuedPeak.store(m_commandStatsWindowPeak.enqueued,
+                                        std::memory_order_relaxed);
+            m_commandCoalescedPeak.store(m_commandStatsWindowPeak.coalesced,
+                                         std::memory_order_relaxed);
+            m_commandAppliedPeak.store(m_commandStatsWindowPeak.applied,
+                                       std::memory_order_relaxed);
+            m_commandStatsWindowPeak = {};
+            m_logicUpdateCount       = 0;
             m_lastUpsTime      = currentTime;
         }
 
@@ -3214,6 +3221,15 @@ void EditorEngine::loop()
                             entry.session->getContext().currentTime;
                         entry.session->update(
                             sessionDt, editorConfigSnapshot, isActiveSession);
+                        const auto& commandStats =
+                            entry.session->getCommandTickStats();
+                        auto& peak = m_commandStatsWindowPeak;
+                        peak.enqueued =
+                            std::max(peak.enqueued, commandStats.enqueued);
+                        peak.coalesced =
+                            std::max(peak.coalesced, commandStats.coalesced);
+                        peak.applied =
+                            std::max(peak.applied, commandStats.applied);
                         if ( isActiveSession && hadPendingCommands &&
                              std::abs(entry.session->getContext().currentTime -
                                       previousCurrentTime) >
@@ -3614,7 +3630,7 @@ void EditorEngine::handleRenameAudioResource(const CmdRenameAudioResource& cmd)
         const auto ecsChanged =
             remapSessionEcsAudioResourceId(ctx, cmd.id, newResourceId);
         if ( ecsChanged.m_changedNoteBindingCount > 0U ) {
-            ctx.m_needsNotesSync = true;
+            SessionUtils::markNotesFullSync(ctx);
             SessionUtils::markHitEventsDirty(ctx);
         }
         if ( ecsChanged.m_changedAudioSampleCount > 0U ) {
@@ -4006,7 +4022,7 @@ std::size_t EditorEngine::remapAudioResourcePathsAfterMove(
         }
 
         if ( noteEcsChanged ) {
-            ctx.m_needsNotesSync = true;
+            SessionUtils::markNotesFullSync(ctx);
             SessionUtils::markHitEventsDirty(ctx);
         }
         if ( sampleEcsChanged ) {
@@ -0,0 +1,184 @@
+#include "logic/HitboxIndex.h"
+
+#include "logic/BeatmapSyncBuffer.h"
+#include <algorithm>
+#include <cmath>
+#include <functional>
+#include <limits>
+
+namespace MMM::Logic
+{
+
+namespace
+{
+
+/// @brief 包围盒四边是否都是有限值。
+bool isFiniteBounds(float minX, float minY, float maxX, float maxY)
+{
+    return std::isfinite(minX) && std::isfinite(minY) &&
+           std::isfinite(maxX) && std::isfinite(maxY);
+}
+
+/// @brief 按平均命中框尺寸计算单轴单元数。
+/// @param extent 网格在该轴上的跨度。
+/// @param averageSize 命中框在该轴上的平均尺寸。
+/// @param maxCells 单轴最大单元数。
+std::int32_t axisCellCount(float extent, double averageSize,
+                           std::int32_t maxCells)
+{
+    if ( !(extent > 0.0F) ) return 1;
+    const double cellSize =
+        std::max(averageSize, double(extent) / double(maxCells));
+    const double cells = std::ceil(double(extent) / cellSize);
+    return static_cast<std::int32_t>(
+        std::clamp(cells, 1.0, static_cast<double>(maxCells)));
+}
+
+}  // namespace
+
+void HitboxIndex::clear()
+{
+    m_bounds.clear();
+    m_cellStart.clear();
+    m_cellItems.clear();
+    m_unbounded.clear();
+    m_originX       = 0.0F;
+    m_originY       = 0.0F;
+    m_invCellWidth  = 0.0F;
+    m_invCellHeight = 0.0F;
+    m_columns       = 0;
+    m_rows          = 0;
+}
+
+std::int32_t HitboxIndex::columnOf(float x) const
+{
+    const float cell = (x - m_originX) * m_invCellWidth;
+    if ( !(cell > 0.0F) ) return 0;
+    if ( cell >= static_cast<float>(m_columns) ) return m_columns - 1;
+    return static_cast<std::int32_t>(cell);
+}
+
+std::int32_t HitboxIndex::rowOf(float y) const
+{
+    const float cell = (y - m_originY) * m_invCellHeight;
+    if ( !(cell > 0.0F) ) return 0;
+    if ( cell >= static_cast<float>(m_rows) ) return m_rows - 1;
+    return static_cast<std::int32_t>(cell);
+}
+
+void HitboxIndex::build(const std::vector<Hitbox>& hitboxes, float scaleX,
+                        float scaleY)
+{
+    clear();
+    if ( hitboxes.empty() ) return;
+    m_bounds.resize(hitboxes.size());
+
+    // 1. 计算交互包围盒与网格范围；倒置或含 NaN 的包围盒永远不会命中。
+    constexpr float infinity = std::numeric_limits<float>::infinity();
+    float           minX = infinity, minY = infinity;
+    float           maxX = -infinity, maxY = -infinity;
+    double          sumWidth = 0.0, sumHeight = 0.0;
+    std::size_t     gridCount = 0;
+    for ( std::size_t index = 0; index < hitboxes.size(); ++index ) {
+        const auto box =
+            scaleInteractionHitbox(hitboxes[index], scaleX, scaleY);
+        auto& bounds = m_bounds[index];
+        bounds       = { box.x, box.y, box.x + box.w, box.y + box.h };
+        if ( !(bounds.minX <= bounds.maxX && bounds.minY <= bounds.maxY) ) {
+            continue;
+        }
+        if ( !isFiniteBounds(
+                 bounds.minX, bounds.minY, bounds.maxX, bounds.maxY) ) {
+            m_unbounded.push_back(static_cast<std::uint32_t>(index));
+            continue;
+        }
+        minX = std::min(minX, bounds.minX);
+        minY = std::min(minY, bounds.minY);
+        maxX = std::max(maxX, bounds.maxX);
+        maxY = std::max(maxY, bounds.maxY);
+        sumWidth += bounds.maxX - bounds.minX;
+        sumHeight += bounds.maxY - bounds.minY;
+        ++gridCount;
+    }
+    if ( gridCount == 0 ) return;
+
+    const float extentX = maxX - minX;
+    const float extentY = maxY - minY;
+    m_originX           = minX;
+    m_originY           = minY;
+    m_columns           = axisCellCount(
+        extentX, sumWidth / double(gridCount), MAX_CELLS_PER_AXIS);
+    m_rows = axisCellCount(
+        extentY, sumHeight / double(gridCount), MAX_CELLS_PER_AXIS);
+    m_invCellWidth =
+        extentX > 0.0F ? static_cast<float>(m_columns) / extentX : 0.0F;
+    m_invCellHeight =
+        extentY > 0.0F ? static_cast<float>(m_rows) / extentY : 0.0F;
+
+    // 2. 统计每个单元的命中框数并转为起始偏移。
+    const auto cellCount = static_cast<std::size_t>(m_columns) * m_rows;
+    m_cellStart.assign(cellCount + 1, 0);
+    const auto forEachCell = [this](const Bounds& bounds, auto&& visit) {
+        const std::int32_t column0 = columnOf(bounds.minX);
+        const std::int32_t column1 = columnOf(bounds.maxX);
+        const std::int32_t row1    = rowOf(bounds.maxY);
+        for ( std::int32_t row = rowOf(bounds.minY); row <= row1; ++row ) {
+            const auto rowBase = static_cast<std::size_t>(row) * m_columns;
+            for ( std::int32_t column = column0; column <= column1; ++column ) {
+                visit(rowBase + static_cast<std::size_t>(column));
+            }
+        }
+    };
+    const auto isGridBox = [](const Bounds& bounds) {
+        return bounds.minX <= bounds.maxX && bounds.minY <= bounds.maxY &&
+               isFiniteBounds(
+                   bounds.minX, bounds.minY, bounds.maxX, bounds.maxY);
+    };
+    for ( const auto& bounds : m_bounds ) {
+        if ( !isGridBox(bounds) ) continue;
+        forEachCell(bounds,
+                    [this](std::size_t cell) { ++m_cellStart[cell + 1]; });
+    }
+    for ( std::size_t cell = 0; cell < cellCount; ++cell ) {
+        m_cellStart[cell + 1] += m_cellStart[cell];
+    }
+
+    // 3. 按下标顺序填充，单元内自然升序；填充时 m_cellStart[cell] 充当写
+    // 游标，结束后整体右移一格恢复为起始偏移。
+    m_cellItems.resize(m_cellStart[cellCount]);
+    for ( std::size_t index = 0; index < m_bounds.size(); ++index ) {
+        if ( !isGridBox(m_bounds[index]) ) continue;
+        forEachCell(m_bounds[index], [this, index](std::size_t cell) {
+            m_cellItems[m_cellStart[cell]++] =
+                static_cast<std::uint32_t>(index);
+        });
+    }
+    for ( std::size_t cell = cellCount; cell > 0; --cell ) {
+        m_cellStart[cell] = m_cellStart[cell - 1];
+    }
+    m_cellStart[0] = 0;
+}
+
+void HitboxIndex::queryPoint(float x, float y,
+                             std::vector<std::uint32_t>& out) const
+{
+    out.clear();
+    if ( !m_cellStart.empty() ) {
+        const auto cell = static_cast<std::size_t>(rowOf(y)) * m_columns +
+                          static_cast<std::size_t>(columnOf(x));
+        for ( auto item = m_cellStart[cell + 1]; item > m_cellStart[cell]; ) {
+            const std::uint32_t index = m_cellItems[--item];
+            if ( contains(m_bounds[index], x, y) ) out.push_back(index);
+        }
+    }
+
+    const std::size_t gridHits = out.size();
+    for ( const std::uint32_t index : m_unbounded ) {
+        if ( contains(m_bounds[index], x, y) ) out.push_back(index);
+    }
+    if ( out.size() != gridHits ) {
+        std::sort(out.begin(), out.end(), std::greater<>());
+    }
+}
+
+}  // namespace MMM::Logic
@@ -5,6 +5,8 @@
 #include "event/project/ProjectEvents.h"
 #include "event/ui/menu/OpenProjectEvent.h"
 #include "log/colorful-log.h"
+#include "mmm/beatmap/BeatmapCache.h"
+#include "mmm/beatmap/BeatmapIndex.h"
 
 #include <fmt/format.h>
 #include <miniz.h>
@@ -14,6 +16,7 @@
 #include <chrono>
 #include <cstdint>
 #include <fstream>
+#include <functional>
 #include <optional>
 #include <string_view>
 #include <system_error>
@@ -693,6 +696,8 @@ bool copyDirectoryContents(const std::filesystem::path& sourceRoot,
         return false;
     }
 
+    const auto beatmapCacheDirectory =
+        ProjectStorage::beatmapCacheDirectory(sourceRoot);
     while ( iterator != endIterator ) {
         const auto entryPath = iterator->path();
         auto       relativePath =
@@ -705,7 +710,11 @@ bool copyDirectoryContents(const std::filesystem::path& sourceRoot,
         const auto destinationPath =
             (destinationRoot / relativePath).lexically_normal();
         filesystemError.clear();
-        if ( iterator->is_directory(filesystemError) && !filesystemError ) {
+        if ( entryPath.lexically_normal() == beatmapCacheDirectory ) {
+            // 缓存条目以源谱面绝对路径为键，复制到新目录后无法命中。
+            iterator.disable_recursion_pending();
+        } else if ( iterator->is_directory(filesystemError) &&
+                    !filesystemError ) {
             std::filesystem::create_directories(destinationPath,
                                                 filesystemError);
         } else if ( iterator->is_regular_file(filesystemError) &&
@@ -734,6 +743,51 @@ bool copyDirectoryContents(const std::filesystem::path& sourceRoot,
     return true;
 }
 
+/// @brief 读取项目谱面摘要索引；条目在使用时按源文件状态校验。
+/// @param projectRoot 项目根目录。
+/// @return 尚未刷新的索引，由 refreshBeatmapIndexInBackground 补齐。
+std::shared_ptr<BeatmapIndex> openBeatmapIndex(
+    const std::filesystem::path& projectRoot)
+{
+    auto beatmapIndex = std::make_shared<BeatmapIndex>(
+        projectRoot, ProjectStorage::beatmapIndexPath(projectRoot));
+    beatmapIndex->load();
+    return beatmapIndex;
+}
+
+/// @brief 在共享线程池中按当前谱面列表刷新索引并写回索引文件。
+/// @param beatmapIndex 已激活的索引。
+/// @param beatmapPaths 项目内全部谱面文件。
+/// @param onRefreshed 刷新完成后在工作线程上调用。
+void refreshBeatmapIndexInBackground(
+    std::shared_ptr<BeatmapIndex>      beatmapIndex,
+    std::vector<std::filesystem::path> beatmapPaths,
+    std::function<void()>              onRefreshed)
+{
+    auto task = [beatmapIndex = std::move(beatmapIndex),
+                 beatmapPaths = std::move(beatmapPaths),
+                 onRefreshed  = std::move(onRefreshed)]() {
+        const auto statistics = beatmapIndex->refresh(beatmapPaths);
+        XINFO("Beatmap index refreshed: {} reused, {} rebuilt, {} failed, {} "
+              "removed.",
+              statistics.reused,
+              statistics.rebuilt,
+              statistics.failed,
+              statistics.removed);
+        if ( !beatmapIndex->save() ) {
+            XWARN("Failed to save beatmap index after refresh.");
+        }
+        onRefreshed();
+    };
+
+    auto* appThreadPool = Runtime::AppThreadPool::instance().get();
+    if ( appThreadPool ) {
+        appThreadPool->enqueue_void(std::move(task));
+    } else {
+        task();
+    }
+}
+
 }  // namespace
 
 /// @brief 获取项目控制器全局实例。
@@ -1283,6 +1337,19 @@ ProjectController::OpenProjectResult ProjectController::openProject(
         Event::ProjectOpenProgressStage::BuildingResources,
         0.34F,
         projectOpenProgressPathDetail(actualProjectPath));
+    /// @brief 打开前的谱面缓存与摘要索引，打开失败时恢复。
+    const auto previousBeatmapCache = BeatmapCache::active();
+    const auto previousBeatmapIndex = BeatmapIndex::active();
+    BeatmapCache::setActive(std::make_shared<BeatmapCache>(
+        ProjectStorage::beatmapCacheDirectory(actualProjectPath)));
+    // 索引在后台刷新；刷新完成前资源扫描只使用有效条目与谱面头部，
+    // 完成后再触发一次目录同步补齐物件采样引用。
+    const auto beatmapIndex = openBeatmapIndex(actualProjectPath);
+    BeatmapIndex::setActive(beatmapIndex);
+    refreshBeatmapIndexInBackground(
+        beatmapIndex,
+        directoryScan.m_beatmapFiles,
+        beatmapIndexRefreshedCallback(beatmapIndex.get()));
     m_projectResourceService.buildInitialResources(*newProject, directoryScan);
 
     publishProjectOpenProgress(
@@ -1362,6 +1429,8 @@ ProjectController::OpenProjectResult ProjectController::openProject(
                Config::pathToUtf8(temporaryInfo->m_sourcePackagePath));
         publishProjectOpenFailed(
             temporaryInfo->m_sourcePackagePath, message, true);
+        BeatmapCache::setActive(previousBeatmapCache);
+        BeatmapIndex::setActive(previousBeatmapIndex);
         return result;
     }
 
@@ -1574,6 +1643,22 @@ ProjectController::saveTemporaryProjectTo(
     }
 
     *m_currentProject = savedProject;
+    BeatmapCache::setActive(std::make_shared<BeatmapCache>(
+        ProjectStorage::beatmapCacheDirectory(saveRoot)));
+    {
+        std::vector<std::filesystem::path> beatmapPaths;
+        beatmapPaths.reserve(savedProject.m_beatmaps.size());
+        for ( const auto& beatmap : savedProject.m_beatmaps ) {
+            beatmapPaths.push_back(saveRoot /
+                                   Config::utf8ToPath(beatmap.m_filePath));
+        }
+        const auto beatmapIndex = openBeatmapIndex(saveRoot);
+        BeatmapIndex::setActive(beatmapIndex);
+        refreshBeatmapIndexInBackground(
+            beatmapIndex,
+            std::move(beatmapPaths),
+            beatmapIndexRefreshedCallback(beatmapIndex.get()));
+    }
     m_projectDirectoryWatcher.start(saveRoot);
     Config::AppConfig::instance().addRecentProject(
         Config::pathToUtf8(saveRoot));
@@ -1599,6 +1684,12 @@ ProjectController::CloseProjectResult ProjectController::closeProject()
     result.m_project                  = std::move(m_currentProject);
     result.m_closed                   = true;
     m_projectDirectoryWatcher.stop();
+    BeatmapCache::setActive(nullptr);
+    if ( const auto beatmapIndex = BeatmapIndex::active();
+         beatmapIndex && !beatmapIndex->save() ) {
+        XWARN("Failed to save beatmap index while closing project.");
+    }
+    BeatmapIndex::setActive(nullptr);
 
     /// @brief 项目关闭完成后向 UI 和其它监听者发布的生命周期事件。
     Event::ProjectClosedEvent closedEvent;
@@ -1619,7 +1710,22 @@ void ProjectController::stopDirectoryWatcher()
 /// @return 有待处理目录变更时返回 true。
 bool ProjectController::consumeDirectoryChangePending()
 {
-    return m_projectDirectoryWatcher.consumeChangePending();
+    const bool indexRefreshed =
+        m_beatmapIndexRefreshed.exchange(false, std::memory_order_acq_rel);
+    return m_projectDirectoryWatcher.consumeChangePending() || indexRefreshed;
+}
+
+/// @brief 生成后台索引刷新完成时的回调。
+/// @param beatmapIndex 被刷新的索引；完成时已不再激活则不触发同步。
+/// @return 在工作线程上调用的回调。
+std::function<void()> ProjectController::beatmapIndexRefreshedCallback(
+    const BeatmapIndex* beatmapIndex)
+{
+    return [this, beatmapIndex]() {
+        if ( BeatmapIndex::active().get() == beatmapIndex ) {
+            m_beatmapIndexRefreshed.store(true, std::memory_order_release);
+        }
+    };
 }
 
 /// @brief 扫描当前项目目录并同步项目资源列表。
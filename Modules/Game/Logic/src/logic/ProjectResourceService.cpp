@@ -2,6 +2,7 @@
 #include "config/Utf8Path.h"
 #include "log/colorful-log.h"
 #include "mmm/beatmap/BeatMap.h"
+#include "mmm/beatmap/BeatmapIndex.h"
 
 #include <algorithm>
 #include <array>
@@ -1224,6 +1225,24 @@ bool rollbackFilesystemMove(const std::filesystem::path& newPath,
     }
     return !filesystemError;
 }
+
+/// @brief 谱面没有可匹配的音频引用时使用的项目默认音频资源。
+/// @param project 谱面所属项目。
+/// @return 首个 Main 资源；没有时返回首个资源。
+const AudioResource* findProjectFallbackAudioResource(const Project& project)
+{
+    const auto mainIterator =
+        std::find_if(project.m_audioResources.begin(),
+                     project.m_audioResources.end(),
+                     [](const AudioResource& resource) {
+                         return resource.m_type == AudioTrackType::Main;
+                     });
+    if ( mainIterator != project.m_audioResources.end() ) {
+        return &*mainIterator;
+    }
+    return project.m_audioResources.empty() ? nullptr
+                                            : &project.m_audioResources.front();
+}
 }  // namespace
 
 /// @brief 根据初次目录扫描结果填充项目的谱面和音频资源列表。
@@ -1825,6 +1844,35 @@ ProjectResourceService::probeBeatmapAudioReferences(
     const Project& project, const std::filesystem::path& mapPath,
     const std::string& beatmapPath, bool warnOnFailure)
 {
+    /// @brief 当前项目的谱面摘要索引；命中时无需加载整张谱面。
+    const auto beatmapIndex = BeatmapIndex::active();
+    if ( beatmapIndex && beatmapIndex->projectRoot() ==
+                             project.m_projectRoot.lexically_normal() ) {
+        std::optional<BeatmapSummary> summary;
+        if ( beatmapIndex->isReady() ) {
+            summary = beatmapIndex->summary(mapPath);
+        } else {
+            // 索引仍在后台刷新：未命中时只探测谱面头部，物件采样引用由
+            // 刷新完成后的目录同步补齐，避免与刷新任务重复加载整张谱面。
+            summary = beatmapIndex->find(mapPath);
+            if ( !summary ) {
+                const auto header = BeatMap::probeHeader(mapPath);
+                if ( !header.m_baseMapMetadata.map_path.empty() ) {
+                    summary = BeatmapSummary::fromBeatMap(header);
+                }
+            }
+        }
+        if ( !summary ) {
+            if ( warnOnFailure ) {
+                XWARN("Failed to probe audio references for beatmap: {}",
+                      beatmapPath);
+            }
+            return {};
+        }
+        return collectBeatmapAudioReferences(
+            project, mapPath, *summary, beatmapPath);
+    }
+
     /// @brief 临时加载的谱面，用于读取完整音频引用。
     auto beatMap = BeatMap::loadFromFile(mapPath);
     if ( beatMap.m_baseMapMetadata.map_path.empty() ) {
@@ -1839,6 +1887,48 @@ ProjectResourceService::probeBeatmapAudioReferences(
     return collectBeatmapAudioReferences(beatMap, beatmapPath);
 }
 
+/// @brief 从谱面摘要展开音频引用，结果与加载谱面后收集的引用一致。
+/// @param project 谱面所属项目。
+/// @param mapPath 摘要对应的谱面文件路径。
+/// @param summary 谱面摘要。
+/// @param beatmapPath 用于诊断和相对路径解析的具体谱面路径。
+/// @return 歌曲提示、玩家物件绑定和自动采样引用列表。
+std::vector<BeatmapAudioReference>
+ProjectResourceService::collectBeatmapAudioReferences(
+    const Project& project, const std::filesystem::path& mapPath,
+    const BeatmapSummary& summary, const std::string& beatmapPath)
+{
+    /// @brief 只携带元数据路径的谱面，复用谱面路径规范化规则。
+    BeatMap metadataOnly;
+    auto&   meta         = metadataOnly.m_baseMapMetadata;
+    meta.map_path        = mapPath;
+    meta.song_file_hint  = summary.songFileHint;
+    meta.main_audio_path = summary.mainAudioPath;
+    normalizeBeatmapMetadataPathsForProject(metadataOnly, project);
+    auto result = collectBeatmapAudioReferences(metadataOnly, beatmapPath);
+
+    /// @brief 按出现次数展开一类计数引用。
+    auto appendCounted =
+        [&](const std::vector<BeatmapAudioReferenceCount>& references,
+            BeatmapAudioReferenceKind                      kind) {
+            for ( const auto& reference : references ) {
+                if ( reference.reference.empty() ) continue;
+                result.insert(result.end(),
+                              reference.count,
+                              BeatmapAudioReference{
+                                  beatmapPath,
+                                  reference.reference,
+                                  kind,
+                              });
+            }
+        };
+    appendCounted(summary.noteSampleReferences,
+                  BeatmapAudioReferenceKind::NoteSampleBinding);
+    appendCounted(summary.audioSampleReferences,
+                  BeatmapAudioReferenceKind::AudioSampleEvent);
+    return result;
+}
+
 /// @brief 判断谱面音频引用是否指向指定项目资源。
 /// @param project 资源所属项目。
 /// @param reference 待匹配的谱面引用。
@@ -2280,18 +2370,48 @@ const AudioResource* ProjectResourceService::findDefaultBeatmapAudioResource(
     }
     if ( firstMainSampleResource ) return firstMainSampleResource;
     if ( firstSampleResource ) return firstSampleResource;
+    return findProjectFallbackAudioResource(project);
+}
 
-    const auto mainIterator =
-        std::find_if(project.m_audioResources.begin(),
-                     project.m_audioResources.end(),
-                     [](const AudioResource& resource) {
-                         return resource.m_type == AudioTrackType::Main;
-                     });
-    if ( mainIterator != project.m_audioResources.end() ) {
-        return &*mainIterator;
+/// @brief 按谱面摘要选择默认音频资源，规则与完整谱面版本一致。
+/// @param project 谱面所属项目。
+/// @param summary 谱面摘要。
+/// @param beatmapPath 谱面的项目相对或绝对路径。
+/// @return 优先匹配歌曲提示和 Main 自动采样的项目资源。
+const AudioResource* ProjectResourceService::findDefaultBeatmapAudioResource(
+    const Project& project, const BeatmapSummary& summary,
+    const std::filesystem::path& beatmapPath)
+{
+    const auto& songFileHint = summary.songFileHint.empty()
+                                   ? summary.mainAudioPath
+                                   : summary.songFileHint;
+    if ( const auto* hintedResource = findAudioResourceForReference(
+             project, beatmapPath, Config::pathToUtf8(songFileHint)) ) {
+        return hintedResource;
     }
-    return project.m_audioResources.empty() ? nullptr
-                                            : &project.m_audioResources.front();
+
+    const AudioResource* firstMainSampleResource = nullptr;
+    const AudioResource* firstSampleResource     = nullptr;
+    double firstMainTimestamp = std::numeric_limits<double>::infinity();
+    double firstTimestamp     = std::numeric_limits<double>::infinity();
+    for ( const auto& reference : summary.audioSampleReferences ) {
+        const auto* resource = findAudioResourceForReference(
+            project, beatmapPath, reference.reference);
+        if ( !resource ) continue;
+
+        if ( reference.firstTimestamp < firstTimestamp ) {
+            firstTimestamp      = reference.firstTimestamp;
+            firstSampleResource = resource;
+        }
+        if ( resource->m_type == AudioTrackType::Main &&
+             reference.firstTimestamp < firstMainTimestamp ) {
+            firstMainTimestamp      = reference.firstTimestamp;
+            firstMainSampleResource = resource;
+        }
+    }
+    if ( firstMainSampleResource ) return firstMainSampleResource;
+    if ( firstSampleResource ) return firstSampleResource;
+    return findProjectFallbackAudioResource(project);
 }
 
 /// @brief 将旧项目条目的单主音轨迁移为 MMM v2 自动采样。
@@ -21,6 +21,12 @@ constexpr int SPLIT_STORAGE_FORMAT_VERSION = 1;
 /// @brief 隐藏项目配置目录名。
 constexpr std::string_view STORAGE_DIRECTORY_NAME = ".mmm";
 
+/// @brief 隐藏目录下的谱面二进制缓存子目录。
+constexpr std::string_view BEATMAP_CACHE_DIRECTORY_NAME = "cache/beatmaps";
+
+/// @brief 隐藏目录下的项目谱面摘要索引文件名。
+constexpr std::string_view BEATMAP_INDEX_FILE_NAME = "beatmap_index.json";
+
 /// @brief 分片格式入口文件名。
 constexpr std::string_view MANIFEST_FILE_NAME = "manifest.json";
 
@@ -152,6 +158,19 @@ std::filesystem::path ProjectStorage::storageDirectory(
     return projectRoot / STORAGE_DIRECTORY_NAME;
 }
 
+std::filesystem::path ProjectStorage::beatmapCacheDirectory(
+    const std::filesystem::path& projectRoot)
+{
+    return (storageDirectory(projectRoot) / BEATMAP_CACHE_DIRECTORY_NAME)
+        .lexically_normal();
+}
+
+std::filesystem::path ProjectStorage::beatmapIndexPath(
+    const std::filesystem::path& projectRoot)
+{
+    return storageDirectory(projectRoot) / BEATMAP_INDEX_FILE_NAME;
+}
+
 std::filesystem::path ProjectStorage::manifestPath(
     const std::filesystem::path& projectRoot)
 {
@@ -88,7 +88,7 @@ const std::string& HitFXSystem::soundEffectKeyForEvent(
     const HitEvent& ev, ::MMM::NoteType effectiveType)
 {
     if ( hasBoundSoundEffect(ev) ) {
-        return ev.sampleBinding->m_audioResourceId;
+        return *ev.sampleResource;
     }
 
     static const std::string NOTE_SOUND_EFFECT_KEY  = "hiteffect.note";
@@ -99,12 +99,12 @@ const std::string& HitFXSystem::soundEffectKeyForEvent(
 
 bool HitFXSystem::hasBoundSoundEffect(const HitEvent& ev) noexcept
 {
-    return ev.sampleBinding && !ev.sampleBinding->m_audioResourceId.empty();
+    return ev.sampleResource != nullptr;
 }
 
 float HitFXSystem::sampleVolumeForEvent(const HitEvent& ev)
 {
-    return hasBoundSoundEffect(ev) ? ev.sampleBinding->m_volume : 1.0F;
+    return hasBoundSoundEffect(ev) ? ev.sampleVolume : 1.0F;
 }
 
 HitEffectRenderBounds HitFXSystem::calculateRenderBounds(
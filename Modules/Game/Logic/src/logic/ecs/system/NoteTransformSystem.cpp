@@ -2,38 +2,138 @@
 #include "logic/ecs/components/NoteComponent.h"
 #include "logic/ecs/components/TransformComponent.h"
 #include "logic/ecs/system/ScrollCache.h"
+#include "logic/session/TimeIntervalIndex.h"
+#include <cmath>
+#include <cstdint>
+#include <limits>
+#include <vector>
 
 namespace MMM::Logic::System
 {
 
+/// @brief 坐标映射的复用缓冲与上次映射状态，存放在音符注册表上下文中。
+struct NoteTransformScratch {
+    /// @brief 本次需要映射的音符。
+    std::vector<entt::entity> entities;
+    /// @brief 与 entities 对应的起始时间、AbsY 与 HS 倍率。
+    std::vector<double> startTimes;
+    std::vector<double> startAbsYs;
+    std::vector<double> startHs;
+    /// @brief 是否已完成过一次完整映射。
+    bool mapped{ false };
+    /// @brief 上次映射时的 ScrollCache 版本、音符索引版本与动画缩放。
+    std::uint64_t scrollRevision{ 0 };
+    std::uint64_t noteRevision{ 0 };
+    double        animatedZoomScale{ 1.0 };
+    /// @brief 上次完整映射时判定线的 AbsY，增量映射沿用以保持同一原点。
+    double originAbsY{ 0.0 };
+};
+
 /// @brief 更新音符逻辑坐标缓存。
 /// @warning 逻辑热路径：每个 Session update 调用；完整 registry view
 /// 遍历只允许在 cacheDirty 或 forceRebuild 时执行，禁止在此处排序。
+/// 时间线增量重建时只重新映射结束时间不早于重建起点的音符。
 void NoteTransformSystem::update(entt::registry&             registry,
                                  entt::registry&             timelineRegistry,
                                  double                      currentTime,
                                  const Config::EditorConfig& config,
                                  MMM::BeatMap* beatmap, bool forceRebuild)
 {
-    auto& cache      = timelineRegistry.ctx().get<ScrollCache>();
-    bool  cacheDirty = cache.isDirty;
-    if ( cache.isDirty ) {
-        cache.rebuild(timelineRegistry, config, beatmap);
-    }
+    auto&      cache      = timelineRegistry.ctx().get<ScrollCache>();
+    const bool cacheDirty = cache.refresh(timelineRegistry, config, beatmap);
 
     if ( !cacheDirty && !forceRebuild ) {
         return;
     }
 
-    double currentAbsY = cache.getAbsY(currentTime);
+    auto* scratch = registry.ctx().find<NoteTransformScratch>();
+    if ( !scratch ) {
+        scratch = &registry.ctx().emplace<NoteTransformScratch>();
+    }
 
     auto noteView = registry.view<TransformComponent, const NoteComponent>();
-    for ( auto entity : noteView ) {
+    const std::size_t noteCount = registry.storage<NoteComponent>().size();
+
+    const TimeIntervalIndex* sorted = nullptr;
+    if ( const auto** sortedPtr =
+             registry.ctx().find<const TimeIntervalIndex*>() ) {
+        sorted = *sortedPtr;
+    }
+    const std::uint64_t* noteRevision = nullptr;
+    if ( const auto** revisionPtr =
+             registry.ctx().find<const std::uint64_t*>() ) {
+        noteRevision = *revisionPtr;
+    }
+
+    // 只有时间线恰好增量重建一次、音符与动画缩放都未变化时，
+    // 在重建起点之前结束的音符坐标才保持不变。
+    const double fromTime    = cache.getLastRebuildFromTime();
+    const bool   remapSuffix =
+        !forceRebuild && scratch->mapped && std::isfinite(fromTime) &&
+        sorted && sorted->size() == noteCount && noteRevision &&
+        *noteRevision == scratch->noteRevision &&
+        cache.getRevision() == scratch->scrollRevision + 1 &&
+        cache.getAnimatedZoomScale() == scratch->animatedZoomScale;
+
+    auto& entities   = scratch->entities;
+    auto& startTimes = scratch->startTimes;
+    entities.clear();
+    startTimes.clear();
+    if ( remapSuffix ) {
+        sorted->queryVisible(
+            fromTime,
+            std::numeric_limits<double>::infinity(),
+            [&](const TimeIntervalIndex::Entry& entry) {
+                if ( !noteView.contains(entry.entity) ) return;
+                entities.push_back(entry.entity);
+                startTimes.push_back(
+                    noteView.get<const NoteComponent>(entry.entity)
+                        .m_timestamp);
+            });
+    } else {
+        // 可见性索引按起始时间排序，起点批量映射可以合并遍历滚动分段；
+        // 索引缺失或与注册表不一致时按存储顺序收集，批量查询逐个回退二分。
+        scratch->originAbsY = cache.getAbsY(currentTime);
+        entities.reserve(noteCount);
+        startTimes.reserve(noteCount);
+        if ( sorted ) {
+            for ( const auto& entry : *sorted ) {
+                if ( !noteView.contains(entry.entity) ) continue;
+                entities.push_back(entry.entity);
+                startTimes.push_back(
+                    noteView.get<const NoteComponent>(entry.entity)
+                        .m_timestamp);
+            }
+        }
+        if ( entities.size() != noteCount ) {
+            entities.clear();
+            startTimes.clear();
+            for ( auto entity : noteView ) {
+                entities.push_back(entity);
+                startTimes.push_back(
+                    noteView.get<const NoteComponent>(entity).m_timestamp);
+            }
+        }
+    }
+    scratch->mapped            = true;
+    scratch->scrollRevision    = cache.getRevision();
+    scratch->noteRevision      = noteRevision ? *noteRevision : 0;
+    scratch->animatedZoomScale = cache.getAnimatedZoomScale();
+
+    const double currentAbsY = scratch->originAbsY;
+    auto&        startAbsYs  = scratch->startAbsYs;
+    auto&        startHs     = scratch->startHs;
+    startAbsYs.resize(startTimes.size());
+    startHs.resize(startTimes.size());
+    cache.getAbsYBatch(startTimes, startAbsYs, startHs);
+
+    for ( std::size_t index = 0; index < entities.size(); ++index ) {
+        const auto  entity    = entities[index];
         auto&       transform = noteView.get<TransformComponent>(entity);
         const auto& note      = noteView.get<const NoteComponent>(entity);
 
-        double noteAbsY = cache.getAbsY(note.m_timestamp);
-        double noteHs   = cache.getHsAt(note.m_timestamp);
+        double noteAbsY = startAbsYs[index];
+        double noteHs   = startHs[index];
         float  relY     = static_cast<float>((noteAbsY - currentAbsY) * noteHs);
 
         float minY = relY;
@@ -4,6 +4,7 @@
 #include "mmm/beatmap/BeatMap.h"
 #include <algorithm>
 #include <cmath>
+#include <iterator>
 #include <limits>
 #include <map>
 #include <string>
@@ -30,6 +31,39 @@ static bool hasMalodyMetadata(const TimelineComponent& tl)
         ::MMM::TimingMetadataType::MALODY);
 }
 
+/// @brief 时间线条目积分顺序：时间戳升序；时间戳相同时 BPM 优先，
+/// 再按实体编号排序，使完整重建与增量归并得到相同的顺序。
+/// @note 时间戳按原值比较而不带容差，保证排序键是严格弱序。
+static bool timingKeyLess(double lhsTime, bool lhsBpm, entt::entity lhsEntity,
+                          double rhsTime, bool rhsBpm, entt::entity rhsEntity)
+{
+    if ( lhsTime != rhsTime ) {
+        return lhsTime < rhsTime;
+    }
+    if ( lhsBpm != rhsBpm ) {
+        return lhsBpm;
+    }
+    return entt::to_integral(lhsEntity) < entt::to_integral(rhsEntity);
+}
+
+/// @brief AbsY 区间索引顺序：下界、上界、分段下标依次升序，均按原值比较。
+constexpr auto absYRangeLess = [](const auto& a, const auto& b) {
+    if ( a.minAbsY != b.minAbsY ) return a.minAbsY < b.minAbsY;
+    if ( a.maxAbsY != b.maxAbsY ) return a.maxAbsY < b.maxAbsY;
+    return a.segmentIndex < b.segmentIndex;
+};
+
+/// @brief 读取谱面的 osu! SliderMultiplier。
+static double readSliderMultiplier(const MMM::BeatMap* beatmap)
+{
+    if ( !beatmap ) return 1.0;
+    return beatmap->m_metadata.get_value<double>(
+        MapMetadataType::OSU, "Difficulty::SliderMultiplier", 1.4);
+}
+
+/// @brief 增量切分时分段时间与变更时间的最小间隔。
+constexpr double SUFFIX_CUT_EPSILON = 1e-6;
+
 /// @brief 根据时间线注册表重建滚动缓存。
 /// @param timelineRegistry 时间线注册表。
 /// @param config 当前编辑器配置。
@@ -40,15 +74,18 @@ void ScrollCache::rebuild(const entt::registry&       timelineRegistry,
                           const Config::EditorConfig& config,
                           MMM::BeatMap*               beatmap)
 {
-    const double BASE_SPEED      = 500.0;
-    const auto&  visualConfig    = config.visual;
-    const bool   isLinearMapping = visualConfig.enableLinearScrollMapping;
-    const bool   enableEffects   = !isLinearMapping;
-    double       timelineZoom    = visualConfig.timelineZoom;
+    const auto& visualConfig = config.visual;
+    double      timelineZoom = visualConfig.timelineZoom;
     if ( !std::isfinite(timelineZoom) || timelineZoom <= 1e-9 ) {
         timelineZoom = 1.0;
     }
-    m_lastZoom = timelineZoom;
+    m_lastZoom          = timelineZoom;
+    m_lastLinearMapping = visualConfig.enableLinearScrollMapping;
+    m_lastBeatmap       = beatmap;
+    m_sliderMultiplier  = readSliderMultiplier(beatmap);
+    m_mapLength = beatmap ? beatmap->m_baseMapMetadata.map_length : 0.0;
+    m_lastRebuildFromTime = -std::numeric_limits<double>::infinity();
+    m_changedEntities.clear();
 
     m_rebuildScratch.clear();
     auto tlView = timelineRegistry.view<const TimelineComponent>();
@@ -63,38 +100,32 @@ void ScrollCache::rebuild(const entt::registry&       timelineRegistry,
         m_segments.clear();
         m_absYRangeIndex.clear();
         m_microImpulseWindows.clear();
+        m_timingOrder.clear();
+        m_timingKeyOf.clear();
         m_hasJumpEffects = false;
+        m_hasHsEffects   = false;
         isDirty          = false;
         ++m_revision;
         return;
     }
 
-    // 排序逻辑：时间戳升序；时间戳相同时，BPM 类型优先于 SCROLL 类型
-    std::stable_sort(
-        m_rebuildScratch.begin(),
-        m_rebuildScratch.end(),
-        [](const auto& a, const auto& b) {
-            if ( std::abs(a.component->m_timestamp - b.component->m_timestamp) >
-                 1e-9 ) {
-                return a.component->m_timestamp < b.component->m_timestamp;
-            }
-            if ( a.component->m_effect != b.component->m_effect ) {
-                return a.component->m_effect == ::MMM::TimingEffect::BPM;
-            }
-            return false;  // 保持原始顺序
-        });
-
-    std::vector<ScrollSegment> newSegments;
-    newSegments.reserve(m_rebuildScratch.size() + 1);
-
-    // 1. 完整版 osu! 逻辑：计算最常见 BPM 作为基准，并获取 SliderMultiplier。
-    double refBPM           = 120.0;
-    double sliderMultiplier = 1.0;
+    // 排序逻辑：时间戳升序；时间戳相同时，BPM 类型优先于 SCROLL 类型，
+    // 其余按实体编号，与 rebuildSuffix 的归并使用同一键。
+    std::sort(m_rebuildScratch.begin(),
+              m_rebuildScratch.end(),
+              [](const auto& a, const auto& b) {
+                  return timingKeyLess(
+                      a.component->m_timestamp,
+                      a.component->m_effect == ::MMM::TimingEffect::BPM,
+                      a.entity,
+                      b.component->m_timestamp,
+                      b.component->m_effect == ::MMM::TimingEffect::BPM,
+                      b.entity);
+              });
+
+    // 1. 完整版 osu! 逻辑：计算最常见 BPM 作为基准。
+    double refBPM = 120.0;
     if ( beatmap ) {
-        // 尝试获取 SliderMultiplier (默认为 1.4)
-        sliderMultiplier = beatmap->m_metadata.get_value<double>(
-            MapMetadataType::OSU, "Difficulty::SliderMultiplier", 1.4);
-
         // 自动计算最常见的 BPM (持续时间最长)
         std::map<double, double> bpmDurations;
         double                   lastBpmTime   = 0.0;
@@ -110,8 +141,7 @@ void ScrollCache::rebuild(const entt::registry&       timelineRegistry,
             }
         }
         // 加上最后一个段落到末尾的时间 (假设谱面时长)
-        bpmDurations[currentBpmVal] +=
-            (beatmap->m_baseMapMetadata.map_length - lastBpmTime);
+        bpmDurations[currentBpmVal] += (m_mapLength - lastBpmTime);
 
         double maxDuration = -1.0;
         for ( const auto& [bpm, dur] : bpmDurations ) {
@@ -122,110 +152,307 @@ void ScrollCache::rebuild(const entt::registry&       timelineRegistry,
         }
     }
     if ( refBPM < 1.0 ) refBPM = 120.0;
+    m_refBpm = refBPM;
 
-    double currentBPM = refBPM;
+    // osu! 关键：SV 跨 BPM 红线继承，不重置。仅绿线显式修改 ScrollSpeed。
+    IntegrationState state;
+    state.currentBpm = refBPM;
+    state.lastTime =
+        std::min(0.0, m_rebuildScratch[0].component->m_timestamp);
+    state.currentSpeed =
+        calcSpeed(state.currentBpm, state.currentScrollMult);
+    m_hasJumpEffects = false;
+    m_hasHsEffects   = false;
+
+    m_segments.clear();
+    m_segments.reserve(m_rebuildScratch.size() + 1);
+    m_segments.push_back({ state.lastTime, 0.0, state.currentSpeed, 0 });
+    m_segments.back().hs                = state.currentHs;
+    m_segments.back().hsValue           = state.currentHs;
+    m_segments.back().activeBpmValue    = state.currentBpm;
+    m_segments.back().activeScrollValue = state.activeScrollValue;
+
+    m_timingOrder.clear();
+    m_timingOrder.reserve(m_rebuildScratch.size());
+    m_timingKeyOf.clear();
+    m_timingKeyOf.reserve(m_rebuildScratch.size());
+    for ( const auto& entry : m_rebuildScratch ) {
+        const TimingKey key{ entry.component->m_timestamp,
+                             entry.component->m_effect ==
+                                 ::MMM::TimingEffect::BPM,
+                             entry.entity };
+        m_timingOrder.push_back(key);
+        m_timingKeyOf[entry.entity] = key;
+        integrateTimingEntry(state, entry.entity, *entry.component);
+    }
 
-    // 状态栏需要展示时间线语义上的当前 SV。该值独立于线性映射开关，
-    // 避免关闭滚动效果后丢失谱面实际段落信息。
-    double activeScrollValue = 1.0;
+    finishRebuild(0);
+    isDirty = false;
+}
 
+bool ScrollCache::refresh(const entt::registry&       timelineRegistry,
+                          const Config::EditorConfig& config,
+                          MMM::BeatMap*               beatmap)
+{
+    if ( !needsRebuild() ) return false;
+
+    double timelineZoom = config.visual.timelineZoom;
+    if ( !std::isfinite(timelineZoom) || timelineZoom <= 1e-9 ) {
+        timelineZoom = 1.0;
+    }
+    const bool sameGlobals =
+        timelineZoom == m_lastZoom &&
+        config.visual.enableLinearScrollMapping == m_lastLinearMapping &&
+        beatmap == m_lastBeatmap &&
+        readSliderMultiplier(beatmap) == m_sliderMultiplier &&
+        (beatmap ? beatmap->m_baseMapMetadata.map_length : 0.0) == m_mapLength;
+    if ( isDirty || !sameGlobals || !rebuildSuffix(timelineRegistry) ) {
+        rebuild(timelineRegistry, config, beatmap);
+    }
+    return true;
+}
+
+void ScrollCache::markTimelineChanged(entt::entity entity)
+{
+    m_changedEntities.push_back(entity);
+}
+
+double ScrollCache::calcSpeed(double bpm, double scrollMult) const
+{
+    constexpr double BASE_SPEED = 500.0;
     // osu! MultiplierControlPoint 换算：
     //   倍率 = Velocity × ScrollSpeed × BaseBeatLength / BeatLength。
     //   推导 = 1.0 × scrollMult × (60000 / refBPM) / (60000 / bpm)。
     //   推导 = scrollMult × bpm / refBPM。
     //   速度 = 倍率 × scrollLength / timeRange。
     //   推导 = scrollMult × bpm / refBPM × BASE_SPEED × timelineZoom。
-    auto calcSpeed = [&](double bpm, double sm) {
-        if ( isLinearMapping ) {
-            return BASE_SPEED * timelineZoom;
-        }
-        double ratio = bpm / refBPM;
-        if ( !std::isfinite(ratio) ) {
-            ratio = 0.0;
-        }
-        if ( ratio < 0.0 ) {
-            ratio = 0.0;
-        }
-        return ratio * sm * sliderMultiplier * BASE_SPEED * timelineZoom;
-    };
+    if ( m_lastLinearMapping ) {
+        return BASE_SPEED * m_lastZoom;
+    }
+    double ratio = bpm / m_refBpm;
+    if ( !std::isfinite(ratio) ) {
+        ratio = 0.0;
+    }
+    if ( ratio < 0.0 ) {
+        ratio = 0.0;
+    }
+    return ratio * scrollMult * m_sliderMultiplier * BASE_SPEED * m_lastZoom;
+}
 
-    // osu! 关键：SV 跨 BPM 红线继承，不重置。仅绿线显式修改 ScrollSpeed。
-    double currentScrollMult = 1.0;
-    double currentHs         = 1.0;
-    double lastTime = std::min(0.0, m_rebuildScratch[0].component->m_timestamp);
-    double currentAbsY = 0.0;
-    m_hasJumpEffects   = false;
-
-    double currentSpeed = calcSpeed(currentBPM, currentScrollMult);
-    newSegments.push_back({ lastTime, 0.0, currentSpeed, 0 });
-    newSegments.back().hs                = currentHs;
-    newSegments.back().hsValue           = currentHs;
-    newSegments.back().activeBpmValue    = currentBPM;
-    newSegments.back().activeScrollValue = activeScrollValue;
+void ScrollCache::integrateTimingEntry(IntegrationState&        state,
+                                       entt::entity             entity,
+                                       const TimelineComponent& timeline)
+{
+    const bool enableEffects = !m_lastLinearMapping;
+    const auto* tl           = &timeline;
+    if ( tl->m_timestamp > state.lastTime ) {
+        double dt = tl->m_timestamp - state.lastTime;
+        state.currentAbsY += dt * state.currentSpeed;
+        state.lastTime = tl->m_timestamp;
+        m_segments.push_back(
+            { state.lastTime, state.currentAbsY, state.currentSpeed, 0 });
+    }
 
-    for ( const auto& entry : m_rebuildScratch ) {
-        const auto* tl = entry.component;
-        if ( tl->m_timestamp > lastTime ) {
-            double dt = tl->m_timestamp - lastTime;
-            currentAbsY += dt * currentSpeed;
-            lastTime = tl->m_timestamp;
-            newSegments.push_back({ lastTime, currentAbsY, currentSpeed, 0 });
-        }
-
-        if ( tl->m_effect == ::MMM::TimingEffect::BPM ) {
-            newSegments.back().effects |= SCROLL_EFFECT_BPM;
-            newSegments.back().bpmEntity = entry.entity;
-            newSegments.back().bpmValue  = tl->m_value;
-            currentBPM                   = tl->m_value;
-            if ( !hasMalodyMetadata(*tl) ) {
-                // osu! 红线会重置 SV；Malody 的 BPM 不改变 effect 状态。
-                activeScrollValue = 1.0;
-                if ( enableEffects ) {
-                    currentScrollMult = 1.0;
-                }
-            }
-        } else if ( tl->m_effect == ::MMM::TimingEffect::SCROLL ) {
-            newSegments.back().effects |= SCROLL_EFFECT_SCROLL;
-            newSegments.back().scrollEntity = entry.entity;
-            newSegments.back().scrollValue  = tl->m_value;
-            // mmm/Malody 内部均存储原始 SV 倍率；osu! 的负 inherited
-            // beatLength 已在导入边界转换。
-            if ( std::isfinite(tl->m_value) ) {
-                activeScrollValue = tl->m_value;
-                if ( enableEffects ) {
-                    currentScrollMult = tl->m_value;
-                }
-            }
-        } else if ( tl->m_effect == ::MMM::TimingEffect::JUMP ) {
-            newSegments.back().effects |= SCROLL_EFFECT_JUMP;
-            newSegments.back().jumpEntity = entry.entity;
-            newSegments.back().jumpValue  = tl->m_value;
-            m_hasJumpEffects              = true;
+    auto& segment = m_segments.back();
+    if ( tl->m_effect == ::MMM::TimingEffect::BPM ) {
+        segment.effects |= SCROLL_EFFECT_BPM;
+        segment.bpmEntity = entity;
+        segment.bpmValue  = tl->m_value;
+        state.currentBpm  = tl->m_value;
+        if ( !hasMalodyMetadata(*tl) ) {
+            // osu! 红线会重置 SV；Malody 的 BPM 不改变 effect 状态。
+            state.activeScrollValue = 1.0;
             if ( enableEffects ) {
-                // Malody Jump 在滚动积分上制造瞬时断层。
-                currentAbsY += (tl->m_value / 1000.0) * currentSpeed;
-                newSegments.back().absY = currentAbsY;
+                state.currentScrollMult = 1.0;
             }
-        } else if ( tl->m_effect == ::MMM::TimingEffect::HS ) {
-            newSegments.back().effects |= SCROLL_EFFECT_HS;
-            newSegments.back().hsEntity = entry.entity;
-            newSegments.back().hsValue  = tl->m_value;
+        }
+    } else if ( tl->m_effect == ::MMM::TimingEffect::SCROLL ) {
+        segment.effects |= SCROLL_EFFECT_SCROLL;
+        segment.scrollEntity = entity;
+        segment.scrollValue  = tl->m_value;
+        // mmm/Malody 内部均存储原始 SV 倍率；osu! 的负 inherited
+        // beatLength 已在导入边界转换。
+        if ( std::isfinite(tl->m_value) ) {
+            state.activeScrollValue = tl->m_value;
             if ( enableEffects ) {
-                currentHs = tl->m_value;
+                state.currentScrollMult = tl->m_value;
             }
         }
+    } else if ( tl->m_effect == ::MMM::TimingEffect::JUMP ) {
+        segment.effects |= SCROLL_EFFECT_JUMP;
+        segment.jumpEntity = entity;
+        segment.jumpValue  = tl->m_value;
+        m_hasJumpEffects   = true;
+        if ( enableEffects ) {
+            // Malody Jump 在滚动积分上制造瞬时断层。
+            state.currentAbsY += (tl->m_value / 1000.0) * state.currentSpeed;
+            segment.absY = state.currentAbsY;
+        }
+    } else if ( tl->m_effect == ::MMM::TimingEffect::HS ) {
+        segment.effects |= SCROLL_EFFECT_HS;
+        segment.hsEntity = entity;
+        segment.hsValue  = tl->m_value;
+        if ( enableEffects ) {
+            state.currentHs = tl->m_value;
+            m_hasHsEffects  = true;
+        }
+    }
+
+    state.currentSpeed =
+        calcSpeed(state.currentBpm, state.currentScrollMult);
+    segment.speed             = state.currentSpeed;
+    segment.hs                = state.currentHs;
+    segment.activeBpmValue    = state.currentBpm;
+    segment.activeScrollValue = state.activeScrollValue;
+}
+
+/// @brief 增量重建：保留首个变更之前的分段，从其末状态继续积分后缀。
+/// @warning 逻辑低频路径：只对变更实体排序，后缀线性归并与重新积分。
+bool ScrollCache::rebuildSuffix(const entt::registry& timelineRegistry)
+{
+    if ( m_segments.empty() || m_timingOrder.empty() ) return false;
+
+    // 1. 变更实体修改前后的最早时间；BPM 会改变基准速度，只能整体重建。
+    double fromTime = std::numeric_limits<double>::infinity();
+    for ( const auto entity : m_changedEntities ) {
+        if ( const auto it = m_timingKeyOf.find(entity);
+             it != m_timingKeyOf.end() ) {
+            if ( it->second.isBpm ) return false;
+            fromTime = std::min(fromTime, it->second.timestamp);
+        }
+        if ( !timelineRegistry.valid(entity) ) continue;
+        if ( const auto* tl =
+                 timelineRegistry.try_get<const TimelineComponent>(entity) ) {
+            if ( tl->m_effect == ::MMM::TimingEffect::BPM ) return false;
+            fromTime = std::min(fromTime, tl->m_timestamp);
+        }
+    }
+    if ( std::isnan(fromTime) ) return false;
+    if ( std::isinf(fromTime) ) {
+        // 变更实体在两次 refresh 之间创建又销毁，映射没有变化。
+        m_changedEntities.clear();
+        return true;
+    }
 
-        currentSpeed             = calcSpeed(currentBPM, currentScrollMult);
-        newSegments.back().speed = currentSpeed;
-        newSegments.back().hs    = currentHs;
-        newSegments.back().activeBpmValue    = currentBPM;
-        newSegments.back().activeScrollValue = activeScrollValue;
+    // 2. 保留时间早于 fromTime 的分段；首段是积分起点，不能被替换。
+    const auto firstChanged =
+        static_cast<std::size_t>(std::lower_bound(
+                                     m_segments.begin(),
+                                     m_segments.end(),
+                                     fromTime - SUFFIX_CUT_EPSILON,
+                                     [](const ScrollSegment& seg, double t) {
+                                         return seg.time < t;
+                                     }) -
+                                 m_segments.begin());
+    if ( firstChanged == 0 ) return false;
+
+    const ScrollSegment resume      = m_segments[firstChanged - 1];
+    const auto          suffixBegin =
+        std::upper_bound(m_timingOrder.begin(),
+                         m_timingOrder.end(),
+                         resume.time,
+                         [](double t, const TimingKey& key) {
+                             return t < key.timestamp;
+                         });
+    const auto suffixStart =
+        static_cast<std::size_t>(suffixBegin - m_timingOrder.begin());
+
+    // 3. 后缀去掉变更实体，再按积分顺序归并变更后的条目。
+    std::sort(m_changedEntities.begin(), m_changedEntities.end());
+    m_changedEntities.erase(
+        std::unique(m_changedEntities.begin(), m_changedEntities.end()),
+        m_changedEntities.end());
+    const auto isChanged = [this](entt::entity entity) {
+        return std::binary_search(
+            m_changedEntities.begin(), m_changedEntities.end(), entity);
+    };
+
+    std::vector<TimingKey> added;
+    added.reserve(m_changedEntities.size());
+    for ( const auto entity : m_changedEntities ) {
+        m_timingKeyOf.erase(entity);
+        if ( !timelineRegistry.valid(entity) ) continue;
+        if ( const auto* tl =
+                 timelineRegistry.try_get<const TimelineComponent>(entity) ) {
+            const TimingKey key{ tl->m_timestamp,
+                                 tl->m_effect == ::MMM::TimingEffect::BPM,
+                                 entity };
+            added.push_back(key);
+            m_timingKeyOf[entity] = key;
+        }
+    }
+    const auto keyLess = [](const TimingKey& a, const TimingKey& b) {
+        return timingKeyLess(
+            a.timestamp, a.isBpm, a.entity, b.timestamp, b.isBpm, b.entity);
+    };
+    std::sort(added.begin(), added.end(), keyLess);
+
+    std::vector<TimingKey> suffix;
+    suffix.reserve(m_timingOrder.size() - suffixStart + added.size());
+    std::remove_copy_if(suffixBegin,
+                        m_timingOrder.end(),
+                        std::back_inserter(suffix),
+                        [&](const TimingKey& key) {
+                            return isChanged(key.entity);
+                        });
+    m_timingOrder.resize(suffixStart);
+    std::merge(suffix.begin(),
+               suffix.end(),
+               added.begin(),
+               added.end(),
+               std::back_inserter(m_timingOrder),
+               keyLess);
+
+    // 4. 从保留段末状态继续积分。
+    IntegrationState state;
+    state.currentBpm        = resume.activeBpmValue;
+    state.activeScrollValue = resume.activeScrollValue;
+    state.currentScrollMult =
+        m_lastLinearMapping ? 1.0 : resume.activeScrollValue;
+    state.currentHs    = resume.hs;
+    state.currentSpeed = resume.speed;
+    state.currentAbsY  = resume.absY;
+    state.lastTime     = resume.time;
+
+    m_segments.resize(firstChanged);
+    m_hasJumpEffects = false;
+    m_hasHsEffects   = false;
+    for ( const auto& seg : m_segments ) {
+        m_hasJumpEffects |= (seg.effects & SCROLL_EFFECT_JUMP) != 0;
+        m_hasHsEffects |=
+            !m_lastLinearMapping && (seg.effects & SCROLL_EFFECT_HS) != 0;
+    }
+    for ( std::size_t i = suffixStart; i < m_timingOrder.size(); ++i ) {
+        const auto entity = m_timingOrder[i].entity;
+        integrateTimingEntry(
+            state,
+            entity,
+            timelineRegistry.get<const TimelineComponent>(entity));
     }
 
-    m_segments = std::move(newSegments);
-    rebuildAbsYRangeIndex();
-    rebuildMicroImpulseWindows();
-    isDirty = false;
+    m_lastRebuildFromTime = resume.time;
+    m_changedEntities.clear();
+    finishRebuild(firstChanged - 1);
+    return true;
+}
+
+void ScrollCache::finishRebuild(std::size_t firstChangedSegment)
+{
+    if ( firstChangedSegment == 0 ) {
+        rebuildAbsYRangeIndex();
+    } else {
+        rebuildAbsYRangeIndexFrom(firstChangedSegment);
+    }
+    // 首个倒流分段落在未变前缀内时保持不变，否则只扫描重建的后缀。
+    if ( m_firstNonMonotonicSegment >= firstChangedSegment ) {
+        std::size_t i = firstChangedSegment;
+        while ( i < m_segments.size() && m_segments[i].speed >= 0.0 &&
+                (i == 0 || m_segments[i].absY >= m_segments[i - 1].absY) ) {
+            ++i;
+        }
+        m_firstNonMonotonicSegment = i;
+    }
+    rebuildMicroImpulseWindows(firstChangedSegment);
     ++m_revision;
 }
 
@@ -268,18 +495,34 @@ void ScrollCache::rebuildAbsYRangeIndex()
         m_absYRangeIndex.push_back({ minAbsY, maxAbsY, i });
     }
 
-    std::stable_sort(m_absYRangeIndex.begin(),
-                     m_absYRangeIndex.end(),
-                     [](const AbsYRangeEntry& a, const AbsYRangeEntry& b) {
-                         if ( std::abs(a.minAbsY - b.minAbsY) > 1e-9 )
-                             return a.minAbsY < b.minAbsY;
-                         if ( std::abs(a.maxAbsY - b.maxAbsY) > 1e-9 )
-                             return a.maxAbsY < b.maxAbsY;
-                         return a.segmentIndex < b.segmentIndex;
-                     });
+    std::sort(m_absYRangeIndex.begin(), m_absYRangeIndex.end(), absYRangeLess);
 }
 
-void ScrollCache::rebuildMicroImpulseWindows()
+void ScrollCache::rebuildAbsYRangeIndexFrom(std::size_t firstSegment)
+{
+    std::vector<AbsYRangeEntry> changed;
+    changed.reserve(m_segments.size() - std::min(firstSegment,
+                                                 m_segments.size()));
+    for ( std::size_t i = firstSegment; i < m_segments.size(); ++i ) {
+        if ( std::abs(m_segments[i].speed) < 1e-9 ) continue;
+        auto [minAbsY, maxAbsY] = getSegmentAbsYRange(i);
+        changed.push_back({ minAbsY, maxAbsY, i });
+    }
+    std::sort(changed.begin(), changed.end(), absYRangeLess);
+
+    std::erase_if(m_absYRangeIndex, [firstSegment](const AbsYRangeEntry& e) {
+        return e.segmentIndex >= firstSegment;
+    });
+    const auto keptCount = m_absYRangeIndex.size();
+    m_absYRangeIndex.insert(
+        m_absYRangeIndex.end(), changed.begin(), changed.end());
+    std::inplace_merge(m_absYRangeIndex.begin(),
+                       m_absYRangeIndex.begin() + keptCount,
+                       m_absYRangeIndex.end(),
+                       absYRangeLess);
+}
+
+void ScrollCache::rebuildMicroImpulseWindows(std::size_t firstChangedSegment)
 {
     constexpr double MAX_SLICE_SECONDS        = 0.0035;
     constexpr double MAX_WINDOW_SECONDS       = 0.0075;
@@ -287,13 +530,38 @@ void ScrollCache::rebuildMicroImpulseWindows()
     constexpr double MAX_ABS_NET_DISPLACEMENT = 12.0;
     constexpr double MAX_REL_NET_DISPLACEMENT = 0.12;
 
-    m_microImpulseWindows.clear();
+    // 窗口读取连续三个分段，终点不晚于 firstChangedSegment 的窗口不受
+    // 后缀影响。它们之后直到 firstChangedSegment - 1 都不会检出新窗口，
+    // 因此只需从那里继续贪心扫描；保留窗口恰好终止于该分段时跳过它。
+    std::size_t scanStart = 0;
+    if ( firstChangedSegment == 0 ||
+         firstChangedSegment >= m_segments.size() ) {
+        m_microImpulseWindows.clear();
+        m_microImpulseWindows.reserve(m_segments.size() / 8);
+    } else {
+        const double keepUntil = m_segments[firstChangedSegment].time;
+        m_microImpulseWindows.erase(
+            std::upper_bound(m_microImpulseWindows.begin(),
+                             m_microImpulseWindows.end(),
+                             keepUntil,
+                             [](double t, const MicroImpulseWindow& window) {
+                                 return t < window.endTime;
+                             }),
+            m_microImpulseWindows.end());
+        scanStart = firstChangedSegment - 1;
+        if ( !m_microImpulseWindows.empty() &&
+             m_microImpulseWindows.back().endTime >= keepUntil ) {
+            scanStart = firstChangedSegment;
+        }
+        // 后缀重新检出的窗口可能从前一个分段开始，受影响范围随之前移。
+        m_lastRebuildFromTime =
+            std::min(m_lastRebuildFromTime, m_segments[scanStart].time);
+    }
     if ( m_segments.size() < 3 ) {
         return;
     }
 
-    m_microImpulseWindows.reserve(m_segments.size() / 8);
-    for ( std::size_t i = 0; i + 2 < m_segments.size(); ++i ) {
+    for ( std::size_t i = scanStart; i + 2 < m_segments.size(); ++i ) {
         const auto& first  = m_segments[i];
         const auto& second = m_segments[i + 1];
         const auto& after  = m_segments[i + 2];
@@ -449,6 +717,88 @@ double ScrollCache::getTime(double absY) const
     return edge.time + (absY - edge.absY) / edge.speed;
 }
 
+void ScrollCache::getTimeBatch(std::span<const double> absYs,
+                               std::span<double>       times) const
+{
+    const std::size_t count = std::min(absYs.size(), times.size());
+    if ( m_segments.empty() ||
+         m_firstNonMonotonicSegment < m_segments.size() ) {
+        for ( std::size_t i = 0; i < count; ++i ) {
+            times[i] = getTime(absYs[i]);
+        }
+        return;
+    }
+
+    // AbsY 单调时，包含目标的最早分段随输入递增，与 getTime 的选择一致。
+    constexpr double EPS      = 1e-6;
+    std::size_t      segment  = 0;
+    double           previous = -std::numeric_limits<double>::infinity();
+    for ( std::size_t i = 0; i < count; ++i ) {
+        const double absY = toUnscaledAbsY(absYs[i]);
+        if ( !(absY >= previous) ) {
+            times[i] = getTime(absYs[i]);
+            continue;
+        }
+        previous = absY;
+
+        while ( segment < m_segments.size() &&
+                (std::abs(m_segments[segment].speed) < 1e-9 ||
+                 getSegmentAbsYRange(segment).second < absY - EPS) ) {
+            ++segment;
+        }
+        if ( segment == m_segments.size() ||
+             getSegmentAbsYRange(segment).first > absY + EPS ) {
+            times[i] = getTime(absYs[i]);
+            continue;
+        }
+        const auto& seg = m_segments[segment];
+        times[i]        = seg.time + (absY - seg.absY) / seg.speed;
+    }
+}
+
+void ScrollCache::getAbsYBatch(std::span<const double> times,
+                               std::span<double>       absYs,
+                               std::span<double>       hs) const
+{
+    const std::size_t count  = std::min(times.size(), absYs.size());
+    const bool        withHs = hs.size() >= count && !hs.empty();
+    if ( m_segments.empty() ) {
+        const double DEFAULT_SPEED = 500.0 * m_lastZoom;
+        for ( std::size_t i = 0; i < count; ++i ) {
+            absYs[i] = applyAnimatedZoomScale(times[i] * DEFAULT_SPEED);
+            if ( withHs ) hs[i] = 1.0;
+        }
+        return;
+    }
+
+    // 合并遍历：segment 始终是最后一个 time <= t 的分段（早于首段时为首段）。
+    std::size_t segment = 0;
+    for ( std::size_t i = 0; i < count; ++i ) {
+        const double t = times[i];
+        if ( t < m_segments[segment].time && segment > 0 ) {
+            // 乱序输入回退为一次二分查找，之后继续合并遍历。
+            auto it = std::upper_bound(m_segments.begin(),
+                                       m_segments.end(),
+                                       t,
+                                       [](double val, const ScrollSegment& s) {
+                                           return val < s.time;
+                                       });
+            segment = it == m_segments.begin()
+                          ? 0
+                          : static_cast<std::size_t>(
+                                std::prev(it) - m_segments.begin());
+        }
+        while ( segment + 1 < m_segments.size() &&
+                m_segments[segment + 1].time <= t ) {
+            ++segment;
+        }
+
+        const auto& seg = m_segments[segment];
+        absYs[i] = applyAnimatedZoomScale(seg.absY + (t - seg.time) * seg.speed);
+        if ( withHs ) hs[i] = seg.hs;
+    }
+}
+
 double ScrollCache::getSpeedAt(double t) const
 {
     if ( m_segments.empty() ) {
@@ -538,6 +888,11 @@ bool ScrollCache::hasJumpEffects() const
     return m_hasJumpEffects;
 }
 
+bool ScrollCache::hasHsEffects() const
+{
+    return m_hasHsEffects;
+}
+
 bool ScrollCache::canInterpolateLinearly(double startTime,
                                          double duration) const
 {
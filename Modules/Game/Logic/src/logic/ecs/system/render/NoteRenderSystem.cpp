@@ -3,6 +3,8 @@
 #include "config/skin/SkinConfig.h"
 #include "logic/ecs/components/InteractionComponent.h"
 #include "logic/ecs/components/NoteComponent.h"
+#include "logic/ecs/components/SampleComponent.h"
+#include "logic/ecs/components/TransformComponent.h"
 #include "logic/ecs/components/TimelineComponent.h"
 #include "logic/ecs/system/BackgroundRenderSystem.h"
 #include "logic/ecs/system/CanvasComponentRenderSystem.h"
@@ -150,21 +152,45 @@ void drawJudgmentGuideBox(Batcher& batcher, float leftX, float centerY,
 
 }  // namespace
 
+/// @brief 串行写入快照阶段共享的注册表状态，之后各视口只读访问 registry。
+/// @warning 逻辑线程每 update 执行一次；组件存储创建与 ctx 写入都必须在
+/// 这里完成，分桶索引只在版本变化时重建。
+void NoteRenderSystem::prepareSnapshotPhase(
+    entt::registry& registry, entt::registry& sampleRegistry,
+    const entt::registry& timelineRegistry)
+{
+    // 非 const registry 的 get/try_get 会按需创建组件存储，提前创建后
+    // 快照阶段的查询不再修改存储表。
+    registry.storage<NoteComponent>();
+    registry.storage<TransformComponent>();
+    registry.storage<InteractionComponent>();
+    sampleRegistry.storage<SampleComponent>();
+    sampleRegistry.storage<InteractionComponent>();
+
+    const auto* cache = timelineRegistry.ctx().find<ScrollCache>();
+    if ( !cache ) return;
+    if ( auto** cacheSlot = registry.ctx().find<const ScrollCache*>() ) {
+        *cacheSlot = cache;
+    } else {
+        registry.ctx().emplace<const ScrollCache*>(cache);
+    }
+    prepareNoteQueryIndex(registry);
+}
+
 /// @brief 生成指定画布的批量渲染快照。
 /// @warning 热路径：每帧/每 update 执行；禁止引入文件系统访问、
 /// registry 全量无缓存扫描或阻塞同步；Timeline 与活跃主画布 Move
 /// 工具会复制 ScrollSegment 供 UI 精确时间映射。
 void NoteRenderSystem::generateSnapshot(
     entt::registry& registry, entt::registry& sampleRegistry,
-    const std::vector<entt::entity>&             sortedSampleEntities,
-    const std::vector<double>&                   sortedSampleMaxEndPrefix,
+    const TimeIntervalIndex&                     sampleIndex,
     const entt::registry&                        timelineRegistry,
     const std::vector<const TimelineComponent*>& bpmEvents,
     RenderSnapshot* snapshot, const std::string& cameraId, double currentTime,
     float viewportWidth, float viewportHeight, float judgmentLineY,
     int32_t trackCount, int32_t bgmTrackCount,
     const Config::EditorConfig& config, float mainViewportHeight,
-    HitFXSystem* hitFXSystem)
+    HitFXSystem* hitFXSystem, RetainedNoteGeometryCache* noteGeometryCache)
 {
     const bool isMainCanvas = SessionUtils::isMainCanvasCameraId(cameraId);
     const auto normalizeInteractionHitboxScale = [](float scale) {
@@ -189,9 +215,10 @@ void NoteRenderSystem::generateSnapshot(
     const auto* cache = timelineRegistry.ctx().find<ScrollCache>();
     if ( !cache ) return;
 
-    // 将 ScrollCache 指针存入 context 供 renderPolyline 等后续使用
+    // 将 ScrollCache 指针存入 context 供 renderPolyline 等后续使用；
+    // prepareSnapshotPhase 已写入相同指针时保持只读，允许多视口并行进入。
     if ( auto** cacheSlot = registry.ctx().find<const ScrollCache*>() ) {
-        *cacheSlot = cache;
+        if ( *cacheSlot != cache ) *cacheSlot = cache;
     } else {
         registry.ctx().emplace<const ScrollCache*>(cache);
     }
@@ -537,7 +564,8 @@ void NoteRenderSystem::generateSnapshot(
                                       topY,
                                       bottomY,
                                       singleTrackW,
-                                      renderScaleY);
+                                      renderScaleY,
+                                      noteGeometryCache);
         if ( isMainCanvas ) {
             const auto laneProjection =
                 calculateCanvasLaneProjection(viewportWidth,
@@ -550,8 +578,7 @@ void NoteRenderSystem::generateSnapshot(
                                               config.settings.enableBmsEditing,
                                               config.settings.enableDraftLanes);
             SampleRenderSystem::renderSamples(sampleRegistry,
-                                              sortedSampleEntities,
-                                              sortedSampleMaxEndPrefix,
+                                              sampleIndex,
                                               snapshot,
                                               batcher,
                                               laneProjection,
@@ -874,7 +901,11 @@ void NoteRenderSystem::generateTimelineSnapshot(
         auto   visibleRanges = cache->getTimeRangesForAbsYWindow(
             std::min(topAbsY, bottomAbsY), std::max(topAbsY, bottomAbsY));
 
-        batcher.setTexture(TextureID::None);
+        // 先收集可见范围内的拍线时间，再按时间顺序批量映射 AbsY 与 HS。
+        std::vector<double> beatTimes;
+        std::vector<int>    beatDenominators;
+        beatTimes.reserve(64);
+        beatDenominators.reserve(64);
         for ( size_t i = 0; i < bpmEvents.size(); ++i ) {
             const auto* currentBPM = bpmEvents[i];
             double      bpmTime    = currentBPM->m_timestamp;
@@ -922,52 +953,56 @@ void NoteRenderSystem::generateTimelineSnapshot(
                         int gcd     = std::gcd(beatIndex, beatDivisor);
                         denominator = beatDivisor / gcd;
                     }
-
-                    auto [color, width] = getBeatLineConfig(denominator);
-                    float y = judgmentLineY -
-                              static_cast<float>(
-                                  cache->getDisplayDelta(t, currentAbsY, t));
-                    if ( y >= 0.0f && y <= viewportHeight ) {
-                        color.a *= 0.75f;
-                        const float beatLineX =
-                            professionalMode ? 0.0f : paddingX;
-                        const float beatLineW =
-                            professionalMode ? viewportWidth : lineW;
-                        batcher.setTexture(TextureID::None);
-                        if ( snapshot->isSnapped &&
-                             std::abs(t - snapshot->snappedTime) < 1e-6 ) {
-                            glm::vec4 glowCol = color;
-                            glowCol.a *= 0.6f;
-                            batcher.pushQuad(beatLineX,
-                                             y + (width + 4.0f) * 0.5f,
-                                             beatLineW,
-                                             width + 4.0f,
-                                             glowCol);
-                            glowCol.a *= 0.5f;
-                            batcher.pushQuad(beatLineX,
-                                             y + (width + 10.0f) * 0.5f,
-                                             beatLineW,
-                                             width + 10.0f,
-                                             glowCol);
-                            glowCol.a *= 0.5f;
-                            batcher.pushQuad(beatLineX,
-                                             y + (width + 20.0f) * 0.5f,
-                                             beatLineW,
-                                             width + 20.0f,
-                                             glowCol);
-                        }
-                        batcher.pushQuad(beatLineX,
-                                         y + width * 0.5f,
-                                         beatLineW,
-                                         width,
-                                         color);
-                    }
+                    beatTimes.push_back(t);
+                    beatDenominators.push_back(denominator);
 
                     stepOffset++;
                     t = bpmTime + stepOffset * stepDuration;
                 }
             }
         }
+
+        // 拍线锚点即自身时间，HS 取所在分段，与 getDisplayDelta(t, ·, t) 一致。
+        std::vector<double> beatAbsYs(beatTimes.size());
+        std::vector<double> beatHs(beatTimes.size());
+        cache->getAbsYBatch(beatTimes, beatAbsYs, beatHs);
+
+        const float beatLineX = professionalMode ? 0.0f : paddingX;
+        const float beatLineW = professionalMode ? viewportWidth : lineW;
+        batcher.setTexture(TextureID::None);
+        for ( size_t beat = 0; beat < beatTimes.size(); ++beat ) {
+            float y = judgmentLineY -
+                      static_cast<float>((beatAbsYs[beat] - currentAbsY) *
+                                         beatHs[beat]);
+            if ( y < 0.0f || y > viewportHeight ) continue;
+
+            auto [color, width] = getBeatLineConfig(beatDenominators[beat]);
+            color.a *= 0.75f;
+            if ( snapshot->isSnapped &&
+                 std::abs(beatTimes[beat] - snapshot->snappedTime) < 1e-6 ) {
+                glm::vec4 glowCol = color;
+                glowCol.a *= 0.6f;
+                batcher.pushQuad(beatLineX,
+                                 y + (width + 4.0f) * 0.5f,
+                                 beatLineW,
+                                 width + 4.0f,
+                                 glowCol);
+                glowCol.a *= 0.5f;
+                batcher.pushQuad(beatLineX,
+                                 y + (width + 10.0f) * 0.5f,
+                                 beatLineW,
+                                 width + 10.0f,
+                                 glowCol);
+                glowCol.a *= 0.5f;
+                batcher.pushQuad(beatLineX,
+                                 y + (width + 20.0f) * 0.5f,
+                                 beatLineW,
+                                 width + 20.0f,
+                                 glowCol);
+            }
+            batcher.pushQuad(
+                beatLineX, y + width * 0.5f, beatLineW, width, color);
+        }
     }
 
     // 5. 绘制 Timing 事件为普通 Note 形状。
@@ -1029,8 +1064,47 @@ void NoteRenderSystem::generateTimelineSnapshot(
                 snapshot->indices.size() - markerIndexOffset);
         };
 
-    for ( const auto& seg : cache->getSegments() ) {
-        if ( seg.effects == 0 ) continue;
+    // 没有 HS 缩放时标记 Y 只由 AbsY 决定，按可见时间范围二分定位分段；
+    // 窗口上下各多留一屏，吸附与快照偏移仍能命中视口边缘外的标记。
+    const auto&         segments = cache->getSegments();
+    std::vector<size_t> markerSegments;
+    auto collectMarkerSegments = [&](size_t first, size_t last) {
+        for ( size_t index = first; index < last; ++index ) {
+            if ( segments[index].effects != 0 ) markerSegments.push_back(index);
+        }
+    };
+    if ( cache->hasHsEffects() ) {
+        collectMarkerSegments(0, segments.size());
+    } else {
+        const double markerTopAbsY =
+            currentAbsY + judgmentLineY + viewportHeight;
+        const double markerBottomAbsY =
+            currentAbsY + judgmentLineY - viewportHeight * 2.0;
+        auto segmentAt = [&](double time) {
+            return static_cast<size_t>(
+                std::lower_bound(segments.begin(),
+                                 segments.end(),
+                                 time,
+                                 [](const ScrollSegment& seg, double value) {
+                                     return seg.time < value;
+                                 }) -
+                segments.begin());
+        };
+        // 时间范围升序且互不重叠；相邻范围落在同一分段时跳过重复下标。
+        size_t collectedEnd = 0;
+        for ( const auto& [startTime, endTime] :
+              cache->getTimeRangesForAbsYWindow(markerBottomAbsY,
+                                                markerTopAbsY) ) {
+            const size_t first =
+                std::max(collectedEnd, segmentAt(startTime - 1e-6));
+            const size_t last = segmentAt(endTime + 1e-6);
+            collectMarkerSegments(first, last);
+            collectedEnd = std::max(collectedEnd, last);
+        }
+    }
+
+    for ( size_t segmentIndex : markerSegments ) {
+        const auto& seg = segments[segmentIndex];
 
         const double segmentAbsY = seg.absY * cache->getAnimatedZoomScale();
         float y = judgmentLineY -
@@ -8,14 +8,16 @@
 #include "logic/ecs/system/ScrollCache.h"
 #include "logic/ecs/system/render/AudioObjectLabelRenderer.h"
 #include "logic/ecs/system/render/Batcher.h"
+#include "logic/ecs/system/render/RetainedNoteGeometry.h"
+#include "logic/session/OverlapDetector.h"
 #include "logic/session/SessionUtils.h"
 #include "logic/session/context/SessionContext.h"
 #include <algorithm>
 #include <cmath>
 #include <cstdint>
+#include <functional>
 #include <iterator>
 #include <limits>
-#include <unordered_map>
 #include <unordered_set>
 #include <utility>
 
@@ -42,8 +44,8 @@ struct NoteAbsYRangeEntry {
 struct NoteAbsYBucketIndex {
     /// @brief 建立索引时使用的 ScrollCache。
     const ScrollCache* cache{ nullptr };
-    /// @brief 建立索引时使用的排序音符列表。
-    const std::vector<entt::entity>* sourceEntities{ nullptr };
+    /// @brief 建立索引时使用的音符可见性索引。
+    const TimeIntervalIndex* sourceEntities{ nullptr };
     /// @brief 建立索引时的排序音符数量。
     std::size_t sourceCount{ 0 };
     /// @brief 建立索引时的 ScrollCache 版本。
@@ -62,10 +64,6 @@ struct NoteAbsYBucketIndex {
     std::vector<NoteAbsYRangeEntry> entries;
     /// @brief AbsY 桶到 entries 下标的映射。
     std::vector<std::vector<std::uint32_t>> buckets;
-    /// @brief 查询去重标记。
-    std::vector<std::uint32_t> seenSerials;
-    /// @brief 当前查询序号。
-    std::uint32_t querySerial{ 0 };
 };
 
 /// @brief 计算单个音符在时间维度上的保守覆盖范围。
@@ -90,13 +88,17 @@ static void forEachNoteVisibilitySampleTime(const NoteComponent& note,
 /// @param currentAbsY 当前快照动画时间对应的绝对 Y。
 /// @param visualPaddingPixels 当前皮肤与缩放下的候选视觉余量。
 /// @param interpolationSeconds UI 亚帧补偿需要覆盖的播放时间。
+/// @param seenSerials 调用方快照持有的分桶条目去重标记。
+/// @param querySerial 调用方快照持有的当前查询序号。
 /// @warning 热路径：每次音符快照生成时执行；只能查询已构建的 AbsY
-/// 分桶索引，不得完整遍历全量 Note，除非索引失效进入保守兜底。
+/// 分桶索引，不得完整遍历全量 Note，除非索引失效进入保守兜底。多视口
+/// 并行生成时分桶索引只读，去重状态必须来自各自的快照。
 static void collectNotesInRange(
     entt::registry& registry, const ScrollCache* cache, double currentTime,
     double currentAbsY, float judgmentLineY, float topY, float bottomY,
     float renderScaleY, float visualPaddingPixels, double interpolationSeconds,
-    std::vector<entt::entity>& result, std::unordered_set<entt::entity>& seen);
+    std::vector<entt::entity>& result, std::unordered_set<entt::entity>& seen,
+    std::vector<std::uint32_t>& seenSerials, std::uint32_t& querySerial);
 
 /// @brief 估算 UI 亚帧补偿期间 ScrollCache 可能产生的最大 AbsY 位移。
 /// @warning 热路径：每次音符候选反查前执行；只允许访问当前时间附近的
@@ -110,7 +112,7 @@ static double calculateInterpolationPaddingAbsY(const ScrollCache* cache,
 /// 版本变化时完整扫描音符；生成快照热路径只查询桶。
 static NoteAbsYBucketIndex& getOrBuildNoteAbsYBucketIndex(
     entt::registry& registry, const ScrollCache* cache,
-    const std::vector<entt::entity>& entities, std::uint64_t noteRevision);
+    const TimeIntervalIndex& entities, std::uint64_t noteRevision);
 
 /// @brief 获取普通物件主体末端的 HS 锚点时间。
 /// @warning 热路径：音符可见性和命中盒计算中调用；保持纯计算，不得分配。
@@ -124,6 +126,13 @@ static double getCarrierEndAnchorTime(const NoteComponent& note,
     return note.m_timestamp + note.m_duration;
 }
 
+/// @brief 音符所属的保留几何时间分桶。
+static std::int64_t retainedNoteChunkId(double timestamp)
+{
+    return static_cast<std::int64_t>(
+        std::floor(timestamp / RETAINED_NOTE_CHUNK_SECONDS));
+}
+
 /// @brief 在草稿或玩家轨道物件锚点上方绘制绑定音效标签。
 /// @warning
 /// 主画布热路径：只处理调用方已剔除的物件锚点，不得访问文件系统或分配堆内存。
@@ -166,7 +175,8 @@ void NoteRenderSystem::renderNotes(
     const std::string& cameraId, double currentTime, float judgmentLineY,
     int32_t trackCount, const Config::EditorConfig& config, Batcher& batcher,
     float leftX, float clipLeftX, float rightX, float topY, float bottomY,
-    float singleTrackW, float renderScaleY)
+    float singleTrackW, float renderScaleY,
+    RetainedNoteGeometryCache* noteGeometryCache)
 {
     // 1. 准备上下文与颜色
     NoteRenderSystem::NoteRenderContext ctx =
@@ -190,7 +200,9 @@ void NoteRenderSystem::renderNotes(
             ? std::abs(snapshot->playbackSpeed) * MAX_UI_INTERPOLATION_SECONDS
             : 0.0,
         noteEntities,
-        noteSeen);
+        noteSeen,
+        snapshot->noteBucketSeenScratch,
+        snapshot->noteBucketQuerySerial);
 
     if ( !config.settings.enableDraftLanes ) {
         std::erase_if(noteEntities, [&registry](entt::entity entity) {
@@ -252,7 +264,8 @@ void NoteRenderSystem::renderNotes(
         trackCount,
         generatePolylineHitboxes,
         config.visual.showBoundSampleLabels &&
-            SessionUtils::isMainCanvasCameraId(cameraId));
+            SessionUtils::isMainCanvasCameraId(cameraId),
+        noteGeometryCache);
 
     // 4. 发光层渲染
     NoteRenderSystem::renderNoteGlowLayer(registry,
@@ -459,7 +472,7 @@ static double calculateInterpolationPaddingAbsY(const ScrollCache* cache,
 
 static NoteAbsYBucketIndex& getOrBuildNoteAbsYBucketIndex(
     entt::registry& registry, const ScrollCache* cache,
-    const std::vector<entt::entity>& entities, std::uint64_t noteRevision)
+    const TimeIntervalIndex& entities, std::uint64_t noteRevision)
 {
     auto* index = registry.ctx().find<NoteAbsYBucketIndex>();
     if ( !index ) {
@@ -485,7 +498,6 @@ static NoteAbsYBucketIndex& getOrBuildNoteAbsYBucketIndex(
     index->requiresFullExactScan = false;
     index->entries.clear();
     index->buckets.clear();
-    index->seenSerials.clear();
 
     if ( !cache || entities.empty() ) {
         index->minHs = 1.0;
@@ -497,7 +509,8 @@ static NoteAbsYBucketIndex& getOrBuildNoteAbsYBucketIndex(
     double globalMinAbsY = std::numeric_limits<double>::infinity();
     double globalMaxAbsY = -std::numeric_limits<double>::infinity();
 
-    for ( auto entity : entities ) {
+    for ( const auto& sortedEntry : entities ) {
+        const auto entity = sortedEntry.entity;
         if ( !registry.valid(entity) ||
              !registry.all_of<NoteComponent>(entity) ) {
             continue;
@@ -544,7 +557,6 @@ static NoteAbsYBucketIndex& getOrBuildNoteAbsYBucketIndex(
         index->requiresFullExactScan = true;
     }
 
-    index->seenSerials.assign(index->entries.size(), 0);
     if ( index->entries.empty() || !std::isfinite(globalMinAbsY) ||
          !std::isfinite(globalMaxAbsY) ||
          globalMaxAbsY < globalMinAbsY - 1e-6 ) {
@@ -584,16 +596,31 @@ static NoteAbsYBucketIndex& getOrBuildNoteAbsYBucketIndex(
     return *index;
 }
 
+void NoteRenderSystem::prepareNoteQueryIndex(entt::registry& registry)
+{
+    const auto** cachePtr = registry.ctx().find<const ScrollCache*>();
+    const auto** sortedEntitiesPtr =
+        registry.ctx().find<const TimeIntervalIndex*>();
+    const auto** noteRevisionPtr = registry.ctx().find<const std::uint64_t*>();
+    if ( !cachePtr || !(*cachePtr) || !sortedEntitiesPtr ||
+         !(*sortedEntitiesPtr) || !noteRevisionPtr || !(*noteRevisionPtr) ) {
+        return;
+    }
+    getOrBuildNoteAbsYBucketIndex(
+        registry, *cachePtr, **sortedEntitiesPtr, **noteRevisionPtr);
+}
+
 static void collectNotesInRange(
     entt::registry& registry, const ScrollCache* cache, double currentTime,
     double currentAbsY, float judgmentLineY, float topY, float bottomY,
     float renderScaleY, float visualPaddingPixels, double interpolationSeconds,
-    std::vector<entt::entity>& result, std::unordered_set<entt::entity>& seen)
+    std::vector<entt::entity>& result, std::unordered_set<entt::entity>& seen,
+    std::vector<std::uint32_t>& seenSerials, std::uint32_t& querySerial)
 {
     result.clear();
     seen.clear();
     const auto** sortedEntitiesPtr =
-        registry.ctx().find<const std::vector<entt::entity>*>();
+        registry.ctx().find<const TimeIntervalIndex*>();
     if ( !sortedEntitiesPtr || !(*sortedEntitiesPtr) ) return;
 
     const auto& entities = **sortedEntitiesPtr;
@@ -636,12 +663,12 @@ static void collectNotesInRange(
 
     auto runFullExactScan = [&]() {
         result.reserve(count);
-        for ( auto entity : entities ) {
-            const auto& note = registry.get<const NoteComponent>(entity);
+        for ( const auto& entry : entities ) {
+            const auto& note = registry.get<const NoteComponent>(entry.entity);
             if ( note.m_isSubNote ) continue;
 
             if ( isDisplayVisible(note) ) {
-                result.push_back(entity);
+                result.push_back(entry.entity);
             }
         }
     };
@@ -730,20 +757,24 @@ static void collectNotesInRange(
 
     const auto startBucket = bucketForAbsY(queryMinAbsY);
     const auto endBucket   = bucketForAbsY(queryMaxAbsY);
-    ++index.querySerial;
-    if ( index.querySerial == 0 ) {
-        std::fill(index.seenSerials.begin(), index.seenSerials.end(), 0);
-        index.querySerial = 1;
+    // 索引重建后旧标记均小于新序号，只需补齐长度。
+    if ( seenSerials.size() != index.entries.size() ) {
+        seenSerials.resize(index.entries.size(), 0);
+    }
+    ++querySerial;
+    if ( querySerial == 0 ) {
+        std::fill(seenSerials.begin(), seenSerials.end(), 0);
+        querySerial = 1;
     }
 
     result.reserve(256);
     for ( std::size_t bucket = startBucket; bucket <= endBucket; ++bucket ) {
         for ( std::uint32_t entryIndex : index.buckets[bucket] ) {
             if ( entryIndex >= index.entries.size() ) continue;
-            if ( index.seenSerials[entryIndex] == index.querySerial ) {
+            if ( seenSerials[entryIndex] == querySerial ) {
                 continue;
             }
-            index.seenSerials[entryIndex] = index.querySerial;
+            seenSerials[entryIndex] = querySerial;
 
             const auto& entry = index.entries[entryIndex];
             if ( entry.maxAbsY < queryMinAbsY ||
@@ -961,7 +992,8 @@ void NoteRenderSystem::renderNoteBaseLayer(
     const std::vector<entt::entity>& noteEntities, Batcher& batcher,
     float currentTime, float judgmentLineY, float leftX, float rightX,
     float topY, float bottomY, float singleTrackW, float renderScaleY,
-    int32_t trackCount, bool generateHitboxes, bool showBoundSampleLabels)
+    int32_t trackCount, bool generateHitboxes, bool showBoundSampleLabels,
+    RetainedNoteGeometryCache* noteGeometryCache)
 {
     std::vector<entt::entity> visibleEntities;
     for ( auto entity : noteEntities ) {
@@ -996,136 +1028,45 @@ void NoteRenderSystem::renderNoteBaseLayer(
         visibleEntities.push_back(entity);
     }
 
+    const bool usedRetainedGeometry =
+        noteGeometryCache &&
+        NoteRenderSystem::renderRetainedNoteBaseLayer(registry,
+                                                      snapshot,
+                                                      ctx,
+                                                      config,
+                                                      visibleEntities,
+                                                      batcher,
+                                                      *noteGeometryCache,
+                                                      judgmentLineY,
+                                                      leftX,
+                                                      rightX,
+                                                      topY,
+                                                      bottomY,
+                                                      singleTrackW,
+                                                      renderScaleY,
+                                                      generateHitboxes);
+
     /// @brief visibleEntities 保持自 SessionContext
     /// 预排序缓存继承来的时间升序。
     /// 基础层按反向顺序绘制，避免在热路径内再次完整排序。
-    for ( auto it = visibleEntities.rbegin(); it != visibleEntities.rend();
+    for ( auto it = visibleEntities.rbegin();
+          !usedRetainedGeometry && it != visibleEntities.rend();
           ++it ) {
-        /// @brief 当前反向遍历到的可见音符实体。
-        entt::entity entity    = *it;
-        const auto&  transform = registry.get<const TransformComponent>(entity);
-        const auto&  note      = registry.get<const NoteComponent>(entity);
-
-        // 处理拖拽/剪切时的视觉反馈；选中反馈由发光层按当前颜色绘制。
-        float alphaMul = 1.0f;
-        if ( auto* ic = registry.try_get<InteractionComponent>(entity) ) {
-            if ( ic->isDragging || ic->isCut ) {
-                alphaMul = 0.5f;
-            }
-        }
-
-        float screenY =
-            judgmentLineY -
-            static_cast<float>(ctx.cache->getDisplayDelta(
-                note.m_timestamp, ctx.currentAbsY, note.m_timestamp)) *
-                renderScaleY;
-        float visualH = static_cast<float>(ctx.cache->getDisplayDelta(
-                            note.m_timestamp + note.m_duration,
-                            ctx.cache->getAbsY(note.m_timestamp),
-                            note.m_timestamp)) *
-                        renderScaleY;
-        float trackX  = leftX + note.m_trackIndex * singleTrackW;
-
-        // 应用自定义颜色与 Alpha。
-        glm::vec4 curColorNote =
-            resolveNoteColor(note, NoteColorSlot::Tap, ctx.colorTap);
-        glm::vec4 curColorHead =
-            resolveNoteColor(note, NoteColorSlot::Head, ctx.colorHead);
-        glm::vec4 curColorHoldBody =
-            resolveNoteColor(note, NoteColorSlot::Hold, ctx.colorHold);
-        glm::vec4 curColorHoldEnd =
-            resolveNoteColor(note, NoteColorSlot::End, ctx.colorEnd);
-        glm::vec4 curColorNode =
-            resolveNoteColor(note, NoteColorSlot::Node, ctx.colorNode);
-        glm::vec4 curColorArrow =
-            resolveNoteColor(note, NoteColorSlot::FlickArrow, ctx.colorArrow);
-
-        const auto objectKind    = note.m_isDraft ? ChartObjectKind::DraftNote
-                                                  : ChartObjectKind::PlayerNote;
-        bool       isFullErasing = snapshot->erasingObjectKind == objectKind &&
-                                   snapshot->erasingEntities.count(entity) &&
-                                   snapshot->erasingSubIndex == -1;
-        if ( isFullErasing ) {
-            curColorNote     = { 1.0f, 0.2f, 0.2f, 1.0f };
-            curColorHead     = { 1.0f, 0.2f, 0.2f, 1.0f };
-            curColorHoldBody = { 1.0f, 0.2f, 0.2f, 1.0f };
-            curColorHoldEnd  = { 1.0f, 0.2f, 0.2f, 1.0f };
-            curColorNode     = { 1.0f, 0.2f, 0.2f, 1.0f };
-            curColorArrow    = { 1.0f, 0.2f, 0.2f, 1.0f };
-            alphaMul *= 0.5f;
-        }
-
-        curColorNote.a *= alphaMul;
-        curColorHead.a *= alphaMul;
-        curColorHoldBody.a *= alphaMul;
-        curColorHoldEnd.a *= alphaMul;
-        curColorNode.a *= alphaMul;
-        curColorArrow.a *= alphaMul;
-
-        if ( note.m_type == ::MMM::NoteType::NOTE )
-            NoteRenderSystem::renderTap(
-                batcher,
-                note,
-                config,
-                trackX + (singleTrackW - ctx.noteW) * 0.5f,
-                screenY,
-                ctx.noteW,
-                ctx.noteH,
-                ctx.baseAspect,
-                curColorNote);
-        else if ( note.m_type == ::MMM::NoteType::HOLD )
-            NoteRenderSystem::renderHold(
-                batcher,
-                note,
-                config,
-                snapshot,
-                trackX + (singleTrackW - ctx.noteW) * 0.5f,
-                ctx.noteW,
-                ctx.noteH,
-                singleTrackW,
-                curColorHead,
-                curColorHoldBody,
-                curColorHoldEnd,
-                ctx.cache,
-                ctx.currentAbsY,
-                judgmentLineY,
-                renderScaleY);
-        else if ( note.m_type == ::MMM::NoteType::FLICK )
-            NoteRenderSystem::renderFlick(
-                batcher,
-                note,
-                config,
-                snapshot,
-                trackX + (singleTrackW - ctx.noteW) * 0.5f,
-                screenY,
-                ctx.noteW,
-                ctx.noteH,
-                singleTrackW,
-                curColorHead,
-                curColorHoldBody,
-                curColorArrow);
-        else if ( note.m_type == ::MMM::NoteType::POLYLINE )
-            NoteRenderSystem::renderPolyline(ctx.cache,
-                                             batcher,
-                                             note,
-                                             config,
-                                             snapshot,
-                                             ctx.currentAbsY,
-                                             ctx.currentTime,
-                                             judgmentLineY,
-                                             leftX,
-                                             rightX,
-                                             topY,
-                                             bottomY,
-                                             singleTrackW,
-                                             renderScaleY,
-                                             curColorHead,
-                                             curColorHoldBody,
-                                             curColorHoldEnd,
-                                             curColorNode,
-                                             curColorArrow,
-                                             entity,
-                                             generateHitboxes);
+        NoteRenderSystem::drawBaseNote(registry,
+                                       snapshot,
+                                       ctx,
+                                       config,
+                                       batcher,
+                                       *it,
+                                       judgmentLineY,
+                                       leftX,
+                                       rightX,
+                                       topY,
+                                       bottomY,
+                                       singleTrackW,
+                                       renderScaleY,
+                                       generateHitboxes,
+                                       true);
     }
 
     if ( showBoundSampleLabels ) {
@@ -1187,6 +1128,426 @@ void NoteRenderSystem::renderNoteBaseLayer(
     batcher.flush();
 }
 
+void NoteRenderSystem::drawBaseNote(
+    entt::registry& registry, RenderSnapshot* snapshot,
+    const NoteRenderSystem::NoteRenderContext& ctx,
+    const Config::EditorConfig& config, Batcher& batcher, entt::entity entity,
+    float judgmentLineY, float leftX, float rightX, float topY, float bottomY,
+    float singleTrackW, float renderScaleY, bool generateHitboxes,
+    bool applyInteractionState)
+{
+    const auto& transform = registry.get<const TransformComponent>(entity);
+    const auto& note      = registry.get<const NoteComponent>(entity);
+
+    // 处理拖拽/剪切时的视觉反馈；选中反馈由发光层按当前颜色绘制。
+    float alphaMul = 1.0f;
+    if ( applyInteractionState ) {
+        if ( auto* ic = registry.try_get<InteractionComponent>(entity) ) {
+            if ( ic->isDragging || ic->isCut ) {
+                alphaMul = 0.5f;
+            }
+        }
+    }
+
+    float screenY =
+        judgmentLineY -
+        static_cast<float>(ctx.cache->getDisplayDelta(
+            note.m_timestamp, ctx.currentAbsY, note.m_timestamp)) *
+            renderScaleY;
+    float visualH = static_cast<float>(ctx.cache->getDisplayDelta(
+                        note.m_timestamp + note.m_duration,
+                        ctx.cache->getAbsY(note.m_timestamp),
+                        note.m_timestamp)) *
+                    renderScaleY;
+    float trackX  = leftX + note.m_trackIndex * singleTrackW;
+
+    // 应用自定义颜色与 Alpha。
+    glm::vec4 curColorNote =
+        resolveNoteColor(note, NoteColorSlot::Tap, ctx.colorTap);
+    glm::vec4 curColorHead =
+        resolveNoteColor(note, NoteColorSlot::Head, ctx.colorHead);
+    glm::vec4 curColorHoldBody =
+        resolveNoteColor(note, NoteColorSlot::Hold, ctx.colorHold);
+    glm::vec4 curColorHoldEnd =
+        resolveNoteColor(note, NoteColorSlot::End, ctx.colorEnd);
+    glm::vec4 curColorNode =
+        resolveNoteColor(note, NoteColorSlot::Node, ctx.colorNode);
+    glm::vec4 curColorArrow =
+        resolveNoteColor(note, NoteColorSlot::FlickArrow, ctx.colorArrow);
+
+    const auto objectKind    = note.m_isDraft ? ChartObjectKind::DraftNote
+                                              : ChartObjectKind::PlayerNote;
+    bool       isFullErasing = applyInteractionState &&
+                               snapshot->erasingObjectKind == objectKind &&
+                               snapshot->erasingEntities.count(entity) &&
+                               snapshot->erasingSubIndex == -1;
+    if ( isFullErasing ) {
+        curColorNote     = { 1.0f, 0.2f, 0.2f, 1.0f };
+        curColorHead     = { 1.0f, 0.2f, 0.2f, 1.0f };
+        curColorHoldBody = { 1.0f, 0.2f, 0.2f, 1.0f };
+        curColorHoldEnd  = { 1.0f, 0.2f, 0.2f, 1.0f };
+        curColorNode     = { 1.0f, 0.2f, 0.2f, 1.0f };
+        curColorArrow    = { 1.0f, 0.2f, 0.2f, 1.0f };
+        alphaMul *= 0.5f;
+    }
+
+    curColorNote.a *= alphaMul;
+    curColorHead.a *= alphaMul;
+    curColorHoldBody.a *= alphaMul;
+    curColorHoldEnd.a *= alphaMul;
+    curColorNode.a *= alphaMul;
+    curColorArrow.a *= alphaMul;
+
+    if ( note.m_type == ::MMM::NoteType::NOTE )
+        NoteRenderSystem::renderTap(
+            batcher,
+            note,
+            config,
+            trackX + (singleTrackW - ctx.noteW) * 0.5f,
+            screenY,
+            ctx.noteW,
+            ctx.noteH,
+            ctx.baseAspect,
+            curColorNote);
+    else if ( note.m_type == ::MMM::NoteType::HOLD )
+        NoteRenderSystem::renderHold(
+            batcher,
+            note,
+            config,
+            snapshot,
+            trackX + (singleTrackW - ctx.noteW) * 0.5f,
+            ctx.noteW,
+            ctx.noteH,
+            singleTrackW,
+            curColorHead,
+            curColorHoldBody,
+            curColorHoldEnd,
+            ctx.cache,
+            ctx.currentAbsY,
+            judgmentLineY,
+            renderScaleY);
+    else if ( note.m_type == ::MMM::NoteType::FLICK )
+        NoteRenderSystem::renderFlick(
+            batcher,
+            note,
+            config,
+            snapshot,
+            trackX + (singleTrackW - ctx.noteW) * 0.5f,
+            screenY,
+            ctx.noteW,
+            ctx.noteH,
+            singleTrackW,
+            curColorHead,
+            curColorHoldBody,
+            curColorArrow);
+    else if ( note.m_type == ::MMM::NoteType::POLYLINE )
+        NoteRenderSystem::renderPolyline(ctx.cache,
+                                         batcher,
+                                         note,
+                                         config,
+                                         snapshot,
+                                         ctx.currentAbsY,
+                                         ctx.currentTime,
+                                         judgmentLineY,
+                                         leftX,
+                                         rightX,
+                                         topY,
+                                         bottomY,
+                                         singleTrackW,
+                                         renderScaleY,
+                                         curColorHead,
+                                         curColorHoldBody,
+                                         curColorHoldEnd,
+                                         curColorNode,
+                                         curColorArrow,
+                                         entity,
+                                         generateHitboxes);
+}
+
+bool NoteRenderSystem::renderRetainedNoteBaseLayer(
+    entt::registry& registry, RenderSnapshot* snapshot,
+    const NoteRenderSystem::NoteRenderContext& ctx,
+    const Config::EditorConfig&                config,
+    const std::vector<entt::entity>& visibleEntities, Batcher& batcher,
+    RetainedNoteGeometryCache& geometry, float judgmentLineY, float leftX,
+    float rightX, float topY, float bottomY, float singleTrackW,
+    float renderScaleY, bool generateHitboxes)
+{
+    const ScrollCache* cache = ctx.cache;
+    const auto**       sortedEntitiesPtr =
+        registry.ctx().find<const TimeIntervalIndex*>();
+    const auto** noteRevisionPtr = registry.ctx().find<const std::uint64_t*>();
+    if ( !cache || !sortedEntitiesPtr || !(*sortedEntitiesPtr) ||
+         !noteRevisionPtr || !(*noteRevisionPtr) ) {
+        return false;
+    }
+
+    // 缩放动画期间每帧比例都不同，逐物件绘制；比例稳定后再整体重建。
+    const double zoomScale = cache->getAnimatedZoomScale();
+    if ( zoomScale != geometry.lastZoomScale ) {
+        geometry.lastZoomScale = zoomScale;
+        return false;
+    }
+
+    const RetainedNoteGeometryKey key{
+        .cache             = cache,
+        .atlasUvRevision   = snapshot->atlasUvRevision,
+        .uvCount           = snapshot->uvMap.size(),
+        .animatedZoomScale = zoomScale,
+        .leftX             = leftX,
+        .singleTrackW      = singleTrackW,
+        .noteW             = ctx.noteW,
+        .noteH             = ctx.noteH,
+        .renderScaleY      = renderScaleY,
+        .colorTap          = ctx.colorTap,
+        .colorHead         = ctx.colorHead,
+        .colorHold         = ctx.colorHold,
+        .colorEnd          = ctx.colorEnd,
+        .colorArrow        = ctx.colorArrow,
+        .noteFillMode      = config.visual.noteFillMode,
+        .enableDraftLanes  = config.settings.enableDraftLanes,
+    };
+    const std::uint64_t noteRevision   = **noteRevisionPtr;
+    const std::uint64_t scrollRevision = cache->getRevision();
+    if ( !(geometry.key == key) ) {
+        geometry.invalidate();
+        geometry.key                 = key;
+        geometry.buildSnapshot.uvMap = snapshot->uvMap;
+    } else {
+        // 音符编辑只失效修改前后起始时间所在的分桶；记录不完整时整体失效。
+        if ( geometry.noteRevision != noteRevision ) {
+            const auto** dirtyTimesPtr =
+                registry.ctx().find<const NoteDirtyTimeLog*>();
+            const auto* dirtyTimes = dirtyTimesPtr ? *dirtyTimesPtr : nullptr;
+            if ( dirtyTimes &&
+                 dirtyTimes->canReplayAfter(geometry.noteRevision) ) {
+                dirtyTimes->forEachAfter(
+                    geometry.noteRevision, [&](double startTime) {
+                        geometry.chunks.erase(retainedNoteChunkId(startTime));
+                    });
+            } else {
+                geometry.chunks.clear();
+            }
+        }
+        // 时间线增量重建只改变起点之后的映射；跨越多个版本时无法得知
+        // 中间各次的起点，整体失效。
+        if ( geometry.scrollRevision != scrollRevision ) {
+            const double fromTime = cache->getLastRebuildFromTime();
+            if ( scrollRevision == geometry.scrollRevision + 1 &&
+                 std::isfinite(fromTime) ) {
+                std::erase_if(geometry.chunks, [&](const auto& entry) {
+                    return entry.second.coverageEndTime >= fromTime;
+                });
+            } else {
+                geometry.chunks.clear();
+            }
+        }
+    }
+    geometry.noteRevision   = noteRevision;
+    geometry.scrollRevision = scrollRevision;
+    ++geometry.tick;
+
+    // 本帧可见的分桶；含拖动、剪切、擦除或折线的分桶逐物件绘制。
+    auto& frameChunks   = geometry.frameChunks;
+    auto& dynamicChunks = geometry.frameDynamicChunks;
+    frameChunks.clear();
+    dynamicChunks.clear();
+    for ( auto entity : visibleEntities ) {
+        const auto& note    = registry.get<const NoteComponent>(entity);
+        const auto  chunkId = retainedNoteChunkId(note.m_timestamp);
+        frameChunks.push_back(chunkId);
+
+        const auto* ic = registry.try_get<const InteractionComponent>(entity);
+        if ( note.m_type == ::MMM::NoteType::POLYLINE ||
+             (ic && (ic->isDragging || ic->isCut)) ||
+             snapshot->erasingEntities.count(entity) ) {
+            dynamicChunks.push_back(chunkId);
+        }
+    }
+    // 拖动中的音符直接改写组件而不更新可见性索引：按索引中的原起始时间
+    // 与当前起始时间各标记一个分桶，其余分桶继续使用缓存几何。拖动结束
+    // 时丢弃途经的分桶，不依赖提交编辑记录的修改前状态。
+    const auto* pinned = registry.ctx().find<DragRenderPinnedEntities>();
+    if ( pinned && pinned->entities && !pinned->entities->empty() ) {
+        const std::size_t firstDragChunk = dynamicChunks.size();
+        for ( const auto entity : *pinned->entities ) {
+            if ( const auto indexedStart =
+                     (*sortedEntitiesPtr)->findStartTime(entity) ) {
+                dynamicChunks.push_back(retainedNoteChunkId(*indexedStart));
+            }
+            if ( const auto* note = registry.try_get<const NoteComponent>(
+                     entity) ) {
+                dynamicChunks.push_back(
+                    retainedNoteChunkId(note->m_timestamp));
+            }
+        }
+        auto& dragChunks = geometry.dragChunks;
+        dragChunks.insert(dragChunks.end(),
+                          dynamicChunks.begin() + firstDragChunk,
+                          dynamicChunks.end());
+        std::sort(dragChunks.begin(), dragChunks.end());
+        dragChunks.erase(std::unique(dragChunks.begin(), dragChunks.end()),
+                         dragChunks.end());
+    } else if ( !geometry.dragChunks.empty() ) {
+        for ( const auto chunkId : geometry.dragChunks ) {
+            geometry.chunks.erase(chunkId);
+        }
+        geometry.dragChunks.clear();
+    }
+    std::sort(frameChunks.begin(), frameChunks.end(), std::greater<>());
+    frameChunks.erase(std::unique(frameChunks.begin(), frameChunks.end()),
+                      frameChunks.end());
+    std::sort(dynamicChunks.begin(), dynamicChunks.end());
+
+    // 以静态外观生成分桶内全部音符，Y 相对分桶原点。
+    auto buildChunk = [&](std::int64_t chunkId, RetainedNoteChunk& chunk) {
+        const auto& sortedEntities = **sortedEntitiesPtr;
+        auto&       members        = geometry.buildMembers;
+        members.clear();
+        chunk.cacheable = true;
+
+        // 分桶边界按 retainedNoteChunkId 判定，前后各放宽一个分桶避免舍入漏项。
+        const double chunkStart =
+            static_cast<double>(chunkId) * RETAINED_NOTE_CHUNK_SECONDS;
+        const double scanEnd = chunkStart + 2.0 * RETAINED_NOTE_CHUNK_SECONDS;
+
+        // 覆盖范围至少为分桶本身，长条延伸到其结束时间。
+        double coverageEnd = chunkStart + RETAINED_NOTE_CHUNK_SECONDS;
+        for ( auto it = sortedEntities.upperBoundStart(
+                  chunkStart - RETAINED_NOTE_CHUNK_SECONDS);
+              it != sortedEntities.end() && it->startTime < scanEnd;
+              ++it ) {
+            if ( !registry.valid(it->entity) ||
+                 !registry.all_of<NoteComponent>(it->entity) ) {
+                continue;
+            }
+            const auto& note = registry.get<const NoteComponent>(it->entity);
+            if ( note.m_isSubNote ||
+                 retainedNoteChunkId(note.m_timestamp) != chunkId ) {
+                continue;
+            }
+            if ( note.m_isDraft && !config.settings.enableDraftLanes ) {
+                continue;
+            }
+            if ( note.m_type == ::MMM::NoteType::POLYLINE ) {
+                chunk.cacheable = false;
+            }
+            coverageEnd = std::max(coverageEnd, it->endTime);
+            members.push_back(it->entity);
+        }
+        chunk.coverageEndTime = coverageEnd;
+
+        // 平移时使用单一 HS，覆盖范围内出现 HS 变化的分桶逐物件绘制。
+        const auto& segments = cache->getSegments();
+        chunk.hs             = cache->getHsAt(chunkStart);
+        for ( auto seg = std::upper_bound(segments.begin(),
+                                          segments.end(),
+                                          chunkStart,
+                                          [](double value,
+                                             const ScrollSegment& segment) {
+                                              return value < segment.time;
+                                          });
+              chunk.cacheable && seg != segments.end() &&
+              seg->time <= coverageEnd;
+              ++seg ) {
+            if ( seg->hs != chunk.hs ) chunk.cacheable = false;
+        }
+
+        chunk.vertices.clear();
+        chunk.indices.clear();
+        chunk.runs.clear();
+        if ( !chunk.cacheable ) return;
+
+        auto& build = geometry.buildSnapshot;
+        build.vertices.clear();
+        build.indices.clear();
+        build.cmds.clear();
+        chunk.originAbsY = cache->getAbsY(chunkStart);
+
+        NoteRenderContext buildCtx = ctx;
+        buildCtx.currentAbsY       = chunk.originAbsY;
+        Batcher builder(&build, &build.cmds);
+        for ( auto it = members.rbegin(); it != members.rend(); ++it ) {
+            NoteRenderSystem::drawBaseNote(registry,
+                                           &build,
+                                           buildCtx,
+                                           config,
+                                           builder,
+                                           *it,
+                                           0.0f,
+                                           leftX,
+                                           rightX,
+                                           topY,
+                                           bottomY,
+                                           singleTrackW,
+                                           renderScaleY,
+                                           false,
+                                           false);
+        }
+        builder.flush();
+
+        for ( const auto& cmd : build.cmds ) {
+            if ( cmd.indexCount == 0 ) continue;
+            chunk.runs.push_back({ static_cast<TextureID>(cmd.customTextureId),
+                                   cmd.indexOffset,
+                                   cmd.indexCount });
+        }
+        // 交换后分桶持有几何，临时快照保留旧容量供下次生成复用。
+        chunk.vertices.swap(build.vertices);
+        chunk.indices.swap(build.indices);
+    };
+
+    for ( const auto chunkId : frameChunks ) {
+        RetainedNoteChunk* chunk = nullptr;
+        if ( !std::binary_search(
+                 dynamicChunks.begin(), dynamicChunks.end(), chunkId) ) {
+            auto [it, inserted] = geometry.chunks.try_emplace(chunkId);
+            if ( inserted ) buildChunk(chunkId, it->second);
+            it->second.lastUsedTick = geometry.tick;
+            if ( it->second.cacheable ) chunk = &it->second;
+        }
+
+        if ( chunk ) {
+            const float offsetY =
+                judgmentLineY -
+                static_cast<float>((chunk->originAbsY - ctx.currentAbsY) *
+                                   chunk->hs) *
+                    renderScaleY;
+            batcher.pushRetainedGeometry(
+                chunk->vertices, chunk->indices, chunk->runs, offsetY);
+            continue;
+        }
+
+        for ( auto it = visibleEntities.rbegin(); it != visibleEntities.rend();
+              ++it ) {
+            const auto& note = registry.get<const NoteComponent>(*it);
+            if ( retainedNoteChunkId(note.m_timestamp) != chunkId ) continue;
+            NoteRenderSystem::drawBaseNote(registry,
+                                           snapshot,
+                                           ctx,
+                                           config,
+                                           batcher,
+                                           *it,
+                                           judgmentLineY,
+                                           leftX,
+                                           rightX,
+                                           topY,
+                                           bottomY,
+                                           singleTrackW,
+                                           renderScaleY,
+                                           generateHitboxes,
+                                           true);
+        }
+    }
+
+    if ( geometry.tick % 64 == 0 ) {
+        std::erase_if(geometry.chunks, [&](const auto& entry) {
+            return geometry.tick - entry.second.lastUsedTick >
+                   RETAINED_NOTE_CHUNK_IDLE_TICKS;
+        });
+    }
+    return true;
+}
 /// @brief 绘制悬浮/选中音符的发光层，并使用轨道框限制可见区域。
 /// @warning
 /// 热路径：悬浮/选中音符每帧绘制；只允许使用已缓存的实体列表和纹理信息。
@@ -1331,68 +1692,18 @@ void NoteRenderSystem::renderOverlapMasks(
 {
     if ( !snapshot || !ctx.cache || noteEntities.size() < 2 ) return;
 
-    struct OverlapItem {
-        ::MMM::NoteType type{ ::MMM::NoteType::NOTE };
-        double          startTime{ 0.0 };
-        double          endTime{ 0.0 };
-        int             track{ 0 };
-        int             dtrack{ 0 };
-        entt::entity    owner{ entt::null };
-        int             subIndex{ -1 };
-    };
-
-    struct OverlapPoint {
-        double       time{ 0.0 };
-        int          track{ 0 };
-        entt::entity owner{ entt::null };
-        float        scale{ 1.0f };
-        bool         testsFlickBody{ false };
-    };
-
-    auto makeEndTime =
-        [](double startTime, double duration, ::MMM::NoteType type) {
-            if ( type != ::MMM::NoteType::HOLD ) return startTime;
-            return startTime + std::max(0.0, duration);
-        };
-
     std::vector<OverlapItem> items;
     items.reserve(noteEntities.size());
     for ( auto entity : noteEntities ) {
-        const auto& note = registry.get<const NoteComponent>(entity);
-        if ( note.m_isSubNote ) continue;
-
-        if ( note.m_type == ::MMM::NoteType::POLYLINE ) {
-            for ( size_t i = 0; i < note.m_subNotes.size(); ++i ) {
-                const auto& sub = note.m_subNotes[i];
-                items.push_back(
-                    { sub.type,
-                      sub.timestamp,
-                      makeEndTime(sub.timestamp, sub.duration, sub.type),
-                      sub.trackIndex,
-                      sub.dtrack,
-                      entity,
-                      static_cast<int>(i) });
-            }
-            continue;
-        }
-
-        items.push_back(
-            { note.m_type,
-              note.m_timestamp,
-              makeEndTime(note.m_timestamp, note.m_duration, note.m_type),
-              note.m_trackIndex,
-              note.m_dtrack,
-              entity,
-              -1 });
+        appendOverlapItems(
+            registry.get<const NoteComponent>(entity), entity, items);
     }
-
-    if ( items.empty() ) return;
+    if ( items.size() < 2 ) return;
 
     const double windowSeconds =
         static_cast<double>(
             std::max(0.0f, config.settings.overlapTimeWindowMs)) *
         0.001;
-    constexpr double timeEpsilon = 1e-7;
 
     auto textureSize = [snapshot](TextureID id, float baseW, float baseH) {
         auto itBase =
@@ -1417,22 +1728,6 @@ void NoteRenderSystem::renderOverlapMasks(
                                    renderScaleY;
     };
 
-    auto sameOwner = [](const OverlapItem& a, const OverlapItem& b) {
-        return a.owner != entt::null && a.owner == b.owner;
-    };
-
-    auto countUniqueOwners = [](const std::vector<const OverlapItem*>& group,
-                                size_t                                 begin,
-                                size_t                                 end) {
-        std::unordered_set<entt::entity> owners;
-        owners.reserve(end - begin);
-        for ( size_t i = begin; i < end; ++i ) {
-            const auto* item = group[i];
-            owners.insert(item->owner);
-        }
-        return static_cast<int>(owners.size());
-    };
-
     auto appendMask = [&](float x, float y, float w, float h, int count) {
         if ( w <= 0.0f || h <= 0.0f || count < 2 ) return;
         if ( x > rightX || x + w < clipLeftX || y > bottomY || y + h < topY )
@@ -1443,385 +1738,72 @@ void NoteRenderSystem::renderOverlapMasks(
         snapshot->overlapMasks.push_back({ x, y, w, h, count });
     };
 
-    auto appendPointMask = [&](double time, int track, float scale, int count) {
-        float w = ctx.noteW * scale;
-        float h = ctx.noteH * scale;
-        float x = leftX + static_cast<float>(track) * singleTrackW +
-                  (singleTrackW - w) * 0.5f;
-        float y = timeToY(time) - h * 0.5f;
-        appendMask(x, y, w, h, count);
-    };
-
-    std::vector<const OverlapItem*> notes;
-    std::vector<const OverlapItem*> holds;
-    std::vector<const OverlapItem*> flicks;
-    std::vector<OverlapPoint>       pointMarkers;
-    bool                            hasBucketTrack = false;
-    int                             minBucketTrack = 0;
-    int                             maxBucketTrack = 0;
-    notes.reserve(items.size());
-    holds.reserve(items.size());
-    flicks.reserve(items.size());
-    pointMarkers.reserve(items.size() * 2);
-
-    auto includeBucketTrack = [&](int track) {
-        if ( !hasBucketTrack ) {
-            minBucketTrack = track;
-            maxBucketTrack = track;
-            hasBucketTrack = true;
-            return;
-        }
-
-        minBucketTrack = std::min(minBucketTrack, track);
-        maxBucketTrack = std::max(maxBucketTrack, track);
-    };
-
-    for ( const auto& item : items ) {
-        if ( item.type == ::MMM::NoteType::NOTE ) {
-            notes.push_back(&item);
-            pointMarkers.push_back(
-                { item.startTime, item.track, item.owner, 1.0f, true });
-            includeBucketTrack(item.track);
-        } else if ( item.type == ::MMM::NoteType::HOLD ) {
-            if ( item.endTime > item.startTime + timeEpsilon ) {
-                holds.push_back(&item);
-                pointMarkers.push_back(
-                    { item.endTime, item.track, item.owner, 1.0f, true });
-            }
-            pointMarkers.push_back(
-                { item.startTime, item.track, item.owner, 1.0f, true });
-            includeBucketTrack(item.track);
-        } else if ( item.type == ::MMM::NoteType::FLICK ) {
-            flicks.push_back(&item);
-            pointMarkers.push_back(
-                { item.startTime, item.track, item.owner, 1.0f, false });
-            pointMarkers.push_back({ item.startTime,
-                                     item.track + item.dtrack,
-                                     item.owner,
-                                     1.0f,
-                                     true });
-            includeBucketTrack(item.track);
-            includeBucketTrack(item.track + item.dtrack);
-        }
-    }
-
-    if ( !hasBucketTrack ) return;
-
-    auto bucketIndex = [&](int track) {
-        return static_cast<size_t>(track - minBucketTrack);
-    };
-
-    size_t bucketCount =
-        static_cast<size_t>(maxBucketTrack - minBucketTrack + 1);
-    std::vector<std::vector<const OverlapItem*>> notesByTrack(bucketCount);
-    std::vector<std::vector<const OverlapItem*>> holdsByTrack(bucketCount);
-    std::vector<std::vector<OverlapPoint>> pointMarkersByTrack(bucketCount);
-
-    for ( const auto* note : notes ) {
-        notesByTrack[bucketIndex(note->track)].push_back(note);
-    }
-    for ( const auto* hold : holds ) {
-        holdsByTrack[bucketIndex(hold->track)].push_back(hold);
-    }
-    for ( const auto& point : pointMarkers ) {
-        pointMarkersByTrack[bucketIndex(point.track)].push_back(point);
-    }
-
-    auto itemStartLess = [](const OverlapItem* a, const OverlapItem* b) {
-        if ( a->startTime != b->startTime ) {
-            return a->startTime < b->startTime;
-        }
-        return a->endTime < b->endTime;
-    };
-    auto ensureItemTimeOrder = [&](std::vector<const OverlapItem*>& bucket) {
-        if ( bucket.size() < 2 ) return;
-        if ( std::is_sorted(bucket.begin(), bucket.end(), itemStartLess) )
-            return;
-        std::sort(bucket.begin(), bucket.end(), itemStartLess);
-    };
-    auto ensurePointTimeOrder = [](std::vector<OverlapPoint>& bucket) {
-        if ( bucket.size() < 2 ) return;
-        auto pointTimeLess = [](const OverlapPoint& a, const OverlapPoint& b) {
-            return a.time < b.time;
-        };
-        if ( std::is_sorted(bucket.begin(), bucket.end(), pointTimeLess) )
-            return;
-        std::sort(bucket.begin(), bucket.end(), pointTimeLess);
-    };
-
-    for ( auto& trackNotes : notesByTrack ) {
-        if ( trackNotes.size() < 2 ) continue;
-        ensureItemTimeOrder(trackNotes);
-
-        for ( size_t i = 0; i < trackNotes.size(); ) {
-            size_t j = i + 1;
-            while ( j < trackNotes.size() &&
-                    trackNotes[j]->startTime - trackNotes[j - 1]->startTime <
-                        windowSeconds ) {
-                ++j;
-            }
-
-            if ( j - i >= 2 ) {
-                double minTime = trackNotes[i]->startTime;
-                double maxTime = trackNotes[i]->startTime;
-                for ( size_t k = i; k < j; ++k ) {
-                    minTime = std::min(minTime, trackNotes[k]->startTime);
-                    maxTime = std::max(maxTime, trackNotes[k]->startTime);
-                }
-
-                int uniqueCount = countUniqueOwners(trackNotes, i, j);
-                if ( uniqueCount >= 2 ) {
-                    float y0 = timeToY(minTime);
-                    float y1 = timeToY(maxTime);
-                    float x  = leftX + trackNotes[i]->track * singleTrackW +
-                               (singleTrackW - ctx.noteW) * 0.5f;
-                    float y  = std::min(y0, y1) - ctx.noteH * 0.5f;
-                    float h  = std::abs(y0 - y1) + ctx.noteH;
-                    appendMask(x, y, ctx.noteW, h, uniqueCount);
-                }
-            }
-
-            i = j;
-        }
-    }
-
-    for ( auto& trackPoints : pointMarkersByTrack ) {
-        if ( trackPoints.size() < 2 ) continue;
-        ensurePointTimeOrder(trackPoints);
-
-        for ( size_t i = 0; i < trackPoints.size(); ) {
-            size_t j = i + 1;
-            while ( j < trackPoints.size() &&
-                    trackPoints[j].time - trackPoints[j - 1].time <=
-                        windowSeconds + timeEpsilon ) {
-                ++j;
-            }
-
-            if ( j - i >= 2 ) {
-                std::unordered_set<entt::entity> owners;
-                double                           minTime = trackPoints[i].time;
-                double                           maxTime = trackPoints[i].time;
-                float maxScale                           = trackPoints[i].scale;
-                for ( size_t k = i; k < j; ++k ) {
-                    owners.insert(trackPoints[k].owner);
-                    minTime  = std::min(minTime, trackPoints[k].time);
-                    maxTime  = std::max(maxTime, trackPoints[k].time);
-                    maxScale = std::max(maxScale, trackPoints[k].scale);
-                }
-
-                if ( owners.size() >= 2 ) {
-                    float w  = ctx.noteW * maxScale;
-                    float h0 = ctx.noteH * maxScale;
-                    float y0 = timeToY(minTime);
-                    float y1 = timeToY(maxTime);
-                    float x  = leftX + trackPoints[i].track * singleTrackW +
-                               (singleTrackW - w) * 0.5f;
-                    float y  = std::min(y0, y1) - h0 * 0.5f;
-                    float h  = std::abs(y0 - y1) + h0;
-                    appendMask(x, y, w, h, static_cast<int>(owners.size()));
-                }
-            }
-
-            i = j;
-        }
-    }
-
-    for ( auto& trackHolds : holdsByTrack ) {
-        if ( trackHolds.size() < 2 ) continue;
-        ensureItemTimeOrder(trackHolds);
-
-        int                 track = trackHolds.front()->track;
-        std::vector<double> bounds;
-        bounds.reserve(trackHolds.size() * 2);
-
-        for ( const auto* hold : trackHolds ) {
-            bounds.push_back(hold->startTime);
-            bounds.push_back(hold->endTime);
+    auto appendRegionMask = [&](const OverlapRegion& region) {
+        const float y0 = timeToY(region.timeBegin);
+        const float y1 = timeToY(region.timeEnd);
+        const float trackX =
+            leftX + static_cast<float>(region.trackBegin) * singleTrackW;
+        switch ( region.shape ) {
+        case OverlapRegionShape::Point: {
+            // 点簇覆盖首尾两个判定点，上下各外扩半个物件高度。
+            const float w = ctx.noteW * region.scale;
+            const float h = ctx.noteH * region.scale;
+            appendMask(trackX + (singleTrackW - w) * 0.5f,
+                       std::min(y0, y1) - h * 0.5f,
+                       w,
+                       std::abs(y0 - y1) + h,
+                       region.objectCount);
+            break;
         }
-        std::sort(bounds.begin(), bounds.end());
-        bounds.erase(std::unique(bounds.begin(),
-                                 bounds.end(),
-                                 [](double a, double b) {
-                                     return std::abs(a - b) < 1e-7;
-                                 }),
-                     bounds.end());
-
-        bool   hasOpenMask = false;
-        double openStart   = 0.0;
-        double openEnd     = 0.0;
-        int    openCount   = 0;
-
-        auto flushOpenMask = [&]() {
-            if ( !hasOpenMask ) return;
-            float y0 = timeToY(openStart);
-            float y1 = timeToY(openEnd);
-            float x  = leftX + track * singleTrackW +
-                       (singleTrackW - verticalBodySize.x) * 0.5f;
-            appendMask(x,
+        case OverlapRegionShape::HoldBody:
+            appendMask(trackX + (singleTrackW - verticalBodySize.x) * 0.5f,
                        std::min(y0, y1),
                        verticalBodySize.x,
                        std::abs(y0 - y1),
-                       openCount);
-            hasOpenMask = false;
-            openCount   = 0;
-        };
-
-        for ( size_t k = 0; k + 1 < bounds.size(); ++k ) {
-            double segStart = bounds[k];
-            double segEnd   = bounds[k + 1];
-            if ( segEnd <= segStart + timeEpsilon ) continue;
-
-            std::unordered_set<entt::entity> activeOwners;
-            for ( const auto* hold : trackHolds ) {
-                if ( hold->startTime >= segEnd - timeEpsilon ) break;
-                if ( hold->endTime > segStart + timeEpsilon ) {
-                    activeOwners.insert(hold->owner);
-                }
-            }
-
-            int activeCount = static_cast<int>(activeOwners.size());
-            if ( activeCount >= 2 ) {
-                if ( !hasOpenMask ) {
-                    hasOpenMask = true;
-                    openStart   = segStart;
-                    openEnd     = segEnd;
-                    openCount   = activeCount;
-                } else {
-                    openEnd   = segEnd;
-                    openCount = std::max(openCount, activeCount);
-                }
-            } else {
-                flushOpenMask();
-            }
-        }
-        flushOpenMask();
-    }
-
-    ensureItemTimeOrder(flicks);
-
-    auto flickBodyMinTrack = [](const OverlapItem& item) {
-        return std::min(item.track, item.track + item.dtrack);
-    };
-    auto flickBodyMaxTrack = [](const OverlapItem& item) {
-        return std::max(item.track, item.track + item.dtrack);
-    };
-
-    for ( size_t i = 0; i < flicks.size(); ++i ) {
-        const auto& a = *flicks[i];
-        if ( a.dtrack == 0 ) continue;
-
-        for ( size_t j = i + 1; j < flicks.size(); ++j ) {
-            const auto& b = *flicks[j];
-            if ( b.startTime - a.startTime > windowSeconds + timeEpsilon )
-                break;
-            if ( b.dtrack == 0 || sameOwner(a, b) ) continue;
-
-            int overlapMin =
-                std::max(flickBodyMinTrack(a), flickBodyMinTrack(b));
-            int overlapMax =
-                std::min(flickBodyMaxTrack(a), flickBodyMaxTrack(b));
-            if ( overlapMax <= overlapMin ) continue;
-
-            float y0 = timeToY(a.startTime);
-            float y1 = timeToY(b.startTime);
-            float x  = leftX + static_cast<float>(overlapMin) * singleTrackW +
-                       singleTrackW * 0.5f;
-            float w =
-                static_cast<float>(overlapMax - overlapMin) * singleTrackW;
-            float y = std::min(y0, y1) - horizontalBodySize.y * 0.5f;
-            float h = std::abs(y0 - y1) + horizontalBodySize.y;
-            appendMask(x, y, w, h, 2);
-        }
-    }
-
-    const std::vector<const OverlapItem*> emptyHoldBucket;
-    auto                                  getHoldBucket =
-        [&](int track) -> const std::vector<const OverlapItem*>& {
-        if ( track < minBucketTrack || track > maxBucketTrack ) {
-            return emptyHoldBucket;
+                       region.objectCount);
+            break;
+        case OverlapRegionShape::FlickBody:
+            appendMask(
+                trackX + singleTrackW * 0.5f,
+                std::min(y0, y1) - horizontalBodySize.y * 0.5f,
+                static_cast<float>(region.trackEnd - region.trackBegin) *
+                    singleTrackW,
+                std::abs(y0 - y1) + horizontalBodySize.y,
+                region.objectCount);
+            break;
         }
-        return holdsByTrack[bucketIndex(track)];
     };
 
-    for ( const auto& point : pointMarkers ) {
-        std::unordered_set<entt::entity> owners;
-        owners.insert(point.owner);
-
-        for ( const auto* hold : getHoldBucket(point.track) ) {
-            if ( point.time <= hold->startTime + timeEpsilon ) break;
-            if ( hold->owner == point.owner ) continue;
-            if ( point.time < hold->endTime - timeEpsilon ) {
-                owners.insert(hold->owner);
-            }
-        }
-
-        if ( owners.size() >= 2 ) {
-            appendPointMask(point.time,
-                            point.track,
-                            point.scale,
-                            static_cast<int>(owners.size()));
+    // 后台结果与当前音符修订号、时间窗口一致且没有拖动时直接按时间范围
+    // 查询；否则对可见物件同步运行同一检测引擎，保证拖动预览实时更新。
+    const OverlapReport* report = nullptr;
+    if ( const auto* reportView = registry.ctx().find<OverlapReportView>();
+         reportView && reportView->report ) {
+        const auto** revisionPtr = registry.ctx().find<const std::uint64_t*>();
+        const auto*  pinned = registry.ctx().find<DragRenderPinnedEntities>();
+        const bool   isDragging =
+            pinned && pinned->entities && !pinned->entities->empty();
+        if ( revisionPtr && *revisionPtr && !isDragging &&
+             reportView->report->revision == **revisionPtr &&
+             reportView->report->windowSeconds == windowSeconds ) {
+            report = reportView->report;
         }
     }
 
-    for ( const auto& point : pointMarkers ) {
-        if ( !point.testsFlickBody ) continue;
-
-        std::unordered_set<entt::entity> owners;
-        owners.insert(point.owner);
-
-        auto firstFlick =
-            std::lower_bound(flicks.begin(),
-                             flicks.end(),
-                             point.time - windowSeconds - timeEpsilon,
-                             [](const OverlapItem* item, double time) {
-                                 return item->startTime < time;
-                             });
-
-        for ( auto it = firstFlick; it != flicks.end(); ++it ) {
-            const auto* flick = *it;
-            if ( flick->startTime > point.time + windowSeconds + timeEpsilon )
-                break;
-            if ( flick->owner == point.owner || flick->dtrack == 0 ) continue;
-
-            int minTrack = flickBodyMinTrack(*flick);
-            int maxTrack = flickBodyMaxTrack(*flick);
-            if ( point.track < minTrack || point.track > maxTrack ) continue;
-
-            owners.insert(flick->owner);
+    if ( report ) {
+        double visibleBegin = std::numeric_limits<double>::max();
+        double visibleEnd   = std::numeric_limits<double>::lowest();
+        for ( const auto& item : items ) {
+            visibleBegin = std::min(visibleBegin, item.startTime);
+            visibleEnd   = std::max(visibleEnd, item.endTime);
         }
-
-        if ( owners.size() >= 2 ) {
-            appendPointMask(point.time,
-                            point.track,
-                            point.scale,
-                            static_cast<int>(owners.size()));
-        }
-    }
-
-    for ( const auto* flick : flicks ) {
-        if ( flick->dtrack == 0 ) continue;
-
-        std::unordered_map<int, std::unordered_set<entt::entity>> ownersByTrack;
-        int bodyMinTrack    = flickBodyMinTrack(*flick);
-        int bodyMaxTrack    = flickBodyMaxTrack(*flick);
-        int checkedMinTrack = std::max(bodyMinTrack, minBucketTrack);
-        int checkedMaxTrack = std::min(bodyMaxTrack, maxBucketTrack);
-
-        for ( int track = checkedMinTrack; track <= checkedMaxTrack; ++track ) {
-            for ( const auto* hold : getHoldBucket(track) ) {
-                if ( flick->startTime <= hold->startTime + timeEpsilon ) break;
-                if ( sameOwner(*flick, *hold) ) continue;
-                if ( flick->startTime >= hold->endTime - timeEpsilon ) continue;
-
-                auto& owners = ownersByTrack[hold->track];
-                owners.insert(flick->owner);
-                owners.insert(hold->owner);
-            }
-        }
-
-        for ( const auto& [track, owners] : ownersByTrack ) {
-            appendPointMask(
-                flick->startTime, track, 0.7f, static_cast<int>(owners.size()));
+        report->forEachRegionInRange(
+            visibleBegin - windowSeconds, visibleEnd + windowSeconds,
+            appendRegionMask);
+    } else if ( auto liveReport =
+                    detectOverlaps(std::move(items), windowSeconds, 0) ) {
+        for ( const auto& region : liveReport->regions ) {
+            appendRegionMask(region);
         }
     }
 
@@ -58,24 +58,21 @@ std::pair<double, double> sampleTimeRange(const SampleComponent& sample)
     return std::minmax(sample.m_timestamp, sample.effectiveTime());
 }
 
-/// @brief 从排序索引收集当前可见时间范围内的自动采样候选。
+/// @brief 从时间区间索引收集当前可见时间范围内的自动采样候选。
 /// @param registry 自动采样注册表。
-/// @param sortedEntities 已按区间起点排序的实体。
-/// @param maxEndPrefix 区间终点前缀最大值。
+/// @param sampleIndex 按区间起点排序的自动采样索引。
 /// @param visibleRanges 当前滚动窗口映射出的可见时间范围。
 /// @param result 输出实体列表。
 /// @param seen 输出去重集合。
-/// @warning 主画布热路径：只遍历索引命中的候选区间。
+/// @warning 主画布热路径：只遍历索引命中的候选分块。
 void collectVisibleSamples(
-    entt::registry& registry, const std::vector<entt::entity>& sortedEntities,
-    const std::vector<double>&                 maxEndPrefix,
+    entt::registry& registry, const TimeIntervalIndex& sampleIndex,
     std::span<const std::pair<double, double>> visibleRanges,
     std::vector<entt::entity>& result, std::unordered_set<entt::entity>& seen)
 {
     result.clear();
     seen.clear();
-    if ( sortedEntities.empty() ||
-         maxEndPrefix.size() != sortedEntities.size() ) {
+    if ( sampleIndex.empty() ) {
         return;
     }
 
@@ -84,39 +81,23 @@ void collectVisibleSamples(
             std::min(rawRange.first, rawRange.second) - 0.25;
         const double rangeEnd =
             std::max(rawRange.first, rawRange.second) + 0.25;
-        const auto high = std::upper_bound(
-            sortedEntities.begin(),
-            sortedEntities.end(),
+        sampleIndex.queryVisible(
+            rangeStart,
             rangeEnd,
-            [&registry](double value, entt::entity entity) {
-                if ( !registry.valid(entity) ||
-                     !registry.all_of<SampleComponent>(entity) ) {
-                    return false;
+            [&](const TimeIntervalIndex::Entry& entry) {
+                if ( !registry.valid(entry.entity) ||
+                     !registry.all_of<SampleComponent>(entry.entity) ) {
+                    return;
                 }
                 const auto range = sampleTimeRange(
-                    registry.get<const SampleComponent>(entity));
-                return value < range.first;
+                    registry.get<const SampleComponent>(entry.entity));
+                if ( range.second < rangeStart || range.first > rangeEnd ) {
+                    return;
+                }
+                if ( seen.insert(entry.entity).second ) {
+                    result.push_back(entry.entity);
+                }
             });
-        const auto highIndex =
-            static_cast<std::size_t>(high - sortedEntities.begin());
-        const auto low = std::lower_bound(
-            maxEndPrefix.begin(), maxEndPrefix.begin() + highIndex, rangeStart);
-        const auto lowIndex =
-            static_cast<std::size_t>(low - maxEndPrefix.begin());
-
-        for ( std::size_t index = lowIndex; index < highIndex; ++index ) {
-            const auto entity = sortedEntities[index];
-            if ( !registry.valid(entity) ||
-                 !registry.all_of<SampleComponent>(entity) ) {
-                continue;
-            }
-            const auto range =
-                sampleTimeRange(registry.get<const SampleComponent>(entity));
-            if ( range.second < rangeStart || range.first > rangeEnd ) continue;
-            if ( seen.insert(entity).second ) {
-                result.push_back(entity);
-            }
-        }
     }
 }
 
@@ -227,8 +208,8 @@ void SampleRenderSystem::renderLaneLayout(
 }
 
 void SampleRenderSystem::renderSamples(
-    entt::registry& registry, const std::vector<entt::entity>& sortedEntities,
-    const std::vector<double>& maxEndPrefix, RenderSnapshot* snapshot,
+    entt::registry& registry, const TimeIntervalIndex& sampleIndex,
+    RenderSnapshot* snapshot,
     Batcher& batcher, const CanvasLaneProjection& projection,
     const ScrollCache* cache, const Config::EditorConfig& config,
     double currentTime, float judgmentLineY, float viewportWidth, float topY,
@@ -253,8 +234,7 @@ void SampleRenderSystem::renderSamples(
     snapshot->sampleQuerySeenScratch.clear();
     if ( visibleLaneRange ) {
         collectVisibleSamples(registry,
-                              sortedEntities,
-                              maxEndPrefix,
+                              sampleIndex,
                               visibleTimeRanges,
                               snapshot->sampleQueryScratch,
                               snapshot->sampleQuerySeenScratch);
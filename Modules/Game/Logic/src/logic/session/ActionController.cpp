@@ -5,6 +5,7 @@
 #include "logic/ecs/components/InteractionComponent.h"
 #include "logic/ecs/components/NoteComponent.h"
 #include "logic/ecs/components/TransformComponent.h"
+#include "logic/session/EditorActionCodec.h"
 #include "logic/session/NoteAction.h"
 #include "logic/session/NoteIdentity.h"
 #include "logic/session/SelectionState.h"
@@ -69,6 +70,7 @@ bool applySingleNoteCacheMutation(SessionContext& ctx, entt::entity entity,
 /// @brief 标记一次 Note 动作实际涉及的正式谱面与项目草稿数据域。
 /// @return 动作是否涉及正式谱面物件。
 bool markNoteStorageDirty(SessionContext&                     ctx,
+                          entt::entity                        entity,
                           const std::optional<NoteComponent>& before,
                           const std::optional<NoteComponent>& after)
 {
@@ -77,7 +79,10 @@ bool markNoteStorageDirty(SessionContext&                     ctx,
     const bool touchesFormal =
         (before && !before->m_isDraft) || (after && !after->m_isDraft);
     ctx.m_needsDraftNotesSync = ctx.m_needsDraftNotesSync || touchesDraft;
-    ctx.m_needsNotesSync      = ctx.m_needsNotesSync || touchesFormal;
+    SessionUtils::markNoteWriteBackDirty(ctx,
+                                         entity,
+                                         before ? &*before : nullptr,
+                                         after ? &*after : nullptr);
     return touchesFormal;
 }
 
@@ -88,12 +93,25 @@ bool markBatchNoteStorageDirty(
 {
     bool touchesFormal = false;
     for ( const auto& entry : entries ) {
-        touchesFormal = markNoteStorageDirty(ctx, entry.before, entry.after) ||
+        touchesFormal = markNoteStorageDirty(
+                            ctx, entry.entity, entry.before, entry.after) ||
                         touchesFormal;
     }
     return touchesFormal;
 }
 
+/// @brief 按批量动作涉及的实体增量刷新打击事件。
+void refreshBatchHitEvents(SessionContext&                            ctx,
+                           const std::vector<BatchNoteAction::Entry>& entries)
+{
+    std::vector<entt::entity> entities;
+    entities.reserve(entries.size());
+    for ( const auto& entry : entries ) {
+        entities.push_back(entry.entity);
+    }
+    SessionUtils::refreshHitEvents(ctx, entities);
+}
+
 /// @brief 判断两个可选音符颜色是否相同。
 bool sameOptionalNoteColor(const std::optional<glm::vec4>& lhs,
                            const std::optional<glm::vec4>& rhs)
@@ -359,6 +377,19 @@ std::string TimelineAction::getName() const
     return typeStr;
 }
 
+std::size_t TimelineAction::memoryUsage() const
+{
+    std::size_t bytes = sizeof(TimelineAction);
+    // 组件本体已计入 sizeof，这里只累加堆上部分。
+    if ( m_before ) {
+        bytes += EditorActionCodec::estimateBytes(*m_before) - sizeof(*m_before);
+    }
+    if ( m_after ) {
+        bytes += EditorActionCodec::estimateBytes(*m_after) - sizeof(*m_after);
+    }
+    return bytes;
+}
+
 // --- BatchTimelineAction 实现 ---
 
 void BatchTimelineAction::execute(SessionContext& ctx)
@@ -424,6 +455,24 @@ std::string BatchTimelineAction::getName() const
                        TR("ui.status.info.entries"));
 }
 
+std::size_t BatchTimelineAction::memoryUsage() const
+{
+    std::size_t bytes = sizeof(BatchTimelineAction) + m_name.capacity() +
+                        m_entries.capacity() * sizeof(Entry);
+    for ( const auto& entry : m_entries ) {
+        // 组件本体已计入 sizeof(Entry)，这里只累加堆上部分。
+        if ( entry.before ) {
+            bytes += EditorActionCodec::estimateBytes(*entry.before) -
+                     sizeof(*entry.before);
+        }
+        if ( entry.after ) {
+            bytes += EditorActionCodec::estimateBytes(*entry.after) -
+                     sizeof(*entry.after);
+        }
+    }
+    return bytes;
+}
+
 // --- NoteAction 实现 ---
 
 void NoteAction::execute(SessionContext& ctx)
@@ -442,7 +491,8 @@ void NoteAction::execute(SessionContext& ctx)
         cacheAfter = reg.get<NoteComponent>(m_entity);
         if ( !hadPendingNoteSync ) {
             beatmapUpdatedIncrementally =
-                SessionUtils::syncCreatedNoteToBeatmap(ctx, *cacheAfter);
+                SessionUtils::syncCreatedNoteToBeatmap(
+                    ctx, m_entity, *cacheAfter);
         }
         XINFO("[Action] Create Note: Type={}, Time={:.3f}, Track={}",
               (int)m_after->m_type,
@@ -483,14 +533,17 @@ void NoteAction::execute(SessionContext& ctx)
             cacheAfter = reg.get<NoteComponent>(m_entity);
         }
     }
-    const bool formalMutation = markNoteStorageDirty(ctx, m_before, m_after);
+    const bool formalMutation = markNoteStorageDirty(ctx, m_entity, m_before, m_after);
     if ( formalMutation && beatmapUpdatedIncrementally ) {
+        // 创建前没有待回写的物件，新记录已直接追加，无需再逐实体修补。
         ctx.m_needsNotesSync = false;
+        ctx.noteWriteBack.dirtyEntities.clear();
     }
     const bool cacheUpdated =
         applySingleNoteCacheMutation(ctx, m_entity, cacheBefore, cacheAfter);
     if ( formalMutation && !cacheUpdated ) {
-        SessionUtils::markHitEventsDirty(ctx);
+        SessionUtils::refreshHitEvents(
+            ctx, std::span<const entt::entity>(&m_entity, 1U));
     }
     if ( cacheUpdated ) {
         return;
@@ -535,11 +588,12 @@ void NoteAction::undo(SessionContext& ctx)
             cacheAfter = reg.get<NoteComponent>(m_entity);
         }
     }
-    const bool formalMutation = markNoteStorageDirty(ctx, m_before, m_after);
+    const bool formalMutation = markNoteStorageDirty(ctx, m_entity, m_before, m_after);
     const bool cacheUpdated =
         applySingleNoteCacheMutation(ctx, m_entity, cacheBefore, cacheAfter);
     if ( formalMutation && !cacheUpdated ) {
-        SessionUtils::markHitEventsDirty(ctx);
+        SessionUtils::refreshHitEvents(
+            ctx, std::span<const entt::entity>(&m_entity, 1U));
     }
     if ( cacheUpdated ) return;
     if ( m_type == Type::Create ) {
@@ -567,11 +621,12 @@ void NoteAction::redo(SessionContext& ctx)
         });
         cacheAfter = reg.get<NoteComponent>(m_entity);
     }
-    const bool formalMutation = markNoteStorageDirty(ctx, m_before, m_after);
+    const bool formalMutation = markNoteStorageDirty(ctx, m_entity, m_before, m_after);
     const bool cacheUpdated =
         applySingleNoteCacheMutation(ctx, m_entity, cacheBefore, cacheAfter);
     if ( formalMutation && !cacheUpdated ) {
-        SessionUtils::markHitEventsDirty(ctx);
+        SessionUtils::refreshHitEvents(
+            ctx, std::span<const entt::entity>(&m_entity, 1U));
     }
     if ( !cacheUpdated ) markNoteOrderDirty(ctx);
 }
@@ -607,6 +662,19 @@ std::string NoteAction::getName() const
     return typeStr;
 }
 
+std::size_t NoteAction::memoryUsage() const
+{
+    std::size_t bytes = sizeof(NoteAction);
+    // 组件本体已计入 sizeof，这里只累加堆上部分。
+    if ( m_before ) {
+        bytes += EditorActionCodec::estimateBytes(*m_before) - sizeof(*m_before);
+    }
+    if ( m_after ) {
+        bytes += EditorActionCodec::estimateBytes(*m_after) - sizeof(*m_after);
+    }
+    return bytes;
+}
+
 // --- BatchNoteAction 实现 ---
 
 void BatchNoteAction::execute(SessionContext& ctx)
@@ -640,7 +708,7 @@ void BatchNoteAction::execute(SessionContext& ctx)
         }
     }
     if ( markBatchNoteStorageDirty(ctx, m_entries) ) {
-        SessionUtils::markHitEventsDirty(ctx);
+        refreshBatchHitEvents(ctx, m_entries);
     }
     bool needsOrderRebuild = false;
     bool needsPrune        = false;
@@ -705,7 +773,7 @@ void BatchNoteAction::undo(SessionContext& ctx)
         }
     }
     if ( markBatchNoteStorageDirty(ctx, m_entries) ) {
-        SessionUtils::markHitEventsDirty(ctx);
+        refreshBatchHitEvents(ctx, m_entries);
     }
     bool needsOrderRebuild = false;
     bool needsPrune        = false;
@@ -769,7 +837,7 @@ void BatchNoteAction::redo(SessionContext& ctx)
         }
     }
     if ( markBatchNoteStorageDirty(ctx, m_entries) ) {
-        SessionUtils::markHitEventsDirty(ctx);
+        refreshBatchHitEvents(ctx, m_entries);
     }
     markNoteOrderDirty(ctx);
 }
@@ -792,4 +860,22 @@ std::string BatchNoteAction::getName() const
                        TR("ui.status.info.entries"));
 }
 
+std::size_t BatchNoteAction::memoryUsage() const
+{
+    std::size_t bytes = sizeof(BatchNoteAction) + m_name.capacity() +
+                        m_entries.capacity() * sizeof(Entry);
+    for ( const auto& entry : m_entries ) {
+        // 组件本体已计入 sizeof(Entry)，这里只累加堆上部分。
+        if ( entry.before ) {
+            bytes += EditorActionCodec::estimateBytes(*entry.before) -
+                     sizeof(*entry.before);
+        }
+        if ( entry.after ) {
+            bytes += EditorActionCodec::estimateBytes(*entry.after) -
+                     sizeof(*entry.after);
+        }
+    }
+    return bytes;
+}
+
 }  // namespace MMM::Logic
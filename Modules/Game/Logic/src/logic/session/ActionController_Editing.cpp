@@ -322,8 +322,7 @@ void ensureReplacementNoteAuxiliaryComponents(entt::registry& registry,
 /// @param ctx 当前会话上下文。
 void markReplacementNoteOrderDirty(SessionContext& ctx)
 {
-    ctx.sortedNoteEntities.clear();
-    ctx.sortedNoteMaxEndPrefix.clear();
+    ctx.noteVisibilityIndex.clear();
     ctx.previewDensityObjectTimes.clear();
     ctx.isNoteOrderDirty             = true;
     ctx.isNotePruneDirty             = false;
@@ -953,7 +952,7 @@ void replaceNoteComponents(SessionContext&                   ctx,
         ctx.eraserState.isActive = false;
         ctx.eraserState.targetEntities.clear();
     }
-    ctx.m_needsNotesSync = true;
+    SessionUtils::markNotesFullSync(ctx);
     SessionUtils::markHitEventsDirty(ctx);
     markReplacementNoteOrderDirty(ctx);
 }
@@ -1123,7 +1122,7 @@ void applyIncrementalNoteComponents(
     }
     if ( !ctx.marqueeBoxes.empty() ) ctx.isMarqueeSelectionDirty = true;
 
-    ctx.m_needsNotesSync = true;
+    SessionUtils::markNotesFullSync(ctx);
     std::vector<SessionUtils::NoteCacheMutationView> cacheMutationViews;
     cacheMutationViews.reserve(cacheMutations.size());
     for ( const auto& mutation : cacheMutations ) {
@@ -1135,7 +1134,12 @@ void applyIncrementalNoteComponents(
     }
     if ( !SessionUtils::applyNoteCacheMutationsIncrementally(
              ctx, cacheMutationViews) ) {
-        SessionUtils::markHitEventsDirty(ctx);
+        std::vector<entt::entity> hitEntities;
+        hitEntities.reserve(cacheMutations.size());
+        for ( const auto& mutation : cacheMutations ) {
+            hitEntities.push_back(mutation.entity);
+        }
+        SessionUtils::refreshHitEvents(ctx, hitEntities);
         markReplacementNoteOrderDirty(ctx);
     }
 }
@@ -2664,7 +2668,7 @@ void ActionController::handleCommand(const CmdUpsertBeatmapAnnotation& cmd)
                 annotation.m_targetId  = root.m_collaborationId;
                 annotation.m_timestamp = root.m_timestamp * 1000.0;
             }
-            m_ctx.m_needsNotesSync = true;
+            SessionUtils::markNotesFullSync(m_ctx);
         } else {
             m_ctx.lastActionMessage = "批注目标类型无效";
             return;
@@ -2728,6 +2732,7 @@ void ActionController::handleCommand(const CmdReplaceBeatmapData& cmd)
             retireBeatmapObjectStorage(cmd.sourceBeatmap);
         }
         m_ctx.m_needsNotesSync = false;
+        SessionUtils::resetNoteWriteBack(m_ctx);
         m_ctx.actionStack.markDirty();
         m_ctx.lastActionMessage = fmt::format(
             "{} {}", TR("ui.status.category.action"), "联机物件增量更新");
@@ -21,10 +21,10 @@
 #include <chrono>
 #include <cmath>
 
-static void markScrollCacheDirty(entt::registry& reg, entt::entity)
+static void markScrollCacheDirty(entt::registry& reg, entt::entity entity)
 {
     if ( auto* cache = reg.ctx().find<MMM::Logic::System::ScrollCache>() ) {
-        cache->isDirty = true;
+        cache->markTimelineChanged(entity);
     }
 }
 
@@ -132,10 +132,8 @@ void prefetchBoundNoteSounds(SessionContext& ctx)
             examinedCount < MAX_BOUND_SOUND_PREFETCH_EVENTS_PER_TICK ) {
         const auto& event = ctx.hitEvents[ctx.nextBoundSoundPrefetchIndex];
         if ( event.timestamp > prefetchEnd ) break;
-        if ( event.sampleBinding &&
-             !event.sampleBinding->m_audioResourceId.empty() ) {
-            audioManager.queueBoundNoteSoundEffectLoad(
-                event.sampleBinding->m_audioResourceId);
+        if ( event.sampleResource ) {
+            audioManager.queueBoundNoteSoundEffectLoad(*event.sampleResource);
         }
         ++ctx.nextBoundSoundPrefetchIndex;
         ++examinedCount;
@@ -402,7 +400,8 @@ void BeatmapSession::publishRequestedMutationSnapshot()
 /// @brief 判断会话是否存在等待逻辑线程消费的指令。
 bool BeatmapSession::hasPendingCommands() const
 {
-    return m_commandQueue.size_approx() > 0;
+    return m_commandBatchCursor < m_commandBatch.size() ||
+           m_commandQueue.size_approx() > 0;
 }
 
 /// @brief 判断会话是否需要跳过后台限频并立即更新。
@@ -704,6 +703,10 @@ void BeatmapSession::update(double dt, const Config::EditorConfig& config,
 {
     m_ctx->lastConfig      = config;
     m_ctx->isActiveSession = isActiveSession;
+    m_ctx->actionStack.setMemoryBudget(
+        static_cast<std::size_t>(
+            std::max(config.settings.undoMemoryBudgetMB, 0)) *
+        1024 * 1024);
     ProjectDraftLaneService::refreshIfChanged(*m_ctx);
     if ( !isActiveSession && m_ctx->isPlaying ) {
         m_ctx->isPlaying = false;
@@ -828,7 +831,7 @@ void BeatmapSession::update(double dt, const Config::EditorConfig& config,
             m_ctx->hitFXSystem.clearActiveEffects();
             SessionUtils::syncHitIndex(*m_ctx);
             m_ctx->hitFXSystem.restoreActiveHoldEffects(
-                m_ctx->animateTime, m_ctx->hitEvents, effectiveConfig);
+                m_ctx->animateTime, m_ctx->hitEvents.events(), effectiveConfig);
 
             if ( m_ctx->isPlaying ) {
                 // 核心修复：Jump/Start 后立即预测播放窗口内的所有音效
@@ -891,7 +894,8 @@ void BeatmapSession::update(double dt, const Config::EditorConfig& config,
 
     const auto* scrollCache =
         m_ctx->timelineRegistry.ctx().find<System::ScrollCache>();
-    const bool isTimelineCacheDirty = scrollCache && scrollCache->isDirty;
+    const bool isTimelineCacheDirty =
+        scrollCache && scrollCache->needsRebuild();
     const bool hasRenderDirtyState =
         m_ctx->isNoteOrderDirty || m_ctx->isNotePruneDirty ||
         m_ctx->isNoteStatsDirty || m_ctx->isTransformDirty ||
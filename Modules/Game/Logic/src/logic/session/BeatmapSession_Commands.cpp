@@ -22,8 +22,10 @@
 #include "logic/session/SessionUtils.h"
 #include "logic/session/context/SessionContext.h"
 #include "mmm/beatmap/BeatMap.h"
+#include "mmm/beatmap/BeatmapIndex.h"
 #include "mmm/project/PackageFileTypes.h"
 #include "mmm/project/Project.h"
+#include "runtime/AppThreadPool.h"
 #include <algorithm>
 #include <array>
 #include <chrono>
@@ -377,6 +379,39 @@ void rememberBeatmapFileHash(
     }
 }
 
+/// @brief 在共享线程池中按刚写出的文件更新谱面摘要索引并写回索引文件。
+/// @param savePath 已成功保存的谱面路径；不在索引所属项目内时忽略。
+/// @note 摘要取自文件而不是内存谱面，有损格式保存后与重新加载的结果
+/// 一致；索引写回串行进行，排队中的写回在条目已写出时直接返回。
+void scheduleBeatmapIndexReload(const std::filesystem::path& savePath)
+{
+    auto beatmapIndex = MMM::BeatmapIndex::active();
+    if ( !beatmapIndex ) return;
+    std::error_code ec;
+    const auto      absolutePath = std::filesystem::absolute(savePath, ec);
+    if ( ec ) return;
+    const auto relativePath =
+        absolutePath.lexically_normal().lexically_relative(
+            beatmapIndex->projectRoot());
+    if ( relativePath.empty() || *relativePath.begin() == ".." ) return;
+
+    auto task = [beatmapIndex = std::move(beatmapIndex), absolutePath]() {
+        if ( !beatmapIndex->reload(absolutePath) ) {
+            XWARN("Failed to update beatmap index for {}",
+                  MMM::Config::pathToUtf8(absolutePath));
+        }
+        if ( !beatmapIndex->save() ) {
+            XWARN("Failed to save beatmap index after saving beatmap.");
+        }
+    };
+    auto* appThreadPool = MMM::Runtime::AppThreadPool::instance().get();
+    if ( appThreadPool ) {
+        appThreadPool->enqueue_void(std::move(task));
+    } else {
+        task();
+    }
+}
+
 /// @brief 判断强制 MMM 保存是否需要用户确认覆盖。
 /// @param settings 当前编辑器设置。
 /// @param savedBeatmapFileHashes 当前会话的谱面文件哈希缓存。
@@ -1189,8 +1224,38 @@ bool writeBeatmapPackage(
 namespace MMM::Logic
 {
 
+bool BeatmapSession::takeNextCommand(LogicCommand& cmd)
+{
+    if ( m_commandBatchCursor >= m_commandBatch.size() ) {
+        m_commandBatch.clear();
+        m_commandBatchCursor = 0;
+        LogicCommand queued;
+        while ( m_commandQueue.try_dequeue(queued) ) {
+            m_commandBatch.push_back(std::move(queued));
+        }
+        if ( m_commandBatch.empty() ) return false;
+
+        // 批次内的配置更新可能开启滚动吸附，此时保守地不累加滚轮。
+        const bool scrollSnap =
+            m_ctx->lastConfig.settings.scrollSnap ||
+            std::any_of(m_commandBatch.begin(),
+                        m_commandBatch.end(),
+                        [](const LogicCommand& queuedCommand) {
+                            return std::holds_alternative<
+                                CmdUpdateEditorConfig>(queuedCommand);
+                        });
+        m_commandTickStats.enqueued +=
+            static_cast<std::uint32_t>(m_commandBatch.size());
+        m_commandTickStats.coalesced += static_cast<std::uint32_t>(
+            m_commandCoalescer.coalesce(m_commandBatch, scrollSnap));
+    }
+    cmd = std::move(m_commandBatch[m_commandBatchCursor++]);
+    return true;
+}
+
 bool BeatmapSession::processCommands()
 {
+    m_commandTickStats = {};
     LogicCommand                cmd;
     bool                        processed = false;
     ::MMM::BeatmapMutationFlags mutationFlags =
@@ -1230,11 +1295,12 @@ bool BeatmapSession::processCommands()
                    value.replaceMetadata || value.replaceAudioSamples ||
                    value.replaceAnnotations;
         };
-    while ( m_commandQueue.try_dequeue(cmd) ) {
+    while ( takeNextCommand(cmd) ) {
         if ( blockCollaborationOfflineEdit(cmd) ||
              blockCollaborationUnauthorizedEdit(cmd, true) ) {
             continue;
         }
+        ++m_commandTickStats.applied;
         if ( const auto* acknowledgement =
                  std::get_if<CmdAcknowledgeCollaborationMutation>(&cmd) ) {
             const auto latestLocalObjectMutationSequence =
@@ -1389,11 +1455,6 @@ bool BeatmapSession::processCommands()
                                std::is_same_v<T, CmdCreateBeatmap> ||
                                std::is_same_v<T, CmdRemoveBeatmap> ||
                                std::is_same_v<T, CmdUpdateBeatmapMetadata> ||
-                               std::is_same_v<T, CmdUpdateTimelineEvent> ||
-                               std::is_same_v<T, CmdUpdateTimelineEvents> ||
-                               std::is_same_v<T, CmdDeleteTimelineEvent> ||
-                               std::is_same_v<T, CmdCreateTimelineEvent> ||
-                               std::is_same_v<T, CmdCreateTimelineEvents> ||
                                std::is_same_v<T, CmdReplaceBeatmapTimings> ||
                                std::is_same_v<T, CmdSetNoteAnnotation> ||
                                std::is_same_v<T, CmdUpsertBeatmapAnnotation> ||
@@ -1980,7 +2041,7 @@ void BeatmapSession::handleCommand(const CmdSaveBeatmap& cmd)
         }
 
         m_ctx->m_needsTimingsSync = true;
-        m_ctx->m_needsNotesSync   = true;
+        SessionUtils::markNotesFullSync(*m_ctx);
         SessionUtils::syncBeatmap(*m_ctx);
         SessionUtils::ensureHitEvents(*m_ctx);
         refreshCurrentProjectSongFileHint(*m_ctx->currentBeatmap);
@@ -2007,6 +2068,7 @@ void BeatmapSession::handleCommand(const CmdSaveBeatmap& cmd)
         auto storedSavePath = makeCurrentProjectRelativePath(savePath);
         m_ctx->currentBeatmap->m_baseMapMetadata.map_path = storedSavePath;
         rememberBeatmapFileHash(m_savedBeatmapFileHashes, savePath);
+        scheduleBeatmapIndexReload(savePath);
         m_ctx->actionStack.markSaved();
         if ( oldPath != storedSavePath ) {
             EditorEngine::instance().updateBeatmapFilePathInProject(
@@ -2025,7 +2087,7 @@ void BeatmapSession::handleCommand(const CmdSaveBeatmapAs& cmd)
 {
     if ( m_ctx->currentBeatmap ) {
         m_ctx->m_needsTimingsSync = true;
-        m_ctx->m_needsNotesSync   = true;
+        SessionUtils::markNotesFullSync(*m_ctx);
         SessionUtils::syncBeatmap(*m_ctx);
         SessionUtils::ensureHitEvents(*m_ctx);
         auto savePath = resolveCurrentProjectPath(Config::utf8ToPath(cmd.path));
@@ -2050,7 +2112,9 @@ void BeatmapSession::handleCommand(const CmdSaveBeatmapAs& cmd)
             .isExport = true,
         });
 
-        // 导出到项目目录时刷新项目资源列表，但不切换当前会话的谱面文件。
+        // 导出到项目目录时刷新项目资源列表与谱面索引，但不切换当前会话的
+        // 谱面文件。
+        scheduleBeatmapIndexReload(savePath);
         EditorEngine::instance().syncProjectWithFile(savePath);
     }
 }
@@ -1,7 +1,9 @@
 #include "logic/BeatmapSession.h"
 
 #include "audio/AudioManager.h"
+#include "config/AppConfig.h"
 #include "config/Utf8Path.h"
+#include "log/colorful-log.h"
 #include "logic/BeatmapSyncBuffer.h"
 #include "logic/EditorEngine.h"
 #include "logic/PreviewDensity.h"
@@ -18,11 +20,17 @@
 #include "logic/session/context/SessionContext.h"
 #include "mmm/beatmap/BeatMap.h"
 #include "mmm/project/Project.h"
+#include "runtime/AppThreadPool.h"
 #include <algorithm>
+#include <array>
+#include <atomic>
+#include <chrono>
 #include <cmath>
 #include <cstdint>
 #include <filesystem>
+#include <ice/thread/ThreadPool.hpp>
 #include <limits>
+#include <memory>
 #include <numeric>
 #include <unordered_map>
 #include <vector>
@@ -30,6 +38,23 @@
 namespace MMM::Logic
 {
 
+/// @brief 一轮多视口并行快照生成的共享调度状态。
+/// @note 调用线程与线程池任务按原子下标领取任务，调用线程只等待任务全部
+/// 完成，不等待辅助任务启动；排队较晚的辅助任务只会领取到越界下标并退出。
+struct CameraSnapshotDispatch {
+    /// @brief 下一个待领取的任务下标。
+    std::atomic<std::size_t> nextJob{ 0 };
+    /// @brief 尚未完成的任务数量，归零时唤醒调用线程。
+    std::atomic<std::size_t> pendingJobs{ 0 };
+    /// @brief 本轮任务总数。
+    std::atomic<std::size_t> jobCount{ 0 };
+    /// @brief 本轮任务执行函数，只在成功领取任务后调用；由 nextJob 的
+    /// release 写入发布给领取者。
+    void (*run)(void* context, std::size_t job){ nullptr };
+    /// @brief 传给 run 的调用线程栈上下文。
+    void* context{ nullptr };
+};
+
 namespace
 {
 /// @brief 在批注或目标物件变化后重建时间戳分组缓存。
@@ -568,6 +593,144 @@ void syncPreviewDragHoverTime(SessionContext&             ctx,
                            static_cast<double>(renderScaleY);
     ctx.previewHoverTime = cache->getTime(currentAbsY + deltaY);
 }
+
+/// @brief 快照生成性能统计使用的单调时钟。
+using SnapshotProfileClock = std::chrono::steady_clock;
+
+/// @brief 快照生成性能统计日志输出间隔。
+constexpr auto SNAPSHOT_PROFILE_LOG_INTERVAL = std::chrono::seconds(2);
+
+/// @brief 仅在开启渲染性能日志时读取当前时间。
+SnapshotProfileClock::time_point snapshotProfileTimePoint(bool enabled)
+{
+    return enabled ? SnapshotProfileClock::now()
+                   : SnapshotProfileClock::time_point{};
+}
+
+/// @brief 计算两个统计时间点之间的毫秒数。
+double snapshotProfileElapsedMs(SnapshotProfileClock::time_point start,
+                                SnapshotProfileClock::time_point end)
+{
+    return std::chrono::duration<double, std::milli>(end - start).count();
+}
+
+/// @brief 多视口快照生成阶段的累计性能统计。
+/// @note 关键路径为每轮最慢视口的耗时；串行耗时为各视口耗时之和。
+/// 墙钟时间接近关键路径说明并行已充分展开，接近串行耗时说明线程池
+/// 没有空闲工作线程。
+struct SnapshotProfileAccumulator {
+    /// @brief 当前统计窗口的起始时间。
+    SnapshotProfileClock::time_point windowStart{ SnapshotProfileClock::now() };
+    /// @brief 统计窗口内的快照阶段数量。
+    std::uint64_t phaseCount{ 0 };
+    /// @brief 统计窗口内生成的视口快照数量。
+    std::uint64_t jobCount{ 0 };
+    /// @brief 统计窗口内并行执行的快照阶段数量。
+    std::uint64_t parallelPhaseCount{ 0 };
+    /// @brief 快照阶段墙钟耗时累计，单位为毫秒。
+    double wallMs{ 0.0 };
+    /// @brief 快照阶段单轮最大墙钟耗时，单位为毫秒。
+    double wallMaxMs{ 0.0 };
+    /// @brief 各视口耗时之和的累计，单位为毫秒。
+    double serialMs{ 0.0 };
+    /// @brief 每轮最慢视口耗时的累计，单位为毫秒。
+    double criticalMs{ 0.0 };
+    /// @brief 统计窗口内最慢的单个视口耗时，单位为毫秒。
+    double criticalMaxMs{ 0.0 };
+    /// @brief 统计窗口内最慢的视口 ID。
+    std::string criticalCameraId;
+
+    /// @brief 清空统计窗口。
+    void reset(SnapshotProfileClock::time_point nextStart)
+    {
+        windowStart        = nextStart;
+        phaseCount         = 0;
+        jobCount           = 0;
+        parallelPhaseCount = 0;
+        wallMs             = 0.0;
+        wallMaxMs          = 0.0;
+        serialMs           = 0.0;
+        criticalMs         = 0.0;
+        criticalMaxMs      = 0.0;
+        criticalCameraId.clear();
+    }
+
+    /// @brief 追加一轮快照阶段的统计。
+    /// @warning 逻辑热路径：仅在开启渲染性能日志时执行。
+    void add(const std::vector<CameraSnapshotJob>& jobs, double phaseWallMs,
+             bool parallel)
+    {
+        double phaseCriticalMs = 0.0;
+        const CameraSnapshotJob* slowest = nullptr;
+        for ( const auto& job : jobs ) {
+            serialMs += job.elapsedMs;
+            if ( !slowest || job.elapsedMs > phaseCriticalMs ) {
+                phaseCriticalMs = job.elapsedMs;
+                slowest         = &job;
+            }
+        }
+        ++phaseCount;
+        jobCount += jobs.size();
+        parallelPhaseCount += parallel ? 1 : 0;
+        wallMs += phaseWallMs;
+        wallMaxMs = std::max(wallMaxMs, phaseWallMs);
+        criticalMs += phaseCriticalMs;
+        if ( slowest && phaseCriticalMs > criticalMaxMs ) {
+            criticalMaxMs    = phaseCriticalMs;
+            criticalCameraId = *slowest->cameraId;
+        }
+    }
+
+    /// @brief 到达统计间隔后输出一次累计结果。
+    /// @warning 逻辑热路径：每轮只做时间间隔判断；到达间隔后才写日志。
+    void logIfReady(SnapshotProfileClock::time_point now)
+    {
+        const double elapsedSeconds =
+            std::chrono::duration<double>(now - windowStart).count();
+        const double logIntervalSeconds =
+            std::chrono::duration<double>(SNAPSHOT_PROFILE_LOG_INTERVAL)
+                .count();
+        if ( elapsedSeconds < logIntervalSeconds || phaseCount == 0 ) {
+            return;
+        }
+
+        const auto phases = static_cast<double>(phaseCount);
+        XINFO(
+            "SnapshotProfile {:.2f}s phases={} parallel={} cameras(avg)={:.1f} "
+            "wall(avg/max)={:.3f}/{:.3f}ms serial(avg)={:.3f}ms "
+            "critical(avg/max)={:.3f}/{:.3f}ms slowest={}",
+            elapsedSeconds,
+            phaseCount,
+            parallelPhaseCount,
+            static_cast<double>(jobCount) / phases,
+            wallMs / phases,
+            wallMaxMs,
+            serialMs / phases,
+            criticalMs / phases,
+            criticalMaxMs,
+            criticalCameraId);
+        reset(now);
+    }
+};
+
+/// @brief 循环领取并执行快照任务，直到本轮任务全部被领取。
+/// @warning 调用线程与线程池任务共用；每个任务完成后递减计数，最后一个
+/// 完成者唤醒等待中的调用线程。
+void drainCameraSnapshotJobs(CameraSnapshotDispatch& dispatch)
+{
+    for ( ;; ) {
+        const std::size_t job =
+            dispatch.nextJob.fetch_add(1, std::memory_order_acquire);
+        if ( job >= dispatch.jobCount.load(std::memory_order_relaxed) ) {
+            return;
+        }
+        dispatch.run(dispatch.context, job);
+        if ( dispatch.pendingJobs.fetch_sub(1, std::memory_order_acq_rel) ==
+             1 ) {
+            dispatch.pendingJobs.notify_all();
+        }
+    }
+}
 }  // namespace
 
 /// @brief 更新 ECS 状态并为当前 Session 的视口生成渲染快照。
@@ -576,51 +739,34 @@ void syncPreviewDragHoverTime(SessionContext&             ctx,
 void BeatmapSession::updateECSAndRender(const Config::EditorConfig& config,
                                         bool isActiveSession)
 {
-    auto rebuildNotePrefixAndStats = [this](bool rebuildStats,
-                                            bool rebuildDensity) {
-        m_ctx->sortedNoteMaxEndPrefix.clear();
-        m_ctx->sortedNoteMaxEndPrefix.reserve(m_ctx->sortedNoteEntities.size());
+    auto rebuildNoteStats = [this](bool rebuildDensity) {
         if ( rebuildDensity ) {
             m_ctx->previewDensityObjectTimes.clear();
             m_ctx->previewDensityObjectTimes.reserve(
-                m_ctx->sortedNoteEntities.size());
+                m_ctx->noteVisibilityIndex.size());
         }
 
         BeatmapStatusStats stats;
-        const auto*        beatmap    = m_ctx->currentBeatmap.get();
-        double             maxEndTime = 0.0;
-        for ( auto entity : m_ctx->sortedNoteEntities ) {
-            if ( !m_ctx->noteRegistry.valid(entity) ||
-                 !m_ctx->noteRegistry.all_of<NoteComponent>(entity) ) {
+        const auto*        beatmap = m_ctx->currentBeatmap.get();
+        for ( const auto& entry : m_ctx->noteVisibilityIndex ) {
+            if ( !m_ctx->noteRegistry.valid(entry.entity) ||
+                 !m_ctx->noteRegistry.all_of<NoteComponent>(entry.entity) ) {
                 continue;
             }
 
             const auto& note =
-                m_ctx->noteRegistry.get<const NoteComponent>(entity);
-            if ( rebuildStats && !note.m_isDraft ) {
-                accumulateNoteStats(note, beatmap, stats);
-            }
-            if ( rebuildDensity && !note.m_isDraft ) {
+                m_ctx->noteRegistry.get<const NoteComponent>(entry.entity);
+            if ( note.m_isDraft ) continue;
+            accumulateNoteStats(note, beatmap, stats);
+            if ( rebuildDensity ) {
                 appendPreviewDensityObjectTimes(
                     note, m_ctx->previewDensityObjectTimes);
             }
-
-            double noteEnd = note.m_timestamp + std::max(0.0, note.m_duration);
-            if ( note.m_type == ::MMM::NoteType::POLYLINE ) {
-                for ( const auto& sub : note.m_subNotes ) {
-                    noteEnd = std::max(
-                        noteEnd, sub.timestamp + std::max(0.0, sub.duration));
-                }
-            }
-            maxEndTime = std::max(maxEndTime, noteEnd);
-            m_ctx->sortedNoteMaxEndPrefix.push_back(maxEndTime);
         }
 
-        if ( rebuildStats ) {
-            m_ctx->noteCount        = stats.noteCount;
-            m_ctx->maxCombo         = stats.maxCombo;
-            m_ctx->isNoteStatsDirty = false;
-        }
+        m_ctx->noteCount        = stats.noteCount;
+        m_ctx->maxCombo         = stats.maxCombo;
+        m_ctx->isNoteStatsDirty = false;
         if ( rebuildDensity ) {
             std::sort(m_ctx->previewDensityObjectTimes.begin(),
                       m_ctx->previewDensityObjectTimes.end());
@@ -628,56 +774,44 @@ void BeatmapSession::updateECSAndRender(const Config::EditorConfig& config,
         }
     };
 
-    // 在需要时重建已排序音符实体缓存。
+    // 在需要时重建音符可见性索引；条目内联起止时间，排序不再访问 ECS。
     if ( m_ctx->isNoteOrderDirty ) {
         auto noteView = m_ctx->noteRegistry.view<const NoteComponent>();
-        m_ctx->sortedNoteEntities.assign(noteView.begin(), noteView.end());
-        std::sort(m_ctx->sortedNoteEntities.begin(),
-                  m_ctx->sortedNoteEntities.end(),
-                  [this](entt::entity a, entt::entity b) {
-                      return m_ctx->noteRegistry.get<const NoteComponent>(a)
-                                 .m_timestamp <
-                             m_ctx->noteRegistry.get<const NoteComponent>(b)
-                                 .m_timestamp;
-                  });
+        std::vector<TimeIntervalIndex::Entry> entries;
+        entries.reserve(noteView.size());
+        for ( auto entity : noteView ) {
+            entries.push_back(TimeIntervalIndex::makeEntry(
+                entity, noteView.get<const NoteComponent>(entity)));
+        }
+        m_ctx->noteVisibilityIndex.assign(std::move(entries));
         // 状态栏统计直接以当前 ECS 为准，不依赖延迟写回的 BeatMap 音符容器。
         // 否则 m_needsNotesSync 等待空闲期间 isNoteStatsDirty 无法消费，
         // 会让每个逻辑 update 都强制生成全部视口的渲染快照。
-        rebuildNotePrefixAndStats(true, true);
+        rebuildNoteStats(true);
         ++m_ctx->noteVisibilityIndexRevision;
+        m_ctx->noteDirtyTimes.recordFull(m_ctx->noteVisibilityIndexRevision);
         m_ctx->isNoteOrderDirty = false;
         m_ctx->isNotePruneDirty = false;
     } else if ( m_ctx->isNotePruneDirty ) {
-        auto isEntityInvalid = [this](entt::entity entity) {
+        m_ctx->noteVisibilityIndex.eraseIf([this](entt::entity entity) {
             return !m_ctx->noteRegistry.valid(entity) ||
                    !m_ctx->noteRegistry.all_of<NoteComponent>(entity);
-        };
-        m_ctx->sortedNoteEntities.erase(
-            std::remove_if(m_ctx->sortedNoteEntities.begin(),
-                           m_ctx->sortedNoteEntities.end(),
-                           isEntityInvalid),
-            m_ctx->sortedNoteEntities.end());
-        rebuildNotePrefixAndStats(true, true);
+        });
+        rebuildNoteStats(true);
         ++m_ctx->noteVisibilityIndexRevision;
+        m_ctx->noteDirtyTimes.recordFull(m_ctx->noteVisibilityIndexRevision);
         m_ctx->isNotePruneDirty = false;
     } else if ( m_ctx->isNoteStatsDirty ) {
-        rebuildNotePrefixAndStats(true, false);
+        rebuildNoteStats(false);
     }
 
-    if ( auto** sortedEntitiesPtr =
+    if ( auto** visibilityIndexPtr =
              m_ctx->noteRegistry.ctx()
-                 .find<const std::vector<entt::entity>*>() ) {
-        *sortedEntitiesPtr = &m_ctx->sortedNoteEntities;
+                 .find<const TimeIntervalIndex*>() ) {
+        *visibilityIndexPtr = &m_ctx->noteVisibilityIndex;
     } else {
-        m_ctx->noteRegistry.ctx().emplace<const std::vector<entt::entity>*>(
-            &m_ctx->sortedNoteEntities);
-    }
-    if ( auto** maxEndPrefixPtr =
-             m_ctx->noteRegistry.ctx().find<const std::vector<double>*>() ) {
-        *maxEndPrefixPtr = &m_ctx->sortedNoteMaxEndPrefix;
-    } else {
-        m_ctx->noteRegistry.ctx().emplace<const std::vector<double>*>(
-            &m_ctx->sortedNoteMaxEndPrefix);
+        m_ctx->noteRegistry.ctx().emplace<const TimeIntervalIndex*>(
+            &m_ctx->noteVisibilityIndex);
     }
     if ( auto** revisionPtr =
              m_ctx->noteRegistry.ctx().find<const std::uint64_t*>() ) {
@@ -686,6 +820,13 @@ void BeatmapSession::updateECSAndRender(const Config::EditorConfig& config,
         m_ctx->noteRegistry.ctx().emplace<const std::uint64_t*>(
             &m_ctx->noteVisibilityIndexRevision);
     }
+    if ( auto** dirtyTimesPtr =
+             m_ctx->noteRegistry.ctx().find<const NoteDirtyTimeLog*>() ) {
+        *dirtyTimesPtr = &m_ctx->noteDirtyTimes;
+    } else {
+        m_ctx->noteRegistry.ctx().emplace<const NoteDirtyTimeLog*>(
+            &m_ctx->noteDirtyTimes);
+    }
     if ( auto* pinnedEntities =
              m_ctx->noteRegistry.ctx().find<DragRenderPinnedEntities>() ) {
         pinnedEntities->entities = &m_ctx->dragRenderPinnedEntities;
@@ -695,62 +836,46 @@ void BeatmapSession::updateECSAndRender(const Config::EditorConfig& config,
         pinnedEntityView.entities = &m_ctx->dragRenderPinnedEntities;
     }
 
-    auto rebuildSamplePrefix = [this]() {
-        m_ctx->sortedSampleMaxEndPrefix.clear();
-        m_ctx->sortedSampleMaxEndPrefix.reserve(
-            m_ctx->sortedSampleEntities.size());
-        double maxEndTime = -std::numeric_limits<double>::infinity();
-        for ( const auto entity : m_ctx->sortedSampleEntities ) {
-            if ( !m_ctx->sampleRegistry.valid(entity) ||
-                 !m_ctx->sampleRegistry.all_of<SampleComponent>(entity) ) {
-                continue;
-            }
-            const auto& sample =
-                m_ctx->sampleRegistry.get<const SampleComponent>(entity);
-            maxEndTime =
-                std::max(maxEndTime,
-                         std::max(sample.m_timestamp, sample.effectiveTime()));
-            m_ctx->sortedSampleMaxEndPrefix.push_back(maxEndTime);
-        }
-    };
+    // 重叠检测在后台按音符修订号增量合并；本轮持有结果，快照生成期间指针
+    // 有效。
+    if ( isActiveSession ) {
+        m_ctx->overlapScan.update(
+            m_ctx->noteRegistry,
+            m_ctx->noteVisibilityIndex,
+            m_ctx->noteDirtyTimes,
+            m_ctx->noteVisibilityIndexRevision,
+            static_cast<double>(
+                std::max(0.0f, config.settings.overlapTimeWindowMs)) *
+                0.001);
+    }
+    m_ctx->overlapReport = m_ctx->overlapScan.report();
+    if ( auto* reportView =
+             m_ctx->noteRegistry.ctx().find<OverlapReportView>() ) {
+        reportView->report = m_ctx->overlapReport.get();
+    } else {
+        m_ctx->noteRegistry.ctx().emplace<OverlapReportView>().report =
+            m_ctx->overlapReport.get();
+    }
 
     // 自动采样拥有独立的低频可见性索引，普通渲染路径不扫描完整 Registry。
     if ( m_ctx->isSampleOrderDirty ) {
         const auto sampleView =
             m_ctx->sampleRegistry.view<const SampleComponent>();
-        m_ctx->sortedSampleEntities.assign(sampleView.begin(),
-                                           sampleView.end());
-        std::sort(m_ctx->sortedSampleEntities.begin(),
-                  m_ctx->sortedSampleEntities.end(),
-                  [this](entt::entity lhs, entt::entity rhs) {
-                      const auto& left =
-                          m_ctx->sampleRegistry.get<const SampleComponent>(lhs);
-                      const auto& right =
-                          m_ctx->sampleRegistry.get<const SampleComponent>(rhs);
-                      const double leftStart =
-                          std::min(left.m_timestamp, left.effectiveTime());
-                      const double rightStart =
-                          std::min(right.m_timestamp, right.effectiveTime());
-                      if ( leftStart != rightStart )
-                          return leftStart < rightStart;
-                      return entt::to_integral(lhs) < entt::to_integral(rhs);
-                  });
-        rebuildSamplePrefix();
+        std::vector<TimeIntervalIndex::Entry> entries;
+        entries.reserve(sampleView.size());
+        for ( auto entity : sampleView ) {
+            entries.push_back(TimeIntervalIndex::makeEntry(
+                entity, sampleView.get<const SampleComponent>(entity)));
+        }
+        m_ctx->sampleVisibilityIndex.assign(std::move(entries));
         ++m_ctx->sampleVisibilityIndexRevision;
         m_ctx->isSampleOrderDirty = false;
         m_ctx->isSamplePruneDirty = false;
     } else if ( m_ctx->isSamplePruneDirty ) {
-        m_ctx->sortedSampleEntities.erase(
-            std::remove_if(
-                m_ctx->sortedSampleEntities.begin(),
-                m_ctx->sortedSampleEntities.end(),
-                [this](entt::entity entity) {
-                    return !m_ctx->sampleRegistry.valid(entity) ||
-                           !m_ctx->sampleRegistry.all_of<SampleComponent>(
-                               entity);
-                }),
-            m_ctx->sortedSampleEntities.end());
-        rebuildSamplePrefix();
+        m_ctx->sampleVisibilityIndex.eraseIf([this](entt::entity entity) {
+            return !m_ctx->sampleRegistry.valid(entity) ||
+                   !m_ctx->sampleRegistry.all_of<SampleComponent>(entity);
+        });
         ++m_ctx->sampleVisibilityIndexRevision;
         m_ctx->isSamplePruneDirty = false;
     }
@@ -862,7 +987,10 @@ void BeatmapSession::updateECSAndRender(const Config::EditorConfig& config,
         }
     }
 
-    // 2. 遍历所有注册的视口 (Camera) 进行独立的视口剔除和坐标映射
+    // 2. 遍历所有注册的视口 (Camera)，串行填写快照头部并收集生成任务；
+    // 本阶段可以修改会话状态，随后的并行生成阶段对 Registry 只读。
+    auto& cameraSnapshotJobs = m_ctx->cameraSnapshotJobs;
+    cameraSnapshotJobs.clear();
     for ( auto& [cameraId, camera] : m_ctx->cameras ) {
         // 只有活跃 Session 才能往 Preview 和 Timeline 缓冲写入，避免后台
         // Session 覆盖
@@ -962,10 +1090,15 @@ void BeatmapSession::updateECSAndRender(const Config::EditorConfig& config,
                 scale = 1.0;
             }
 
-            snapshot->visibleTimeStart = cache->getTime(
-                currentAbsY - (camera.viewportHeight - judgmentLineY) / scale);
-            snapshot->visibleTimeEnd =
-                cache->getTime(currentAbsY + judgmentLineY / scale);
+            // 视口下沿与上沿一次批量反向映射，单调缓存只遍历一次分段。
+            const std::array<double, 2> edgeAbsYs{
+                currentAbsY - (camera.viewportHeight - judgmentLineY) / scale,
+                currentAbsY + judgmentLineY / scale,
+            };
+            std::array<double, 2> edgeTimes{};
+            cache->getTimeBatch(edgeAbsYs, edgeTimes);
+            snapshot->visibleTimeStart = edgeTimes[0];
+            snapshot->visibleTimeEnd   = edgeTimes[1];
         }
         if ( SessionUtils::isMainCanvasCameraId(cameraId) &&
              !m_ctx->annotationRenderCache.empty() ) {
@@ -995,6 +1128,8 @@ void BeatmapSession::updateECSAndRender(const Config::EditorConfig& config,
         snapshot->acceptsInteraction = isActiveSession;
         snapshot->noteCount          = m_ctx->noteCount;
         snapshot->maxCombo           = m_ctx->maxCombo;
+        snapshot->undoMemoryBytes    = m_ctx->actionStack.getMemoryUsage();
+        snapshot->undoSpilledBytes   = m_ctx->actionStack.getSpilledBytes();
         snapshot->trackCount         = m_ctx->trackCount;
         snapshot->bgmTrackCount      = m_ctx->bgmTrackCount;
         snapshot->bmsEditingEnabled =
@@ -1645,41 +1780,143 @@ void BeatmapSession::updateECSAndRender(const Config::EditorConfig& config,
         }
 
 
-        // 3. 调用 ECS System 针对当前 Camera 生成渲染快照
-        // 使用动画时间 m_ctx->animateTime 进行剔除和位置映射
+        // Timeline 不绘制音符基础层，不需要保留几何。
+        System::RetainedNoteGeometryCache* geometryCache = nullptr;
+        if ( cameraId != "Timeline" ) {
+            geometryCache = &m_ctx->noteGeometryCaches[cameraId];
+        }
+
+        cameraSnapshotJobs.push_back({ .cameraId           = &cameraId,
+                                       .camera             = &camera,
+                                       .syncBuffer         = syncBuffer.get(),
+                                       .snapshot           = snapshot,
+                                       .judgmentLineY      = judgmentLineY,
+                                       .mainViewportHeight = finalMainHeight,
+                                       .noteGeometryCache  = geometryCache });
+    }
+    if ( cameraSnapshotJobs.empty() ) return;
+
+    static SnapshotProfileAccumulator snapshotProfile;
+    static bool lastSnapshotProfileLoggingEnabled = false;
+    const bool  snapshotProfileLoggingEnabled =
+        Config::AppConfig::instance().getEditorSettings().renderProfileLogging;
+    if ( snapshotProfileLoggingEnabled && !lastSnapshotProfileLoggingEnabled ) {
+        snapshotProfile.reset(SnapshotProfileClock::now());
+    }
+    lastSnapshotProfileLoggingEnabled = snapshotProfileLoggingEnabled;
+
+    // 3. 调用 ECS System 针对各 Camera 生成渲染快照
+    // 使用动画时间 m_ctx->animateTime 进行剔除和位置映射。共享的上下文槽、
+    // 分桶索引与组件存储先串行准备，之后各视口只写自己的 RenderSnapshot，
+    // Batcher 与查询临时缓冲也随快照各自持有。
+    System::NoteRenderSystem::prepareSnapshotPhase(
+        m_ctx->noteRegistry, m_ctx->sampleRegistry, m_ctx->timelineRegistry);
+    const auto* snapshotScrollCache =
+        m_ctx->timelineRegistry.ctx().find<System::ScrollCache>();
+    auto generateCameraSnapshot = [&](std::size_t jobIndex) {
+        auto&      job = cameraSnapshotJobs[jobIndex];
+        const auto start =
+            snapshotProfileTimePoint(snapshotProfileLoggingEnabled);
+        RenderSnapshot* snapshot = job.snapshot;
         System::NoteRenderSystem::generateSnapshot(
             m_ctx->noteRegistry,
             m_ctx->sampleRegistry,
-            m_ctx->sortedSampleEntities,
-            m_ctx->sortedSampleMaxEndPrefix,
+            m_ctx->sampleVisibilityIndex,
             m_ctx->timelineRegistry,
             bpmEvents,
             snapshot,
-            cameraId,
+            *job.cameraId,
             m_ctx->animateTime,
-            camera.viewportWidth,
-            camera.viewportHeight,
-            judgmentLineY,
+            job.camera->viewportWidth,
+            job.camera->viewportHeight,
+            job.judgmentLineY,
             m_ctx->trackCount,
             m_ctx->bgmTrackCount,
             config,
-            finalMainHeight,
-            &m_ctx->hitFXSystem);
+            job.mainViewportHeight,
+            &m_ctx->hitFXSystem,
+            job.noteGeometryCache);
+        // 命中框已全部写入；只有主画布做悬停拾取，预览与时间线不构建索引。
+        if ( SessionUtils::isMainCanvasCameraId(*job.cameraId) ) {
+            snapshot->hitboxIndex.build(snapshot->hitboxes,
+                                        snapshot->interactionHitboxScaleX,
+                                        snapshot->interactionHitboxScaleY);
+        } else {
+            snapshot->hitboxIndex.clear();
+        }
 
-        if ( SessionUtils::isMainCanvasCameraId(cameraId) && cache ) {
+        if ( SessionUtils::isMainCanvasCameraId(*job.cameraId) &&
+             snapshotScrollCache ) {
             const double currentAbsY =
-                cache->getVisualAnchorAbsY(m_ctx->animateTime);
+                snapshotScrollCache->getVisualAnchorAbsY(m_ctx->animateTime);
             for ( auto& marker : snapshot->annotationMarkers ) {
                 marker.canvasY =
-                    judgmentLineY -
-                    static_cast<float>(cache->getDisplayDelta(
+                    job.judgmentLineY -
+                    static_cast<float>(snapshotScrollCache->getDisplayDelta(
                         marker.timestamp, currentAbsY, marker.timestamp)) *
                         snapshot->renderScaleY;
             }
         }
+        if ( snapshotProfileLoggingEnabled ) {
+            job.elapsedMs = snapshotProfileElapsedMs(
+                start, SnapshotProfileClock::now());
+        }
+    };
+
+    const auto phaseStart =
+        snapshotProfileTimePoint(snapshotProfileLoggingEnabled);
+    auto*      threadPool = Runtime::AppThreadPool::instance().get();
+    const bool useParallelSnapshots =
+        threadPool && cameraSnapshotJobs.size() > 1;
+    if ( useParallelSnapshots ) {
+        // 只有没有滞留线程池任务持有时才复用调度状态。
+        auto& dispatch = m_ctx->cameraSnapshotDispatch;
+        if ( !dispatch || dispatch.use_count() != 1 ) {
+            dispatch = std::make_shared<CameraSnapshotDispatch>();
+        }
+        std::atomic_thread_fence(std::memory_order_acquire);
+        dispatch->jobCount.store(cameraSnapshotJobs.size(),
+                                 std::memory_order_relaxed);
+        dispatch->context = &generateCameraSnapshot;
+        dispatch->run     = [](void* context, std::size_t job) {
+            (*static_cast<decltype(generateCameraSnapshot)*>(context))(job);
+        };
+        dispatch->pendingJobs.store(cameraSnapshotJobs.size(),
+                                    std::memory_order_relaxed);
+        dispatch->nextJob.store(0, std::memory_order_release);
+
+        // 逻辑循环本身占用一个工作线程，调用线程同样参与领取任务；
+        // 线程池繁忙时由调用线程独自完成全部任务，不会因等待而死锁。
+        for ( std::size_t helper = 1; helper < cameraSnapshotJobs.size();
+              ++helper ) {
+            threadPool->enqueue_void(
+                [dispatch]() { drainCameraSnapshotJobs(*dispatch); });
+        }
+        drainCameraSnapshotJobs(*dispatch);
+        auto& pendingJobs = dispatch->pendingJobs;
+        for ( auto pending = pendingJobs.load(std::memory_order_acquire);
+              pending != 0;
+              pending = pendingJobs.load(std::memory_order_acquire) ) {
+            pendingJobs.wait(pending, std::memory_order_acquire);
+        }
+    } else {
+        for ( std::size_t jobIndex = 0; jobIndex < cameraSnapshotJobs.size();
+              ++jobIndex ) {
+            generateCameraSnapshot(jobIndex);
+        }
+    }
+
+    if ( snapshotProfileLoggingEnabled ) {
+        const auto phaseEnd = SnapshotProfileClock::now();
+        snapshotProfile.add(cameraSnapshotJobs,
+                            snapshotProfileElapsedMs(phaseStart, phaseEnd),
+                            useParallelSnapshots);
+        snapshotProfile.logIfReady(phaseEnd);
+    }
 
-        // 5. 提交专属快照
-        syncBuffer->pushWorkingSnapshot();
+    // 5. 按收集顺序提交专属快照
+    for ( const auto& job : cameraSnapshotJobs ) {
+        job.syncBuffer->pushWorkingSnapshot();
     }
 }
 
@@ -0,0 +1,140 @@
+#include "logic/session/CommandCoalescer.h"
+
+#include <algorithm>
+#include <cmath>
+
+namespace MMM::Logic
+{
+
+CommandCoalescer::MergeRule CommandCoalescer::classify(
+    const LogicCommand& command, CommandKey& key)
+{
+    key = CommandKey{ command.index(), nullptr, 0 };
+    return std::visit(
+        [&key](const auto& value) {
+            using T = std::decay_t<decltype(value)>;
+            if constexpr ( std::is_same_v<T, CmdSetMousePosition> ) {
+                // 悬停/拖出状态决定是否接受坐标，只合并状态相同的更新。
+                key.cameraId = &value.cameraId;
+                key.flags    = (value.isHovering ? 1U : 0U) |
+                               (value.isDragging ? 2U : 0U) |
+                               (value.hoverTime >= 0.0 ? 4U : 0U);
+                return MergeRule::LastWins;
+            } else if constexpr ( std::is_same_v<T, CmdUpdateDrag> ) {
+                key.cameraId = &value.cameraId;
+                key.flags    = value.isCtrlDown ? 1U : 0U;
+                return MergeRule::LastWins;
+            } else if constexpr ( std::is_same_v<T, CmdUpdateViewport> ) {
+                key.cameraId = &value.cameraId;
+                return MergeRule::LastWins;
+            } else if constexpr ( std::is_same_v<T, CmdSetHoveredEntity> ||
+                                  std::is_same_v<T, CmdUpdateMarquee> ||
+                                  std::is_same_v<T, CmdSetPlaybackSpeed> ) {
+                return MergeRule::LastWins;
+            } else if constexpr ( std::is_same_v<T, CmdSeek> ) {
+                // 普通跳转会写状态栏消息，只有进度条预览是纯状态写入。
+                return value.isScrubbing ? MergeRule::LastWins
+                                         : MergeRule::Barrier;
+            } else if constexpr ( std::is_same_v<T, CmdScroll> ||
+                                  std::is_same_v<T, CmdPanCanvas> ) {
+                return MergeRule::Accumulate;
+            } else {
+                return MergeRule::Barrier;
+            }
+        },
+        command);
+}
+
+bool CommandCoalescer::accumulate(LogicCommand&       into,
+                                  const LogicCommand& next, bool scrollSnap)
+{
+    if ( auto* scroll = std::get_if<CmdScroll>(&into) ) {
+        const auto* nextScroll = std::get_if<CmdScroll>(&next);
+        if ( !nextScroll || nextScroll->cameraId != scroll->cameraId ||
+             nextScroll->isShiftDown != scroll->isShiftDown ||
+             nextScroll->intent != scroll->intent ) {
+            return false;
+        }
+        // 修饰键滚轮只触发“滚动停止播放”，重复执行没有额外效果。
+        if ( scroll->intent == ScrollCommandIntent::ModifierAdjustment ) {
+            return true;
+        }
+        // 吸附滚动按起点所在 BPM 段取整，跨段累加会偏离逐格结果；反向滚动
+        // 在时间边界处被截断后也不满足加法。
+        if ( scrollSnap || !std::isfinite(scroll->wheel) ||
+             !std::isfinite(nextScroll->wheel) ||
+             (scroll->wheel > 0.0F) != (nextScroll->wheel > 0.0F) ) {
+            return false;
+        }
+        scroll->wheel += nextScroll->wheel;
+        return true;
+    }
+
+    if ( auto* pan = std::get_if<CmdPanCanvas>(&into) ) {
+        const auto* nextPan = std::get_if<CmdPanCanvas>(&next);
+        if ( !nextPan || nextPan->cameraId != pan->cameraId ||
+             nextPan->viewportWidth != pan->viewportWidth ||
+             nextPan->viewportHeight != pan->viewportHeight ||
+             nextPan->renderScaleY != pan->renderScaleY ||
+             !std::isfinite(nextPan->deltaX) ||
+             !std::isfinite(nextPan->deltaY) ) {
+            return false;
+        }
+        // 纵向平移在 ScrollCache 的 AbsY 空间中线性叠加。
+        pan->deltaX += nextPan->deltaX;
+        pan->deltaY += nextPan->deltaY;
+        return true;
+    }
+    return false;
+}
+
+std::size_t CommandCoalescer::coalesce(std::vector<LogicCommand>& batch,
+                                       bool                       scrollSnap)
+{
+    if ( batch.size() < 2 ) return 0;
+    m_keep.assign(batch.size(), 1);
+    m_seenKeys.clear();
+
+    // 1. 逆序扫描：屏障区间内同目标的幂等命令只保留最后一条。
+    for ( std::size_t index = batch.size(); index-- > 0; ) {
+        CommandKey key;
+        const auto rule = classify(batch[index], key);
+        if ( rule == MergeRule::Barrier ) {
+            m_seenKeys.clear();
+            continue;
+        }
+        if ( rule != MergeRule::LastWins ) continue;
+        if ( std::find(m_seenKeys.begin(), m_seenKeys.end(), key) !=
+             m_seenKeys.end() ) {
+            m_keep[index] = 0;
+        } else {
+            m_seenKeys.push_back(key);
+        }
+    }
+
+    // 2. 正序扫描：相邻的同目标增量变换累加到前一条。
+    std::size_t previous = batch.size();
+    for ( std::size_t index = 0; index < batch.size(); ++index ) {
+        if ( !m_keep[index] ) continue;
+        if ( previous < batch.size() &&
+             accumulate(batch[previous], batch[index], scrollSnap) ) {
+            m_keep[index] = 0;
+            continue;
+        }
+        previous = index;
+    }
+
+    // 3. 保序压缩。
+    std::size_t write = 0;
+    for ( std::size_t index = 0; index < batch.size(); ++index ) {
+        if ( !m_keep[index] ) continue;
+        if ( write != index ) batch[write] = std::move(batch[index]);
+        ++write;
+    }
+    const std::size_t removed = batch.size() - write;
+    batch.erase(batch.begin() + static_cast<std::ptrdiff_t>(write),
+                batch.end());
+    return removed;
+}
+
+}  // namespace MMM::Logic
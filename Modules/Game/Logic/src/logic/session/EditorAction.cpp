@@ -1,16 +1,43 @@
 #include "logic/session/EditorAction.h"
+#include "config/Utf8Path.h"
 #include "config/skin/SkinConfig.h"
 #include "config/skin/translation/Translation.h"
+#include "log/colorful-log.h"
 #include "logic/BeatmapSession.h"
 #include "logic/ProjectDraftLaneService.h"
+#include "logic/session/EditorActionCodec.h"
 #include "logic/session/SessionUtils.h"
 #include "logic/session/context/SessionContext.h"
 
+#include <algorithm>
 #include <fmt/format.h>
+#include <limits>
+#include <miniz.h>
 
 namespace MMM::Logic
 {
 
+namespace
+{
+
+/// @brief 未覆写 memoryUsage 的操作使用的保守估算。
+constexpr std::size_t DEFAULT_ACTION_BYTES = 256;
+
+/// @brief 保存位置已随最旧历史一起丢弃时的标记。
+constexpr std::size_t NO_SAVE_INDEX = std::numeric_limits<std::size_t>::max();
+
+}  // namespace
+
+std::size_t IEditorAction::memoryUsage() const
+{
+    return DEFAULT_ACTION_BYTES;
+}
+
+EditorActionStack::~EditorActionStack()
+{
+    clear();
+}
+
 void EditorActionStack::pushAndExecute(std::unique_ptr<IEditorAction> action,
                                        SessionContext&                ctx)
 {
@@ -18,44 +45,74 @@ void EditorActionStack::pushAndExecute(std::unique_ptr<IEditorAction> action,
         "{} {}", TR("ui.status.category.action").data(), action->getName());
     action->execute(ctx);
     m_pendingMutationFlags |= action->mutationFlags();
-    m_undoStack.push_back(std::move(action));
+    HistoryEntry entry;
+    entry.flags       = action->mutationFlags();
+    entry.action      = std::move(action);
+    entry.memoryBytes = entryMemory(entry);
+    m_undoStack.push_back(std::move(entry));
     m_redoStack.clear();
     if ( ctx.m_needsTimingsSync || ctx.m_needsSamplesSync ) {
         SessionUtils::syncBeatmap(ctx);
     }
     ProjectDraftLaneService::sync(ctx);
+    enforceMemoryBudget();
 }
 
 void EditorActionStack::undo(SessionContext& ctx)
 {
     if ( m_undoStack.empty() ) return;
-    auto action = std::move(m_undoStack.back());
+    auto entry = std::move(m_undoStack.back());
     m_undoStack.pop_back();
-    ctx.lastActionMessage = fmt::format(
-        "{} {}", TR("ui.status.category.undo").data(), action->getName());
-    action->undo(ctx);
-    m_pendingMutationFlags |= action->mutationFlags();
-    m_redoStack.push_back(std::move(action));
+    if ( !restore(entry) ) {
+        // 更早的历史以本条为前提，无法再逐条撤销。
+        XERROR("Undo history entry could not be restored; dropping {} older "
+               "entries",
+               m_undoStack.size());
+        ctx.lastActionMessage = TR("ui.status.undo_history_lost").data();
+        dropOldestUndo(m_undoStack.size());
+        refreshUsage();
+        return;
+    }
+    ctx.lastActionMessage = fmt::format("{} {}",
+                                        TR("ui.status.category.undo").data(),
+                                        entry.action->getName());
+    entry.action->undo(ctx);
+    m_pendingMutationFlags |= entry.flags;
+    entry.memoryBytes = entryMemory(entry);
+    m_redoStack.push_back(std::move(entry));
     if ( ctx.m_needsTimingsSync || ctx.m_needsSamplesSync ) {
         SessionUtils::syncBeatmap(ctx);
     }
     ProjectDraftLaneService::sync(ctx);
+    enforceMemoryBudget();
 }
 
 void EditorActionStack::redo(SessionContext& ctx)
 {
     if ( m_redoStack.empty() ) return;
-    auto action = std::move(m_redoStack.back());
+    auto entry = std::move(m_redoStack.back());
     m_redoStack.pop_back();
-    ctx.lastActionMessage = fmt::format(
-        "{} {}", TR("ui.status.category.redo").data(), action->getName());
-    action->redo(ctx);
-    m_pendingMutationFlags |= action->mutationFlags();
-    m_undoStack.push_back(std::move(action));
+    if ( !restore(entry) ) {
+        XERROR("Redo history entry could not be restored; dropping {} later "
+               "entries",
+               m_redoStack.size());
+        ctx.lastActionMessage = TR("ui.status.undo_history_lost").data();
+        m_redoStack.clear();
+        refreshUsage();
+        return;
+    }
+    ctx.lastActionMessage = fmt::format("{} {}",
+                                        TR("ui.status.category.redo").data(),
+                                        entry.action->getName());
+    entry.action->redo(ctx);
+    m_pendingMutationFlags |= entry.flags;
+    entry.memoryBytes = entryMemory(entry);
+    m_undoStack.push_back(std::move(entry));
     if ( ctx.m_needsTimingsSync || ctx.m_needsSamplesSync ) {
         SessionUtils::syncBeatmap(ctx);
     }
     ProjectDraftLaneService::sync(ctx);
+    enforceMemoryBudget();
 }
 
 void EditorActionStack::clear()
@@ -65,6 +122,25 @@ void EditorActionStack::clear()
     m_saveIndex             = 0;
     m_hasNonUndoableChanges = false;
     m_pendingMutationFlags  = ::MMM::BeatmapMutationFlags::None;
+    m_memoryUsage           = 0;
+    m_spilledBytes          = 0;
+    if ( m_spillFile.is_open() ) {
+        m_spillFile.close();
+        std::error_code ec;
+        std::filesystem::remove(m_spillPath, ec);
+    }
+    m_spillEnd = 0;
+}
+
+void EditorActionStack::setSpillPath(std::filesystem::path path)
+{
+    if ( m_spillFile.is_open() ) {
+        m_spillFile.close();
+        std::error_code ec;
+        std::filesystem::remove(m_spillPath, ec);
+    }
+    m_spillPath = std::move(path);
+    m_spillEnd  = 0;
 }
 
 bool EditorActionStack::isDirty() const
@@ -93,13 +169,255 @@ void EditorActionStack::markDirty()
 ::MMM::BeatmapMutationFlags EditorActionStack::undoMutationFlags() const
 {
     return m_undoStack.empty() ? ::MMM::BeatmapMutationFlags::None
-                               : m_undoStack.back()->mutationFlags();
+                               : m_undoStack.back().flags;
 }
 
 ::MMM::BeatmapMutationFlags EditorActionStack::redoMutationFlags() const
 {
     return m_redoStack.empty() ? ::MMM::BeatmapMutationFlags::None
-                               : m_redoStack.back()->mutationFlags();
+                               : m_redoStack.back().flags;
+}
+
+bool EditorActionStack::restore(HistoryEntry& entry)
+{
+    if ( entry.action ) return true;
+    std::string packed;
+    if ( entry.spilled ) {
+        std::string compressed(entry.spillBytes, '\0');
+        m_spillFile.clear();
+        m_spillFile.seekg(static_cast<std::streamoff>(entry.spillOffset));
+        m_spillFile.read(compressed.data(),
+                         static_cast<std::streamsize>(compressed.size()));
+        if ( !m_spillFile ) return false;
+        packed.resize(entry.packedBytes);
+        mz_ulong packedSize = entry.packedBytes;
+        if ( mz_uncompress(reinterpret_cast<unsigned char*>(packed.data()),
+                           &packedSize,
+                           reinterpret_cast<const unsigned char*>(
+                               compressed.data()),
+                           static_cast<mz_ulong>(compressed.size())) !=
+                 MZ_OK ||
+             packedSize != entry.packedBytes ) {
+            return false;
+        }
+        entry.spilled = false;
+    } else {
+        packed = std::move(entry.packed);
+        entry.packed.clear();
+    }
+    entry.action = EditorActionCodec::decode(packed);
+    return entry.action != nullptr;
+}
+
+bool EditorActionStack::spill(HistoryEntry& entry)
+{
+    if ( m_spillPath.empty() || entry.packed.empty() ||
+         entry.packed.size() > std::numeric_limits<std::uint32_t>::max() ) {
+        return false;
+    }
+    if ( !m_spillFile.is_open() ) {
+        std::error_code ec;
+        std::filesystem::create_directories(m_spillPath.parent_path(), ec);
+        m_spillFile.open(m_spillPath,
+                         std::ios::in | std::ios::out | std::ios::binary |
+                             std::ios::trunc);
+        m_spillEnd = 0;
+        if ( !m_spillFile.is_open() ) {
+            XWARN("Failed to open undo spill file: {}",
+                  Config::pathToUtf8(m_spillPath));
+            m_spillPath.clear();
+            return false;
+        }
+    }
+
+    mz_ulong compressedSize =
+        mz_compressBound(static_cast<mz_ulong>(entry.packed.size()));
+    std::string compressed(compressedSize, '\0');
+    if ( mz_compress2(reinterpret_cast<unsigned char*>(compressed.data()),
+                      &compressedSize,
+                      reinterpret_cast<const unsigned char*>(
+                          entry.packed.data()),
+                      static_cast<mz_ulong>(entry.packed.size()),
+                      MZ_BEST_SPEED) != MZ_OK ) {
+        return false;
+    }
+    m_spillFile.clear();
+    m_spillFile.seekp(static_cast<std::streamoff>(m_spillEnd));
+    m_spillFile.write(compressed.data(),
+                      static_cast<std::streamsize>(compressedSize));
+    m_spillFile.flush();
+    if ( !m_spillFile ) {
+        XWARN("Failed to write undo spill file: {}",
+              Config::pathToUtf8(m_spillPath));
+        return false;
+    }
+
+    entry.spilled     = true;
+    entry.spillOffset = m_spillEnd;
+    entry.spillBytes  = static_cast<std::uint32_t>(compressedSize);
+    entry.packedBytes = static_cast<std::uint32_t>(entry.packed.size());
+    m_spillEnd += compressedSize;
+    std::string().swap(entry.packed);
+    return true;
+}
+
+void EditorActionStack::enforceMemoryBudget()
+{
+    // 1. 热区之外的活跃操作编码为紧凑字节流；超出预算时热区缩小到栈顶一条。
+    const auto packCold = [](std::vector<HistoryEntry>& stack,
+                             std::size_t                keep) {
+        if ( stack.size() <= keep ) return;
+        for ( std::size_t i = 0; i < stack.size() - keep; ++i ) {
+            auto& entry = stack[i];
+            if ( !entry.action || !entry.packable ) continue;
+            std::string packed;
+            if ( !EditorActionCodec::encode(*entry.action, packed) ) {
+                entry.packable = false;
+                continue;
+            }
+            packed.shrink_to_fit();
+            entry.packed = std::move(packed);
+            entry.action.reset();
+            entry.memoryBytes = entryMemory(entry);
+        }
+    };
+    packCold(m_undoStack, HOT_ENTRY_COUNT);
+    packCold(m_redoStack, HOT_ENTRY_COUNT);
+    refreshUsage();
+    if ( m_memoryBudget == 0 || m_memoryUsage <= m_memoryBudget ) return;
+    packCold(m_undoStack, 1);
+    packCold(m_redoStack, 1);
+    refreshUsage();
+
+    // 2. 按距当前状态由远到近溢出已编码条目：撤销栈底部，再到重做栈底部。
+    for ( auto* stack : { &m_undoStack, &m_redoStack } ) {
+        for ( auto& entry : *stack ) {
+            if ( m_memoryUsage <= m_memoryBudget ) break;
+            if ( entry.packed.empty() ) continue;
+            const std::size_t before = entry.memoryBytes;
+            if ( !spill(entry) ) break;
+            entry.memoryBytes = entryMemory(entry);
+            m_memoryUsage -= before - entry.memoryBytes;
+            m_spilledBytes += entry.spillBytes;
+        }
+    }
+
+    // 3. 仍超出预算时丢弃最旧的撤销历史与最远的重做历史，栈顶条目保留。
+    std::size_t dropCount = 0;
+    while ( m_memoryUsage > m_memoryBudget &&
+            dropCount + 1 < m_undoStack.size() ) {
+        m_memoryUsage -= m_undoStack[dropCount++].memoryBytes;
+    }
+    if ( dropCount > 0 ) {
+        XWARN("Undo history exceeded its memory budget; dropped {} entries",
+              dropCount);
+        dropOldestUndo(dropCount);
+    }
+    dropCount = 0;
+    while ( m_memoryUsage > m_memoryBudget &&
+            dropCount + 1 < m_redoStack.size() ) {
+        m_memoryUsage -= m_redoStack[dropCount++].memoryBytes;
+    }
+    m_redoStack.erase(m_redoStack.begin(),
+                      m_redoStack.begin() +
+                          static_cast<std::ptrdiff_t>(dropCount));
+    refreshUsage();
+}
+
+void EditorActionStack::dropOldestUndo(std::size_t count)
+{
+    m_undoStack.erase(m_undoStack.begin(),
+                      m_undoStack.begin() + static_cast<std::ptrdiff_t>(count));
+    if ( m_saveIndex != NO_SAVE_INDEX && m_saveIndex >= count ) {
+        m_saveIndex -= count;
+    } else {
+        m_saveIndex = NO_SAVE_INDEX;
+    }
+}
+
+void EditorActionStack::refreshUsage()
+{
+    m_memoryUsage  = 0;
+    m_spilledBytes = 0;
+    for ( const auto* stack : { &m_undoStack, &m_redoStack } ) {
+        for ( const auto& entry : *stack ) {
+            m_memoryUsage += entry.memoryBytes;
+            if ( entry.spilled ) m_spilledBytes += entry.spillBytes;
+        }
+    }
+    // 读回或丢弃的记录只留下空洞；失效部分多于有效记录时压缩，
+    // 文件大小不超过有效字节数的两倍加 SPILL_COMPACT_MIN_BYTES。
+    const std::uint64_t deadBytes = m_spillEnd - m_spilledBytes;
+    if ( m_spillFile.is_open() && m_spillEnd > 0 &&
+         (m_spilledBytes == 0 ||
+          deadBytes > std::max<std::uint64_t>(m_spilledBytes,
+                                              SPILL_COMPACT_MIN_BYTES)) ) {
+        compactSpillFile();
+    }
+}
+
+void EditorActionStack::compactSpillFile()
+{
+    std::vector<HistoryEntry*> spilled;
+    for ( auto* stack : { &m_undoStack, &m_redoStack } ) {
+        for ( auto& entry : *stack ) {
+            if ( entry.spilled ) spilled.push_back(&entry);
+        }
+    }
+    std::sort(spilled.begin(),
+              spilled.end(),
+              [](const HistoryEntry* lhs, const HistoryEntry* rhs) {
+                  return lhs->spillOffset < rhs->spillOffset;
+              });
+
+    // 按偏移升序前移，目标区间只会覆盖已搬走或已失效的字节。
+    std::string   buffer;
+    std::uint64_t writeOffset = 0;
+    for ( auto* entry : spilled ) {
+        if ( entry->spillOffset != writeOffset ) {
+            buffer.resize(entry->spillBytes);
+            m_spillFile.clear();
+            m_spillFile.seekg(static_cast<std::streamoff>(entry->spillOffset));
+            m_spillFile.read(buffer.data(),
+                             static_cast<std::streamsize>(buffer.size()));
+            m_spillFile.seekp(static_cast<std::streamoff>(writeOffset));
+            m_spillFile.write(buffer.data(),
+                              static_cast<std::streamsize>(buffer.size()));
+            if ( !m_spillFile ) {
+                XWARN("Failed to compact undo spill file: {}",
+                      Config::pathToUtf8(m_spillPath));
+                return;
+            }
+            entry->spillOffset = writeOffset;
+        }
+        writeOffset += entry->spillBytes;
+    }
+    m_spillEnd = writeOffset;
+
+    // 截断需要先释放句柄，Windows 上打开中的文件不能改变大小。
+    m_spillFile.close();
+    std::error_code ec;
+    std::filesystem::resize_file(m_spillPath, m_spillEnd, ec);
+    if ( ec ) {
+        XWARN("Failed to truncate undo spill file {}: {}",
+              Config::pathToUtf8(m_spillPath),
+              ec.message());
+    }
+    m_spillFile.open(m_spillPath,
+                     std::ios::in | std::ios::out | std::ios::binary);
+    if ( !m_spillFile.is_open() ) {
+        // 不能再以截断方式重新打开，否则会覆盖仍被引用的记录。
+        XWARN("Failed to reopen undo spill file: {}",
+              Config::pathToUtf8(m_spillPath));
+        m_spillPath.clear();
+    }
+}
+
+std::size_t EditorActionStack::entryMemory(const HistoryEntry& entry)
+{
+    std::size_t bytes = sizeof(HistoryEntry) + entry.packed.capacity();
+    if ( entry.action ) bytes += entry.action->memoryUsage();
+    return bytes;
 }
 
 void CompositeEditorAction::execute(SessionContext& ctx)
@@ -136,4 +454,12 @@ std::string CompositeEditorAction::getName() const
     return flags;
 }
 
+std::size_t CompositeEditorAction::memoryUsage() const
+{
+    std::size_t bytes = sizeof(CompositeEditorAction) + m_name.capacity() +
+                        m_actions.capacity() * sizeof(m_actions.front());
+    for ( const auto& action : m_actions ) bytes += action->memoryUsage();
+    return bytes;
+}
+
 }  // namespace MMM::Logic
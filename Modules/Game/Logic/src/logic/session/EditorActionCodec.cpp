@@ -0,0 +1,753 @@
+#include "logic/session/EditorActionCodec.h"
+#include "logic/ecs/components/NoteComponent.h"
+#include "logic/ecs/components/TimelineComponent.h"
+#include "logic/session/EditorAction.h"
+#include "logic/session/NoteAction.h"
+#include "logic/session/TimelineAction.h"
+
+#include <cstdint>
+#include <cstring>
+#include <limits>
+#include <optional>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+namespace MMM::Logic
+{
+
+namespace
+{
+
+/// @brief 字节流首字节记录的操作类型。
+enum class ActionKind : std::uint8_t {
+    Note,
+    BatchNote,
+    Timeline,
+    BatchTimeline,
+    Composite,
+};
+
+/// @brief 音符字段掩码；更新条目的变更前数据只写入掩码中的字段。
+enum NoteField : std::uint16_t {
+    NOTE_TYPE             = 1U << 0U,
+    NOTE_TIMESTAMP        = 1U << 1U,
+    NOTE_DURATION         = 1U << 2U,
+    NOTE_TRACK            = 1U << 3U,
+    NOTE_DTRACK           = 1U << 4U,
+    NOTE_SUB_NOTE         = 1U << 5U,
+    NOTE_DRAFT            = 1U << 6U,
+    NOTE_PARENT           = 1U << 7U,
+    NOTE_SUB_INDEX        = 1U << 8U,
+    NOTE_METADATA         = 1U << 9U,
+    NOTE_ANNOTATION       = 1U << 10U,
+    NOTE_SAMPLE_BINDING   = 1U << 11U,
+    NOTE_COLORS           = 1U << 12U,
+    NOTE_SUB_NOTES        = 1U << 13U,
+    NOTE_COLLABORATION_ID = 1U << 14U,
+    NOTE_ALL              = (1U << 15U) - 1U,
+};
+
+/// @brief 时间线字段掩码。
+enum TimelineField : std::uint8_t {
+    TIMELINE_TIMESTAMP = 1U << 0U,
+    TIMELINE_EFFECT    = 1U << 1U,
+    TIMELINE_VALUE     = 1U << 2U,
+    TIMELINE_METADATA  = 1U << 3U,
+    TIMELINE_ALL       = (1U << 4U) - 1U,
+};
+
+/// @brief 条目标志：是否携带变更前/后数据与选中状态。
+enum EntryFlag : std::uint8_t {
+    ENTRY_BEFORE              = 1U << 0U,
+    ENTRY_AFTER               = 1U << 1U,
+    ENTRY_BEFORE_SELECTED     = 1U << 2U,
+    ENTRY_BEFORE_SELECTED_SET = 1U << 3U,
+    ENTRY_AFTER_SELECTED      = 1U << 4U,
+    ENTRY_AFTER_SELECTED_SET  = 1U << 5U,
+};
+
+/// @brief 顺序追加的字节流写入器。
+class ActionWriter
+{
+public:
+    explicit ActionWriter(std::string& out) : m_out(out) {}
+
+    template<typename T> void pod(T value)
+    {
+        static_assert(std::is_trivially_copyable_v<T>);
+        m_out.append(reinterpret_cast<const char*>(&value), sizeof(T));
+    }
+
+    void flag(bool value) { pod(static_cast<std::uint8_t>(value ? 1 : 0)); }
+
+    template<typename E> void enumeration(E value)
+    {
+        pod(static_cast<std::uint8_t>(value));
+    }
+
+    void count(std::size_t value)
+    {
+        if ( value > std::numeric_limits<std::uint32_t>::max() ) m_ok = false;
+        pod(static_cast<std::uint32_t>(value));
+    }
+
+    void string(std::string_view text)
+    {
+        count(text.size());
+        m_out.append(text);
+    }
+
+    void entity(entt::entity value) { pod(entt::to_integral(value)); }
+
+    [[nodiscard]] bool ok() const { return m_ok; }
+
+private:
+    std::string& m_out;
+    bool         m_ok{ true };
+};
+
+/// @brief 带边界检查的字节流读取器；任一读取越界后 ok() 永久为 false。
+class ActionReader
+{
+public:
+    explicit ActionReader(std::string_view payload)
+        : m_cursor(payload.data()), m_end(payload.data() + payload.size())
+    {
+    }
+
+    template<typename T> T pod()
+    {
+        static_assert(std::is_trivially_copyable_v<T>);
+        T value{};
+        if ( remaining() < sizeof(T) ) {
+            m_ok = false;
+            return value;
+        }
+        std::memcpy(&value, m_cursor, sizeof(T));
+        m_cursor += sizeof(T);
+        return value;
+    }
+
+    bool flag() { return pod<std::uint8_t>() != 0; }
+
+    /// @brief 读取枚举值，超出 [0, last] 时判定字节流损坏。
+    template<typename E> E enumeration(E last)
+    {
+        const auto raw = pod<std::uint8_t>();
+        if ( raw > static_cast<std::uint8_t>(last) ) {
+            m_ok = false;
+            return E{};
+        }
+        return static_cast<E>(raw);
+    }
+
+    /// @brief 读取元素个数；每个元素至少占 minBytes 字节。
+    std::size_t count(std::size_t minBytes)
+    {
+        const std::size_t value = pod<std::uint32_t>();
+        if ( !m_ok || (minBytes > 0 && value > remaining() / minBytes) ) {
+            m_ok = false;
+            return 0;
+        }
+        return value;
+    }
+
+    std::string_view stringView()
+    {
+        const std::size_t size = count(1);
+        const char*       text = m_cursor;
+        m_cursor += size;
+        return { text, size };
+    }
+
+    std::string string() { return std::string(stringView()); }
+
+    entt::entity entity()
+    {
+        return entt::entity{ pod<std::underlying_type_t<entt::entity>>() };
+    }
+
+    /// @brief 标记字节流损坏。
+    void fail() { m_ok = false; }
+
+    [[nodiscard]] bool ok() const { return m_ok; }
+
+    [[nodiscard]] bool atEnd() const { return m_cursor == m_end; }
+
+private:
+    [[nodiscard]] std::size_t remaining() const
+    {
+        return static_cast<std::size_t>(m_end - m_cursor);
+    }
+
+    const char* m_cursor;
+    const char* m_end;
+    bool        m_ok{ true };
+};
+
+/// @brief 字符串超出内联容量时占用的堆字节数。
+std::size_t stringHeapBytes(const std::string& text)
+{
+    static const std::size_t INLINE_CAPACITY = std::string().capacity();
+    return text.capacity() > INLINE_CAPACITY ? text.capacity() + 1 : 0;
+}
+
+template<typename Source>
+void writeTable(ActionWriter& writer, const MetadataTable<Source>& table)
+{
+    writer.count(table.size());
+    for ( const auto& [source, properties] : table ) {
+        writer.enumeration(source);
+        writer.count(properties.size());
+        for ( const auto& entry : properties ) {
+            writer.string(entry.key());
+            writer.string(entry.second);
+        }
+    }
+}
+
+template<typename Source>
+void readTable(ActionReader& reader, MetadataTable<Source>& table, Source last)
+{
+    table.clear();
+    const std::size_t sources =
+        reader.count(sizeof(std::uint8_t) + sizeof(std::uint32_t));
+    for ( std::size_t i = 0; i < sources && reader.ok(); ++i ) {
+        const Source source  = reader.enumeration(last);
+        const auto   entries = reader.count(2 * sizeof(std::uint32_t));
+        if ( !reader.ok() ) return;
+        MetadataProperties& properties = table[source];
+        for ( std::size_t j = 0; j < entries && reader.ok(); ++j ) {
+            const std::string_view key   = reader.stringView();
+            std::string            value = reader.string();
+            if ( reader.ok() ) properties[key] = std::move(value);
+        }
+    }
+}
+
+void writeSampleBinding(ActionWriter&                                   writer,
+                        const std::optional<::MMM::AudioSampleBinding>& binding)
+{
+    writer.flag(binding.has_value());
+    if ( binding ) {
+        writer.string(binding->m_audioResourceId);
+        writer.pod(binding->m_volume);
+    }
+}
+
+std::optional<::MMM::AudioSampleBinding> readSampleBinding(
+    ActionReader& reader)
+{
+    if ( !reader.flag() ) return std::nullopt;
+    ::MMM::AudioSampleBinding binding;
+    binding.m_audioResourceId = reader.string();
+    binding.m_volume          = reader.pod<float>();
+    return binding;
+}
+
+bool sameSampleBinding(const std::optional<::MMM::AudioSampleBinding>& lhs,
+                       const std::optional<::MMM::AudioSampleBinding>& rhs)
+{
+    if ( lhs.has_value() != rhs.has_value() ) return false;
+    return !lhs || (lhs->m_audioResourceId == rhs->m_audioResourceId &&
+                    lhs->m_volume == rhs->m_volume);
+}
+
+/// @brief 按固定顺序访问自定义颜色的六个槽位。
+template<typename Colors, typename Visitor>
+void forEachColor(Colors& colors, Visitor&& visitor)
+{
+    visitor(colors.tap);
+    visitor(colors.head);
+    visitor(colors.hold);
+    visitor(colors.end);
+    visitor(colors.flickArrow);
+    visitor(colors.node);
+}
+
+void writeColors(ActionWriter& writer, const NoteColorOverrides& colors)
+{
+    std::uint8_t mask = 0;
+    std::uint8_t bit  = 1;
+    forEachColor(colors, [&](const std::optional<glm::vec4>& color) {
+        if ( color ) mask |= bit;
+        bit = static_cast<std::uint8_t>(bit << 1U);
+    });
+    writer.pod(mask);
+    forEachColor(colors, [&](const std::optional<glm::vec4>& color) {
+        if ( color ) writer.pod(*color);
+    });
+}
+
+NoteColorOverrides readColors(ActionReader& reader)
+{
+    NoteColorOverrides colors;
+    const auto         mask = reader.pod<std::uint8_t>();
+    std::uint8_t       bit  = 1;
+    forEachColor(colors, [&](std::optional<glm::vec4>& color) {
+        if ( (mask & bit) != 0 ) color = reader.pod<glm::vec4>();
+        bit = static_cast<std::uint8_t>(bit << 1U);
+    });
+    return colors;
+}
+
+bool sameColors(const NoteColorOverrides& lhs, const NoteColorOverrides& rhs)
+{
+    return lhs.tap == rhs.tap && lhs.head == rhs.head &&
+           lhs.hold == rhs.hold && lhs.end == rhs.end &&
+           lhs.flickArrow == rhs.flickArrow && lhs.node == rhs.node;
+}
+
+bool sameSubNotes(const std::vector<NoteComponent::SubNote>& lhs,
+                  const std::vector<NoteComponent::SubNote>& rhs)
+{
+    if ( lhs.size() != rhs.size() ) return false;
+    for ( std::size_t i = 0; i < lhs.size(); ++i ) {
+        const auto& a = lhs[i];
+        const auto& b = rhs[i];
+        if ( a.type != b.type || a.timestamp != b.timestamp ||
+             a.duration != b.duration || a.trackIndex != b.trackIndex ||
+             a.dtrack != b.dtrack || a.annotation != b.annotation ||
+             a.collaborationId != b.collaborationId ||
+             !(a.metadata.note_properties == b.metadata.note_properties) ||
+             !sameSampleBinding(a.sampleBinding, b.sampleBinding) ||
+             !sameColors(a.customColors, b.customColors) ) {
+            return false;
+        }
+    }
+    return true;
+}
+
+void writeSubNotes(ActionWriter&                              writer,
+                   const std::vector<NoteComponent::SubNote>& subNotes)
+{
+    writer.count(subNotes.size());
+    for ( const auto& subNote : subNotes ) {
+        writer.enumeration(subNote.type);
+        writer.pod(subNote.timestamp);
+        writer.pod(subNote.duration);
+        writer.pod(subNote.trackIndex);
+        writer.pod(subNote.dtrack);
+        writeTable(writer, subNote.metadata.note_properties);
+        writer.string(subNote.annotation);
+        writeSampleBinding(writer, subNote.sampleBinding);
+        writeColors(writer, subNote.customColors);
+        writer.string(subNote.collaborationId);
+    }
+}
+
+std::vector<NoteComponent::SubNote> readSubNotes(ActionReader& reader)
+{
+    // 单个子物件至少包含类型、两个时间、两个轨道与四个长度前缀。
+    constexpr std::size_t MIN_SUB_NOTE_BYTES =
+        1 + 2 * sizeof(double) + 2 * sizeof(int) + 4 * sizeof(std::uint32_t);
+    std::vector<NoteComponent::SubNote> subNotes(
+        reader.count(MIN_SUB_NOTE_BYTES));
+    for ( auto& subNote : subNotes ) {
+        subNote.type       = reader.enumeration(::MMM::NoteType::POLYLINE);
+        subNote.timestamp  = reader.pod<double>();
+        subNote.duration   = reader.pod<double>();
+        subNote.trackIndex = reader.pod<int>();
+        subNote.dtrack     = reader.pod<int>();
+        readTable(reader,
+                  subNote.metadata.note_properties,
+                  ::MMM::NoteMetadataType::MMM);
+        subNote.annotation      = reader.string();
+        subNote.sampleBinding   = readSampleBinding(reader);
+        subNote.customColors    = readColors(reader);
+        subNote.collaborationId = reader.string();
+    }
+    return subNotes;
+}
+
+/// @brief 计算 note 相对 base 不同的字段掩码。
+std::uint16_t noteDifference(const NoteComponent& base,
+                             const NoteComponent& note)
+{
+    std::uint16_t mask = 0;
+    if ( note.m_type != base.m_type ) mask |= NOTE_TYPE;
+    if ( note.m_timestamp != base.m_timestamp ) mask |= NOTE_TIMESTAMP;
+    if ( note.m_duration != base.m_duration ) mask |= NOTE_DURATION;
+    if ( note.m_trackIndex != base.m_trackIndex ) mask |= NOTE_TRACK;
+    if ( note.m_dtrack != base.m_dtrack ) mask |= NOTE_DTRACK;
+    if ( note.m_isSubNote != base.m_isSubNote ) mask |= NOTE_SUB_NOTE;
+    if ( note.m_isDraft != base.m_isDraft ) mask |= NOTE_DRAFT;
+    if ( note.m_parentPolyline != base.m_parentPolyline ) mask |= NOTE_PARENT;
+    if ( note.m_subIndex != base.m_subIndex ) mask |= NOTE_SUB_INDEX;
+    if ( !(note.m_metadata.note_properties ==
+           base.m_metadata.note_properties) ) {
+        mask |= NOTE_METADATA;
+    }
+    if ( note.m_annotation != base.m_annotation ) mask |= NOTE_ANNOTATION;
+    if ( !sameSampleBinding(note.m_sampleBinding, base.m_sampleBinding) ) {
+        mask |= NOTE_SAMPLE_BINDING;
+    }
+    if ( !sameColors(note.m_customColors, base.m_customColors) ) {
+        mask |= NOTE_COLORS;
+    }
+    if ( !sameSubNotes(note.m_subNotes, base.m_subNotes) ) {
+        mask |= NOTE_SUB_NOTES;
+    }
+    if ( note.m_collaborationId != base.m_collaborationId ) {
+        mask |= NOTE_COLLABORATION_ID;
+    }
+    return mask;
+}
+
+/// @brief 写入掩码及掩码中的音符字段。
+void writeNoteFields(ActionWriter& writer, const NoteComponent& note,
+                     std::uint16_t mask)
+{
+    writer.pod(mask);
+    if ( mask & NOTE_TYPE ) writer.enumeration(note.m_type);
+    if ( mask & NOTE_TIMESTAMP ) writer.pod(note.m_timestamp);
+    if ( mask & NOTE_DURATION ) writer.pod(note.m_duration);
+    if ( mask & NOTE_TRACK ) writer.pod(note.m_trackIndex);
+    if ( mask & NOTE_DTRACK ) writer.pod(note.m_dtrack);
+    if ( mask & NOTE_SUB_NOTE ) writer.flag(note.m_isSubNote);
+    if ( mask & NOTE_DRAFT ) writer.flag(note.m_isDraft);
+    if ( mask & NOTE_PARENT ) writer.entity(note.m_parentPolyline);
+    if ( mask & NOTE_SUB_INDEX ) writer.pod(note.m_subIndex);
+    if ( mask & NOTE_METADATA ) {
+        writeTable(writer, note.m_metadata.note_properties);
+    }
+    if ( mask & NOTE_ANNOTATION ) writer.string(note.m_annotation);
+    if ( mask & NOTE_SAMPLE_BINDING ) {
+        writeSampleBinding(writer, note.m_sampleBinding);
+    }
+    if ( mask & NOTE_COLORS ) writeColors(writer, note.m_customColors);
+    if ( mask & NOTE_SUB_NOTES ) writeSubNotes(writer, note.m_subNotes);
+    if ( mask & NOTE_COLLABORATION_ID ) writer.string(note.m_collaborationId);
+}
+
+/// @brief 读取掩码并覆盖 note 中对应字段，其余字段保持不变。
+void readNoteFields(ActionReader& reader, NoteComponent& note)
+{
+    const auto mask = reader.pod<std::uint16_t>();
+    if ( (mask & ~static_cast<std::uint16_t>(NOTE_ALL)) != 0 ) {
+        reader.fail();
+        return;
+    }
+    if ( mask & NOTE_TYPE ) {
+        note.m_type = reader.enumeration(::MMM::NoteType::POLYLINE);
+    }
+    if ( mask & NOTE_TIMESTAMP ) note.m_timestamp = reader.pod<double>();
+    if ( mask & NOTE_DURATION ) note.m_duration = reader.pod<double>();
+    if ( mask & NOTE_TRACK ) note.m_trackIndex = reader.pod<int>();
+    if ( mask & NOTE_DTRACK ) note.m_dtrack = reader.pod<int>();
+    if ( mask & NOTE_SUB_NOTE ) note.m_isSubNote = reader.flag();
+    if ( mask & NOTE_DRAFT ) note.m_isDraft = reader.flag();
+    if ( mask & NOTE_PARENT ) note.m_parentPolyline = reader.entity();
+    if ( mask & NOTE_SUB_INDEX ) note.m_subIndex = reader.pod<int>();
+    if ( mask & NOTE_METADATA ) {
+        readTable(reader,
+                  note.m_metadata.note_properties,
+                  ::MMM::NoteMetadataType::MMM);
+    }
+    if ( mask & NOTE_ANNOTATION ) note.m_annotation = reader.string();
+    if ( mask & NOTE_SAMPLE_BINDING ) {
+        note.m_sampleBinding = readSampleBinding(reader);
+    }
+    if ( mask & NOTE_COLORS ) note.m_customColors = readColors(reader);
+    if ( mask & NOTE_SUB_NOTES ) note.m_subNotes = readSubNotes(reader);
+    if ( mask & NOTE_COLLABORATION_ID ) {
+        note.m_collaborationId = reader.string();
+    }
+}
+
+/// @brief 写入一对变更前/后音符；两者都存在时变更前只写差异字段。
+void writeNotePair(ActionWriter& writer, std::uint8_t extraFlags,
+                   const std::optional<NoteComponent>& before,
+                   const std::optional<NoteComponent>& after)
+{
+    std::uint8_t flags = extraFlags;
+    if ( before ) flags |= ENTRY_BEFORE;
+    if ( after ) flags |= ENTRY_AFTER;
+    writer.pod(flags);
+    if ( after ) writeNoteFields(writer, *after, NOTE_ALL);
+    if ( before ) {
+        writeNoteFields(
+            writer, *before, after ? noteDifference(*after, *before) : NOTE_ALL);
+    }
+}
+
+/// @brief 读取 writeNotePair 写入的一对音符。
+/// @return 条目标志。
+std::uint8_t readNotePair(ActionReader& reader,
+                          std::optional<NoteComponent>& before,
+                          std::optional<NoteComponent>& after)
+{
+    const auto flags = reader.pod<std::uint8_t>();
+    if ( flags & ENTRY_AFTER ) {
+        after.emplace();
+        readNoteFields(reader, *after);
+    }
+    if ( flags & ENTRY_BEFORE ) {
+        before = after ? *after : NoteComponent{};
+        readNoteFields(reader, *before);
+    }
+    return flags;
+}
+
+std::uint8_t timelineDifference(const TimelineComponent& base,
+                                const TimelineComponent& timeline)
+{
+    std::uint8_t mask = 0;
+    if ( timeline.m_timestamp != base.m_timestamp ) {
+        mask |= TIMELINE_TIMESTAMP;
+    }
+    if ( timeline.m_effect != base.m_effect ) mask |= TIMELINE_EFFECT;
+    if ( timeline.m_value != base.m_value ) mask |= TIMELINE_VALUE;
+    if ( !(timeline.m_metadata.timing_properties ==
+           base.m_metadata.timing_properties) ) {
+        mask |= TIMELINE_METADATA;
+    }
+    return mask;
+}
+
+void writeTimelineFields(ActionWriter& writer, const TimelineComponent& timeline,
+                         std::uint8_t mask)
+{
+    writer.pod(mask);
+    if ( mask & TIMELINE_TIMESTAMP ) writer.pod(timeline.m_timestamp);
+    if ( mask & TIMELINE_EFFECT ) writer.enumeration(timeline.m_effect);
+    if ( mask & TIMELINE_VALUE ) writer.pod(timeline.m_value);
+    if ( mask & TIMELINE_METADATA ) {
+        writeTable(writer, timeline.m_metadata.timing_properties);
+    }
+}
+
+void readTimelineFields(ActionReader& reader, TimelineComponent& timeline)
+{
+    const auto mask = reader.pod<std::uint8_t>();
+    if ( mask & TIMELINE_TIMESTAMP ) {
+        timeline.m_timestamp = reader.pod<double>();
+    }
+    if ( mask & TIMELINE_EFFECT ) {
+        timeline.m_effect = reader.enumeration(::MMM::TimingEffect::HS);
+    }
+    if ( mask & TIMELINE_VALUE ) timeline.m_value = reader.pod<double>();
+    if ( mask & TIMELINE_METADATA ) {
+        readTable(reader,
+                  timeline.m_metadata.timing_properties,
+                  ::MMM::TimingMetadataType::MALODY);
+    }
+}
+
+void writeTimelinePair(ActionWriter&                           writer,
+                       const std::optional<TimelineComponent>& before,
+                       const std::optional<TimelineComponent>& after)
+{
+    std::uint8_t flags = 0;
+    if ( before ) flags |= ENTRY_BEFORE;
+    if ( after ) flags |= ENTRY_AFTER;
+    writer.pod(flags);
+    if ( after ) writeTimelineFields(writer, *after, TIMELINE_ALL);
+    if ( before ) {
+        writeTimelineFields(writer,
+                            *before,
+                            after ? timelineDifference(*after, *before)
+                                  : TIMELINE_ALL);
+    }
+}
+
+void readTimelinePair(ActionReader&                     reader,
+                      std::optional<TimelineComponent>& before,
+                      std::optional<TimelineComponent>& after)
+{
+    const auto flags = reader.pod<std::uint8_t>();
+    if ( flags & ENTRY_AFTER ) {
+        after.emplace();
+        readTimelineFields(reader, *after);
+    }
+    if ( flags & ENTRY_BEFORE ) {
+        before = after ? *after : TimelineComponent{};
+        readTimelineFields(reader, *before);
+    }
+}
+
+}  // namespace
+
+/// @brief 访问各操作私有状态的编码实现。
+struct EditorActionCodecAccess {
+    static bool encode(ActionWriter& writer, const IEditorAction& action);
+    static std::unique_ptr<IEditorAction> decode(ActionReader& reader);
+};
+
+bool EditorActionCodecAccess::encode(ActionWriter&        writer,
+                                     const IEditorAction& action)
+{
+    if ( const auto* note = dynamic_cast<const NoteAction*>(&action) ) {
+        writer.enumeration(ActionKind::Note);
+        writer.enumeration(note->m_type);
+        writer.entity(note->m_entity);
+        writeNotePair(writer, 0, note->m_before, note->m_after);
+        return writer.ok();
+    }
+    if ( const auto* batch = dynamic_cast<const BatchNoteAction*>(&action) ) {
+        writer.enumeration(ActionKind::BatchNote);
+        writer.string(batch->m_name);
+        writer.pod(static_cast<std::uint8_t>(batch->m_mutationFlags));
+        writer.count(batch->m_entries.size());
+        for ( const auto& entry : batch->m_entries ) {
+            std::uint8_t selection = 0;
+            if ( entry.beforeSelected ) {
+                selection |= ENTRY_BEFORE_SELECTED_SET;
+                if ( *entry.beforeSelected ) selection |= ENTRY_BEFORE_SELECTED;
+            }
+            if ( entry.afterSelected ) {
+                selection |= ENTRY_AFTER_SELECTED_SET;
+                if ( *entry.afterSelected ) selection |= ENTRY_AFTER_SELECTED;
+            }
+            writer.entity(entry.entity);
+            writeNotePair(writer, selection, entry.before, entry.after);
+        }
+        return writer.ok();
+    }
+    if ( const auto* timeline = dynamic_cast<const TimelineAction*>(&action) ) {
+        writer.enumeration(ActionKind::Timeline);
+        writer.enumeration(timeline->m_type);
+        writer.entity(timeline->m_entity);
+        writeTimelinePair(writer, timeline->m_before, timeline->m_after);
+        return writer.ok();
+    }
+    if ( const auto* batch =
+             dynamic_cast<const BatchTimelineAction*>(&action) ) {
+        writer.enumeration(ActionKind::BatchTimeline);
+        writer.string(batch->m_name);
+        writer.count(batch->m_entries.size());
+        for ( const auto& entry : batch->m_entries ) {
+            writer.entity(entry.entity);
+            writeTimelinePair(writer, entry.before, entry.after);
+        }
+        return writer.ok();
+    }
+    if ( const auto* composite =
+             dynamic_cast<const CompositeEditorAction*>(&action) ) {
+        writer.enumeration(ActionKind::Composite);
+        writer.string(composite->m_name);
+        writer.count(composite->m_actions.size());
+        for ( const auto& child : composite->m_actions ) {
+            if ( !encode(writer, *child) ) return false;
+        }
+        return writer.ok();
+    }
+    return false;
+}
+
+std::unique_ptr<IEditorAction> EditorActionCodecAccess::decode(
+    ActionReader& reader)
+{
+    switch ( reader.enumeration(ActionKind::Composite) ) {
+    case ActionKind::Note: {
+        const auto type   = reader.enumeration(NoteAction::Type::Delete);
+        const auto entity = reader.entity();
+        // 不经构造函数清理协作标识：保留执行时分配的标识。
+        auto action = std::make_unique<NoteAction>(
+            type, entity, std::nullopt, std::nullopt);
+        readNotePair(reader, action->m_before, action->m_after);
+        return reader.ok() ? std::move(action) : nullptr;
+    }
+    case ActionKind::BatchNote: {
+        std::string name  = reader.string();
+        const auto  flags = static_cast<::MMM::BeatmapMutationFlags>(
+            reader.pod<std::uint8_t>());
+        std::vector<BatchNoteAction::Entry> entries(
+            reader.count(sizeof(std::uint32_t) + 1));
+        for ( auto& entry : entries ) {
+            entry.entity = reader.entity();
+            const auto selection =
+                readNotePair(reader, entry.before, entry.after);
+            if ( selection & ENTRY_BEFORE_SELECTED_SET ) {
+                entry.beforeSelected = (selection & ENTRY_BEFORE_SELECTED) != 0;
+            }
+            if ( selection & ENTRY_AFTER_SELECTED_SET ) {
+                entry.afterSelected = (selection & ENTRY_AFTER_SELECTED) != 0;
+            }
+        }
+        auto action = std::make_unique<BatchNoteAction>(
+            std::vector<BatchNoteAction::Entry>{}, std::move(name), flags);
+        action->m_entries = std::move(entries);
+        return reader.ok() ? std::move(action) : nullptr;
+    }
+    case ActionKind::Timeline: {
+        const auto type   = reader.enumeration(TimelineAction::Type::Update);
+        const auto entity = reader.entity();
+        auto       action = std::make_unique<TimelineAction>(
+            type, entity, std::nullopt, std::nullopt);
+        readTimelinePair(reader, action->m_before, action->m_after);
+        return reader.ok() ? std::move(action) : nullptr;
+    }
+    case ActionKind::BatchTimeline: {
+        std::string name = reader.string();
+        std::vector<BatchTimelineAction::Entry> entries(
+            reader.count(sizeof(std::uint32_t) + 1));
+        for ( auto& entry : entries ) {
+            entry.entity = reader.entity();
+            readTimelinePair(reader, entry.before, entry.after);
+        }
+        if ( !reader.ok() ) return nullptr;
+        return std::make_unique<BatchTimelineAction>(std::move(entries),
+                                                     std::move(name));
+    }
+    case ActionKind::Composite: {
+        std::string name = reader.string();
+        std::vector<std::unique_ptr<IEditorAction>> actions(reader.count(1));
+        for ( auto& child : actions ) {
+            child = decode(reader);
+            if ( !child ) return nullptr;
+        }
+        if ( !reader.ok() ) return nullptr;
+        return std::make_unique<CompositeEditorAction>(std::move(actions),
+                                                       std::move(name));
+    }
+    }
+    return nullptr;
+}
+
+bool EditorActionCodec::encode(const IEditorAction& action, std::string& out)
+{
+    out.clear();
+    ActionWriter writer(out);
+    return EditorActionCodecAccess::encode(writer, action);
+}
+
+std::unique_ptr<IEditorAction> EditorActionCodec::decode(
+    std::string_view payload)
+{
+    ActionReader reader(payload);
+    auto         action = EditorActionCodecAccess::decode(reader);
+    if ( !reader.ok() || !reader.atEnd() ) return nullptr;
+    return action;
+}
+
+std::size_t EditorActionCodec::estimateBytes(const NoteComponent& note)
+{
+    std::size_t bytes = sizeof(NoteComponent) +
+                        note.m_metadata.note_properties.heapBytes() +
+                        stringHeapBytes(note.m_annotation) +
+                        stringHeapBytes(note.m_collaborationId) +
+                        note.m_subNotes.capacity() *
+                            sizeof(NoteComponent::SubNote);
+    if ( note.m_sampleBinding ) {
+        bytes += stringHeapBytes(note.m_sampleBinding->m_audioResourceId);
+    }
+    for ( const auto& subNote : note.m_subNotes ) {
+        bytes += subNote.metadata.note_properties.heapBytes() +
+                 stringHeapBytes(subNote.annotation) +
+                 stringHeapBytes(subNote.collaborationId);
+        if ( subNote.sampleBinding ) {
+            bytes += stringHeapBytes(subNote.sampleBinding->m_audioResourceId);
+        }
+    }
+    return bytes;
+}
+
+std::size_t EditorActionCodec::estimateBytes(const TimelineComponent& timeline)
+{
+    return sizeof(TimelineComponent) +
+           timeline.m_metadata.timing_properties.heapBytes();
+}
+
+}  // namespace MMM::Logic
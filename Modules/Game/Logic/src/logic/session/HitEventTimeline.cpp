@@ -0,0 +1,272 @@
+#include "logic/session/HitEventTimeline.h"
+
+#include <algorithm>
+#include <cstdlib>
+#include <functional>
+#include <mutex>
+#include <unordered_set>
+
+namespace MMM::Logic
+{
+
+namespace
+{
+
+using HitEvent = HitEventTimeline::HitEvent;
+using HitRole  = HitEvent::Role;
+
+/// @brief 支持以 string_view 直接查找的字符串哈希。
+struct StringViewHash {
+    using is_transparent = void;
+
+    std::size_t operator()(std::string_view value) const noexcept
+    {
+        return std::hash<std::string_view>{}(value);
+    }
+};
+
+/// @brief 把可选采样绑定写入事件；空资源视为未绑定。
+void assignSampleBinding(
+    HitEvent& event, const std::optional<::MMM::AudioSampleBinding>& binding)
+{
+    if ( !binding ) return;
+    event.sampleResource = internSampleResource(binding->m_audioResourceId);
+    if ( event.sampleResource ) event.sampleVolume = binding->m_volume;
+}
+
+/// @brief 音符及其折线子物件的最晚结束时间，与原全量重建的口径一致。
+double noteEndTime(const NoteComponent& note)
+{
+    double endTime = note.m_timestamp + note.m_duration;
+    if ( note.m_type == ::MMM::NoteType::POLYLINE ) {
+        for ( const auto& sub : note.m_subNotes ) {
+            endTime = std::max(endTime, sub.timestamp + sub.duration);
+        }
+    }
+    return endTime;
+}
+
+/// @brief 事件时间早于给定时间。
+bool startsBefore(const HitEvent& event, double time)
+{
+    return event.timestamp < time;
+}
+
+/// @brief 给定时间早于事件时间。
+bool startsAfter(double time, const HitEvent& event)
+{
+    return time < event.timestamp;
+}
+
+}  // namespace
+
+const std::string* internSampleResource(std::string_view resourceId)
+{
+    if ( resourceId.empty() ) return nullptr;
+
+    // 节点式容器在扩容时不移动元素，返回的地址在进程生命周期内有效。
+    static std::mutex poolMutex;
+    static std::unordered_set<std::string, StringViewHash, std::equal_to<>>
+        pool;
+
+    std::lock_guard<std::mutex> lock(poolMutex);
+    auto                        found = pool.find(resourceId);
+    if ( found == pool.end() ) {
+        found = pool.emplace(resourceId).first;
+    }
+    return &*found;
+}
+
+void HitEventTimeline::appendNoteEvents(entt::entity          entity,
+                                        const NoteComponent&  note,
+                                        std::vector<HitEvent>& out)
+{
+    if ( note.m_isDraft || note.m_isSubNote ) return;
+
+    if ( note.m_type == ::MMM::NoteType::POLYLINE ) {
+        const std::size_t count = note.m_subNotes.size();
+        for ( std::size_t index = 0; index < count; ++index ) {
+            const auto& sub  = note.m_subNotes[index];
+            HitRole     role = HitRole::Internal;
+            if ( index == 0 ) {
+                role = HitRole::Head;
+            } else if ( index + 1 == count ) {
+                role = HitRole::Tail;
+            }
+            const int span = sub.type == ::MMM::NoteType::FLICK
+                                 ? std::abs(sub.dtrack) + 1
+                                 : 1;
+
+            HitEvent event{ sub.timestamp,
+                            sub.type,
+                            role,
+                            span,
+                            sub.trackIndex,
+                            sub.dtrack,
+                            sub.duration,
+                            true };
+            assignSampleBinding(event,
+                                sub.sampleBinding || role != HitRole::Head
+                                    ? sub.sampleBinding
+                                    : note.m_sampleBinding);
+            event.entity   = entity;
+            event.subIndex = static_cast<std::int32_t>(index);
+            out.push_back(event);
+        }
+        return;
+    }
+
+    const int span =
+        note.m_type == ::MMM::NoteType::FLICK ? std::abs(note.m_dtrack) + 1 : 1;
+    HitEvent event{ note.m_timestamp,
+                    note.m_type,
+                    HitRole::None,
+                    span,
+                    note.m_trackIndex,
+                    note.m_dtrack,
+                    note.m_duration,
+                    false };
+    assignSampleBinding(event, note.m_sampleBinding);
+    event.entity = entity;
+    out.push_back(event);
+}
+
+bool HitEventTimeline::keyLess(const HitEvent& lhs, const HitEvent& rhs)
+{
+    if ( lhs.timestamp != rhs.timestamp ) return lhs.timestamp < rhs.timestamp;
+    if ( lhs.entity != rhs.entity ) {
+        return entt::to_integral(lhs.entity) < entt::to_integral(rhs.entity);
+    }
+    return lhs.subIndex < rhs.subIndex;
+}
+
+double HitEventTimeline::rebuild(const entt::registry& noteRegistry)
+{
+    clear();
+    double     maxEndTime = 0.0;
+    const auto view       = noteRegistry.view<const NoteComponent>();
+    m_events.reserve(view.size());
+    for ( const auto entity : view ) {
+        const auto& note = view.get<const NoteComponent>(entity);
+        if ( note.m_isSubNote || note.m_isDraft ) continue;
+        maxEndTime = std::max(maxEndTime, noteEndTime(note));
+        appendNoteEvents(entity, note, m_events);
+    }
+    std::sort(m_events.begin(), m_events.end(), keyLess);
+    recordSpans(m_events);
+    return maxEndTime;
+}
+
+double HitEventTimeline::apply(const entt::registry&         noteRegistry,
+                               std::span<const entt::entity> entities)
+{
+    std::vector<entt::entity> changed(entities.begin(), entities.end());
+    std::sort(changed.begin(),
+              changed.end(),
+              [](entt::entity lhs, entt::entity rhs) {
+                  return entt::to_integral(lhs) < entt::to_integral(rhs);
+              });
+    changed.erase(std::unique(changed.begin(), changed.end()), changed.end());
+
+    // 1. 删除旧事件：少量变更只在各自的时间跨度内过滤，大批量一次过滤全表。
+    if ( changed.size() <= SMALL_BATCH_SIZE ) {
+        for ( const auto entity : changed ) {
+            const auto found = m_spanOf.find(entity);
+            if ( found == m_spanOf.end() ) continue;
+            const auto [firstTime, lastTime] = found->second;
+            const auto first = std::lower_bound(
+                m_events.begin(), m_events.end(), firstTime, startsBefore);
+            const auto last =
+                std::upper_bound(first, m_events.end(), lastTime, startsAfter);
+            m_events.erase(std::remove_if(first,
+                                          last,
+                                          [entity](const HitEvent& event) {
+                                              return event.entity == entity;
+                                          }),
+                           last);
+            m_spanOf.erase(found);
+        }
+    } else {
+        std::unordered_set<entt::entity> removed;
+        removed.reserve(changed.size());
+        for ( const auto entity : changed ) {
+            if ( m_spanOf.erase(entity) > 0 ) removed.insert(entity);
+        }
+        if ( !removed.empty() ) {
+            std::erase_if(m_events, [&](const HitEvent& event) {
+                return removed.contains(event.entity);
+            });
+        }
+    }
+
+    // 2. 按当前组件生成新事件，少量逐条插入，大批量排序后与原序列归并。
+    std::vector<HitEvent> added;
+    double                maxEndTime = 0.0;
+    for ( const auto entity : changed ) {
+        if ( !noteRegistry.valid(entity) ) continue;
+        const auto* note = noteRegistry.try_get<const NoteComponent>(entity);
+        if ( !note || note->m_isSubNote || note->m_isDraft ) continue;
+        maxEndTime = std::max(maxEndTime, noteEndTime(*note));
+        appendNoteEvents(entity, *note, added);
+    }
+    if ( added.empty() ) return maxEndTime;
+
+    std::sort(added.begin(), added.end(), keyLess);
+    recordSpans(added);
+    if ( added.size() <= SMALL_BATCH_SIZE ) {
+        for ( const auto& event : added ) {
+            m_events.insert(std::upper_bound(
+                                m_events.begin(), m_events.end(), event, keyLess),
+                            event);
+        }
+    } else {
+        const auto middle = static_cast<std::ptrdiff_t>(m_events.size());
+        m_events.insert(m_events.end(), added.begin(), added.end());
+        std::inplace_merge(m_events.begin(),
+                           m_events.begin() + middle,
+                           m_events.end(),
+                           keyLess);
+    }
+    return maxEndTime;
+}
+
+void HitEventTimeline::clear()
+{
+    m_events.clear();
+    m_spanOf.clear();
+}
+
+void HitEventTimeline::recordSpans(std::span<const HitEvent> added)
+{
+    for ( const auto& event : added ) {
+        const auto [found, inserted] = m_spanOf.try_emplace(
+            event.entity, event.timestamp, event.timestamp);
+        if ( !inserted ) {
+            found->second.first =
+                std::min(found->second.first, event.timestamp);
+            found->second.second =
+                std::max(found->second.second, event.timestamp);
+        }
+    }
+}
+
+bool HitEventTimeline::isConsistent() const
+{
+    if ( !std::is_sorted(m_events.begin(), m_events.end(), keyLess) ) {
+        return false;
+    }
+    std::unordered_map<entt::entity, std::pair<double, double>> spans;
+    for ( const auto& event : m_events ) {
+        const auto [found, inserted] = spans.try_emplace(
+            event.entity, event.timestamp, event.timestamp);
+        if ( !inserted ) {
+            found->second.first =
+                std::min(found->second.first, event.timestamp);
+            found->second.second =
+                std::max(found->second.second, event.timestamp);
+        }
+    }
+    return spans == m_spanOf;
+}
+
+}  // namespace MMM::Logic
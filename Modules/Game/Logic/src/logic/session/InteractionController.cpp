@@ -758,18 +758,6 @@ bool sampleMatchesSelection(const SampleComponent&        sample,
         selection, makeSampleScreenRect(sample, screen), mode);
 }
 
-/// @brief 获取实体的主时间戳，失效实体排序到末尾。
-/// @warning 逻辑热路径：框选候选二分时调用，只做 registry 有效性检查。
-double getNoteStartTimeForSelection(const SessionContext& ctx,
-                                    entt::entity          entity)
-{
-    if ( !ctx.noteRegistry.valid(entity) ||
-         !ctx.noteRegistry.all_of<NoteComponent>(entity) ) {
-        return std::numeric_limits<double>::infinity();
-    }
-    return ctx.noteRegistry.get<const NoteComponent>(entity).m_timestamp;
-}
-
 /// @brief 收集所有主音符实体作为候选。
 /// @warning 逻辑热路径兜底：只在排序缓存不可用时完整扫描 NoteComponent。
 void collectAllPrimaryNoteCandidates(
@@ -787,16 +775,15 @@ void collectAllPrimaryNoteCandidates(
 }
 
 /// @brief 根据单个框选框的时间范围收集排序缓存中的候选实体。
-/// @warning 逻辑热路径：框选更新时按框数量执行二分和局部线性扫描。
+/// @warning 逻辑热路径：框选更新时按框数量查询时间区间索引。
 bool collectMarqueeBoxCandidates(
     SessionContext& ctx, const PreparedMarqueeBox& box,
     std::vector<MarqueeSelectionCandidate>& candidates,
     std::unordered_set<entt::entity>&       seen)
 {
-    const auto& entities     = ctx.sortedNoteEntities;
-    const auto& maxEndPrefix = ctx.sortedNoteMaxEndPrefix;
-    if ( entities.empty() || maxEndPrefix.size() != entities.size() ||
-         !box.screen.valid || !box.screen.cache || !box.rect.valid ) {
+    const auto& index = ctx.noteVisibilityIndex;
+    if ( index.empty() || !box.screen.valid || !box.screen.cache ||
+         !box.rect.valid ) {
         return false;
     }
 
@@ -808,47 +795,25 @@ bool collectMarqueeBoxCandidates(
             return;
         }
 
-        auto startIt =
-            std::lower_bound(maxEndPrefix.begin(), maxEndPrefix.end(), minTime);
-        std::size_t startIndex = static_cast<std::size_t>(
-            std::distance(maxEndPrefix.begin(), startIt));
-        if ( startIndex >= entities.size() ) {
-            return;
-        }
+        index.queryVisible(
+            minTime, maxTime, [&](const TimeIntervalIndex::Entry& entry) {
+                const auto entity = entry.entity;
+                if ( !seen.insert(entity).second ) {
+                    return;
+                }
+                if ( !ctx.noteRegistry.valid(entity) ||
+                     !ctx.noteRegistry.all_of<NoteComponent>(entity) ) {
+                    return;
+                }
 
-        auto endIt = std::upper_bound(
-            entities.begin() + static_cast<std::ptrdiff_t>(startIndex),
-            entities.end(),
-            maxTime,
-            [&ctx](double value, entt::entity entity) {
-                return value < getNoteStartTimeForSelection(ctx, entity);
+                const auto& note =
+                    ctx.noteRegistry.get<const NoteComponent>(entity);
+                if ( note.m_isSubNote ) return;
+                candidates.push_back(
+                    { note.m_isDraft ? ChartObjectKind::DraftNote
+                                     : ChartObjectKind::PlayerNote,
+                      entity });
             });
-
-        candidates.reserve(
-            candidates.size() +
-            static_cast<std::size_t>(std::distance(
-                entities.begin() + static_cast<std::ptrdiff_t>(startIndex),
-                endIt)));
-        for ( auto it =
-                  entities.begin() + static_cast<std::ptrdiff_t>(startIndex);
-              it != endIt;
-              ++it ) {
-            const auto entity = *it;
-            if ( !seen.insert(entity).second ) {
-                continue;
-            }
-            if ( !ctx.noteRegistry.valid(entity) ||
-                 !ctx.noteRegistry.all_of<NoteComponent>(entity) ) {
-                continue;
-            }
-
-            const auto& note =
-                ctx.noteRegistry.get<const NoteComponent>(entity);
-            if ( note.m_isSubNote ) continue;
-            candidates.push_back({ note.m_isDraft ? ChartObjectKind::DraftNote
-                                                  : ChartObjectKind::PlayerNote,
-                                   entity });
-        }
     };
 
     const double paddedTopY    = box.rect.top - box.screen.noteH;
@@ -899,19 +864,6 @@ void collectMarqueeSelectionCandidates(
     collectAllPrimaryNoteCandidates(ctx, candidates);
 }
 
-/// @brief 获取自动采样可见区间起点，失效实体排序到末尾。
-/// @warning 逻辑热路径：框选候选二分时调用，只做 Registry 查询。
-double getSampleStartTimeForSelection(const SessionContext& ctx,
-                                      entt::entity          entity)
-{
-    if ( !ctx.sampleRegistry.valid(entity) ||
-         !ctx.sampleRegistry.all_of<SampleComponent>(entity) ) {
-        return std::numeric_limits<double>::infinity();
-    }
-    const auto& sample = ctx.sampleRegistry.get<const SampleComponent>(entity);
-    return std::min(sample.m_timestamp, sample.effectiveTime());
-}
-
 /// @brief 收集全部自动采样作为索引失效时的框选兜底候选。
 /// @warning 逻辑热路径兜底：只在排序缓存不可用时完整扫描 SampleComponent。
 void collectAllSampleCandidates(
@@ -924,16 +876,15 @@ void collectAllSampleCandidates(
 }
 
 /// @brief 从单个框选框的时间窗口收集自动采样候选。
-/// @warning 逻辑热路径：使用预排序区间与前缀最大终点，只扫描窗口候选。
+/// @warning 逻辑热路径：使用时间区间索引，只扫描与窗口相交的候选分块。
 bool collectMarqueeBoxSampleCandidates(
     SessionContext& ctx, const PreparedMarqueeBox& box,
     std::vector<MarqueeSelectionCandidate>& candidates,
     std::unordered_set<entt::entity>&       seen)
 {
-    const auto& entities     = ctx.sortedSampleEntities;
-    const auto& maxEndPrefix = ctx.sortedSampleMaxEndPrefix;
-    if ( entities.empty() || maxEndPrefix.size() != entities.size() ||
-         !box.screen.valid || !box.screen.cache || !box.rect.valid ) {
+    const auto& index = ctx.sampleVisibilityIndex;
+    if ( index.empty() || !box.screen.valid || !box.screen.cache ||
+         !box.rect.valid ) {
         return false;
     }
 
@@ -945,31 +896,16 @@ bool collectMarqueeBoxSampleCandidates(
             return;
         }
 
-        const auto startIt =
-            std::lower_bound(maxEndPrefix.begin(), maxEndPrefix.end(), minTime);
-        const std::size_t startIndex = static_cast<std::size_t>(
-            std::distance(maxEndPrefix.begin(), startIt));
-        if ( startIndex >= entities.size() ) return;
-
-        const auto endIt = std::upper_bound(
-            entities.begin() + static_cast<std::ptrdiff_t>(startIndex),
-            entities.end(),
-            maxTime,
-            [&ctx](double value, entt::entity entity) {
-                return value < getSampleStartTimeForSelection(ctx, entity);
+        index.queryVisible(
+            minTime, maxTime, [&](const TimeIntervalIndex::Entry& entry) {
+                const auto entity = entry.entity;
+                if ( !seen.insert(entity).second ||
+                     !ctx.sampleRegistry.valid(entity) ||
+                     !ctx.sampleRegistry.all_of<SampleComponent>(entity) ) {
+                    return;
+                }
+                candidates.push_back({ ChartObjectKind::AudioSample, entity });
             });
-        for ( auto iterator =
-                  entities.begin() + static_cast<std::ptrdiff_t>(startIndex);
-              iterator != endIt;
-              ++iterator ) {
-            const auto entity = *iterator;
-            if ( !seen.insert(entity).second ||
-                 !ctx.sampleRegistry.valid(entity) ||
-                 !ctx.sampleRegistry.all_of<SampleComponent>(entity) ) {
-                continue;
-            }
-            candidates.push_back({ ChartObjectKind::AudioSample, entity });
-        }
     };
 
     const double paddedTopY    = box.rect.top - box.screen.noteH;
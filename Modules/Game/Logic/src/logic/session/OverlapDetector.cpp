@@ -0,0 +1,786 @@
+#include "logic/session/OverlapDetector.h"
+
+#include <algorithm>
+#include <cmath>
+#include <iterator>
+#include <unordered_map>
+#include <utility>
+
+namespace MMM::Logic
+{
+
+namespace
+{
+
+/// @brief 时间比较容差，与原重叠遮罩保持一致。
+constexpr double TIME_EPSILON = 1e-7;
+
+/// @brief 每处理多少个元素检查一次取消请求。
+constexpr std::size_t STOP_CHECK_INTERVAL = 4096;
+
+/// @brief Flick 横穿长条时点遮罩相对物件尺寸的缩放。
+constexpr float FLICK_CROSS_SCALE = 0.7F;
+
+/// @brief 区域成员：顶层物件与代表它的判定物件下标。
+using Member = std::pair<entt::entity, std::uint32_t>;
+
+/// @brief 判定点或 Flick 横向身体上的探测点。
+struct Probe {
+    double        time{ 0.0 };
+    std::int32_t  track{ 0 };
+    entt::entity  owner{ entt::null };
+    std::uint32_t item{ 0 };
+    /// @brief 是否需要检测与 Flick 横向身体的重叠。
+    bool testsFlickBody{ false };
+    /// @brief 命中时点遮罩的缩放。
+    float scale{ 1.0F };
+};
+
+/// @brief 活动长条：按结束时间组成小顶堆。
+struct ActiveHold {
+    double        endTime{ 0.0 };
+    entt::entity  owner{ entt::null };
+    std::uint32_t item{ 0 };
+};
+
+/// @brief 小顶堆比较：结束时间早的在堆顶。
+bool laterEnd(const ActiveHold& lhs, const ActiveHold& rhs)
+{
+    return lhs.endTime > rhs.endTime;
+}
+
+/// @brief 按轨道维护时间轴上的活动长条集合与各顶层物件的活动数。
+class ActiveHoldSet
+{
+public:
+    /// @brief 加入一个长条。
+    void add(const OverlapItem& hold, std::uint32_t item)
+    {
+        m_heap.push_back({ hold.endTime, hold.owner, item });
+        std::push_heap(m_heap.begin(), m_heap.end(), laterEnd);
+        ++m_ownerCounts[hold.owner];
+    }
+
+    /// @brief 移除结束时间不晚于 time 的长条。
+    void expire(double time)
+    {
+        while ( !m_heap.empty() && m_heap.front().endTime <= time ) {
+            const auto owner = m_heap.front().owner;
+            std::pop_heap(m_heap.begin(), m_heap.end(), laterEnd);
+            m_heap.pop_back();
+            auto found = m_ownerCounts.find(owner);
+            if ( found != m_ownerCounts.end() && --found->second == 0 ) {
+                m_ownerCounts.erase(found);
+            }
+        }
+    }
+
+    /// @brief 清空集合并保留容量。
+    void clear()
+    {
+        m_heap.clear();
+        m_ownerCounts.clear();
+    }
+
+    /// @brief 活动长条涉及的顶层物件数量。
+    [[nodiscard]] std::size_t ownerCount() const { return m_ownerCounts.size(); }
+
+    /// @brief 给定顶层物件是否有活动长条。
+    [[nodiscard]] bool hasOwner(entt::entity owner) const
+    {
+        return m_ownerCounts.find(owner) != m_ownerCounts.end();
+    }
+
+    /// @brief 追加除 exclude 外的活动长条成员。
+    void appendMembers(std::vector<Member>& members,
+                       entt::entity         exclude = entt::null) const
+    {
+        for ( const auto& hold : m_heap ) {
+            if ( hold.owner == exclude ) continue;
+            members.emplace_back(hold.owner, hold.item);
+        }
+    }
+
+private:
+    std::vector<ActiveHold>                        m_heap;
+    std::unordered_map<entt::entity, std::size_t> m_ownerCounts;
+};
+
+/// @brief 向结果追加区域；成员按顶层物件去重，少于两个时丢弃。
+class RegionWriter
+{
+public:
+    explicit RegionWriter(OverlapReport& report) : m_report(report) {}
+
+    void add(OverlapRegionShape shape, float scale, std::int32_t trackBegin,
+             std::int32_t trackEnd, double timeBegin, double timeEnd,
+             std::vector<Member>& members)
+    {
+        std::sort(members.begin(), members.end());
+        members.erase(std::unique(members.begin(),
+                                  members.end(),
+                                  [](const Member& lhs, const Member& rhs) {
+                                      return lhs.first == rhs.first;
+                                  }),
+                      members.end());
+        if ( members.size() < 2 ) return;
+
+        OverlapRegion region;
+        region.shape       = shape;
+        region.scale       = scale;
+        region.trackBegin  = trackBegin;
+        region.trackEnd    = trackEnd;
+        region.timeBegin   = timeBegin;
+        region.timeEnd     = timeEnd;
+        region.objectCount = static_cast<std::int32_t>(members.size());
+        region.itemBegin =
+            static_cast<std::uint32_t>(m_report.regionItems.size());
+        region.itemCount = static_cast<std::uint32_t>(members.size());
+        for ( const auto& [owner, item] : members ) {
+            (void)owner;
+            m_report.regionItems.push_back(item);
+        }
+        m_report.regions.push_back(region);
+    }
+
+private:
+    OverlapReport& m_report;
+};
+
+/// @brief 定期检查取消请求。
+class StopPoll
+{
+public:
+    explicit StopPoll(const std::stop_token& stop) : m_stop(stop) {}
+
+    /// @brief 每 STOP_CHECK_INTERVAL 次调用检查一次。
+    /// @return 已请求停止时返回 true。
+    bool operator()()
+    {
+        if ( ++m_counter % STOP_CHECK_INTERVAL != 0 ) return false;
+        return m_stop.stop_requested();
+    }
+
+private:
+    const std::stop_token& m_stop;
+    std::size_t            m_counter{ 0 };
+};
+
+std::int32_t flickMinTrack(const OverlapItem& item)
+{
+    return std::min(item.track, item.track + item.dtrack);
+}
+
+std::int32_t flickMaxTrack(const OverlapItem& item)
+{
+    return std::max(item.track, item.track + item.dtrack);
+}
+
+/// @brief 判定物件的全序：起始时间、顶层物件、子物件下标。
+bool itemLess(const OverlapItem& lhs, const OverlapItem& rhs)
+{
+    if ( lhs.startTime != rhs.startTime ) return lhs.startTime < rhs.startTime;
+    if ( lhs.owner != rhs.owner ) return lhs.owner < rhs.owner;
+    return lhs.subIndex < rhs.subIndex;
+}
+
+/// @brief 区域按起始时间排序。
+bool regionTimeLess(const OverlapRegion& lhs, const OverlapRegion& rhs)
+{
+    return lhs.timeBegin < rhs.timeBegin;
+}
+
+/// @brief 增量合并中时间覆盖连通的一段物件，与其他岛之间不会产生区域。
+struct Island {
+    /// @brief 岛内最早的起始时间，单位秒。
+    double timeBegin{ 0.0 };
+    /// @brief 岛内最晚的结束时间，单位秒。
+    double timeEnd{ 0.0 };
+    /// @brief 岛内第一个新物件的下标。
+    std::uint32_t itemBegin{ 0 };
+    /// @brief 岛内最后一个新物件之后的下标。
+    std::uint32_t itemEnd{ 0 };
+};
+
+/// @brief 把区域按（轨道, 时间）合并为检测窗口行。
+void buildFindings(OverlapReport& report, double windowSeconds)
+{
+    std::vector<std::uint32_t> order(report.regions.size());
+    for ( std::size_t index = 0; index < order.size(); ++index ) {
+        order[index] = static_cast<std::uint32_t>(index);
+    }
+    std::sort(order.begin(),
+              order.end(),
+              [&](std::uint32_t lhs, std::uint32_t rhs) {
+                  const auto& a = report.regions[lhs];
+                  const auto& b = report.regions[rhs];
+                  if ( a.trackBegin != b.trackBegin ) {
+                      return a.trackBegin < b.trackBegin;
+                  }
+                  return a.timeBegin < b.timeBegin;
+              });
+
+    std::vector<std::uint32_t> groupItems;
+    for ( std::size_t begin = 0; begin < order.size(); ) {
+        const auto& first = report.regions[order[begin]];
+        std::size_t end   = begin + 1;
+        while ( end < order.size() &&
+                report.regions[order[end]].trackBegin == first.trackBegin &&
+                report.regions[order[end]].timeBegin <=
+                    first.timeBegin + windowSeconds + TIME_EPSILON ) {
+            ++end;
+        }
+
+        groupItems.clear();
+        for ( std::size_t index = begin; index < end; ++index ) {
+            const auto& region = report.regions[order[index]];
+            groupItems.insert(
+                groupItems.end(),
+                report.regionItems.begin() + region.itemBegin,
+                report.regionItems.begin() + region.itemBegin +
+                    region.itemCount);
+        }
+        std::sort(groupItems.begin(), groupItems.end());
+        groupItems.erase(std::unique(groupItems.begin(), groupItems.end()),
+                         groupItems.end());
+
+        // 每个区域至少两个成员；单个两物件区域保留其成员以便逐个描述。
+        const std::uint32_t* representatives = groupItems.data();
+        if ( end == begin + 1 && first.itemCount == 2 ) {
+            representatives = report.regionItems.data() + first.itemBegin;
+        }
+        report.findings.push_back(
+            { first.timeBegin,
+              first.trackBegin,
+              static_cast<std::uint32_t>(groupItems.size()),
+              static_cast<std::uint32_t>(end - begin),
+              representatives[0],
+              representatives[1] });
+        begin = end;
+    }
+}
+
+}  // namespace
+
+std::vector<OverlapRegion>::const_iterator OverlapReport::regionLowerBound(
+    double time) const
+{
+    return std::lower_bound(regions.begin(),
+                            regions.end(),
+                            time,
+                            [](const OverlapRegion& region, double value) {
+                                return region.timeBegin < value;
+                            });
+}
+
+void sortOverlapItems(std::vector<OverlapItem>& items)
+{
+    std::sort(items.begin(), items.end(), itemLess);
+}
+
+void appendOverlapItems(const NoteComponent& note, entt::entity entity,
+                        std::vector<OverlapItem>& out)
+{
+    if ( note.m_isSubNote ) return;
+
+    auto makeEndTime = [](double startTime, double duration,
+                          ::MMM::NoteType type) {
+        if ( type != ::MMM::NoteType::HOLD ) return startTime;
+        return startTime + std::max(0.0, duration);
+    };
+
+    if ( note.m_type == ::MMM::NoteType::POLYLINE ) {
+        for ( std::size_t index = 0; index < note.m_subNotes.size(); ++index ) {
+            const auto& sub = note.m_subNotes[index];
+            out.push_back({ sub.type,
+                            sub.timestamp,
+                            makeEndTime(sub.timestamp, sub.duration, sub.type),
+                            sub.trackIndex,
+                            sub.dtrack,
+                            entity,
+                            static_cast<std::int32_t>(index),
+                            note.m_timestamp });
+        }
+        return;
+    }
+
+    out.push_back(
+        { note.m_type,
+          note.m_timestamp,
+          makeEndTime(note.m_timestamp, note.m_duration, note.m_type),
+          note.m_trackIndex,
+          note.m_dtrack,
+          entity,
+          -1,
+          note.m_timestamp });
+}
+
+std::optional<OverlapReport> detectOverlaps(std::vector<OverlapItem> items,
+                                            double        windowSeconds,
+                                            std::uint64_t revision,
+                                            std::stop_token stop)
+{
+    OverlapReport report;
+    report.items         = std::move(items);
+    report.windowSeconds = std::max(0.0, windowSeconds);
+    report.revision      = revision;
+
+    const auto&  source = report.items;
+    const double window = report.windowSeconds + TIME_EPSILON;
+    StopPoll     stopRequested(stop);
+    RegionWriter writer(report);
+
+    // 1. 拆分判定点、长条与 Flick。
+    std::vector<Probe>         points;
+    std::vector<std::uint32_t> holds;
+    std::vector<std::uint32_t> flicks;
+    points.reserve(source.size() * 2);
+    for ( std::size_t index = 0; index < source.size(); ++index ) {
+        const auto& item = source[index];
+        const auto  id   = static_cast<std::uint32_t>(index);
+        if ( item.type == ::MMM::NoteType::NOTE ) {
+            points.push_back(
+                { item.startTime, item.track, item.owner, id, true, 1.0F });
+        } else if ( item.type == ::MMM::NoteType::HOLD ) {
+            points.push_back(
+                { item.startTime, item.track, item.owner, id, true, 1.0F });
+            if ( item.endTime > item.startTime + TIME_EPSILON ) {
+                holds.push_back(id);
+                points.push_back(
+                    { item.endTime, item.track, item.owner, id, true, 1.0F });
+            }
+        } else if ( item.type == ::MMM::NoteType::FLICK ) {
+            flicks.push_back(id);
+            points.push_back(
+                { item.startTime, item.track, item.owner, id, false, 1.0F });
+            points.push_back({ item.startTime,
+                               item.track + item.dtrack,
+                               item.owner,
+                               id,
+                               true,
+                               1.0F });
+        }
+    }
+
+    const auto probeLess = [](const Probe& lhs, const Probe& rhs) {
+        if ( lhs.track != rhs.track ) return lhs.track < rhs.track;
+        if ( lhs.time != rhs.time ) return lhs.time < rhs.time;
+        return lhs.item < rhs.item;
+    };
+    std::sort(points.begin(), points.end(), probeLess);
+    std::sort(holds.begin(),
+              holds.end(),
+              [&](std::uint32_t lhs, std::uint32_t rhs) {
+                  const auto& a = source[lhs];
+                  const auto& b = source[rhs];
+                  if ( a.track != b.track ) return a.track < b.track;
+                  if ( a.startTime != b.startTime ) {
+                      return a.startTime < b.startTime;
+                  }
+                  return a.endTime < b.endTime;
+              });
+    std::sort(flicks.begin(),
+              flicks.end(),
+              [&](std::uint32_t lhs, std::uint32_t rhs) {
+                  const auto& a = source[lhs];
+                  const auto& b = source[rhs];
+                  if ( a.startTime != b.startTime ) {
+                      return a.startTime < b.startTime;
+                  }
+                  return lhs < rhs;
+              });
+
+    std::vector<Member> members;
+
+    // 2. 同轨判定点：相邻间隔不超过时间窗口的点连成一簇。
+    for ( std::size_t begin = 0; begin < points.size(); ) {
+        std::size_t end = begin + 1;
+        while ( end < points.size() && points[end].track == points[begin].track &&
+                points[end].time - points[end - 1].time <= window ) {
+            ++end;
+        }
+        if ( end - begin >= 2 ) {
+            members.clear();
+            for ( std::size_t index = begin; index < end; ++index ) {
+                members.emplace_back(points[index].owner, points[index].item);
+            }
+            writer.add(OverlapRegionShape::Point,
+                       1.0F,
+                       points[begin].track,
+                       points[begin].track,
+                       points[begin].time,
+                       points[end - 1].time,
+                       members);
+        }
+        if ( stopRequested() ) return std::nullopt;
+        begin = end;
+    }
+
+    // 3. 同轨长条身体：按去重后的端点切分时段，扫描维护活动长条。
+    std::vector<double> bounds;
+    ActiveHoldSet       active;
+    for ( std::size_t begin = 0; begin < holds.size(); ) {
+        const std::int32_t track = source[holds[begin]].track;
+        std::size_t        end   = begin;
+        bounds.clear();
+        while ( end < holds.size() && source[holds[end]].track == track ) {
+            bounds.push_back(source[holds[end]].startTime);
+            bounds.push_back(source[holds[end]].endTime);
+            ++end;
+        }
+        if ( end - begin < 2 ) {
+            begin = end;
+            continue;
+        }
+        std::sort(bounds.begin(), bounds.end());
+        bounds.erase(std::unique(bounds.begin(),
+                                 bounds.end(),
+                                 [](double a, double b) {
+                                     return std::abs(a - b) < TIME_EPSILON;
+                                 }),
+                     bounds.end());
+
+        bool        hasOpen   = false;
+        double      openStart = 0.0;
+        double      openEnd   = 0.0;
+        std::size_t openCount = 0;
+        auto        flush     = [&]() {
+            if ( !hasOpen ) return;
+            writer.add(OverlapRegionShape::HoldBody,
+                       1.0F,
+                       track,
+                       track,
+                       openStart,
+                       openEnd,
+                       members);
+            hasOpen = false;
+        };
+
+        active.clear();
+        std::size_t next = begin;
+        for ( std::size_t k = 0; k + 1 < bounds.size(); ++k ) {
+            const double segStart = bounds[k];
+            const double segEnd   = bounds[k + 1];
+            if ( segEnd <= segStart + TIME_EPSILON ) continue;
+
+            while ( next < end &&
+                    source[holds[next]].startTime < segEnd - TIME_EPSILON ) {
+                active.add(source[holds[next]], holds[next]);
+                ++next;
+            }
+            active.expire(segStart + TIME_EPSILON);
+
+            const std::size_t count = active.ownerCount();
+            if ( count >= 2 ) {
+                if ( !hasOpen || count > openCount ) {
+                    members.clear();
+                    active.appendMembers(members);
+                    openCount = count;
+                }
+                if ( !hasOpen ) openStart = segStart;
+                hasOpen = true;
+                openEnd = segEnd;
+            } else {
+                flush();
+            }
+            if ( stopRequested() ) return std::nullopt;
+        }
+        flush();
+        begin = end;
+    }
+
+    // 4. 相近时间的两个 Flick 横向身体交叠。
+    for ( std::size_t i = 0; i < flicks.size(); ++i ) {
+        const auto& a = source[flicks[i]];
+        if ( a.dtrack == 0 ) continue;
+        for ( std::size_t j = i + 1; j < flicks.size(); ++j ) {
+            const auto& b = source[flicks[j]];
+            if ( b.startTime - a.startTime > window ) break;
+            if ( b.dtrack == 0 || a.owner == b.owner ) continue;
+
+            const std::int32_t overlapMin =
+                std::max(flickMinTrack(a), flickMinTrack(b));
+            const std::int32_t overlapMax =
+                std::min(flickMaxTrack(a), flickMaxTrack(b));
+            if ( overlapMax <= overlapMin ) continue;
+
+            members.assign(
+                { Member{ a.owner, flicks[i] }, Member{ b.owner, flicks[j] } });
+            writer.add(OverlapRegionShape::FlickBody,
+                       1.0F,
+                       overlapMin,
+                       overlapMax,
+                       a.startTime,
+                       b.startTime,
+                       members);
+        }
+        if ( stopRequested() ) return std::nullopt;
+    }
+
+    // 5. 判定点落在相近时间的 Flick 横向身体上。
+    for ( const auto& point : points ) {
+        if ( !point.testsFlickBody ) continue;
+        auto first = std::lower_bound(
+            flicks.begin(),
+            flicks.end(),
+            point.time - window,
+            [&](std::uint32_t item, double time) {
+                return source[item].startTime < time;
+            });
+        members.clear();
+        for ( auto it = first; it != flicks.end(); ++it ) {
+            const auto& flick = source[*it];
+            if ( flick.startTime > point.time + window ) break;
+            if ( flick.owner == point.owner || flick.dtrack == 0 ) continue;
+            if ( point.track < flickMinTrack(flick) ||
+                 point.track > flickMaxTrack(flick) ) {
+                continue;
+            }
+            members.emplace_back(flick.owner, *it);
+        }
+        if ( !members.empty() ) {
+            members.emplace_back(point.owner, point.item);
+            writer.add(OverlapRegionShape::Point,
+                       point.scale,
+                       point.track,
+                       point.track,
+                       point.time,
+                       point.time,
+                       members);
+        }
+        if ( stopRequested() ) return std::nullopt;
+    }
+
+    // 6. 判定点或 Flick 横向身体落在其他长条身体内部：每轨按时间扫描，
+    // 活动集合只含起点早于探测时间、终点晚于探测时间的长条。
+    std::vector<Probe> probes;
+    probes.reserve(points.size());
+    std::vector<std::int32_t> holdTracks;
+    for ( const auto id : holds ) {
+        if ( holdTracks.empty() || holdTracks.back() != source[id].track ) {
+            holdTracks.push_back(source[id].track);
+        }
+    }
+    const auto hasHoldsOnTrack = [&](std::int32_t track) {
+        return std::binary_search(holdTracks.begin(), holdTracks.end(), track);
+    };
+    for ( const auto& point : points ) {
+        if ( hasHoldsOnTrack(point.track) ) probes.push_back(point);
+    }
+    for ( const auto id : flicks ) {
+        const auto& flick = source[id];
+        if ( flick.dtrack == 0 ) continue;
+        for ( std::int32_t track = flickMinTrack(flick);
+              track <= flickMaxTrack(flick);
+              ++track ) {
+            if ( !hasHoldsOnTrack(track) ) continue;
+            probes.push_back({ flick.startTime,
+                               track,
+                               flick.owner,
+                               id,
+                               false,
+                               FLICK_CROSS_SCALE });
+        }
+    }
+    std::sort(probes.begin(), probes.end(), probeLess);
+
+    std::size_t holdCursor = 0;
+    for ( std::size_t begin = 0; begin < probes.size(); ) {
+        const std::int32_t track = probes[begin].track;
+        while ( holdCursor < holds.size() &&
+                source[holds[holdCursor]].track < track ) {
+            ++holdCursor;
+        }
+        active.clear();
+        std::size_t end = begin;
+        for ( ; end < probes.size() && probes[end].track == track; ++end ) {
+            const auto& probe = probes[end];
+            while ( holdCursor < holds.size() &&
+                    source[holds[holdCursor]].track == track &&
+                    source[holds[holdCursor]].startTime + TIME_EPSILON <
+                        probe.time ) {
+                active.add(source[holds[holdCursor]], holds[holdCursor]);
+                ++holdCursor;
+            }
+            active.expire(probe.time + TIME_EPSILON);
+
+            const std::size_t others =
+                active.ownerCount() - (active.hasOwner(probe.owner) ? 1 : 0);
+            if ( others > 0 ) {
+                members.clear();
+                active.appendMembers(members, probe.owner);
+                members.emplace_back(probe.owner, probe.item);
+                writer.add(OverlapRegionShape::Point,
+                           probe.scale,
+                           track,
+                           track,
+                           probe.time,
+                           probe.time,
+                           members);
+            }
+            if ( stopRequested() ) return std::nullopt;
+        }
+        begin = end;
+    }
+
+    // 7. 区域按时间排序供可见范围查询，并合并出检测窗口行。
+    std::sort(report.regions.begin(), report.regions.end(), regionTimeLess);
+    for ( const auto& region : report.regions ) {
+        report.maxRegionSpan =
+            std::max(report.maxRegionSpan, region.timeEnd - region.timeBegin);
+    }
+    buildFindings(report, report.windowSeconds);
+    if ( stop.stop_requested() ) return std::nullopt;
+    return report;
+}
+
+std::optional<OverlapReport> mergeOverlaps(const OverlapReport&     previous,
+                                           std::vector<double>      dirtyTimes,
+                                           std::vector<OverlapItem> added,
+                                           std::uint64_t            revision,
+                                           std::stop_token          stop)
+{
+    std::sort(dirtyTimes.begin(), dirtyTimes.end());
+    dirtyTimes.erase(std::unique(dirtyTimes.begin(), dirtyTimes.end()),
+                     dirtyTimes.end());
+    sortOverlapItems(added);
+    // 重新收集的顶层物件即使旧起始时间未被记录，也不能保留旧判定物件。
+    std::vector<entt::entity> addedOwners;
+    addedOwners.reserve(added.size());
+    for ( const auto& item : added ) addedOwners.push_back(item.owner);
+    std::sort(addedOwners.begin(), addedOwners.end());
+    addedOwners.erase(std::unique(addedOwners.begin(), addedOwners.end()),
+                      addedOwners.end());
+
+    OverlapReport report;
+    report.windowSeconds = previous.windowSeconds;
+    report.revision      = revision;
+
+    constexpr auto DROPPED = static_cast<std::uint32_t>(-1);
+    const auto&    old     = previous.items;
+    const double   window  = report.windowSeconds + TIME_EPSILON;
+    StopPoll       stopRequested(stop);
+
+    // 1. 归并保留的旧物件与新物件，同时按新旧物件的并集切分时间覆盖岛。
+    // 并集中的空隙在新旧两组物件中都是空隙，任何区域都不会跨岛。
+    std::vector<std::uint32_t> remap(old.size(), DROPPED);
+    std::vector<Island>        dirtyIslands;
+    report.items.reserve(old.size() + added.size());
+    Island      island;
+    bool        hasIsland   = false;
+    bool        islandDirty = false;
+    std::size_t oldCursor   = 0;
+    std::size_t addedCursor = 0;
+    const auto  closeIsland = [&]() {
+        island.itemEnd = static_cast<std::uint32_t>(report.items.size());
+        if ( hasIsland && islandDirty ) dirtyIslands.push_back(island);
+    };
+    while ( oldCursor < old.size() || addedCursor < added.size() ) {
+        const bool takeOld =
+            addedCursor == added.size() ||
+            (oldCursor < old.size() &&
+             itemLess(old[oldCursor], added[addedCursor]));
+        const auto& item    = takeOld ? old[oldCursor] : added[addedCursor];
+        const bool  dropped =
+            takeOld && (std::binary_search(dirtyTimes.begin(),
+                                           dirtyTimes.end(),
+                                           item.ownerTime) ||
+                        std::binary_search(addedOwners.begin(),
+                                           addedOwners.end(),
+                                           item.owner));
+
+        if ( !hasIsland || item.startTime > island.timeEnd + window ) {
+            closeIsland();
+            island      = { item.startTime,
+                            item.endTime,
+                            static_cast<std::uint32_t>(report.items.size()),
+                            0 };
+            hasIsland   = true;
+            islandDirty = false;
+        }
+        island.timeEnd = std::max(island.timeEnd, item.endTime);
+        islandDirty    = islandDirty || dropped || !takeOld;
+
+        if ( takeOld ) {
+            if ( !dropped ) {
+                remap[oldCursor] =
+                    static_cast<std::uint32_t>(report.items.size());
+                report.items.push_back(item);
+            }
+            ++oldCursor;
+        } else {
+            report.items.push_back(item);
+            ++addedCursor;
+        }
+        if ( stopRequested() ) return std::nullopt;
+    }
+    closeIsland();
+
+    // 2. 只对受影响的岛重新检测，局部下标映射回合并后的物件列表。
+    std::vector<OverlapItem>   dirtyItems;
+    std::vector<std::uint32_t> dirtyToItem;
+    for ( const auto& dirty : dirtyIslands ) {
+        for ( auto index = dirty.itemBegin; index < dirty.itemEnd; ++index ) {
+            dirtyItems.push_back(report.items[index]);
+            dirtyToItem.push_back(index);
+        }
+    }
+    auto rescanned = detectOverlaps(
+        std::move(dirtyItems), report.windowSeconds, revision, stop);
+    if ( !rescanned ) return std::nullopt;
+
+    // 3. 沿用受影响岛之外的旧区域；受影响岛按起始时间有序，区域完全落在
+    // 某一个岛内，只需比较区域起点。
+    const auto inDirtyIsland = [&](double time) {
+        auto it = std::upper_bound(dirtyIslands.begin(),
+                                   dirtyIslands.end(),
+                                   time,
+                                   [](double value, const Island& dirty) {
+                                       return value < dirty.timeBegin;
+                                   });
+        return it != dirtyIslands.begin() && time <= std::prev(it)->timeEnd;
+    };
+    std::vector<OverlapRegion> keptRegions;
+    keptRegions.reserve(previous.regions.size());
+    for ( auto region : previous.regions ) {
+        if ( inDirtyIsland(region.timeBegin) ) continue;
+        const auto itemBegin =
+            static_cast<std::uint32_t>(report.regionItems.size());
+        for ( std::uint32_t offset = 0; offset < region.itemCount; ++offset ) {
+            report.regionItems.push_back(
+                remap[previous.regionItems[region.itemBegin + offset]]);
+        }
+        region.itemBegin = itemBegin;
+        keptRegions.push_back(region);
+        if ( stopRequested() ) return std::nullopt;
+    }
+
+    auto rescannedRegions = std::move(rescanned->regions);
+    for ( auto& region : rescannedRegions ) {
+        const auto itemBegin =
+            static_cast<std::uint32_t>(report.regionItems.size());
+        for ( std::uint32_t offset = 0; offset < region.itemCount; ++offset ) {
+            report.regionItems.push_back(
+                dirtyToItem[rescanned->regionItems[region.itemBegin + offset]]);
+        }
+        region.itemBegin = itemBegin;
+    }
+
+    // 4. 两组区域各自按起始时间有序，线性归并后重建窗口行。
+    report.regions.reserve(keptRegions.size() + rescannedRegions.size());
+    std::merge(keptRegions.begin(),
+               keptRegions.end(),
+               rescannedRegions.begin(),
+               rescannedRegions.end(),
+               std::back_inserter(report.regions),
+               regionTimeLess);
+    for ( const auto& region : report.regions ) {
+        report.maxRegionSpan =
+            std::max(report.maxRegionSpan, region.timeEnd - region.timeBegin);
+    }
+    buildFindings(report, report.windowSeconds);
+    if ( stop.stop_requested() ) return std::nullopt;
+    return report;
+}
+
+}  // namespace MMM::Logic
@@ -0,0 +1,121 @@
+#include "logic/session/OverlapScanService.h"
+
+#include "logic/ecs/components/NoteComponent.h"
+#include "runtime/AppThreadPool.h"
+#include <algorithm>
+#include <ice/thread/ThreadPool.hpp>
+#include <optional>
+#include <utility>
+#include <vector>
+
+namespace MMM::Logic
+{
+
+OverlapScanService::~OverlapScanService()
+{
+    // 运行中的任务持有共享状态与全部输入，只需请求停止，不必等待。
+    m_stopSource.request_stop();
+}
+
+void OverlapScanService::update(const entt::registry&    noteRegistry,
+                                const TimeIntervalIndex& noteIndex,
+                                const NoteDirtyTimeLog&  dirtyTimes,
+                                std::uint64_t revision, double windowSeconds)
+{
+    if ( m_hasSubmitted && m_submittedRevision == revision &&
+         m_submittedWindow == windowSeconds ) {
+        return;
+    }
+    m_hasSubmitted      = true;
+    m_submittedRevision = revision;
+    m_submittedWindow   = windowSeconds;
+
+    // 以最近发布的快照为基础；被取消任务的编辑仍在脏时间记录中，随本次
+    // 一并重放。
+    auto base = report();
+    if ( base && (base->windowSeconds != std::max(0.0, windowSeconds) ||
+                  base->revision > revision ||
+                  !dirtyTimes.canReplayAfter(base->revision)) ) {
+        base.reset();
+    }
+
+    std::vector<double>      times;
+    std::vector<OverlapItem> items;
+    if ( base ) {
+        dirtyTimes.forEachAfter(base->revision,
+                                [&](double time) { times.push_back(time); });
+        std::sort(times.begin(), times.end());
+        times.erase(std::unique(times.begin(), times.end()), times.end());
+        for ( const double time : times ) {
+            noteIndex.queryVisible(
+                time, time, [&](const TimeIntervalIndex::Entry& entry) {
+                    if ( entry.startTime != time ) return;
+                    if ( const auto* note =
+                             noteRegistry.try_get<const NoteComponent>(
+                                 entry.entity) ) {
+                        appendOverlapItems(*note, entry.entity, items);
+                    }
+                });
+        }
+    } else {
+        const auto view = noteRegistry.view<const NoteComponent>();
+        items.reserve(view.size());
+        for ( const auto entity : view ) {
+            appendOverlapItems(
+                view.get<const NoteComponent>(entity), entity, items);
+        }
+    }
+
+    m_stopSource.request_stop();
+    m_stopSource     = std::stop_source{};
+    const auto token = m_stopSource.get_token();
+    const auto job   = m_state->submitted.fetch_add(1) + 1;
+    auto scan = [state = m_state, base = std::move(base),
+                 times = std::move(times), items = std::move(items),
+                 windowSeconds, revision, token, job]() mutable {
+        std::optional<OverlapReport> report;
+        if ( base ) {
+            report = mergeOverlaps(
+                *base, std::move(times), std::move(items), revision, token);
+        } else {
+            sortOverlapItems(items);
+            report = detectOverlaps(
+                std::move(items), windowSeconds, revision, token);
+        }
+        if ( report && !token.stop_requested() ) {
+            auto published =
+                std::make_shared<const OverlapReport>(std::move(*report));
+            // 取消检查与发布之间可能已有更新的任务完成，按任务编号拒绝回退。
+            std::lock_guard<std::mutex> lock(state->mutex);
+            if ( job > state->publishedJob ) {
+                state->report       = std::move(published);
+                state->publishedJob = job;
+            }
+        }
+        // 只向前推进，晚到的旧任务不会覆盖新任务的完成状态。
+        auto finished = state->finished.load();
+        while ( finished < job &&
+                !state->finished.compare_exchange_weak(finished, job) ) {
+        }
+    };
+
+    auto* threadPool = Runtime::AppThreadPool::instance().get();
+    if ( threadPool ) {
+        static_cast<void>(threadPool->enqueue(std::move(scan)));
+    } else {
+        scan();
+    }
+}
+
+std::shared_ptr<const OverlapReport> OverlapScanService::report() const
+{
+    std::lock_guard<std::mutex> lock(m_state->mutex);
+    return m_state->report;
+}
+
+bool OverlapScanService::isScanning() const
+{
+    return m_state->finished.load() < m_state->submitted.load();
+}
+
+}  // namespace MMM::Logic
@@ -105,7 +105,7 @@ void restoreActiveHoldEffectsAfterPlaybackJump(SessionContext& ctx)
     const double animateTime =
         ctx.currentTime + ctx.lastConfig.visual.getEffectiveVisualOffset();
     ctx.hitFXSystem.restoreActiveHoldEffects(
-        animateTime, ctx.hitEvents, ctx.lastConfig);
+        animateTime, ctx.hitEvents.events(), ctx.lastConfig);
 }
 }  // namespace
 
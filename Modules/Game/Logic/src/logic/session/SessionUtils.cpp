@@ -152,96 +152,24 @@ void appendDensityTimes(const NoteComponent& note, std::vector<double>& output)
     }
 }
 
-/// @brief 计算音符用于可见性前缀的结束时间。
-double noteEndTime(const NoteComponent& note)
+/// @brief 音符最晚结束时间超出元数据总时长时向后扩展。
+void extendMapLength(SessionContext& ctx, double maxEndTime)
 {
-    double result = note.m_timestamp + std::max(0.0, note.m_duration);
-    if ( note.m_type == ::MMM::NoteType::POLYLINE ) {
-        for ( const auto& sub : note.m_subNotes ) {
-            result =
-                std::max(result, sub.timestamp + std::max(0.0, sub.duration));
-        }
+    if ( !ctx.currentBeatmap ) return;
+    const double maxEndTimeMs = maxEndTime * 1000.0;
+    if ( maxEndTimeMs > ctx.currentBeatmap->m_baseMapMetadata.map_length ) {
+        ctx.currentBeatmap->m_baseMapMetadata.map_length = maxEndTimeMs;
     }
-    return result;
-}
-
-/// @brief 判断两个可选采样绑定是否相同。
-bool sameSampleBinding(const std::optional<::MMM::AudioSampleBinding>& lhs,
-                       const std::optional<::MMM::AudioSampleBinding>& rhs)
-{
-    if ( lhs.has_value() != rhs.has_value() ) return false;
-    return !lhs || (lhs->m_audioResourceId == rhs->m_audioResourceId &&
-                    lhs->m_volume == rhs->m_volume);
-}
-
-/// @brief 将单个正式顶层音符转换为打击事件。
-void appendHitEvents(const NoteComponent&                        note,
-                     std::vector<System::HitFXSystem::HitEvent>& output)
-{
-    using HitEvent = System::HitFXSystem::HitEvent;
-    using HitRole  = HitEvent::Role;
-    if ( note.m_isDraft || note.m_isSubNote ) return;
-
-    if ( note.m_type == ::MMM::NoteType::POLYLINE ) {
-        for ( std::size_t index = 0U; index < note.m_subNotes.size();
-              ++index ) {
-            const auto& sub = note.m_subNotes[index];
-            HitRole   role = index == 0U ? HitRole::Head
-                                         : (index + 1U == note.m_subNotes.size()
-                                                ? HitRole::Tail
-                                                : HitRole::Internal);
-            const int span = sub.type == ::MMM::NoteType::FLICK
-                                 ? std::abs(sub.dtrack) + 1
-                                 : 1;
-            auto      binding = sub.sampleBinding;
-            if ( !binding && role == HitRole::Head ) {
-                binding = note.m_sampleBinding;
-            }
-            output.push_back({ sub.timestamp,
-                               sub.type,
-                               role,
-                               span,
-                               sub.trackIndex,
-                               sub.dtrack,
-                               sub.duration,
-                               true,
-                               std::move(binding) });
-        }
-        return;
-    }
-
-    const int span =
-        note.m_type == ::MMM::NoteType::FLICK ? std::abs(note.m_dtrack) + 1 : 1;
-    output.push_back({ note.m_timestamp,
-                       note.m_type,
-                       HitRole::None,
-                       span,
-                       note.m_trackIndex,
-                       note.m_dtrack,
-                       note.m_duration,
-                       false,
-                       note.m_sampleBinding });
 }
 
-/// @brief 判断两个打击事件是否来自同一个音符状态。
-bool sameHitEvent(const System::HitFXSystem::HitEvent& lhs,
-                  const System::HitFXSystem::HitEvent& rhs)
-{
-    return lhs.timestamp == rhs.timestamp && lhs.type == rhs.type &&
-           lhs.role == rhs.role && lhs.trackSpan == rhs.trackSpan &&
-           lhs.trackIndex == rhs.trackIndex &&
-           lhs.trackOffset == rhs.trackOffset && lhs.duration == rhs.duration &&
-           lhs.isSubNote == rhs.isSubNote &&
-           sameSampleBinding(lhs.sampleBinding, rhs.sampleBinding);
-}
 }  // namespace
 
 bool applyNoteCacheMutationsIncrementally(
     SessionContext& ctx, std::span<const NoteCacheMutationView> mutations)
 {
     if ( mutations.empty() ) return true;
-    if ( ctx.isNoteOrderDirty || ctx.isNotePruneDirty || ctx.isNoteStatsDirty ||
-         ctx.sortedNoteEntities.size() != ctx.sortedNoteMaxEndPrefix.size() ) {
+    if ( ctx.isNoteOrderDirty || ctx.isNotePruneDirty ||
+         ctx.isNoteStatsDirty ) {
         return false;
     }
 
@@ -249,12 +177,9 @@ bool applyNoteCacheMutationsIncrementally(
     std::vector<entt::entity>                  replacementEntities;
     std::vector<double>                        removedDensityTimes;
     std::vector<double>                        addedDensityTimes;
-    std::vector<System::HitFXSystem::HitEvent> removedHitEvents;
-    std::vector<System::HitFXSystem::HitEvent> addedHitEvents;
     NoteStatisticsContribution                 beforeStatistics;
     NoteStatisticsContribution                 afterStatistics;
-    double earliestTimestamp = std::numeric_limits<double>::infinity();
-    bool   touchesFormalNote = false;
+    bool touchesFormalNote = false;
 
     affectedEntities.reserve(mutations.size());
     replacementEntities.reserve(mutations.size());
@@ -264,8 +189,6 @@ bool applyNoteCacheMutationsIncrementally(
             return false;
         }
         if ( mutation.before ) {
-            earliestTimestamp =
-                std::min(earliestTimestamp, mutation.before->m_timestamp);
             const auto contribution = calculateNoteStatistics(
                 *mutation.before, ctx.currentBeatmap.get());
             beforeStatistics.noteCount += contribution.noteCount;
@@ -274,9 +197,6 @@ bool applyNoteCacheMutationsIncrementally(
             if ( !mutation.before->m_isDraft &&
                  !mutation.before->m_isSubNote ) {
                 touchesFormalNote = true;
-                if ( !ctx.isHitEventsDirty ) {
-                    appendHitEvents(*mutation.before, removedHitEvents);
-                }
             }
         }
         if ( mutation.after ) {
@@ -285,8 +205,6 @@ bool applyNoteCacheMutationsIncrementally(
                 return false;
             }
             replacementEntities.push_back(mutation.entity);
-            earliestTimestamp =
-                std::min(earliestTimestamp, mutation.after->m_timestamp);
             const auto contribution = calculateNoteStatistics(
                 *mutation.after, ctx.currentBeatmap.get());
             afterStatistics.noteCount += contribution.noteCount;
@@ -294,63 +212,24 @@ bool applyNoteCacheMutationsIncrementally(
             appendDensityTimes(*mutation.after, addedDensityTimes);
             if ( !mutation.after->m_isDraft && !mutation.after->m_isSubNote ) {
                 touchesFormalNote = true;
-                if ( !ctx.isHitEventsDirty ) {
-                    appendHitEvents(*mutation.after, addedHitEvents);
-                }
             }
         }
     }
 
+    auto& visibilityIndex = ctx.noteVisibilityIndex;
     for ( const auto& mutation : mutations ) {
-        if ( mutation.before &&
-             std::find(ctx.sortedNoteEntities.begin(),
-                       ctx.sortedNoteEntities.end(),
-                       mutation.entity) == ctx.sortedNoteEntities.end() ) {
+        if ( mutation.before && !visibilityIndex.contains(mutation.entity) ) {
             return false;
         }
     }
 
-    std::erase_if(ctx.sortedNoteEntities, [&](entt::entity entity) {
-        return affectedEntities.contains(entity);
-    });
-    const auto entityLess = [&ctx](entt::entity lhs, entt::entity rhs) {
-        return ctx.noteRegistry.get<const NoteComponent>(lhs).m_timestamp <
-               ctx.noteRegistry.get<const NoteComponent>(rhs).m_timestamp;
-    };
-    std::sort(
-        replacementEntities.begin(), replacementEntities.end(), entityLess);
-    std::vector<entt::entity> mergedEntities;
-    mergedEntities.reserve(ctx.sortedNoteEntities.size() +
-                           replacementEntities.size());
-    std::merge(ctx.sortedNoteEntities.begin(),
-               ctx.sortedNoteEntities.end(),
-               replacementEntities.begin(),
-               replacementEntities.end(),
-               std::back_inserter(mergedEntities),
-               entityLess);
-    ctx.sortedNoteEntities.swap(mergedEntities);
-
-    const auto prefixBegin = std::lower_bound(
-        ctx.sortedNoteEntities.begin(),
-        ctx.sortedNoteEntities.end(),
-        earliestTimestamp,
-        [&ctx](entt::entity entity, double timestamp) {
-            return ctx.noteRegistry.get<const NoteComponent>(entity)
-                       .m_timestamp < timestamp;
-        });
-    const auto prefixIndex = static_cast<std::size_t>(
-        std::distance(ctx.sortedNoteEntities.begin(), prefixBegin));
-    ctx.sortedNoteMaxEndPrefix.resize(ctx.sortedNoteEntities.size());
-    double maximumEnd =
-        prefixIndex == 0U ? 0.0 : ctx.sortedNoteMaxEndPrefix[prefixIndex - 1U];
-    for ( std::size_t index = prefixIndex;
-          index < ctx.sortedNoteEntities.size();
-          ++index ) {
-        const auto entity = ctx.sortedNoteEntities[index];
-        maximumEnd        = std::max(
-            maximumEnd,
-            noteEndTime(ctx.noteRegistry.get<const NoteComponent>(entity)));
-        ctx.sortedNoteMaxEndPrefix[index] = maximumEnd;
+    // 索引条目内联起止时间，逐个删除再按当前组件插入，不重排整张谱面。
+    for ( const auto entity : affectedEntities ) {
+        visibilityIndex.erase(entity);
+    }
+    for ( const auto entity : replacementEntities ) {
+        visibilityIndex.insert(TimeIntervalIndex::makeEntry(
+            entity, ctx.noteRegistry.get<const NoteComponent>(entity)));
     }
 
     ctx.noteCount = ctx.noteCount >= beforeStatistics.noteCount
@@ -383,31 +262,26 @@ bool applyNoteCacheMutationsIncrementally(
     ctx.isPreviewDensityDirty =
         !removedDensityTimes.empty() || !addedDensityTimes.empty();
 
-    if ( touchesFormalNote && !ctx.isHitEventsDirty ) {
-        for ( const auto& event : removedHitEvents ) {
-            const auto range = std::equal_range(
-                ctx.hitEvents.begin(), ctx.hitEvents.end(), event);
-            const auto found = std::find_if(
-                range.first, range.second, [&](const auto& current) {
-                    return sameHitEvent(current, event);
-                });
-            if ( found == range.second ) {
-                ctx.isHitEventsDirty = true;
-                break;
-            }
-            ctx.hitEvents.erase(found);
-        }
-        if ( !ctx.isHitEventsDirty ) {
-            for ( auto& event : addedHitEvents ) {
-                const auto insertion = std::upper_bound(
-                    ctx.hitEvents.begin(), ctx.hitEvents.end(), event);
-                ctx.hitEvents.insert(insertion, std::move(event));
-            }
-            syncHitIndex(ctx);
+    if ( touchesFormalNote ) {
+        std::vector<entt::entity> hitEntities;
+        hitEntities.reserve(mutations.size());
+        for ( const auto& mutation : mutations ) {
+            hitEntities.push_back(mutation.entity);
         }
+        refreshHitEvents(ctx, hitEntities);
     }
 
     ++ctx.noteVisibilityIndexRevision;
+    for ( const auto& mutation : mutations ) {
+        if ( mutation.before ) {
+            ctx.noteDirtyTimes.record(ctx.noteVisibilityIndexRevision,
+                                      mutation.before->m_timestamp);
+        }
+        if ( mutation.after ) {
+            ctx.noteDirtyTimes.record(ctx.noteVisibilityIndexRevision,
+                                      mutation.after->m_timestamp);
+        }
+    }
     ctx.isNoteOrderDirty = false;
     ctx.isNotePruneDirty = false;
     ctx.isNoteStatsDirty = false;
@@ -913,87 +787,21 @@ void ensureHitEvents(SessionContext& ctx)
     }
 }
 
+void refreshHitEvents(SessionContext&               ctx,
+                      std::span<const entt::entity> entities)
+{
+    if ( ctx.isHitEventsDirty || entities.empty() ) return;
+
+    extendMapLength(ctx, ctx.hitEvents.apply(ctx.noteRegistry, entities));
+    syncHitIndex(ctx);
+}
+
 void rebuildHitEvents(SessionContext& ctx)
 {
-    ctx.hitEvents.clear();
     ctx.nextHitIndex                = 0;
     ctx.nextBoundSoundPrefetchIndex = 0;
-
-    double maxEndTime = 0.0;
-
-    auto view     = ctx.noteRegistry.view<NoteComponent>();
-    using HitRole = System::HitFXSystem::HitEvent::Role;
-
-    for ( auto entity : view ) {
-        const auto& note = view.get<NoteComponent>(entity);
-        if ( note.m_isSubNote || note.m_isDraft ) continue;
-
-        double noteEndTime = note.m_timestamp + note.m_duration;
-        if ( noteEndTime > maxEndTime ) {
-            maxEndTime = noteEndTime;
-        }
-
-        if ( note.m_type == ::MMM::NoteType::POLYLINE ) {
-            size_t subNoteCount = note.m_subNotes.size();
-            for ( size_t i = 0; i < subNoteCount; ++i ) {
-                const auto& sn   = note.m_subNotes[i];
-                HitRole     role = HitRole::Internal;
-                if ( i == 0 )
-                    role = HitRole::Head;
-                else if ( i == subNoteCount - 1 )
-                    role = HitRole::Tail;
-
-                int span = 1;
-                if ( sn.type == ::MMM::NoteType::FLICK ) {
-                    span = std::abs(sn.dtrack) + 1;
-                }
-
-                auto sampleBinding = sn.sampleBinding;
-                if ( !sampleBinding && role == HitRole::Head ) {
-                    sampleBinding = note.m_sampleBinding;
-                }
-                ctx.hitEvents.push_back({ sn.timestamp,
-                                          sn.type,
-                                          role,
-                                          span,
-                                          sn.trackIndex,
-                                          sn.dtrack,
-                                          sn.duration,
-                                          true,
-                                          std::move(sampleBinding) });
-
-                double snEndTime = sn.timestamp + sn.duration;
-                if ( snEndTime > maxEndTime ) {
-                    maxEndTime = snEndTime;
-                }
-            }
-        } else {
-            int span = 1;
-            if ( note.m_type == ::MMM::NoteType::FLICK ) {
-                span = std::abs(note.m_dtrack) + 1;
-            }
-
-            ctx.hitEvents.push_back({ note.m_timestamp,
-                                      note.m_type,
-                                      HitRole::None,
-                                      span,
-                                      note.m_trackIndex,
-                                      note.m_dtrack,
-                                      note.m_duration,
-                                      false,
-                                      note.m_sampleBinding });
-        }
-    }
-    std::sort(ctx.hitEvents.begin(), ctx.hitEvents.end());
+    extendMapLength(ctx, ctx.hitEvents.rebuild(ctx.noteRegistry));
     ctx.isHitEventsDirty = false;
-    syncHitIndex(ctx);
-
-    if ( ctx.currentBeatmap ) {
-        double maxEndTimeMs = maxEndTime * 1000.0;
-        if ( maxEndTimeMs > ctx.currentBeatmap->m_baseMapMetadata.map_length ) {
-            ctx.currentBeatmap->m_baseMapMetadata.map_length = maxEndTimeMs;
-        }
-    }
 }
 
 }  // namespace MMM::Logic::SessionUtils
@@ -5,6 +5,7 @@
 #include "log/colorful-log.h"
 #include "logic/EditorEngine.h"
 #include "logic/ProjectDraftLaneService.h"
+#include "logic/ProjectStorage.h"
 #include "logic/ecs/components/InteractionComponent.h"
 #include "logic/ecs/components/NoteColorUtils.h"
 #include "logic/ecs/components/NoteComponent.h"
@@ -17,7 +18,9 @@
 #include "mmm/beatmap/BeatMap.h"
 #include "mmm/project/Project.h"
 #include <algorithm>
+#include <atomic>
 #include <deque>
+#include <fmt/format.h>
 #include <limits>
 #include <stb_image.h>
 #include <system_error>
@@ -88,14 +91,22 @@ void SessionUtils::loadBeatmap(SessionContext&               ctx,
     ctx.sampleRegistry.clear();
     ctx.timelineRegistry.clear();
     ctx.actionStack.clear();
-    ctx.sortedNoteEntities.clear();
-    ctx.sortedNoteMaxEndPrefix.clear();
-    ctx.sortedSampleEntities.clear();
-    ctx.sortedSampleMaxEndPrefix.clear();
+    if ( auto* project = EditorEngine::instance().getCurrentProject() ) {
+        static std::atomic<std::uint64_t> spillSerial{ 0 };
+        ctx.actionStack.setSpillPath(
+            ProjectStorage::storageDirectory(project->m_projectRoot) / "cache" /
+            "undo" /
+            fmt::format("session-{}.undo", spillSerial.fetch_add(1)));
+    } else {
+        ctx.actionStack.setSpillPath({});
+    }
+    ctx.noteVisibilityIndex.clear();
+    ctx.sampleVisibilityIndex.clear();
     ctx.annotationRenderCache.clear();
     ctx.previewDensityObjectTimes.clear();
     ctx.previewDensityCache.clear();
     ctx.lastCameraSnapshotTimes.clear();
+    ctx.noteGeometryCaches.clear();
     ctx.isNoteOrderDirty             = true;
     ctx.isNotePruneDirty             = false;
     ctx.isNoteStatsDirty             = true;
@@ -122,6 +133,7 @@ void SessionUtils::loadBeatmap(SessionContext&               ctx,
     ctx.m_draftLaneGroupRevision = 0U;
     ctx.m_draftLaneBasePayload.clear();
     ctx.m_needsDraftNotesSync                    = false;
+    SessionUtils::resetNoteWriteBack(ctx);
     ctx.audioTimelineTotalTime                   = 0.0;
     ctx.missingAudioTimelineClipCount            = 0U;
     ctx.isAudioTimelineDescriptorDirty           = true;
@@ -373,6 +385,17 @@ void SessionUtils::loadBeatmap(SessionContext&               ctx,
             glm::vec2(50.0f, 20.0f));
     }
 
+    // 顶层物件实体与领域对象一一对应，供之后的单物件编辑增量回写。
+    auto& writeBack = ctx.noteWriteBack;
+    writeBack.recordOfEntity.reserve(noteToEntity.size());
+    writeBack.entityOfRecord.reserve(noteToEntity.size());
+    for ( const auto& [record, entity] : noteToEntity ) {
+        if ( ctx.noteRegistry.get<NoteComponent>(entity).m_isSubNote ) continue;
+        writeBack.recordOfEntity.emplace(entity, const_cast<::MMM::Note*>(record));
+        writeBack.entityOfRecord.emplace(record, entity);
+    }
+    writeBack.recordsValid = true;
+
     // 6. 自动采样使用独立 Registry，避免进入判定、Combo、KPS 与 HitFX。
     for ( const auto& sample : beatmap->m_audioSamples ) {
         auto entity = ctx.sampleRegistry.create();
@@ -393,99 +416,11 @@ void SessionUtils::loadBeatmap(SessionContext&               ctx,
         }
     }
 
-    // 构建音效触发事件队列并排序
-    ctx.hitEvents.clear();
+    // 按刚建立的音符 ECS 构建音效触发事件时间线，之后的编辑只做增量刷新
+    ctx.hitEvents.rebuild(ctx.noteRegistry);
     ctx.nextHitIndex                = 0;
     ctx.nextBoundSoundPrefetchIndex = 0;
-
-    // 收集所有的 subNote 引用，避免它们被重复加入普通音符的播放队列
-    std::unordered_set<const ::MMM::Note*> subNotesSet;
-    for ( const auto& polyline : beatmap->m_noteData.polylines ) {
-        for ( const auto& subNoteRef : polyline.m_subNotes ) {
-            subNotesSet.insert(&subNoteRef.get());
-        }
-    }
-
-    using HitRole = System::HitFXSystem::HitEvent::Role;
-
-    for ( const auto& note : beatmap->m_noteData.notes ) {
-        if ( subNotesSet.find(&note) != subNotesSet.end() ) continue;
-        ctx.hitEvents.push_back({ note.m_timestamp / 1000.0,
-                                  note.m_type,
-                                  HitRole::None,
-                                  1,
-                                  static_cast<int>(note.m_track),
-                                  0,
-                                  0.0,
-                                  false,
-                                  note.getSampleBinding() });
-    }
-    for ( const auto& hold : beatmap->m_noteData.holds ) {
-        if ( subNotesSet.find(&hold) != subNotesSet.end() ) continue;
-        ctx.hitEvents.push_back({ hold.m_timestamp / 1000.0,
-                                  hold.m_type,
-                                  HitRole::None,
-                                  1,
-                                  static_cast<int>(hold.m_track),
-                                  0,
-                                  hold.m_duration / 1000.0,
-                                  false,
-                                  hold.getSampleBinding() });
-    }
-    for ( const auto& flick : beatmap->m_noteData.flicks ) {
-        if ( subNotesSet.find(&flick) != subNotesSet.end() ) continue;
-        int span = std::abs(flick.m_dtrack) + 1;
-        ctx.hitEvents.push_back({ flick.m_timestamp / 1000.0,
-                                  flick.m_type,
-                                  HitRole::None,
-                                  span,
-                                  static_cast<int>(flick.m_track),
-                                  flick.m_dtrack,
-                                  0.0,
-                                  false,
-                                  flick.getSampleBinding() });
-    }
-    for ( const auto& polyline : beatmap->m_noteData.polylines ) {
-        // 对于 Polyline 本身不发声，由子物件发声
-        size_t subNoteCount = polyline.m_subNotes.size();
-        for ( size_t i = 0; i < subNoteCount; ++i ) {
-            const auto& subNote = polyline.m_subNotes[i].get();
-
-            HitRole role = HitRole::Internal;
-            if ( i == 0 )
-                role = HitRole::Head;
-            else if ( i == subNoteCount - 1 )
-                role = HitRole::Tail;
-
-            int    span        = 1;
-            int    trackOffset = 0;
-            double duration    = 0.0;
-            if ( subNote.m_type == ::MMM::NoteType::FLICK ) {
-                const auto& f = static_cast<const ::MMM::Flick&>(subNote);
-                span          = std::abs(f.m_dtrack) + 1;
-                trackOffset   = f.m_dtrack;
-            } else if ( subNote.m_type == ::MMM::NoteType::HOLD ) {
-                const auto& h = static_cast<const ::MMM::Hold&>(subNote);
-                duration      = h.m_duration / 1000.0;
-            }
-
-            auto sampleBinding = subNote.getSampleBinding();
-            if ( !sampleBinding && role == HitRole::Head ) {
-                sampleBinding = polyline.getSampleBinding();
-            }
-            ctx.hitEvents.push_back({ subNote.m_timestamp / 1000.0,
-                                      subNote.m_type,
-                                      role,
-                                      span,
-                                      static_cast<int>(subNote.m_track),
-                                      trackOffset,
-                                      duration,
-                                      true,
-                                      std::move(sampleBinding) });
-        }
-    }
-    std::sort(ctx.hitEvents.begin(), ctx.hitEvents.end());
-    ctx.isHitEventsDirty = false;
+    ctx.isHitEventsDirty            = false;
 
     XINFO(
         "Loaded new BeatMap with {} notes, {} holds, {} flicks, {} polylines "
@@ -509,70 +444,233 @@ void SessionUtils::loadBeatmap(SessionContext&               ctx,
     ctx.isSamplePruneDirty = false;
 }
 
-bool SessionUtils::syncCreatedNoteToBeatmap(SessionContext&      ctx,
-                                            const NoteComponent& note)
+namespace
 {
-    if ( !ctx.currentBeatmap || note.m_isDraft || note.m_isSubNote ||
-         note.m_collaborationId.empty() ||
-         (note.m_type != ::MMM::NoteType::NOTE &&
-          note.m_type != ::MMM::NoteType::HOLD &&
-          note.m_type != ::MMM::NoteType::FLICK) ) {
-        return false;
-    }
 
+/// @brief 顶层正式 Note/Hold/Flick 才有一一对应的领域对象，可以逐实体回写。
+bool isWriteBackRecordNote(const NoteComponent& note)
+{
+    return !note.m_isDraft && !note.m_isSubNote &&
+           (note.m_type == ::MMM::NoteType::NOTE ||
+            note.m_type == ::MMM::NoteType::HOLD ||
+            note.m_type == ::MMM::NoteType::FLICK);
+}
+
+/// @brief 把音符组件写入同类型的领域对象，时间由秒换算为毫秒。
+/// @warning 调用方负责在修改排序键前后维护 m_allNotes。
+void assignNoteRecord(::MMM::Note& record, const NoteComponent& note)
+{
     NoteComponent synchronized = note;
     if ( hasAnyNoteColorOverride(synchronized.m_customColors) ) {
         writeNoteColorOverridesToMetadata(synchronized);
     }
 
+    record.m_type      = synchronized.m_type;
+    record.m_timestamp = synchronized.m_timestamp * 1000.0;
+    record.m_track = static_cast<std::uint32_t>(synchronized.m_trackIndex);
+    record.m_metadata        = std::move(synchronized.m_metadata);
+    record.m_annotation      = std::move(synchronized.m_annotation);
+    record.m_sampleBinding   = std::move(synchronized.m_sampleBinding);
+    record.m_collaborationId = std::move(synchronized.m_collaborationId);
+    if ( synchronized.m_type == ::MMM::NoteType::HOLD ) {
+        static_cast<::MMM::Hold&>(record).m_duration =
+            synchronized.m_duration * 1000.0;
+    } else if ( synchronized.m_type == ::MMM::NoteType::FLICK ) {
+        static_cast<::MMM::Flick&>(record).m_dtrack = synchronized.m_dtrack;
+    }
+}
+
+/// @brief 追加一个领域对象并登记到引用索引与实体映射。
+/// @return 新领域对象。
+::MMM::Note& appendNoteRecord(SessionContext& ctx, entt::entity entity,
+                              const NoteComponent& note)
+{
+    auto&        noteData = ctx.currentBeatmap->m_noteData;
+    ::MMM::Note* appended = nullptr;
+    if ( note.m_type == ::MMM::NoteType::NOTE ) {
+        appended = &noteData.notes.emplace_back();
+    } else if ( note.m_type == ::MMM::NoteType::HOLD ) {
+        appended = &noteData.holds.emplace_back();
+    } else {
+        appended = &noteData.flicks.emplace_back();
+    }
+    assignNoteRecord(*appended, note);
+    ctx.currentBeatmap->m_allNotes.insert(*appended);
+
+    auto& writeBack = ctx.noteWriteBack;
+    if ( writeBack.recordsValid && entity != entt::null ) {
+        writeBack.recordOfEntity[entity]    = appended;
+        writeBack.entityOfRecord[appended] = entity;
+    }
+    return *appended;
+}
+
+/// @brief 把折线对 from 的子物件引用改指向 to。
+/// @return 找到引用 from 的折线时返回 true。
+bool repointPolylineSubNote(::MMM::BeatMap& beatmap, const ::MMM::Note& from,
+                            ::MMM::Note& to)
+{
+    for ( auto& polyline : beatmap.m_noteData.polylines ) {
+        for ( auto& subNote : polyline.m_subNotes ) {
+            if ( &subNote.get() != &from ) continue;
+            subNote = std::ref(to);
+            if ( to.m_type == ::MMM::NoteType::HOLD ) {
+                for ( auto& hold : polyline.m_subHolds ) {
+                    if ( &hold.get() == &from ) {
+                        hold = std::ref(static_cast<::MMM::Hold&>(to));
+                    }
+                }
+            } else if ( to.m_type == ::MMM::NoteType::FLICK ) {
+                for ( auto& flick : polyline.m_subFlicks ) {
+                    if ( &flick.get() == &from ) {
+                        flick = std::ref(static_cast<::MMM::Flick&>(to));
+                    }
+                }
+            }
+            return true;
+        }
+    }
+    return false;
+}
+
+/// @brief 从容器中删除 record：把末尾对象搬入空位后弹出末尾。
+/// @details 只有末尾对象的地址改变，其引用索引、实体映射或折线子物件引用
+/// 随之更新；其余领域对象地址保持稳定。
+/// @return 末尾对象的所有者无法确定时返回 false，调用方回退整体重建。
+template<typename Record>
+bool removeNoteRecord(SessionContext& ctx, std::deque<Record>& records,
+                      Record& record)
+{
+    auto& beatmap   = *ctx.currentBeatmap;
+    auto& writeBack = ctx.noteWriteBack;
+    beatmap.m_allNotes.erase(record);
+
+    Record& last = records.back();
+    if ( &last != &record ) {
+        if ( const auto owner = writeBack.entityOfRecord.find(&last);
+             owner != writeBack.entityOfRecord.end() ) {
+            const entt::entity moved = owner->second;
+            writeBack.entityOfRecord.erase(owner);
+            writeBack.entityOfRecord[&record] = moved;
+            writeBack.recordOfEntity[moved]   = &record;
+        } else if ( !repointPolylineSubNote(beatmap, last, record) ) {
+            return false;
+        }
+        beatmap.m_allNotes.erase(last);
+        record = std::move(last);
+        beatmap.m_allNotes.insert(record);
+    }
+    records.pop_back();
+    return true;
+}
+
+/// @brief 按领域对象类型从对应容器中删除。
+bool removeNoteRecord(SessionContext& ctx, ::MMM::Note& record)
+{
+    auto& noteData = ctx.currentBeatmap->m_noteData;
+    switch ( record.m_type ) {
+    case ::MMM::NoteType::NOTE:
+        return removeNoteRecord(ctx, noteData.notes, record);
+    case ::MMM::NoteType::HOLD:
+        return removeNoteRecord(
+            ctx, noteData.holds, static_cast<::MMM::Hold&>(record));
+    case ::MMM::NoteType::FLICK:
+        return removeNoteRecord(
+            ctx, noteData.flicks, static_cast<::MMM::Flick&>(record));
+    default: return false;
+    }
+}
+
+/// @brief 只把脏实体对应的领域对象修补到 currentBeatmap。
+/// @return 全部脏实体都能逐个回写时返回 true；返回 false 时领域物件容器
+/// 可能已部分修改，调用方必须整体重建。
+/// @warning 逻辑编辑热路径：耗时只与脏实体数成正比，禁止遍历完整 ECS。
+bool patchDirtyNoteRecords(SessionContext& ctx)
+{
+    auto& writeBack = ctx.noteWriteBack;
+    auto& reg       = ctx.noteRegistry;
+    for ( const entt::entity entity : writeBack.dirtyEntities ) {
+        const NoteComponent* current =
+            reg.valid(entity) ? reg.try_get<NoteComponent>(entity) : nullptr;
+        if ( current && !current->m_isDraft && !isWriteBackRecordNote(*current) ) {
+            return false;
+        }
+        const bool wanted = current && !current->m_isDraft;
+
+        ::MMM::Note* record = nullptr;
+        if ( const auto found = writeBack.recordOfEntity.find(entity);
+             found != writeBack.recordOfEntity.end() ) {
+            record = found->second;
+        }
+
+        if ( record && wanted && record->m_type == current->m_type ) {
+            auto& allNotes = ctx.currentBeatmap->m_allNotes;
+            allNotes.erase(*record);
+            assignNoteRecord(*record, *current);
+            allNotes.insert(*record);
+            continue;
+        }
+        if ( record ) {
+            writeBack.recordOfEntity.erase(entity);
+            writeBack.entityOfRecord.erase(record);
+            if ( !removeNoteRecord(ctx, *record) ) return false;
+        }
+        if ( wanted ) appendNoteRecord(ctx, entity, *current);
+    }
+    return true;
+}
+
+}  // namespace
+
+void SessionUtils::markNoteWriteBackDirty(SessionContext&      ctx,
+                                          entt::entity         entity,
+                                          const NoteComponent* before,
+                                          const NoteComponent* after)
+{
+    const bool touchesFormal =
+        (before && !before->m_isDraft) || (after && !after->m_isDraft);
+    if ( !touchesFormal ) return;
+
+    ctx.m_needsNotesSync = true;
+    auto&      writeBack = ctx.noteWriteBack;
+    const auto perEntity = [](const NoteComponent* note) {
+        return !note || note->m_isDraft || isWriteBackRecordNote(*note);
+    };
+    if ( entity == entt::null || !perEntity(before) || !perEntity(after) ) {
+        writeBack.needsFullRebuild = true;
+        return;
+    }
+    if ( !writeBack.needsFullRebuild ) writeBack.dirtyEntities.insert(entity);
+}
+
+void SessionUtils::markNotesFullSync(SessionContext& ctx)
+{
+    ctx.m_needsNotesSync                = true;
+    ctx.noteWriteBack.needsFullRebuild = true;
+}
+
+void SessionUtils::resetNoteWriteBack(SessionContext& ctx)
+{
+    auto& writeBack = ctx.noteWriteBack;
+    writeBack.dirtyEntities.clear();
+    writeBack.needsFullRebuild = false;
+    writeBack.recordOfEntity.clear();
+    writeBack.entityOfRecord.clear();
+    writeBack.recordsValid = false;
+}
+
+bool SessionUtils::syncCreatedNoteToBeatmap(SessionContext&      ctx,
+                                            entt::entity         entity,
+                                            const NoteComponent& note)
+{
+    if ( !ctx.currentBeatmap || note.m_collaborationId.empty() ||
+         !isWriteBackRecordNote(note) ) {
+        return false;
+    }
+
     auto& mutex = EditorEngine::instance().getSessionMutex();
     std::lock_guard<std::recursive_mutex> lock(mutex);
-    ::MMM::Note*                          appended = nullptr;
-    if ( synchronized.m_type == ::MMM::NoteType::NOTE ) {
-        auto& target      = ctx.currentBeatmap->m_noteData.notes;
-        auto& value       = target.emplace_back();
-        value.m_type      = ::MMM::NoteType::NOTE;
-        value.m_timestamp = synchronized.m_timestamp * 1000.0;
-        value.m_track = static_cast<std::uint32_t>(synchronized.m_trackIndex);
-        value.m_metadata        = synchronized.m_metadata;
-        value.m_annotation      = synchronized.m_annotation;
-        value.m_sampleBinding   = synchronized.m_sampleBinding;
-        value.m_collaborationId = synchronized.m_collaborationId;
-        appended                = &value;
-    } else if ( synchronized.m_type == ::MMM::NoteType::HOLD ) {
-        auto& target      = ctx.currentBeatmap->m_noteData.holds;
-        auto& value       = target.emplace_back();
-        value.m_type      = ::MMM::NoteType::HOLD;
-        value.m_timestamp = synchronized.m_timestamp * 1000.0;
-        value.m_track = static_cast<std::uint32_t>(synchronized.m_trackIndex);
-        value.m_duration        = synchronized.m_duration * 1000.0;
-        value.m_metadata        = synchronized.m_metadata;
-        value.m_annotation      = synchronized.m_annotation;
-        value.m_sampleBinding   = synchronized.m_sampleBinding;
-        value.m_collaborationId = synchronized.m_collaborationId;
-        appended                = &value;
-    } else {
-        auto& target      = ctx.currentBeatmap->m_noteData.flicks;
-        auto& value       = target.emplace_back();
-        value.m_type      = ::MMM::NoteType::FLICK;
-        value.m_timestamp = synchronized.m_timestamp * 1000.0;
-        value.m_track  = static_cast<std::uint32_t>(synchronized.m_trackIndex);
-        value.m_dtrack = synchronized.m_dtrack;
-        value.m_metadata        = synchronized.m_metadata;
-        value.m_annotation      = synchronized.m_annotation;
-        value.m_sampleBinding   = synchronized.m_sampleBinding;
-        value.m_collaborationId = synchronized.m_collaborationId;
-        appended                = &value;
-    }
-
-    const auto insertion = std::upper_bound(
-        ctx.currentBeatmap->m_allNotes.begin(),
-        ctx.currentBeatmap->m_allNotes.end(),
-        appended->m_timestamp,
-        [](double timestamp, const std::reference_wrapper<::MMM::Note>& value) {
-            return timestamp < value.get().m_timestamp;
-        });
-    ctx.currentBeatmap->m_allNotes.insert(insertion, *appended);
+    appendNoteRecord(ctx, entity, note);
     return true;
 }
 
@@ -585,10 +683,33 @@ void SessionUtils::syncBeatmap(SessionContext& ctx)
         return;
     }
 
+    // 单物件编辑只修补脏实体对应的领域对象；无法逐实体表达或修补中途失败
+    // 时保留 m_needsNotesSync，由下方整体重建兜底。
+    auto& writeBack = ctx.noteWriteBack;
+    if ( ctx.m_needsNotesSync && !writeBack.needsFullRebuild &&
+         writeBack.recordsValid && !writeBack.dirtyEntities.empty() ) {
+        auto& mutex = EditorEngine::instance().getSessionMutex();
+        std::lock_guard<std::recursive_mutex> lock(mutex);
+        if ( patchDirtyNoteRecords(ctx) ) {
+            ctx.m_needsNotesSync = false;
+            writeBack.dirtyEntities.clear();
+        } else {
+            XWARN("Incremental note write-back fell back to a full rebuild");
+        }
+    }
+    if ( !ctx.m_needsTimingsSync && !ctx.m_needsNotesSync &&
+         !ctx.m_needsSamplesSync ) {
+        ctx.isAudioTimelineDescriptorDirty = true;
+        return;
+    }
+
     std::vector<Timing>                       newTimings;
     std::vector<std::reference_wrapper<Note>> newAllNotes;
+    NoteOrderIndex                            newNoteOrder;
     NoteData                                  newNoteData;
     std::deque<AudioSampleEvent>              newAudioSamples;
+    std::unordered_map<entt::entity, Note*>       newRecordOfEntity;
+    std::unordered_map<const Note*, entt::entity> newEntityOfRecord;
 
     if ( ctx.m_needsTimingsSync ) {
         auto tlView = ctx.timelineRegistry.view<TimelineComponent>();
@@ -650,6 +771,8 @@ void SessionUtils::syncBeatmap(SessionContext& ctx)
                 n.m_collaborationId = syncedNote.m_collaborationId;
                 newNoteData.notes.push_back(std::move(n));
                 newAllNotes.push_back(newNoteData.notes.back());
+                newRecordOfEntity.emplace(entity, &newNoteData.notes.back());
+                newEntityOfRecord.emplace(&newNoteData.notes.back(), entity);
             } else if ( nc.m_type == ::MMM::NoteType::HOLD ) {
                 Hold h;
                 h.m_type       = ::MMM::NoteType::HOLD;
@@ -662,6 +785,8 @@ void SessionUtils::syncBeatmap(SessionContext& ctx)
                 h.m_collaborationId = syncedNote.m_collaborationId;
                 newNoteData.holds.push_back(std::move(h));
                 newAllNotes.push_back(newNoteData.holds.back());
+                newRecordOfEntity.emplace(entity, &newNoteData.holds.back());
+                newEntityOfRecord.emplace(&newNoteData.holds.back(), entity);
             } else if ( nc.m_type == ::MMM::NoteType::FLICK ) {
                 Flick f;
                 f.m_type       = ::MMM::NoteType::FLICK;
@@ -674,6 +799,8 @@ void SessionUtils::syncBeatmap(SessionContext& ctx)
                 f.m_collaborationId = syncedNote.m_collaborationId;
                 newNoteData.flicks.push_back(std::move(f));
                 newAllNotes.push_back(newNoteData.flicks.back());
+                newRecordOfEntity.emplace(entity, &newNoteData.flicks.back());
+                newEntityOfRecord.emplace(&newNoteData.flicks.back(), entity);
             }
         }
 
@@ -756,12 +883,7 @@ void SessionUtils::syncBeatmap(SessionContext& ctx)
             newAllNotes.push_back(newNoteData.polylines.back());
         }
 
-        std::sort(newAllNotes.begin(),
-                  newAllNotes.end(),
-                  [](const std::reference_wrapper<Note>& a,
-                     const std::reference_wrapper<Note>& b) {
-                      return a.get().m_timestamp < b.get().m_timestamp;
-                  });
+        newNoteOrder.assign(std::move(newAllNotes));
     }
 
     if ( ctx.m_needsSamplesSync ) {
@@ -799,12 +921,18 @@ void SessionUtils::syncBeatmap(SessionContext& ctx)
             ctx.currentBeatmap->m_timings.swap(newTimings);
         }
         if ( ctx.m_needsNotesSync ) {
-            ctx.currentBeatmap->m_allNotes.swap(newAllNotes);
+            ctx.currentBeatmap->m_allNotes.swap(newNoteOrder);
             ctx.currentBeatmap->m_noteData.notes.swap(newNoteData.notes);
             ctx.currentBeatmap->m_noteData.holds.swap(newNoteData.holds);
             ctx.currentBeatmap->m_noteData.flicks.swap(newNoteData.flicks);
             ctx.currentBeatmap->m_noteData.polylines.swap(
                 newNoteData.polylines);
+            // deque 交换不移动元素，映射中的地址仍指向新容器内的对象。
+            writeBack.recordOfEntity.swap(newRecordOfEntity);
+            writeBack.entityOfRecord.swap(newEntityOfRecord);
+            writeBack.recordsValid     = true;
+            writeBack.needsFullRebuild = false;
+            writeBack.dirtyEntities.clear();
         }
         if ( ctx.m_needsSamplesSync ) {
             ctx.currentBeatmap->m_audioSamples.swap(newAudioSamples);
@@ -0,0 +1,332 @@
+#include "logic/session/TimeIntervalIndex.h"
+#include <algorithm>
+#include <limits>
+#include <utility>
+
+namespace MMM::Logic
+{
+
+namespace
+{
+
+/// @brief 线段树中空叶子的取值，任何查询时刻都不会命中。
+constexpr double EMPTY_LEAF = -std::numeric_limits<double>::infinity();
+
+/// @brief 条目序列的最大结束时间；空序列返回 EMPTY_LEAF。
+double maxEndOf(const std::vector<TimeIntervalIndex::Entry>& entries)
+{
+    double maxEnd = EMPTY_LEAF;
+    for ( const auto& entry : entries ) {
+        maxEnd = std::max(maxEnd, entry.endTime);
+    }
+    return maxEnd;
+}
+
+}  // namespace
+
+double TimeIntervalIndex::noteEndTime(const NoteComponent& note)
+{
+    double end = note.m_timestamp + std::max(0.0, note.m_duration);
+    if ( note.m_type == ::MMM::NoteType::POLYLINE ) {
+        for ( const auto& sub : note.m_subNotes ) {
+            end = std::max(end, sub.timestamp + std::max(0.0, sub.duration));
+        }
+    }
+    return end;
+}
+
+TimeIntervalIndex::Entry TimeIntervalIndex::makeEntry(
+    entt::entity entity, const NoteComponent& note)
+{
+    return { entity, note.m_timestamp, noteEndTime(note) };
+}
+
+TimeIntervalIndex::Entry TimeIntervalIndex::makeEntry(
+    entt::entity entity, const SampleComponent& sample)
+{
+    const auto [start, end] =
+        std::minmax(sample.m_timestamp, sample.effectiveTime());
+    return { entity, start, end };
+}
+
+bool TimeIntervalIndex::keyLess(double lhsStart, entt::entity lhsEntity,
+                                  double rhsStart, entt::entity rhsEntity)
+{
+    if ( lhsStart != rhsStart ) return lhsStart < rhsStart;
+    return entt::to_integral(lhsEntity) < entt::to_integral(rhsEntity);
+}
+
+void TimeIntervalIndex::assign(std::vector<Entry> entries)
+{
+    clear();
+    // 同一实体重复出现时保留最后一条，与逐条 insert() 的结果一致。
+    std::vector<Entry> unique;
+    unique.reserve(entries.size());
+    m_startOf.reserve(entries.size());
+    std::unordered_map<entt::entity, std::size_t> positionOf;
+    positionOf.reserve(entries.size());
+    for ( const auto& entry : entries ) {
+        const auto [found, inserted] =
+            positionOf.try_emplace(entry.entity, unique.size());
+        if ( inserted ) {
+            unique.push_back(entry);
+        } else {
+            unique[found->second] = entry;
+        }
+    }
+    std::sort(
+        unique.begin(), unique.end(), [](const Entry& lhs, const Entry& rhs) {
+            return keyLess(
+                lhs.startTime, lhs.entity, rhs.startTime, rhs.entity);
+        });
+
+    m_chunks.reserve((unique.size() + FILL_CHUNK_SIZE - 1) / FILL_CHUNK_SIZE);
+    for ( std::size_t first = 0; first < unique.size();
+          first += FILL_CHUNK_SIZE ) {
+        const std::size_t last =
+            std::min(unique.size(), first + FILL_CHUNK_SIZE);
+        auto& chunk = m_chunks.emplace_back();
+        chunk.entries.assign(unique.begin() + static_cast<std::ptrdiff_t>(first),
+                             unique.begin() + static_cast<std::ptrdiff_t>(last));
+        chunk.maxEnd = maxEndOf(chunk.entries);
+        for ( const auto& entry : chunk.entries ) {
+            m_startOf.emplace(entry.entity, entry.startTime);
+        }
+    }
+    m_size = unique.size();
+    rebuildTree();
+}
+
+void TimeIntervalIndex::insert(const Entry& entry)
+{
+    erase(entry.entity);
+
+    if ( m_chunks.empty() ) {
+        auto& chunk = m_chunks.emplace_back();
+        chunk.entries.push_back(entry);
+        chunk.maxEnd = entry.endTime;
+        m_startOf.emplace(entry.entity, entry.startTime);
+        m_size = 1;
+        rebuildTree();
+        return;
+    }
+
+    const std::size_t chunkIndex = chunkFor(entry.startTime, entry.entity);
+    auto&             entries    = m_chunks[chunkIndex].entries;
+    const auto        position   = std::lower_bound(
+        entries.begin(),
+        entries.end(),
+        entry,
+        [](const Entry& lhs, const Entry& rhs) {
+            return keyLess(
+                lhs.startTime, lhs.entity, rhs.startTime, rhs.entity);
+        });
+    entries.insert(position, entry);
+    m_startOf.emplace(entry.entity, entry.startTime);
+    ++m_size;
+
+    if ( entries.size() <= MAX_CHUNK_SIZE ) {
+        auto& chunk  = m_chunks[chunkIndex];
+        chunk.maxEnd = std::max(chunk.maxEnd, entry.endTime);
+        updateTreeLeaf(chunkIndex);
+        return;
+    }
+
+    // 分块过大时对半拆分；分块数变化后整体重建线段树（只有分块数个叶子）。
+    Chunk upper;
+    upper.entries.assign(
+        entries.begin() + static_cast<std::ptrdiff_t>(entries.size() / 2),
+        entries.end());
+    entries.resize(entries.size() / 2);
+    m_chunks.insert(m_chunks.begin() + static_cast<std::ptrdiff_t>(chunkIndex) +
+                        1,
+                    std::move(upper));
+    m_chunks[chunkIndex].maxEnd = maxEndOf(m_chunks[chunkIndex].entries);
+    m_chunks[chunkIndex + 1].maxEnd =
+        maxEndOf(m_chunks[chunkIndex + 1].entries);
+    rebuildTree();
+}
+
+bool TimeIntervalIndex::erase(entt::entity entity)
+{
+    const auto found = m_startOf.find(entity);
+    if ( found == m_startOf.end() ) return false;
+    const double startTime = found->second;
+    m_startOf.erase(found);
+
+    const std::size_t chunkIndex = chunkFor(startTime, entity);
+    auto&             entries    = m_chunks[chunkIndex].entries;
+    const auto        position   = std::lower_bound(
+        entries.begin(),
+        entries.end(),
+        std::pair{ startTime, entity },
+        [](const Entry& lhs, const std::pair<double, entt::entity>& key) {
+            return keyLess(lhs.startTime, lhs.entity, key.first, key.second);
+        });
+    entries.erase(position);
+    --m_size;
+
+    if ( entries.empty() ) {
+        m_chunks.erase(m_chunks.begin() +
+                       static_cast<std::ptrdiff_t>(chunkIndex));
+        rebuildTree();
+        return true;
+    }
+    // 与过小的后继分块合并，避免大量删除后留下许多零碎分块。
+    const std::size_t next = chunkIndex + 1;
+    if ( next < m_chunks.size() &&
+         entries.size() + m_chunks[next].entries.size() <= FILL_CHUNK_SIZE / 2 ) {
+        auto& following = m_chunks[next].entries;
+        entries.insert(entries.end(), following.begin(), following.end());
+        m_chunks.erase(m_chunks.begin() + static_cast<std::ptrdiff_t>(next));
+        m_chunks[chunkIndex].maxEnd = maxEndOf(entries);
+        rebuildTree();
+        return true;
+    }
+    refreshChunk(chunkIndex);
+    return true;
+}
+
+void TimeIntervalIndex::clear()
+{
+    m_chunks.clear();
+    m_maxEndTree.clear();
+    m_treeLeaves = 0;
+    m_startOf.clear();
+    m_size = 0;
+}
+
+TimeIntervalIndex::const_iterator TimeIntervalIndex::firstEndingAtOrAfter(
+    double time) const
+{
+    if ( m_treeLeaves == 0 || !(m_maxEndTree[1] >= time) ) return end();
+
+    std::size_t node = 1;
+    while ( node < m_treeLeaves ) {
+        node = m_maxEndTree[node * 2] >= time ? node * 2 : node * 2 + 1;
+    }
+    const std::size_t chunkIndex = node - m_treeLeaves;
+    const auto&       entries    = m_chunks[chunkIndex].entries;
+    for ( std::size_t offset = 0; offset < entries.size(); ++offset ) {
+        if ( entries[offset].endTime >= time ) {
+            return { this, chunkIndex, offset };
+        }
+    }
+    return end();
+}
+
+TimeIntervalIndex::const_iterator TimeIntervalIndex::upperBoundStart(
+    double time) const
+{
+    const auto chunk = std::upper_bound(
+        m_chunks.begin(),
+        m_chunks.end(),
+        time,
+        [](double value, const Chunk& current) {
+            return value < current.entries.back().startTime;
+        });
+    if ( chunk == m_chunks.end() ) return end();
+
+    const auto offset = std::upper_bound(
+        chunk->entries.begin(),
+        chunk->entries.end(),
+        time,
+        [](double value, const Entry& entry) {
+            return value < entry.startTime;
+        });
+    return { this,
+             static_cast<std::size_t>(std::distance(m_chunks.begin(), chunk)),
+             static_cast<std::size_t>(
+                 std::distance(chunk->entries.begin(), offset)) };
+}
+
+bool TimeIntervalIndex::isConsistent() const
+{
+    std::size_t count    = 0;
+    const Entry* previous = nullptr;
+    for ( std::size_t chunk = 0; chunk < m_chunks.size(); ++chunk ) {
+        const auto& current = m_chunks[chunk];
+        if ( current.entries.empty() ||
+             current.entries.size() > MAX_CHUNK_SIZE ) {
+            return false;
+        }
+        for ( const auto& entry : current.entries ) {
+            if ( previous && !keyLess(previous->startTime,
+                                      previous->entity,
+                                      entry.startTime,
+                                      entry.entity) ) {
+                return false;
+            }
+            const auto found = m_startOf.find(entry.entity);
+            if ( found == m_startOf.end() ||
+                 found->second != entry.startTime ) {
+                return false;
+            }
+            previous = &entry;
+            ++count;
+        }
+        const double maxEnd = maxEndOf(current.entries);
+        if ( maxEnd != current.maxEnd ||
+             m_maxEndTree[m_treeLeaves + chunk] != maxEnd ) {
+            return false;
+        }
+    }
+    for ( std::size_t node = 1; node < m_treeLeaves; ++node ) {
+        if ( m_maxEndTree[node] !=
+             std::max(m_maxEndTree[node * 2], m_maxEndTree[node * 2 + 1]) ) {
+            return false;
+        }
+    }
+    return count == m_size && m_startOf.size() == m_size;
+}
+
+std::size_t TimeIntervalIndex::chunkFor(double       startTime,
+                                          entt::entity entity) const
+{
+    const auto chunk = std::lower_bound(
+        m_chunks.begin(),
+        m_chunks.end(),
+        std::pair{ startTime, entity },
+        [](const Chunk& current, const std::pair<double, entt::entity>& key) {
+            const auto& last = current.entries.back();
+            return keyLess(last.startTime, last.entity, key.first, key.second);
+        });
+    if ( chunk == m_chunks.end() ) return m_chunks.size() - 1;
+    return static_cast<std::size_t>(std::distance(m_chunks.begin(), chunk));
+}
+
+void TimeIntervalIndex::refreshChunk(std::size_t chunk)
+{
+    m_chunks[chunk].maxEnd = maxEndOf(m_chunks[chunk].entries);
+    updateTreeLeaf(chunk);
+}
+
+void TimeIntervalIndex::rebuildTree()
+{
+    m_treeLeaves = 0;
+    m_maxEndTree.clear();
+    if ( m_chunks.empty() ) return;
+
+    m_treeLeaves = 1;
+    while ( m_treeLeaves < m_chunks.size() ) m_treeLeaves *= 2;
+    m_maxEndTree.assign(m_treeLeaves * 2, EMPTY_LEAF);
+    for ( std::size_t chunk = 0; chunk < m_chunks.size(); ++chunk ) {
+        m_maxEndTree[m_treeLeaves + chunk] = m_chunks[chunk].maxEnd;
+    }
+    for ( std::size_t node = m_treeLeaves - 1; node > 0; --node ) {
+        m_maxEndTree[node] =
+            std::max(m_maxEndTree[node * 2], m_maxEndTree[node * 2 + 1]);
+    }
+}
+
+void TimeIntervalIndex::updateTreeLeaf(std::size_t chunk)
+{
+    std::size_t node  = m_treeLeaves + chunk;
+    m_maxEndTree[node] = m_chunks[chunk].maxEnd;
+    for ( node /= 2; node > 0; node /= 2 ) {
+        m_maxEndTree[node] =
+            std::max(m_maxEndTree[node * 2], m_maxEndTree[node * 2 + 1]);
+    }
+}
+
+}  // namespace MMM::Logic
@@ -32,6 +32,7 @@
 #include <filesystem>
 #include <limits>
 #include <memory>
+#include <span>
 #include <string_view>
 #include <unordered_map>
 #include <unordered_set>
@@ -1768,8 +1769,7 @@ bool testAuthoritativeReplacementPreservesOwnedCreateUndo()
     const auto collaborationId =
         context.noteRegistry.get<MMM::Logic::NoteComponent>(staleEntity)
             .m_collaborationId;
-    context.sortedNoteEntities.push_back(staleEntity);
-    context.sortedNoteMaxEndPrefix.push_back(1.0);
+    context.noteVisibilityIndex.insert({ staleEntity, 1.0, 1.0 });
     context.noteRegistry.emplace_or_replace<MMM::Logic::InteractionComponent>(
         staleEntity,
         MMM::Logic::InteractionComponent{
@@ -1841,8 +1841,7 @@ bool testAuthoritativeReplacementPreservesOwnedCreateUndo()
          context.marqueeBoxes.size() != 1U ||
          !context.isMarqueeSelectionDirty ||
          context.draggedEntity != entt::null ||
-         !context.sortedNoteEntities.empty() ||
-         !context.sortedNoteMaxEndPrefix.empty() ||
+         !context.noteVisibilityIndex.empty() ||
          !context.isNoteOrderDirty ) {
         XERROR("Authoritative replacement did not preserve owned create undo");
         return false;
@@ -1970,6 +1969,157 @@ bool testPolylineSubNoteIdentitySurvivesRepeatedEcsSync()
     return true;
 }
 
+/// @brief 验证单物件编辑只修补对应的领域对象，其余对象地址保持稳定。
+/// @return 更新、删除与创建后领域对象、引用索引与折线子物件引用一致时返回 true。
+bool testIncrementalNoteWriteBackPatchesRecords()
+{
+    auto beatmap                           = std::make_shared<MMM::BeatMap>();
+    beatmap->m_baseMapMetadata.track_count = 4;
+    for ( int index = 0; index < 3; ++index ) {
+        auto& note       = beatmap->m_noteData.notes.emplace_back();
+        note.m_timestamp = 1000.0 * (index + 1);
+        note.m_track     = static_cast<std::uint32_t>(index);
+    }
+    auto& rootHold      = beatmap->m_noteData.holds.emplace_back();
+    rootHold.m_timestamp = 4000.0;
+    rootHold.m_duration  = 500.0;
+    rootHold.m_track     = 3;
+    auto& subHold       = beatmap->m_noteData.holds.emplace_back();
+    subHold.m_timestamp = 5000.0;
+    subHold.m_duration  = 250.0;
+    subHold.m_track     = 1;
+    subHold.m_isSubNote = true;
+    auto& subFlick       = beatmap->m_noteData.flicks.emplace_back();
+    subFlick.m_timestamp = 5250.0;
+    subFlick.m_track     = 1;
+    subFlick.m_dtrack    = 1;
+    subFlick.m_isSubNote = true;
+    auto& polyline = beatmap->m_noteData.polylines.emplace_back();
+    polyline.m_subNotes.emplace_back(subHold);
+    polyline.m_subNotes.emplace_back(subFlick);
+    polyline.m_subHolds.emplace_back(subHold);
+    polyline.m_subFlicks.emplace_back(subFlick);
+    beatmap->sync();
+
+    MMM::Logic::SessionContext context;
+    MMM::Logic::SessionUtils::loadBeatmap(context, beatmap);
+    const auto findEntity = [&](MMM::NoteType type, double timestamp) {
+        auto view = context.noteRegistry.view<MMM::Logic::NoteComponent>();
+        for ( auto entity : view ) {
+            const auto& note = view.get<MMM::Logic::NoteComponent>(entity);
+            if ( !note.m_isSubNote && note.m_type == type &&
+                 near(note.m_timestamp, timestamp) ) {
+                return entity;
+            }
+        }
+        return entt::entity{ entt::null };
+    };
+    const auto recordsConsistent = [&](std::size_t expectedIndexed) {
+        const auto& data  = beatmap->m_noteData;
+        const auto& poly  = data.polylines.front();
+        return beatmap->m_allNotes.isConsistent() &&
+               beatmap->m_allNotes.size() == expectedIndexed &&
+               poly.m_subNotes.size() == 2U && poly.m_subHolds.size() == 1U &&
+               poly.m_subFlicks.size() == 1U &&
+               &poly.m_subNotes[0].get() == &poly.m_subHolds[0].get() &&
+               &poly.m_subNotes[1].get() == &poly.m_subFlicks[0].get() &&
+               poly.m_subHolds[0].get().m_isSubNote &&
+               near(poly.m_subHolds[0].get().m_timestamp, 5000.0) &&
+               near(poly.m_subFlicks[0].get().m_timestamp, 5250.0);
+    };
+    const std::size_t indexed = beatmap->m_allNotes.size();
+
+    const auto middle = findEntity(MMM::NoteType::NOTE, 2.0);
+    if ( middle == entt::entity{ entt::null } ) {
+        XERROR("Incremental write-back setup did not create the middle note");
+        return false;
+    }
+    const MMM::Note* middleRecord = &beatmap->m_noteData.notes[1];
+    auto before = context.noteRegistry.get<MMM::Logic::NoteComponent>(middle);
+    auto after  = before;
+    after.m_timestamp  = 2.5;
+    after.m_trackIndex = 3;
+    context.actionStack.pushAndExecute(
+        std::make_unique<MMM::Logic::NoteAction>(
+            MMM::Logic::NoteAction::Type::Update, middle, before, after),
+        context);
+    MMM::Logic::SessionUtils::syncBeatmap(context);
+    if ( context.m_needsNotesSync ||
+         &beatmap->m_noteData.notes[1] != middleRecord ||
+         !near(middleRecord->m_timestamp, 2500.0) ||
+         middleRecord->m_track != 3U ||
+         beatmap->m_noteData.notes.size() != 3U ||
+         !recordsConsistent(indexed) ) {
+        XERROR("Note update was not patched into its existing record");
+        return false;
+    }
+
+    const auto first = findEntity(MMM::NoteType::NOTE, 1.0);
+    context.actionStack.pushAndExecute(
+        std::make_unique<MMM::Logic::NoteAction>(
+            MMM::Logic::NoteAction::Type::Delete,
+            first,
+            context.noteRegistry.get<MMM::Logic::NoteComponent>(first),
+            std::nullopt),
+        context);
+    MMM::Logic::SessionUtils::syncBeatmap(context);
+    if ( beatmap->m_noteData.notes.size() != 2U ||
+         !near(beatmap->m_noteData.notes[0].m_timestamp, 3000.0) ||
+         &beatmap->m_noteData.notes[1] != middleRecord ||
+         !recordsConsistent(indexed - 1U) ) {
+        XERROR("Note deletion did not compact its record container");
+        return false;
+    }
+
+    // 删除根 Hold 会把折线子 Hold 搬入空位，折线引用必须随之改指。
+    const auto hold = findEntity(MMM::NoteType::HOLD, 4.0);
+    context.actionStack.pushAndExecute(
+        std::make_unique<MMM::Logic::NoteAction>(
+            MMM::Logic::NoteAction::Type::Delete,
+            hold,
+            context.noteRegistry.get<MMM::Logic::NoteComponent>(hold),
+            std::nullopt),
+        context);
+    MMM::Logic::SessionUtils::syncBeatmap(context);
+    if ( beatmap->m_noteData.holds.size() != 1U ||
+         &beatmap->m_noteData.polylines.front().m_subHolds[0].get() !=
+             &beatmap->m_noteData.holds[0] ||
+         !recordsConsistent(indexed - 2U) ) {
+        XERROR("Hold deletion broke polyline sub-note references");
+        return false;
+    }
+
+    MMM::Logic::NoteComponent created;
+    created.m_type       = MMM::NoteType::FLICK;
+    created.m_timestamp  = 6.0;
+    created.m_trackIndex = 2;
+    created.m_dtrack     = -1;
+    context.actionStack.pushAndExecute(
+        std::make_unique<MMM::Logic::NoteAction>(
+            MMM::Logic::NoteAction::Type::Create,
+            entt::null,
+            std::nullopt,
+            created),
+        context);
+    MMM::Logic::SessionUtils::syncBeatmap(context);
+    if ( beatmap->m_noteData.flicks.size() != 2U ||
+         beatmap->m_noteData.flicks.back().m_dtrack != -1 ||
+         !recordsConsistent(indexed - 1U) ) {
+        XERROR("Note creation was not appended to the record containers");
+        return false;
+    }
+
+    // 撤销全部操作后仍只修补受影响的记录，最终与初始物件集合一致。
+    for ( int step = 0; step < 4; ++step ) {
+        context.actionStack.undo(context);
+    }
+    MMM::Logic::SessionUtils::syncBeatmap(context);
+    return beatmap->m_noteData.notes.size() == 3U &&
+           beatmap->m_noteData.holds.size() == 2U &&
+           beatmap->m_noteData.flicks.size() == 1U &&
+           recordsConsistent(indexed);
+}
+
 /// @brief 验证在运行时追加空轨放置采样会持久扩展 BGM 轨道数。
 /// @return 扩展及 Undo/Redo 均恢复完整状态时返回 true。
 bool testAppendLaneExpandsPersistentCount()
@@ -2318,16 +2468,80 @@ bool testNoteSampleBindingRoundTrip()
          domainBinding->m_audioResourceId != "replacement-effect" ||
          !near(domainBinding->m_volume, 0.75) ||
          context.hitEvents.size() != 1 ||
-         !context.hitEvents.front().sampleBinding ||
-         context.hitEvents.front().sampleBinding->m_audioResourceId !=
-             "replacement-effect" ||
-         !near(context.hitEvents.front().sampleBinding->m_volume, 0.75) ) {
+         !context.hitEvents[0].sampleResource ||
+         *context.hitEvents[0].sampleResource != "replacement-effect" ||
+         !near(context.hitEvents[0].sampleVolume, 0.75) ) {
         XERROR("ECS note sample binding did not sync to domain and HitEvent");
         return false;
     }
     return true;
 }
 
+/// @brief 验证增量缓存维护按索引版本记录修改前后的起始时间。
+/// @return 移动记录两个时间、完整重建后旧版本无法增量回放时返回 true。
+bool testIncrementalNoteCacheRecordsDirtyTimes()
+{
+    MMM::Logic::SessionContext context;
+    const auto entity = context.noteRegistry.create();
+    auto&      note =
+        context.noteRegistry.emplace<MMM::Logic::NoteComponent>(entity);
+    note.m_timestamp  = 1.25;
+    note.m_trackIndex = 1;
+    context.noteVisibilityIndex.assign(
+        { MMM::Logic::TimeIntervalIndex::makeEntry(entity, note) });
+    context.previewDensityObjectTimes = { 1.25 };
+    context.isNoteOrderDirty          = false;
+    context.isNotePruneDirty          = false;
+    context.isNoteStatsDirty          = false;
+    context.isHitEventsDirty          = true;
+
+    const std::uint64_t revision = context.noteVisibilityIndexRevision;
+
+    const MMM::Logic::NoteComponent before = note;
+    note.m_timestamp                      = 7.5;
+    const MMM::Logic::SessionUtils::NoteCacheMutationView moved{
+        .entity = entity,
+        .before = &before,
+        .after  = &note,
+    };
+    if ( !MMM::Logic::SessionUtils::applyNoteCacheMutationsIncrementally(
+             context, std::span(&moved, 1)) ) {
+        XERROR("Incremental note cache update unexpectedly fell back");
+        return false;
+    }
+
+    std::vector<double> dirtyTimes;
+    if ( !context.noteDirtyTimes.canReplayAfter(revision) ) {
+        XERROR("Dirty note times were not replayable after an incremental "
+               "edit");
+        return false;
+    }
+    context.noteDirtyTimes.forEachAfter(
+        revision, [&](double time) { dirtyTimes.push_back(time); });
+    std::sort(dirtyTimes.begin(), dirtyTimes.end());
+    if ( dirtyTimes.size() != 2 || !near(dirtyTimes[0], 1.25) ||
+         !near(dirtyTimes[1], 7.5) ) {
+        XERROR("Dirty note times did not cover both positions of a move");
+        return false;
+    }
+
+    dirtyTimes.clear();
+    context.noteDirtyTimes.forEachAfter(
+        context.noteVisibilityIndexRevision,
+        [&](double time) { dirtyTimes.push_back(time); });
+    if ( !dirtyTimes.empty() ) {
+        XERROR("Dirty note times replayed an already consumed revision");
+        return false;
+    }
+
+    context.noteDirtyTimes.recordFull(++context.noteVisibilityIndexRevision);
+    if ( context.noteDirtyTimes.canReplayAfter(revision) ) {
+        XERROR("Dirty note times stayed replayable across a full rebuild");
+        return false;
+    }
+    return true;
+}
+
 /// @brief 验证主画布音量指令原子更新玩家绑定、Polyline 子绑定和自动采样。
 /// @return 三类目标均支持 Undo/Redo，非法音量不写入时返回 true。
 bool testObjectSampleVolumeCommand()
@@ -3862,11 +4076,9 @@ bool testMarqueeSelectsTypedSamplesOnlyOnMainCanvas()
         return false;
     }
 
-    context.sortedNoteEntities       = { noteEntity };
-    context.sortedNoteMaxEndPrefix   = { 1.0 };
-    context.sortedSampleEntities     = { sampleEntity };
-    context.sortedSampleMaxEndPrefix = { 1.0 };
-    context.marqueeBoxes             = {
+    context.noteVisibilityIndex.assign({ { noteEntity, 1.0, 1.0 } });
+    context.sampleVisibilityIndex.assign({ { sampleEntity, 1.0, 1.0 } });
+    context.marqueeBoxes = {
         MMM::Logic::MarqueeBox{
             .startTime  = 0.9,
             .endTime    = 1.1,
@@ -4192,6 +4404,8 @@ int main()
                    testSamplePropertyEditValidationAndAction() &&
                    testSampleRegistryLoadAndSync() &&
                    testNoteSampleBindingRoundTrip() &&
+                   testIncrementalNoteWriteBackPatchesRecords() &&
+                   testIncrementalNoteCacheRecordsDirtyTimes() &&
                    testObjectSampleVolumeCommand() &&
                    testObjectSampleVolumeCommandRoutesThroughSession() &&
                    testSelectedObjectSampleVolumeCommand() &&
@@ -0,0 +1,126 @@
+#include "logic/session/CommandCoalescer.h"
+
+#include "log/colorful-log.h"
+
+#include <vector>
+
+namespace
+{
+
+using MMM::Logic::CmdPanCanvas;
+using MMM::Logic::CmdScroll;
+using MMM::Logic::CmdSetMousePosition;
+using MMM::Logic::CmdUndo;
+using MMM::Logic::CmdUpdateDrag;
+using MMM::Logic::CommandCoalescer;
+using MMM::Logic::LogicCommand;
+
+/// @brief 构造主画布悬停时的鼠标位置命令。
+LogicCommand mouseAt(float x)
+{
+    return CmdSetMousePosition{ .cameraId   = "Main",
+                                .mouseX     = x,
+                                .mouseY     = 100.0f,
+                                .isHovering = true };
+}
+
+/// @brief 构造主画布拖动更新命令。
+LogicCommand dragAt(float x)
+{
+    return CmdUpdateDrag{ .cameraId = "Main", .mouseX = x, .mouseY = 50.0f };
+}
+
+/// @brief 构造主画布滚轮命令。
+LogicCommand wheel(float delta)
+{
+    return CmdScroll{ .cameraId    = "Main",
+                      .wheel       = delta,
+                      .isShiftDown = false };
+}
+
+/// @brief 验证同一屏障区间内的幂等命令只保留最后一条且保持顺序。
+bool testLastWriteWins()
+{
+    CommandCoalescer          coalescer;
+    std::vector<LogicCommand> batch{ mouseAt(1.0f), dragAt(1.0f),
+                                     mouseAt(2.0f), dragAt(2.0f),
+                                     mouseAt(3.0f) };
+    if ( coalescer.coalesce(batch, false) != 3 || batch.size() != 2 ) {
+        XERROR("Superseded pointer updates were not coalesced");
+        return false;
+    }
+    const auto* drag  = std::get_if<CmdUpdateDrag>(&batch[0]);
+    const auto* mouse = std::get_if<CmdSetMousePosition>(&batch[1]);
+    if ( !drag || drag->mouseX != 2.0f || !mouse || mouse->mouseX != 3.0f ) {
+        XERROR("Coalesced pointer updates lost their order or value");
+        return false;
+    }
+
+    std::vector<LogicCommand> hoverChange{ mouseAt(1.0f), mouseAt(2.0f) };
+    std::get<CmdSetMousePosition>(hoverChange[1]).isHovering = false;
+    if ( coalescer.coalesce(hoverChange, false) != 0 ) {
+        XERROR("Mouse updates with different hover state were coalesced");
+        return false;
+    }
+    return true;
+}
+
+/// @brief 验证屏障命令两侧的命令不会互相覆盖。
+bool testBarrierBlocksCoalescing()
+{
+    CommandCoalescer          coalescer;
+    std::vector<LogicCommand> batch{ mouseAt(1.0f), CmdUndo{}, mouseAt(2.0f),
+                                     wheel(1.0f),   CmdUndo{}, wheel(1.0f) };
+    if ( coalescer.coalesce(batch, false) != 0 || batch.size() != 6 ) {
+        XERROR("Commands were coalesced across a barrier");
+        return false;
+    }
+    return true;
+}
+
+/// @brief 验证相邻滚轮与平移累加，吸附或反向时保持逐条执行。
+bool testTransformsAccumulate()
+{
+    CommandCoalescer          coalescer;
+    std::vector<LogicCommand> batch{ wheel(1.0f), wheel(0.5f), wheel(2.0f) };
+    if ( coalescer.coalesce(batch, false) != 2 ||
+         std::get<CmdScroll>(batch[0]).wheel != 3.5f ) {
+        XERROR("Consecutive wheel deltas were not accumulated");
+        return false;
+    }
+
+    std::vector<LogicCommand> snapped{ wheel(1.0f), wheel(1.0f) };
+    std::vector<LogicCommand> reversed{ wheel(1.0f), wheel(-1.0f) };
+    if ( coalescer.coalesce(snapped, true) != 0 ||
+         coalescer.coalesce(reversed, false) != 0 ) {
+        XERROR("Snapped or reversed wheel deltas were accumulated");
+        return false;
+    }
+
+    std::vector<LogicCommand> pans{
+        CmdPanCanvas{ .cameraId = "Main", .deltaX = 3.0f, .deltaY = 4.0f },
+        CmdPanCanvas{ .cameraId = "Main", .deltaX = -1.0f, .deltaY = 6.0f },
+        CmdPanCanvas{ .cameraId = "Other", .deltaX = 1.0f, .deltaY = 1.0f },
+    };
+    if ( coalescer.coalesce(pans, false) != 1 || pans.size() != 2 ) {
+        XERROR("Consecutive pans were not accumulated per canvas");
+        return false;
+    }
+    const auto& merged = std::get<CmdPanCanvas>(pans[0]);
+    if ( merged.deltaX != 2.0f || merged.deltaY != 10.0f ) {
+        XERROR("Accumulated pan has wrong deltas");
+        return false;
+    }
+    return true;
+}
+
+}  // namespace
+
+/// @brief 运行命令合并测试。
+/// @return 全部测试通过时返回 0。
+int main()
+{
+    const bool passed = testLastWriteWins() && testBarrierBlocksCoalescing() &&
+                        testTransformsAccumulate();
+    return passed ? 0 : 1;
+}
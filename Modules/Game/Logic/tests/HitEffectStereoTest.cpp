@@ -1,4 +1,5 @@
 #include "logic/ecs/system/HitFXSystem.h"
+#include "logic/session/HitEventTimeline.h"
 
 #include "audio/StereoGainEnvelope.h"
 #include "config/skin/SkinConfig.h"
@@ -108,8 +109,9 @@ bool testBoundSoundOverridesDefault()
 {
     using HitFXSystem = MMM::Logic::System::HitFXSystem;
 
-    auto boundEvent          = makeEvent(MMM::NoteType::FLICK, 1, 1);
-    boundEvent.sampleBinding = MMM::AudioSampleBinding{ "sample.wav", 0.35F };
+    auto boundEvent = makeEvent(MMM::NoteType::FLICK, 1, 1);
+    boundEvent.sampleResource = MMM::Logic::internSampleResource("sample.wav");
+    boundEvent.sampleVolume   = 0.35F;
     if ( HitFXSystem::soundEffectKeyForEvent(
              boundEvent, MMM::NoteType::FLICK) != "sample.wav" ) {
         XERROR("Bound note sound did not override the built-in Flick sound");
@@ -134,8 +136,9 @@ bool testBoundSampleVolume()
 {
     using HitFXSystem = MMM::Logic::System::HitFXSystem;
 
-    auto boundEvent          = makeEvent(MMM::NoteType::NOTE, 1);
-    boundEvent.sampleBinding = MMM::AudioSampleBinding{ "sample.wav", 0.35F };
+    auto boundEvent = makeEvent(MMM::NoteType::NOTE, 1);
+    boundEvent.sampleResource = MMM::Logic::internSampleResource("sample.wav");
+    boundEvent.sampleVolume   = 0.35F;
     if ( !near(HitFXSystem::sampleVolumeForEvent(boundEvent), 0.35F) ||
          !near(HitFXSystem::sampleVolumeForEvent(
                    makeEvent(MMM::NoteType::NOTE, 1)),
@@ -152,10 +155,10 @@ bool testBoundSoundClassification()
 {
     using HitFXSystem = MMM::Logic::System::HitFXSystem;
 
-    auto emptyBindingEvent          = makeEvent(MMM::NoteType::NOTE, 0);
-    emptyBindingEvent.sampleBinding = MMM::AudioSampleBinding{ "", 0.5F };
-    auto boundEvent                 = makeEvent(MMM::NoteType::NOTE, 0);
-    boundEvent.sampleBinding = MMM::AudioSampleBinding{ "sample.wav", 0.5F };
+    auto emptyBindingEvent = makeEvent(MMM::NoteType::NOTE, 0);
+    emptyBindingEvent.sampleResource = MMM::Logic::internSampleResource("");
+    auto boundEvent = makeEvent(MMM::NoteType::NOTE, 0);
+    boundEvent.sampleResource = MMM::Logic::internSampleResource("sample.wav");
     if ( HitFXSystem::hasBoundSoundEffect(makeEvent(MMM::NoteType::NOTE, 0)) ||
          HitFXSystem::hasBoundSoundEffect(emptyBindingEvent) ||
          !HitFXSystem::hasBoundSoundEffect(boundEvent) ) {
@@ -0,0 +1,230 @@
+#include "logic/session/HitEventTimeline.h"
+
+#include "log/colorful-log.h"
+
+#include <vector>
+
+namespace
+{
+
+using MMM::NoteType;
+using MMM::Logic::HitEventTimeline;
+using MMM::Logic::NoteComponent;
+
+/// @brief 在注册表中创建单个正式音符。
+entt::entity createNote(entt::registry& registry, NoteType type,
+                        double timestamp, int track)
+{
+    const auto entity = registry.create();
+    auto&      note   = registry.emplace<NoteComponent>(entity);
+    note.m_type       = type;
+    note.m_timestamp  = timestamp;
+    note.m_trackIndex = track;
+    return entity;
+}
+
+/// @brief 构造折线子物件。
+NoteComponent::SubNote subNote(NoteType type, double timestamp, int track)
+{
+    NoteComponent::SubNote sub{};
+    sub.type       = type;
+    sub.timestamp  = timestamp;
+    sub.trackIndex = track;
+    return sub;
+}
+
+/// @brief 比较增量维护结果与全量重建结果。
+bool matchesRebuild(const entt::registry&   registry,
+                    const HitEventTimeline& timeline)
+{
+    HitEventTimeline rebuilt;
+    rebuilt.rebuild(registry);
+    if ( !timeline.isConsistent() || rebuilt.size() != timeline.size() ) {
+        return false;
+    }
+    for ( std::size_t index = 0; index < rebuilt.size(); ++index ) {
+        const auto& lhs = rebuilt[index];
+        const auto& rhs = timeline[index];
+        if ( lhs.timestamp != rhs.timestamp || lhs.entity != rhs.entity ||
+             lhs.subIndex != rhs.subIndex || lhs.type != rhs.type ||
+             lhs.trackIndex != rhs.trackIndex ||
+             lhs.sampleResource != rhs.sampleResource ) {
+            return false;
+        }
+    }
+    return true;
+}
+
+/// @brief 验证全量重建按时间排序并跳过草稿与子物件实体。
+bool testRebuildOrdering()
+{
+    entt::registry registry;
+    createNote(registry, NoteType::NOTE, 3.0, 0);
+    createNote(registry, NoteType::HOLD, 1.0, 1);
+    const auto draft = createNote(registry, NoteType::NOTE, 2.0, 2);
+    registry.get<NoteComponent>(draft).m_isDraft = true;
+    const auto child = createNote(registry, NoteType::NOTE, 2.5, 3);
+    registry.get<NoteComponent>(child).m_isSubNote = true;
+    registry.get<NoteComponent>(createNote(registry, NoteType::HOLD, 4.0, 0))
+        .m_duration = 2.0;
+
+    HitEventTimeline timeline;
+    const double     maxEndTime = timeline.rebuild(registry);
+    if ( timeline.size() != 3 || timeline[0].timestamp != 1.0 ||
+         timeline[1].timestamp != 3.0 || timeline[2].timestamp != 4.0 ||
+         maxEndTime != 6.0 || !timeline.isConsistent() ) {
+        XERROR("Hit event rebuild produced a wrong ordered sequence");
+        return false;
+    }
+    return true;
+}
+
+/// @brief 验证移动、删除、创建与草稿转正式都只刷新给定实体。
+bool testIncrementalApply()
+{
+    entt::registry registry;
+    const auto     first  = createNote(registry, NoteType::NOTE, 1.0, 0);
+    const auto     second = createNote(registry, NoteType::NOTE, 2.0, 1);
+    const auto     third  = createNote(registry, NoteType::FLICK, 3.0, 2);
+    registry.get<NoteComponent>(third).m_dtrack = -2;
+
+    HitEventTimeline timeline;
+    timeline.rebuild(registry);
+    if ( timeline[2].trackSpan != 3 ) {
+        XERROR("Flick hit event lost its track span");
+        return false;
+    }
+
+    registry.get<NoteComponent>(first).m_timestamp = 5.0;
+    const std::vector<entt::entity> moved{ first, first };
+    if ( timeline.apply(registry, moved) != 5.0 ||
+         timeline.size() != 3 || timeline[2].entity != first ||
+         !matchesRebuild(registry, timeline) ) {
+        XERROR("Moved note was not reinserted at its new time");
+        return false;
+    }
+
+    registry.destroy(second);
+    timeline.apply(registry, std::vector<entt::entity>{ second });
+    if ( timeline.size() != 2 || !matchesRebuild(registry, timeline) ) {
+        XERROR("Destroyed note kept its hit event");
+        return false;
+    }
+
+    const auto draft = createNote(registry, NoteType::NOTE, 0.5, 3);
+    registry.get<NoteComponent>(draft).m_isDraft = true;
+    const std::vector<entt::entity> drafted{ draft };
+    timeline.apply(registry, drafted);
+    if ( timeline.size() != 2 ) {
+        XERROR("Draft note produced a hit event");
+        return false;
+    }
+    registry.get<NoteComponent>(draft).m_isDraft = false;
+    timeline.apply(registry, drafted);
+    if ( timeline.size() != 3 || timeline[0].entity != draft ||
+         !matchesRebuild(registry, timeline) ) {
+        XERROR("Promoted draft note was not inserted");
+        return false;
+    }
+    return true;
+}
+
+/// @brief 验证折线子物件的角色、子下标键与头部采样回退。
+bool testPolylineEvents()
+{
+    entt::registry registry;
+    const auto     entity = createNote(registry, NoteType::POLYLINE, 1.0, 0);
+    auto&          note   = registry.get<NoteComponent>(entity);
+    note.m_sampleBinding  = MMM::AudioSampleBinding{ "head.wav", 0.5F };
+    note.m_subNotes       = { subNote(NoteType::NOTE, 1.0, 0),
+                              subNote(NoteType::NOTE, 1.0, 1),
+                              subNote(NoteType::NOTE, 2.0, 2) };
+    note.m_subNotes[2].sampleBinding =
+        MMM::AudioSampleBinding{ "tail.wav", 0.25F };
+
+    HitEventTimeline timeline;
+    timeline.rebuild(registry);
+    using Role = HitEventTimeline::HitEvent::Role;
+    if ( timeline.size() != 3 || timeline[0].subIndex != 0 ||
+         timeline[1].subIndex != 1 || timeline[0].role != Role::Head ||
+         timeline[1].role != Role::Internal ||
+         timeline[2].role != Role::Tail || !timeline[0].isSubNote ) {
+        XERROR("Polyline sub notes have wrong roles or keys");
+        return false;
+    }
+    if ( !timeline[0].sampleResource ||
+         *timeline[0].sampleResource != "head.wav" ||
+         timeline[0].sampleVolume != 0.5F || timeline[1].sampleResource ||
+         !timeline[2].sampleResource ||
+         *timeline[2].sampleResource != "tail.wav" ) {
+        XERROR("Polyline sample bindings were resolved incorrectly");
+        return false;
+    }
+
+    note.m_subNotes.pop_back();
+    timeline.apply(registry, std::vector<entt::entity>{ entity });
+    if ( timeline.size() != 2 || !matchesRebuild(registry, timeline) ) {
+        XERROR("Shortened polyline kept a stale sub note event");
+        return false;
+    }
+    return true;
+}
+
+/// @brief 验证采样资源驻留后同名资源共享同一地址。
+bool testSampleInterning()
+{
+    const std::string name   = "shared.wav";
+    const auto*       first  = MMM::Logic::internSampleResource(name);
+    const auto*       second = MMM::Logic::internSampleResource("shared.wav");
+    if ( !first || first != second || *first != name ||
+         MMM::Logic::internSampleResource("") != nullptr ) {
+        XERROR("Sample resource interning returned unstable pointers");
+        return false;
+    }
+    return true;
+}
+
+/// @brief 验证超过小批量阈值的变更走过滤与归并路径后结果一致。
+bool testLargeBatchMerge()
+{
+    entt::registry            registry;
+    std::vector<entt::entity> entities;
+    for ( int index = 0; index < 200; ++index ) {
+        entities.push_back(
+            createNote(registry, NoteType::NOTE, index * 0.1, index % 4));
+    }
+    HitEventTimeline timeline;
+    timeline.rebuild(registry);
+
+    std::vector<entt::entity> changed;
+    for ( std::size_t index = 0; index < entities.size(); index += 3 ) {
+        registry.get<NoteComponent>(entities[index]).m_timestamp += 7.25;
+        changed.push_back(entities[index]);
+    }
+    for ( std::size_t index = 1; index < entities.size(); index += 9 ) {
+        registry.destroy(entities[index]);
+        changed.push_back(entities[index]);
+    }
+    if ( changed.size() <= HitEventTimeline::SMALL_BATCH_SIZE ) {
+        XERROR("Large batch test did not exceed the small batch size");
+        return false;
+    }
+    timeline.apply(registry, changed);
+    if ( !matchesRebuild(registry, timeline) ) {
+        XERROR("Large batch merge diverged from a full rebuild");
+        return false;
+    }
+    return true;
+}
+
+}  // namespace
+
+/// @brief 运行打击事件时间线测试。
+/// @return 全部测试通过时返回 0。
+int main()
+{
+    const bool passed = testRebuildOrdering() && testIncrementalApply() &&
+                        testPolylineEvents() && testSampleInterning() &&
+                        testLargeBatchMerge();
+    return passed ? 0 : 1;
+}
@@ -0,0 +1,133 @@
+#include "logic/BeatmapSyncBuffer.h"
+
+#include "log/colorful-log.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cstdint>
+#include <cstdlib>
+#include <random>
+#include <utility>
+#include <vector>
+
+/**
+ * @brief 悬停拾取的线性扫描与网格索引耗时对比。
+ *
+ * 用法: HitboxIndexBenchmark [hitbox_count ...]
+ * 默认依次测量 10k 与 100k 个命中框：在 1920x1080 画布内随机生成缩小视图
+ * 下的密集物件命中框，对同一组鼠标位置分别做逆序线性扫描与网格点查询，
+ * 输出每次拾取的平均耗时与索引构建耗时，并校验两者命中数一致。
+ */
+
+namespace
+{
+
+using Clock = std::chrono::steady_clock;
+
+double elapsedMs(Clock::time_point begin)
+{
+    return std::chrono::duration<double, std::milli>(Clock::now() - begin)
+        .count();
+}
+
+/// @brief 每个规模测量的鼠标位置数量。
+constexpr std::size_t QUERY_COUNT = 20000;
+
+/// @brief 线性扫描最多抽样的鼠标位置数量，按平均值比较。
+constexpr std::size_t MAX_LINEAR_SAMPLES = 1000;
+
+/// @brief 基准使用的交互拾取缩放。
+constexpr float SCALE = 1.2F;
+
+/// @brief 运行一个规模的对比。
+/// @return 两条路径命中数一致时返回 true。
+bool runBenchmark(std::size_t hitboxCount)
+{
+    std::mt19937                          random(0x41bU);
+    std::uniform_real_distribution<float> x(0.0F, 1920.0F);
+    std::uniform_real_distribution<float> y(0.0F, 1080.0F);
+    std::vector<MMM::Logic::Hitbox>       hitboxes;
+    hitboxes.reserve(hitboxCount);
+    for ( std::size_t index = 0; index < hitboxCount; ++index ) {
+        hitboxes.push_back({ static_cast<entt::entity>(index),
+                             MMM::Logic::HoverPart::Head,
+                             -1,
+                             x(random),
+                             y(random),
+                             48.0F,
+                             6.0F });
+    }
+    std::vector<std::pair<float, float>> queries(QUERY_COUNT);
+    for ( auto& query : queries ) query = { x(random), y(random) };
+
+    // 1. 逆序线性扫描，与原悬停拾取路径相同；只抽样前若干个位置。
+    const std::size_t linearSamples = std::min(QUERY_COUNT, MAX_LINEAR_SAMPLES);
+    std::size_t       linearHits    = 0;
+    const auto        linearBegin   = Clock::now();
+    for ( std::size_t query = 0; query < linearSamples; ++query ) {
+        const auto [mouseX, mouseY] = queries[query];
+        for ( auto it = hitboxes.rbegin(); it != hitboxes.rend(); ++it ) {
+            const auto box =
+                MMM::Logic::scaleInteractionHitbox(*it, SCALE, SCALE);
+            if ( mouseX >= box.x && mouseX <= box.x + box.w &&
+                 mouseY >= box.y && mouseY <= box.y + box.h ) {
+                ++linearHits;
+            }
+        }
+    }
+    const double linearMs = elapsedMs(linearBegin);
+
+    // 2. 网格索引：构建一次后逐点查询。
+    MMM::Logic::HitboxIndex index;
+    const auto              buildBegin = Clock::now();
+    index.build(hitboxes, SCALE, SCALE);
+    const double buildMs = elapsedMs(buildBegin);
+
+    std::vector<std::uint32_t> result;
+    std::size_t                indexHits   = 0;
+    std::size_t                sampledHits = 0;
+    const auto                 indexBegin  = Clock::now();
+    for ( std::size_t query = 0; query < QUERY_COUNT; ++query ) {
+        index.queryPoint(queries[query].first, queries[query].second, result);
+        indexHits += result.size();
+        if ( query < linearSamples ) sampledHits += result.size();
+    }
+    const double indexMs = elapsedMs(indexBegin);
+
+    const double linearUs = linearMs * 1000.0 / double(linearSamples);
+    const double indexUs  = indexMs * 1000.0 / double(QUERY_COUNT);
+    XINFO("HitboxIndex benchmark: hitboxes={} queries={} hits={}",
+          hitboxCount,
+          QUERY_COUNT,
+          indexHits);
+    XINFO("  linear scan  : {:.3f}us/pick ({} sampled)",
+          linearUs,
+          linearSamples);
+    XINFO("  grid index   : {:.3f}us/pick (build {:.2f}ms)", indexUs, buildMs);
+    if ( indexUs > 0.0 ) {
+        XINFO("  speedup      : {:.1f}x", linearUs / indexUs);
+    }
+    if ( linearHits != sampledHits ) {
+        XERROR("Index found {} sampled hits, linear scan found {}",
+               sampledHits,
+               linearHits);
+        return false;
+    }
+    return true;
+}
+
+}  // namespace
+
+int main(int argc, char* argv[])
+{
+    std::vector<std::size_t> sizes;
+    for ( int arg = 1; arg < argc; ++arg ) {
+        sizes.push_back(std::strtoull(argv[arg], nullptr, 10));
+    }
+    if ( sizes.empty() ) sizes = { 10000, 100000 };
+
+    for ( const std::size_t size : sizes ) {
+        if ( size == 0 || !runBenchmark(size) ) return 1;
+    }
+    return 0;
+}
@@ -0,0 +1,152 @@
+#include "logic/BeatmapSyncBuffer.h"
+
+#include "log/colorful-log.h"
+
+#include <algorithm>
+#include <cstdint>
+#include <functional>
+#include <limits>
+#include <random>
+#include <vector>
+
+namespace
+{
+
+/// @brief 随机查询次数。
+constexpr int QUERY_COUNT = 2000;
+
+/// @brief 交互拾取横向缩放。
+constexpr float SCALE_X = 1.5F;
+
+/// @brief 交互拾取纵向缩放。
+constexpr float SCALE_Y = 2.0F;
+
+/// @brief 生成分布在 1920x1080 画布内的随机命中框，附带少量异常值。
+std::vector<MMM::Logic::Hitbox> makeHitboxes(std::size_t count,
+                                             std::mt19937& random)
+{
+    std::uniform_real_distribution<float> position(-50.0F, 1970.0F);
+    std::uniform_real_distribution<float> size(0.0F, 80.0F);
+    std::vector<MMM::Logic::Hitbox>       hitboxes;
+    hitboxes.reserve(count + 3);
+    for ( std::size_t index = 0; index < count; ++index ) {
+        hitboxes.push_back({ static_cast<entt::entity>(index),
+                             MMM::Logic::HoverPart::Head,
+                             -1,
+                             position(random),
+                             position(random) * 0.56F,
+                             size(random),
+                             size(random) * 0.25F });
+    }
+    // 负宽度永不命中；无限宽度需要单独判断；NaN 直接忽略。
+    constexpr float infinity = std::numeric_limits<float>::infinity();
+    hitboxes.push_back({ entt::null, MMM::Logic::HoverPart::Head, -1, 100.0F,
+                         100.0F, -20.0F, 10.0F });
+    hitboxes.push_back({ entt::null, MMM::Logic::HoverPart::Head, -1, 600.0F,
+                         300.0F, infinity, 10.0F });
+    hitboxes.push_back({ entt::null,
+                         MMM::Logic::HoverPart::Head,
+                         -1,
+                         std::numeric_limits<float>::quiet_NaN(),
+                         0.0F,
+                         10.0F,
+                         10.0F });
+    return hitboxes;
+}
+
+/// @brief 线性扫描得到包含点的命中框，下标降序。
+std::vector<std::uint32_t> bruteForcePoint(
+    const std::vector<MMM::Logic::Hitbox>& hitboxes, float x, float y)
+{
+    std::vector<std::uint32_t> result;
+    for ( std::size_t index = hitboxes.size(); index-- > 0; ) {
+        const auto box = MMM::Logic::scaleInteractionHitbox(
+            hitboxes[index], SCALE_X, SCALE_Y);
+        if ( x >= box.x && x <= box.x + box.w && y >= box.y &&
+             y <= box.y + box.h ) {
+            result.push_back(static_cast<std::uint32_t>(index));
+        }
+    }
+    return result;
+}
+
+/// @brief 验证点查询与逆序线性扫描结果及顺序一致。
+bool testPointQueriesMatchLinearScan()
+{
+    std::mt19937 random(0x5eedU);
+    const auto   hitboxes = makeHitboxes(5000, random);
+
+    MMM::Logic::HitboxIndex index;
+    index.build(hitboxes, SCALE_X, SCALE_Y);
+    if ( index.size() != hitboxes.size() ) {
+        XERROR("Index covers {} of {} hitboxes", index.size(), hitboxes.size());
+        return false;
+    }
+
+    std::uniform_real_distribution<float> coordinate(-100.0F, 2020.0F);
+    std::vector<std::uint32_t>            result;
+    for ( int query = 0; query < QUERY_COUNT; ++query ) {
+        const float x = coordinate(random);
+        const float y = coordinate(random) * 0.56F;
+        index.queryPoint(x, y, result);
+        if ( result != bruteForcePoint(hitboxes, x, y) ) {
+            XERROR("Point query at ({}, {}) differs from linear scan", x, y);
+            return false;
+        }
+    }
+
+    // 落在无限宽命中框上的点必须按层级与网格结果合并。
+    index.queryPoint(1900.0F, 305.0F, result);
+    if ( result != bruteForcePoint(hitboxes, 1900.0F, 305.0F) ||
+         std::find(result.begin(), result.end(), hitboxes.size() - 2) ==
+             result.end() ) {
+        XERROR("Unbounded hitbox was not merged into the point query");
+        return false;
+    }
+    return true;
+}
+
+/// @brief 验证空快照与重建后的索引不残留旧数据。
+bool testRebuildAndClear()
+{
+    MMM::Logic::HitboxIndex    index;
+    std::vector<std::uint32_t> result;
+    index.build({}, 1.0F, 1.0F);
+    index.queryPoint(0.0F, 0.0F, result);
+    if ( !result.empty() ) {
+        XERROR("Empty index returned hitboxes");
+        return false;
+    }
+
+    const std::vector<MMM::Logic::Hitbox> single{ { entt::null,
+                                                    MMM::Logic::HoverPart::Head,
+                                                    -1,
+                                                    5.0F,
+                                                    5.0F,
+                                                    0.0F,
+                                                    0.0F } };
+    index.build(single, 1.0F, 1.0F);
+    index.queryPoint(5.0F, 5.0F, result);
+    if ( result.size() != 1 ) {
+        XERROR("Degenerate point hitbox was not found");
+        return false;
+    }
+    index.clear();
+    index.queryPoint(5.0F, 5.0F, result);
+    if ( !result.empty() || index.size() != 0 ) {
+        XERROR("Cleared index still returned hitboxes");
+        return false;
+    }
+    return true;
+}
+
+}  // namespace
+
+/// @brief 运行命中框网格索引测试。
+/// @return 全部测试通过时返回 0。
+int main()
+{
+    const bool passed = testPointQueriesMatchLinearScan() &&
+                        testRebuildAndClear();
+    return passed ? 0 : 1;
+}
@@ -32,7 +32,6 @@ bool testLogoUsesFullViewportScissor()
         noteRegistry,
         sampleRegistry,
         {},
-        {},
         timelineRegistry,
         {},
         &snapshot,
@@ -7,6 +7,7 @@
 #include "logic/ecs/components/TimelineComponent.h"
 #include "logic/ecs/components/TransformComponent.h"
 #include "logic/ecs/system/ScrollCache.h"
+#include "logic/session/TimeIntervalIndex.h"
 
 #include <cmath>
 #include <cstdint>
@@ -162,11 +163,14 @@ void renderBoundTap(MMM::Logic::RenderSnapshot& snapshot, bool enabled,
         .m_audioResourceId = "very_long_bound_effect_resource_name.wav",
         .m_volume          = 0.75F,
     };
+    MMM::Logic::TimeIntervalIndex sortedNotes;
+    sortedNotes.insert(
+        MMM::Logic::TimeIntervalIndex::makeEntry(noteEntity, note));
     noteRegistry.emplace<MMM::Logic::NoteComponent>(noteEntity,
                                                     std::move(note));
     noteRegistry.emplace<MMM::Logic::TransformComponent>(noteEntity);
-    const std::vector<entt::entity> sortedNotes{ noteEntity };
-    noteRegistry.ctx().emplace<const std::vector<entt::entity>*>(&sortedNotes);
+    noteRegistry.ctx().emplace<const MMM::Logic::TimeIntervalIndex*>(
+        &sortedNotes);
 
     snapshot.hasBeatmap      = true;
     snapshot.snapshotSysTime = snapshotSysTime;
@@ -182,7 +186,6 @@ void renderBoundTap(MMM::Logic::RenderSnapshot& snapshot, bool enabled,
         noteRegistry,
         sampleRegistry,
         {},
-        {},
         timelineRegistry,
         {},
         &snapshot,
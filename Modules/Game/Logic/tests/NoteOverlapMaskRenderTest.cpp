@@ -6,6 +6,7 @@
 #include "logic/ecs/components/TransformComponent.h"
 #include "logic/ecs/system/NoteRenderSystem.h"
 #include "logic/ecs/system/ScrollCache.h"
+#include "logic/session/TimeIntervalIndex.h"
 
 #include <entt/entt.hpp>
 #include <glm/vec4.hpp>
@@ -50,20 +51,21 @@ void renderOverlappingTaps(MMM::Logic::RenderSnapshot& snapshot, bool isPlaying)
         timelineRegistry.ctx().emplace<MMM::Logic::System::ScrollCache>();
     cache.rebuild(timelineRegistry, config, nullptr);
 
-    std::vector<entt::entity> sortedNotes;
-    sortedNotes.reserve(2U);
+    MMM::Logic::TimeIntervalIndex sortedNotes;
     for ( std::size_t index = 0; index < 2U; ++index ) {
         const auto                entity = noteRegistry.create();
         MMM::Logic::NoteComponent note;
         note.m_timestamp  = 1.0;
         note.m_type       = MMM::NoteType::NOTE;
         note.m_trackIndex = 1;
+        sortedNotes.insert(
+            MMM::Logic::TimeIntervalIndex::makeEntry(entity, note));
         noteRegistry.emplace<MMM::Logic::NoteComponent>(entity,
                                                         std::move(note));
         noteRegistry.emplace<MMM::Logic::TransformComponent>(entity);
-        sortedNotes.push_back(entity);
     }
-    noteRegistry.ctx().emplace<const std::vector<entt::entity>*>(&sortedNotes);
+    noteRegistry.ctx().emplace<const MMM::Logic::TimeIntervalIndex*>(
+        &sortedNotes);
 
     snapshot.hasBeatmap    = true;
     snapshot.isPlaying     = isPlaying;
@@ -78,7 +80,6 @@ void renderOverlappingTaps(MMM::Logic::RenderSnapshot& snapshot, bool isPlaying)
     MMM::Logic::System::NoteRenderSystem::generateSnapshot(noteRegistry,
                                                            sampleRegistry,
                                                            {},
-                                                           {},
                                                            timelineRegistry,
                                                            {},
                                                            &snapshot,
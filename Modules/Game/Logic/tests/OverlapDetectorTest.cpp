@@ -0,0 +1,440 @@
+#include "logic/session/OverlapDetector.h"
+
+#include "log/colorful-log.h"
+
+#include <algorithm>
+#include <map>
+#include <random>
+#include <stop_token>
+#include <tuple>
+#include <vector>
+
+namespace
+{
+
+using MMM::NoteType;
+using MMM::Logic::detectOverlaps;
+using MMM::Logic::mergeOverlaps;
+using MMM::Logic::NoteComponent;
+using MMM::Logic::OverlapItem;
+using MMM::Logic::OverlapRegion;
+using MMM::Logic::OverlapRegionShape;
+using MMM::Logic::OverlapReport;
+
+/// @brief 测试使用的 5ms 重叠时间窗口。
+constexpr double WINDOW_SECONDS = 0.005;
+
+/// @brief 构造测试用顶层实体。
+entt::entity owner(std::uint32_t id)
+{
+    return static_cast<entt::entity>(id);
+}
+
+/// @brief 构造单个判定物件。
+OverlapItem item(NoteType type, double startTime, double endTime,
+                 std::int32_t track, std::int32_t dtrack, std::uint32_t id)
+{
+    return {
+        type, startTime, endTime, track, dtrack, owner(id), -1, startTime
+    };
+}
+
+/// @brief 统计指定形状的区域数量。
+std::size_t countShape(const OverlapReport& report, OverlapRegionShape shape)
+{
+    std::size_t count = 0;
+    for ( const auto& region : report.regions ) {
+        if ( region.shape == shape ) ++count;
+    }
+    return count;
+}
+
+/// @brief 查找第一个指定形状的区域。
+const OverlapRegion* findShape(const OverlapReport& report,
+                               OverlapRegionShape   shape)
+{
+    for ( const auto& region : report.regions ) {
+        if ( region.shape == shape ) return &region;
+    }
+    return nullptr;
+}
+
+/// @brief 验证同轨时间窗口内的判定点成簇，并生成可逐个描述的窗口行。
+bool testPointCluster()
+{
+    const auto report =
+        detectOverlaps({ item(NoteType::NOTE, 1.000, 1.000, 0, 0, 1),
+                         item(NoteType::NOTE, 1.003, 1.003, 0, 0, 2),
+                         item(NoteType::NOTE, 1.010, 1.010, 0, 0, 3),
+                         item(NoteType::NOTE, 1.000, 1.000, 1, 0, 4) },
+                       WINDOW_SECONDS,
+                       7);
+    if ( !report || report->revision != 7 || report->regions.size() != 1 ) {
+        XERROR("Notes inside the overlap window were not clustered");
+        return false;
+    }
+    const auto& region = report->regions.front();
+    if ( region.shape != OverlapRegionShape::Point || region.trackBegin != 0 ||
+         region.objectCount != 2 || region.timeBegin != 1.000 ||
+         region.timeEnd != 1.003 ) {
+        XERROR("Point cluster region has wrong bounds");
+        return false;
+    }
+    if ( report->findings.size() != 1 ) {
+        XERROR("Point cluster produced wrong number of findings");
+        return false;
+    }
+    const auto& finding = report->findings.front();
+    if ( finding.objectCount != 2 || finding.regionCount != 1 ||
+         finding.firstItem == finding.secondItem ||
+         finding.firstItem > 1 || finding.secondItem > 1 ) {
+        XERROR("Two-object finding lost its representatives");
+        return false;
+    }
+
+    const auto triple =
+        detectOverlaps({ item(NoteType::NOTE, 2.000, 2.000, 3, 0, 1),
+                         item(NoteType::NOTE, 2.004, 2.004, 3, 0, 2),
+                         item(NoteType::NOTE, 2.008, 2.008, 3, 0, 3) },
+                       WINDOW_SECONDS,
+                       0);
+    if ( !triple || triple->findings.size() != 1 ||
+         triple->findings.front().objectCount != 3 ) {
+        XERROR("Chained notes were not merged into one finding");
+        return false;
+    }
+    return true;
+}
+
+/// @brief 验证同一折线的子物件不会互相判为重叠。
+bool testPolylineOwnerExclusion()
+{
+    NoteComponent polyline;
+    polyline.m_type = NoteType::POLYLINE;
+    NoteComponent::SubNote flick{};
+    flick.type       = NoteType::FLICK;
+    flick.timestamp  = 2.0;
+    flick.trackIndex = 0;
+    flick.dtrack     = 2;
+    NoteComponent::SubNote hold{};
+    hold.type       = NoteType::HOLD;
+    hold.timestamp  = 2.0;
+    hold.duration   = 1.0;
+    hold.trackIndex = 2;
+    polyline.m_subNotes = { flick, hold };
+
+    NoteComponent subNote;
+    subNote.m_isSubNote = true;
+
+    std::vector<OverlapItem> items;
+    MMM::Logic::appendOverlapItems(polyline, owner(1), items);
+    MMM::Logic::appendOverlapItems(subNote, owner(2), items);
+    if ( items.size() != 2 || items[0].subIndex != 0 ||
+         items[1].subIndex != 1 || items[1].endTime != 3.0 ) {
+        XERROR("Polyline was not expanded into its sub notes");
+        return false;
+    }
+
+    const auto report = detectOverlaps(items, WINDOW_SECONDS, 0);
+    if ( !report || !report->regions.empty() ) {
+        XERROR("Sub notes of one polyline were reported as overlapping");
+        return false;
+    }
+    return true;
+}
+
+/// @brief 验证同轨长条身体重叠时段与按时间范围查询。
+bool testHoldBodies()
+{
+    const auto report =
+        detectOverlaps({ item(NoteType::HOLD, 1.0, 3.0, 0, 0, 1),
+                         item(NoteType::HOLD, 2.0, 4.0, 0, 0, 2) },
+                       WINDOW_SECONDS,
+                       0);
+    if ( !report || countShape(*report, OverlapRegionShape::HoldBody) != 1 ) {
+        XERROR("Overlapping hold bodies were not detected");
+        return false;
+    }
+    const auto* body = findShape(*report, OverlapRegionShape::HoldBody);
+    if ( body->timeBegin != 2.0 || body->timeEnd != 3.0 ||
+         body->objectCount != 2 ) {
+        XERROR("Hold body region has wrong bounds");
+        return false;
+    }
+
+    // 查询起点晚于区域起点时仍需通过最长跨度回退找到长条身体。
+    std::vector<OverlapRegionShape> visited;
+    report->forEachRegionInRange(2.5, 2.6, [&](const OverlapRegion& region) {
+        visited.push_back(region.shape);
+    });
+    if ( visited.size() != 1 ||
+         visited.front() != OverlapRegionShape::HoldBody ) {
+        XERROR("Range query missed the long hold body region");
+        return false;
+    }
+    return true;
+}
+
+/// @brief 验证判定点与 Flick 横向身体落在其他长条内部。
+bool testPointsInsideHold()
+{
+    const auto note =
+        detectOverlaps({ item(NoteType::HOLD, 1.0, 2.0, 1, 0, 1),
+                         item(NoteType::NOTE, 1.5, 1.5, 1, 0, 2) },
+                       WINDOW_SECONDS,
+                       0);
+    if ( !note || note->regions.size() != 1 ||
+         note->regions.front().timeBegin != 1.5 ||
+         note->regions.front().scale != 1.0F ) {
+        XERROR("Note inside a hold body was not detected");
+        return false;
+    }
+
+    const auto flick =
+        detectOverlaps({ item(NoteType::HOLD, 1.0, 2.0, 2, 0, 1),
+                         item(NoteType::FLICK, 1.5, 1.5, 0, 3, 2) },
+                       WINDOW_SECONDS,
+                       0);
+    if ( !flick || flick->regions.size() != 1 ) {
+        XERROR("Flick crossing a hold body was not detected");
+        return false;
+    }
+    const auto& region = flick->regions.front();
+    if ( region.trackBegin != 2 || region.scale != 0.7F ||
+         region.timeBegin != 1.5 ) {
+        XERROR("Flick crossing region has wrong track or scale");
+        return false;
+    }
+    return true;
+}
+
+/// @brief 验证相近时间的两个 Flick 横向身体交叠。
+bool testFlickBodies()
+{
+    const auto report =
+        detectOverlaps({ item(NoteType::FLICK, 5.000, 5.000, 0, 3, 1),
+                         item(NoteType::FLICK, 5.002, 5.002, 1, 3, 2) },
+                       WINDOW_SECONDS,
+                       0);
+    if ( !report || countShape(*report, OverlapRegionShape::FlickBody) != 1 ) {
+        XERROR("Overlapping flick bodies were not detected");
+        return false;
+    }
+    const auto* body = findShape(*report, OverlapRegionShape::FlickBody);
+    if ( body->trackBegin != 1 || body->trackEnd != 3 ) {
+        XERROR("Flick body region has wrong track span");
+        return false;
+    }
+
+    const auto apart =
+        detectOverlaps({ item(NoteType::FLICK, 5.0, 5.0, 0, 3, 1),
+                         item(NoteType::FLICK, 6.0, 6.0, 1, 3, 2) },
+                       WINDOW_SECONDS,
+                       0);
+    if ( !apart || !apart->regions.empty() ) {
+        XERROR("Distant flicks were reported as overlapping");
+        return false;
+    }
+    return true;
+}
+
+/// @brief 验证请求停止后检测返回空结果。
+bool testCancellation()
+{
+    std::stop_source stopSource;
+    stopSource.request_stop();
+    const auto report =
+        detectOverlaps({ item(NoteType::NOTE, 1.0, 1.0, 0, 0, 1),
+                         item(NoteType::NOTE, 1.0, 1.0, 0, 0, 2) },
+                       WINDOW_SECONDS,
+                       0,
+                       stopSource.get_token());
+    if ( report ) {
+        XERROR("Cancelled overlap scan still produced a report");
+        return false;
+    }
+    return true;
+}
+
+/// @brief 与下标无关的区域描述：形状、范围与按（物件, 子物件）排序的成员。
+using RegionKey =
+    std::tuple<OverlapRegionShape, float, std::int32_t, std::int32_t, double,
+               double, std::int32_t,
+               std::vector<std::pair<entt::entity, std::int32_t>>>;
+
+/// @brief 把区域转换为可跨结果比较的有序描述。
+std::vector<RegionKey> regionKeys(const OverlapReport& report)
+{
+    std::vector<RegionKey> keys;
+    for ( const auto& region : report.regions ) {
+        std::vector<std::pair<entt::entity, std::int32_t>> members;
+        for ( std::uint32_t offset = 0; offset < region.itemCount; ++offset ) {
+            const auto& member =
+                report.items[report.regionItems[region.itemBegin + offset]];
+            members.emplace_back(member.owner, member.subIndex);
+        }
+        std::sort(members.begin(), members.end());
+        keys.emplace_back(region.shape,
+                          region.scale,
+                          region.trackBegin,
+                          region.trackEnd,
+                          region.timeBegin,
+                          region.timeEnd,
+                          region.objectCount,
+                          std::move(members));
+    }
+    std::sort(keys.begin(), keys.end());
+    return keys;
+}
+
+/// @brief 增量合并与完整检测的物件、区域与窗口行是否一致。
+bool sameReport(const OverlapReport& merged, const OverlapReport& full)
+{
+    if ( merged.items.size() != full.items.size() ) return false;
+    for ( std::size_t index = 0; index < full.items.size(); ++index ) {
+        const auto& lhs = merged.items[index];
+        const auto& rhs = full.items[index];
+        if ( lhs.owner != rhs.owner || lhs.subIndex != rhs.subIndex ||
+             lhs.startTime != rhs.startTime || lhs.track != rhs.track ) {
+            return false;
+        }
+    }
+    if ( regionKeys(merged) != regionKeys(full) ) return false;
+
+    // 起点相同的区域先后顺序不固定，窗口行只比较与代表物件无关的字段。
+    using FindingKey =
+        std::tuple<double, std::int32_t, std::uint32_t, std::uint32_t>;
+    const auto findingKeys = [](const OverlapReport& report) {
+        std::vector<FindingKey> keys;
+        for ( const auto& finding : report.findings ) {
+            keys.emplace_back(finding.time,
+                              finding.track,
+                              finding.objectCount,
+                              finding.regionCount);
+        }
+        std::sort(keys.begin(), keys.end());
+        return keys;
+    };
+    return findingKeys(merged) == findingKeys(full) &&
+           merged.maxRegionSpan == full.maxRegionSpan;
+}
+
+/// @brief 验证随机编辑序列下增量合并与对当前物件完整检测的结果一致。
+bool testIncrementalMerge()
+{
+    std::mt19937 random(0x4f564cU);
+    const auto   pick = [&](int low, int high) {
+        return std::uniform_int_distribution<int>(low, high)(random);
+    };
+
+    // 每个顶层物件的判定物件；折线展开为两个子物件。
+    std::map<std::uint32_t, std::vector<OverlapItem>> notes;
+    std::uint32_t                                     nextOwner = 1;
+    const auto makeNote = [&](std::uint32_t id, double time) {
+        std::vector<OverlapItem> expanded;
+        const std::int32_t       track = pick(0, 5);
+        switch ( pick(0, 3) ) {
+        case 0:
+            expanded.push_back(item(NoteType::NOTE, time, time, track, 0, id));
+            break;
+        case 1:
+            expanded.push_back(item(NoteType::HOLD,
+                                    time,
+                                    time + 0.002 * pick(1, 200),
+                                    track,
+                                    0,
+                                    id));
+            break;
+        case 2:
+            expanded.push_back(
+                item(NoteType::FLICK, time, time, track, pick(-3, 3), id));
+            break;
+        default: {
+            auto flick = item(NoteType::FLICK, time, time, track, 2, id);
+            auto hold  = item(
+                NoteType::HOLD, time, time + 0.3, track + 2, 0, id);
+            flick.subIndex = 0;
+            hold.subIndex  = 1;
+            expanded       = { flick, hold };
+            break;
+        }
+        }
+        return expanded;
+    };
+    // 物件集中在稀疏的时间槽附近，既有重叠也留出互不相连的岛。
+    const auto randomTime = [&]() {
+        return 0.5 * pick(0, 400) + 0.002 * pick(0, 3);
+    };
+    const auto collect    = [&]() {
+        std::vector<OverlapItem> items;
+        for ( const auto& [id, expanded] : notes ) {
+            items.insert(items.end(), expanded.begin(), expanded.end());
+        }
+        MMM::Logic::sortOverlapItems(items);
+        return items;
+    };
+
+    for ( ; nextOwner <= 600; ++nextOwner ) {
+        notes[nextOwner] = makeNote(nextOwner, randomTime());
+    }
+    auto previous = detectOverlaps(collect(), WINDOW_SECONDS, 0);
+    if ( !previous ) return false;
+
+    for ( std::uint64_t revision = 1; revision <= 60; ++revision ) {
+        std::vector<double> dirtyTimes;
+        const int           edits = pick(1, 6);
+        for ( int edit = 0; edit < edits; ++edit ) {
+            const int  offset = pick(0, static_cast<int>(notes.size()) - 1);
+            auto       it     = std::next(notes.begin(), offset);
+            const auto action = pick(0, 3);
+            dirtyTimes.push_back(it->second.front().ownerTime);
+            if ( action == 0 ) {
+                notes.erase(it);
+            } else if ( action == 1 ) {
+                const double time = randomTime();
+                it->second        = makeNote(it->first, time);
+                dirtyTimes.push_back(time);
+            } else if ( action == 2 ) {
+                // 原地修改轨道：编辑前后的起始时间相同。
+                for ( auto& expanded : it->second ) ++expanded.track;
+            } else {
+                const double time = randomTime();
+                notes[nextOwner]  = makeNote(nextOwner, time);
+                ++nextOwner;
+                dirtyTimes.push_back(time);
+            }
+        }
+
+        std::vector<OverlapItem> added;
+        for ( const auto& [id, expanded] : notes ) {
+            if ( std::find(dirtyTimes.begin(),
+                           dirtyTimes.end(),
+                           expanded.front().ownerTime) != dirtyTimes.end() ) {
+                added.insert(added.end(), expanded.begin(), expanded.end());
+            }
+        }
+        auto merged =
+            mergeOverlaps(*previous, dirtyTimes, std::move(added), revision);
+        const auto full = detectOverlaps(collect(), WINDOW_SECONDS, revision);
+        if ( !merged || !full || merged->revision != revision ||
+             !sameReport(*merged, *full) ) {
+            XERROR("Incremental overlap merge diverged from a full scan");
+            return false;
+        }
+        previous = std::move(merged);
+    }
+    return true;
+}
+
+}  // namespace
+
+/// @brief 运行重叠检测测试。
+/// @return 全部测试通过时返回 0。
+int main()
+{
+    const bool passed = testPointCluster() && testPolylineOwnerExclusion() &&
+                        testHoldBodies() && testPointsInsideHold() &&
+                        testFlickBodies() && testCancellation() &&
+                        testIncrementalMerge();
+    return passed ? 0 : 1;
+}
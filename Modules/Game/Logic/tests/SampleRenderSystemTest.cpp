@@ -290,8 +290,10 @@ void renderSingleSample(MMM::Logic::RenderSnapshot& snapshot,
             .isHovered  = hovered,
             .isSelected = selected,
         });
-    const std::vector<entt::entity> sortedEntities{ sampleEntity };
-    const std::vector<double>       maxEndPrefix{ 0.0 };
+    MMM::Logic::TimeIntervalIndex sampleIndex;
+    sampleIndex.insert(MMM::Logic::TimeIntervalIndex::makeEntry(
+        sampleEntity,
+        sampleRegistry.get<const MMM::Logic::SampleComponent>(sampleEntity)));
     if ( erasing ) {
         snapshot.erasingObjectKind = MMM::Logic::ChartObjectKind::AudioSample;
         snapshot.erasingEntities.insert(sampleEntity);
@@ -309,8 +311,7 @@ void renderSingleSample(MMM::Logic::RenderSnapshot& snapshot,
         800.0F, 4, 1, 0.1F, 0.5F, 0.0F);
     MMM::Logic::System::Batcher batcher(&snapshot);
     MMM::Logic::System::SampleRenderSystem::renderSamples(sampleRegistry,
-                                                          sortedEntities,
-                                                          maxEndPrefix,
+                                                          sampleIndex,
                                                           &snapshot,
                                                           batcher,
                                                           projection,
@@ -359,7 +360,6 @@ void renderSampleBrushPreview(MMM::Logic::RenderSnapshot& snapshot)
         800.0F, 4, 1, 0.1F, 0.5F, 0.0F);
     MMM::Logic::System::Batcher batcher(&snapshot);
     MMM::Logic::System::SampleRenderSystem::renderSamples(sampleRegistry,
-                                                          {},
                                                           {},
                                                           &snapshot,
                                                           batcher,
@@ -0,0 +1,361 @@
+#include "config/EditorConfig.h"
+#include "log/colorful-log.h"
+#include "logic/ecs/components/TimelineComponent.h"
+#include "logic/ecs/system/ScrollCache.h"
+
+#include <entt/entt.hpp>
+
+#include <cmath>
+#include <cstddef>
+#include <random>
+#include <vector>
+
+namespace
+{
+
+using MMM::Logic::TimelineComponent;
+using MMM::Logic::System::ScrollCache;
+
+/// @brief 与会话相同：时间线信号只向缓存登记变更实体。
+void markChanged(entt::registry& registry, entt::entity entity)
+{
+    if ( auto* cache = registry.ctx().find<ScrollCache>() ) {
+        cache->markTimelineChanged(entity);
+    }
+}
+
+/// @brief 创建挂接信号的时间线注册表与缓存。
+ScrollCache& attachCache(entt::registry& registry)
+{
+    auto& cache = registry.ctx().emplace<ScrollCache>();
+    registry.on_construct<TimelineComponent>().connect<&markChanged>();
+    registry.on_update<TimelineComponent>().connect<&markChanged>();
+    registry.on_destroy<TimelineComponent>().connect<&markChanged>();
+    return cache;
+}
+
+/// @brief 生成一条 BPM 与大量 SV、HS、Jump 的时间线。
+void populateTimeline(entt::registry& registry, std::mt19937& random)
+{
+    std::uniform_real_distribution<double> value(0.25, 4.0);
+    registry.emplace<TimelineComponent>(registry.create(),
+                                        TimelineComponent{
+                                            .m_timestamp = 0.0,
+                                            .m_effect = MMM::TimingEffect::BPM,
+                                            .m_value  = 150.0,
+                                        });
+    for ( int index = 1; index <= 400; ++index ) {
+        const auto effect = index % 23 == 0   ? MMM::TimingEffect::JUMP
+                            : index % 11 == 0 ? MMM::TimingEffect::HS
+                                              : MMM::TimingEffect::SCROLL;
+        registry.emplace<TimelineComponent>(
+            registry.create(),
+            TimelineComponent{
+                .m_timestamp = index * 0.25,
+                .m_effect    = effect,
+                .m_value =
+                    effect == MMM::TimingEffect::JUMP ? 40.0 : value(random),
+            });
+    }
+}
+
+/// @brief 比较增量刷新后的缓存与同一时间线完整重建的结果。
+bool matchesFullRebuild(const ScrollCache&                actualCache,
+                        const entt::registry&             registry,
+                        const MMM::Config::EditorConfig& config)
+{
+    ScrollCache reference;
+    reference.rebuild(registry, config, nullptr);
+
+    const auto& actual   = actualCache.getSegments();
+    const auto& expected = reference.getSegments();
+    if ( actual.size() != expected.size() ) {
+        XERROR("Segment count {} differs from full rebuild {}",
+               actual.size(),
+               expected.size());
+        return false;
+    }
+    constexpr double EPSILON = 1e-6;
+    for ( std::size_t index = 0; index < actual.size(); ++index ) {
+        const auto& lhs = actual[index];
+        const auto& rhs = expected[index];
+        if ( std::abs(lhs.time - rhs.time) > EPSILON ||
+             std::abs(lhs.absY - rhs.absY) > EPSILON ||
+             std::abs(lhs.speed - rhs.speed) > EPSILON ||
+             std::abs(lhs.hs - rhs.hs) > EPSILON ||
+             std::abs(lhs.activeScrollValue - rhs.activeScrollValue) >
+                 EPSILON ||
+             lhs.effects != rhs.effects ||
+             lhs.scrollEntity != rhs.scrollEntity ||
+             lhs.hsEntity != rhs.hsEntity ) {
+            XERROR("Segment {} differs from full rebuild", index);
+            return false;
+        }
+    }
+    for ( double time = -1.0; time < 110.0; time += 0.37 ) {
+        if ( std::abs(actualCache.getAbsY(time) - reference.getAbsY(time)) >
+             EPSILON ) {
+            XERROR("AbsY at {} differs from full rebuild", time);
+            return false;
+        }
+    }
+    for ( const auto& segment : expected ) {
+        for ( double offset = 0.0; offset < 0.005; offset += 0.0005 ) {
+            const double time = segment.time + offset;
+            if ( std::abs(actualCache.getVisualAnchorAbsY(time) -
+                          reference.getVisualAnchorAbsY(time)) > EPSILON ) {
+                XERROR("Visual anchor at {} differs from full rebuild", time);
+                return false;
+            }
+        }
+    }
+    return actualCache.hasJumpEffects() == reference.hasJumpEffects();
+}
+
+/// @brief 验证单条 SV 编辑只重新积分后缀且结果与完整重建一致。
+bool testIncrementalEditsMatchFullRebuild()
+{
+    entt::registry            registry;
+    MMM::Config::EditorConfig config;
+    std::mt19937              random(7);
+    auto&                     cache = attachCache(registry);
+    populateTimeline(registry, random);
+    cache.refresh(registry, config, nullptr);
+
+    std::vector<entt::entity> scrollEntities;
+    for ( auto [entity, timeline] :
+          registry.view<const TimelineComponent>().each() ) {
+        if ( timeline.m_effect == MMM::TimingEffect::SCROLL ) {
+            scrollEntities.push_back(entity);
+        }
+    }
+
+    std::uniform_int_distribution<std::size_t> pick(
+        0, scrollEntities.size() - 1);
+    std::uniform_real_distribution<double> time(1.0, 100.0);
+    for ( int step = 0; step < 200; ++step ) {
+        const auto entity = scrollEntities[pick(random)];
+        if ( !registry.valid(entity) ) continue;
+        if ( step % 17 == 0 ) {
+            registry.destroy(entity);
+        } else if ( step % 13 == 0 ) {
+            registry.emplace<TimelineComponent>(
+                registry.create(),
+                TimelineComponent{ .m_timestamp = time(random),
+                                   .m_effect    = MMM::TimingEffect::SCROLL,
+                                   .m_value     = 2.0 });
+        } else {
+            const double target = time(random);
+            registry.patch<TimelineComponent>(
+                entity, [&](TimelineComponent& timeline) {
+                    timeline.m_timestamp = target;
+                    timeline.m_value     = 0.5 + step % 5;
+                });
+        }
+
+        if ( !cache.needsRebuild() || !cache.refresh(registry, config, nullptr) ) {
+            XERROR("Timeline edit did not trigger a refresh");
+            return false;
+        }
+        if ( step % 13 != 0 && !std::isfinite(cache.getLastRebuildFromTime()) ) {
+            XERROR("Scroll edit fell back to a full rebuild");
+            return false;
+        }
+        if ( !matchesFullRebuild(cache, registry, config) ) return false;
+    }
+    return true;
+}
+
+/// @brief 验证 BPM 编辑会回退到完整重建。
+bool testBpmEditRebuildsFully()
+{
+    entt::registry            registry;
+    MMM::Config::EditorConfig config;
+    std::mt19937              random(11);
+    auto&                     cache = attachCache(registry);
+    populateTimeline(registry, random);
+    cache.refresh(registry, config, nullptr);
+
+    registry.emplace<TimelineComponent>(
+        registry.create(),
+        TimelineComponent{ .m_timestamp = 50.0,
+                           .m_effect    = MMM::TimingEffect::BPM,
+                           .m_value     = 200.0 });
+    cache.refresh(registry, config, nullptr);
+    if ( std::isfinite(cache.getLastRebuildFromTime()) ) {
+        XERROR("BPM edit was applied incrementally");
+        return false;
+    }
+    return matchesFullRebuild(cache, registry, config);
+}
+
+/// @brief 验证同一时间戳上的多条 SV/HS 增量编辑后，积分顺序与完整重建
+/// 一致，且亚帧抵消窗口只在后缀重新检出。
+bool testEqualKeyEditsMatchFullRebuild()
+{
+    entt::registry            registry;
+    MMM::Config::EditorConfig config;
+    auto&                     cache = attachCache(registry);
+    auto add = [&](double time, MMM::TimingEffect effect, double value) {
+        const auto entity = registry.create();
+        registry.emplace<TimelineComponent>(
+            entity,
+            TimelineComponent{
+                .m_timestamp = time, .m_effect = effect, .m_value = value });
+        return entity;
+    };
+
+    add(0.0, MMM::TimingEffect::BPM, 150.0);
+    std::vector<entt::entity> tied;
+    for ( int index = 1; index <= 40; ++index ) {
+        const double time = index * 0.5;
+        for ( int copy = 0; copy < 3; ++copy ) {
+            tied.push_back(
+                add(time, MMM::TimingEffect::SCROLL, 0.5 + (index + copy) % 4));
+        }
+        if ( index % 5 == 0 ) add(time, MMM::TimingEffect::HS, 1.5);
+    }
+    // 两段亚帧正负高速 SV 组成抵消窗口。
+    add(5.2, MMM::TimingEffect::SCROLL, 30.0);
+    add(5.202, MMM::TimingEffect::SCROLL, -30.0);
+    add(5.204, MMM::TimingEffect::SCROLL, 1.0);
+    add(12.2, MMM::TimingEffect::SCROLL, 30.0);
+    const auto windowEntity = add(12.202, MMM::TimingEffect::SCROLL, -30.0);
+    add(12.204, MMM::TimingEffect::SCROLL, 1.0);
+    cache.refresh(registry, config, nullptr);
+    if ( !matchesFullRebuild(cache, registry, config) ) return false;
+
+    auto expectIncremental = [&](const char* label) {
+        if ( !cache.refresh(registry, config, nullptr) ) {
+            XERROR("{}: edit did not trigger a refresh", label);
+            return false;
+        }
+        if ( !std::isfinite(cache.getLastRebuildFromTime()) ) {
+            XERROR("{}: edit fell back to a full rebuild", label);
+            return false;
+        }
+        return matchesFullRebuild(cache, registry, config);
+    };
+
+    for ( std::size_t index = 0; index < tied.size(); index += 7 ) {
+        registry.patch<TimelineComponent>(
+            tied[index], [](TimelineComponent& timeline) {
+                timeline.m_value += 0.25;
+            });
+        if ( !expectIncremental("value edit") ) return false;
+    }
+
+    // 移动到已有条目的时间戳，以及在已有时间戳上新建条目。
+    registry.patch<TimelineComponent>(
+        tied[4], [](TimelineComponent& timeline) {
+            timeline.m_timestamp = 15.0;
+        });
+    if ( !expectIncremental("move onto tie") ) return false;
+    add(7.5, MMM::TimingEffect::SCROLL, 3.0);
+    if ( !expectIncremental("create on tie") ) return false;
+
+    // 窗口之后的编辑保留窗口；窗口内的编辑使其在后缀重新检出。
+    registry.patch<TimelineComponent>(
+        tied[60], [](TimelineComponent& timeline) {
+            timeline.m_value = 2.0;
+        });
+    if ( !expectIncremental("edit after window") ) return false;
+    registry.patch<TimelineComponent>(
+        windowEntity, [](TimelineComponent& timeline) {
+            timeline.m_value = 1.0;
+        });
+    if ( !expectIncremental("break window") ) return false;
+    if ( cache.getLastRebuildFromTime() > 12.2 ) {
+        XERROR("Window rescan did not widen the rebuilt range");
+        return false;
+    }
+    registry.patch<TimelineComponent>(
+        windowEntity, [](TimelineComponent& timeline) {
+            timeline.m_value = -30.0;
+        });
+    return expectIncremental("restore window");
+}
+
+/// @brief 验证批量映射与逐个查询一致，包括乱序输入。
+bool testBatchQueriesMatchScalar()
+{
+    entt::registry            registry;
+    MMM::Config::EditorConfig config;
+    std::mt19937              random(3);
+    auto&                     cache = attachCache(registry);
+    populateTimeline(registry, random);
+    cache.refresh(registry, config, nullptr);
+
+    std::vector<double> times;
+    for ( double time = -2.0; time < 120.0; time += 0.013 ) {
+        times.push_back(time);
+    }
+    times.push_back(5.0);  // 乱序元素
+    times.push_back(130.0);
+
+    std::vector<double> absYs(times.size());
+    std::vector<double> hs(times.size());
+    cache.getAbsYBatch(times, absYs, hs);
+    constexpr double EPSILON = 1e-6;
+    for ( std::size_t index = 0; index < times.size(); ++index ) {
+        if ( std::abs(absYs[index] - cache.getAbsY(times[index])) > EPSILON ||
+             std::abs(hs[index] - cache.getHsAt(times[index])) > EPSILON ) {
+            XERROR("Batch AbsY differs at {}", times[index]);
+            return false;
+        }
+    }
+
+    // 反向映射：单调缓存走合并遍历，倒流后逐个回退，恢复后重新合并。
+    auto timesMatch = [&](const char* label) {
+        std::vector<double> queryAbsYs;
+        for ( double absY = cache.getAbsY(-2.0); absY < cache.getAbsY(120.0);
+              absY += 7.0 ) {
+            queryAbsYs.push_back(absY);
+        }
+        queryAbsYs.push_back(cache.getAbsY(5.0));  // 乱序元素
+        std::vector<double> batchTimes(queryAbsYs.size());
+        cache.getTimeBatch(queryAbsYs, batchTimes);
+        for ( std::size_t index = 0; index < queryAbsYs.size(); ++index ) {
+            if ( std::abs(batchTimes[index] -
+                          cache.getTime(queryAbsYs[index])) > EPSILON ) {
+                XERROR("{}: batch time differs at AbsY {}",
+                       label,
+                       queryAbsYs[index]);
+                return false;
+            }
+        }
+        return true;
+    };
+    if ( !timesMatch("monotonic") ) return false;
+
+    entt::entity reversed = entt::null;
+    for ( auto [entity, timeline] :
+          registry.view<const TimelineComponent>().each() ) {
+        if ( timeline.m_effect == MMM::TimingEffect::SCROLL &&
+             timeline.m_timestamp > 60.0 ) {
+            reversed = entity;
+            break;
+        }
+    }
+    registry.patch<TimelineComponent>(
+        reversed, [](TimelineComponent& timeline) { timeline.m_value = -1.5; });
+    cache.refresh(registry, config, nullptr);
+    if ( !timesMatch("reversed") ) return false;
+    registry.patch<TimelineComponent>(
+        reversed, [](TimelineComponent& timeline) { timeline.m_value = 1.5; });
+    cache.refresh(registry, config, nullptr);
+    return timesMatch("restored");
+}
+
+}  // namespace
+
+/// @brief 运行 ScrollCache 增量重建与批量查询测试。
+/// @return 全部测试通过时返回 0。
+int main()
+{
+    const bool passed = testIncrementalEditsMatchFullRebuild() &&
+                        testBpmEditRebuildsFully() &&
+                        testEqualKeyEditsMatchFullRebuild() &&
+                        testBatchQueriesMatchScalar();
+    return passed ? 0 : 1;
+}
@@ -0,0 +1,219 @@
+#include "logic/session/TimeIntervalIndex.h"
+
+#include "log/colorful-log.h"
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <map>
+#include <random>
+#include <tuple>
+#include <vector>
+
+namespace
+{
+
+using MMM::Logic::TimeIntervalIndex;
+
+/// @brief 参考实现中的条目：按 (起始时间, 实体) 排序后线性查询。
+using ReferenceEntry = std::tuple<double, std::uint32_t, double>;
+
+/// @brief 把参考表按索引的排序键展开。
+std::vector<ReferenceEntry> sortedReference(
+    const std::map<std::uint32_t, std::pair<double, double>>& reference)
+{
+    std::vector<ReferenceEntry> entries;
+    entries.reserve(reference.size());
+    for ( const auto& [entity, range] : reference ) {
+        entries.emplace_back(range.first, entity, range.second);
+    }
+    std::sort(entries.begin(), entries.end());
+    return entries;
+}
+
+/// @brief 迭代器距 begin() 的条目数。
+std::size_t positionOf(const TimeIntervalIndex&                 index,
+                       TimeIntervalIndex::const_iterator target)
+{
+    std::size_t position = 0;
+    for ( auto it = index.begin(); it != target; ++it ) ++position;
+    return position;
+}
+
+/// @brief 验证长条不会让之后所有音符都被视为可能可见。
+/// @return 查询只从仍在持续的长条开始时返回 true。
+bool testFirstEndingSkipsFinishedNotes()
+{
+    TimeIntervalIndex index;
+    index.assign({
+        { entt::entity{ 1 }, 0.0, 100.0 },
+        { entt::entity{ 2 }, 1.0, 1.0 },
+        { entt::entity{ 3 }, 2.0, 2.0 },
+        { entt::entity{ 4 }, 150.0, 150.0 },
+    });
+    const auto first = index.firstEndingAtOrAfter(50.0);
+    if ( first == index.end() || first->entity != entt::entity{ 1 } ) {
+        XERROR("Long hold was not reported as still visible");
+        return false;
+    }
+    const auto later = index.firstEndingAtOrAfter(120.0);
+    if ( later == index.end() || later->entity != entt::entity{ 4 } ||
+         index.upperBoundStart(150.0) != index.end() ||
+         index.firstEndingAtOrAfter(200.0) != index.end() ) {
+        XERROR("Visibility bounds after the long hold are incorrect");
+        return false;
+    }
+    return true;
+}
+
+/// @brief 验证区间查询只返回相交条目，且长条不会拖入之后已结束的音符。
+/// @return 查询结果与预期实体序列一致时返回 true。
+bool testQueryVisibleReturnsOverlaps()
+{
+    TimeIntervalIndex                     index;
+    std::vector<TimeIntervalIndex::Entry> entries{
+        { entt::entity{ 0 }, 0.0, 1000.0 }
+    };
+    for ( std::uint32_t entity = 1; entity <= 2000U; ++entity ) {
+        const double start = static_cast<double>(entity) * 0.25;
+        entries.push_back({ entt::entity{ entity }, start, start });
+    }
+    index.assign(entries);
+
+    std::vector<entt::entity> visible;
+    index.queryVisible(100.0, 101.0, [&](const TimeIntervalIndex::Entry& entry) {
+        visible.push_back(entry.entity);
+    });
+    std::vector<entt::entity> expected{ entt::entity{ 0 } };
+    for ( std::uint32_t entity = 400; entity <= 404U; ++entity ) {
+        expected.push_back(entt::entity{ entity });
+    }
+    if ( visible != expected ) {
+        XERROR("Range query returned {} entries, expected {}",
+               visible.size(),
+               expected.size());
+        return false;
+    }
+    return true;
+}
+
+/// @brief 验证移动已有实体只改变其位置，不产生重复条目。
+/// @return 移动后条目数不变且顺序正确时返回 true。
+bool testInsertMovesExistingEntity()
+{
+    TimeIntervalIndex index;
+    index.insert({ entt::entity{ 7 }, 3.0, 3.0 });
+    index.insert({ entt::entity{ 8 }, 1.0, 4.0 });
+    index.insert({ entt::entity{ 7 }, 0.5, 0.5 });
+    if ( index.size() != 2U || index.begin()->entity != entt::entity{ 7 } ||
+         !index.isConsistent() ) {
+        XERROR("Moving an indexed entity did not reorder it in place");
+        return false;
+    }
+    if ( !index.erase(entt::entity{ 7 }) || index.erase(entt::entity{ 7 }) ||
+         index.contains(entt::entity{ 7 }) || index.size() != 1U ) {
+        XERROR("Erasing an indexed entity returned inconsistent results");
+        return false;
+    }
+    return true;
+}
+
+/// @brief 随机插入、移动与删除，并与线性参考实现比较。
+/// @return 分块拆分与合并后查询结果始终与参考一致时返回 true。
+bool testRandomEditsMatchReference()
+{
+    std::mt19937                           random(20260517U);
+    std::uniform_real_distribution<double> time(0.0, 600.0);
+    std::uniform_real_distribution<double> length(0.0, 2.0);
+
+    TimeIntervalIndex                                index;
+    std::map<std::uint32_t, std::pair<double, double>> reference;
+    std::vector<TimeIntervalIndex::Entry>            initial;
+    for ( std::uint32_t entity = 0; entity < 4000U; ++entity ) {
+        const double start = time(random);
+        const double end   = start + (entity % 97U == 0U ? 60.0 : length(random));
+        initial.push_back({ entt::entity{ entity }, start, end });
+        reference[entity] = { start, end };
+    }
+    index.assign(initial);
+
+    for ( std::size_t step = 0; step < 40000U; ++step ) {
+        const auto entity = static_cast<std::uint32_t>(random() % 6000U);
+        if ( random() % 3U == 0U ) {
+            index.erase(entt::entity{ entity });
+            reference.erase(entity);
+        } else {
+            const double start = time(random);
+            const double end   = start + length(random);
+            index.insert({ entt::entity{ entity }, start, end });
+            reference[entity] = { start, end };
+        }
+        if ( step % 2000U != 0U ) continue;
+
+        const auto expected = sortedReference(reference);
+        if ( !index.isConsistent() || index.size() != expected.size() ) {
+            XERROR("Index became inconsistent after {} edits", step);
+            return false;
+        }
+        const double query         = time(random);
+        std::size_t  expectedFirst = expected.size();
+        for ( std::size_t i = 0; i < expected.size(); ++i ) {
+            if ( std::get<2>(expected[i]) >= query ) {
+                expectedFirst = i;
+                break;
+            }
+        }
+        const auto expectedUpper = static_cast<std::size_t>(std::distance(
+            expected.begin(),
+            std::upper_bound(expected.begin(),
+                             expected.end(),
+                             query,
+                             [](double value, const ReferenceEntry& entry) {
+                                 return value < std::get<0>(entry);
+                             })));
+        const double queryEnd = query + length(random) * 10.0;
+        std::vector<entt::entity> visible;
+        index.queryVisible(
+            query, queryEnd, [&](const TimeIntervalIndex::Entry& entry) {
+                visible.push_back(entry.entity);
+            });
+        std::vector<entt::entity> expectedVisible;
+        for ( const auto& [start, entity, end] : expected ) {
+            if ( start <= queryEnd && end >= query ) {
+                expectedVisible.push_back(entt::entity{ entity });
+            }
+        }
+        if ( visible != expectedVisible ) {
+            XERROR("Range query at {:.3f} disagrees with reference", query);
+            return false;
+        }
+        if ( positionOf(index, index.firstEndingAtOrAfter(query)) !=
+                 expectedFirst ||
+             positionOf(index, index.upperBoundStart(query)) !=
+                 expectedUpper ) {
+            XERROR("Index query at {:.3f} disagrees with reference", query);
+            return false;
+        }
+    }
+
+    for ( const auto& [entity, range] :
+          std::map<std::uint32_t, std::pair<double, double>>(reference) ) {
+        index.erase(entt::entity{ entity });
+    }
+    return index.empty() && index.begin() == index.end() &&
+           index.isConsistent();
+}
+
+}  // namespace
+
+/// @brief 运行时间区间索引测试。
+/// @return 全部测试通过时返回 0。
+int main()
+{
+    return testFirstEndingSkipsFinishedNotes() &&
+                   testQueryVisibleReturnsOverlaps() &&
+                   testInsertMovesExistingEntity() &&
+                   testRandomEditsMatchReference()
+               ? 0
+               : 1;
+}
@@ -0,0 +1,280 @@
+#include "logic/session/EditorActionCodec.h"
+
+#include "log/colorful-log.h"
+#include "logic/ecs/components/NoteComponent.h"
+#include "logic/ecs/components/TimelineComponent.h"
+#include "logic/session/NoteAction.h"
+#include "logic/session/TimelineAction.h"
+#include "logic/session/context/SessionContext.h"
+
+#include <cmath>
+#include <filesystem>
+#include <memory>
+#include <string>
+#include <vector>
+
+namespace
+{
+
+/// @brief 压力测试中连续更新的次数。
+constexpr int UPDATE_COUNT = 300;
+
+/// @brief 使用小容差比较时间线数值。
+bool near(double lhs, double rhs)
+{
+    return std::abs(lhs - rhs) < 1e-9;
+}
+
+/// @brief 构造一个带元数据与注释的音符。
+MMM::Logic::NoteComponent makeNote(double timestamp, int track)
+{
+    MMM::Logic::NoteComponent note;
+    note.m_timestamp  = timestamp;
+    note.m_trackIndex = track;
+    note.m_annotation = "annotation-" + std::to_string(track);
+    note.m_metadata.note_properties[MMM::NoteMetadataType::MALODY]["style"] =
+        std::string(64, 'x');
+    return note;
+}
+
+/// @brief 构造一个带长元数据的 SV 事件。
+MMM::Logic::TimelineComponent makeTimeline(double value)
+{
+    MMM::Logic::TimelineComponent timeline;
+    timeline.m_timestamp = 4.0;
+    timeline.m_effect    = MMM::TimingEffect::SCROLL;
+    timeline.m_value     = value;
+    timeline.m_metadata.timing_properties[MMM::TimingMetadataType::MALODY]
+                                         ["comment"] = std::string(200, 'm');
+    return timeline;
+}
+
+/// @brief 验证批量平移编码可逆，且紧凑编码小于活跃操作。
+bool testCodecRoundTrip()
+{
+    std::vector<MMM::Logic::BatchNoteAction::Entry> entries;
+    for ( int index = 0; index < 64; ++index ) {
+        auto before = makeNote(index * 0.5, index % 4);
+        auto after  = before;
+        after.m_timestamp += 0.25;
+        entries.push_back({ static_cast<entt::entity>(index),
+                            before,
+                            after,
+                            index % 2 == 0,
+                            std::nullopt });
+    }
+    entries.push_back({ static_cast<entt::entity>(100),
+                        std::nullopt,
+                        makeNote(40.0, 2),
+                        std::nullopt,
+                        true });
+    MMM::Logic::BatchNoteAction action(std::move(entries), "Align Selected");
+
+    std::string packed;
+    if ( !MMM::Logic::EditorActionCodec::encode(action, packed) ) {
+        XERROR("Batch note action could not be encoded");
+        return false;
+    }
+    if ( packed.size() >= action.memoryUsage() ) {
+        XERROR("Packed action ({} bytes) is not smaller than live action ({})",
+               packed.size(),
+               action.memoryUsage());
+        return false;
+    }
+
+    const auto decoded = MMM::Logic::EditorActionCodec::decode(packed);
+    std::string repacked;
+    if ( !decoded ||
+         !MMM::Logic::EditorActionCodec::encode(*decoded, repacked) ||
+         repacked != packed ) {
+        XERROR("Batch note action did not survive an encode round trip");
+        return false;
+    }
+    if ( decoded->getName() != action.getName() ||
+         decoded->mutationFlags() != action.mutationFlags() ) {
+        XERROR("Decoded action changed its name or mutation flags");
+        return false;
+    }
+
+    packed.pop_back();
+    if ( MMM::Logic::EditorActionCodec::decode(packed) ) {
+        XERROR("Truncated payload was decoded");
+        return false;
+    }
+    return true;
+}
+
+/// @brief 验证超出预算的历史溢出到磁盘，且撤销与重做结果不变。
+bool testBudgetSpillsAndRestores()
+{
+    const auto spillPath = std::filesystem::temp_directory_path() /
+                           "mmm-undo-budget-test" / "history.undo";
+    constexpr std::size_t BUDGET = 64 * 1024;
+
+    MMM::Logic::SessionContext context;
+    context.actionStack.setSpillPath(spillPath);
+    context.actionStack.setMemoryBudget(BUDGET);
+
+    const auto entity = context.timelineRegistry.create();
+    context.actionStack.pushAndExecute(
+        std::make_unique<MMM::Logic::TimelineAction>(
+            MMM::Logic::TimelineAction::Type::Create,
+            entity,
+            std::nullopt,
+            makeTimeline(0.0)),
+        context);
+    for ( int step = 0; step < UPDATE_COUNT; ++step ) {
+        context.actionStack.pushAndExecute(
+            std::make_unique<MMM::Logic::TimelineAction>(
+                MMM::Logic::TimelineAction::Type::Update,
+                entity,
+                makeTimeline(step),
+                makeTimeline(step + 1)),
+            context);
+    }
+
+    if ( context.actionStack.getMemoryUsage() > BUDGET ||
+         context.actionStack.getSpilledBytes() == 0 ) {
+        XERROR("Undo history used {} bytes with {} spilled",
+               context.actionStack.getMemoryUsage(),
+               context.actionStack.getSpilledBytes());
+        return false;
+    }
+    if ( context.actionStack.getUndoStackSize() != UPDATE_COUNT + 1 ) {
+        XERROR("Undo history dropped entries although spilling succeeded");
+        return false;
+    }
+
+    for ( int step = UPDATE_COUNT; step > 0; --step ) {
+        context.actionStack.undo(context);
+        const auto* timeline =
+            context.timelineRegistry.try_get<MMM::Logic::TimelineComponent>(
+                entity);
+        if ( !timeline || !near(timeline->m_value, step - 1) ||
+             timeline->m_metadata.timing_properties.empty() ) {
+            XERROR("Undo step {} restored the wrong state", step);
+            return false;
+        }
+    }
+    context.actionStack.undo(context);
+    if ( context.timelineRegistry.valid(entity) ) {
+        XERROR("Undoing the create did not remove the event");
+        return false;
+    }
+    if ( context.actionStack.getMemoryUsage() > BUDGET ) {
+        XERROR("Redo history exceeded the memory budget");
+        return false;
+    }
+
+    for ( int step = 0; step <= UPDATE_COUNT; ++step ) {
+        context.actionStack.redo(context);
+    }
+    const auto* timeline =
+        context.timelineRegistry.try_get<MMM::Logic::TimelineComponent>(
+            entity);
+    if ( !timeline || !near(timeline->m_value, UPDATE_COUNT) ) {
+        XERROR("Redo did not reach the final state");
+        return false;
+    }
+
+    context.actionStack.clear();
+    if ( std::filesystem::exists(spillPath) ) {
+        XERROR("Clearing the history did not remove the spill file");
+        return false;
+    }
+    return true;
+}
+
+/// @brief 验证反复撤销与重做时溢出文件会回收失效记录，大小保持有界。
+bool testSpillFileStaysBoundedAcrossUndoRedo()
+{
+    const auto spillPath = std::filesystem::temp_directory_path() /
+                           "mmm-undo-budget-test" / "cycle.undo";
+    constexpr std::size_t BUDGET      = 16 * 1024;
+    constexpr int         CYCLE_COUNT = 50;
+    constexpr int         CYCLE_DEPTH = 200;
+
+    MMM::Logic::SessionContext context;
+    context.actionStack.setSpillPath(spillPath);
+    context.actionStack.setMemoryBudget(BUDGET);
+
+    const auto entity = context.timelineRegistry.create();
+    context.actionStack.pushAndExecute(
+        std::make_unique<MMM::Logic::TimelineAction>(
+            MMM::Logic::TimelineAction::Type::Create,
+            entity,
+            std::nullopt,
+            makeTimeline(0.0)),
+        context);
+    for ( int step = 0; step < UPDATE_COUNT; ++step ) {
+        context.actionStack.pushAndExecute(
+            std::make_unique<MMM::Logic::TimelineAction>(
+                MMM::Logic::TimelineAction::Type::Update,
+                entity,
+                makeTimeline(step),
+                makeTimeline(step + 1)),
+            context);
+    }
+
+    // 文件只在末尾追加，压缩后按有效字节数截断。
+    const auto withinBound = [&]() {
+        std::error_code ec;
+        const auto      fileSize = std::filesystem::file_size(spillPath, ec);
+        const auto      bound =
+            2 * context.actionStack.getSpilledBytes() +
+            MMM::Logic::EditorActionStack::SPILL_COMPACT_MIN_BYTES;
+        if ( !ec && fileSize > bound ) {
+            XERROR("Spill file grew to {} bytes with {} still referenced",
+                   fileSize,
+                   context.actionStack.getSpilledBytes());
+            return false;
+        }
+        return true;
+    };
+    if ( context.actionStack.getSpilledBytes() == 0 || !withinBound() ) {
+        XERROR("Undo history did not spill before cycling");
+        return false;
+    }
+
+    for ( int cycle = 0; cycle < CYCLE_COUNT; ++cycle ) {
+        for ( int step = 0; step < CYCLE_DEPTH; ++step ) {
+            context.actionStack.undo(context);
+            if ( !withinBound() ) return false;
+        }
+        for ( int step = 0; step < CYCLE_DEPTH; ++step ) {
+            context.actionStack.redo(context);
+            if ( !withinBound() ) return false;
+        }
+    }
+
+    if ( context.actionStack.getUndoStackSize() != UPDATE_COUNT + 1 ) {
+        XERROR("Undo history lost entries while cycling");
+        return false;
+    }
+    for ( int step = UPDATE_COUNT; step > 0; --step ) {
+        context.actionStack.undo(context);
+        const auto* timeline =
+            context.timelineRegistry.try_get<MMM::Logic::TimelineComponent>(
+                entity);
+        if ( !timeline || !near(timeline->m_value, step - 1) ) {
+            XERROR("Undo step {} restored the wrong state after cycling",
+                   step);
+            return false;
+        }
+    }
+
+    context.actionStack.clear();
+    return !std::filesystem::exists(spillPath);
+}
+
+}  // namespace
+
+/// @brief 运行撤销历史编码与内存预算测试。
+/// @return 全部测试通过时返回 0。
+int main()
+{
+    const bool passed = testCodecRoundTrip() &&
+                        testBudgetSpillsAndRestores() &&
+                        testSpillFileStaysBoundedAcrossUndoRedo();
+    return passed ? 0 : 1;
+}
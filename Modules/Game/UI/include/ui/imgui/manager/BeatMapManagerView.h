@@ -5,6 +5,7 @@
 #include <cstdint>
 #include <deque>
 #include <filesystem>
+#include <memory>
 #include <vector>
 
 namespace MMM::UI
@@ -117,6 +118,14 @@ private:
     /// @brief 谱面排序缓存是否需要重建。
     bool m_beatmapSortCacheDirty{ true };
 
+    /// @brief 后台谱面头部探测任务与 UI 线程之间的交接区。
+    struct BeatmapHeaderProbeJob;
+
+    /// @brief 当前仍在进行的谱面头部探测任务；全部结果合并后置空。
+    /// @warning 跨线程共享：后台任务持有同一份所有权，视图只通过停止请求
+    /// 放弃旧任务，不等待其结束。
+    std::shared_ptr<BeatmapHeaderProbeJob> m_headerProbeJob;
+
     // --- 谱面管理相关 ---
     std::string m_manageBeatmapPath;
     bool        m_openManageModal{ false };
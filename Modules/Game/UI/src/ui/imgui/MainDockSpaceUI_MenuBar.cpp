@@ -157,6 +157,17 @@ void MainDockSpaceUI::renderMenuBar(UIManager* sourceManager,
         float fpsX   = buttonsStartX - fpsGap - fpsWidth;
         ImGui::SetCursorPosX(fpsX);
         ImGui::TextUnformatted(fpsStr.c_str());
+        if ( ImGui::IsItemHovered() ) {
+            // 输入突发时的命令队列诊断：上一统计窗口内单 tick 峰值。
+            const auto commandStats =
+                Logic::EditorEngine::instance().getCommandQueuePeakStats();
+            ImGui::SetTooltip("%s",
+                              TR_FMT("ui.menu.command_stats_fmt",
+                                     commandStats.enqueued,
+                                     commandStats.coalesced,
+                                     commandStats.applied)
+                                  .c_str());
+        }
         float fpsEndX = fpsX + fpsWidth;
         if ( menuFont ) ImGui::PopFont();
 
@@ -286,6 +286,23 @@ void MainDockSpaceUI::renderStatusBar(UIManager* sourceManager,
                     ImGui::Text("%s: %zu",
                                 TR("ui.status.max_combo").data(),
                                 snapshot->maxCombo);
+
+                    ImGui::SameLine();
+                    ImGui::SetCursorPosY(offsetY);
+                    ImGui::SeparatorEx(ImGuiSeparatorFlags_Vertical);
+                    ImGui::SameLine();
+                    ImGui::SetCursorPosY(offsetY);
+                    constexpr double MIB = 1024.0 * 1024.0;
+                    if ( snapshot->undoSpilledBytes > 0 ) {
+                        ImGui::Text("%s: %.1f MB (+%.1f MB)",
+                                    TR("ui.status.undo_memory").data(),
+                                    snapshot->undoMemoryBytes / MIB,
+                                    snapshot->undoSpilledBytes / MIB);
+                    } else {
+                        ImGui::Text("%s: %.1f MB",
+                                    TR("ui.status.undo_memory").data(),
+                                    snapshot->undoMemoryBytes / MIB);
+                    }
                 }
 
                 // 在状态栏最右侧显示最后一次操作信息
@@ -11,7 +11,9 @@
 #include "logic/EditorEngine.h"
 #include "logic/ProjectResourceService.h"
 #include "mmm/beatmap/BeatMap.h"
+#include "mmm/beatmap/BeatmapIndex.h"
 #include "mmm/project/Project.h"
+#include "runtime/AppThreadPool.h"
 #include "ui/Icons.h"
 #include "ui/UIManager.h"
 #include "ui/imgui/manager/NewBeatmapWizard.h"
@@ -25,9 +27,14 @@
 #include <ctime>
 #include <filesystem>
 #include <fmt/format.h>
+#include <ice/thread/ThreadPool.hpp>
 #include <imgui_internal.h>
+#include <mutex>
 #include <numeric>
+#include <optional>
+#include <stop_token>
 #include <system_error>
+#include <utility>
 
 namespace MMM::UI
 {
@@ -305,6 +312,26 @@ void renderScrollingTableText(const std::string& text, ImVec2 cursorPos,
 
 }  // namespace
 
+/// @brief 后台谱面头部探测任务与 UI 线程之间的交接区。
+struct BeatMapManagerView::BeatmapHeaderProbeJob {
+    /// @brief 放弃任务的停止请求源；项目或谱面列表变化时由 UI 线程触发。
+    std::stop_source stopSource;
+
+    /// @brief 保护 results 的互斥量。
+    std::mutex mutex;
+
+    /// @brief 已探测、等待 UI 线程合并的结果（谱面下标与摘要）；谱面
+    /// 无法读取时摘要为空。
+    std::vector<std::pair<size_t, std::optional<MMM::BeatmapSummary>>>
+        results;
+
+    /// @brief 需要探测的谱面总数。
+    size_t totalCount{ 0 };
+
+    /// @brief UI 线程已合并的结果数，仅由 UI 线程读写。
+    size_t mergedCount{ 0 };
+};
+
 /// @brief 获取谱面管理器中不可再换行控件所需的最小内容尺寸。
 /// @warning UI 热路径：子视图可见时每帧查询；仅保留轻量文本测量。
 ImVec2 BeatMapManagerView::getMinContentSize(float dpiScale) const
@@ -655,37 +682,128 @@ void BeatMapManagerView::onUpdate(LayoutContext& layoutContext,
             };
             renderBeatmapTableHeaderContextMenu();
 
-            auto rebuildSortCache = [&]() {
+            // 文件大小与修改时间在 UI 线程同步读取；版本与默认音频优先取自
+            // 项目谱面索引，索引未命中时读取谱面头部。两者都交给线程池逐个
+            // 处理，结果在后续帧中逐步合并。
+            auto restartBeatmapMetadataScan = [&]() {
+                if ( m_headerProbeJob ) {
+                    m_headerProbeJob->stopSource.request_stop();
+                    m_headerProbeJob.reset();
+                }
+
                 const auto& beatmaps = project->m_beatmaps;
-                m_sortedBeatmapIndices.resize(beatmaps.size());
+                // 同一份谱面列表重新扫描时保留已探测字段，避免列表闪烁。
+                const bool keepHeaders =
+                    m_cachedBeatmapProject == project &&
+                    m_beatmapFileMetadata.size() == beatmaps.size();
                 m_beatmapFileMetadata.resize(beatmaps.size());
-                std::iota(m_sortedBeatmapIndices.begin(),
-                          m_sortedBeatmapIndices.end(),
-                          size_t{ 0 });
+                std::vector<std::filesystem::path> filePaths;
+                filePaths.reserve(beatmaps.size());
                 for ( size_t index = 0; index < beatmaps.size(); ++index ) {
-                    const auto filePath =
+                    filePaths.push_back(
                         project->m_projectRoot /
-                        Config::utf8ToPath(beatmaps[index].m_filePath);
-                    m_beatmapFileMetadata[index] =
-                        queryBeatmapFileMetadata(filePath);
-                    auto beatmap = MMM::BeatMap::loadFromFile(filePath);
-                    if ( !beatmap.m_baseMapMetadata.map_path.empty() ) {
-                        m_beatmapFileMetadata[index].version =
-                            beatmap.m_baseMapMetadata.version;
-                        m_beatmapFileMetadata[index].hasVersion = true;
-                        if ( const auto* audioResource =
-                                 Logic::ProjectResourceService::
-                                     findDefaultBeatmapAudioResource(
-                                         *project,
-                                         beatmap,
-                                         beatmaps[index].m_filePath) ) {
-                            m_beatmapFileMetadata[index].audioResourceId =
-                                audioResource->m_id;
-                            m_beatmapFileMetadata[index].hasAudioResource =
-                                true;
+                        Config::utf8ToPath(beatmaps[index].m_filePath));
+                    auto  metadata = queryBeatmapFileMetadata(filePaths.back());
+                    auto& previous = m_beatmapFileMetadata[index];
+                    if ( keepHeaders ) {
+                        metadata.version          = std::move(previous.version);
+                        metadata.hasVersion       = previous.hasVersion;
+                        metadata.audioResourceId  =
+                            std::move(previous.audioResourceId);
+                        metadata.hasAudioResource = previous.hasAudioResource;
+                    }
+                    previous = std::move(metadata);
+                }
+                m_cachedBeatmapCount    = beatmaps.size();
+                m_cachedBeatmapProject  = project;
+                m_beatmapSortCacheDirty = false;
+                if ( filePaths.empty() ) return;
+
+                m_headerProbeJob = std::make_shared<BeatmapHeaderProbeJob>();
+                m_headerProbeJob->totalCount    = filePaths.size();
+                const std::stop_token stopToken =
+                    m_headerProbeJob->stopSource.get_token();
+                auto task = [job          = m_headerProbeJob,
+                             stopToken,
+                             beatmapIndex = MMM::BeatmapIndex::active(),
+                             filePaths    = std::move(filePaths)]() {
+                    for ( size_t index = 0; index < filePaths.size();
+                          ++index ) {
+                        if ( stopToken.stop_requested() ) return;
+                        std::optional<MMM::BeatmapSummary> summary;
+                        if ( beatmapIndex ) {
+                            summary = beatmapIndex->find(filePaths[index]);
+                        }
+                        if ( !summary ) {
+                            const auto beatmap =
+                                MMM::BeatMap::probeHeader(filePaths[index]);
+                            if ( !beatmap.m_baseMapMetadata.map_path
+                                      .empty() ) {
+                                summary =
+                                    MMM::BeatmapSummary::fromBeatMap(beatmap);
+                            }
                         }
+                        std::lock_guard<std::mutex> lock(job->mutex);
+                        job->results.emplace_back(index, std::move(summary));
+                    }
+                };
+
+                auto* appThreadPool =
+                    MMM::Runtime::AppThreadPool::instance().get();
+                if ( appThreadPool ) {
+                    appThreadPool->enqueue_void(std::move(task));
+                } else {
+                    task();
+                }
+            };
+
+            // 合并后台探测结果；默认音频解析读取项目资源，只在 UI 线程进行。
+            auto mergeProbedBeatmapHeaders = [&]() -> bool {
+                if ( !m_headerProbeJob ) return false;
+                std::vector<
+                    std::pair<size_t, std::optional<MMM::BeatmapSummary>>>
+                    results;
+                {
+                    std::lock_guard<std::mutex> lock(m_headerProbeJob->mutex);
+                    results.swap(m_headerProbeJob->results);
+                }
+
+                const auto& beatmaps = project->m_beatmaps;
+                for ( const auto& [index, summary] : results ) {
+                    if ( index >= m_beatmapFileMetadata.size() ) continue;
+                    auto& metadata            = m_beatmapFileMetadata[index];
+                    metadata.version          = {};
+                    metadata.hasVersion       = false;
+                    metadata.audioResourceId  = {};
+                    metadata.hasAudioResource = false;
+                    if ( !summary ) continue;
+                    metadata.version    = summary->version;
+                    metadata.hasVersion = true;
+                    if ( const auto* audioResource =
+                             Logic::ProjectResourceService::
+                                 findDefaultBeatmapAudioResource(
+                                     *project,
+                                     *summary,
+                                     beatmaps[index].m_filePath) ) {
+                        metadata.audioResourceId  = audioResource->m_id;
+                        metadata.hasAudioResource = true;
                     }
                 }
+
+                m_headerProbeJob->mergedCount += results.size();
+                if ( m_headerProbeJob->mergedCount >=
+                     m_headerProbeJob->totalCount ) {
+                    m_headerProbeJob.reset();
+                }
+                return !results.empty();
+            };
+
+            auto sortBeatmapIndices = [&]() {
+                const auto& beatmaps = project->m_beatmaps;
+                m_sortedBeatmapIndices.resize(beatmaps.size());
+                std::iota(m_sortedBeatmapIndices.begin(),
+                          m_sortedBeatmapIndices.end(),
+                          size_t{ 0 });
                 std::stable_sort(
                     m_sortedBeatmapIndices.begin(),
                     m_sortedBeatmapIndices.end(),
@@ -747,16 +865,20 @@ void BeatMapManagerView::onUpdate(LayoutContext& layoutContext,
                         }
                         return compareResult < 0;
                     });
-                m_cachedBeatmapCount    = beatmaps.size();
-                m_cachedBeatmapProject  = project;
-                m_beatmapSortCacheDirty = false;
             };
 
+            bool resortBeatmaps = false;
             if ( m_beatmapSortCacheDirty ||
                  m_cachedBeatmapCount != project->m_beatmaps.size() ||
                  m_cachedBeatmapProject != project ) {
-                rebuildSortCache();
+                restartBeatmapMetadataScan();
+                resortBeatmaps = true;
+            }
+            if ( mergeProbedBeatmapHeaders() &&
+                 m_beatmapSortKey == BeatmapSortKey::Version ) {
+                resortBeatmaps = true;
             }
+            if ( resortBeatmaps ) sortBeatmapIndices();
 
             ImGuiListClipper clipper;
             clipper.Begin(static_cast<int>(m_sortedBeatmapIndices.size()),
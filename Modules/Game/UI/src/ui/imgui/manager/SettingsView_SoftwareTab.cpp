@@ -1367,6 +1367,24 @@ void SettingsView::drawSoftwareSettings()
                 }
             });
 
+        // 撤销历史内存预算
+        addSettingItem(
+            *sec,
+            rowIndex,
+            TR_CACHE("ui.settings.software.undo_memory_budget").data(),
+            maxLabelW,
+            [&](Clay_BoundingBox r, bool) {
+                ImGui::SetNextItemWidth(r.width);
+                if ( ::MMM::UI::FeedbackSliderInt(
+                         "##UndoMemoryBudget",
+                         &settings.undoMemoryBudgetMB,
+                         16,
+                         4096,
+                         "%d MB") ) {
+                    changed = true;
+                }
+            });
+
         // 同步设置
         addSettingItem(
             *sec,
@@ -77,8 +77,7 @@ struct MetadataJsonEditorState {
 };
 
 /// @brief 元数据属性表类型。
-using MetadataPropertyMap =
-    std::unordered_map<std::string, std::string, StringHash, std::equal_to<>>;
+using MetadataPropertyMap = MetadataProperties;
 
 /// @brief 元数据字段说明列表类型。
 using MetadataFieldList = std::vector<std::pair<std::string, std::string>>;
@@ -8,6 +8,7 @@
 #include "logic/EditorEngine.h"
 #include "logic/ProjectResourceService.h"
 #include "mmm/beatmap/BeatMap.h"
+#include "mmm/beatmap/BeatmapIndex.h"
 #include "mmm/project/PackageFileTypes.h"
 #include "mmm/project/Project.h"
 #include "ui/imgui/menu/package/PackageDefaultSelection.h"
@@ -576,8 +577,20 @@ PackageBeatmapInfo collectPackageBeatmapInfo(
     const auto relativePath = Config::utf8ToPath(normalizedBeatmapPath);
     const auto mapPath =
         resolvePackageProjectPath(project.m_projectRoot, relativePath);
-    auto beatMap = BeatMap::loadFromFile(mapPath);
-    if ( beatMap.m_baseMapMetadata.map_path.empty() ) {
+    // 项目谱面索引已有摘要时不必加载整张谱面；引用按去重后的计数
+    // 记录，依赖与未解析引用本身也按去重收集，结果不变。
+    std::optional<BeatmapSummary> summary;
+    const auto                    beatmapIndex = BeatmapIndex::active();
+    if ( beatmapIndex && beatmapIndex->projectRoot() ==
+                             project.m_projectRoot.lexically_normal() ) {
+        summary = beatmapIndex->summary(mapPath);
+    } else {
+        const auto beatMap = BeatMap::loadFromFile(mapPath);
+        if ( !beatMap.m_baseMapMetadata.map_path.empty() ) {
+            summary = BeatmapSummary::fromBeatMap(beatMap);
+        }
+    }
+    if ( !summary ) {
         result.loadFailed = true;
         return result;
     }
@@ -586,40 +599,19 @@ PackageBeatmapInfo collectPackageBeatmapInfo(
     auto       mapExtension      = Config::pathToUtf8(mapPath.extension());
     mapExtension                 = toLowerAscii(mapExtension);
     const bool preferProjectRoot = packageExtensionEquals(mapExtension, ".mmm");
-    const auto& meta             = beatMap.m_baseMapMetadata;
 
-    result.hasStoreModeExtEligibleElements =
-        !beatMap.m_noteData.flicks.empty() ||
-        !beatMap.m_noteData.polylines.empty();
+    result.hasStoreModeExtEligibleElements = summary->hasFlicksOrPolylines;
 
     std::vector<PackageAudioReference> audioReferences;
-    audioReferences.reserve(
-        beatMap.m_noteData.notes.size() + beatMap.m_noteData.holds.size() +
-        beatMap.m_noteData.flicks.size() + beatMap.m_noteData.polylines.size() +
-        beatMap.m_audioSamples.size());
-
-    /// @brief 收集一个玩家物件绑定的采样资源。
-    auto appendNoteBinding = [&](const Note& note) {
-        const auto binding = note.getSampleBinding();
-        if ( !binding ) return;
+    audioReferences.reserve(summary->noteSampleReferences.size() +
+                            summary->audioSampleReferences.size());
+    for ( const auto& reference : summary->noteSampleReferences ) {
         appendPackageAudioReference(
-            audioReferences, binding->m_audioResourceId, "Note sample");
-    };
-    for ( const auto& note : beatMap.m_noteData.notes ) {
-        appendNoteBinding(note);
-    }
-    for ( const auto& hold : beatMap.m_noteData.holds ) {
-        appendNoteBinding(hold);
-    }
-    for ( const auto& flick : beatMap.m_noteData.flicks ) {
-        appendNoteBinding(flick);
-    }
-    for ( const auto& polyline : beatMap.m_noteData.polylines ) {
-        appendNoteBinding(polyline);
+            audioReferences, reference.reference, "Note sample");
     }
-    for ( const auto& sample : beatMap.m_audioSamples ) {
+    for ( const auto& reference : summary->audioSampleReferences ) {
         appendPackageAudioReference(
-            audioReferences, sample.m_audioResourceId, "audio_samples");
+            audioReferences, reference.reference, "audio_samples");
     }
 
     std::vector<std::string_view> audioReferenceViews;
@@ -650,12 +642,12 @@ PackageBeatmapInfo collectPackageBeatmapInfo(
     appendPackageMetadataDependency(result.dependencyRelativePaths,
                                     project.m_projectRoot,
                                     mapDirectory,
-                                    meta.main_cover_path,
+                                    summary->mainCoverPath,
                                     preferProjectRoot);
     appendPackageMetadataDependency(result.dependencyRelativePaths,
                                     project.m_projectRoot,
                                     mapDirectory,
-                                    meta.cover_path,
+                                    summary->coverPath,
                                     preferProjectRoot);
 
     result.dependencyRelativePaths.erase(
@@ -15,6 +15,7 @@
 #include <cmath>
 #include <fmt/format.h>
 #include <imgui.h>
+#include <memory>
 #include <mutex>
 #include <string>
 #include <vector>
@@ -63,312 +64,45 @@ private:
         std::string note2Desc;
     };
 
-    /// @brief 扫描当前谱面中的重叠音符并缓存检测结果。
-    void performScan()
+    /// @brief 把会话后台检测结果转换为窗口行；结果未变化时直接复用缓存。
+    /// @param scan 活动会话的后台重叠检测。
+    /// @warning UI 热路径：窗口打开时每帧执行；只有新结果发布后才重建行。
+    void syncResults(const Logic::OverlapScanService& scan)
     {
+        auto report = scan.report();
+        if ( report == m_report ) return;
+        m_report = std::move(report);
         m_results.clear();
-        m_hasScan = true;
-
-        auto& engine = Logic::EditorEngine::instance();
-        std::lock_guard<std::recursive_mutex> sessionLock(
-            engine.getSessionMutex());
-        auto session = engine.getActiveSession();
-        if ( !session ) return;
-
-        struct CheckItem {
-            /// @brief 音符类型。
-            ::MMM::NoteType type{ ::MMM::NoteType::NOTE };
-            /// @brief 起始时间。
-            double startTime{ 0.0 };
-            /// @brief 结束时间。
-            double endTime{ 0.0 };
-            /// @brief 起始轨道。
-            int track{ 0 };
-            /// @brief Flick 轨道增量。
-            int dtrack{ 0 };
-            /// @brief 音符实体。
-            entt::entity entity{ entt::null };
-            /// @brief 所属折线实体。
-            entt::entity parentPolyline{ entt::null };
-            /// @brief UI 显示描述。
-            std::string desc;
-        };
-
-        std::vector<CheckItem> items;
-        const auto&            registry = session->getContext().noteRegistry;
-        auto view = registry.view<const Logic::NoteComponent>();
-
-        for ( auto entity : view ) {
-            const auto& nc = view.get<const Logic::NoteComponent>(entity);
-            if ( nc.m_type == ::MMM::NoteType::POLYLINE ) continue;
-
-            double startTime = nc.m_timestamp;
-            double endTime   = startTime;
-            if ( nc.m_type == ::MMM::NoteType::HOLD ) {
-                endTime = startTime + std::max(0.0, nc.m_duration);
-            }
+        if ( !m_report ) return;
 
-            std::string desc = "Note";
-            if ( nc.m_type == ::MMM::NoteType::HOLD ) {
-                desc = nc.m_isSubNote ? "Polyline Hold" : "Hold";
-            } else if ( nc.m_type == ::MMM::NoteType::FLICK ) {
-                desc = nc.m_isSubNote ? "Polyline Flick" : "Flick";
+        auto describe = [](const Logic::OverlapItem& item) -> std::string {
+            const bool isPolyline = item.subIndex >= 0;
+            if ( item.type == ::MMM::NoteType::HOLD ) {
+                return isPolyline ? "Polyline Hold" : "Hold";
             }
-
-            items.push_back({ nc.m_type,
-                              startTime,
-                              endTime,
-                              nc.m_trackIndex,
-                              nc.m_dtrack,
-                              entity,
-                              nc.m_parentPolyline,
-                              desc });
-        }
-
-        struct PairHit {
-            /// @brief 第一项索引。
-            size_t i{ 0 };
-            /// @brief 第二项索引。
-            size_t j{ 0 };
-            /// @brief 重叠轨道。
-            int track{ 0 };
-            /// @brief 重叠时间。
-            double time{ 0.0 };
-        };
-
-        struct PointProbe {
-            /// @brief 检测时间。
-            double time{ 0.0 };
-            /// @brief 检测轨道。
-            int track{ 0 };
-            /// @brief 是否检测 Flick 跨轨身体。
-            bool testsFlickBody{ false };
-        };
-
-        const double windowSeconds =
-            static_cast<double>(std::max(0.0f,
-                                         Config::AppConfig::instance()
-                                             .getEditorSettings()
-                                             .overlapTimeWindowMs)) *
-            0.001;
-        constexpr double timeEpsilon = 1e-7;
-
-        auto samePolylineParent = [](const CheckItem& a, const CheckItem& b) {
-            return a.parentPolyline != entt::null &&
-                   a.parentPolyline == b.parentPolyline;
-        };
-
-        auto flickMinTrack = [](const CheckItem& item) {
-            return std::min(item.track, item.track + item.dtrack);
-        };
-        auto flickMaxTrack = [](const CheckItem& item) {
-            return std::max(item.track, item.track + item.dtrack);
-        };
-
-        auto collectPoints = [&](const CheckItem& item) {
-            std::vector<PointProbe> points;
-            if ( item.type == ::MMM::NoteType::NOTE ) {
-                points.push_back({ item.startTime, item.track, true });
-            } else if ( item.type == ::MMM::NoteType::HOLD ) {
-                points.push_back({ item.startTime, item.track, true });
-                if ( item.endTime > item.startTime + timeEpsilon ) {
-                    points.push_back({ item.endTime, item.track, true });
-                }
-            } else if ( item.type == ::MMM::NoteType::FLICK ) {
-                points.push_back({ item.startTime, item.track, false });
-                points.push_back(
-                    { item.startTime, item.track + item.dtrack, true });
+            if ( item.type == ::MMM::NoteType::FLICK ) {
+                return isPolyline ? "Polyline Flick" : "Flick";
             }
-            return points;
+            return "Note";
         };
 
-        auto isOverlapPair = [&](const CheckItem& a,
-                                 const CheckItem& b,
-                                 int&             overlapTrack,
-                                 double&          overlapTime) {
-            if ( samePolylineParent(a, b) ) return false;
-
-            overlapTrack = a.track;
-            overlapTime  = std::min(a.startTime, b.startTime);
-
-            auto aPoints = collectPoints(a);
-            auto bPoints = collectPoints(b);
-            for ( const auto& aPoint : aPoints ) {
-                for ( const auto& bPoint : bPoints ) {
-                    if ( aPoint.track != bPoint.track ) continue;
-                    if ( std::abs(aPoint.time - bPoint.time) >
-                         windowSeconds + timeEpsilon )
-                        continue;
-
-                    overlapTrack = aPoint.track;
-                    overlapTime  = std::min(aPoint.time, bPoint.time);
-                    return true;
-                }
-            }
-
-            auto flickBodyContainsPoint = [&](const CheckItem&  flick,
-                                              const PointProbe& point) {
-                if ( !point.testsFlickBody ||
-                     flick.type != ::MMM::NoteType::FLICK || flick.dtrack == 0 )
-                    return false;
-                if ( std::abs(point.time - flick.startTime) >
-                     windowSeconds + timeEpsilon )
-                    return false;
-                return point.track >= flickMinTrack(flick) &&
-                       point.track <= flickMaxTrack(flick);
-            };
-
-            for ( const auto& point : bPoints ) {
-                if ( flickBodyContainsPoint(a, point) ) {
-                    overlapTrack = point.track;
-                    overlapTime  = point.time;
-                    return true;
-                }
-            }
-            for ( const auto& point : aPoints ) {
-                if ( flickBodyContainsPoint(b, point) ) {
-                    overlapTrack = point.track;
-                    overlapTime  = point.time;
-                    return true;
-                }
-            }
-
-            if ( a.type == ::MMM::NoteType::NOTE &&
-                 b.type == ::MMM::NoteType::NOTE ) {
-                return a.track == b.track &&
-                       std::abs(a.startTime - b.startTime) < windowSeconds;
-            }
-
-            if ( a.type == ::MMM::NoteType::HOLD &&
-                 b.type == ::MMM::NoteType::HOLD && a.track == b.track ) {
-                double start = std::max(a.startTime, b.startTime);
-                double end   = std::min(a.endTime, b.endTime);
-                overlapTime  = start;
-                return end > start + timeEpsilon;
-            }
-
-            if ( a.type == ::MMM::NoteType::FLICK &&
-                 b.type == ::MMM::NoteType::FLICK && a.dtrack != 0 &&
-                 b.dtrack != 0 &&
-                 std::abs(a.startTime - b.startTime) <=
-                     windowSeconds + timeEpsilon ) {
-                int minTrack = std::max(flickMinTrack(a), flickMinTrack(b));
-                int maxTrack = std::min(flickMaxTrack(a), flickMaxTrack(b));
-                overlapTrack = minTrack;
-                return maxTrack > minTrack;
-            }
-
-            auto holdBodyContainsPoint = [&](const CheckItem&  hold,
-                                             const PointProbe& point) {
-                return hold.type == ::MMM::NoteType::HOLD &&
-                       point.track == hold.track &&
-                       point.time > hold.startTime + timeEpsilon &&
-                       point.time < hold.endTime - timeEpsilon;
-            };
-
-            for ( const auto& point : bPoints ) {
-                if ( holdBodyContainsPoint(a, point) ) {
-                    overlapTrack = point.track;
-                    overlapTime  = point.time;
-                    return true;
-                }
-            }
-            for ( const auto& point : aPoints ) {
-                if ( holdBodyContainsPoint(b, point) ) {
-                    overlapTrack = point.track;
-                    overlapTime  = point.time;
-                    return true;
-                }
-            }
-
-            auto holdFlickCrosses = [&](const CheckItem& hold,
-                                        const CheckItem& flick) {
-                if ( hold.type != ::MMM::NoteType::HOLD ||
-                     flick.type != ::MMM::NoteType::FLICK || flick.dtrack == 0 )
-                    return false;
-                if ( flick.startTime <= hold.startTime + timeEpsilon ||
-                     flick.startTime >= hold.endTime - timeEpsilon )
-                    return false;
-                return hold.track >= flickMinTrack(flick) &&
-                       hold.track <= flickMaxTrack(flick);
-            };
-
-            if ( holdFlickCrosses(a, b) ) {
-                overlapTrack = a.track;
-                overlapTime  = b.startTime;
-                return true;
-            }
-            if ( holdFlickCrosses(b, a) ) {
-                overlapTrack = b.track;
-                overlapTime  = a.startTime;
-                return true;
-            }
-
-            return false;
-        };
-
-        std::vector<PairHit> pairHits;
-
-        for ( size_t i = 0; i < items.size(); ++i ) {
-            for ( size_t j = i + 1; j < items.size(); ++j ) {
-                int    overlapTrack = 0;
-                double overlapTime  = 0.0;
-                if ( !isOverlapPair(
-                         items[i], items[j], overlapTrack, overlapTime) )
-                    continue;
-
-                pairHits.push_back({ i, j, overlapTrack, overlapTime });
-            }
-        }
-
-        std::sort(pairHits.begin(),
-                  pairHits.end(),
-                  [](const PairHit& a, const PairHit& b) {
-                      if ( a.track != b.track ) return a.track < b.track;
-                      return a.time < b.time;
-                  });
-
-        for ( size_t i = 0; i < pairHits.size(); ) {
-            size_t j = i + 1;
-            while ( j < pairHits.size() &&
-                    pairHits[j].track == pairHits[i].track &&
-                    pairHits[j].time <=
-                        pairHits[i].time + windowSeconds + timeEpsilon ) {
-                ++j;
-            }
-
-            std::vector<size_t> indices;
-            indices.reserve((j - i) * 2);
-            auto addUniqueIndex = [&](size_t index) {
-                if ( std::find(indices.begin(), indices.end(), index) ==
-                     indices.end() ) {
-                    indices.push_back(index);
-                }
-            };
-
-            double minTime = pairHits[i].time;
-            for ( size_t k = i; k < j; ++k ) {
-                addUniqueIndex(pairHits[k].i);
-                addUniqueIndex(pairHits[k].j);
-                minTime = std::min(minTime, pairHits[k].time);
-            }
-
+        m_results.reserve(m_report->findings.size());
+        for ( const auto& finding : m_report->findings ) {
             std::string desc1;
             std::string desc2;
-            if ( indices.size() == 2 && j == i + 1 ) {
-                desc1 = items[pairHits[i].i].desc;
-                desc2 = items[pairHits[i].j].desc;
+            if ( finding.objectCount == 2 && finding.regionCount == 1 ) {
+                desc1 = describe(m_report->items[finding.firstItem]);
+                desc2 = describe(m_report->items[finding.secondItem]);
             } else {
-                desc1 = TR_FMT("ui.tools.multiple_objects", indices.size());
+                desc1 =
+                    TR_FMT("ui.tools.multiple_objects", finding.objectCount);
                 desc2 = TR("ui.tools.each_other").data();
             }
-
             m_results.push_back({ true,
-                                  minTime,
-                                  static_cast<uint32_t>(pairHits[i].track),
-                                  desc1,
-                                  desc2 });
-            i = j;
+                                  finding.time,
+                                  static_cast<uint32_t>(finding.track),
+                                  std::move(desc1),
+                                  std::move(desc2) });
         }
     }
 
@@ -434,7 +168,9 @@ private:
                                        "%s",
                                        TR("ui.tools.no_active_beatmap").data());
                 } else {
-                    renderResults(dpiScale);
+                    const auto& scan = session->getContext().overlapScan;
+                    syncResults(scan);
+                    renderResults(dpiScale, scan.isScanning());
                 }
             }
         }
@@ -445,24 +181,15 @@ private:
 
     /// @brief 渲染重叠检测结果内容。
     /// @param dpiScale 当前窗口内容缩放。
+    /// @param isScanning 后台是否仍在检测最新修改。
     /// @warning UI 热路径：每帧执行；仅在窗口打开时绘制结果表。
-    void renderResults(float dpiScale)
+    void renderResults(float dpiScale, bool isScanning)
     {
-        if ( !m_hasScan ) {
-            if ( ::MMM::UI::FeedbackButton(TR("ui.tools.scan_now").data(),
-                                           ImVec2(-1.0f, 40.0f * dpiScale)) ) {
-                performScan();
-            }
-            return;
-        }
-
-        if ( ::MMM::UI::FeedbackButton(
-                 TR("ui.tools.rescan").data(),
-                 ImVec2(120.0f * dpiScale, 30.0f * dpiScale)) ) {
-            performScan();
+        if ( isScanning ) {
+            ImGui::TextDisabled("%s", TR("ui.tools.overlap_scanning").data());
         }
+        if ( !m_report ) return;
 
-        ImGui::SameLine();
         int definiteCount  = 0;
         int suspectedCount = 0;
         for ( const auto& result : m_results ) {
@@ -578,8 +305,8 @@ private:
     /// @brief 是否显示重叠检测窗口。
     bool m_showWindow = false;
 
-    /// @brief 当前重叠检测结果是否已生成。
-    bool m_hasScan = false;
+    /// @brief 当前窗口行对应的后台检测结果。
+    std::shared_ptr<const Logic::OverlapReport> m_report;
 
     /// @brief 当前缓存的重叠检测结果。
     std::vector<OverlapResult> m_results;
@@ -15,6 +15,7 @@
 #include "graphic/imguivk/VKRenderer.h"
 #include "log/colorful-log.h"
 #include "logic/EditorEngine.h"
+#include "mmm/ParallelExecutor.h"
 #include "network/collaboration/CollaborationRoom.h"
 #include "runtime/AppThreadPool.h"
 #include "ui/UIManager.h"
@@ -30,8 +31,11 @@
 #include "ui/imgui/manager/NewBeatmapWizard.h"
 #include "ui/imgui/manager/NewProjectWizard.h"
 #include "ui/imgui/manager/SearchView.h"
+#include <algorithm>
 #include <array>
 #include <chrono>
+#include <functional>
+#include <ice/thread/ThreadPool.hpp>
 #include <nfd.h>
 #include <thread>
 #include <utility>
@@ -188,6 +192,16 @@ int GameLoop::start(Graphic::NativeWindow& window, int argc, char* argv[],
     if ( g_vkContext ) {
         auto& appThreadPool = Runtime::AppThreadPool::instance();
         appThreadPool.init();
+        // 谱面格式库不依赖 Runtime，由这里把共享线程池注入为其并行执行器。
+        MMM::ParallelExecutor mapExecutor;
+        mapExecutor.submit = [&appThreadPool](std::function<void()> task) {
+            if ( auto* threadPool = appThreadPool.get() ) {
+                threadPool->enqueue_void(std::move(task));
+            }
+        };
+        mapExecutor.concurrency = static_cast<std::size_t>(
+            std::max<int32_t>(1, appThreadPool.requestedWorkerCount()));
+        MMM::setParallelExecutor(std::move(mapExecutor));
 
         auto& context = g_vkContext->get();
         int   fbWidth, fbHeight;
@@ -346,6 +360,7 @@ int GameLoop::start(Graphic::NativeWindow& window, int argc, char* argv[],
         (void)context.getLogicalDevice().waitIdle();
         m_uiManager.clearAllViews();
         context.release();
+        MMM::setParallelExecutor({});
         appThreadPool.shutdown();
         appThreadPool.completeApplicationShutdownWatchdog();
         return EXIT_NORMAL;
@@ -0,0 +1,133 @@
+#pragma once
+
+#include "mmm/beatmap/BeatMap.h"
+#include <cstddef>
+#include <filesystem>
+#include <functional>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace MMM::Convert
+{
+
+/// @brief 批量转换参数。
+struct BatchConvertOptions {
+    /// @brief 输入文件或目录；目录按 sourceExtensions 筛选谱面。
+    std::vector<std::filesystem::path> inputs;
+
+    /// @brief 输出根目录；为空时写在源文件旁边。
+    /// @details 目录输入在其下保留相对路径，单个文件直接写入该目录。
+    std::filesystem::path outputDirectory;
+
+    /// @brief 目标格式扩展名（含点号），如 ".mmm"。
+    std::string targetExtension{ ".mmm" };
+
+    /// @brief 从目录中挑选的源格式扩展名；为空时取目标以外的全部格式。
+    std::vector<std::string> sourceExtensions;
+
+    /// @brief 是否递归进入子目录。
+    bool recursive{ true };
+
+    /// @brief 目标文件已存在时是否覆盖；否则跳过。
+    bool overwrite{ false };
+
+    /// @brief 保存后重新加载输出并与源谱面逐物件比较。
+    bool verify{ false };
+
+    /// @brief 并行转换的线程数；0 表示硬件线程数。
+    std::size_t jobs{ 0 };
+};
+
+/// @brief 单个转换任务。
+struct ConvertJob {
+    /// @brief 源谱面路径。
+    std::filesystem::path source;
+
+    /// @brief 输出路径。
+    std::filesystem::path output;
+
+    /// @brief 与先前任务输出路径冲突时记录先前的源文件；为空表示无冲突。
+    std::filesystem::path conflictsWith;
+};
+
+/// @brief 单个转换任务的结果状态。
+enum class ConvertStatus {
+    CONVERTED,
+    SKIPPED,
+    LOAD_FAILED,
+    SAVE_FAILED,
+    VERIFY_FAILED,
+};
+
+/// @brief 单个转换任务的结果。
+struct ConvertResult {
+    ConvertJob    job;
+    ConvertStatus status{ ConvertStatus::SKIPPED };
+
+    /// @brief 加载、保存与校验（重新加载加比较）的耗时，单位毫秒。
+    double loadMs{ 0.0 };
+    double saveMs{ 0.0 };
+    double verifyMs{ 0.0 };
+
+    /// @brief 源谱面的顶层物件数。
+    std::size_t noteCount{ 0 };
+
+    /// @brief 加载源谱面产生的结构化诊断。
+    std::vector<BeatmapLoadDiagnostic> diagnostics;
+
+    /// @brief 失败、跳过或校验不一致的说明。
+    std::string message;
+};
+
+/// @brief 一次批量转换的汇总。
+struct BatchConvertSummary {
+    std::size_t converted{ 0 };
+    std::size_t skipped{ 0 };
+    std::size_t failed{ 0 };
+
+    /// @brief 整批墙钟耗时，单位毫秒。
+    double wallMs{ 0.0 };
+
+    /// @brief 按任务顺序排列的全部结果。
+    std::vector<ConvertResult> results;
+};
+
+/// @brief 支持的谱面格式扩展名。
+[[nodiscard]] const std::vector<std::string>& supportedBeatmapExtensions();
+
+/// @brief 状态的稳定英文名称，用于报告输出。
+[[nodiscard]] std::string_view convertStatusName(ConvertStatus status);
+
+/**
+ * @brief 展开输入并生成按路径排序的转换任务。
+ * @details 不存在的输入与不支持的单个文件被忽略并记录警告；多个源文件
+ * 映射到同一输出时，后出现的任务标记 conflictsWith。
+ */
+[[nodiscard]] std::vector<ConvertJob> collectConvertJobs(
+    const BatchConvertOptions& options);
+
+/**
+ * @brief 比较源谱面与转换后重新加载的谱面。
+ * @details 比较轨道数、BPM 时间点以及按 (时间戳, 轨道, 类型) 排序的顶层
+ * 物件；时间允许 1ms 误差，以容纳 osu! 与 imd 的整数毫秒取整。
+ * @return 一致时为空，否则为首个差异的说明。
+ */
+[[nodiscard]] std::string compareConvertedBeatMap(const BeatMap& source,
+                                                  const BeatMap& converted);
+
+/// @brief 执行单个转换任务：加载、保存，并按需校验。
+[[nodiscard]] ConvertResult convertBeatmap(const ConvertJob&          job,
+                                           const BatchConvertOptions& options);
+
+/**
+ * @brief 并行执行全部任务。
+ * @param options 转换参数。
+ * @param onResult 每完成一个任务调用一次；调用被串行化，可直接输出报告。
+ * @return 汇总与按任务顺序排列的结果。
+ */
+BatchConvertSummary runBatchConvert(
+    const BatchConvertOptions&                       options,
+    const std::function<void(const ConvertResult&)>& onResult = {});
+
+}  // namespace MMM::Convert
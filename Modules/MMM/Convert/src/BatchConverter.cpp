@@ -0,0 +1,452 @@
+#include "mmm/convert/BatchConverter.h"
+
+#include "config/Utf8Path.h"
+#include "log/colorful-log.h"
+#include <algorithm>
+#include <atomic>
+#include <cctype>
+#include <chrono>
+#include <cmath>
+#include <exception>
+#include <fmt/format.h>
+#include <iterator>
+#include <map>
+#include <mutex>
+#include <thread>
+#include <unordered_set>
+#include <utility>
+
+namespace MMM::Convert
+{
+namespace
+{
+
+using Clock = std::chrono::steady_clock;
+
+double elapsedMs(Clock::time_point begin)
+{
+    return std::chrono::duration<double, std::milli>(Clock::now() - begin)
+        .count();
+}
+
+/// @brief 校验允许的时间误差（毫秒），容纳整数毫秒格式的取整。
+constexpr double TIME_TOLERANCE_MS = 1.0;
+
+/// @brief 校验允许的 BPM 相对误差。
+constexpr double BPM_RELATIVE_TOLERANCE = 1e-6;
+
+/// @brief 小写并补齐前导点号的扩展名。
+std::string normalizeExtension(std::string_view extension)
+{
+    std::string normalized;
+    if ( !extension.starts_with('.') ) normalized += '.';
+    for ( const char c : extension ) {
+        normalized += static_cast<char>(
+            std::tolower(static_cast<unsigned char>(c)));
+    }
+    return normalized;
+}
+
+/// @brief 文件扩展名的小写形式。
+std::string extensionOf(const std::filesystem::path& path)
+{
+    return normalizeExtension(Config::pathToUtf8(path.extension()));
+}
+
+/// @brief 源路径映射到目标格式后的输出路径。
+std::filesystem::path outputPathFor(const std::filesystem::path& source,
+                                    const std::filesystem::path& relative,
+                                    const BatchConvertOptions&   options,
+                                    const std::string&           target)
+{
+    std::filesystem::path output = options.outputDirectory.empty()
+                                       ? source
+                                       : options.outputDirectory / relative;
+    output.replace_extension(std::filesystem::path(target));
+    return output;
+}
+
+/// @brief 按 BPM 时间点的时间排序。
+std::vector<const Timing*> bpmTimingsOf(const BeatMap& beatMap)
+{
+    std::vector<const Timing*> timings;
+    for ( const auto& timing : beatMap.m_timings ) {
+        if ( timing.m_timingEffect == TimingEffect::BPM ) {
+            timings.push_back(&timing);
+        }
+    }
+    std::stable_sort(timings.begin(),
+                     timings.end(),
+                     [](const Timing* lhs, const Timing* rhs) {
+                         return lhs->m_timestamp < rhs->m_timestamp;
+                     });
+    return timings;
+}
+
+/// @brief 按 m_allNotes 顺序排列的顶层物件，不含折线子物件。
+/// @details 各加载器对子物件是否进入 m_allNotes 的处理不同，只比较顶层
+/// 物件才能在格式之间对齐。
+std::vector<const Note*> topLevelNotesOf(const BeatMap& beatMap)
+{
+    std::unordered_set<const Note*> subNotes;
+    for ( const auto& polyline : beatMap.m_noteData.polylines ) {
+        for ( const auto& subNote : polyline.m_subNotes ) {
+            subNotes.insert(&subNote.get());
+        }
+    }
+
+    std::vector<const Note*> notes;
+    notes.reserve(beatMap.m_allNotes.size());
+    for ( const auto& note : beatMap.m_allNotes ) {
+        if ( !note.get().m_isSubNote && !subNotes.contains(&note.get()) ) {
+            notes.push_back(&note.get());
+        }
+    }
+    return notes;
+}
+
+bool timeDiffers(double lhs, double rhs)
+{
+    return !(std::abs(lhs - rhs) <= TIME_TOLERANCE_MS);
+}
+
+std::string_view noteTypeName(NoteType type)
+{
+    switch ( type ) {
+    case NoteType::NOTE: return "note";
+    case NoteType::HOLD: return "hold";
+    case NoteType::FLICK: return "flick";
+    case NoteType::POLYLINE: return "polyline";
+    }
+    return "unknown";
+}
+
+}  // namespace
+
+const std::vector<std::string>& supportedBeatmapExtensions()
+{
+    static const std::vector<std::string> extensions{
+        ".osu", ".mc", ".imd", ".mmm"
+    };
+    return extensions;
+}
+
+std::string_view convertStatusName(ConvertStatus status)
+{
+    switch ( status ) {
+    case ConvertStatus::CONVERTED: return "OK";
+    case ConvertStatus::SKIPPED: return "SKIP";
+    case ConvertStatus::LOAD_FAILED: return "LOAD-FAIL";
+    case ConvertStatus::SAVE_FAILED: return "SAVE-FAIL";
+    case ConvertStatus::VERIFY_FAILED: return "VERIFY-FAIL";
+    }
+    return "UNKNOWN";
+}
+
+std::vector<ConvertJob> collectConvertJobs(const BatchConvertOptions& options)
+{
+    const std::string target = normalizeExtension(options.targetExtension);
+    const auto&       supported = supportedBeatmapExtensions();
+
+    std::vector<std::string> sources;
+    if ( options.sourceExtensions.empty() ) {
+        std::copy_if(supported.begin(),
+                     supported.end(),
+                     std::back_inserter(sources),
+                     [&target](const std::string& extension) {
+                         return extension != target;
+                     });
+    } else {
+        for ( const auto& extension : options.sourceExtensions ) {
+            sources.push_back(normalizeExtension(extension));
+        }
+    }
+    const auto isSource = [&sources](const std::filesystem::path& path) {
+        return std::find(sources.begin(), sources.end(), extensionOf(path)) !=
+               sources.end();
+    };
+
+    std::vector<ConvertJob> jobs;
+    for ( const auto& input : options.inputs ) {
+        std::error_code ec;
+        if ( std::filesystem::is_directory(input, ec) ) {
+            const auto addEntry =
+                [&](const std::filesystem::directory_entry& entry) {
+                    std::error_code entryError;
+                    if ( !entry.is_regular_file(entryError) ||
+                         !isSource(entry.path()) ) {
+                        return;
+                    }
+                    jobs.push_back(
+                        { entry.path(),
+                          outputPathFor(entry.path(),
+                                        entry.path().lexically_relative(input),
+                                        options,
+                                        target),
+                          {} });
+                };
+            const auto directoryOptions =
+                std::filesystem::directory_options::skip_permission_denied;
+            if ( options.recursive ) {
+                for ( const auto& entry :
+                      std::filesystem::recursive_directory_iterator(
+                          input, directoryOptions, ec) ) {
+                    addEntry(entry);
+                }
+            } else {
+                for ( const auto& entry : std::filesystem::directory_iterator(
+                          input, directoryOptions, ec) ) {
+                    addEntry(entry);
+                }
+            }
+        } else if ( std::filesystem::is_regular_file(input, ec) ) {
+            const std::string extension = extensionOf(input);
+            if ( std::find(supported.begin(), supported.end(), extension) ==
+                 supported.end() ) {
+                XWARN("Skipping unsupported beatmap file: {}",
+                      Config::pathToUtf8(input));
+                continue;
+            }
+            jobs.push_back(
+                { input,
+                  outputPathFor(input, input.filename(), options, target),
+                  {} });
+        } else {
+            XWARN("Input does not exist: {}", Config::pathToUtf8(input));
+        }
+    }
+
+    std::sort(jobs.begin(),
+              jobs.end(),
+              [](const ConvertJob& lhs, const ConvertJob& rhs) {
+                  return lhs.source < rhs.source;
+              });
+    jobs.erase(std::unique(jobs.begin(),
+                           jobs.end(),
+                           [](const ConvertJob& lhs, const ConvertJob& rhs) {
+                               return lhs.source == rhs.source;
+                           }),
+               jobs.end());
+
+    // 同名不同格式的源文件会映射到同一输出；只转换第一个，其余报告冲突。
+    std::map<std::filesystem::path, std::filesystem::path> claimedOutputs;
+    for ( auto& job : jobs ) {
+        const auto output = job.output.lexically_normal();
+        if ( output == job.source.lexically_normal() ) {
+            job.conflictsWith = job.source;
+            continue;
+        }
+        const auto [claimed, inserted] =
+            claimedOutputs.emplace(output, job.source);
+        if ( !inserted ) job.conflictsWith = claimed->second;
+    }
+    return jobs;
+}
+
+std::string compareConvertedBeatMap(const BeatMap& source,
+                                    const BeatMap& converted)
+{
+    if ( source.m_baseMapMetadata.track_count !=
+         converted.m_baseMapMetadata.track_count ) {
+        return fmt::format("track count {} became {}",
+                           source.m_baseMapMetadata.track_count,
+                           converted.m_baseMapMetadata.track_count);
+    }
+
+    const auto sourceBpms    = bpmTimingsOf(source);
+    const auto convertedBpms = bpmTimingsOf(converted);
+    if ( sourceBpms.size() != convertedBpms.size() ) {
+        return fmt::format("BPM timing count {} became {}",
+                           sourceBpms.size(),
+                           convertedBpms.size());
+    }
+    for ( std::size_t i = 0; i < sourceBpms.size(); ++i ) {
+        const Timing& lhs = *sourceBpms[i];
+        const Timing& rhs = *convertedBpms[i];
+        if ( timeDiffers(lhs.m_timestamp, rhs.m_timestamp) ||
+             !(std::abs(lhs.m_bpm - rhs.m_bpm) <=
+               BPM_RELATIVE_TOLERANCE * std::abs(lhs.m_bpm)) ) {
+            return fmt::format("BPM timing #{} {}ms@{} became {}ms@{}",
+                               i,
+                               lhs.m_timestamp,
+                               lhs.m_bpm,
+                               rhs.m_timestamp,
+                               rhs.m_bpm);
+        }
+    }
+
+    const auto sourceNotes    = topLevelNotesOf(source);
+    const auto convertedNotes = topLevelNotesOf(converted);
+    if ( sourceNotes.size() != convertedNotes.size() ) {
+        return fmt::format("note count {} became {}",
+                           sourceNotes.size(),
+                           convertedNotes.size());
+    }
+    for ( std::size_t i = 0; i < sourceNotes.size(); ++i ) {
+        const Note& lhs      = *sourceNotes[i];
+        const Note& rhs      = *convertedNotes[i];
+        const auto  describe = [&](std::string_view what) {
+            return fmt::format("note #{} ({} at {}ms, track {}): {} differs",
+                               i,
+                               noteTypeName(lhs.m_type),
+                               lhs.m_timestamp,
+                               lhs.m_track,
+                               what);
+        };
+        if ( lhs.m_type != rhs.m_type ) return describe("type");
+        if ( lhs.m_track != rhs.m_track ) return describe("track");
+        if ( timeDiffers(lhs.m_timestamp, rhs.m_timestamp) ) {
+            return describe("timestamp");
+        }
+        switch ( lhs.m_type ) {
+        case NoteType::HOLD:
+            if ( timeDiffers(static_cast<const Hold&>(lhs).m_duration,
+                             static_cast<const Hold&>(rhs).m_duration) ) {
+                return describe("duration");
+            }
+            break;
+        case NoteType::FLICK:
+            if ( static_cast<const Flick&>(lhs).m_dtrack !=
+                 static_cast<const Flick&>(rhs).m_dtrack ) {
+                return describe("flick direction");
+            }
+            break;
+        case NoteType::POLYLINE:
+            if ( static_cast<const Polyline&>(lhs).m_subNotes.size() !=
+                 static_cast<const Polyline&>(rhs).m_subNotes.size() ) {
+                return describe("segment count");
+            }
+            break;
+        case NoteType::NOTE: break;
+        }
+    }
+    return {};
+}
+
+ConvertResult convertBeatmap(const ConvertJob&          job,
+                             const BatchConvertOptions& options)
+{
+    ConvertResult result;
+    result.job = job;
+
+    if ( !job.conflictsWith.empty() ) {
+        result.status  = ConvertStatus::SKIPPED;
+        result.message = job.conflictsWith == job.source
+                             ? std::string("output would replace the source")
+                             : fmt::format("output is already produced from {}",
+                                           Config::pathToUtf8(job.conflictsWith));
+        return result;
+    }
+    std::error_code ec;
+    if ( !options.overwrite && std::filesystem::exists(job.output, ec) ) {
+        result.status  = ConvertStatus::SKIPPED;
+        result.message = "output exists (use --overwrite)";
+        return result;
+    }
+
+    BeatMap    source;
+    const auto loadBegin = Clock::now();
+    try {
+        source = BeatMap::loadFromFile(job.source);
+    } catch ( const std::exception& error ) {
+        result.loadMs  = elapsedMs(loadBegin);
+        result.status  = ConvertStatus::LOAD_FAILED;
+        result.message = error.what();
+        return result;
+    }
+    result.loadMs      = elapsedMs(loadBegin);
+    result.noteCount   = topLevelNotesOf(source).size();
+    result.diagnostics = source.m_loadDiagnostics;
+    // 加载器在无法解析时返回空谱面，没有任何物件与时间点即视为失败。
+    if ( source.m_allNotes.empty() && source.m_timings.empty() ) {
+        result.status  = ConvertStatus::LOAD_FAILED;
+        result.message = "no notes or timing points were loaded";
+        return result;
+    }
+
+    std::filesystem::create_directories(job.output.parent_path(), ec);
+    const auto saveBegin = Clock::now();
+    bool       saved     = false;
+    try {
+        saved = source.saveToFile(job.output);
+    } catch ( const std::exception& error ) {
+        result.message = error.what();
+    }
+    result.saveMs = elapsedMs(saveBegin);
+    if ( !saved ) {
+        result.status = ConvertStatus::SAVE_FAILED;
+        if ( result.message.empty() ) {
+            result.message = "the target format cannot represent this beatmap";
+        }
+        return result;
+    }
+
+    if ( options.verify ) {
+        const auto verifyBegin = Clock::now();
+        try {
+            const BeatMap converted = BeatMap::loadFromFile(job.output);
+            result.message = compareConvertedBeatMap(source, converted);
+        } catch ( const std::exception& error ) {
+            result.message = fmt::format("reload failed: {}", error.what());
+        }
+        result.verifyMs = elapsedMs(verifyBegin);
+        if ( !result.message.empty() ) {
+            result.status = ConvertStatus::VERIFY_FAILED;
+            return result;
+        }
+    }
+
+    result.status = ConvertStatus::CONVERTED;
+    return result;
+}
+
+BatchConvertSummary runBatchConvert(
+    const BatchConvertOptions&                       options,
+    const std::function<void(const ConvertResult&)>& onResult)
+{
+    const auto wallBegin = Clock::now();
+    const auto jobs      = collectConvertJobs(options);
+
+    BatchConvertSummary summary;
+    summary.results.resize(jobs.size());
+
+    std::size_t workerCount = options.jobs;
+    if ( workerCount == 0 ) {
+        workerCount = std::max(1U, std::thread::hardware_concurrency());
+    }
+    workerCount = std::min(workerCount, std::max<std::size_t>(1, jobs.size()));
+
+    std::atomic<std::size_t> next{ 0 };
+    std::mutex               reportMutex;
+    const auto               work = [&]() {
+        for ( std::size_t index = next.fetch_add(1); index < jobs.size();
+              index             = next.fetch_add(1) ) {
+            ConvertResult result = convertBeatmap(jobs[index], options);
+            std::lock_guard<std::mutex> lock(reportMutex);
+            if ( onResult ) onResult(result);
+            summary.results[index] = std::move(result);
+        }
+    };
+
+    if ( !jobs.empty() ) {
+        std::vector<std::thread> workers;
+        workers.reserve(workerCount - 1);
+        for ( std::size_t i = 1; i < workerCount; ++i ) {
+            workers.emplace_back(work);
+        }
+        work();
+        for ( auto& worker : workers ) worker.join();
+    }
+
+    for ( const auto& result : summary.results ) {
+        switch ( result.status ) {
+        case ConvertStatus::CONVERTED: ++summary.converted; break;
+        case ConvertStatus::SKIPPED: ++summary.skipped; break;
+        default: ++summary.failed; break;
+        }
+    }
+    summary.wallMs = elapsedMs(wallBegin);
+    return summary;
+}
+
+}  // namespace MMM::Convert
@@ -0,0 +1,141 @@
+#include "mmm/convert/BatchConverter.h"
+
+#include "config/Utf8Path.h"
+#include "log/colorful-log.h"
+#include <algorithm>
+#include <charconv>
+#include <cstddef>
+#include <cstdio>
+#include <fmt/format.h>
+#include <string>
+#include <string_view>
+
+namespace
+{
+
+constexpr std::string_view USAGE =
+    "Usage: mmm-convert [options] <input>...\n"
+    "\n"
+    "Converts beatmap files, or every beatmap below input directories, to\n"
+    "another format using the editor's own loaders and savers.\n"
+    "\n"
+    "Options:\n"
+    "  -t, --to <format>      target format: mmm, osu, mc or imd (default mmm)\n"
+    "  -f, --from <format>    source format picked from directories; may be\n"
+    "                         repeated (default: every format but the target)\n"
+    "  -o, --output <dir>     output root; directory inputs keep their\n"
+    "                         relative layout (default: next to each source)\n"
+    "  -j, --jobs <n>         parallel conversions (default: hardware threads)\n"
+    "      --no-recursive     do not descend into subdirectories\n"
+    "      --overwrite        replace existing output files\n"
+    "      --verify           reload each output and compare it to the source\n"
+    "  -v, --verbose          keep the loaders' and savers' info logging\n"
+    "  -h, --help             show this help\n";
+
+/// @brief 输出单个任务的结果行与诊断。
+void printResult(const MMM::Convert::ConvertResult& result)
+{
+    using MMM::Config::pathToUtf8;
+    fmt::print("[{:<11}] {} -> {}  notes={} load={:.1f}ms save={:.1f}ms",
+               MMM::Convert::convertStatusName(result.status),
+               pathToUtf8(result.job.source),
+               pathToUtf8(result.job.output),
+               result.noteCount,
+               result.loadMs,
+               result.saveMs);
+    if ( result.verifyMs > 0.0 ) {
+        fmt::print(" verify={:.1f}ms", result.verifyMs);
+    }
+    fmt::print("\n");
+    if ( !result.message.empty() ) {
+        fmt::print("              {}\n", result.message);
+    }
+    for ( const auto& diagnostic : result.diagnostics ) {
+        fmt::print("              diagnostic: {}\n", diagnostic.m_message);
+    }
+    std::fflush(stdout);
+}
+
+}  // namespace
+
+int main(int argc, char** argv)
+{
+    XLogger::init("mmm-convert");
+
+    MMM::Convert::BatchConvertOptions options;
+    bool                              verbose = false;
+    for ( int index = 1; index < argc; ++index ) {
+        const std::string_view argument = argv[index] ? argv[index] : "";
+        const auto             value    = [&]() -> const char* {
+            return index + 1 < argc ? argv[++index] : nullptr;
+        };
+
+        if ( argument == "-h" || argument == "--help" ) {
+            fmt::print("{}", USAGE);
+            XLogger::shutdown();
+            return 0;
+        }
+        if ( argument == "-t" || argument == "--to" ) {
+            const char* format = value();
+            if ( !format ) break;
+            options.targetExtension = format;
+        } else if ( argument == "-f" || argument == "--from" ) {
+            const char* format = value();
+            if ( !format ) break;
+            options.sourceExtensions.emplace_back(format);
+        } else if ( argument == "-o" || argument == "--output" ) {
+            const char* directory = value();
+            if ( !directory ) break;
+            options.outputDirectory = MMM::Config::utf8ToPath(directory);
+        } else if ( argument == "-j" || argument == "--jobs" ) {
+            const char* jobs = value();
+            if ( !jobs ) break;
+            const std::string_view text(jobs);
+            std::from_chars(text.data(), text.data() + text.size(), options.jobs);
+        } else if ( argument == "--no-recursive" ) {
+            options.recursive = false;
+        } else if ( argument == "--overwrite" ) {
+            options.overwrite = true;
+        } else if ( argument == "--verify" ) {
+            options.verify = true;
+        } else if ( argument == "-v" || argument == "--verbose" ) {
+            verbose = true;
+        } else if ( argument.starts_with('-') ) {
+            XERROR("Unknown option: {}", argument);
+            fmt::print(stderr, "{}", USAGE);
+            XLogger::shutdown();
+            return 2;
+        } else {
+            options.inputs.push_back(MMM::Config::utf8ToPath(std::string(argument)));
+        }
+    }
+    if ( options.inputs.empty() ) {
+        fmt::print(stderr, "{}", USAGE);
+        XLogger::shutdown();
+        return 2;
+    }
+
+    const auto& supported = MMM::Convert::supportedBeatmapExtensions();
+    std::string target    = options.targetExtension;
+    if ( !target.starts_with('.') ) target.insert(target.begin(), '.');
+    if ( std::find(supported.begin(), supported.end(), target) ==
+         supported.end() ) {
+        XERROR("Unsupported target format: {}", options.targetExtension);
+        XLogger::shutdown();
+        return 2;
+    }
+    options.targetExtension = target;
+
+    // 加载器与保存器每个文件都会输出 info 日志，批量运行时默认只保留警告。
+    if ( !verbose ) XLogger::setlevel(spdlog::level::warn);
+
+    const auto summary = MMM::Convert::runBatchConvert(options, &printResult);
+    fmt::print("\n{} converted, {} skipped, {} failed in {:.1f}ms\n",
+               summary.converted,
+               summary.skipped,
+               summary.failed,
+               summary.wallMs);
+
+    XLogger::shutdown();
+    return summary.failed == 0 ? 0 : 1;
+}
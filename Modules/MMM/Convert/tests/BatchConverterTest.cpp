@@ -0,0 +1,139 @@
+#include "log/colorful-log.h"
+#include "mmm/convert/BatchConverter.h"
+
+#include <filesystem>
+#include <string>
+
+namespace
+{
+namespace fs = std::filesystem;
+
+using MMM::Convert::BatchConvertOptions;
+using MMM::Convert::ConvertStatus;
+
+/// @brief 把测试谱面全部转换为 .mmm 并回读校验，再次运行时应全部跳过。
+/// @return 转换、校验与跳过行为均正确时返回 true。
+bool testConvertDataDirectory(const fs::path& dataDirectory,
+                              const fs::path& outputDirectory)
+{
+    BatchConvertOptions options;
+    options.inputs          = { dataDirectory };
+    options.outputDirectory = outputDirectory / "mmm";
+    options.targetExtension = "mmm";
+    options.overwrite       = true;
+    options.verify          = true;
+    options.jobs            = 2;
+
+    const auto jobs = MMM::Convert::collectConvertJobs(options);
+    if ( jobs.empty() ) {
+        XERROR("No beatmaps were collected from {}", dataDirectory.string());
+        return false;
+    }
+
+    std::size_t reported = 0;
+    const auto  summary  = MMM::Convert::runBatchConvert(
+        options, [&reported](const MMM::Convert::ConvertResult&) {
+            ++reported;
+        });
+    if ( summary.results.size() != jobs.size() || reported != jobs.size() ) {
+        XERROR("Expected {} results, got {} ({} reported)",
+               jobs.size(),
+               summary.results.size(),
+               reported);
+        return false;
+    }
+    for ( const auto& result : summary.results ) {
+        if ( result.status != ConvertStatus::CONVERTED ) {
+            XERROR("{} was not converted: {} {}",
+                   result.job.source.string(),
+                   MMM::Convert::convertStatusName(result.status),
+                   result.message);
+            return false;
+        }
+        if ( result.job.output.extension() != ".mmm" ||
+             !fs::exists(result.job.output) ) {
+            XERROR("Missing converted output {}", result.job.output.string());
+            return false;
+        }
+    }
+
+    options.overwrite     = false;
+    const auto rerun      = MMM::Convert::runBatchConvert(options);
+    if ( rerun.skipped != jobs.size() || rerun.converted != 0 ) {
+        XERROR("Existing outputs were not skipped: {} converted, {} skipped",
+               rerun.converted,
+               rerun.skipped);
+        return false;
+    }
+    return true;
+}
+
+/// @brief 同名不同格式的源文件只转换第一个，输出覆盖源文件的任务被拒绝。
+/// @return 冲突标记与跳过结果正确时返回 true。
+bool testOutputConflicts(const fs::path& dataDirectory,
+                         const fs::path& outputDirectory)
+{
+    const fs::path conflictDirectory = outputDirectory / "conflict";
+    fs::remove_all(conflictDirectory);
+    fs::create_directories(conflictDirectory);
+    fs::copy_file(dataDirectory / "[General]Unsan-musho.mc",
+                  conflictDirectory / "chart.mc");
+    fs::copy_file(dataDirectory / "[General]Scandal.osu",
+                  conflictDirectory / "chart.osu");
+
+    BatchConvertOptions options;
+    options.inputs          = { conflictDirectory };
+    options.targetExtension = ".mmm";
+
+    const auto summary = MMM::Convert::runBatchConvert(options);
+    if ( summary.results.size() != 2 || summary.converted != 1 ||
+         summary.skipped != 1 ) {
+        XERROR("Conflicting outputs were not detected: {} converted, {} "
+               "skipped",
+               summary.converted,
+               summary.skipped);
+        return false;
+    }
+    const auto& conflicting = summary.results[1];
+    if ( conflicting.job.source.filename() != "chart.osu" ||
+         conflicting.job.conflictsWith.filename() != "chart.mc" ) {
+        XERROR("Unexpected conflict: {} conflicts with {}",
+               conflicting.job.source.string(),
+               conflicting.job.conflictsWith.string());
+        return false;
+    }
+
+    options.sourceExtensions = { "osu" };
+    options.targetExtension  = "osu";
+    const auto inPlace       = MMM::Convert::runBatchConvert(options);
+    if ( inPlace.results.size() != 1 ||
+         inPlace.results[0].status != ConvertStatus::SKIPPED ) {
+        XERROR("Converting a file onto itself was not rejected");
+        return false;
+    }
+    return true;
+}
+
+}  // namespace
+
+int main(int argc, char** argv)
+{
+    if ( argc < 3 ) {
+        XERROR("Usage: BatchConverterTest <data_directory> <output_directory>");
+        return 1;
+    }
+
+    const fs::path  dataDirectory   = argv[1];
+    const fs::path  outputDirectory = argv[2];
+    std::error_code filesystemError;
+    fs::create_directories(outputDirectory, filesystemError);
+    if ( filesystemError ) {
+        XERROR("Failed to create batch convert test output directory");
+        return 1;
+    }
+
+    return testConvertDataDirectory(dataDirectory, outputDirectory) &&
+                   testOutputConflicts(dataDirectory, outputDirectory)
+               ? 0
+               : 1;
+}
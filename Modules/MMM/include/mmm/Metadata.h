@@ -1,9 +1,24 @@
 #pragma once
 
+#include "mmm/SafeParse.h"
+#include <array>
+#include <atomic>
+#include <cctype>
+#include <charconv>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
 #include <filesystem>
+#include <iterator>
+#include <memory>
 #include <sstream>
+#include <stdexcept>
 #include <string>
+#include <string_view>
+#include <type_traits>
 #include <unordered_map>
+#include <utility>
+#include <vector>
 
 namespace MMM
 {
@@ -24,6 +39,635 @@ struct StringHash {
     }
 };
 
+namespace Internal
+{
+
+/// @brief 驻留键记录；地址在进程生命周期内保持稳定。
+struct MetadataKeyRecord {
+    /// @brief 键文本。
+    std::string name;
+    /// @brief 驻留序号；空键为 0。
+    uint32_t id{ 0 };
+};
+
+/// @brief 空键记录，默认构造的 MetadataKey 指向它。
+extern const MetadataKeyRecord EMPTY_METADATA_KEY;
+
+/// @brief 数值缓存类型标签；非数值类型返回 0 表示不缓存。
+template<typename T> constexpr uint8_t metadataCacheTag()
+{
+    if constexpr ( !std::is_arithmetic_v<T> || sizeof(T) > sizeof(uint64_t) ||
+                   std::is_same_v<T, char> || std::is_same_v<T, signed char> ||
+                   std::is_same_v<T, unsigned char> ||
+                   std::is_same_v<T, char8_t> ||
+                   std::is_same_v<T, char16_t> ||
+                   std::is_same_v<T, char32_t> ||
+                   std::is_same_v<T, wchar_t> ) {
+        return 0;
+    } else {
+        return static_cast<uint8_t>((std::is_floating_point_v<T> ? 0x40U : 0) |
+                                    (std::is_signed_v<T> ? 0x20U : 0) |
+                                    (std::is_same_v<T, bool> ? 0x10U : 0) |
+                                    sizeof(T));
+    }
+}
+
+/**
+ * @brief 文本是否以数字或负号加数字开头，即可以走 from_chars 快速路径。
+ * @param text 属性文本。
+ * @param allowMinus 是否接受负号。
+ */
+inline bool isPlainNumberStart(std::string_view text, bool allowMinus)
+{
+    if ( allowMinus && text.size() > 1 && text.front() == '-' ) {
+        text.remove_prefix(1);
+    }
+    return !text.empty() &&
+           std::isdigit(static_cast<unsigned char>(text.front())) != 0;
+}
+
+/**
+ * @brief 按旧版 istringstream 语义解析元数据文本。
+ *
+ * 纯十进制整数与浮点文本走 from_chars 快速路径；前导空白、正号、尾随字符、
+ * 溢出等边界情况回落到 istringstream，保证结果与原实现逐位一致。
+ * @param text 属性文本。
+ * @param value 输出值；失败时与 istringstream 写入的值相同。
+ * @return istringstream 提取是否成功。
+ */
+template<typename T> bool parseMetadataValue(const std::string& text, T& value)
+{
+    if constexpr ( std::is_integral_v<T> && !std::is_same_v<T, bool> &&
+                   metadataCacheTag<T>() != 0 ) {
+        if ( isPlainNumberStart(text, std::is_signed_v<T>) ) {
+            const auto result = std::from_chars(
+                text.data(), text.data() + text.size(), value);
+            if ( result.ec == std::errc{} &&
+                 result.ptr == text.data() + text.size() ) {
+                return true;
+            }
+        }
+    } else if constexpr ( std::is_same_v<T, double> ) {
+        if ( isPlainNumberStart(text, true) ) {
+            const auto result = parseFloatingPrefix(text);
+            if ( result.error == std::errc{} &&
+                 result.parsedLength == text.size() ) {
+                value = result.value;
+                return true;
+            }
+        }
+    }
+    std::istringstream iss(text);
+    return static_cast<bool>(iss >> value);
+}
+
+}  // namespace Internal
+
+/**
+ * @brief 全局驻留的元数据属性键。
+ *
+ * 同名键在进程内只保存一份文本并分配一个小整数 id；属性条目只保存指向驻留
+ * 记录的指针，比较两个键只需比较指针。驻留表只增不减，适用于格式字段名这类
+ * 有限集合。
+ */
+class MetadataKey
+{
+public:
+    MetadataKey() = default;
+
+    /**
+     * @brief 驻留键文本，线程安全。
+     * @param name 键文本。
+     * @return 同名键始终返回同一驻留记录。
+     */
+    static MetadataKey intern(std::string_view name);
+
+    /// @brief 当前已驻留的键数量。
+    static std::size_t internedCount();
+
+    /// @brief 驻留序号；空键为 0。
+    [[nodiscard]] uint32_t id() const { return m_record->id; }
+
+    /// @brief 键文本。
+    [[nodiscard]] const std::string& name() const { return m_record->name; }
+
+    friend bool operator==(MetadataKey, MetadataKey) = default;
+
+private:
+    explicit MetadataKey(const Internal::MetadataKeyRecord* record)
+        : m_record(record)
+    {
+    }
+
+    const Internal::MetadataKeyRecord* m_record{
+        &Internal::EMPTY_METADATA_KEY
+    };
+};
+
+/**
+ * @brief 单条元数据属性：驻留键、原始文本值与数值解析缓存。
+ *
+ * 支持 `const auto& [key, value]` 结构化绑定，值成员沿用 std::pair 的
+ * `second` 命名以兼容 `it->second` 写法。数值缓存只在 const 读取时填充，
+ * 任何可写访问都会使其失效；并发 const 读取通过原子标签安全地共享缓存。
+ */
+class MetadataEntry
+{
+public:
+    MetadataEntry() = default;
+    MetadataEntry(MetadataKey key, std::string value)
+        : second(std::move(value)), m_key(key)
+    {
+    }
+    MetadataEntry(const MetadataEntry& other);
+    MetadataEntry(MetadataEntry&& other) noexcept;
+    MetadataEntry& operator=(const MetadataEntry& other);
+    MetadataEntry& operator=(MetadataEntry&& other) noexcept;
+    ~MetadataEntry() = default;
+
+    /// @brief 键文本。
+    [[nodiscard]] const std::string& key() const { return m_key.name(); }
+
+    /// @brief 驻留键句柄。
+    [[nodiscard]] MetadataKey keyHandle() const { return m_key; }
+
+    /// @brief 使数值缓存失效；可写访问路径在交出引用前调用。
+    void invalidateCache() { m_cacheTag.store(0, std::memory_order_relaxed); }
+
+    /**
+     * @brief 以旧版 istringstream 语义解析值，数值类型命中缓存时跳过解析。
+     * @param value 输出值。
+     * @return 解析是否成功。
+     */
+    template<typename T> bool parse(T& value) const
+    {
+        constexpr uint8_t tag = Internal::metadataCacheTag<T>();
+        if constexpr ( tag == 0 ) {
+            return Internal::parseMetadataValue(second, value);
+        } else {
+            const uint8_t cached = m_cacheTag.load(std::memory_order_acquire);
+            if ( (cached & ~CACHE_FAILED) == tag ) {
+                const uint64_t bits =
+                    m_cacheBits.load(std::memory_order_relaxed);
+                std::memcpy(&value, &bits, sizeof(T));
+                return (cached & CACHE_FAILED) == 0;
+            }
+
+            const bool ok = Internal::parseMetadataValue(second, value);
+            // 仅在缓存为空时抢占填充，避免不同类型的并发读取互相覆盖。
+            uint8_t expected = 0;
+            if ( m_cacheTag.compare_exchange_strong(
+                     expected, CACHE_BUSY, std::memory_order_acquire) ) {
+                uint64_t bits = 0;
+                std::memcpy(&bits, &value, sizeof(T));
+                m_cacheBits.store(bits, std::memory_order_relaxed);
+                m_cacheTag.store(ok ? tag : uint8_t(tag | CACHE_FAILED),
+                                 std::memory_order_release);
+            }
+            return ok;
+        }
+    }
+
+    /// @brief 结构化绑定访问：0 为键文本，1 为值。
+    template<std::size_t I> decltype(auto) get() const
+    {
+        static_assert(I < 2);
+        if constexpr ( I == 0 ) {
+            return key();
+        } else {
+            return (second);
+        }
+    }
+
+    /// @brief 结构化绑定访问：0 为只读键文本，1 为可写值。
+    template<std::size_t I> decltype(auto) get()
+    {
+        static_assert(I < 2);
+        if constexpr ( I == 0 ) {
+            return key();
+        } else {
+            return (second);
+        }
+    }
+
+    /// @brief 属性文本值。
+    std::string second;
+
+private:
+    static constexpr uint8_t CACHE_FAILED = 0x80U;
+    static constexpr uint8_t CACHE_BUSY   = 0x7FU;
+
+    MetadataKey                   m_key;
+    mutable std::atomic<uint64_t> m_cacheBits{ 0 };
+    mutable std::atomic<uint8_t>  m_cacheTag{ 0 };
+};
+
+/**
+ * @brief 单一来源的元数据属性表。
+ *
+ * 不超过 INLINE_CAPACITY 条属性时直接存放在对象内部，不产生任何堆分配；
+ * 超出后整体迁移到溢出数组。接口与旧版
+ * `unordered_map<string, string, StringHash, equal_to<>>` 的常用子集一致，
+ * 迭代顺序为插入顺序，相等比较与顺序无关。与 vector 相同，插入与删除可能
+ * 使已取得的条目引用和迭代器失效。
+ */
+class MetadataProperties
+{
+public:
+    /// @brief 对象内联存放的属性条数。
+    static constexpr std::size_t INLINE_CAPACITY = 4;
+
+    using key_type    = std::string;
+    using mapped_type = std::string;
+    using value_type  = MetadataEntry;
+    using size_type   = std::size_t;
+
+    /// @brief 前向迭代器；可写迭代器解引用时使该条目的数值缓存失效。
+    template<bool Const> class Iterator
+    {
+    public:
+        using iterator_category = std::forward_iterator_tag;
+        using value_type        = MetadataEntry;
+        using difference_type   = std::ptrdiff_t;
+        using pointer =
+            std::conditional_t<Const, const MetadataEntry*, MetadataEntry*>;
+        using reference =
+            std::conditional_t<Const, const MetadataEntry&, MetadataEntry&>;
+
+        Iterator() = default;
+        explicit Iterator(pointer entry) : m_entry(entry) {}
+
+        /// @brief 可写迭代器到只读迭代器的隐式转换。
+        operator Iterator<true>() const { return Iterator<true>(m_entry); }
+
+        reference operator*() const
+        {
+            if constexpr ( !Const ) m_entry->invalidateCache();
+            return *m_entry;
+        }
+        pointer operator->() const { return &**this; }
+
+        Iterator& operator++()
+        {
+            ++m_entry;
+            return *this;
+        }
+        Iterator operator++(int)
+        {
+            Iterator copy = *this;
+            ++m_entry;
+            return copy;
+        }
+
+        friend bool operator==(const Iterator&, const Iterator&) = default;
+
+        /// @brief 底层条目指针，不触发缓存失效。
+        [[nodiscard]] pointer entry() const { return m_entry; }
+
+    private:
+        pointer m_entry{ nullptr };
+    };
+
+    using iterator       = Iterator<false>;
+    using const_iterator = Iterator<true>;
+
+    MetadataProperties()                                         = default;
+    MetadataProperties(const MetadataProperties& other)          = default;
+    MetadataProperties(MetadataProperties&& other) noexcept      = default;
+    MetadataProperties& operator=(const MetadataProperties&)     = default;
+    MetadataProperties& operator=(MetadataProperties&&) noexcept = default;
+    ~MetadataProperties()                                        = default;
+
+    [[nodiscard]] bool      empty() const { return m_size == 0; }
+    [[nodiscard]] size_type size() const { return m_size; }
+
+    iterator       begin() { return iterator(data()); }
+    iterator       end() { return iterator(data() + m_size); }
+    const_iterator begin() const { return const_iterator(data()); }
+    const_iterator end() const { return const_iterator(data() + m_size); }
+    const_iterator cbegin() const { return begin(); }
+    const_iterator cend() const { return end(); }
+
+    /// @brief 查找属性。
+    iterator find(std::string_view key) { return iterator(findEntry(key)); }
+    const_iterator find(std::string_view key) const
+    {
+        return const_iterator(findEntry(key));
+    }
+    iterator       find(MetadataKey key) { return iterator(findEntry(key)); }
+    const_iterator find(MetadataKey key) const
+    {
+        return const_iterator(findEntry(key));
+    }
+
+    [[nodiscard]] bool contains(std::string_view key) const
+    {
+        return findEntry(key) != data() + m_size;
+    }
+    [[nodiscard]] bool contains(MetadataKey key) const
+    {
+        return findEntry(key) != data() + m_size;
+    }
+
+    /// @brief 获取或插入属性值。
+    std::string& operator[](std::string_view key);
+    std::string& operator[](MetadataKey key);
+
+    /// @brief 获取已有属性值；不存在时抛出 std::out_of_range。
+    std::string&       at(std::string_view key);
+    const std::string& at(std::string_view key) const;
+
+    /**
+     * @brief 仅在键不存在时插入。
+     * @return 指向该键条目的迭代器，以及是否发生插入。
+     */
+    template<typename... Args>
+    std::pair<iterator, bool> try_emplace(std::string_view key,
+                                          Args&&... args)
+    {
+        if ( MetadataEntry* entry = findEntry(key); entry != data() + m_size ) {
+            return { iterator(entry), false };
+        }
+        MetadataEntry& entry = append(MetadataKey::intern(key));
+        entry.second         = std::string(std::forward<Args>(args)...);
+        return { iterator(&entry), true };
+    }
+
+    /// @brief 与 unordered_map::emplace 一致：键已存在时保持原值。
+    std::pair<iterator, bool> emplace(std::string_view key, std::string value)
+    {
+        return try_emplace(key, std::move(value));
+    }
+
+    /// @brief 删除属性。
+    /// @return 删除的条数。
+    size_type erase(std::string_view key);
+
+    /// @brief 删除迭代器指向的属性。
+    /// @return 被删除条目之后的迭代器。
+    iterator erase(const_iterator pos);
+
+    /// @brief 清空所有属性并释放溢出数组。
+    void clear();
+
+    /// @brief 估算属性表占用的堆字节数，不含对象本身。
+    [[nodiscard]] std::size_t heapBytes() const;
+
+    friend bool operator==(const MetadataProperties& lhs,
+                           const MetadataProperties& rhs);
+
+private:
+    MetadataEntry* data()
+    {
+        return m_spill.empty() ? m_inline.data() : m_spill.data();
+    }
+    const MetadataEntry* data() const
+    {
+        return m_spill.empty() ? m_inline.data() : m_spill.data();
+    }
+
+    MetadataEntry* findEntry(std::string_view key)
+    {
+        return const_cast<MetadataEntry*>(std::as_const(*this).findEntry(key));
+    }
+    const MetadataEntry* findEntry(std::string_view key) const
+    {
+        const MetadataEntry* first = data();
+        const MetadataEntry* last  = first + m_size;
+        for ( ; first != last; ++first ) {
+            if ( first->key() == key ) break;
+        }
+        return first;
+    }
+    MetadataEntry* findEntry(MetadataKey key)
+    {
+        return const_cast<MetadataEntry*>(std::as_const(*this).findEntry(key));
+    }
+    const MetadataEntry* findEntry(MetadataKey key) const
+    {
+        const MetadataEntry* first = data();
+        const MetadataEntry* last  = first + m_size;
+        for ( ; first != last; ++first ) {
+            if ( first->keyHandle() == key ) break;
+        }
+        return first;
+    }
+
+    /// @brief 追加一个空值条目，必要时迁移到溢出数组。
+    MetadataEntry& append(MetadataKey key);
+
+    /// @brief 内联条目；m_spill 非空时不再使用。
+    std::array<MetadataEntry, INLINE_CAPACITY> m_inline;
+    /// @brief 溢出条目。
+    std::vector<MetadataEntry> m_spill;
+    /// @brief 有效条目数。
+    uint32_t m_size{ 0 };
+};
+
+/**
+ * @brief 来源枚举到属性表的映射。
+ *
+ * 来源种类只有个位数，因此用单链表节点保存：空表只占一个指针且不分配，
+ * 每个来源一次分配；节点地址稳定，插入或删除其他来源不会使已取得的属性表
+ * 引用失效。接口与旧版 `unordered_map<Source, ...>` 的常用子集一致。
+ */
+template<typename Source> class MetadataTable
+{
+    struct Node;
+
+public:
+    using key_type    = Source;
+    using mapped_type = MetadataProperties;
+    using value_type  = std::pair<const Source, MetadataProperties>;
+    using size_type   = std::size_t;
+
+    /// @brief 前向迭代器。
+    template<bool Const> class Iterator
+    {
+    public:
+        using iterator_category = std::forward_iterator_tag;
+        using value_type        = MetadataTable::value_type;
+        using difference_type   = std::ptrdiff_t;
+        using pointer =
+            std::conditional_t<Const, const value_type*, value_type*>;
+        using reference =
+            std::conditional_t<Const, const value_type&, value_type&>;
+
+        Iterator() = default;
+        explicit Iterator(Node* node) : m_node(node) {}
+
+        operator Iterator<true>() const { return Iterator<true>(m_node); }
+
+        reference operator*() const { return m_node->value; }
+        pointer   operator->() const { return &m_node->value; }
+
+        Iterator& operator++()
+        {
+            m_node = m_node->next.get();
+            return *this;
+        }
+        Iterator operator++(int)
+        {
+            Iterator copy = *this;
+            m_node        = m_node->next.get();
+            return copy;
+        }
+
+        friend bool operator==(const Iterator&, const Iterator&) = default;
+
+    private:
+        friend class MetadataTable;
+        Node* m_node{ nullptr };
+    };
+
+    using iterator       = Iterator<false>;
+    using const_iterator = Iterator<true>;
+
+    MetadataTable() = default;
+    MetadataTable(const MetadataTable& other) { copyFrom(other); }
+    MetadataTable(MetadataTable&& other) noexcept = default;
+    MetadataTable& operator=(const MetadataTable& other)
+    {
+        if ( this != &other ) {
+            clear();
+            copyFrom(other);
+        }
+        return *this;
+    }
+    MetadataTable& operator=(MetadataTable&& other) noexcept = default;
+    ~MetadataTable()                                         = default;
+
+    [[nodiscard]] bool empty() const { return m_head == nullptr; }
+    [[nodiscard]] size_type size() const
+    {
+        size_type count = 0;
+        for ( Node* node = m_head.get(); node; node = node->next.get() ) {
+            ++count;
+        }
+        return count;
+    }
+
+    iterator       begin() { return iterator(m_head.get()); }
+    iterator       end() { return iterator(); }
+    const_iterator begin() const { return const_iterator(m_head.get()); }
+    const_iterator end() const { return const_iterator(); }
+
+    iterator       find(Source source) { return iterator(findNode(source)); }
+    const_iterator find(Source source) const
+    {
+        return const_iterator(findNode(source));
+    }
+
+    [[nodiscard]] bool contains(Source source) const
+    {
+        return findNode(source) != nullptr;
+    }
+
+    /// @brief 获取或插入来源属性表；新来源追加在末尾。
+    MetadataProperties& operator[](Source source)
+    {
+        if ( Node* node = findNode(source) ) return node->value.second;
+        return appendNode(source).value.second;
+    }
+
+    /// @brief 获取已有来源属性表；不存在时抛出 std::out_of_range。
+    MetadataProperties& at(Source source)
+    {
+        if ( Node* node = findNode(source) ) return node->value.second;
+        throw std::out_of_range("MetadataTable::at");
+    }
+    const MetadataProperties& at(Source source) const
+    {
+        if ( Node* node = findNode(source) ) return node->value.second;
+        throw std::out_of_range("MetadataTable::at");
+    }
+
+    /// @brief 删除来源。
+    /// @return 删除的条数。
+    size_type erase(Source source)
+    {
+        for ( auto* link = &m_head; *link; link = &(*link)->next ) {
+            if ( (*link)->value.first == source ) {
+                *link = std::move((*link)->next);
+                return 1;
+            }
+        }
+        return 0;
+    }
+
+    /// @brief 删除迭代器指向的来源。
+    /// @return 被删除来源之后的迭代器。
+    iterator erase(const_iterator pos)
+    {
+        for ( auto* link = &m_head; *link; link = &(*link)->next ) {
+            if ( link->get() == pos.m_node ) {
+                *link = std::move((*link)->next);
+                return iterator(link->get());
+            }
+        }
+        return end();
+    }
+
+    void clear() { m_head.reset(); }
+
+    /// @brief 估算占用的堆字节数，不含对象本身。
+    [[nodiscard]] std::size_t heapBytes() const
+    {
+        std::size_t bytes = 0;
+        for ( Node* node = m_head.get(); node; node = node->next.get() ) {
+            bytes += sizeof(Node) + node->value.second.heapBytes();
+        }
+        return bytes;
+    }
+
+    /// @brief 与来源顺序无关的相等比较。
+    friend bool operator==(const MetadataTable& lhs, const MetadataTable& rhs)
+    {
+        if ( lhs.size() != rhs.size() ) return false;
+        for ( const auto& [source, properties] : lhs ) {
+            const Node* other = rhs.findNode(source);
+            if ( other == nullptr || !(other->value.second == properties) ) {
+                return false;
+            }
+        }
+        return true;
+    }
+
+private:
+    struct Node {
+        value_type            value;
+        std::unique_ptr<Node> next;
+    };
+
+    Node* findNode(Source source) const
+    {
+        for ( Node* node = m_head.get(); node; node = node->next.get() ) {
+            if ( node->value.first == source ) return node;
+        }
+        return nullptr;
+    }
+
+    Node& appendNode(Source source)
+    {
+        auto* link = &m_head;
+        while ( *link ) link = &(*link)->next;
+        *link = std::make_unique<Node>(
+            Node{ value_type{ source, MetadataProperties{} }, nullptr });
+        return **link;
+    }
+
+    void copyFrom(const MetadataTable& other)
+    {
+        auto* link = &m_head;
+        for ( const auto& value : other ) {
+            *link = std::make_unique<Node>(Node{ value, nullptr });
+            link  = &(*link)->next;
+        }
+    }
+
+    std::unique_ptr<Node> m_head;
+};
+
 enum class MapMetadataType {
     OSU,
     MALODY,
@@ -39,15 +683,12 @@ public:
     virtual ~MapMetadata() = default;
 
     // 统一通用属性表(来源-[属性名-属性值])
-    std::unordered_map<MapMetadataType,
-                       std::unordered_map<std::string, std::string, StringHash,
-                                          std::equal_to<>>>
-        map_properties;
+    MetadataTable<MapMetadataType> map_properties;
 
     // 获取数据
     template<typename T>
     T get_value(MapMetadataType source, const std::string& key,
-                T default_value = T())
+                T default_value = T()) const
     {
         auto properties_it = map_properties.find(source);
         if ( properties_it == map_properties.end() ) return default_value;
@@ -57,9 +698,8 @@ public:
             // 类型为字符串时整个返回
             return key_it->second;
         } else {
-            std::istringstream iss(key_it->second);
-            T                  value;
-            iss >> value;
+            T value{};
+            key_it->parse(value);
             return value;
         }
     }
@@ -132,15 +772,12 @@ public:
     virtual ~NoteMetadata() = default;
 
     // 统一通用属性表(来源-[属性名-属性值])
-    std::unordered_map<NoteMetadataType,
-                       std::unordered_map<std::string, std::string, StringHash,
-                                          std::equal_to<>>>
-        note_properties;
+    MetadataTable<NoteMetadataType> note_properties;
 
     // 获取数据
     template<typename T>
     T get_value(NoteMetadataType source, const std::string& key,
-                T default_value = T())
+                T default_value = T()) const
     {
         auto properties_it = note_properties.find(source);
         if ( properties_it == note_properties.end() ) return default_value;
@@ -150,9 +787,8 @@ public:
             // 类型为字符串时整个返回
             return key_it->second;
         } else {
-            std::istringstream iss(key_it->second);
-            T                  value;
-            iss >> value;
+            T value{};
+            key_it->parse(value);
             return value;
         }
     }
@@ -175,10 +811,7 @@ public:
     // 元数据类型
 
     // 属性表
-    std::unordered_map<TimingMetadataType,
-                       std::unordered_map<std::string, std::string, StringHash,
-                                          std::equal_to<>>>
-        timing_properties;
+    MetadataTable<TimingMetadataType> timing_properties;
 
     /**
      * @brief 获取数据
@@ -188,7 +821,7 @@ public:
      */
     template<typename T>
     T get_value(TimingMetadataType source, const std::string& key,
-                T default_value = T())
+                T default_value = T()) const
     {
         // 1. 先查找来源 (OSU 或 MALODY)
         auto properties_it = timing_properties.find(source);
@@ -203,13 +836,23 @@ public:
             // 如果目标类型就是 string，直接返回
             return key_it->second;
         } else {
-            // 使用 istringstream 进行类型转换 (int, float, double 等)
-            std::istringstream iss(key_it->second);
-            T                  value;
+            // 按 istringstream 语义转换 (int, float, double 等)，数值命中缓存
+            T value{};
             // 如果转换失败（例如字符串内容无法解析为数字），返回默认值
-            if ( !(iss >> value) ) return default_value;
+            if ( !key_it->parse(value) ) return default_value;
             return value;
         }
     }
 };
 }  // namespace MMM
+
+template<> struct std::tuple_size<MMM::MetadataEntry>
+    : std::integral_constant<std::size_t, 2> {};
+
+template<> struct std::tuple_element<0, MMM::MetadataEntry> {
+    using type = const std::string;
+};
+
+template<> struct std::tuple_element<1, MMM::MetadataEntry> {
+    using type = std::string;
+};
@@ -0,0 +1,43 @@
+#pragma once
+
+#include <cstddef>
+#include <functional>
+
+namespace MMM
+{
+
+/**
+ * @brief 谱面格式库使用的可注入后台执行器。
+ *
+ * MMM 不依赖应用线程池；应用在启动阶段把共享线程池包装为执行器注入，
+ * 命令行工具与测试不注入时所有并行入口退化为在调用线程内串行执行。
+ */
+struct ParallelExecutor {
+    /// @brief 投递一个后台任务；任务可能在 parallelFor 返回之后才开始执行。
+    std::function<void(std::function<void()>)> submit;
+
+    /// @brief 包含调用线程在内可同时运行的线程数。
+    std::size_t concurrency{ 1 };
+};
+
+/// @brief 设置进程级执行器；submit 为空或 concurrency 不大于 1 表示停用。
+/// @warning 生命周期路径：由应用启动与退出阶段调用，关闭线程池前须先停用。
+void setParallelExecutor(ParallelExecutor executor);
+
+/// @brief 当前执行器的并发数；未注入时返回 1。
+[[nodiscard]] std::size_t parallelConcurrency();
+
+/**
+ * @brief 对 [0, taskCount) 的每个下标调用一次 task。
+ * @details 调用线程同样领取任务；执行器繁忙（例如调用本身运行在线程池内）
+ * 时由调用线程独自完成全部任务，不会因等待而死锁。未注入执行器时按顺序
+ * 串行执行。任一任务抛出的首个异常在全部任务结束后重新抛出。
+ * @param taskCount 任务数量。
+ * @param task 以任务下标调用，可能在多个线程上并发执行。
+ * @param maxThreads 最多参与的线程数；为 0 时使用 parallelConcurrency()。
+ */
+void parallelFor(std::size_t                             taskCount,
+                 const std::function<void(std::size_t)>& task,
+                 std::size_t                             maxThreads = 0);
+
+}  // namespace MMM
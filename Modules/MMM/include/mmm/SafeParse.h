@@ -4,6 +4,7 @@
 #include <cmath>
 #include <cstddef>
 #include <limits>
+#include <span>
 #include <string>
 #include <string_view>
 #include <system_error>
@@ -88,12 +89,45 @@ inline std::string safeAt(const std::vector<std::string>& v, size_t idx,
     return v[idx];
 }
 
+/// @brief 安全读取字段视图，越界时返回默认值。
+/// @param v 字段视图列表。
+/// @param idx 字段下标。
+/// @param defaultVal 越界时返回的默认值。
+/// @return 字段视图或默认值；返回值与输入共享底层缓冲区。
+inline std::string_view safeAt(std::span<const std::string_view> v, size_t idx,
+                               std::string_view defaultVal = {})
+{
+    if ( idx >= v.size() ) return defaultVal;
+    return v[idx];
+}
+
+/// @brief 读取按分隔符切分后的第 idx 个字段，不分配临时字段列表。
+/// @details 与逐段切分并保留结尾空字段的语义一致，字段不存在时返回空视图。
+/// @param text 待切分字符串视图。
+/// @param delimiter 分隔符。
+/// @param idx 字段下标。
+/// @return 字段视图。
+inline std::string_view delimitedFieldAt(std::string_view text, char delimiter,
+                                         size_t idx)
+{
+    std::size_t start = 0;
+    for ( ; idx > 0; --idx ) {
+        const std::size_t end = text.find(delimiter, start);
+        if ( end == std::string_view::npos ) return {};
+        start = end + 1;
+    }
+    const std::size_t end = text.find(delimiter, start);
+    return text.substr(start,
+                       end == std::string_view::npos ? std::string_view::npos
+                                                     : end - start);
+}
+
 /// @brief 安全解析整数，失败时返回默认值。
 /// @details 兼容旧 `std::stoi` 行为：允许前导空白和数字后的非数字尾巴。
-/// @param s 待解析字符串。
+/// @param s 待解析字符串视图。
 /// @param defaultVal 解析失败时的默认值。
 /// @return 解析得到的整数或默认值。
-inline int safeStoi(const std::string& s, int defaultVal = 0)
+inline int safeStoi(std::string_view s, int defaultVal = 0)
 {
     if ( s.empty() ) return defaultVal;
     auto text = trimLeadingAsciiSpaces(s);
@@ -120,10 +154,10 @@ inline int safeStoi(const std::string& s, int defaultVal = 0)
 
 /// @brief 安全解析浮点数，失败时返回默认值。
 /// @details 兼容旧 `std::stod` 行为：允许前导空白和数字后的非数字尾巴。
-/// @param s 待解析字符串。
+/// @param s 待解析字符串视图。
 /// @param defaultVal 解析失败时的默认值。
 /// @return 解析得到的浮点数或默认值。
-inline double safeStod(const std::string& s, double defaultVal = 0.0)
+inline double safeStod(std::string_view s, double defaultVal = 0.0)
 {
     if ( s.empty() ) return defaultVal;
     auto text = trimLeadingAsciiSpaces(s);
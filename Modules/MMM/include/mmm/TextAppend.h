@@ -0,0 +1,41 @@
+#pragma once
+#include <charconv>
+#include <concepts>
+#include <string>
+#include <system_error>
+
+namespace MMM::Internal
+{
+
+/// @brief 以十进制追加整数，不经过流或临时字符串。
+/// @param out 输出缓冲区。
+/// @param value 待追加的整数。
+template<std::integral T> inline void appendInteger(std::string& out, T value)
+{
+    char buffer[24];
+    const auto result = std::to_chars(buffer, buffer + sizeof(buffer), value);
+    out.append(buffer, result.ptr);
+}
+
+/// @brief 以定点格式追加浮点数，结果与 `std::fixed` 加
+/// `std::setprecision(precision)` 的流输出一致。
+/// @param out 输出缓冲区。
+/// @param value 待追加的浮点数。
+/// @param precision 小数位数。
+inline void appendFixed(std::string& out, double value, int precision)
+{
+    // 最大有限 double 的整数部分为 309 位，另加符号、小数点与小数位。
+    char       buffer[384];
+    const auto result = std::to_chars(buffer,
+                                      buffer + sizeof(buffer),
+                                      value,
+                                      std::chars_format::fixed,
+                                      precision);
+    if ( result.ec == std::errc{} ) {
+        out.append(buffer, result.ptr);
+    } else {
+        out += std::to_string(value);
+    }
+}
+
+}  // namespace MMM::Internal
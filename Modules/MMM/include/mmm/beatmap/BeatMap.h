@@ -2,6 +2,7 @@
 
 #include "mmm/Metadata.h"
 #include "mmm/annotation/BeatmapAnnotation.h"
+#include "mmm/beatmap/NoteOrderIndex.h"
 #include "mmm/note/Flick.h"
 #include "mmm/note/Hold.h"
 #include "mmm/note/Note.h"
@@ -84,6 +85,20 @@ public:
      */
     static BeatMap loadFromFile(std::filesystem::path mapFilePath);
 
+    /**
+     * @brief 只读取谱面头部元数据，在任何物件之前停止
+     *
+     * 各格式读取的范围：osu 为 [TimingPoints]/[HitObjects] 之前的各段，
+     * Malody 为 meta，imd 为文件名信息与开头的谱面时长，mmm 为
+     * format_version、metadata 与 audio_samples。返回的谱面没有物件与
+     * Timing，依赖物件推导的字段（如 imd 的轨道数与谱面时长上限、
+     * 首个 BPM）保持头部中的值；Malody 位于 note 数组中的自动采样也不会
+     * 被读取。结果不经过也不写入谱面缓存。
+     * @param mapFilePath 谱面文件路径
+     * @return 只填充了头部字段的谱面；读取失败时返回空谱面
+     */
+    static BeatMap probeHeader(std::filesystem::path mapFilePath);
+
     /**
      * @brief 保存谱面到文件
      * @param mapFilePath 保存的目标路径
@@ -91,11 +106,16 @@ public:
      */
     bool saveToFile(std::filesystem::path mapFilePath) const;
 
-    /// @brief 同步物件引用表 (m_allNotes)
+    /**
+     * @brief 由 m_noteData 整体重建物件引用表 (m_allNotes)
+     *
+     * 只在物件容器被整体替换（加载、格式转换、协作快照）后调用；单个物件
+     * 的增删改时应直接调用 m_allNotes 的 insert()/erase()/retime()。
+     */
     void sync();
 
-    /// @brief 所有物件引用
-    std::vector<std::reference_wrapper<Note>> m_allNotes;
+    /// @brief 所有物件引用，按 (时间戳, 轨道, 类型) 有序
+    NoteOrderIndex m_allNotes;
 
     /// @brief 所有物件数据
     NoteData m_noteData;
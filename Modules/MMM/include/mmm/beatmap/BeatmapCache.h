@@ -0,0 +1,175 @@
+#pragma once
+
+#include "mmm/beatmap/BeatMap.h"
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <filesystem>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <optional>
+
+namespace MMM
+{
+
+/// @brief 谱面二进制缓存的容量限制。
+struct BeatmapCacheOptions {
+    /// @brief 缓存目录允许占用的总字节数，超出后按最近访问时间淘汰。
+    std::uint64_t maxBytes{ 256ULL * 1024ULL * 1024ULL };
+
+    /// @brief 缓存目录允许保存的条目数。
+    std::size_t maxEntries{ 1024 };
+};
+
+/// @brief 谱面缓存命中统计快照。
+struct BeatmapCacheStatistics {
+    /// @brief 直接由缓存文件还原的加载次数。
+    std::uint64_t hits{ 0 };
+
+    /// @brief 缓存缺失或失效、回退到解析器的加载次数。
+    std::uint64_t misses{ 0 };
+
+    /// @brief 成功写入的缓存条目数。
+    std::uint64_t stores{ 0 };
+
+    /// @brief 因容量限制被淘汰的条目数。
+    std::uint64_t evictions{ 0 };
+};
+
+/**
+ * @brief 已解析谱面的版本化二进制旁路缓存。
+ *
+ * 每个谱面文件对应缓存目录中的一个条目，以调用方传入的路径与其绝对路径
+ * 作为键，头部记录源文件大小、修改时间与内容哈希。读取时整份条目以内存
+ * 映射打开：大小与修改时间一致即视为有效，仅修改时间变化时再比对内容
+ * 哈希。.imd 与 .mmm 的加载结果还依赖同目录下的其他文件，因此额外校验
+ * 所在目录的修改时间。
+ *
+ * 命中时不读取源文件是有意的取舍：命中路径只需两次 stat，不随谱面大小
+ * 增长。代价是在修改时间精度内改写且大小不变、或改写后又恢复修改时间的
+ * 源文件会命中旧条目；这种情况下删除条目、clear() 或设置
+ * MMM_DISABLE_BEATMAP_CACHE 即可恢复。
+ *
+ * 写入后按本进程记录的目录占用估计判断是否超出容量限制，只有超出时才
+ * 扫描目录淘汰，因此批量写入不会每次都遍历整个目录。
+ *
+ * BeatMap::loadFromFile 通过 active() 使用进程级当前缓存；没有激活缓存、
+ * setEnabled(false) 或设置了环境变量 MMM_DISABLE_BEATMAP_CACHE 时完全
+ * 走原解析路径。
+ */
+class BeatmapCache
+{
+public:
+    /// @brief 缓存缺失时调用的原始解析器。
+    using Parser = std::function<BeatMap(const std::filesystem::path&)>;
+
+    /// @brief 缓存条目格式版本。条目布局或任一加载器的输出语义变化时递增，
+    /// 旧条目随即失效并按淘汰策略清理。
+    static constexpr std::uint32_t FORMAT_VERSION = 1;
+
+    /// @brief 缓存条目文件扩展名。
+    static constexpr const char* ENTRY_EXTENSION = ".mmmcache";
+
+    /// @param directory 缓存目录，首次写入时创建。
+    /// @param options 容量限制。
+    explicit BeatmapCache(std::filesystem::path directory,
+                          BeatmapCacheOptions   options = {});
+
+    BeatmapCache(const BeatmapCache&)            = delete;
+    BeatmapCache& operator=(const BeatmapCache&) = delete;
+
+    /// @brief 缓存目录。
+    [[nodiscard]] const std::filesystem::path& directory() const
+    {
+        return m_directory;
+    }
+
+    /**
+     * @brief 优先从缓存还原谱面，缺失或失效时解析并写回缓存。
+     * @param mapPath 谱面文件路径。
+     * @param parse 原始解析器。
+     * @return 与 parse(mapPath) 相同的谱面。
+     */
+    BeatMap load(const std::filesystem::path& mapPath, const Parser& parse);
+
+    /**
+     * @brief 只查找有效缓存，不调用解析器。
+     * @param mapPath 谱面文件路径。
+     * @return 命中时返回还原的谱面。
+     */
+    std::optional<BeatMap> find(const std::filesystem::path& mapPath);
+
+    /**
+     * @brief 按当前源文件状态写入缓存条目。
+     * @param mapPath 谱面文件路径。
+     * @param beatMap 由该文件解析出的谱面。
+     * @return 写入成功时返回 true。
+     */
+    bool store(const std::filesystem::path& mapPath, const BeatMap& beatMap);
+
+    /// @brief 缓存条目文件路径。
+    [[nodiscard]] std::filesystem::path entryPath(
+        const std::filesystem::path& mapPath) const;
+
+    /// @brief 扫描缓存目录；超出容量限制时按最近访问时间淘汰条目，直到
+    /// 低于限制的 90%，为后续写入留出余量。
+    void trim();
+
+    /// @brief 删除全部缓存条目。
+    void clear();
+
+    /// @brief 当前统计快照。
+    [[nodiscard]] BeatmapCacheStatistics statistics() const;
+
+    /// @brief 设置进程级当前缓存；传入空指针表示停用。
+    static void setActive(std::shared_ptr<BeatmapCache> cache);
+
+    /// @brief 进程级当前缓存；未激活或已被总开关关闭时返回空指针。
+    [[nodiscard]] static std::shared_ptr<BeatmapCache> active();
+
+    /// @brief 缓存总开关。
+    static void setEnabled(bool enabled);
+
+    /// @brief 缓存是否启用；环境变量 MMM_DISABLE_BEATMAP_CACHE 优先关闭。
+    [[nodiscard]] static bool isEnabled();
+
+private:
+    struct SourceStamp;
+
+    /// @brief 按条目与源文件状态尝试还原谱面。
+    std::optional<BeatMap> findWithStamp(const std::filesystem::path& mapPath,
+                                         const SourceStamp&           stamp);
+
+    /// @brief 把谱面写入条目；stamp 为解析前采集的源文件状态。
+    bool storeWithStamp(const std::filesystem::path& mapPath,
+                        const SourceStamp& stamp, const BeatMap& beatMap);
+
+    /// @brief 记入一次写入；估计占用超出容量限制或尚未扫描过目录时调用
+    /// trim()。
+    /// @param entryBytes 新条目字节数。
+    /// @param replacedBytes 被替换的旧条目字节数；新增条目时为空。
+    void accountStore(std::uint64_t                entryBytes,
+                      std::optional<std::uint64_t> replacedBytes);
+
+    /// @brief 用一次目录扫描的结果重置占用估计。
+    void resetUsage(std::uint64_t bytes, std::size_t entries);
+
+    std::filesystem::path m_directory;
+    BeatmapCacheOptions   m_options;
+
+    /// @brief 保护下面的目录占用估计。
+    std::mutex m_usageMutex;
+    /// @brief 是否已扫描过目录；其他进程的写入只在下一次扫描时计入。
+    bool          m_usageKnown{ false };
+    std::uint64_t m_usageBytes{ 0 };
+    std::size_t   m_usageEntries{ 0 };
+
+    std::atomic<std::uint64_t> m_hits{ 0 };
+    std::atomic<std::uint64_t> m_misses{ 0 };
+    std::atomic<std::uint64_t> m_stores{ 0 };
+    std::atomic<std::uint64_t> m_evictions{ 0 };
+};
+
+}  // namespace MMM
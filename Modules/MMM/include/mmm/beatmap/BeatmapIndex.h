@@ -0,0 +1,277 @@
+#pragma once
+
+#include "mmm/beatmap/BeatMap.h"
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <filesystem>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+namespace MMM
+{
+
+/// @brief 谱面中的一个音频引用及其出现次数。
+struct BeatmapAudioReferenceCount {
+    /// @brief 谱面字段中保存的资源 ID 或路径。
+    std::string reference;
+
+    /// @brief 该引用在谱面中出现的次数。
+    std::uint32_t count{ 0 };
+
+    /// @brief 该引用最早一次出现的有效时间戳（毫秒）。
+    double firstTimestamp{ 0.0 };
+
+    bool operator==(const BeatmapAudioReferenceCount&) const = default;
+};
+
+/// @brief 项目视图与资源扫描共用的单谱面摘要。
+struct BeatmapSummary {
+    /// @brief 谱面版本名。
+    std::string version;
+
+    /// @brief 歌曲标题。
+    std::string title;
+
+    /// @brief 歌曲艺术家。
+    std::string artist;
+
+    /// @brief 谱面作者。
+    std::string author;
+
+    /// @brief 元数据中的歌曲文件提示，保持谱面中的原始写法。
+    std::filesystem::path songFileHint;
+
+    /// @brief 旧版单主音频路径，保持谱面中的原始写法。
+    std::filesystem::path mainAudioPath;
+
+    /// @brief 封面图片路径，保持谱面中的原始写法。
+    std::filesystem::path coverPath;
+
+    /// @brief 主背景路径，保持谱面中的原始写法。
+    std::filesystem::path mainCoverPath;
+
+    /// @brief 可计数物件数量；折线按其 Note、Hold、Flick 子物件计数。
+    std::size_t noteCount{ 0 };
+
+    /// @brief 最大连击数；Hold 区间按四分之一拍累计，与编辑器状态栏一致。
+    std::size_t maxCombo{ 0 };
+
+    /// @brief 最后一个物件结束的时间（毫秒）。
+    double durationMs{ 0.0 };
+
+    /// @brief 主轨道数量。
+    std::int32_t trackCount{ -1 };
+
+    /// @brief BPM 时间线中的最小 BPM；没有 BPM 时间线时取参考 BPM。
+    double minBpm{ 0.0 };
+
+    /// @brief BPM 时间线中的最大 BPM；没有 BPM 时间线时取参考 BPM。
+    double maxBpm{ 0.0 };
+
+    /// @brief 是否包含 Flick 或折线。
+    bool hasFlicksOrPolylines{ false };
+
+    /// @brief 玩家物件命中采样绑定，按首次出现顺序排列。
+    std::vector<BeatmapAudioReferenceCount> noteSampleReferences;
+
+    /// @brief 自动采样引用，按首次出现顺序排列。
+    std::vector<BeatmapAudioReferenceCount> audioSampleReferences;
+
+    bool operator==(const BeatmapSummary&) const = default;
+
+    /// @brief 从已加载的谱面计算摘要。
+    [[nodiscard]] static BeatmapSummary fromBeatMap(const BeatMap& beatMap);
+};
+
+/// @brief 一次批量刷新的结果统计。
+struct BeatmapIndexStatistics {
+    /// @brief 源文件未变、直接复用的条目数。
+    std::size_t reused{ 0 };
+
+    /// @brief 重新解析并写入的条目数。
+    std::size_t rebuilt{ 0 };
+
+    /// @brief 解析失败、没有条目的谱面数。
+    std::size_t failed{ 0 };
+
+    /// @brief 谱面已不在项目中而被删除的条目数。
+    std::size_t removed{ 0 };
+};
+
+/**
+ * @brief 持久化的项目谱面摘要索引。
+ *
+ * 以项目相对路径为键，为每个谱面保存一份 BeatmapSummary 与源文件大小、
+ * 修改时间和内容哈希。大小与修改时间一致即视为有效，仅修改时间变化时
+ * 比对内容哈希；.imd 的摘要还依赖同目录下的音频与封面探测，额外校验
+ * 所在目录的修改时间。索引文件为 JSON，与项目分片配置放在同一隐藏目录。
+ *
+ * 所有成员函数都可以跨线程调用。ProjectResourceService 等调用方通过
+ * active() 使用当前项目的索引；没有激活索引时回退到完整加载谱面。项目
+ * 打开时索引先激活、再在后台刷新，isReady() 为 false 期间调用方只查找
+ * 有效条目，未命中时回退到 BeatMap::probeHeader。
+ */
+class BeatmapIndex
+{
+public:
+    /// @brief 索引文件格式版本。摘要字段或统计口径变化时递增，旧索引整体
+    /// 失效并在下次刷新时重建。
+    static constexpr std::uint32_t FORMAT_VERSION = 1;
+
+    /// @param projectRoot 项目根目录，条目键相对于它。
+    /// @param indexFile 索引文件路径。
+    BeatmapIndex(std::filesystem::path projectRoot,
+                 std::filesystem::path indexFile);
+
+    BeatmapIndex(const BeatmapIndex&)            = delete;
+    BeatmapIndex& operator=(const BeatmapIndex&) = delete;
+
+    /// @brief 项目根目录。
+    [[nodiscard]] const std::filesystem::path& projectRoot() const
+    {
+        return m_projectRoot;
+    }
+
+    /// @brief 索引文件路径。
+    [[nodiscard]] const std::filesystem::path& indexFile() const
+    {
+        return m_indexFile;
+    }
+
+    /**
+     * @brief 从索引文件读取条目，替换当前内容。
+     * @return 文件存在且格式版本匹配时返回 true；否则索引为空。
+     */
+    bool load();
+
+    /**
+     * @brief 条目有变化时以临时文件替换方式写回索引文件。
+     * @details 并发调用按顺序写入；排在后面的调用发现条目已被前一次写入
+     * 时直接返回，连续保存因此合并为一次写入。
+     * @return 没有变化或写入成功时返回 true。
+     */
+    bool save();
+
+    /**
+     * @brief 按项目当前谱面列表并行刷新索引。
+     *
+     * 有效条目直接复用，其余谱面经 parallelFor 分发到注入的执行器上加载
+     * 并重新计算摘要；不在 mapPaths 中的条目被删除。完成后 isReady()
+     * 返回 true。
+     * @param mapPaths 项目内全部谱面路径，绝对路径或项目相对路径。
+     * @param workerCount 最多参与的线程数；为 0 时使用执行器并发数。
+     * @return 本次刷新的统计。
+     */
+    BeatmapIndexStatistics refresh(
+        const std::vector<std::filesystem::path>& mapPaths,
+        std::size_t                               workerCount = 0);
+
+    /**
+     * @brief 获取谱面摘要，条目缺失或失效时加载谱面并更新条目。
+     * @param mapPath 谱面路径，绝对路径或项目相对路径。
+     * @return 谱面无法读取时返回空。
+     */
+    std::optional<BeatmapSummary> summary(const std::filesystem::path& mapPath);
+
+    /**
+     * @brief 只查找有效条目，不加载谱面。
+     * @param mapPath 谱面路径，绝对路径或项目相对路径。
+     */
+    std::optional<BeatmapSummary> find(const std::filesystem::path& mapPath);
+
+    /**
+     * @brief 重新读取刚写入的谱面文件并更新条目。
+     * @details 摘要取自文件而不是内存谱面，osu、imd 等有损格式保存后的
+     * 摘要与之后加载得到的一致；源文件状态未变时同样重建条目。
+     * @param mapPath 谱面路径，绝对路径或项目相对路径。
+     * @return 谱面读取成功并写入条目时返回 true。
+     */
+    bool reload(const std::filesystem::path& mapPath);
+
+    /// @brief 删除一个条目。
+    void remove(const std::filesystem::path& mapPath);
+
+    /// @brief 条目数量。
+    [[nodiscard]] std::size_t size() const;
+
+    /// @brief 是否存在尚未写回索引文件的变化。
+    [[nodiscard]] bool isDirty() const;
+
+    /// @brief 是否已按项目谱面列表完成过一次 refresh()。
+    [[nodiscard]] bool isReady() const
+    {
+        return m_ready.load(std::memory_order_acquire);
+    }
+
+    /// @brief 条目键：项目内谱面为 '/' 分隔的相对路径，项目外为绝对路径。
+    [[nodiscard]] std::string entryKey(
+        const std::filesystem::path& mapPath) const;
+
+    /// @brief 设置进程级当前索引；传入空指针表示停用。
+    static void setActive(std::shared_ptr<BeatmapIndex> index);
+
+    /// @brief 进程级当前索引；未激活时返回空指针。
+    [[nodiscard]] static std::shared_ptr<BeatmapIndex> active();
+
+private:
+    /// @brief 源文件状态快照。
+    struct SourceStamp {
+        std::uint64_t size{ 0 };
+        std::int64_t  writeTime{ 0 };
+        std::int64_t  directoryWriteTime{ 0 };
+
+        bool operator==(const SourceStamp&) const = default;
+
+        /// @brief 读取源文件状态；文件不存在时返回空。
+        static std::optional<SourceStamp> read(
+            const std::filesystem::path& absolutePath);
+    };
+
+    /// @brief 一个谱面的索引条目。
+    struct Entry {
+        SourceStamp    stamp;
+        std::uint64_t  contentHash{ 0 };
+        BeatmapSummary summary;
+    };
+
+    /// @brief 解析为绝对路径。
+    [[nodiscard]] std::filesystem::path resolve(
+        const std::filesystem::path& mapPath) const;
+
+    /// @brief 按源文件状态查找有效条目；仅修改时间变化且内容未变时刷新
+    /// 条目记录的修改时间。
+    std::optional<BeatmapSummary> findWithStamp(
+        const std::string& key, const std::filesystem::path& absolutePath,
+        const SourceStamp& stamp);
+
+    /// @brief 加载谱面并写入条目；stamp 为加载前采集的源文件状态。
+    std::optional<BeatmapSummary> rebuild(
+        const std::string& key, const std::filesystem::path& absolutePath,
+        const SourceStamp& stamp);
+
+    /// @brief 按摘要与源文件状态写入条目。
+    bool storeWithStamp(const std::string&           key,
+                        const std::filesystem::path& absolutePath,
+                        const SourceStamp& stamp, BeatmapSummary summary);
+
+    std::filesystem::path m_projectRoot;
+    std::filesystem::path m_indexFile;
+
+    mutable std::mutex                     m_mutex;
+    std::unordered_map<std::string, Entry> m_entries;
+    bool                                   m_dirty{ false };
+
+    /// @brief 串行化索引文件写入，避免并发保存争用同一个临时文件。
+    std::mutex m_saveMutex;
+
+    /// @brief 首次 refresh() 完成后置位；后台刷新线程写入，调用方读取。
+    std::atomic<bool> m_ready{ false };
+};
+
+}  // namespace MMM
@@ -0,0 +1,282 @@
+#pragma once
+
+#include "mmm/note/Note.h"
+#include <compare>
+#include <cstddef>
+#include <functional>
+#include <iterator>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+namespace MMM
+{
+
+/**
+ * @brief 按 (时间戳, 轨道, 类型) 排序的物件引用表。
+ *
+ * 引用存放在若干有序分块中，每块不超过 MAX_CHUNK_SIZE 个元素并记录其全局
+ * 起始下标。定位通过先二分分块、再在块内二分完成；插入、删除与改时只移动
+ * 单个分块内的元素并平移后续分块的起始下标，编辑单个物件不必重新排序
+ * 整张谱面。
+ *
+ * 时间戳相差不超过 TIMESTAMP_EPSILON 视为相同，此时依次比较轨道与类型；
+ * 键完全相同的引用保持插入顺序，因此 assign() 的结果与原先 sync() 中
+ * stable_sort 的结果逐项一致。
+ *
+ * 对外保留随机访问迭代器、下标、front()/back() 等只读接口，现有按顺序
+ * 遍历的保存器与测试无需修改。
+ */
+class NoteOrderIndex
+{
+public:
+    using value_type      = std::reference_wrapper<Note>;
+    using size_type       = std::size_t;
+    using difference_type = std::ptrdiff_t;
+    using reference       = value_type&;
+    using const_reference = const value_type&;
+
+    /// @brief 判定为同一时刻的时间戳差值（毫秒）。
+    static constexpr double TIMESTAMP_EPSILON = 1e-4;
+
+    /// @brief 分块的元素上限；插入使分块超出时对半拆分。
+    static constexpr size_type MAX_CHUNK_SIZE = 512;
+
+    /// @brief 批量构建时每个分块的目标元素数，为后续插入留出余量。
+    static constexpr size_type FILL_CHUNK_SIZE = MAX_CHUNK_SIZE * 3 / 4;
+
+    /// @brief 按排序键比较两个物件。
+    [[nodiscard]] static bool keyLess(const Note& lhs, const Note& rhs);
+
+    /// @brief 顺序访问迭代器，按 (分块, 块内下标) 遍历。
+    template<bool IsConst> class Iterator
+    {
+    public:
+        using iterator_category = std::random_access_iterator_tag;
+        using value_type        = NoteOrderIndex::value_type;
+        using difference_type   = std::ptrdiff_t;
+        using reference =
+            std::conditional_t<IsConst, const value_type&, value_type&>;
+        using pointer =
+            std::conditional_t<IsConst, const value_type*, value_type*>;
+        using Owner =
+            std::conditional_t<IsConst, const NoteOrderIndex, NoteOrderIndex>;
+
+        Iterator() = default;
+        Iterator(Owner* owner, size_type chunk, size_type offset)
+            : m_owner(owner), m_chunk(chunk), m_offset(offset)
+        {
+        }
+
+        /// @brief 非常量迭代器可隐式转换为常量迭代器。
+        operator Iterator<true>() const
+            requires(!IsConst)
+        {
+            return Iterator<true>(m_owner, m_chunk, m_offset);
+        }
+
+        reference operator*() const
+        {
+            return m_owner->m_chunks[m_chunk][m_offset];
+        }
+        pointer operator->() const { return &**this; }
+        reference operator[](difference_type n) const { return *(*this + n); }
+
+        Iterator& operator++()
+        {
+            if ( ++m_offset == m_owner->m_chunks[m_chunk].size() ) {
+                ++m_chunk;
+                m_offset = 0;
+            }
+            return *this;
+        }
+        Iterator operator++(int)
+        {
+            Iterator previous = *this;
+            ++*this;
+            return previous;
+        }
+        Iterator& operator--()
+        {
+            if ( m_offset == 0 ) {
+                --m_chunk;
+                m_offset = m_owner->m_chunks[m_chunk].size();
+            }
+            --m_offset;
+            return *this;
+        }
+        Iterator operator--(int)
+        {
+            Iterator previous = *this;
+            --*this;
+            return previous;
+        }
+
+        Iterator& operator+=(difference_type n)
+        {
+            *this = m_owner->template iteratorAt<IsConst>(
+                static_cast<size_type>(position() + n));
+            return *this;
+        }
+        Iterator& operator-=(difference_type n) { return *this += -n; }
+        friend Iterator operator+(Iterator it, difference_type n)
+        {
+            return it += n;
+        }
+        friend Iterator operator+(difference_type n, Iterator it)
+        {
+            return it += n;
+        }
+        friend Iterator operator-(Iterator it, difference_type n)
+        {
+            return it -= n;
+        }
+        friend difference_type operator-(const Iterator& lhs,
+                                         const Iterator& rhs)
+        {
+            return lhs.position() - rhs.position();
+        }
+
+        friend bool operator==(const Iterator& lhs, const Iterator& rhs)
+        {
+            return lhs.m_chunk == rhs.m_chunk && lhs.m_offset == rhs.m_offset;
+        }
+        friend auto operator<=>(const Iterator& lhs, const Iterator& rhs)
+        {
+            return lhs.position() <=> rhs.position();
+        }
+
+    private:
+        friend class NoteOrderIndex;
+
+        /// @brief 全局下标。
+        [[nodiscard]] difference_type position() const
+        {
+            return static_cast<difference_type>(
+                m_chunk < m_owner->m_chunkStarts.size()
+                    ? m_owner->m_chunkStarts[m_chunk] + m_offset
+                    : m_owner->m_size);
+        }
+
+        Owner*    m_owner{ nullptr };
+        size_type m_chunk{ 0 };
+        size_type m_offset{ 0 };
+    };
+
+    using iterator       = Iterator<false>;
+    using const_iterator = Iterator<true>;
+
+    NoteOrderIndex()                                 = default;
+    NoteOrderIndex(NoteOrderIndex&&)                 = default;
+    NoteOrderIndex(const NoteOrderIndex&)            = default;
+    NoteOrderIndex& operator=(NoteOrderIndex&&)      = default;
+    NoteOrderIndex& operator=(const NoteOrderIndex&) = default;
+    ~NoteOrderIndex()                                = default;
+
+    /**
+     * @brief 整体重建：按排序键稳定排序后重新分块。
+     * @param refs 任意顺序的物件引用；键相同者保留此处的先后顺序。
+     */
+    void assign(std::vector<value_type> refs);
+
+    /**
+     * @brief 插入一个物件引用，位于所有键相同的引用之后。
+     * @return 指向新元素的迭代器。
+     */
+    iterator insert(Note& note);
+
+    /**
+     * @brief 删除一个物件引用，按对象地址识别。
+     * @param note 待删除物件；其排序键必须与插入时一致。
+     * @return 找到并删除时返回 true。
+     */
+    bool erase(const Note& note);
+
+    /**
+     * @brief 修改物件时间戳并移动到新位置。
+     * @param note 已在表中的物件。
+     * @param timestamp 新时间戳（毫秒）。
+     * @return 物件在表中时返回 true；否则只修改时间戳。
+     */
+    bool retime(Note& note, double timestamp);
+
+    /**
+     * @brief 在末尾追加引用，不检查顺序。
+     * @details 只供按已排序顺序解码的调用方（如谱面缓存）使用。
+     */
+    void push_back(value_type ref);
+
+    /// @brief 预留分块表容量。
+    void reserve(size_type count);
+
+    /// @brief 清空所有引用。
+    void clear();
+
+    /// @brief 与另一张表交换内容。
+    void swap(NoteOrderIndex& other) noexcept;
+
+    /// @brief 查找物件引用的位置，按对象地址识别。
+    [[nodiscard]] const_iterator find(const Note& note) const;
+
+    /// @brief 第一个排序键不小于 note 的位置。
+    [[nodiscard]] const_iterator lowerBound(const Note& note) const;
+
+    /// @brief 各分块按顺序满足排序键，且起始下标与元素数一致。
+    [[nodiscard]] bool isConsistent() const;
+
+    [[nodiscard]] size_type size() const { return m_size; }
+    [[nodiscard]] bool      empty() const { return m_size == 0; }
+
+    /// @brief 分块数量。
+    [[nodiscard]] size_type chunkCount() const { return m_chunks.size(); }
+
+    reference       operator[](size_type index);
+    const_reference operator[](size_type index) const;
+
+    reference       front() { return m_chunks.front().front(); }
+    const_reference front() const { return m_chunks.front().front(); }
+    reference       back() { return m_chunks.back().back(); }
+    const_reference back() const { return m_chunks.back().back(); }
+
+    iterator       begin() { return { this, 0, 0 }; }
+    iterator       end() { return { this, m_chunks.size(), 0 }; }
+    const_iterator begin() const { return { this, 0, 0 }; }
+    const_iterator end() const { return { this, m_chunks.size(), 0 }; }
+    const_iterator cbegin() const { return begin(); }
+    const_iterator cend() const { return end(); }
+
+private:
+    using Chunk = std::vector<value_type>;
+
+    /// @brief 全局下标对应的迭代器；index == size() 时返回 end()。
+    template<bool IsConst> Iterator<IsConst> iteratorAt(size_type index) const
+    {
+        using Owner = typename Iterator<IsConst>::Owner;
+        auto* owner = const_cast<Owner*>(this);
+        if ( index >= m_size ) return { owner, m_chunks.size(), 0 };
+        const size_type chunk = chunkContaining(index);
+        return { owner, chunk, index - m_chunkStarts[chunk] };
+    }
+
+    /// @brief 包含全局下标 index 的分块。
+    [[nodiscard]] size_type chunkContaining(size_type index) const;
+
+    /// @brief 从 firstChunk 起重新计算起始下标。
+    void updateChunkStarts(size_type firstChunk);
+
+    /// @brief 分块过大时对半拆分。
+    void splitIfNeeded(size_type chunk);
+
+    /// @brief 删除空分块，并与过小的相邻分块合并。
+    void compactAfterErase(size_type chunk);
+
+    /// @brief 插入 note 的位置（分块与块内下标），位于键相同者之后。
+    [[nodiscard]] std::pair<size_type, size_type> insertPosition(
+        const Note& note) const;
+
+    std::vector<Chunk>     m_chunks;
+    std::vector<size_type> m_chunkStarts;
+    size_type              m_size{ 0 };
+};
+
+}  // namespace MMM
@@ -18,11 +18,16 @@ public:
     /// @brief 长条持续时间
     double m_duration{ .0 };
 
+    using Note::from_osu_description;
+
     /// @brief 从osu描述加载
-    void from_osu_description(const std::vector<std::string>& description,
+    void from_osu_description(std::span<const std::string_view> description,
                               int32_t orbit_count) override;
     /// @brief 转换为osu描述
     std::string to_osu_description(int32_t orbit_count) override;
+    /// @brief 将osu描述直接追加到输出缓冲区
+    void append_osu_description(std::string& out,
+                                int32_t      orbit_count) const override;
 };
 
 }  // namespace MMM
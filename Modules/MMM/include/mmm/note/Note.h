@@ -5,7 +5,9 @@
 #include <cstddef>
 #include <cstdint>
 #include <optional>
+#include <span>
 #include <string>
+#include <string_view>
 #include <utility>
 #include <vector>
 
@@ -79,11 +81,23 @@ public:
     }
 
     /// @brief 从osu描述加载
+    /// @param description 逗号切分后的字段视图，仅在调用期间被读取。
+    /// @param orbit_count 轨道数。
     virtual void from_osu_description(
-        const std::vector<std::string>& description, int32_t orbit_count);
+        std::span<const std::string_view> description, int32_t orbit_count);
+
+    /// @brief 从osu描述加载
+    void from_osu_description(const std::vector<std::string>& description,
+                              int32_t                         orbit_count);
 
     /// @brief 转换为osu描述
     virtual std::string to_osu_description(int32_t orbit_count);
+
+    /// @brief 将osu描述直接追加到输出缓冲区，结果与 to_osu_description 一致。
+    /// @param out 输出缓冲区。
+    /// @param orbit_count 轨道数。
+    virtual void append_osu_description(std::string& out,
+                                        int32_t      orbit_count) const;
 };
 
 
@@ -1,7 +1,9 @@
 #pragma once
 
 #include "mmm/Metadata.h"
+#include <span>
 #include <string>
+#include <string_view>
 #include <vector>
 
 namespace MMM
@@ -57,6 +59,10 @@ public:
     /// @brief 所有时间线元数据
     TimingMetadata m_metadata;
 
+    /// @brief 从osu的字符串读取
+    /// @param description 逗号切分后的字段视图，仅在调用期间被读取。
+    void from_osu_description(std::span<const std::string_view> description);
+
     /// @brief 从osu的字符串读取
     void from_osu_description(std::vector<std::string>& description);
 
@@ -0,0 +1,241 @@
+#include "mmm/Metadata.h"
+
+#include <deque>
+#include <mutex>
+#include <shared_mutex>
+
+namespace MMM
+{
+namespace Internal
+{
+
+const MetadataKeyRecord EMPTY_METADATA_KEY{};
+
+}  // namespace Internal
+
+namespace
+{
+
+/// @brief 线程局部驻留缓存槽数，必须为 2 的幂。
+constexpr std::size_t INTERN_CACHE_SLOTS = 32;
+
+/// @brief 进程级键驻留表。
+struct MetadataKeyTable {
+    std::shared_mutex mutex;
+    /// @brief deque 尾部追加不会移动既有记录，键视图与记录指针始终有效。
+    std::deque<Internal::MetadataKeyRecord> records;
+    std::unordered_map<std::string_view, const Internal::MetadataKeyRecord*>
+        index;
+};
+
+MetadataKeyTable& keyTable()
+{
+    static MetadataKeyTable table;
+    return table;
+}
+
+/// @brief 估算字符串超出小字符串优化后的堆缓冲区字节数。
+std::size_t stringHeapBytes(const std::string& text)
+{
+    return text.capacity() > std::string{}.capacity() ? text.capacity() + 1
+                                                      : 0;
+}
+
+}  // namespace
+
+MetadataKey MetadataKey::intern(std::string_view name)
+{
+    if ( name.empty() ) return {};
+
+    // 加载器每个物件都会写入同一组键，线程局部的直接映射缓存可以跳过锁。
+    thread_local std::array<const Internal::MetadataKeyRecord*,
+                            INTERN_CACHE_SLOTS>
+                      cache{};
+    const std::size_t slot =
+        std::hash<std::string_view>{}(name) & (INTERN_CACHE_SLOTS - 1);
+    if ( cache[slot] != nullptr && cache[slot]->name == name ) {
+        return MetadataKey(cache[slot]);
+    }
+
+    auto& table = keyTable();
+    {
+        std::shared_lock lock(table.mutex);
+        if ( auto it = table.index.find(name); it != table.index.end() ) {
+            cache[slot] = it->second;
+            return MetadataKey(it->second);
+        }
+    }
+
+    std::unique_lock lock(table.mutex);
+    if ( auto it = table.index.find(name); it != table.index.end() ) {
+        cache[slot] = it->second;
+        return MetadataKey(it->second);
+    }
+    const auto  id     = static_cast<uint32_t>(table.records.size() + 1);
+    const auto& record = table.records.emplace_back(
+        Internal::MetadataKeyRecord{ std::string(name), id });
+    table.index.emplace(record.name, &record);
+    cache[slot] = &record;
+    return MetadataKey(&record);
+}
+
+std::size_t MetadataKey::internedCount()
+{
+    auto&            table = keyTable();
+    std::shared_lock lock(table.mutex);
+    return table.records.size();
+}
+
+MetadataEntry::MetadataEntry(const MetadataEntry& other)
+    : second(other.second)
+    , m_key(other.m_key)
+    , m_cacheBits(other.m_cacheBits.load(std::memory_order_relaxed))
+    , m_cacheTag(other.m_cacheTag.load(std::memory_order_acquire))
+{
+}
+
+MetadataEntry::MetadataEntry(MetadataEntry&& other) noexcept
+    : second(std::move(other.second))
+    , m_key(other.m_key)
+    , m_cacheBits(other.m_cacheBits.load(std::memory_order_relaxed))
+    , m_cacheTag(other.m_cacheTag.load(std::memory_order_acquire))
+{
+    other.invalidateCache();
+}
+
+MetadataEntry& MetadataEntry::operator=(const MetadataEntry& other)
+{
+    if ( this == &other ) return *this;
+    second = other.second;
+    m_key  = other.m_key;
+    m_cacheBits.store(other.m_cacheBits.load(std::memory_order_relaxed),
+                      std::memory_order_relaxed);
+    m_cacheTag.store(other.m_cacheTag.load(std::memory_order_acquire),
+                     std::memory_order_release);
+    return *this;
+}
+
+MetadataEntry& MetadataEntry::operator=(MetadataEntry&& other) noexcept
+{
+    if ( this == &other ) return *this;
+    second = std::move(other.second);
+    m_key  = other.m_key;
+    m_cacheBits.store(other.m_cacheBits.load(std::memory_order_relaxed),
+                      std::memory_order_relaxed);
+    m_cacheTag.store(other.m_cacheTag.load(std::memory_order_acquire),
+                     std::memory_order_release);
+    other.invalidateCache();
+    return *this;
+}
+
+std::string& MetadataProperties::operator[](std::string_view key)
+{
+    MetadataEntry* entry = findEntry(key);
+    if ( entry == data() + m_size ) entry = &append(MetadataKey::intern(key));
+    entry->invalidateCache();
+    return entry->second;
+}
+
+std::string& MetadataProperties::operator[](MetadataKey key)
+{
+    MetadataEntry* entry = findEntry(key);
+    if ( entry == data() + m_size ) entry = &append(key);
+    entry->invalidateCache();
+    return entry->second;
+}
+
+std::string& MetadataProperties::at(std::string_view key)
+{
+    MetadataEntry* entry = findEntry(key);
+    if ( entry == data() + m_size ) {
+        throw std::out_of_range("MetadataProperties::at");
+    }
+    entry->invalidateCache();
+    return entry->second;
+}
+
+const std::string& MetadataProperties::at(std::string_view key) const
+{
+    const MetadataEntry* entry = findEntry(key);
+    if ( entry == data() + m_size ) {
+        throw std::out_of_range("MetadataProperties::at");
+    }
+    return entry->second;
+}
+
+MetadataProperties::size_type MetadataProperties::erase(std::string_view key)
+{
+    const MetadataEntry* entry = findEntry(key);
+    if ( entry == data() + m_size ) return 0;
+    erase(const_iterator(entry));
+    return 1;
+}
+
+MetadataProperties::iterator MetadataProperties::erase(const_iterator pos)
+{
+    MetadataEntry* first = data();
+    const auto     index = static_cast<std::size_t>(pos.entry() - first);
+    // 保持插入顺序：后续条目整体前移一位。
+    std::move(first + index + 1, first + m_size, first + index);
+    --m_size;
+    if ( m_spill.empty() ) {
+        m_inline[m_size] = MetadataEntry{};
+    } else {
+        m_spill.pop_back();
+    }
+    return iterator(data() + index);
+}
+
+void MetadataProperties::clear()
+{
+    if ( m_spill.empty() ) {
+        for ( std::size_t i = 0; i < m_size; ++i ) {
+            m_inline[i] = MetadataEntry{};
+        }
+    }
+    m_spill.clear();
+    m_spill.shrink_to_fit();
+    m_size = 0;
+}
+
+MetadataEntry& MetadataProperties::append(MetadataKey key)
+{
+    if ( m_spill.empty() && m_size < INLINE_CAPACITY ) {
+        m_inline[m_size] = MetadataEntry(key, {});
+        return m_inline[m_size++];
+    }
+    if ( m_spill.empty() ) {
+        // 首次溢出：内联条目整体迁移，之后只使用溢出数组。
+        m_spill.reserve(INLINE_CAPACITY * 2);
+        for ( auto& entry : m_inline ) {
+            m_spill.push_back(std::move(entry));
+            entry = MetadataEntry{};
+        }
+    }
+    ++m_size;
+    return m_spill.emplace_back(key, std::string{});
+}
+
+std::size_t MetadataProperties::heapBytes() const
+{
+    std::size_t bytes = m_spill.capacity() * sizeof(MetadataEntry);
+    for ( const auto& entry : *this ) {
+        bytes += stringHeapBytes(entry.second);
+    }
+    return bytes;
+}
+
+bool operator==(const MetadataProperties& lhs, const MetadataProperties& rhs)
+{
+    if ( lhs.m_size != rhs.m_size ) return false;
+    for ( const auto& entry : lhs ) {
+        const MetadataEntry* other = rhs.findEntry(entry.keyHandle());
+        if ( other == rhs.data() + rhs.m_size ||
+             other->second != entry.second ) {
+            return false;
+        }
+    }
+    return true;
+}
+
+}  // namespace MMM
@@ -0,0 +1,122 @@
+#include "mmm/ParallelExecutor.h"
+
+#include <algorithm>
+#include <atomic>
+#include <exception>
+#include <memory>
+#include <mutex>
+#include <utility>
+
+namespace MMM
+{
+
+namespace
+{
+
+/// @brief 进程级执行器槽。
+struct ExecutorSlot {
+    std::mutex                              mutex;
+    std::shared_ptr<const ParallelExecutor> executor;
+};
+
+ExecutorSlot& executorSlot()
+{
+    static ExecutorSlot slot;
+    return slot;
+}
+
+/// @brief 当前执行器；未注入时返回空指针。
+std::shared_ptr<const ParallelExecutor> currentExecutor()
+{
+    auto&                       slot = executorSlot();
+    std::lock_guard<std::mutex> lock(slot.mutex);
+    return slot.executor;
+}
+
+/// @brief 任务领取状态，由调用线程与后台任务共享。
+/// @details 后台任务可能在全部任务领取完毕、调用方返回之后才开始执行；
+/// 此时只读取计数后立即退出，不会再调用 run 访问调用方的状态。
+struct Dispatch {
+    std::size_t                      taskCount{ 0 };
+    std::function<void(std::size_t)> run;
+    std::atomic<std::size_t>         nextTask{ 0 };
+    std::atomic<std::size_t>         pendingTasks{ 0 };
+};
+
+/// @brief 循环领取并执行任务，直到全部任务都被领取。
+/// @warning 调用线程与后台任务共用；最后一个完成的任务唤醒调用线程。
+void drain(Dispatch& dispatch)
+{
+    for ( ;; ) {
+        const std::size_t index =
+            dispatch.nextTask.fetch_add(1, std::memory_order_acquire);
+        if ( index >= dispatch.taskCount ) return;
+        dispatch.run(index);
+        if ( dispatch.pendingTasks.fetch_sub(1, std::memory_order_acq_rel) ==
+             1 ) {
+            dispatch.pendingTasks.notify_all();
+        }
+    }
+}
+
+}  // namespace
+
+void setParallelExecutor(ParallelExecutor executor)
+{
+    std::shared_ptr<const ParallelExecutor> installed;
+    if ( executor.submit && executor.concurrency > 1 ) {
+        installed =
+            std::make_shared<const ParallelExecutor>(std::move(executor));
+    }
+    auto&                       slot = executorSlot();
+    std::lock_guard<std::mutex> lock(slot.mutex);
+    slot.executor = std::move(installed);
+}
+
+std::size_t parallelConcurrency()
+{
+    const auto executor = currentExecutor();
+    return executor ? executor->concurrency : 1;
+}
+
+void parallelFor(std::size_t                             taskCount,
+                 const std::function<void(std::size_t)>& task,
+                 std::size_t                             maxThreads)
+{
+    const auto executor = currentExecutor();
+    std::size_t threads = executor ? executor->concurrency : 1;
+    if ( maxThreads > 0 ) threads = std::min(threads, maxThreads);
+    threads = std::min(threads, taskCount);
+    if ( threads <= 1 ) {
+        for ( std::size_t index = 0; index < taskCount; ++index ) task(index);
+        return;
+    }
+
+    std::exception_ptr failure;
+    std::mutex         failureMutex;
+    auto               dispatch = std::make_shared<Dispatch>();
+    dispatch->taskCount         = taskCount;
+    dispatch->run               = [&](std::size_t index) {
+        try {
+            task(index);
+        } catch ( ... ) {
+            std::lock_guard<std::mutex> lock(failureMutex);
+            if ( !failure ) failure = std::current_exception();
+        }
+    };
+    dispatch->pendingTasks.store(taskCount, std::memory_order_relaxed);
+
+    for ( std::size_t helper = 1; helper < threads; ++helper ) {
+        executor->submit([dispatch]() { drain(*dispatch); });
+    }
+    drain(*dispatch);
+    auto& pendingTasks = dispatch->pendingTasks;
+    for ( auto pending = pendingTasks.load(std::memory_order_acquire);
+          pending != 0;
+          pending = pendingTasks.load(std::memory_order_acquire) ) {
+        pendingTasks.wait(pending, std::memory_order_acquire);
+    }
+    if ( failure ) std::rethrow_exception(failure);
+}
+
+}  // namespace MMM
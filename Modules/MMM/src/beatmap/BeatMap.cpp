@@ -11,17 +11,19 @@
 
 #include "config/Utf8Path.h"
 #include "log/colorful-log.h"
+#include "mmm/beatmap/BeatmapCache.h"
 #include <filesystem>
 #include <fstream>
 
 namespace MMM
 {
 
-/**
- * @brief 从文件加载谱面
- * @param mapFilePath 谱面文件路径
- */
-BeatMap BeatMap::loadFromFile(std::filesystem::path mapFilePath)
+namespace
+{
+
+/// @brief 按扩展名分派到具体格式的解析器，不经过缓存。
+/// @param headerOnly 只解析物件之前的头部字段。
+BeatMap readMapFile(const std::filesystem::path& mapFilePath, bool headerOnly)
 {
     std::error_code ec;
     if ( !std::filesystem::exists(mapFilePath, ec) ) {
@@ -35,7 +37,7 @@ BeatMap BeatMap::loadFromFile(std::filesystem::path mapFilePath)
             std::string firstLine;
             if ( std::getline(ifs, firstLine) ) {
                 if ( firstLine.find("osu file format") != std::string::npos ) {
-                    return loadOSUMap(mapFilePath);
+                    return loadOSUMap(mapFilePath, headerOnly);
                 }
             }
         }
@@ -46,21 +48,46 @@ BeatMap BeatMap::loadFromFile(std::filesystem::path mapFilePath)
     }
     std::string mapFileExtention = Config::pathToUtf8(mapFilePath.extension());
     if ( mapFileExtention == ".osu" ) {
-        return loadOSUMap(mapFilePath);
+        return loadOSUMap(mapFilePath, headerOnly);
     }
     if ( mapFileExtention == ".mc" ) {
-        return loadMalodyMap(mapFilePath);
+        return loadMalodyMap(mapFilePath, headerOnly);
     }
     if ( mapFileExtention == ".imd" ) {
-        return loadRMMap(mapFilePath);
+        return loadRMMap(mapFilePath, headerOnly);
     }
     if ( mapFileExtention == ".mmm" ) {
-        return loadMMMMap(mapFilePath);
+        return loadMMMMap(mapFilePath, headerOnly);
     }
     XWARN("Unsupport map file type: {}", mapFileExtention);
     return {};
 }
 
+/// @brief 完整解析谱面文件，作为缓存缺失时的解析器。
+BeatMap parseMapFile(const std::filesystem::path& mapFilePath)
+{
+    return readMapFile(mapFilePath, false);
+}
+
+}  // namespace
+
+/**
+ * @brief 从文件加载谱面
+ * @param mapFilePath 谱面文件路径
+ */
+BeatMap BeatMap::loadFromFile(std::filesystem::path mapFilePath)
+{
+    if ( auto cache = BeatmapCache::active() ) {
+        return cache->load(mapFilePath, parseMapFile);
+    }
+    return parseMapFile(mapFilePath);
+}
+
+BeatMap BeatMap::probeHeader(std::filesystem::path mapFilePath)
+{
+    return readMapFile(mapFilePath, true);
+}
+
 bool BeatMap::saveToFile(std::filesystem::path mapFilePath) const
 {
     std::string mapFileExtention = Config::pathToUtf8(mapFilePath.extension());
@@ -82,37 +109,28 @@ bool BeatMap::saveToFile(std::filesystem::path mapFilePath) const
 
 void BeatMap::sync()
 {
-    m_allNotes.clear();
+    std::vector<std::reference_wrapper<Note>> refs;
+    refs.reserve(m_noteData.notes.size() + m_noteData.holds.size() +
+                 m_noteData.flicks.size() + m_noteData.polylines.size());
     // 添加所有普通物件
     for ( auto& note : m_noteData.notes ) {
-        if ( !note.m_isSubNote ) m_allNotes.push_back(std::ref(note));
+        if ( !note.m_isSubNote ) refs.push_back(std::ref(note));
     }
     // 添加所有长条物件
     for ( auto& hold : m_noteData.holds ) {
-        if ( !hold.m_isSubNote ) m_allNotes.push_back(std::ref(hold));
+        if ( !hold.m_isSubNote ) refs.push_back(std::ref(hold));
     }
     // 添加所有滑键物件
     for ( auto& flick : m_noteData.flicks ) {
-        if ( !flick.m_isSubNote ) m_allNotes.push_back(std::ref(flick));
+        if ( !flick.m_isSubNote ) refs.push_back(std::ref(flick));
     }
     // 添加所有折线物件
     for ( auto& poly : m_noteData.polylines ) {
-        m_allNotes.push_back(std::ref(poly));
+        refs.push_back(std::ref(poly));
     }
 
     // 确定性排序：时间戳为主键，轨道和类型为次键
-    std::stable_sort(m_allNotes.begin(),
-                     m_allNotes.end(),
-                     [](const std::reference_wrapper<Note>& a_ref,
-                        const std::reference_wrapper<Note>& b_ref) {
-                         const Note& a = a_ref.get();
-                         const Note& b = b_ref.get();
-                         if ( std::abs(a.m_timestamp - b.m_timestamp) > 1e-4 )
-                             return a.m_timestamp < b.m_timestamp;
-                         if ( a.m_track != b.m_track )
-                             return a.m_track < b.m_track;
-                         return a.m_type < b.m_type;
-                     });
+    m_allNotes.assign(std::move(refs));
 }
 
 BeatMap::BeatMap() {}
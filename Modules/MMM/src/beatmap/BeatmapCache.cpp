@@ -0,0 +1,500 @@
+#include "mmm/beatmap/BeatmapCache.h"
+
+#include "BeatmapCacheCodec.h"
+#include "ContentHash.h"
+#include "MappedFile.h"
+
+#include "config/Utf8Path.h"
+#include "log/colorful-log.h"
+#include <algorithm>
+#include <array>
+#include <chrono>
+#include <cstddef>
+#include <cstdlib>
+#include <cstring>
+#include <fmt/format.h>
+#include <fstream>
+#include <functional>
+#include <mutex>
+#include <string>
+#include <string_view>
+#include <system_error>
+#include <thread>
+#include <type_traits>
+#include <vector>
+
+namespace MMM
+{
+namespace
+{
+
+/// @brief 条目文件魔数。
+constexpr std::array<char, 8> ENTRY_MAGIC{ 'M', 'M', 'M', 'B',
+                                           'C', 'A', 'C', 'H' };
+
+/// @brief 字节序标记；在另一种字节序的机器上读取时不相等。
+constexpr uint32_t BYTE_ORDER_MARK = 0x01020304U;
+
+/// @brief 写入中的临时条目扩展名。
+constexpr std::string_view TEMP_EXTENSION = ".tmp";
+
+/// @brief 条目头部，其后依次是条目键与负载。
+struct EntryHeader {
+    std::array<char, 8> magic;
+    uint32_t            formatVersion;
+    uint32_t            byteOrderMark;
+    uint64_t            sourceSize;
+    int64_t             sourceWriteTime;
+    int64_t             directoryWriteTime;
+    uint64_t            contentHash;
+    uint64_t            keyBytes;
+    uint64_t            payloadBytes;
+};
+static_assert(std::is_trivially_copyable_v<EntryHeader>);
+
+/// @brief 条目键：调用方传入的路径与其绝对路径。
+/// @details 加载器会把传入路径原样写入 map_path 与诊断路径，两者都相同时
+/// 解析结果才能复用。
+std::string makeEntryKey(const std::filesystem::path& mapPath)
+{
+    std::error_code ec;
+    const auto      absolutePath = std::filesystem::absolute(mapPath, ec);
+    std::string     key          = Config::pathToUtf8(mapPath);
+    key.push_back('\0');
+    key += Config::pathToUtf8(ec ? mapPath : absolutePath);
+    return key;
+}
+
+/// @brief 条目文件名：条目键的哈希。
+std::string entryFileName(const std::string& key)
+{
+    return fmt::format("{:016x}{}",
+                       Internal::hashContent(key),
+                       BeatmapCache::ENTRY_EXTENSION);
+}
+
+/// @brief 加载结果是否依赖同目录下的其他文件。
+/// @details .imd 会探测同名音频与封面，旧版 .mmm 会探测同名 .mc；这些
+/// 文件的增删会改变所在目录的修改时间。
+bool dependsOnSiblingFiles(const std::filesystem::path& mapPath)
+{
+    const std::string extension = Config::pathToUtf8(mapPath.extension());
+    return extension == ".imd" || extension == ".mmm";
+}
+
+int64_t writeTimeTicks(std::filesystem::file_time_type time)
+{
+    return static_cast<int64_t>(time.time_since_epoch().count());
+}
+
+/// @brief 条目或写入中的临时条目；淘汰与清空只处理这两类文件。
+bool isCacheFile(const std::filesystem::path& path)
+{
+    const std::string extension = Config::pathToUtf8(path.extension());
+    return extension == BeatmapCache::ENTRY_EXTENSION ||
+           extension == TEMP_EXTENSION;
+}
+
+/// @brief 把条目修改时间设为当前时间，作为最近访问时间参与淘汰排序。
+void touchEntry(const std::filesystem::path& file)
+{
+    std::error_code ec;
+    std::filesystem::last_write_time(
+        file, std::filesystem::file_time_type::clock::now(), ec);
+}
+
+/// @brief 同一进程内并发写入同一条目时区分临时文件。
+std::string makeTempSuffix()
+{
+    static std::atomic<uint64_t> sequence{ 0 };
+    const auto                   threadHash =
+        std::hash<std::thread::id>{}(std::this_thread::get_id());
+    const auto now = std::chrono::steady_clock::now().time_since_epoch();
+    return fmt::format(".{:x}.{:x}{}",
+                       threadHash ^ static_cast<uint64_t>(now.count()),
+                       sequence.fetch_add(1, std::memory_order_relaxed),
+                       TEMP_EXTENSION);
+}
+
+bool disabledByEnvironment()
+{
+    const char* value = std::getenv("MMM_DISABLE_BEATMAP_CACHE");
+    return value != nullptr && *value != '\0' && std::string_view(value) != "0";
+}
+
+std::atomic<bool>& enabledFlag()
+{
+    static std::atomic<bool> enabled{ true };
+    return enabled;
+}
+
+/// @brief 进程级当前缓存槽。
+struct ActiveCacheSlot {
+    std::mutex                    mutex;
+    std::shared_ptr<BeatmapCache> cache;
+};
+
+ActiveCacheSlot& activeSlot()
+{
+    static ActiveCacheSlot slot;
+    return slot;
+}
+
+}  // namespace
+
+/// @brief 源文件状态快照；解析前采集，写入前再次比对。
+struct BeatmapCache::SourceStamp {
+    uint64_t size{ 0 };
+    int64_t  writeTime{ 0 };
+    int64_t  directoryWriteTime{ 0 };
+
+    bool operator==(const SourceStamp&) const = default;
+
+    static std::optional<SourceStamp> read(
+        const std::filesystem::path& mapPath)
+    {
+        std::error_code ec;
+        SourceStamp     stamp;
+        stamp.size = std::filesystem::file_size(mapPath, ec);
+        if ( ec ) return std::nullopt;
+        stamp.writeTime =
+            writeTimeTicks(std::filesystem::last_write_time(mapPath, ec));
+        if ( ec ) return std::nullopt;
+        if ( dependsOnSiblingFiles(mapPath) ) {
+            const auto directory =
+                std::filesystem::absolute(mapPath, ec).parent_path();
+            if ( ec ) return std::nullopt;
+            stamp.directoryWriteTime =
+                writeTimeTicks(std::filesystem::last_write_time(directory, ec));
+            if ( ec ) return std::nullopt;
+        }
+        return stamp;
+    }
+};
+
+BeatmapCache::BeatmapCache(std::filesystem::path directory,
+                           BeatmapCacheOptions   options)
+    : m_directory(std::move(directory)), m_options(options)
+{
+}
+
+BeatMap BeatmapCache::load(const std::filesystem::path& mapPath,
+                           const Parser&                parse)
+{
+    if ( !isEnabled() ) return parse(mapPath);
+    const auto stamp = SourceStamp::read(mapPath);
+    if ( !stamp ) return parse(mapPath);
+
+    if ( auto cached = findWithStamp(mapPath, *stamp) ) {
+        m_hits.fetch_add(1, std::memory_order_relaxed);
+        return std::move(*cached);
+    }
+    m_misses.fetch_add(1, std::memory_order_relaxed);
+
+    BeatMap beatMap = parse(mapPath);
+    // 解析失败与空谱面无法区分，两者都不写入缓存。
+    if ( !beatMap.m_allNotes.empty() || !beatMap.m_timings.empty() ) {
+        storeWithStamp(mapPath, *stamp, beatMap);
+    }
+    return beatMap;
+}
+
+std::optional<BeatMap> BeatmapCache::find(const std::filesystem::path& mapPath)
+{
+    if ( !isEnabled() ) return std::nullopt;
+    const auto stamp = SourceStamp::read(mapPath);
+    auto cached = stamp ? findWithStamp(mapPath, *stamp) : std::nullopt;
+    (cached ? m_hits : m_misses).fetch_add(1, std::memory_order_relaxed);
+    return cached;
+}
+
+bool BeatmapCache::store(const std::filesystem::path& mapPath,
+                         const BeatMap&               beatMap)
+{
+    if ( !isEnabled() ) return false;
+    const auto stamp = SourceStamp::read(mapPath);
+    return stamp && storeWithStamp(mapPath, *stamp, beatMap);
+}
+
+std::filesystem::path BeatmapCache::entryPath(
+    const std::filesystem::path& mapPath) const
+{
+    return m_directory / entryFileName(makeEntryKey(mapPath));
+}
+
+std::optional<BeatMap> BeatmapCache::findWithStamp(
+    const std::filesystem::path& mapPath, const SourceStamp& stamp)
+{
+    const std::string           key  = makeEntryKey(mapPath);
+    const std::filesystem::path file = m_directory / entryFileName(key);
+
+    Internal::MappedFile entry;
+    if ( !entry.open(file) ) return std::nullopt;
+    const std::string_view bytes = entry.bytes();
+
+    // 头部与键不符的条目（旧版本、哈希碰撞、源文件已变化）直接视为缺失，
+    // 随后的写入会覆盖它。
+    EntryHeader header{};
+    if ( bytes.size() < sizeof(header) ) return std::nullopt;
+    std::memcpy(&header, bytes.data(), sizeof(header));
+    const std::size_t bodyBytes = bytes.size() - sizeof(header);
+    if ( header.magic != ENTRY_MAGIC ||
+         header.formatVersion != FORMAT_VERSION ||
+         header.byteOrderMark != BYTE_ORDER_MARK ||
+         header.keyBytes > bodyBytes ||
+         header.payloadBytes != bodyBytes - header.keyBytes ||
+         bytes.substr(sizeof(header), header.keyBytes) != key ) {
+        return std::nullopt;
+    }
+    if ( header.sourceSize != stamp.size ||
+         header.directoryWriteTime != stamp.directoryWriteTime ) {
+        return std::nullopt;
+    }
+
+    // 只有修改时间变化（复制、检出、touch）时才读取源文件比对内容哈希。
+    const bool writeTimeChanged = header.sourceWriteTime != stamp.writeTime;
+    if ( writeTimeChanged ) {
+        Internal::MappedFile source;
+        if ( !source.open(mapPath) ||
+             Internal::hashContent(source.bytes()) != header.contentHash ) {
+            return std::nullopt;
+        }
+    }
+
+    BeatMap beatMap;
+    if ( !Internal::decodeBeatmapPayload(
+             bytes.substr(sizeof(header) + header.keyBytes), beatMap) ) {
+        XWARN("Discarding corrupted beatmap cache entry: {}",
+              Config::pathToUtf8(file));
+        entry.close();
+        std::error_code ec;
+        if ( std::filesystem::remove(file, ec) ) {
+            std::lock_guard lock(m_usageMutex);
+            if ( m_usageKnown && m_usageEntries > 0 ) {
+                m_usageBytes -= std::min<uint64_t>(m_usageBytes, bytes.size());
+                --m_usageEntries;
+            }
+        }
+        return std::nullopt;
+    }
+    entry.close();
+
+    if ( writeTimeChanged ) {
+        // 内容未变，记下新的修改时间，下次命中不再计算哈希。
+        std::fstream patch(file,
+                           std::ios::in | std::ios::out | std::ios::binary);
+        if ( patch.is_open() ) {
+            patch.seekp(offsetof(EntryHeader, sourceWriteTime));
+            patch.write(reinterpret_cast<const char*>(&stamp.writeTime),
+                        sizeof(stamp.writeTime));
+        }
+    }
+    touchEntry(file);
+    return beatMap;
+}
+
+bool BeatmapCache::storeWithStamp(const std::filesystem::path& mapPath,
+                                  const SourceStamp&           stamp,
+                                  const BeatMap&               beatMap)
+{
+    std::string payload;
+    if ( !Internal::encodeBeatmapPayload(beatMap, payload) ) {
+        XWARN("Beatmap has dangling note references, not cached: {}",
+              Config::pathToUtf8(mapPath));
+        return false;
+    }
+
+    const std::string key = makeEntryKey(mapPath);
+    EntryHeader       header{};
+    header.magic              = ENTRY_MAGIC;
+    header.formatVersion      = FORMAT_VERSION;
+    header.byteOrderMark      = BYTE_ORDER_MARK;
+    header.sourceSize         = stamp.size;
+    header.sourceWriteTime    = stamp.writeTime;
+    header.directoryWriteTime = stamp.directoryWriteTime;
+    header.keyBytes           = key.size();
+    header.payloadBytes       = payload.size();
+    {
+        Internal::MappedFile source;
+        if ( !source.open(mapPath) || source.bytes().size() != stamp.size ) {
+            return false;
+        }
+        header.contentHash = Internal::hashContent(source.bytes());
+    }
+    // 解析期间源文件被改写时放弃写入，避免把旧结果记在新内容名下。
+    if ( SourceStamp::read(mapPath) != stamp ) return false;
+
+    std::error_code ec;
+    std::filesystem::create_directories(m_directory, ec);
+    if ( ec ) return false;
+
+    const std::filesystem::path file     = m_directory / entryFileName(key);
+    std::filesystem::path       tempFile = file;
+    tempFile += makeTempSuffix();
+    {
+        std::ofstream out(tempFile, std::ios::binary | std::ios::trunc);
+        if ( !out.is_open() ) return false;
+        out.write(reinterpret_cast<const char*>(&header), sizeof(header));
+        out.write(key.data(), static_cast<std::streamsize>(key.size()));
+        out.write(payload.data(),
+                  static_cast<std::streamsize>(payload.size()));
+        if ( !out.good() ) {
+            out.close();
+            std::filesystem::remove(tempFile, ec);
+            return false;
+        }
+    }
+    // 被替换条目的大小用于维护目录占用估计。
+    std::error_code sizeError;
+    const uint64_t  previousBytes = std::filesystem::file_size(file, sizeError);
+    std::filesystem::rename(tempFile, file, ec);
+    if ( ec ) {
+        // Windows 上目标条目正被其他加载映射时无法替换，放弃本次写入。
+        std::error_code removeError;
+        std::filesystem::remove(tempFile, removeError);
+        return false;
+    }
+
+    m_stores.fetch_add(1, std::memory_order_relaxed);
+    accountStore(sizeof(header) + key.size() + payload.size(),
+                 sizeError ? std::nullopt : std::optional(previousBytes));
+    return true;
+}
+
+void BeatmapCache::accountStore(std::uint64_t                entryBytes,
+                                std::optional<std::uint64_t> replacedBytes)
+{
+    {
+        std::lock_guard lock(m_usageMutex);
+        if ( m_usageKnown ) {
+            m_usageBytes += entryBytes;
+            if ( replacedBytes ) {
+                m_usageBytes -= std::min(m_usageBytes, *replacedBytes);
+            } else {
+                ++m_usageEntries;
+            }
+            if ( m_usageBytes <= m_options.maxBytes &&
+                 m_usageEntries <= m_options.maxEntries ) {
+                return;
+            }
+        }
+    }
+    // 首次写入时扫描一次目录建立估计；此后只在估计超出限制时扫描。
+    trim();
+}
+
+void BeatmapCache::resetUsage(std::uint64_t bytes, std::size_t entries)
+{
+    std::lock_guard lock(m_usageMutex);
+    m_usageKnown   = true;
+    m_usageBytes   = bytes;
+    m_usageEntries = entries;
+}
+
+void BeatmapCache::trim()
+{
+    struct Entry {
+        std::filesystem::path           path;
+        uint64_t                        bytes;
+        std::filesystem::file_time_type lastAccess;
+    };
+    std::vector<Entry> entries;
+    uint64_t           totalBytes = 0;
+
+    std::error_code ec;
+    for ( std::filesystem::directory_iterator it(m_directory, ec), end;
+          !ec && it != end;
+          it.increment(ec) ) {
+        std::error_code entryError;
+        if ( !it->is_regular_file(entryError) || !isCacheFile(it->path()) ) {
+            continue;
+        }
+        Entry entry{ it->path(),
+                     it->file_size(entryError),
+                     it->last_write_time(entryError) };
+        if ( entryError ) continue;
+        totalBytes += entry.bytes;
+        entries.push_back(std::move(entry));
+    }
+    if ( totalBytes <= m_options.maxBytes &&
+         entries.size() <= m_options.maxEntries ) {
+        resetUsage(totalBytes, entries.size());
+        return;
+    }
+
+    // 淘汰到限制的 90%：容量边界上的连续写入不必每次都重新扫描目录。
+    const uint64_t    targetBytes =
+        m_options.maxBytes - m_options.maxBytes / 10;
+    const std::size_t targetEntries =
+        m_options.maxEntries - m_options.maxEntries / 10;
+
+    // 最久未访问的条目先淘汰；写入中的临时文件总是最新的。
+    std::sort(entries.begin(),
+              entries.end(),
+              [](const Entry& lhs, const Entry& rhs) {
+                  return lhs.lastAccess < rhs.lastAccess;
+              });
+    std::size_t remaining = entries.size();
+    for ( const Entry& entry : entries ) {
+        if ( totalBytes <= targetBytes && remaining <= targetEntries ) break;
+        std::error_code removeError;
+        if ( std::filesystem::remove(entry.path, removeError) ) {
+            totalBytes -= entry.bytes;
+            --remaining;
+            m_evictions.fetch_add(1, std::memory_order_relaxed);
+        }
+    }
+    resetUsage(totalBytes, remaining);
+}
+
+void BeatmapCache::clear()
+{
+    std::vector<std::filesystem::path> files;
+    std::error_code                    ec;
+    for ( std::filesystem::directory_iterator it(m_directory, ec), end;
+          !ec && it != end;
+          it.increment(ec) ) {
+        if ( isCacheFile(it->path()) ) files.push_back(it->path());
+    }
+    for ( const auto& file : files ) {
+        std::error_code removeError;
+        std::filesystem::remove(file, removeError);
+    }
+    resetUsage(0, 0);
+}
+
+BeatmapCacheStatistics BeatmapCache::statistics() const
+{
+    return { m_hits.load(std::memory_order_relaxed),
+             m_misses.load(std::memory_order_relaxed),
+             m_stores.load(std::memory_order_relaxed),
+             m_evictions.load(std::memory_order_relaxed) };
+}
+
+void BeatmapCache::setActive(std::shared_ptr<BeatmapCache> cache)
+{
+    auto&           slot = activeSlot();
+    std::lock_guard lock(slot.mutex);
+    slot.cache = std::move(cache);
+}
+
+std::shared_ptr<BeatmapCache> BeatmapCache::active()
+{
+    if ( !isEnabled() ) return nullptr;
+    auto&           slot = activeSlot();
+    std::lock_guard lock(slot.mutex);
+    return slot.cache;
+}
+
+void BeatmapCache::setEnabled(bool enabled)
+{
+    enabledFlag().store(enabled, std::memory_order_relaxed);
+}
+
+bool BeatmapCache::isEnabled()
+{
+    static const bool disabled = disabledByEnvironment();
+    return !disabled && enabledFlag().load(std::memory_order_relaxed);
+}
+
+}  // namespace MMM
@@ -0,0 +1,604 @@
+#include "BeatmapCacheCodec.h"
+
+#include "config/Utf8Path.h"
+#include "mmm/note/Flick.h"
+#include "mmm/note/Hold.h"
+#include "mmm/note/Polyline.h"
+
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <deque>
+#include <functional>
+#include <limits>
+#include <optional>
+#include <type_traits>
+#include <unordered_map>
+
+namespace MMM::Internal
+{
+namespace
+{
+
+/// @brief 单个物件编码后的最小字节数，用于拒绝虚高的元素计数。
+constexpr std::size_t MIN_NOTE_BYTES = sizeof(uint8_t) + sizeof(double) +
+                                       sizeof(uint32_t) + 2 * sizeof(uint8_t) +
+                                       3 * sizeof(uint32_t);
+
+/// @brief 物件引用编码后的字节数：类型与下标。
+constexpr std::size_t NOTE_REF_BYTES = sizeof(uint8_t) + sizeof(uint32_t);
+
+/// @brief 字符串编码后的最小字节数：仅长度前缀。
+constexpr std::size_t MIN_STRING_BYTES = sizeof(uint32_t);
+
+/// @brief 顺序追加的负载写入器。
+class PayloadWriter
+{
+public:
+    explicit PayloadWriter(std::string& out) : m_out(out) {}
+
+    template<typename T> void pod(T value)
+    {
+        static_assert(std::is_trivially_copyable_v<T>);
+        m_out.append(reinterpret_cast<const char*>(&value), sizeof(T));
+    }
+
+    void flag(bool value) { pod(static_cast<uint8_t>(value ? 1 : 0)); }
+
+    template<typename E> void enumeration(E value)
+    {
+        pod(static_cast<uint8_t>(value));
+    }
+
+    void count(std::size_t value)
+    {
+        if ( value > std::numeric_limits<uint32_t>::max() ) m_ok = false;
+        pod(static_cast<uint32_t>(value));
+    }
+
+    void string(std::string_view text)
+    {
+        count(text.size());
+        m_out.append(text);
+    }
+
+    void path(const std::filesystem::path& value)
+    {
+        string(Config::pathToUtf8(value));
+    }
+
+    /// @brief 标记负载无法编码。
+    void fail() { m_ok = false; }
+
+    [[nodiscard]] bool ok() const { return m_ok; }
+
+private:
+    std::string& m_out;
+    bool         m_ok{ true };
+};
+
+/// @brief 带边界检查的负载读取器；任一读取越界后 ok() 永久为 false。
+class PayloadReader
+{
+public:
+    explicit PayloadReader(std::string_view payload)
+        : m_cursor(payload.data()), m_end(payload.data() + payload.size())
+    {
+    }
+
+    template<typename T> T pod()
+    {
+        static_assert(std::is_trivially_copyable_v<T>);
+        T value{};
+        if ( remaining() < sizeof(T) ) {
+            m_ok = false;
+            return value;
+        }
+        std::memcpy(&value, m_cursor, sizeof(T));
+        m_cursor += sizeof(T);
+        return value;
+    }
+
+    bool flag() { return pod<uint8_t>() != 0; }
+
+    /// @brief 读取枚举值，超出 [0, last] 时判定负载损坏。
+    template<typename E> E enumeration(E last)
+    {
+        const auto raw = pod<uint8_t>();
+        if ( raw > static_cast<uint8_t>(last) ) {
+            m_ok = false;
+            return E{};
+        }
+        return static_cast<E>(raw);
+    }
+
+    /// @brief 读取元素个数；每个元素至少占 minBytes 字节。
+    std::size_t count(std::size_t minBytes)
+    {
+        const std::size_t value = pod<uint32_t>();
+        if ( !m_ok || (minBytes > 0 && value > remaining() / minBytes) ) {
+            m_ok = false;
+            return 0;
+        }
+        return value;
+    }
+
+    std::string_view stringView()
+    {
+        const std::size_t size = count(1);
+        const char*       text = m_cursor;
+        m_cursor += size;
+        return { text, size };
+    }
+
+    std::string string() { return std::string(stringView()); }
+
+    std::filesystem::path path() { return Config::utf8ToPath(string()); }
+
+    /// @brief 标记负载损坏。
+    void fail() { m_ok = false; }
+
+    [[nodiscard]] bool ok() const { return m_ok; }
+
+    [[nodiscard]] bool atEnd() const { return m_cursor == m_end; }
+
+private:
+    [[nodiscard]] std::size_t remaining() const
+    {
+        return static_cast<std::size_t>(m_end - m_cursor);
+    }
+
+    const char* m_cursor;
+    const char* m_end;
+    bool        m_ok{ true };
+};
+
+/// @brief 物件地址到“类型 + 容器下标”的反查表，仅编码时使用。
+class NoteRefIndex
+{
+public:
+    explicit NoteRefIndex(const NoteData& data)
+    {
+        m_refs.reserve(data.notes.size() + data.holds.size() +
+                       data.flicks.size() + data.polylines.size());
+        add(data.notes, NoteType::NOTE);
+        add(data.holds, NoteType::HOLD);
+        add(data.flicks, NoteType::FLICK);
+        add(data.polylines, NoteType::POLYLINE);
+    }
+
+    /// @brief 写入物件引用；物件不属于本谱面时标记编码失败。
+    void write(PayloadWriter& writer, const Note& note) const
+    {
+        const auto it = m_refs.find(&note);
+        if ( it == m_refs.end() ) {
+            writer.fail();
+            return;
+        }
+        writer.enumeration(it->second.first);
+        writer.pod(it->second.second);
+    }
+
+private:
+    template<typename T>
+    void add(const std::deque<T>& notes, NoteType type)
+    {
+        uint32_t index = 0;
+        for ( const T& note : notes ) {
+            m_refs.emplace(&note, std::pair{ type, index++ });
+        }
+    }
+
+    std::unordered_map<const Note*, std::pair<NoteType, uint32_t>> m_refs;
+};
+
+/// @brief 按类型与下标解析物件引用；下标越界时返回空指针。
+Note* resolveNoteRef(NoteData& data, NoteType type, uint32_t index)
+{
+    switch ( type ) {
+    case NoteType::NOTE:
+        return index < data.notes.size() ? &data.notes[index] : nullptr;
+    case NoteType::HOLD:
+        return index < data.holds.size() ? &data.holds[index] : nullptr;
+    case NoteType::FLICK:
+        return index < data.flicks.size() ? &data.flicks[index] : nullptr;
+    case NoteType::POLYLINE:
+        return index < data.polylines.size() ? &data.polylines[index]
+                                             : nullptr;
+    }
+    return nullptr;
+}
+
+/// @brief 读取物件引用并要求其类型为 expected（为空时不限类型）。
+Note* readNoteRef(PayloadReader& reader, NoteData& data,
+                  std::optional<NoteType> expected = std::nullopt)
+{
+    const NoteType type  = reader.enumeration(NoteType::POLYLINE);
+    const auto     index = reader.pod<uint32_t>();
+    Note*          note  = nullptr;
+    if ( reader.ok() && (!expected || *expected == type) ) {
+        note = resolveNoteRef(data, type, index);
+    }
+    if ( note == nullptr ) reader.fail();
+    return note;
+}
+
+template<typename Source>
+void writeTable(PayloadWriter& writer, const MetadataTable<Source>& table)
+{
+    writer.count(table.size());
+    for ( const auto& [source, properties] : table ) {
+        writer.enumeration(source);
+        writer.count(properties.size());
+        for ( const auto& [key, value] : properties ) {
+            writer.string(key);
+            writer.string(value);
+        }
+    }
+}
+
+template<typename Source>
+void readTable(PayloadReader& reader, MetadataTable<Source>& table,
+               Source last)
+{
+    const std::size_t sources =
+        reader.count(sizeof(uint8_t) + sizeof(uint32_t));
+    for ( std::size_t i = 0; i < sources && reader.ok(); ++i ) {
+        const Source source  = reader.enumeration(last);
+        const auto   entries = reader.count(2 * MIN_STRING_BYTES);
+        if ( !reader.ok() ) return;
+        // 与加载器相同：来源一旦出现即存在，即使属性表为空。
+        MetadataProperties& properties = table[source];
+        for ( std::size_t j = 0; j < entries && reader.ok(); ++j ) {
+            const std::string_view key   = reader.stringView();
+            std::string            value = reader.string();
+            if ( reader.ok() ) properties[key] = std::move(value);
+        }
+    }
+}
+
+void writeNote(PayloadWriter& writer, const Note& note)
+{
+    writer.enumeration(note.m_type);
+    writer.pod(note.m_timestamp);
+    writer.pod(note.m_track);
+    writer.flag(note.m_isSubNote);
+    const auto& binding = note.getSampleBinding();
+    writer.flag(binding.has_value());
+    if ( binding ) {
+        writer.string(binding->m_audioResourceId);
+        writer.pod(binding->m_volume);
+    }
+    writeTable(writer, note.m_metadata.note_properties);
+    writer.string(note.m_annotation);
+    writer.string(note.m_collaborationId);
+}
+
+void readNote(PayloadReader& reader, Note& note)
+{
+    note.m_type      = reader.enumeration(NoteType::POLYLINE);
+    note.m_timestamp = reader.pod<double>();
+    note.m_track     = reader.pod<uint32_t>();
+    note.m_isSubNote = reader.flag();
+    if ( reader.flag() ) {
+        // 直接还原绑定，不经 setSampleBinding 清理空标识，与解析结果一致。
+        AudioSampleBinding binding;
+        binding.m_audioResourceId = reader.string();
+        binding.m_volume          = reader.pod<float>();
+        note.m_sampleBinding      = std::move(binding);
+    }
+    readTable(
+        reader, note.m_metadata.note_properties, NoteMetadataType::MMM);
+    note.m_annotation      = reader.string();
+    note.m_collaborationId = reader.string();
+}
+
+void writeBaseMeta(PayloadWriter& writer, const BaseMapMeta& meta)
+{
+    writer.string(meta.name);
+    writer.string(meta.title);
+    writer.string(meta.title_unicode);
+    writer.string(meta.artist);
+    writer.string(meta.artist_unicode);
+    writer.path(meta.map_path);
+    writer.path(meta.main_audio_path);
+    writer.path(meta.song_file_hint);
+    writer.path(meta.main_cover_path);
+    writer.path(meta.cover_path);
+    writer.enumeration(meta.cover_type);
+    writer.pod(meta.video_starttime);
+    writer.pod(meta.bgxoffset);
+    writer.pod(meta.bgyoffset);
+    writer.string(meta.version);
+    writer.string(meta.author);
+    writer.pod(meta.preference_bpm);
+    writer.pod(meta.track_count);
+    writer.pod(meta.bgm_track_count);
+    writer.pod(meta.map_length);
+}
+
+void readBaseMeta(PayloadReader& reader, BaseMapMeta& meta)
+{
+    meta.name            = reader.string();
+    meta.title           = reader.string();
+    meta.title_unicode   = reader.string();
+    meta.artist          = reader.string();
+    meta.artist_unicode  = reader.string();
+    meta.map_path        = reader.path();
+    meta.main_audio_path = reader.path();
+    meta.song_file_hint  = reader.path();
+    meta.main_cover_path = reader.path();
+    meta.cover_path      = reader.path();
+    meta.cover_type      = reader.enumeration(CoverType::VIDEO);
+    meta.video_starttime = reader.pod<int32_t>();
+    meta.bgxoffset       = reader.pod<int32_t>();
+    meta.bgyoffset       = reader.pod<int32_t>();
+    meta.version         = reader.string();
+    meta.author          = reader.string();
+    meta.preference_bpm  = reader.pod<double>();
+    meta.track_count     = reader.pod<int32_t>();
+    meta.bgm_track_count = reader.pod<int32_t>();
+    meta.map_length      = reader.pod<double>();
+}
+
+void writeTiming(PayloadWriter& writer, const Timing& timing)
+{
+    writer.pod(timing.m_timestamp);
+    writer.pod(timing.m_bpm);
+    writer.pod(timing.m_beat_length);
+    writer.enumeration(timing.m_timingEffect);
+    writer.pod(timing.m_timingEffectParameter);
+    writeTable(writer, timing.m_metadata.timing_properties);
+}
+
+void readTiming(PayloadReader& reader, Timing& timing)
+{
+    timing.m_timestamp             = reader.pod<double>();
+    timing.m_bpm                   = reader.pod<double>();
+    timing.m_beat_length           = reader.pod<double>();
+    timing.m_timingEffect          = reader.enumeration(TimingEffect::HS);
+    timing.m_timingEffectParameter = reader.pod<double>();
+    readTable(reader,
+              timing.m_metadata.timing_properties,
+              TimingMetadataType::MALODY);
+}
+
+void writeAudioSample(PayloadWriter& writer, const AudioSampleEvent& sample)
+{
+    writer.pod(sample.m_timestamp);
+    writer.pod(sample.m_offsetMs);
+    writer.pod(sample.m_track);
+    writer.string(sample.m_audioResourceId);
+    writer.pod(sample.m_volume);
+    writer.count(sample.m_metadata.sample_properties.size());
+    for ( const auto& [source, properties] :
+          sample.m_metadata.sample_properties ) {
+        writer.enumeration(source);
+        writer.count(properties.size());
+        for ( const auto& [key, value] : properties ) {
+            writer.string(key);
+            writer.string(value);
+        }
+    }
+    writer.string(sample.m_collaborationId);
+}
+
+void readAudioSample(PayloadReader& reader, AudioSampleEvent& sample)
+{
+    sample.m_timestamp       = reader.pod<double>();
+    sample.m_offsetMs        = reader.pod<std::int64_t>();
+    sample.m_track           = reader.pod<uint32_t>();
+    sample.m_audioResourceId = reader.string();
+    sample.m_volume          = reader.pod<float>();
+    const std::size_t sources =
+        reader.count(sizeof(uint8_t) + sizeof(uint32_t));
+    for ( std::size_t i = 0; i < sources && reader.ok(); ++i ) {
+        const auto source  = reader.enumeration(SampleMetadataType::MMM);
+        const auto entries = reader.count(2 * MIN_STRING_BYTES);
+        if ( !reader.ok() ) break;
+        auto& properties = sample.m_metadata.sample_properties[source];
+        for ( std::size_t j = 0; j < entries && reader.ok(); ++j ) {
+            std::string key   = reader.string();
+            std::string value = reader.string();
+            if ( reader.ok() ) properties[std::move(key)] = std::move(value);
+        }
+    }
+    sample.m_collaborationId = reader.string();
+}
+
+void writeAnnotation(PayloadWriter& writer, const BeatmapAnnotation& note)
+{
+    writer.string(note.m_id);
+    writer.enumeration(note.m_targetKind);
+    writer.string(note.m_targetId);
+    writer.pod(note.m_timestamp);
+    writer.string(note.m_author);
+    writer.string(note.m_content);
+}
+
+void readAnnotation(PayloadReader& reader, BeatmapAnnotation& note)
+{
+    note.m_id = reader.string();
+    note.m_targetKind =
+        reader.enumeration(BeatmapAnnotationTargetKind::AUDIO_SAMPLE);
+    note.m_targetId  = reader.string();
+    note.m_timestamp = reader.pod<double>();
+    note.m_author    = reader.string();
+    note.m_content   = reader.string();
+}
+
+void writeDiagnostic(PayloadWriter&               writer,
+                     const BeatmapLoadDiagnostic& diagnostic)
+{
+    writer.enumeration(diagnostic.m_code);
+    writer.enumeration(diagnostic.m_severity);
+    writer.string(diagnostic.m_message);
+    writer.path(diagnostic.m_relatedPath);
+}
+
+void readDiagnostic(PayloadReader& reader, BeatmapLoadDiagnostic& diagnostic)
+{
+    diagnostic.m_code = reader.enumeration(
+        BeatmapLoadDiagnosticCode::AUDIO_SAMPLE_TRACK_RELOCATED);
+    diagnostic.m_severity =
+        reader.enumeration(BeatmapLoadDiagnosticSeverity::
+                               BEATMAP_LOAD_DIAGNOSTIC_SEVERITY_ERROR);
+    diagnostic.m_message     = reader.string();
+    diagnostic.m_relatedPath = reader.path();
+}
+
+}  // namespace
+
+bool encodeBeatmapPayload(const BeatMap& beatMap, std::string& payload)
+{
+    payload.clear();
+    PayloadWriter writer(payload);
+    const NoteData& data = beatMap.m_noteData;
+
+    writeBaseMeta(writer, beatMap.m_baseMapMetadata);
+    writeTable(writer, beatMap.m_metadata.map_properties);
+
+    writer.count(beatMap.m_timings.size());
+    for ( const Timing& timing : beatMap.m_timings ) {
+        writeTiming(writer, timing);
+    }
+
+    writer.count(data.notes.size());
+    for ( const Note& note : data.notes ) writeNote(writer, note);
+    writer.count(data.holds.size());
+    for ( const Hold& hold : data.holds ) {
+        writeNote(writer, hold);
+        writer.pod(hold.m_duration);
+    }
+    writer.count(data.flicks.size());
+    for ( const Flick& flick : data.flicks ) {
+        writeNote(writer, flick);
+        writer.pod(flick.m_dtrack);
+    }
+
+    // 折线与 m_allNotes 只保存引用，按“类型 + 下标”编码。
+    const NoteRefIndex refs(data);
+    writer.count(data.polylines.size());
+    for ( const Polyline& polyline : data.polylines ) {
+        writeNote(writer, polyline);
+        writer.count(polyline.m_subFlicks.size());
+        for ( const Flick& flick : polyline.m_subFlicks ) {
+            refs.write(writer, flick);
+        }
+        writer.count(polyline.m_subHolds.size());
+        for ( const Hold& hold : polyline.m_subHolds ) {
+            refs.write(writer, hold);
+        }
+        writer.count(polyline.m_subNotes.size());
+        for ( const Note& note : polyline.m_subNotes ) {
+            refs.write(writer, note);
+        }
+    }
+    writer.count(beatMap.m_allNotes.size());
+    for ( const Note& note : beatMap.m_allNotes ) refs.write(writer, note);
+
+    writer.count(beatMap.m_audioSamples.size());
+    for ( const AudioSampleEvent& sample : beatMap.m_audioSamples ) {
+        writeAudioSample(writer, sample);
+    }
+    writer.count(beatMap.m_annotations.size());
+    for ( const BeatmapAnnotation& annotation : beatMap.m_annotations ) {
+        writeAnnotation(writer, annotation);
+    }
+    writer.count(beatMap.m_loadDiagnostics.size());
+    for ( const BeatmapLoadDiagnostic& diagnostic :
+          beatMap.m_loadDiagnostics ) {
+        writeDiagnostic(writer, diagnostic);
+    }
+    return writer.ok();
+}
+
+bool decodeBeatmapPayload(std::string_view payload, BeatMap& beatMap)
+{
+    PayloadReader reader(payload);
+    NoteData&     data = beatMap.m_noteData;
+
+    readBaseMeta(reader, beatMap.m_baseMapMetadata);
+    readTable(
+        reader, beatMap.m_metadata.map_properties, MapMetadataType::RM);
+
+    std::size_t count = reader.count(4 * sizeof(double));
+    beatMap.m_timings.resize(count);
+    for ( Timing& timing : beatMap.m_timings ) {
+        if ( !reader.ok() ) return false;
+        readTiming(reader, timing);
+    }
+
+    count = reader.count(MIN_NOTE_BYTES);
+    for ( std::size_t i = 0; i < count && reader.ok(); ++i ) {
+        readNote(reader, data.notes.emplace_back());
+    }
+    count = reader.count(MIN_NOTE_BYTES + sizeof(double));
+    for ( std::size_t i = 0; i < count && reader.ok(); ++i ) {
+        Hold& hold = data.holds.emplace_back();
+        readNote(reader, hold);
+        hold.m_duration = reader.pod<double>();
+    }
+    count = reader.count(MIN_NOTE_BYTES + sizeof(int32_t));
+    for ( std::size_t i = 0; i < count && reader.ok(); ++i ) {
+        Flick& flick = data.flicks.emplace_back();
+        readNote(reader, flick);
+        flick.m_dtrack = reader.pod<int32_t>();
+    }
+
+    // 折线在普通物件、长条与滑键之后还原，子物件引用此时均已就位。
+    count = reader.count(MIN_NOTE_BYTES + 3 * sizeof(uint32_t));
+    for ( std::size_t i = 0; i < count && reader.ok(); ++i ) {
+        Polyline& polyline = data.polylines.emplace_back();
+        readNote(reader, polyline);
+        std::size_t refs = reader.count(NOTE_REF_BYTES);
+        for ( std::size_t j = 0; j < refs && reader.ok(); ++j ) {
+            Note* note = readNoteRef(reader, data, NoteType::FLICK);
+            if ( note ) {
+                polyline.m_subFlicks.push_back(
+                    std::ref(*static_cast<Flick*>(note)));
+            }
+        }
+        refs = reader.count(NOTE_REF_BYTES);
+        for ( std::size_t j = 0; j < refs && reader.ok(); ++j ) {
+            Note* note = readNoteRef(reader, data, NoteType::HOLD);
+            if ( note ) {
+                polyline.m_subHolds.push_back(
+                    std::ref(*static_cast<Hold*>(note)));
+            }
+        }
+        refs = reader.count(NOTE_REF_BYTES);
+        for ( std::size_t j = 0; j < refs && reader.ok(); ++j ) {
+            if ( Note* note = readNoteRef(reader, data) ) {
+                polyline.m_subNotes.push_back(std::ref(*note));
+            }
+        }
+    }
+    count = reader.count(NOTE_REF_BYTES);
+    beatMap.m_allNotes.reserve(count);
+    for ( std::size_t i = 0; i < count && reader.ok(); ++i ) {
+        if ( Note* note = readNoteRef(reader, data) ) {
+            beatMap.m_allNotes.push_back(std::ref(*note));
+        }
+    }
+
+    count = reader.count(2 * sizeof(double));
+    for ( std::size_t i = 0; i < count && reader.ok(); ++i ) {
+        readAudioSample(reader, beatMap.m_audioSamples.emplace_back());
+    }
+    count = reader.count(sizeof(uint8_t) + sizeof(double));
+    beatMap.m_annotations.resize(count);
+    for ( BeatmapAnnotation& annotation : beatMap.m_annotations ) {
+        if ( !reader.ok() ) return false;
+        readAnnotation(reader, annotation);
+    }
+    count = reader.count(2 * sizeof(uint8_t));
+    beatMap.m_loadDiagnostics.resize(count);
+    for ( BeatmapLoadDiagnostic& diagnostic : beatMap.m_loadDiagnostics ) {
+        if ( !reader.ok() ) return false;
+        readDiagnostic(reader, diagnostic);
+    }
+    return reader.ok() && reader.atEnd();
+}
+
+}  // namespace MMM::Internal
@@ -0,0 +1,33 @@
+#pragma once
+
+#include "mmm/beatmap/BeatMap.h"
+
+#include <string>
+#include <string_view>
+
+namespace MMM::Internal
+{
+
+/**
+ * @brief 把谱面编码为缓存负载。
+ *
+ * 负载按本机字节序逐字段写入，物件引用（m_allNotes 与折线子物件）编码为
+ * 物件类型加所在容器下标，还原时不需要重新排序或查找。
+ * @param beatMap 谱面。
+ * @param payload 输出负载，先被清空。
+ * @return 存在无法编码的悬空引用时返回 false。
+ */
+bool encodeBeatmapPayload(const BeatMap& beatMap, std::string& payload);
+
+/**
+ * @brief 从缓存负载还原谱面。
+ *
+ * 所有长度、枚举值与引用下标都做边界检查，负载损坏时返回 false 而不会
+ * 越界读取。
+ * @param payload 缓存负载。
+ * @param beatMap 输出谱面，应为默认构造状态。
+ * @return 负载完整且恰好被读完时返回 true。
+ */
+bool decodeBeatmapPayload(std::string_view payload, BeatMap& beatMap);
+
+}  // namespace MMM::Internal
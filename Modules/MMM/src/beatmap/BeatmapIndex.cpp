@@ -0,0 +1,650 @@
+#include "mmm/beatmap/BeatmapIndex.h"
+
+#include "ContentHash.h"
+#include "MappedFile.h"
+
+#include "config/Utf8Path.h"
+#include "log/colorful-log.h"
+#include "mmm/ParallelExecutor.h"
+#include "mmm/note/Hold.h"
+#include "mmm/note/Polyline.h"
+#include <algorithm>
+#include <atomic>
+#include <cmath>
+#include <fstream>
+#include <limits>
+#include <nlohmann/json.hpp>
+#include <string_view>
+#include <system_error>
+#include <unordered_set>
+#include <utility>
+
+namespace MMM
+{
+namespace
+{
+
+using json = nlohmann::json;
+
+/// @brief 计算 Hold 区间内的四分之一拍连击增量，与编辑器状态栏统计一致。
+std::size_t calculateIntervalCombos(double startTime, double endTime,
+                                    const BeatMap& beatMap)
+{
+    if ( endTime <= startTime ) return 0U;
+
+    double      totalQuarterBeats = 0.0;
+    double      currentTime       = startTime;
+    double      currentBpm        = beatMap.m_baseMapMetadata.preference_bpm;
+    std::size_t nextTimingIndex   = 0U;
+    if ( currentBpm <= 0.0 ) currentBpm = 120.0;
+
+    const auto& timings = beatMap.m_timings;
+    for ( std::size_t index = 0U; index < timings.size(); ++index ) {
+        const auto& timing = timings[index];
+        if ( timing.m_timingEffect != TimingEffect::BPM ) continue;
+        if ( timing.m_timestamp <= startTime ) {
+            currentBpm = timing.m_bpm;
+        } else {
+            nextTimingIndex = index;
+            break;
+        }
+    }
+
+    while ( currentTime < endTime ) {
+        double      nextEventTime = endTime;
+        double      nextBpm       = currentBpm;
+        std::size_t foundIndex    = timings.size();
+        for ( std::size_t index = nextTimingIndex; index < timings.size();
+              ++index ) {
+            const auto& timing = timings[index];
+            if ( timing.m_timingEffect == TimingEffect::BPM &&
+                 timing.m_timestamp > currentTime ) {
+                if ( timing.m_timestamp < endTime ) {
+                    nextEventTime = timing.m_timestamp;
+                    nextBpm       = timing.m_bpm;
+                    foundIndex    = index + 1U;
+                }
+                break;
+            }
+        }
+        totalQuarterBeats +=
+            (nextEventTime - currentTime) * (currentBpm / 15.0);
+        currentTime = nextEventTime;
+        currentBpm  = nextBpm;
+        if ( foundIndex < timings.size() ) nextTimingIndex = foundIndex;
+    }
+
+    const double tolerance = 0.003 * (currentBpm / 15.0);
+    return static_cast<std::size_t>(std::floor(totalQuarterBeats + tolerance));
+}
+
+/// @brief 物件的结束时间；Hold 为尾判时间。
+double noteEndTime(const Note& note)
+{
+    if ( note.m_type == NoteType::HOLD ) {
+        return note.m_timestamp + static_cast<const Hold&>(note).m_duration;
+    }
+    return note.m_timestamp;
+}
+
+/// @brief 按首次出现顺序累计音频引用。
+class ReferenceCounter
+{
+public:
+    explicit ReferenceCounter(std::vector<BeatmapAudioReferenceCount>& output)
+        : m_output(output)
+    {
+    }
+
+    void add(const std::string& reference, double timestamp)
+    {
+        if ( reference.empty() ) return;
+        auto [it, inserted] = m_positions.try_emplace(reference, 0U);
+        if ( inserted ) {
+            it->second = m_output.size();
+            m_output.push_back({ reference, 0U, timestamp });
+        }
+        auto& counted = m_output[it->second];
+        ++counted.count;
+        counted.firstTimestamp = std::min(counted.firstTimestamp, timestamp);
+    }
+
+private:
+    std::vector<BeatmapAudioReferenceCount>&     m_output;
+    std::unordered_map<std::string, std::size_t> m_positions;
+};
+
+json referencesToJson(const std::vector<BeatmapAudioReferenceCount>& values)
+{
+    json array = json::array();
+    for ( const auto& value : values ) {
+        array.push_back(json::array(
+            { value.reference, value.count, value.firstTimestamp }));
+    }
+    return array;
+}
+
+std::vector<BeatmapAudioReferenceCount> referencesFromJson(const json& array)
+{
+    std::vector<BeatmapAudioReferenceCount> values;
+    if ( !array.is_array() ) return values;
+    values.reserve(array.size());
+    for ( const auto& item : array ) {
+        if ( !item.is_array() || item.size() != 3 ) continue;
+        values.push_back({ item[0].get<std::string>(),
+                           item[1].get<std::uint32_t>(),
+                           item[2].get<double>() });
+    }
+    return values;
+}
+
+json summaryToJson(const BeatmapSummary& summary)
+{
+    return json{
+        { "version", summary.version },
+        { "title", summary.title },
+        { "artist", summary.artist },
+        { "author", summary.author },
+        { "song_file_hint", Config::pathToUtf8(summary.songFileHint) },
+        { "main_audio_path", Config::pathToUtf8(summary.mainAudioPath) },
+        { "cover_path", Config::pathToUtf8(summary.coverPath) },
+        { "main_cover_path", Config::pathToUtf8(summary.mainCoverPath) },
+        { "note_count", summary.noteCount },
+        { "max_combo", summary.maxCombo },
+        { "duration_ms", summary.durationMs },
+        { "track_count", summary.trackCount },
+        { "min_bpm", summary.minBpm },
+        { "max_bpm", summary.maxBpm },
+        { "has_flicks_or_polylines", summary.hasFlicksOrPolylines },
+        { "note_sample_references",
+          referencesToJson(summary.noteSampleReferences) },
+        { "audio_sample_references",
+          referencesToJson(summary.audioSampleReferences) },
+    };
+}
+
+BeatmapSummary summaryFromJson(const json& value)
+{
+    BeatmapSummary summary;
+    summary.version = value.at("version").get<std::string>();
+    summary.title   = value.at("title").get<std::string>();
+    summary.artist  = value.at("artist").get<std::string>();
+    summary.author  = value.at("author").get<std::string>();
+    summary.songFileHint =
+        Config::utf8ToPath(value.at("song_file_hint").get<std::string>());
+    summary.mainAudioPath =
+        Config::utf8ToPath(value.at("main_audio_path").get<std::string>());
+    summary.coverPath =
+        Config::utf8ToPath(value.at("cover_path").get<std::string>());
+    summary.mainCoverPath =
+        Config::utf8ToPath(value.at("main_cover_path").get<std::string>());
+    summary.noteCount  = value.at("note_count").get<std::size_t>();
+    summary.maxCombo   = value.at("max_combo").get<std::size_t>();
+    summary.durationMs = value.at("duration_ms").get<double>();
+    summary.trackCount = value.at("track_count").get<std::int32_t>();
+    summary.minBpm     = value.at("min_bpm").get<double>();
+    summary.maxBpm     = value.at("max_bpm").get<double>();
+    summary.hasFlicksOrPolylines =
+        value.at("has_flicks_or_polylines").get<bool>();
+    summary.noteSampleReferences =
+        referencesFromJson(value.at("note_sample_references"));
+    summary.audioSampleReferences =
+        referencesFromJson(value.at("audio_sample_references"));
+    return summary;
+}
+
+int64_t writeTimeTicks(std::filesystem::file_time_type time)
+{
+    return static_cast<int64_t>(time.time_since_epoch().count());
+}
+
+/// @brief 摘要是否依赖同目录下的其他文件。
+/// @details .imd 没有歌曲与封面字段，加载器按同名文件探测；.mmm 的同目录
+/// 依赖只影响加载诊断，不进入摘要。
+bool dependsOnSiblingFiles(const std::filesystem::path& mapPath)
+{
+    return Config::pathToUtf8(mapPath.extension()) == ".imd";
+}
+
+/// @brief 进程级当前索引槽。
+struct ActiveIndexSlot {
+    std::mutex                    mutex;
+    std::shared_ptr<BeatmapIndex> index;
+};
+
+ActiveIndexSlot& activeSlot()
+{
+    static ActiveIndexSlot slot;
+    return slot;
+}
+
+}  // namespace
+
+BeatmapSummary BeatmapSummary::fromBeatMap(const BeatMap& beatMap)
+{
+    BeatmapSummary summary;
+    const auto&    meta = beatMap.m_baseMapMetadata;
+    summary.version       = meta.version;
+    summary.title         = meta.title;
+    summary.artist        = meta.artist;
+    summary.author        = meta.author;
+    summary.songFileHint  = meta.song_file_hint;
+    summary.mainAudioPath = meta.main_audio_path;
+    summary.coverPath     = meta.cover_path;
+    summary.mainCoverPath = meta.main_cover_path;
+    summary.trackCount    = meta.track_count;
+    summary.hasFlicksOrPolylines =
+        !beatMap.m_noteData.flicks.empty() ||
+        !beatMap.m_noteData.polylines.empty();
+
+    for ( const Note& note : beatMap.m_allNotes ) {
+        double endTime = noteEndTime(note);
+        if ( note.m_type == NoteType::POLYLINE ) {
+            const auto& subNotes =
+                static_cast<const Polyline&>(note).m_subNotes;
+            for ( const Note& sub : subNotes ) {
+                ++summary.noteCount;
+                endTime = std::max(endTime, noteEndTime(sub));
+            }
+            if ( !subNotes.empty() ) {
+                ++summary.maxCombo;
+                const Note& first = subNotes.front();
+                if ( first.m_type == NoteType::HOLD ) {
+                    summary.maxCombo += calculateIntervalCombos(
+                        first.m_timestamp, noteEndTime(first), beatMap);
+                }
+                for ( std::size_t index = 1U; index < subNotes.size();
+                      ++index ) {
+                    const Note& sub = subNotes[index];
+                    if ( sub.m_type == NoteType::FLICK ) {
+                        ++summary.maxCombo;
+                    } else if ( sub.m_type == NoteType::HOLD ) {
+                        summary.maxCombo += calculateIntervalCombos(
+                            sub.m_timestamp, noteEndTime(sub), beatMap);
+                    }
+                }
+            }
+        } else {
+            ++summary.noteCount;
+            ++summary.maxCombo;
+            if ( note.m_type == NoteType::HOLD ) {
+                summary.maxCombo += calculateIntervalCombos(
+                    note.m_timestamp, endTime, beatMap);
+            }
+        }
+        summary.durationMs = std::max(summary.durationMs, endTime);
+    }
+
+    double minBpm = std::numeric_limits<double>::infinity();
+    double maxBpm = 0.0;
+    for ( const auto& timing : beatMap.m_timings ) {
+        if ( timing.m_timingEffect != TimingEffect::BPM ||
+             timing.m_bpm <= 0.0 ) {
+            continue;
+        }
+        minBpm = std::min(minBpm, timing.m_bpm);
+        maxBpm = std::max(maxBpm, timing.m_bpm);
+    }
+    if ( maxBpm > 0.0 ) {
+        summary.minBpm = minBpm;
+        summary.maxBpm = maxBpm;
+    } else if ( meta.preference_bpm > 0.0 ) {
+        summary.minBpm = meta.preference_bpm;
+        summary.maxBpm = meta.preference_bpm;
+    }
+
+    ReferenceCounter noteSamples(summary.noteSampleReferences);
+    auto             addBinding = [&](const Note& note) {
+        if ( const auto binding = note.getSampleBinding() ) {
+            noteSamples.add(binding->m_audioResourceId, note.m_timestamp);
+        }
+    };
+    for ( const auto& note : beatMap.m_noteData.notes ) addBinding(note);
+    for ( const auto& hold : beatMap.m_noteData.holds ) addBinding(hold);
+    for ( const auto& flick : beatMap.m_noteData.flicks ) addBinding(flick);
+    for ( const auto& polyline : beatMap.m_noteData.polylines ) {
+        addBinding(polyline);
+    }
+
+    ReferenceCounter audioSamples(summary.audioSampleReferences);
+    for ( const auto& sample : beatMap.m_audioSamples ) {
+        audioSamples.add(sample.m_audioResourceId, sample.effectiveTimestamp());
+    }
+    return summary;
+}
+
+std::optional<BeatmapIndex::SourceStamp> BeatmapIndex::SourceStamp::read(
+    const std::filesystem::path& absolutePath)
+{
+    std::error_code ec;
+    SourceStamp     stamp;
+    stamp.size = std::filesystem::file_size(absolutePath, ec);
+    if ( ec ) return std::nullopt;
+    stamp.writeTime =
+        writeTimeTicks(std::filesystem::last_write_time(absolutePath, ec));
+    if ( ec ) return std::nullopt;
+    if ( dependsOnSiblingFiles(absolutePath) ) {
+        stamp.directoryWriteTime = writeTimeTicks(
+            std::filesystem::last_write_time(absolutePath.parent_path(), ec));
+        if ( ec ) return std::nullopt;
+    }
+    return stamp;
+}
+
+BeatmapIndex::BeatmapIndex(std::filesystem::path projectRoot,
+                           std::filesystem::path indexFile)
+    : m_projectRoot(std::move(projectRoot)), m_indexFile(std::move(indexFile))
+{
+    std::error_code ec;
+    auto            absoluteRoot = std::filesystem::absolute(m_projectRoot, ec);
+    if ( !ec ) m_projectRoot = std::move(absoluteRoot);
+    m_projectRoot = m_projectRoot.lexically_normal();
+}
+
+bool BeatmapIndex::load()
+{
+    std::unordered_map<std::string, Entry> entries;
+    bool                                   loaded = false;
+
+    std::ifstream file(m_indexFile, std::ios::binary);
+    if ( file.is_open() ) {
+        const json root = json::parse(file, nullptr, false);
+        try {
+            if ( root.is_object() &&
+                 root.value("format_version", 0U) == FORMAT_VERSION ) {
+                for ( const auto& [key, value] : root.at("beatmaps").items() ) {
+                    Entry entry;
+                    entry.stamp.size = value.at("size").get<std::uint64_t>();
+                    entry.stamp.writeTime =
+                        value.at("write_time").get<std::int64_t>();
+                    entry.stamp.directoryWriteTime =
+                        value.at("directory_write_time").get<std::int64_t>();
+                    entry.contentHash =
+                        value.at("content_hash").get<std::uint64_t>();
+                    entry.summary = summaryFromJson(value.at("summary"));
+                    entries.emplace(key, std::move(entry));
+                }
+                loaded = true;
+            }
+        } catch ( const json::exception& error ) {
+            XWARN("Discarding corrupted beatmap index {}: {}",
+                  Config::pathToUtf8(m_indexFile),
+                  error.what());
+            entries.clear();
+        }
+    }
+
+    std::lock_guard<std::mutex> lock(m_mutex);
+    m_entries = std::move(entries);
+    m_dirty   = false;
+    return loaded;
+}
+
+bool BeatmapIndex::save()
+{
+    std::lock_guard<std::mutex> saveLock(m_saveMutex);
+    json                        beatmaps = json::object();
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        if ( !m_dirty ) return true;
+        for ( const auto& [key, entry] : m_entries ) {
+            beatmaps[key] = json{
+                { "size", entry.stamp.size },
+                { "write_time", entry.stamp.writeTime },
+                { "directory_write_time", entry.stamp.directoryWriteTime },
+                { "content_hash", entry.contentHash },
+                { "summary", summaryToJson(entry.summary) },
+            };
+        }
+        m_dirty = false;
+    }
+    const json root{
+        { "format_version", FORMAT_VERSION },
+        { "beatmaps", std::move(beatmaps) },
+    };
+
+    const auto markDirty = [this]() {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_dirty = true;
+    };
+    std::error_code ec;
+    std::filesystem::create_directories(m_indexFile.parent_path(), ec);
+    std::filesystem::path tempFile = m_indexFile;
+    tempFile += ".tmp";
+    {
+        std::ofstream out(tempFile, std::ios::binary | std::ios::trunc);
+        out << root.dump() << '\n';
+        if ( !out.good() ) {
+            XWARN("Failed to write beatmap index: {}",
+                  Config::pathToUtf8(tempFile));
+            markDirty();
+            return false;
+        }
+    }
+    std::filesystem::rename(tempFile, m_indexFile, ec);
+    if ( ec ) {
+        std::error_code removeError;
+        std::filesystem::remove(tempFile, removeError);
+        XWARN("Failed to replace beatmap index {}: {}",
+              Config::pathToUtf8(m_indexFile),
+              ec.message());
+        markDirty();
+        return false;
+    }
+    return true;
+}
+
+BeatmapIndexStatistics BeatmapIndex::refresh(
+    const std::vector<std::filesystem::path>& mapPaths,
+    std::size_t                               workerCount)
+{
+    struct Pending {
+        std::string           key;
+        std::filesystem::path absolutePath;
+        SourceStamp           stamp;
+    };
+
+    BeatmapIndexStatistics          statistics;
+    std::vector<Pending>            pending;
+    std::unordered_set<std::string> keys;
+    keys.reserve(mapPaths.size());
+    for ( const auto& mapPath : mapPaths ) {
+        std::string key = entryKey(mapPath);
+        if ( !keys.insert(key).second ) continue;
+        const auto absolutePath = resolve(mapPath);
+        const auto stamp        = SourceStamp::read(absolutePath);
+        if ( !stamp ) {
+            ++statistics.failed;
+            continue;
+        }
+        if ( findWithStamp(key, absolutePath, *stamp) ) {
+            ++statistics.reused;
+            continue;
+        }
+        pending.push_back({ std::move(key), absolutePath, *stamp });
+    }
+
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        for ( auto it = m_entries.begin(); it != m_entries.end(); ) {
+            if ( keys.contains(it->first) ) {
+                ++it;
+                continue;
+            }
+            it = m_entries.erase(it);
+            ++statistics.removed;
+            m_dirty = true;
+        }
+    }
+    if ( pending.empty() ) {
+        m_ready.store(true, std::memory_order_release);
+        return statistics;
+    }
+
+    std::atomic<std::size_t> rebuilt{ 0 };
+    parallelFor(
+        pending.size(),
+        [&](std::size_t index) {
+            const auto& item = pending[index];
+            if ( rebuild(item.key, item.absolutePath, item.stamp) ) {
+                rebuilt.fetch_add(1, std::memory_order_relaxed);
+            }
+        },
+        workerCount);
+
+    statistics.rebuilt = rebuilt.load();
+    statistics.failed += pending.size() - statistics.rebuilt;
+    m_ready.store(true, std::memory_order_release);
+    return statistics;
+}
+
+std::optional<BeatmapSummary> BeatmapIndex::summary(
+    const std::filesystem::path& mapPath)
+{
+    const std::string key          = entryKey(mapPath);
+    const auto        absolutePath = resolve(mapPath);
+    const auto        stamp        = SourceStamp::read(absolutePath);
+    if ( !stamp ) return std::nullopt;
+    if ( auto found = findWithStamp(key, absolutePath, *stamp) ) return found;
+    return rebuild(key, absolutePath, *stamp);
+}
+
+std::optional<BeatmapSummary> BeatmapIndex::find(
+    const std::filesystem::path& mapPath)
+{
+    const auto absolutePath = resolve(mapPath);
+    const auto stamp        = SourceStamp::read(absolutePath);
+    if ( !stamp ) return std::nullopt;
+    return findWithStamp(entryKey(mapPath), absolutePath, *stamp);
+}
+
+bool BeatmapIndex::reload(const std::filesystem::path& mapPath)
+{
+    const auto absolutePath = resolve(mapPath);
+    const auto stamp        = SourceStamp::read(absolutePath);
+    return stamp && rebuild(entryKey(mapPath), absolutePath, *stamp);
+}
+
+void BeatmapIndex::remove(const std::filesystem::path& mapPath)
+{
+    const std::string           key = entryKey(mapPath);
+    std::lock_guard<std::mutex> lock(m_mutex);
+    if ( m_entries.erase(key) > 0 ) m_dirty = true;
+}
+
+std::size_t BeatmapIndex::size() const
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+    return m_entries.size();
+}
+
+bool BeatmapIndex::isDirty() const
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+    return m_dirty;
+}
+
+std::string BeatmapIndex::entryKey(const std::filesystem::path& mapPath) const
+{
+    const auto absolutePath = resolve(mapPath);
+    const auto relativePath = absolutePath.lexically_relative(m_projectRoot);
+    const bool insideProject =
+        !relativePath.empty() && *relativePath.begin() != "..";
+    std::string key = Config::pathToUtf8(insideProject ? relativePath
+                                                       : absolutePath);
+    std::replace(key.begin(), key.end(), '\\', '/');
+    return key;
+}
+
+void BeatmapIndex::setActive(std::shared_ptr<BeatmapIndex> index)
+{
+    auto&                       slot = activeSlot();
+    std::lock_guard<std::mutex> lock(slot.mutex);
+    slot.index = std::move(index);
+}
+
+std::shared_ptr<BeatmapIndex> BeatmapIndex::active()
+{
+    auto&                       slot = activeSlot();
+    std::lock_guard<std::mutex> lock(slot.mutex);
+    return slot.index;
+}
+
+std::filesystem::path BeatmapIndex::resolve(
+    const std::filesystem::path& mapPath) const
+{
+    return (mapPath.is_absolute() ? mapPath : m_projectRoot / mapPath)
+        .lexically_normal();
+}
+
+std::optional<BeatmapSummary> BeatmapIndex::findWithStamp(
+    const std::string& key, const std::filesystem::path& absolutePath,
+    const SourceStamp& stamp)
+{
+    std::uint64_t expectedHash = 0;
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        const auto                  it = m_entries.find(key);
+        if ( it == m_entries.end() ) return std::nullopt;
+        const Entry& entry = it->second;
+        if ( entry.stamp == stamp ) return entry.summary;
+        if ( entry.stamp.size != stamp.size ||
+             entry.stamp.directoryWriteTime != stamp.directoryWriteTime ) {
+            return std::nullopt;
+        }
+        expectedHash = entry.contentHash;
+    }
+
+    // 只有修改时间变化（复制、检出、touch）时才读取源文件比对内容哈希。
+    Internal::MappedFile source;
+    if ( !source.open(absolutePath) ||
+         Internal::hashContent(source.bytes()) != expectedHash ) {
+        return std::nullopt;
+    }
+    std::lock_guard<std::mutex> lock(m_mutex);
+    const auto                  it = m_entries.find(key);
+    if ( it == m_entries.end() || it->second.contentHash != expectedHash ) {
+        return std::nullopt;
+    }
+    it->second.stamp = stamp;
+    m_dirty          = true;
+    return it->second.summary;
+}
+
+std::optional<BeatmapSummary> BeatmapIndex::rebuild(
+    const std::string& key, const std::filesystem::path& absolutePath,
+    const SourceStamp& stamp)
+{
+    const BeatMap beatMap = BeatMap::loadFromFile(absolutePath);
+    if ( beatMap.m_baseMapMetadata.map_path.empty() ) return std::nullopt;
+    BeatmapSummary summary = BeatmapSummary::fromBeatMap(beatMap);
+    storeWithStamp(key, absolutePath, stamp, summary);
+    return summary;
+}
+
+bool BeatmapIndex::storeWithStamp(const std::string&           key,
+                                  const std::filesystem::path& absolutePath,
+                                  const SourceStamp&           stamp,
+                                  BeatmapSummary               summary)
+{
+    Entry entry;
+    entry.stamp   = stamp;
+    entry.summary = std::move(summary);
+    {
+        Internal::MappedFile source;
+        if ( !source.open(absolutePath) ||
+             source.bytes().size() != stamp.size ) {
+            return false;
+        }
+        entry.contentHash = Internal::hashContent(source.bytes());
+    }
+    // 加载期间源文件被改写时放弃写入，避免把旧摘要记在新内容名下。
+    if ( SourceStamp::read(absolutePath) != stamp ) return false;
+
+    std::lock_guard<std::mutex> lock(m_mutex);
+    m_entries.insert_or_assign(key, std::move(entry));
+    m_dirty = true;
+    return true;
+}
+
+}  // namespace MMM
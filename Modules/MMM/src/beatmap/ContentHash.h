@@ -0,0 +1,31 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <string_view>
+
+namespace MMM::Internal
+{
+
+/// @brief 64 位 FNV-1a 的按机器字分组变体，只用于本机缓存与索引校验。
+/// @details 结果依赖字节序，不能写入需要跨机器比较的文件。
+inline uint64_t hashContent(std::string_view bytes)
+{
+    constexpr uint64_t FNV1A_OFFSET_BASIS = 14695981039346656037ULL;
+    constexpr uint64_t FNV1A_PRIME        = 1099511628211ULL;
+
+    uint64_t    state = FNV1A_OFFSET_BASIS;
+    std::size_t i     = 0;
+    for ( ; i + sizeof(uint64_t) <= bytes.size(); i += sizeof(uint64_t) ) {
+        uint64_t word = 0;
+        std::memcpy(&word, bytes.data() + i, sizeof(uint64_t));
+        state = (state ^ word) * FNV1A_PRIME;
+    }
+    for ( ; i < bytes.size(); ++i ) {
+        state = (state ^ static_cast<uint8_t>(bytes[i])) * FNV1A_PRIME;
+    }
+    return state;
+}
+
+}  // namespace MMM::Internal
@@ -0,0 +1,142 @@
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <filesystem>
+#include <fstream>
+#include <functional>
+#include <string>
+#include <string_view>
+#include <system_error>
+#include <thread>
+
+#ifdef _WIN32
+#    ifndef WIN32_LEAN_AND_MEAN
+#        define WIN32_LEAN_AND_MEAN
+#    endif
+#    ifndef NOMINMAX
+#        define NOMINMAX
+#    endif
+#    include <windows.h>
+#else
+#    include <fcntl.h>
+#    include <unistd.h>
+#endif
+
+namespace MMM::Internal
+{
+
+/// @brief 把整个文件读入单块缓冲区。
+/// @details 以二进制方式读取，换行符原样保留，由调用方自行切分。
+/// @param path 文件路径。
+/// @param buffer 输出缓冲区。
+/// @return 文件可以打开时返回 true。
+inline bool readFileBuffer(const std::filesystem::path& path,
+                           std::string&                 buffer)
+{
+    std::ifstream ifs(path, std::ios::binary | std::ios::ate);
+    if ( !ifs.is_open() ) return false;
+
+    const std::streamoff size = ifs.tellg();
+    buffer.clear();
+    if ( size > 0 ) {
+        buffer.resize(static_cast<std::size_t>(size));
+        ifs.seekg(0, std::ios::beg);
+        ifs.read(buffer.data(), size);
+        buffer.resize(static_cast<std::size_t>(ifs.gcount()));
+    }
+    return true;
+}
+
+/// @brief 把文件内容从系统缓存刷到磁盘。
+/// @return 刷新成功时返回 true。
+inline bool syncFileToDisk(const std::filesystem::path& path)
+{
+#ifdef _WIN32
+    HANDLE file = CreateFileW(path.c_str(),
+                              GENERIC_WRITE,
+                              FILE_SHARE_READ | FILE_SHARE_WRITE,
+                              nullptr,
+                              OPEN_EXISTING,
+                              FILE_ATTRIBUTE_NORMAL,
+                              nullptr);
+    if ( file == INVALID_HANDLE_VALUE ) return false;
+    const bool synced = FlushFileBuffers(file) != 0;
+    CloseHandle(file);
+    return synced;
+#else
+    const int file = ::open(path.c_str(), O_RDONLY | O_CLOEXEC);
+    if ( file < 0 ) return false;
+    const bool synced = ::fsync(file) == 0;
+    ::close(file);
+    return synced;
+#endif
+}
+
+/// @brief 把目录项的变化（新建、重命名）刷到磁盘。
+/// @details Windows 上目录元数据由文件系统日志保证，不需要也无法单独刷新。
+inline void syncDirectoryToDisk(const std::filesystem::path& directory)
+{
+#ifndef _WIN32
+    const int file = ::open(directory.empty() ? "." : directory.c_str(),
+                            O_RDONLY | O_DIRECTORY | O_CLOEXEC);
+    if ( file < 0 ) return;
+    ::fsync(file);
+    ::close(file);
+#else
+    static_cast<void>(directory);
+#endif
+}
+
+/**
+ * @brief 把整块缓冲区写入同目录临时文件，再原子替换目标文件。
+ * @details 写出或替换失败时删除临时文件，原有目标文件保持不变；读取方
+ * 永远不会看到写到一半的谱面。临时文件在替换前刷到磁盘，替换后再刷新
+ * 所在目录，断电后目标路径要么是旧文件、要么是完整的新文件。临时文件名
+ * 带线程与序号后缀，同一进程内并发保存同一路径互不干扰。
+ * @param path 目标路径。
+ * @param data 完整文件内容。
+ * @param mode 额外打开模式；文本格式传入空模式以保留平台换行转换。
+ * @return 写出并替换成功时返回 true。
+ */
+inline bool writeFileBufferAtomically(const std::filesystem::path& path,
+                                      std::string_view             data,
+                                      std::ios::openmode           mode)
+{
+    static std::atomic<uint64_t> sequence{ 0 };
+    const auto threadHash =
+        std::hash<std::thread::id>{}(std::this_thread::get_id());
+    const auto serial = sequence.fetch_add(1, std::memory_order_relaxed);
+
+    std::filesystem::path tempFile = path;
+    tempFile += "." + std::to_string(threadHash % 0x100000000ULL) + "." +
+                std::to_string(serial) + ".tmp";
+
+    std::error_code ec;
+    {
+        std::ofstream out(tempFile, std::ios::out | std::ios::trunc | mode);
+        if ( !out.is_open() ) return false;
+        out.write(data.data(), static_cast<std::streamsize>(data.size()));
+        out.close();
+        if ( !out ) {
+            std::filesystem::remove(tempFile, ec);
+            return false;
+        }
+    }
+    // 先落盘再替换：否则断电后目标路径可能指向尚未写入数据的新文件。
+    if ( !syncFileToDisk(tempFile) ) {
+        std::filesystem::remove(tempFile, ec);
+        return false;
+    }
+    std::filesystem::rename(tempFile, path, ec);
+    if ( ec ) {
+        std::error_code removeError;
+        std::filesystem::remove(tempFile, removeError);
+        return false;
+    }
+    syncDirectoryToDisk(path.parent_path());
+    return true;
+}
+
+}  // namespace MMM::Internal
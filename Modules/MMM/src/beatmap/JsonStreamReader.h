@@ -0,0 +1,346 @@
+#pragma once
+
+#include <cstddef>
+#include <nlohmann/json.hpp>
+#include <string>
+#include <string_view>
+#include <utility>
+#include <vector>
+
+namespace MMM::Internal
+{
+
+/// @brief 跳过 JSON 空白；允许注释时一并跳过 `//` 与 `/* */` 注释。
+/// @details 未闭合的块注释不会被跳过，留给后续的结构检查报错。
+/// @param text JSON 文本。
+/// @param pos 起始位置。
+/// @param ignoreComments 是否把注释视为空白。
+/// @return 第一个非空白字符的位置。
+inline std::size_t skipJsonSpace(std::string_view text, std::size_t pos,
+                                 bool ignoreComments)
+{
+    while ( pos < text.size() ) {
+        const char c = text[pos];
+        if ( c == ' ' || c == '\t' || c == '\n' || c == '\r' ) {
+            ++pos;
+            continue;
+        }
+        if ( !ignoreComments || c != '/' || pos + 1 >= text.size() ) break;
+        if ( text[pos + 1] == '/' ) {
+            pos = text.find_first_of("\r\n", pos + 2);
+            if ( pos == std::string_view::npos ) return text.size();
+        } else if ( text[pos + 1] == '*' ) {
+            const std::size_t end = text.find("*/", pos + 2);
+            if ( end == std::string_view::npos ) break;
+            pos = end + 2;
+        } else {
+            break;
+        }
+    }
+    return pos;
+}
+
+/// @brief 跳过一个 JSON 字符串。
+/// @param text JSON 文本。
+/// @param pos 开引号位置。
+/// @return 闭引号之后的位置；字符串未闭合时返回文本末尾。
+inline std::size_t skipJsonString(std::string_view text, std::size_t pos)
+{
+    const std::size_t begin = pos + 1;
+    std::size_t       quote = begin;
+    while ( (quote = text.find('"', quote)) != std::string_view::npos ) {
+        // 引号前连续的反斜杠为奇数个时，该引号被转义。
+        std::size_t slashes = 0;
+        while ( quote - slashes > begin && text[quote - slashes - 1] == '\\' ) {
+            ++slashes;
+        }
+        if ( slashes % 2 == 0 ) return quote + 1;
+        ++quote;
+    }
+    return text.size();
+}
+
+/// @brief 跳过一个 JSON 值，只确定其边界，不构建 DOM 也不校验内容。
+/// @details 切出的值交给 nlohmann 严格解析，格式错误会在那一步暴露。
+/// @param text JSON 文本。
+/// @param pos 值的首字符位置。
+/// @param ignoreComments 是否允许注释。
+/// @return 值之后的位置。
+inline std::size_t skipJsonValue(std::string_view text, std::size_t pos,
+                                 bool ignoreComments)
+{
+    if ( pos >= text.size() ) return pos;
+    if ( text[pos] == '"' ) return skipJsonString(text, pos);
+
+    if ( text[pos] == '{' || text[pos] == '[' ) {
+        std::size_t depth = 0;
+        while ( pos < text.size() ) {
+            switch ( text[pos] ) {
+            case '"': pos = skipJsonString(text, pos); continue;
+            case '{':
+            case '[': ++depth; break;
+            case '}':
+            case ']':
+                if ( --depth == 0 ) return pos + 1;
+                break;
+            case '/': {
+                const std::size_t next =
+                    skipJsonSpace(text, pos, ignoreComments);
+                if ( next != pos ) {
+                    pos = next;
+                    continue;
+                }
+                break;
+            }
+            default: break;
+            }
+            ++pos;
+        }
+        return pos;
+    }
+
+    // 数字与 true/false/null 字面量。
+    while ( pos < text.size() ) {
+        const char c = text[pos];
+        if ( c == ',' || c == ']' || c == '}' || c == ' ' || c == '\t' ||
+             c == '\n' || c == '\r' || c == '/' ) {
+            break;
+        }
+        ++pos;
+    }
+    return pos;
+}
+
+/// @brief 顶层对象的一个成员：键名与值的原文切片。
+struct JsonMemberSlice {
+    /// @brief 反转义后的键名。
+    std::string key;
+    /// @brief 值在原文中的切片，生命周期跟随原文缓冲区。
+    std::string_view value;
+};
+
+/// @brief 依次访问顶层 JSON 对象的成员，不构建任何 DOM。
+/// @details 只校验已经访问到的顶层框架（括号、键、冒号、逗号与尾随内容）。
+/// 访问者返回 false 时立即停止，之后的文本不再被读取，供只需要少数顶层
+/// 字段的头部探测使用。
+/// @param text 完整 JSON 文本，可带 UTF-8 BOM。
+/// @param ignoreComments 是否允许注释。
+/// @param visit 以 JsonMemberSlice 调用，返回 false 表示停止。
+/// @return 顶层是框架完整的对象，或访问者提前停止时返回 true。
+template <typename Visitor>
+inline bool visitJsonObjectMembers(std::string_view text, bool ignoreComments,
+                                   Visitor&& visit)
+{
+    std::size_t pos = text.starts_with("\xEF\xBB\xBF") ? 3 : 0;
+    pos             = skipJsonSpace(text, pos, ignoreComments);
+    if ( pos >= text.size() || text[pos] != '{' ) return false;
+
+    pos = skipJsonSpace(text, pos + 1, ignoreComments);
+    if ( pos < text.size() && text[pos] == '}' ) {
+        return skipJsonSpace(text, pos + 1, ignoreComments) == text.size();
+    }
+    while ( pos < text.size() && text[pos] == '"' ) {
+        const std::size_t keyEnd = skipJsonString(text, pos);
+        const auto        key    = nlohmann::json::parse(
+            text.substr(pos, keyEnd - pos), nullptr, false);
+        if ( !key.is_string() ) return false;
+
+        pos = skipJsonSpace(text, keyEnd, ignoreComments);
+        if ( pos >= text.size() || text[pos] != ':' ) return false;
+        pos = skipJsonSpace(text, pos + 1, ignoreComments);
+        const std::size_t valueEnd = skipJsonValue(text, pos, ignoreComments);
+        if ( valueEnd == pos ) return false;
+        if ( !visit(JsonMemberSlice{ key.get<std::string>(),
+                                     text.substr(pos, valueEnd - pos) }) ) {
+            return true;
+        }
+
+        pos = skipJsonSpace(text, valueEnd, ignoreComments);
+        if ( pos < text.size() && text[pos] == ',' ) {
+            pos = skipJsonSpace(text, pos + 1, ignoreComments);
+            continue;
+        }
+        if ( pos >= text.size() || text[pos] != '}' ) return false;
+        return skipJsonSpace(text, pos + 1, ignoreComments) == text.size();
+    }
+    return false;
+}
+
+/// @brief 顶层 JSON 对象的单遍 SAX 解析器。
+/// @details 由 Handler 选中的数组成员逐元素构建 DOM 并立即交给 Handler，同一
+/// 时刻只存在一个元素的 DOM；其余成员（以及被选中但不是数组的成员）整体构建
+/// 后交给 Handler。重复的键按出现顺序全部交付，由 Handler 决定取舍（nlohmann
+/// 解析时后出现的值生效）。顶层不是对象时不交付任何内容，只校验语法。
+///
+/// Handler 需提供：
+/// - `bool streamMember(const std::string& key)`：顶层键出现时调用，返回 true
+///   表示逐元素解析该成员；
+/// - `bool element(const nlohmann::json& value)`：逐元素成员的一个数组元素；
+/// - `bool member(std::string&& key, nlohmann::json&& value)`：整体构建的成员。
+///
+/// 任一回调返回 false 时解析中止，parse() 返回 false。
+template <typename Handler>
+class JsonObjectSax
+{
+public:
+    using json = nlohmann::json;
+
+    explicit JsonObjectSax(Handler& handler) : m_handler(handler) {}
+
+    /// @brief 解析整份文本。
+    /// @param text 完整 JSON 文本，可带 UTF-8 BOM。
+    /// @param ignoreComments 是否允许注释。
+    /// @return 文本是合法 JSON 且 Handler 未中止时返回 true。
+    bool parse(std::string_view text, bool ignoreComments)
+    {
+        return json::sax_parse(text.data(),
+                               text.data() + text.size(),
+                               this,
+                               json::input_format_t::json,
+                               true,
+                               ignoreComments);
+    }
+
+    /// @brief 顶层是否为对象。
+    bool rootIsObject() const { return m_rootIsObject; }
+
+    bool null() { return addValue(nullptr); }
+    bool boolean(bool value) { return addValue(value); }
+    bool number_integer(json::number_integer_t value)
+    {
+        return addValue(value);
+    }
+    bool number_unsigned(json::number_unsigned_t value)
+    {
+        return addValue(value);
+    }
+    bool number_float(json::number_float_t value, const json::string_t&)
+    {
+        return addValue(value);
+    }
+    bool string(json::string_t& value) { return addValue(std::move(value)); }
+    bool binary(json::binary_t& value)
+    {
+        return addValue(json::binary(std::move(value)));
+    }
+
+    bool start_object(std::size_t)
+    {
+        if ( m_depth++ == 0 ) {
+            m_rootIsObject = true;
+            return true;
+        }
+        return beginContainer(json::value_t::object);
+    }
+
+    bool key(json::string_t& key)
+    {
+        if ( !m_rootIsObject ) return true;
+        if ( m_depth == 1 ) {
+            m_memberKey = key;
+            m_streaming = m_handler.streamMember(m_memberKey);
+            return true;
+        }
+        m_slot = &(*m_stack.back())[key];
+        return true;
+    }
+
+    bool end_object() { return endContainer(); }
+
+    bool start_array(std::size_t)
+    {
+        if ( m_depth++ == 0 ) return true;
+        if ( m_depth == 2 && m_streaming && m_rootIsObject ) {
+            m_inStreamArray = true;
+            return true;
+        }
+        return beginContainer(json::value_t::array);
+    }
+
+    bool end_array() { return endContainer(); }
+
+    bool parse_error(std::size_t, const std::string&,
+                     const nlohmann::detail::exception&)
+    {
+        return false;
+    }
+
+private:
+    /// @brief 把标量写入当前容器；位于成员或元素顶层时直接交付。
+    template <typename Value>
+    bool addValue(Value&& value)
+    {
+        if ( m_depth == 0 || !m_rootIsObject ) return true;
+        if ( m_stack.empty() ) {
+            m_value = std::forward<Value>(value);
+            return deliver();
+        }
+        json* parent = m_stack.back();
+        if ( parent->is_array() ) {
+            parent->emplace_back(std::forward<Value>(value));
+        } else {
+            *m_slot = std::forward<Value>(value);
+        }
+        return true;
+    }
+
+    /// @brief 开始构建一个容器，成员或元素顶层的容器写入 m_value。
+    bool beginContainer(json::value_t type)
+    {
+        if ( !m_rootIsObject ) return true;
+        json* target = &m_value;
+        if ( !m_stack.empty() ) {
+            json* parent = m_stack.back();
+            if ( parent->is_array() ) {
+                target = &parent->emplace_back();
+            } else {
+                target = m_slot;
+            }
+        }
+        *target = json(type);
+        m_stack.push_back(target);
+        return true;
+    }
+
+    /// @brief 结束一个容器；成员或元素构建完毕时交付给 Handler。
+    bool endContainer()
+    {
+        if ( --m_depth == 0 || !m_rootIsObject ) return true;
+        if ( m_depth == 1 && m_inStreamArray ) {
+            m_inStreamArray = false;
+            return true;
+        }
+        m_stack.pop_back();
+        return m_stack.empty() ? deliver() : true;
+    }
+
+    bool deliver()
+    {
+        if ( m_inStreamArray ) return m_handler.element(m_value);
+        return m_handler.member(std::move(m_memberKey), std::move(m_value));
+    }
+
+    Handler& m_handler;
+    /// @brief 正在构建的成员或数组元素。
+    json m_value;
+    /// @brief 构建中的容器栈，栈底为 m_value。
+    std::vector<json*> m_stack;
+    /// @brief 对象容器中下一个值的写入位置。
+    json*       m_slot{ nullptr };
+    std::string m_memberKey;
+    std::size_t m_depth{ 0 };
+    bool        m_rootIsObject{ false };
+    bool        m_streaming{ false };
+    bool        m_inStreamArray{ false };
+};
+
+/// @brief 由三个可调用对象组成的 JsonObjectSax Handler，供加载器以 lambda
+/// 直接描述对成员与元素的处理。
+template <typename StreamMember, typename Element, typename Member>
+struct JsonObjectSaxCallbacks {
+    StreamMember streamMember;
+    Element      element;
+    Member       member;
+};
+
+}  // namespace MMM::Internal
@@ -1,5 +1,8 @@
 #pragma once
 
+#include "JsonStreamReader.h"
+#include "MappedFile.h"
+
 #include "config/Utf8Path.h"
 #include "log/colorful-log.h"
 #include "mmm/beatmap/BeatMap.h"
@@ -8,12 +11,15 @@
 #include <cmath>
 #include <cstdint>
 #include <filesystem>
-#include <fstream>
 #include <limits>
 #include <nlohmann/json.hpp>
 #include <optional>
 #include <set>
 #include <string>
+#include <string_view>
+#include <type_traits>
+#include <unordered_map>
+#include <unordered_set>
 #include <utility>
 #include <vector>
 
@@ -110,25 +116,29 @@ inline uint32_t readMMMU32(const json& object, const char* key,
 /**
  * @brief 从 mmm 格式 (JSON) 加载谱面
  * @param path 谱面文件路径
+ * @param headerOnly 只读取 format_version、metadata 与 audio_samples，
+ * 三者齐全后立即停止，不读取 timing 与 note 数组
  * @return 加载完成的谱面对象
  */
-inline BeatMap loadMMMMap(const std::filesystem::path& path)
+inline BeatMap loadMMMMap(const std::filesystem::path& path,
+                          bool                         headerOnly = false)
 {
-    BeatMap       beatMap;
-    std::ifstream file(path);
-    if ( !file.is_open() ) {
+    BeatMap beatMap;
+    // 以内存映射读取：原文不占用堆内存，头部探测时 note 等数组所在的页
+    // 也不会被读入。
+    Internal::MappedFile mappedFile;
+    if ( !mappedFile.open(path) ) {
         XERROR("Failed to open mmm map file: {}", Config::pathToUtf8(path));
         return beatMap;
     }
+    const std::string_view text = mappedFile.bytes();
 
-    json root = json::parse(file, nullptr, false);
-    if ( root.is_discarded() || !root.is_object() || file.bad() ) {
+    const auto parseFailed = [&path]() {
         XERROR("Failed to parse mmm map JSON: {}", Config::pathToUtf8(path));
-        return beatMap;
-    }
+        return BeatMap{};
+    };
 
     beatMap.m_baseMapMetadata.map_path = path;
-    const int formatVersion            = readMMMInt(root, "format_version", 1);
 
     /// @brief 从 MMM extra 对象中复制字符串属性。
     auto copyStringMetadataProperties = [](auto& props, const json& propsJson) {
@@ -250,6 +260,462 @@ inline BeatMap loadMMMMap(const std::filesystem::path& path)
         }
     };
 
+    // 2. Timing 事件，随解析逐个写入。
+    /// @brief 加载 timing 数组的一个元素。
+    auto loadTiming = [&](const json& tJson) {
+        if ( !tJson.is_object() ) return;
+        Timing t;
+        t.m_timestamp   = readMMMDouble(tJson, "timestamp", 0.0);
+        t.m_bpm         = readMMMDouble(tJson, "bpm", 120.0);
+        t.m_beat_length = readMMMDouble(tJson, "beat_length", 500.0);
+        t.m_timingEffect =
+            timingEffectFromString(readMMMString(tJson, "effect", "bpm"));
+        t.m_timingEffectParameter = readMMMDouble(tJson, "param", 0.0);
+
+        auto timingExtraIt = tJson.find("extra");
+        if ( timingExtraIt != tJson.end() && timingExtraIt->is_array() ) {
+            for ( const auto& extraItem : *timingExtraIt ) {
+                if ( !extraItem.is_object() ) continue;
+                for ( auto it = extraItem.begin(); it != extraItem.end();
+                      ++it ) {
+                    TimingMetadataType type;
+                    if ( it.key() == "osu" )
+                        type = TimingMetadataType::OSU;
+                    else if ( it.key() == "malody" )
+                        type = TimingMetadataType::MALODY;
+                    else
+                        continue;
+
+                    auto& props = t.m_metadata.timing_properties[type];
+                    copyStringMetadataProperties(props, it.value());
+                }
+            }
+        }
+        beatMap.m_timings.push_back(t);
+    };
+
+    // 4. 玩家物件，随解析逐个写入 NoteData。
+    /// @brief 折线子物件的 (时间戳, 轨道)，用于剔除旧版本残留的重复独立条目。
+    std::set<std::pair<double, uint32_t>> subNoteKeys;
+    /// @brief 由折线退化而来的独立物件，不参与上述剔除。
+    std::unordered_set<const Note*> polylineOutputs;
+
+    /// @brief 加载 note 数组的一个元素。
+    auto loadNote = [&](const json& nJson) {
+        if ( !nJson.is_object() ) return;
+        std::string type = readMMMString(nJson, "type", "note");
+        if ( type == "polyline" ) {
+            Polyline& poly   = beatMap.m_noteData.polylines.emplace_back();
+            poly.m_type      = NoteType::POLYLINE;
+            poly.m_timestamp = readMMMDouble(nJson, "timestamp", 0.0);
+            poly.m_track     = readMMMU32(nJson, "track", 0);
+            loadNoteSampleBinding(poly, nJson);
+
+            loadNoteMetadata(poly, nJson);
+            loadNoteAnnotation(poly, nJson);
+            loadNoteCollaborationIdentity(poly, nJson);
+
+            struct TempSub {
+                NoteType type;
+                double   timestamp;
+                double   duration;
+                int      track;
+                int      dtrack;
+                /// @brief 子物件的可选命中采样绑定。
+                std::optional<AudioSampleBinding> sampleBinding;
+                /// @brief 子物件的独立编辑器注释。
+                std::string annotation;
+                /// @brief 子物件的稳定协作标识。
+                std::string collaborationId;
+            };
+            std::vector<TempSub> tempSubs;
+            bool preserveAnnotatedStructure = !poly.m_annotation.empty();
+
+            auto subNotesIt = nJson.find("sub_notes");
+            if ( subNotesIt != nJson.end() && subNotesIt->is_array() ) {
+                preserveAnnotatedStructure =
+                    preserveAnnotatedStructure ||
+                    std::any_of(
+                        subNotesIt->begin(),
+                        subNotesIt->end(),
+                        [](const json& subNoteJson) {
+                            const auto annotationIt =
+                                subNoteJson.find("annotation");
+                            return annotationIt != subNoteJson.end() &&
+                                   annotationIt->is_string() &&
+                                   !annotationIt
+                                        ->get_ref<const std::string&>()
+                                        .empty();
+                        });
+                for ( const auto& snJson : *subNotesIt ) {
+                    if ( !snJson.is_object() ) continue;
+                    subNoteKeys.insert(
+                        { readMMMDouble(snJson, "timestamp", 0.0),
+                          readMMMU32(snJson, "track", 0) });
+                    std::string stype =
+                        readMMMString(snJson, "type", "note");
+                    TempSub sn;
+                    sn.timestamp = readMMMDouble(snJson, "timestamp", 0.0);
+                    sn.track     = readMMMInt(snJson, "track", 0);
+                    sn.duration  = 0.0;
+                    sn.dtrack    = 0;
+                    sn.sampleBinding = readNoteSampleBinding(snJson);
+                    const std::string annotation =
+                        readMMMString(snJson, "annotation");
+                    if ( annotation.size() <= MAX_NOTE_ANNOTATION_BYTES ) {
+                        sn.annotation = annotation;
+                    }
+                    sn.collaborationId =
+                        readMMMString(snJson, "collaboration_id");
+                    if ( sn.collaborationId.size() >
+                         MAX_BEATMAP_ANNOTATION_ID_BYTES ) {
+                        sn.collaborationId.clear();
+                    }
+                    preserveAnnotatedStructure =
+                        preserveAnnotatedStructure ||
+                        !sn.collaborationId.empty();
+                    if ( stype == "hold" ) {
+                        sn.duration =
+                            readMMMDouble(snJson, "duration", 0.0);
+                        if ( sn.duration < 1e-4 &&
+                             !preserveAnnotatedStructure ) {
+                            continue;
+                        }
+                        sn.type = NoteType::HOLD;
+                    } else if ( stype == "flick" ) {
+                        sn.type   = NoteType::FLICK;
+                        sn.dtrack = readMMMInt(snJson, "dtrack", 0);
+                    } else {
+                        sn.type = NoteType::NOTE;
+                    }
+                    tempSubs.push_back(sn);
+                }
+
+                // 迭代清洗逻辑
+                bool changed = !preserveAnnotatedStructure;
+                while ( changed ) {
+                    changed = false;
+
+                    // 1. 过滤零值
+                    auto it =
+                        std::remove_if(tempSubs.begin(),
+                                       tempSubs.end(),
+                                       [](const auto& s) {
+                                           if ( s.type == NoteType::HOLD )
+                                               return s.duration < 1e-4;
+                                           if ( s.type == NoteType::FLICK )
+                                               return s.dtrack == 0;
+                                           return false;
+                                       });
+                    if ( it != tempSubs.end() ) {
+                        tempSubs.erase(it, tempSubs.end());
+                        changed = true;
+                    }
+
+                    // 2. 合并同类
+                    if ( tempSubs.size() > 1 ) {
+                        for ( size_t i = 0; i < tempSubs.size() - 1; ) {
+                            auto& curr = tempSubs[i];
+                            auto& next = tempSubs[i + 1];
+                            if ( curr.type == next.type ) {
+                                if ( curr.type == NoteType::HOLD ) {
+                                    curr.duration += next.duration;
+                                    if ( !curr.sampleBinding ) {
+                                        curr.sampleBinding =
+                                            next.sampleBinding;
+                                    }
+                                    tempSubs.erase(tempSubs.begin() + i +
+                                                   1);
+                                    changed = true;
+                                    continue;
+                                } else if ( curr.type == NoteType::FLICK ) {
+                                    curr.dtrack += next.dtrack;
+                                    if ( !curr.sampleBinding ) {
+                                        curr.sampleBinding =
+                                            next.sampleBinding;
+                                    }
+                                    tempSubs.erase(tempSubs.begin() + i +
+                                                   1);
+                                    changed = true;
+                                    continue;
+                                }
+                            }
+                            i++;
+                        }
+                    }
+                }
+            }
+
+            // 根据清洗后的结果决定最终去向
+            if ( tempSubs.empty() && !preserveAnnotatedStructure ) {
+                // 彻底退化为普通 Note
+                Note& n       = beatMap.m_noteData.notes.emplace_back();
+                polylineOutputs.insert(&n);
+                n.m_type      = NoteType::NOTE;
+                n.m_timestamp = poly.m_timestamp;
+                n.m_track     = poly.m_track;
+                applyNoteSampleBinding(n, poly.getSampleBinding());
+                n.m_metadata        = poly.m_metadata;
+                n.m_annotation      = poly.m_annotation;
+                n.m_collaborationId = poly.m_collaborationId;
+                beatMap.m_noteData.polylines
+                    .pop_back();  // 移除预先创建的空壳
+            } else if ( tempSubs.size() == 1 &&
+                        !preserveAnnotatedStructure ) {
+                // 退化为单一物件
+                const auto& s = tempSubs[0];
+                if ( s.type == NoteType::HOLD ) {
+                    Hold& h       = beatMap.m_noteData.holds.emplace_back();
+                    polylineOutputs.insert(&h);
+                    h.m_type      = NoteType::HOLD;
+                    h.m_timestamp = s.timestamp;
+                    h.m_track     = s.track;
+                    h.m_duration  = s.duration;
+                    applyNoteSampleBinding(h,
+                                           s.sampleBinding
+                                               ? s.sampleBinding
+                                               : poly.getSampleBinding());
+                    h.m_metadata        = poly.m_metadata;
+                    h.m_annotation      = poly.m_annotation;
+                    h.m_collaborationId = poly.m_collaborationId;
+                } else if ( s.type == NoteType::FLICK ) {
+                    Flick& f = beatMap.m_noteData.flicks.emplace_back();
+                    polylineOutputs.insert(&f);
+                    f.m_type = NoteType::FLICK;
+                    f.m_timestamp = s.timestamp;
+                    f.m_track     = s.track;
+                    f.m_dtrack    = s.dtrack;
+                    applyNoteSampleBinding(f,
+                                           s.sampleBinding
+                                               ? s.sampleBinding
+                                               : poly.getSampleBinding());
+                    f.m_metadata        = poly.m_metadata;
+                    f.m_annotation      = poly.m_annotation;
+                    f.m_collaborationId = poly.m_collaborationId;
+                } else {
+                    Note& n       = beatMap.m_noteData.notes.emplace_back();
+                    polylineOutputs.insert(&n);
+                    n.m_type      = NoteType::NOTE;
+                    n.m_timestamp = s.timestamp;
+                    n.m_track     = s.track;
+                    applyNoteSampleBinding(n,
+                                           s.sampleBinding
+                                               ? s.sampleBinding
+                                               : poly.getSampleBinding());
+                    n.m_metadata        = poly.m_metadata;
+                    n.m_annotation      = poly.m_annotation;
+                    n.m_collaborationId = poly.m_collaborationId;
+                }
+                beatMap.m_noteData.polylines
+                    .pop_back();  // 移除预先创建的空壳
+            } else {
+                // 依然是有效的 Polyline，填充子物件
+                for ( const auto& s : tempSubs ) {
+                    if ( s.type == NoteType::HOLD ) {
+                        Hold& h  = beatMap.m_noteData.holds.emplace_back();
+                        h.m_type = NoteType::HOLD;
+                        h.m_timestamp       = s.timestamp;
+                        h.m_track           = s.track;
+                        h.m_duration        = s.duration;
+                        h.m_isSubNote       = true;
+                        h.m_annotation      = s.annotation;
+                        h.m_collaborationId = s.collaborationId;
+                        applyNoteSampleBinding(h, s.sampleBinding);
+                        poly.m_subNotes.push_back(h);
+                        poly.m_subHolds.push_back(h);
+                    } else if ( s.type == NoteType::FLICK ) {
+                        Flick& f = beatMap.m_noteData.flicks.emplace_back();
+                        f.m_type = NoteType::FLICK;
+                        f.m_timestamp       = s.timestamp;
+                        f.m_track           = s.track;
+                        f.m_dtrack          = s.dtrack;
+                        f.m_isSubNote       = true;
+                        f.m_annotation      = s.annotation;
+                        f.m_collaborationId = s.collaborationId;
+                        applyNoteSampleBinding(f, s.sampleBinding);
+                        poly.m_subNotes.push_back(f);
+                        poly.m_subFlicks.push_back(f);
+                    } else {
+                        Note& n  = beatMap.m_noteData.notes.emplace_back();
+                        n.m_type = NoteType::NOTE;
+                        n.m_timestamp       = s.timestamp;
+                        n.m_track           = s.track;
+                        n.m_isSubNote       = true;
+                        n.m_annotation      = s.annotation;
+                        n.m_collaborationId = s.collaborationId;
+                        applyNoteSampleBinding(n, s.sampleBinding);
+                        poly.m_subNotes.push_back(n);
+                    }
+                }
+                // 更新 Polyline 的锚点信息为第一个子物件
+                if ( !tempSubs.empty() ) {
+                    poly.m_timestamp = tempSubs.front().timestamp;
+                    poly.m_track     = tempSubs.front().track;
+                }
+            }
+        } else if ( type == "hold" ) {
+            Hold& h       = beatMap.m_noteData.holds.emplace_back();
+            h.m_type      = NoteType::HOLD;
+            h.m_timestamp = readMMMDouble(nJson, "timestamp", 0.0);
+            h.m_track     = readMMMU32(nJson, "track", 0);
+            h.m_duration  = readMMMDouble(nJson, "duration", 0.0);
+            loadNoteSampleBinding(h, nJson);
+            loadNoteMetadata(h, nJson);
+            loadNoteAnnotation(h, nJson);
+            loadNoteCollaborationIdentity(h, nJson);
+        } else if ( type == "flick" ) {
+            Flick& f      = beatMap.m_noteData.flicks.emplace_back();
+            f.m_type      = NoteType::FLICK;
+            f.m_timestamp = readMMMDouble(nJson, "timestamp", 0.0);
+            f.m_track     = readMMMU32(nJson, "track", 0);
+            f.m_dtrack    = readMMMInt(nJson, "dtrack", 0);
+            loadNoteSampleBinding(f, nJson);
+            loadNoteMetadata(f, nJson);
+            loadNoteAnnotation(f, nJson);
+            loadNoteCollaborationIdentity(f, nJson);
+        } else {
+            Note& n       = beatMap.m_noteData.notes.emplace_back();
+            n.m_type      = NoteType::NOTE;
+            n.m_timestamp = readMMMDouble(nJson, "timestamp", 0.0);
+            n.m_track     = readMMMU32(nJson, "track", 0);
+            loadNoteSampleBinding(n, nJson);
+            loadNoteMetadata(n, nJson);
+            loadNoteAnnotation(n, nJson);
+            loadNoteCollaborationIdentity(n, nJson);
+        }
+    };
+
+    // 5. 多批注。无效或重复记录被忽略，避免损坏文件阻断谱面载入；
+    // 达到上限或遇到非对象元素后不再读取后续批注。
+    std::set<std::string> annotationIds;
+    bool                  annotationsStopped = false;
+
+    /// @brief 加载 annotations 数组的一个元素。
+    auto loadAnnotation = [&](const json& annotationJson) {
+        if ( annotationsStopped ||
+             beatMap.m_annotations.size() >= MAX_BEATMAP_ANNOTATION_COUNT ||
+             !annotationJson.is_object() ) {
+            annotationsStopped = true;
+            return;
+        }
+        BeatmapAnnotation annotation;
+        annotation.m_id       = readMMMString(annotationJson, "id");
+        annotation.m_targetId = readMMMString(annotationJson, "target_id");
+        annotation.m_timestamp =
+            readMMMDouble(annotationJson, "timestamp", 0.0);
+        annotation.m_author  = readMMMString(annotationJson, "author");
+        annotation.m_content = readMMMString(annotationJson, "content");
+
+        const std::string targetKind =
+            readMMMString(annotationJson, "target_kind", "timestamp");
+        if ( targetKind == "player_object" ) {
+            annotation.m_targetKind =
+                BeatmapAnnotationTargetKind::PLAYER_OBJECT;
+        } else if ( targetKind == "audio_sample" ) {
+            annotation.m_targetKind =
+                BeatmapAnnotationTargetKind::AUDIO_SAMPLE;
+        } else if ( targetKind != "timestamp" ) {
+            return;
+        }
+
+        if ( annotation.m_id.empty() ||
+             annotation.m_id.size() > MAX_BEATMAP_ANNOTATION_ID_BYTES ||
+             annotation.m_targetId.size() >
+                 MAX_BEATMAP_ANNOTATION_ID_BYTES ||
+             annotation.m_author.size() >
+                 MAX_BEATMAP_ANNOTATION_AUTHOR_BYTES ||
+             annotation.m_content.empty() ||
+             annotation.m_content.size() >
+                 MAX_BEATMAP_ANNOTATION_CONTENT_BYTES ||
+             !annotationIds.insert(annotation.m_id).second ||
+             (annotation.m_targetKind !=
+                  BeatmapAnnotationTargetKind::TIMESTAMP &&
+              annotation.m_targetId.empty()) ) {
+            return;
+        }
+        beatMap.m_annotations.push_back(std::move(annotation));
+    };
+
+    // 单遍 SAX 解析：timing、note 与 annotations 三个数组逐元素构建 DOM 并
+    // 立即写入谱面，其余成员整体构建为 DOM。audio_samples 体积小且依赖
+    // metadata 中的轨道数（保存时排在 metadata 之前），随元数据一起处理。
+    // 语法校验随解析进行，任一部分不合法都按解析失败处理。
+    json root = json::object();
+    if ( headerOnly ) {
+        // 保存时键按字母序排列，这三个成员都位于 note 与 timing 之前。
+        constexpr std::string_view HEADER_KEYS[] = { "audio_samples",
+                                                     "format_version",
+                                                     "metadata" };
+        std::size_t                found         = 0;
+        bool                       parsed        = true;
+        Internal::visitJsonObjectMembers(
+            text, false, [&](Internal::JsonMemberSlice&& member) {
+                if ( std::find(std::begin(HEADER_KEYS),
+                               std::end(HEADER_KEYS),
+                               member.key) == std::end(HEADER_KEYS) ) {
+                    return true;
+                }
+                auto value = json::parse(member.value, nullptr, false);
+                parsed     = parsed && !value.is_discarded();
+                root[member.key] = std::move(value);
+                return ++found < std::size(HEADER_KEYS);
+            });
+        if ( !parsed ) return parseFailed();
+    } else {
+        /// @brief 正在逐元素解析的数组成员。
+        enum class StreamedArray { TIMING, NOTE, ANNOTATIONS };
+        StreamedArray streamed = StreamedArray::TIMING;
+
+        Internal::JsonObjectSaxCallbacks callbacks{
+            [&](const std::string& key) {
+                // 同名键以最后一次出现为准，丢弃先前写入的内容。
+                if ( key == "timing" ) {
+                    beatMap.m_timings.clear();
+                    streamed = StreamedArray::TIMING;
+                } else if ( key == "note" ) {
+                    beatMap.m_noteData = NoteData{};
+                    subNoteKeys.clear();
+                    polylineOutputs.clear();
+                    streamed = StreamedArray::NOTE;
+                } else if ( key == "annotations" ) {
+                    beatMap.m_annotations.clear();
+                    annotationIds.clear();
+                    annotationsStopped = false;
+                    streamed           = StreamedArray::ANNOTATIONS;
+                } else {
+                    return false;
+                }
+                return true;
+            },
+            [&](const json& element) {
+                switch ( streamed ) {
+                case StreamedArray::TIMING: loadTiming(element); break;
+                case StreamedArray::NOTE: loadNote(element); break;
+                case StreamedArray::ANNOTATIONS:
+                    loadAnnotation(element);
+                    break;
+                }
+                return true;
+            },
+            [&](std::string&& key, json&& value) {
+                // 逐元素解析的成员不是数组时没有内容可读。
+                if ( key != "timing" && key != "note" &&
+                     key != "annotations" ) {
+                    root[key] = std::move(value);
+                }
+                return true;
+            }
+        };
+        Internal::JsonObjectSax sax(callbacks);
+        if ( !sax.parse(text, false) || !sax.rootIsObject() ) {
+            return parseFailed();
+        }
+        // 原文已全部读完，先于后续处理解除映射。
+        mappedFile.close();
+    }
+
+    const int formatVersion = readMMMInt(root, "format_version", 1);
+
     // 1. 元数据。
     auto metadataIt = root.find("metadata");
     if ( metadataIt != root.end() && metadataIt->is_object() ) {
@@ -332,46 +798,10 @@ inline BeatMap loadMMMMap(const std::filesystem::path& path)
         }
     }
 
-    // 2. Timing 事件。
-    auto timingIt = root.find("timing");
-    if ( timingIt != root.end() && timingIt->is_array() ) {
-        for ( const auto& tJson : *timingIt ) {
-            if ( !tJson.is_object() ) continue;
-            Timing t;
-            t.m_timestamp   = readMMMDouble(tJson, "timestamp", 0.0);
-            t.m_bpm         = readMMMDouble(tJson, "bpm", 120.0);
-            t.m_beat_length = readMMMDouble(tJson, "beat_length", 500.0);
-            t.m_timingEffect =
-                timingEffectFromString(readMMMString(tJson, "effect", "bpm"));
-            t.m_timingEffectParameter = readMMMDouble(tJson, "param", 0.0);
-
-            auto timingExtraIt = tJson.find("extra");
-            if ( timingExtraIt != tJson.end() && timingExtraIt->is_array() ) {
-                for ( const auto& extraItem : *timingExtraIt ) {
-                    if ( !extraItem.is_object() ) continue;
-                    for ( auto it = extraItem.begin(); it != extraItem.end();
-                          ++it ) {
-                        TimingMetadataType type;
-                        if ( it.key() == "osu" )
-                            type = TimingMetadataType::OSU;
-                        else if ( it.key() == "malody" )
-                            type = TimingMetadataType::MALODY;
-                        else
-                            continue;
-
-                        auto& props = t.m_metadata.timing_properties[type];
-                        copyStringMetadataProperties(props, it.value());
-                    }
-                }
-            }
-            beatMap.m_timings.push_back(t);
-        }
-    }
-
     // 3. 自动采样对象。
-    auto sampleIt = root.find("audio_samples");
-    if ( sampleIt != root.end() && sampleIt->is_array() ) {
-        for ( const auto& sampleJson : *sampleIt ) {
+    const auto samplesIt = root.find("audio_samples");
+    if ( samplesIt != root.end() && samplesIt->is_array() ) {
+        for ( const auto& sampleJson : *samplesIt ) {
             if ( !sampleJson.is_object() ) continue;
             const auto audioReferenceIt = sampleJson.find("audio_ref");
             if ( audioReferenceIt == sampleJson.end() ||
@@ -465,364 +895,48 @@ inline BeatMap loadMMMMap(const std::filesystem::path& path)
         }
     }
 
-    // 4. 玩家物件。
-    auto noteIt = root.find("note");
-    if ( noteIt != root.end() && noteIt->is_array() ) {
-        // 预扫描所有折线子物件引用，用于去重（防御旧版本残留的重复数据）
-        std::set<std::pair<double, uint32_t>> subNoteKeys;
-        for ( const auto& nJson : *noteIt ) {
-            if ( !nJson.is_object() ) continue;
-            if ( readMMMString(nJson, "type", "note") == "polyline" ) {
-                auto subNotesIt = nJson.find("sub_notes");
-                if ( subNotesIt != nJson.end() && subNotesIt->is_array() ) {
-                    for ( const auto& snJson : *subNotesIt ) {
-                        if ( !snJson.is_object() ) continue;
-                        subNoteKeys.insert(
-                            { readMMMDouble(snJson, "timestamp", 0.0),
-                              readMMMU32(snJson, "track", 0) });
-                    }
-                }
-            }
-        }
-
-        for ( const auto& nJson : *noteIt ) {
-            if ( !nJson.is_object() ) continue;
-            std::string type = readMMMString(nJson, "type", "note");
-            if ( type == "polyline" ) {
-                Polyline& poly   = beatMap.m_noteData.polylines.emplace_back();
-                poly.m_type      = NoteType::POLYLINE;
-                poly.m_timestamp = readMMMDouble(nJson, "timestamp", 0.0);
-                poly.m_track     = readMMMU32(nJson, "track", 0);
-                loadNoteSampleBinding(poly, nJson);
-
-                loadNoteMetadata(poly, nJson);
-                loadNoteAnnotation(poly, nJson);
-                loadNoteCollaborationIdentity(poly, nJson);
-
-                struct TempSub {
-                    NoteType type;
-                    double   timestamp;
-                    double   duration;
-                    int      track;
-                    int      dtrack;
-                    /// @brief 子物件的可选命中采样绑定。
-                    std::optional<AudioSampleBinding> sampleBinding;
-                    /// @brief 子物件的独立编辑器注释。
-                    std::string annotation;
-                    /// @brief 子物件的稳定协作标识。
-                    std::string collaborationId;
-                };
-                std::vector<TempSub> tempSubs;
-                bool preserveAnnotatedStructure = !poly.m_annotation.empty();
-
-                auto subNotesIt = nJson.find("sub_notes");
-                if ( subNotesIt != nJson.end() && subNotesIt->is_array() ) {
-                    preserveAnnotatedStructure =
-                        preserveAnnotatedStructure ||
-                        std::any_of(
-                            subNotesIt->begin(),
-                            subNotesIt->end(),
-                            [](const json& subNoteJson) {
-                                const auto annotationIt =
-                                    subNoteJson.find("annotation");
-                                return annotationIt != subNoteJson.end() &&
-                                       annotationIt->is_string() &&
-                                       !annotationIt
-                                            ->get_ref<const std::string&>()
-                                            .empty();
-                            });
-                    for ( const auto& snJson : *subNotesIt ) {
-                        if ( !snJson.is_object() ) continue;
-                        std::string stype =
-                            readMMMString(snJson, "type", "note");
-                        TempSub sn;
-                        sn.timestamp = readMMMDouble(snJson, "timestamp", 0.0);
-                        sn.track     = readMMMInt(snJson, "track", 0);
-                        sn.duration  = 0.0;
-                        sn.dtrack    = 0;
-                        sn.sampleBinding = readNoteSampleBinding(snJson);
-                        const std::string annotation =
-                            readMMMString(snJson, "annotation");
-                        if ( annotation.size() <= MAX_NOTE_ANNOTATION_BYTES ) {
-                            sn.annotation = annotation;
-                        }
-                        sn.collaborationId =
-                            readMMMString(snJson, "collaboration_id");
-                        if ( sn.collaborationId.size() >
-                             MAX_BEATMAP_ANNOTATION_ID_BYTES ) {
-                            sn.collaborationId.clear();
-                        }
-                        preserveAnnotatedStructure =
-                            preserveAnnotatedStructure ||
-                            !sn.collaborationId.empty();
-                        if ( stype == "hold" ) {
-                            sn.duration =
-                                readMMMDouble(snJson, "duration", 0.0);
-                            if ( sn.duration < 1e-4 &&
-                                 !preserveAnnotatedStructure ) {
-                                continue;
-                            }
-                            sn.type = NoteType::HOLD;
-                        } else if ( stype == "flick" ) {
-                            sn.type   = NoteType::FLICK;
-                            sn.dtrack = readMMMInt(snJson, "dtrack", 0);
-                        } else {
-                            sn.type = NoteType::NOTE;
-                        }
-                        tempSubs.push_back(sn);
-                    }
-
-                    // 迭代清洗逻辑
-                    bool changed = !preserveAnnotatedStructure;
-                    while ( changed ) {
-                        changed = false;
-
-                        // 1. 过滤零值
-                        auto it =
-                            std::remove_if(tempSubs.begin(),
-                                           tempSubs.end(),
-                                           [](const auto& s) {
-                                               if ( s.type == NoteType::HOLD )
-                                                   return s.duration < 1e-4;
-                                               if ( s.type == NoteType::FLICK )
-                                                   return s.dtrack == 0;
-                                               return false;
-                                           });
-                        if ( it != tempSubs.end() ) {
-                            tempSubs.erase(it, tempSubs.end());
-                            changed = true;
-                        }
-
-                        // 2. 合并同类
-                        if ( tempSubs.size() > 1 ) {
-                            for ( size_t i = 0; i < tempSubs.size() - 1; ) {
-                                auto& curr = tempSubs[i];
-                                auto& next = tempSubs[i + 1];
-                                if ( curr.type == next.type ) {
-                                    if ( curr.type == NoteType::HOLD ) {
-                                        curr.duration += next.duration;
-                                        if ( !curr.sampleBinding ) {
-                                            curr.sampleBinding =
-                                                next.sampleBinding;
-                                        }
-                                        tempSubs.erase(tempSubs.begin() + i +
-                                                       1);
-                                        changed = true;
-                                        continue;
-                                    } else if ( curr.type == NoteType::FLICK ) {
-                                        curr.dtrack += next.dtrack;
-                                        if ( !curr.sampleBinding ) {
-                                            curr.sampleBinding =
-                                                next.sampleBinding;
-                                        }
-                                        tempSubs.erase(tempSubs.begin() + i +
-                                                       1);
-                                        changed = true;
-                                        continue;
-                                    }
-                                }
-                                i++;
-                            }
-                        }
-                    }
-                }
-
-                // 根据清洗后的结果决定最终去向
-                if ( tempSubs.empty() && !preserveAnnotatedStructure ) {
-                    // 彻底退化为普通 Note
-                    Note& n       = beatMap.m_noteData.notes.emplace_back();
-                    n.m_type      = NoteType::NOTE;
-                    n.m_timestamp = poly.m_timestamp;
-                    n.m_track     = poly.m_track;
-                    applyNoteSampleBinding(n, poly.getSampleBinding());
-                    n.m_metadata        = poly.m_metadata;
-                    n.m_annotation      = poly.m_annotation;
-                    n.m_collaborationId = poly.m_collaborationId;
-                    beatMap.m_noteData.polylines
-                        .pop_back();  // 移除预先创建的空壳
-                } else if ( tempSubs.size() == 1 &&
-                            !preserveAnnotatedStructure ) {
-                    // 退化为单一物件
-                    const auto& s = tempSubs[0];
-                    if ( s.type == NoteType::HOLD ) {
-                        Hold& h       = beatMap.m_noteData.holds.emplace_back();
-                        h.m_type      = NoteType::HOLD;
-                        h.m_timestamp = s.timestamp;
-                        h.m_track     = s.track;
-                        h.m_duration  = s.duration;
-                        applyNoteSampleBinding(h,
-                                               s.sampleBinding
-                                                   ? s.sampleBinding
-                                                   : poly.getSampleBinding());
-                        h.m_metadata        = poly.m_metadata;
-                        h.m_annotation      = poly.m_annotation;
-                        h.m_collaborationId = poly.m_collaborationId;
-                    } else if ( s.type == NoteType::FLICK ) {
-                        Flick& f = beatMap.m_noteData.flicks.emplace_back();
-                        f.m_type = NoteType::FLICK;
-                        f.m_timestamp = s.timestamp;
-                        f.m_track     = s.track;
-                        f.m_dtrack    = s.dtrack;
-                        applyNoteSampleBinding(f,
-                                               s.sampleBinding
-                                                   ? s.sampleBinding
-                                                   : poly.getSampleBinding());
-                        f.m_metadata        = poly.m_metadata;
-                        f.m_annotation      = poly.m_annotation;
-                        f.m_collaborationId = poly.m_collaborationId;
-                    } else {
-                        Note& n       = beatMap.m_noteData.notes.emplace_back();
-                        n.m_type      = NoteType::NOTE;
-                        n.m_timestamp = s.timestamp;
-                        n.m_track     = s.track;
-                        applyNoteSampleBinding(n,
-                                               s.sampleBinding
-                                                   ? s.sampleBinding
-                                                   : poly.getSampleBinding());
-                        n.m_metadata        = poly.m_metadata;
-                        n.m_annotation      = poly.m_annotation;
-                        n.m_collaborationId = poly.m_collaborationId;
-                    }
-                    beatMap.m_noteData.polylines
-                        .pop_back();  // 移除预先创建的空壳
-                } else {
-                    // 依然是有效的 Polyline，填充子物件
-                    for ( const auto& s : tempSubs ) {
-                        if ( s.type == NoteType::HOLD ) {
-                            Hold& h  = beatMap.m_noteData.holds.emplace_back();
-                            h.m_type = NoteType::HOLD;
-                            h.m_timestamp       = s.timestamp;
-                            h.m_track           = s.track;
-                            h.m_duration        = s.duration;
-                            h.m_isSubNote       = true;
-                            h.m_annotation      = s.annotation;
-                            h.m_collaborationId = s.collaborationId;
-                            applyNoteSampleBinding(h, s.sampleBinding);
-                            poly.m_subNotes.push_back(h);
-                            poly.m_subHolds.push_back(h);
-                        } else if ( s.type == NoteType::FLICK ) {
-                            Flick& f = beatMap.m_noteData.flicks.emplace_back();
-                            f.m_type = NoteType::FLICK;
-                            f.m_timestamp       = s.timestamp;
-                            f.m_track           = s.track;
-                            f.m_dtrack          = s.dtrack;
-                            f.m_isSubNote       = true;
-                            f.m_annotation      = s.annotation;
-                            f.m_collaborationId = s.collaborationId;
-                            applyNoteSampleBinding(f, s.sampleBinding);
-                            poly.m_subNotes.push_back(f);
-                            poly.m_subFlicks.push_back(f);
-                        } else {
-                            Note& n  = beatMap.m_noteData.notes.emplace_back();
-                            n.m_type = NoteType::NOTE;
-                            n.m_timestamp       = s.timestamp;
-                            n.m_track           = s.track;
-                            n.m_isSubNote       = true;
-                            n.m_annotation      = s.annotation;
-                            n.m_collaborationId = s.collaborationId;
-                            applyNoteSampleBinding(n, s.sampleBinding);
-                            poly.m_subNotes.push_back(n);
-                        }
-                    }
-                    // 更新 Polyline 的锚点信息为第一个子物件
-                    if ( !tempSubs.empty() ) {
-                        poly.m_timestamp = tempSubs.front().timestamp;
-                        poly.m_track     = tempSubs.front().track;
-                    }
-                }
-            } else if ( type == "hold" ) {
-                // 跳过属于折线子物件的独立条目（防御旧版本残留的重复数据）
-                if ( subNoteKeys.count({ readMMMDouble(nJson, "timestamp", 0.0),
-                                         readMMMU32(nJson, "track", 0) }) ) {
-                    continue;
-                }
-                Hold& h       = beatMap.m_noteData.holds.emplace_back();
-                h.m_type      = NoteType::HOLD;
-                h.m_timestamp = readMMMDouble(nJson, "timestamp", 0.0);
-                h.m_track     = readMMMU32(nJson, "track", 0);
-                h.m_duration  = readMMMDouble(nJson, "duration", 0.0);
-                loadNoteSampleBinding(h, nJson);
-                loadNoteMetadata(h, nJson);
-                loadNoteAnnotation(h, nJson);
-                loadNoteCollaborationIdentity(h, nJson);
-            } else if ( type == "flick" ) {
-                // 跳过属于折线子物件的独立条目（防御旧版本残留的重复数据）
-                if ( subNoteKeys.count({ readMMMDouble(nJson, "timestamp", 0.0),
-                                         readMMMU32(nJson, "track", 0) }) ) {
+    if ( headerOnly ) return beatMap;
+
+    // 剔除属于折线子物件的独立条目（防御旧版本残留的重复数据）。折线可能晚于
+    // 这些条目出现，因此在整个 note 数组读完后统一压缩；压缩会移动子物件，
+    // 折线持有的引用随后按新地址重建。
+    if ( !subNoteKeys.empty() ) {
+        std::unordered_map<const Note*, Note*> relocated;
+        auto compact = [&](auto& items) {
+            std::size_t kept = 0;
+            for ( std::size_t i = 0; i < items.size(); ++i ) {
+                auto& item = items[i];
+                if ( !item.m_isSubNote && !polylineOutputs.contains(&item) &&
+                     subNoteKeys.contains({ item.m_timestamp, item.m_track }) ) {
                     continue;
                 }
-                Flick& f      = beatMap.m_noteData.flicks.emplace_back();
-                f.m_type      = NoteType::FLICK;
-                f.m_timestamp = readMMMDouble(nJson, "timestamp", 0.0);
-                f.m_track     = readMMMU32(nJson, "track", 0);
-                f.m_dtrack    = readMMMInt(nJson, "dtrack", 0);
-                loadNoteSampleBinding(f, nJson);
-                loadNoteMetadata(f, nJson);
-                loadNoteAnnotation(f, nJson);
-                loadNoteCollaborationIdentity(f, nJson);
-            } else {
-                // 跳过属于折线子物件的独立条目（防御旧版本残留的重复数据）
-                if ( subNoteKeys.count({ readMMMDouble(nJson, "timestamp", 0.0),
-                                         readMMMU32(nJson, "track", 0) }) ) {
-                    continue;
+                if ( kept != i ) {
+                    items[kept] = std::move(item);
+                    if ( items[kept].m_isSubNote ) {
+                        relocated.emplace(&item, &items[kept]);
+                    }
                 }
-                Note& n       = beatMap.m_noteData.notes.emplace_back();
-                n.m_type      = NoteType::NOTE;
-                n.m_timestamp = readMMMDouble(nJson, "timestamp", 0.0);
-                n.m_track     = readMMMU32(nJson, "track", 0);
-                loadNoteSampleBinding(n, nJson);
-                loadNoteMetadata(n, nJson);
-                loadNoteAnnotation(n, nJson);
-                loadNoteCollaborationIdentity(n, nJson);
-            }
-        }
-    }
-
-    // 5. 多批注。无效或重复记录被忽略，避免损坏文件阻断谱面载入。
-    auto annotationIt = root.find("annotations");
-    if ( annotationIt != root.end() && annotationIt->is_array() ) {
-        std::set<std::string> annotationIds;
-        for ( const auto& annotationJson : *annotationIt ) {
-            if ( beatMap.m_annotations.size() >= MAX_BEATMAP_ANNOTATION_COUNT ||
-                 !annotationJson.is_object() ) {
-                break;
-            }
-            BeatmapAnnotation annotation;
-            annotation.m_id       = readMMMString(annotationJson, "id");
-            annotation.m_targetId = readMMMString(annotationJson, "target_id");
-            annotation.m_timestamp =
-                readMMMDouble(annotationJson, "timestamp", 0.0);
-            annotation.m_author  = readMMMString(annotationJson, "author");
-            annotation.m_content = readMMMString(annotationJson, "content");
-
-            const std::string targetKind =
-                readMMMString(annotationJson, "target_kind", "timestamp");
-            if ( targetKind == "player_object" ) {
-                annotation.m_targetKind =
-                    BeatmapAnnotationTargetKind::PLAYER_OBJECT;
-            } else if ( targetKind == "audio_sample" ) {
-                annotation.m_targetKind =
-                    BeatmapAnnotationTargetKind::AUDIO_SAMPLE;
-            } else if ( targetKind != "timestamp" ) {
-                continue;
+                ++kept;
             }
-
-            if ( annotation.m_id.empty() ||
-                 annotation.m_id.size() > MAX_BEATMAP_ANNOTATION_ID_BYTES ||
-                 annotation.m_targetId.size() >
-                     MAX_BEATMAP_ANNOTATION_ID_BYTES ||
-                 annotation.m_author.size() >
-                     MAX_BEATMAP_ANNOTATION_AUTHOR_BYTES ||
-                 annotation.m_content.empty() ||
-                 annotation.m_content.size() >
-                     MAX_BEATMAP_ANNOTATION_CONTENT_BYTES ||
-                 !annotationIds.insert(annotation.m_id).second ||
-                 (annotation.m_targetKind !=
-                      BeatmapAnnotationTargetKind::TIMESTAMP &&
-                  annotation.m_targetId.empty()) ) {
-                continue;
+            items.resize(kept);
+        };
+        compact(beatMap.m_noteData.notes);
+        compact(beatMap.m_noteData.holds);
+        compact(beatMap.m_noteData.flicks);
+
+        auto relocate = [&relocated](auto& refs) {
+            for ( auto& ref : refs ) {
+                const auto it = relocated.find(&ref.get());
+                if ( it == relocated.end() ) continue;
+                ref = static_cast<
+                    std::remove_reference_t<decltype(ref.get())>&>(
+                    *it->second);
             }
-            beatMap.m_annotations.push_back(std::move(annotation));
+        };
+        for ( auto& poly : beatMap.m_noteData.polylines ) {
+            relocate(poly.m_subNotes);
+            relocate(poly.m_subHolds);
+            relocate(poly.m_subFlicks);
         }
     }
 
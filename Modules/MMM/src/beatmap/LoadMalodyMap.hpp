@@ -1,6 +1,8 @@
 #pragma once
 
+#include "JsonStreamReader.h"
 #include "MalodyVolume.h"
+#include "MappedFile.h"
 
 #include "config/Utf8Path.h"
 #include "log/colorful-log.h"
@@ -10,12 +12,13 @@
 #include <cmath>
 #include <cstdint>
 #include <filesystem>
-#include <fstream>
 #include <limits>
 #include <map>
 #include <nlohmann/json.hpp>
 #include <optional>
 #include <set>
+#include <span>
+#include <string_view>
 #include <vector>
 
 using json = nlohmann::json;
@@ -75,10 +78,23 @@ inline std::int64_t readMalodyJsonInt64(const json& object, const char* key,
     return static_cast<std::int64_t>(std::llround(value));
 }
 
+/// @brief 按 `json::get<int>()` 的规则读取 Malody JSON 整数，不抛出异常。
+/// @param value 待读取的 JSON 值。
+/// @param out 读取结果。
+/// @return 值为数字或布尔时返回 true；其他类型返回 false，out 不变。
+inline bool readMalodyJsonInt(const json& value, int& out)
+{
+    if ( !value.is_number() && !value.is_boolean() ) return false;
+    out = value.get<int>();
+    return true;
+}
+
 /// @brief 从 Malody `.mc` JSON 文件加载谱面。
 /// @param path 待加载的谱面路径。
+/// @param headerOnly 只读取 meta 段，找到后立即停止，不读取 note 数组。
 /// @return 加载后的谱面；文件或 JSON 无效时返回空谱面。
-inline BeatMap loadMalodyMap(std::filesystem::path path)
+inline BeatMap loadMalodyMap(std::filesystem::path path,
+                             bool                  headerOnly = false)
 {
     // 创建谱面
     BeatMap beatMap;
@@ -97,21 +113,261 @@ inline BeatMap loadMalodyMap(std::filesystem::path path)
 
     XINFO("加载malody谱面路径:{}", Config::pathToUtf8(basemeta.map_path));
 
-    std::ifstream fs{ path };
-    if ( !fs.is_open() ) {
+    // 以内存映射读取：原文不占用堆内存，头部探测时 meta 之后的页也不会
+    // 被读入。
+    Internal::MappedFile mappedFile;
+    if ( !mappedFile.open(path) ) {
         XERROR("无法打开 malody 谱面文件: {}", Config::pathToUtf8(path));
         return {};
     }
+    const std::string_view text = mappedFile.bytes();
 
-    json        fileData;
-    std::string fileContent((std::istreambuf_iterator<char>(fs)),
-                            std::istreambuf_iterator<char>());
-    fileData = json::parse(fileContent, nullptr, false, true);
-
-    if ( fileData.is_discarded() ) {
+    const auto parseFailed = [&path]() {
         XERROR("解析 malody 谱面 JSON 失败，可能存在严重的编码错误: {}",
                Config::pathToUtf8(path));
-        return {};
+        return BeatMap{};
+    };
+
+    // 辅助函数：将 Malody 的 beat [beat_index, numerator, denominator]
+    // 转换为绝对拍数 (float)
+    auto beatToDouble = [](const json& b) {
+        if ( !b.is_array() || b.size() < 3 ) return 0.0;
+        // Malody 的 beat 数组约定：第一个元素即为当前拍数索引，后续为细分偏移
+        // 绝对拍数 = beat_index + (numerator / denominator)
+        const double denominator = parseMalodyJsonDouble(b[2], 1.0);
+        if ( std::abs(denominator) <= 1e-9 ) return 0.0;
+        return parseMalodyJsonDouble(b[0], 0.0) +
+               (parseMalodyJsonDouble(b[1], 0.0) / denominator);
+    };
+
+    /// @brief 判断 note 条目是否为音效或 BGM 采样。
+    /// type 字段为字符串 ("SOUND") 或旧版整数 (1) 时不参与 key 数推断。
+    auto isSoundNote = [](const json& n) -> bool {
+        if ( n.contains("type") ) {
+            if ( n["type"].is_string() )
+                return n["type"].get<std::string>() == "SOUND";
+            if ( n["type"].is_number() ) {
+                return std::abs(parseMalodyJsonDouble(n["type"], 0.0) - 1.0) <=
+                       std::numeric_limits<double>::epsilon();
+            }
+        }
+        return false;
+    };
+
+    /// @brief note 数组中带 beat 的条目在解析时压缩出的记录。
+    /// @details 只保留物件转换用到的字段，语义与原 JSON 字段一致；
+    /// 需要原样往返的其余字段以 dump 文本存入 noteProps。
+    struct NoteRecord {
+        /// @brief beat 的绝对拍数。
+        double beat = 0.0;
+        /// @brief endbeat 的绝对拍数，仅 hasEndBeat 时有效。
+        double endBeat = 0.0;
+        /// @brief vol 字段，Malody 增益百分比。
+        double vol = 0.0;
+        int    column = 0;
+        int    x      = 0;
+        int    dir    = 0;
+        int    w      = 0;
+        /// @brief seg 在 noteSegments 中的起点与个数。
+        std::uint32_t segBegin = 0;
+        std::uint32_t segCount = 0;
+        /// @brief 其余字段在 noteProps 中的起点与个数。
+        std::uint32_t propsBegin = 0;
+        std::uint32_t propsCount = 0;
+        /// @brief 字符串 sound 在 noteSounds 中的序号。
+        std::uint32_t sound = std::numeric_limits<std::uint32_t>::max();
+        /// @brief 自动采样专有字段在 sampleRecords 中的序号。
+        std::uint32_t sample = 0;
+        bool isSound = false;
+        bool hasColumn = false;
+        bool hasX = false;
+        bool hasSeg = false;
+        bool hasEndBeat = false;
+        bool hasDir = false;
+        bool hasW = false;
+    };
+    /// @brief seg 的一个折点。
+    struct SegRecord {
+        double beat = 0.0;
+        int    x    = 0;
+    };
+    /// @brief 自动采样 (SOUND) 条目的专有字段。
+    struct SampleRecord {
+        double       offset   = 0.0;
+        std::int64_t offsetMs = 0;
+        /// @brief x 的数值，缺失或非数值时为 NaN。
+        double x = std::numeric_limits<double>::quiet_NaN();
+        /// @brief x 的原文，用于迁移诊断与往返保存。
+        std::string xDump;
+    };
+    constexpr std::uint32_t NO_SOUND = std::numeric_limits<std::uint32_t>::max();
+
+    std::vector<NoteRecord>                          noteRecords;
+    std::vector<SegRecord>                           noteSegments;
+    std::vector<std::pair<std::string, std::string>> noteProps;
+    std::vector<std::string>                         noteSounds;
+    std::vector<SampleRecord>                        sampleRecords;
+
+    // 轨道数推断的统计量随解析一并收集 (针对 Mode 7 / 坐标模式)
+    std::map<int, int> xFreq;
+    int                maxColumnField    = -1;
+    bool               hasX              = false;
+    int                playableNoteCount = 0;
+
+    /// @brief 把一个 note 条目压缩为 NoteRecord 并累计轨道统计。
+    /// @return 字段类型无法按整数读取等格式错误时返回 false。
+    auto collectNote = [&](const json& n) {
+        const bool isSound = isSoundNote(n);
+        // 非对象条目上 find 返回 end()，按缺少字段处理。
+        const auto columnIt       = n.find("column");
+        const bool hasColumnField = columnIt != n.end();
+        const auto xIt            = n.find("x");
+        const bool hasXField      = xIt != n.end();
+
+        int column = 0;
+        int x      = 0;
+        if ( !isSound ) {
+            ++playableNoteCount;
+            if ( hasColumnField ) {
+                if ( !readMalodyJsonInt(*columnIt, column) ) return false;
+                maxColumnField = std::max(maxColumnField, column);
+            } else if ( hasXField ) {
+                if ( !readMalodyJsonInt(*xIt, x) ) return false;
+                xFreq[x]++;
+                hasX = true;
+            }
+        }
+        if ( !n.contains("beat") ) return true;
+
+        NoteRecord& record = noteRecords.emplace_back();
+        record.beat        = beatToDouble(n["beat"]);
+        record.vol         = readMalodyJsonDouble(n, "vol", 0.0);
+        record.isSound     = isSound;
+        record.hasColumn   = hasColumnField;
+        record.column      = column;
+        record.hasX        = hasXField;
+        record.x           = x;
+        if ( auto sound = n.find("sound");
+             sound != n.end() && sound->is_string() ) {
+            record.sound = static_cast<std::uint32_t>(noteSounds.size());
+            noteSounds.push_back(sound->get_ref<const std::string&>());
+        }
+
+        // 原样保存的字段：自动采样与玩家物件各自排除已解析的字段。
+        auto keepProperty = [isSound](const std::string& key) {
+            if ( key == "type" || key == "sound" || key == "x" ||
+                 key == "vol" ) {
+                return false;
+            }
+            if ( isSound ) return key != "offset";
+            return key != "beat" && key != "column" && key != "w" &&
+                   key != "dir" && key != "endbeat" && key != "seg";
+        };
+        record.propsBegin = static_cast<std::uint32_t>(noteProps.size());
+        for ( auto it = n.begin(); it != n.end(); ++it ) {
+            if ( keepProperty(it.key()) ) {
+                noteProps.emplace_back(it.key(), it.value().dump());
+            }
+        }
+        record.propsCount = static_cast<std::uint32_t>(noteProps.size()) -
+                            record.propsBegin;
+
+        if ( isSound ) {
+            record.sample = static_cast<std::uint32_t>(sampleRecords.size());
+            SampleRecord& sample = sampleRecords.emplace_back();
+            sample.offset   = readMalodyJsonDouble(n, "offset", 0.0);
+            sample.offsetMs = readMalodyJsonInt64(n, "offset", 0);
+            if ( hasXField ) {
+                sample.x = parseMalodyJsonDouble(
+                    *xIt, std::numeric_limits<double>::quiet_NaN());
+                sample.xDump = xIt->dump();
+            }
+            return true;
+        }
+
+        if ( auto segIt = n.find("seg"); segIt != n.end() ) {
+            // seg 必须是非空的对象数组，折点 x 与根 x 按整数读取。
+            if ( !segIt->is_array() || segIt->empty() ) return false;
+            if ( hasXField && hasColumnField &&
+                 !readMalodyJsonInt(*xIt, record.x) ) {
+                return false;
+            }
+            record.hasSeg   = true;
+            record.segBegin = static_cast<std::uint32_t>(noteSegments.size());
+            record.segCount = static_cast<std::uint32_t>(segIt->size());
+            for ( const auto& s : *segIt ) {
+                if ( !s.is_object() ) return false;
+                SegRecord& seg = noteSegments.emplace_back();
+                if ( auto beatIt = s.find("beat"); beatIt != s.end() ) {
+                    seg.beat = beatToDouble(*beatIt);
+                }
+                if ( auto segXIt = s.find("x");
+                     segXIt != s.end() && !readMalodyJsonInt(*segXIt, seg.x) ) {
+                    return false;
+                }
+            }
+        } else if ( auto endBeatIt = n.find("endbeat"); endBeatIt != n.end() ) {
+            record.hasEndBeat = true;
+            record.endBeat    = beatToDouble(*endBeatIt);
+        } else if ( auto dirIt = n.find("dir"); dirIt != n.end() ) {
+            record.hasDir = true;
+            if ( !readMalodyJsonInt(*dirIt, record.dir) ) return false;
+            if ( auto wIt = n.find("w"); wIt != n.end() ) {
+                record.hasW = true;
+                if ( !readMalodyJsonInt(*wIt, record.w) ) return false;
+            }
+        }
+        return true;
+    };
+
+    // 单遍 SAX 解析：除 note 外的顶层字段体积很小，整体构建为 DOM；note 数组
+    // 每构建完一个条目就压缩为 NoteRecord 并丢弃其 DOM。轨道数推断需要看完
+    // 全部条目，且 time 可能位于 note 之后，物件在解析结束后才转换为 NoteData。
+    json fileData = json::object();
+    if ( headerOnly ) {
+        Internal::visitJsonObjectMembers(
+            text, true, [&fileData](Internal::JsonMemberSlice&& member) {
+                if ( member.key != "meta" ) return true;
+                auto value = json::parse(member.value, nullptr, false, true);
+                if ( !value.is_discarded() ) {
+                    fileData["meta"] = std::move(value);
+                }
+                return false;
+            });
+    } else {
+        Internal::JsonObjectSaxCallbacks callbacks{
+            [&](const std::string& key) {
+                if ( key != "note" ) return false;
+                // 同名键以最后一次出现为准，丢弃先前收集的记录与统计。
+                noteRecords.clear();
+                noteSegments.clear();
+                noteProps.clear();
+                noteSounds.clear();
+                sampleRecords.clear();
+                xFreq.clear();
+                maxColumnField    = -1;
+                hasX              = false;
+                playableNoteCount = 0;
+                return true;
+            },
+            collectNote,
+            [&](std::string&& key, json&& value) {
+                if ( key != "note" ) {
+                    fileData[key] = std::move(value);
+                    return true;
+                }
+                // note 不是数组时按 nlohmann 的遍历语义逐个产出条目。
+                for ( const auto& n : value ) {
+                    if ( !collectNote(n) ) return false;
+                }
+                return true;
+            }
+        };
+        // 顶层不是对象：合法 JSON 照常走完流程，只是读不到任何字段。
+        Internal::JsonObjectSax sax(callbacks);
+        if ( !sax.parse(text, true) ) return parseFailed();
+        // 原文已全部转为记录，在构建 NoteData 之前解除映射。
+        mappedFile.close();
     }
 
     // 1. 解析基础元数据 (Meta)
@@ -176,18 +432,16 @@ inline BeatMap loadMalodyMap(std::filesystem::path path)
         beatMap.m_metadata.map_properties[MapMetadataType::MALODY]["extra"] =
             fileData["extra"].dump();
     }
-
-    // 辅助函数：将 Malody 的 beat [beat_index, numerator, denominator]
-    // 转换为绝对拍数 (float)
-    auto beatToDouble = [](const json& b) {
-        if ( !b.is_array() || b.size() < 3 ) return 0.0;
-        // Malody 的 beat 数组约定：第一个元素即为当前拍数索引，后续为细分偏移
-        // 绝对拍数 = beat_index + (numerator / denominator)
-        const double denominator = parseMalodyJsonDouble(b[2], 1.0);
-        if ( std::abs(denominator) <= 1e-9 ) return 0.0;
-        return parseMalodyJsonDouble(b[0], 0.0) +
-               (parseMalodyJsonDouble(b[1], 0.0) / denominator);
-    };
+    if ( headerOnly ) {
+        // 轨道数取 mode_ext 中的声明值，不做基于物件坐标的推断；
+        // 坐标模式下声明为 0 时视为未知。
+        if ( basemeta.track_count <= 0 ) basemeta.track_count = -1;
+        basemeta.name = fmt::format("[mc] {} [{}] {}",
+                                    basemeta.title,
+                                    basemeta.track_count,
+                                    basemeta.version);
+        return beatMap;
+    }
 
     // 2. 收集原始时间事件
     struct RawEvent {
@@ -274,30 +528,14 @@ inline BeatMap loadMalodyMap(std::filesystem::path path)
         malodyMode = fileData["meta"].value("mode", 0);
     }
 
-    /// @brief 判断 note 条目是否为音效或 BGM 采样。
-    /// type 字段为字符串 ("SOUND") 或旧版整数 (1) 时不参与 key 数推断。
-    auto isSoundNote = [](const json& n) -> bool {
-        if ( n.contains("type") ) {
-            if ( n["type"].is_string() )
-                return n["type"].get<std::string>() == "SOUND";
-            if ( n["type"].is_number() ) {
-                return std::abs(parseMalodyJsonDouble(n["type"], 0.0) - 1.0) <=
-                       std::numeric_limits<double>::epsilon();
-            }
-        }
-        return false;
-    };
-
     /// @brief 判断自动采样是否引用 meta.song.file 指定的主音频。
-    /// @param node 待判断的 Malody note 节点。
+    /// @param record 待判断的 note 记录。
     /// @return sound 字段与主音频路径或文件名一致时返回 true。
-    auto isMainSongSample = [&](const json& node) {
-        const auto sound = node.find("sound");
-        if ( sound == node.end() || !sound->is_string() ||
-             basemeta.song_file_hint.empty() ) {
+    auto isMainSongSample = [&](const NoteRecord& record) {
+        if ( record.sound == NO_SOUND || basemeta.song_file_hint.empty() ) {
             return false;
         }
-        const std::string& resourceId = sound->get_ref<const std::string&>();
+        const std::string& resourceId = noteSounds[record.sound];
         const std::string  songFileValue =
             Config::pathToUtf8(basemeta.song_file_hint);
         if ( resourceId == songFileValue ) return true;
@@ -305,68 +543,59 @@ inline BeatMap loadMalodyMap(std::filesystem::path path)
                basemeta.song_file_hint.filename();
     };
 
-    /// @brief 与首红线 delay 成对编码歌曲相位的主 SOUND 节点。
-    const json* wrappedMainSoundNode = nullptr;
+    /// @brief 与首红线 delay 成对编码歌曲相位的主 SOUND 记录在 noteRecords
+    /// 中的序号。
+    std::optional<std::size_t> wrappedMainSoundIndex;
     /// @brief 首红线相对主音频零点的规范化相位，单位为毫秒。
     double wrappedFirstTimingPhaseMs = 0.0;
-    if ( !bpmEvents.empty() && fileData.contains("note") ) {
+    const bool detectWrappedMainSound =
+        !bpmEvents.empty() && bpmEvents.front().delayMs >= -1e-6;
+
+    /// @brief 检查记录是否为与首红线成对的主 SOUND，是则记录歌曲相位。
+    auto matchWrappedMainSound = [&](const NoteRecord& record) {
+        if ( !record.isSound || !isMainSongSample(record) ) {
+            return false;
+        }
         const auto&  firstBpmEvent = bpmEvents.front();
         const double firstBpm =
             firstBpmEvent.bpm > 0.0 ? firstBpmEvent.bpm : 120.0;
         const double firstBeatLengthMs = 60000.0 / firstBpm;
-        if ( firstBpmEvent.delayMs >= -1e-6 ) {
-            for ( const auto& node : fileData["note"] ) {
-                if ( !isSoundNote(node) || !isMainSongSample(node) ||
-                     !node.contains("beat") ) {
-                    continue;
-                }
-                const double sampleBeat = beatToDouble(node["beat"]);
-                const double sampleOffset =
-                    readMalodyJsonDouble(node, "offset", 0.0);
-                // Malody 自动测速把“音频零点减首拍相位”按首拍长回卷到
-                // 非负区间，并把结果同时写入 time.delay 与主 SOUND.offset。
-                // 两个字段成对且资源匹配时才可按歌曲相位逆变换。
-                if ( std::abs(sampleBeat - firstBpmEvent.beat) <= 1e-6 &&
-                     sampleOffset >= -1e-6 &&
-                     std::abs(sampleOffset - firstBpmEvent.delayMs) <= 0.51 ) {
-                    wrappedMainSoundNode = &node;
-                    wrappedFirstTimingPhaseMs =
-                        std::fmod(-firstBpmEvent.delayMs, firstBeatLengthMs);
-                    if ( wrappedFirstTimingPhaseMs < 0.0 ) {
-                        wrappedFirstTimingPhaseMs += firstBeatLengthMs;
-                    }
-                    if ( std::abs(wrappedFirstTimingPhaseMs) <= 1e-6 ||
-                         std::abs(wrappedFirstTimingPhaseMs -
-                                  firstBeatLengthMs) <= 1e-6 ) {
-                        wrappedFirstTimingPhaseMs = 0.0;
-                    }
-                    break;
-                }
-            }
+        const double sampleBeat        = record.beat;
+        const double sampleOffset = sampleRecords[record.sample].offset;
+        // Malody 自动测速把“音频零点减首拍相位”按首拍长回卷到
+        // 非负区间，并把结果同时写入 time.delay 与主 SOUND.offset。
+        // 两个字段成对且资源匹配时才可按歌曲相位逆变换。
+        if ( std::abs(sampleBeat - firstBpmEvent.beat) > 1e-6 ||
+             sampleOffset < -1e-6 ||
+             std::abs(sampleOffset - firstBpmEvent.delayMs) > 0.51 ) {
+            return false;
         }
-    }
-
-    // 2.5 预扫描：通过统计学特征自动识别轨道数 (针对 Mode 7 / 坐标模式)
-    std::map<int, int> xFreq;
-    int                maxColumnField    = -1;
-    bool               hasX              = false;
-    int                playableNoteCount = 0;
-    int                metadataTrackCount =
-        basemeta.track_count > 0 ? basemeta.track_count : -1;
+        wrappedFirstTimingPhaseMs =
+            std::fmod(-firstBpmEvent.delayMs, firstBeatLengthMs);
+        if ( wrappedFirstTimingPhaseMs < 0.0 ) {
+            wrappedFirstTimingPhaseMs += firstBeatLengthMs;
+        }
+        if ( std::abs(wrappedFirstTimingPhaseMs) <= 1e-6 ||
+             std::abs(wrappedFirstTimingPhaseMs - firstBeatLengthMs) <=
+                 1e-6 ) {
+            wrappedFirstTimingPhaseMs = 0.0;
+        }
+        return true;
+    };
 
-    if ( fileData.contains("note") ) {
-        for ( const auto& n : fileData["note"] ) {
-            if ( isSoundNote(n) ) continue;
-            ++playableNoteCount;
-            if ( n.contains("column") ) {
-                maxColumnField = std::max(maxColumnField, n.value("column", 0));
-            } else if ( n.contains("x") ) {
-                xFreq[n["x"].get<int>()]++;
-                hasX = true;
+    if ( detectWrappedMainSound ) {
+        for ( std::size_t index = 0; index < noteRecords.size(); ++index ) {
+            if ( matchWrappedMainSound(noteRecords[index]) ) {
+                wrappedMainSoundIndex = index;
+                break;
             }
         }
     }
 
+    // 2.5 通过解析时收集的统计学特征自动识别轨道数 (针对 Mode 7 / 坐标模式)
+    int metadataTrackCount =
+        basemeta.track_count > 0 ? basemeta.track_count : -1;
+
     // 默认轨道数取 column 字段最大值
     int finalK = std::max(0, maxColumnField + 1);
 
@@ -451,11 +680,9 @@ inline BeatMap loadMalodyMap(std::filesystem::path path)
         return static_cast<uint32_t>(std::clamp(idx, 0, finalK - 1));
     };
 
-    auto getNoteTrackIndex = [&](const json& n) -> uint32_t {
-        if ( n.contains("column") ) return n.value("column", 0);
-        if ( n.contains("x") ) {
-            return getTrackIndexFromX(n["x"].get<int>());
-        }
+    auto getNoteTrackIndex = [&](const NoteRecord& record) -> uint32_t {
+        if ( record.hasColumn ) return static_cast<uint32_t>(record.column);
+        if ( record.hasX ) return getTrackIndexFromX(record.x);
         return 0;
     };
 
@@ -477,7 +704,7 @@ inline BeatMap loadMalodyMap(std::filesystem::path path)
         if ( index == 0 ) {
             const double firstBpm   = ev.bpm > 0.0 ? ev.bpm : getInitialBpm();
             const double beatLength = 60000.0 / firstBpm;
-            if ( wrappedMainSoundNode != nullptr ) {
+            if ( wrappedMainSoundIndex.has_value() ) {
                 ev.timestamp = ev.beat * beatLength + wrappedFirstTimingPhaseMs;
             } else {
                 ev.timestamp = ev.beat * beatLength + ev.delayMs;
@@ -499,7 +726,7 @@ inline BeatMap loadMalodyMap(std::filesystem::path path)
 
     /// @brief 正相位回卷时 note[] 内容在 Malody 拍轴上的整拍补偿。
     const double malodyNoteBeatShift =
-        wrappedMainSoundNode != nullptr && !bpmEvents.empty() &&
+        wrappedMainSoundIndex.has_value() && !bpmEvents.empty() &&
                 bpmEvents.front().timestamp > 1e-6 &&
                 wrappedFirstTimingPhaseMs > 1e-6
             ? 1.0
@@ -605,219 +832,194 @@ inline BeatMap loadMalodyMap(std::filesystem::path path)
                  static_cast<std::uint32_t>(std::max(0, finalK)));
     std::size_t legacyAutoPositionedSampleCount = 0;
 
-    if ( fileData.contains("note") ) {
-        for ( const auto& n : fileData["note"] ) {
-            if ( !n.contains("beat") ) continue;
+    for ( std::size_t index = 0; index < noteRecords.size(); ++index ) {
+        NoteRecord& r = noteRecords[index];
+        const auto  recordProps =
+            std::span(noteProps).subspan(r.propsBegin, r.propsCount);
+
+        const bool isAutomaticSample = r.isSound;
+        const bool isWrappedMainSample =
+            isAutomaticSample && wrappedMainSoundIndex == index;
+        double startBeat = r.beat;
+        if ( !isWrappedMainSample ) {
+            startBeat -= malodyNoteBeatShift;
+        }
+        double startTime = getAbsTime(startBeat);
 
-            const bool isAutomaticSample = isSoundNote(n);
-            const bool isWrappedMainSample =
-                isAutomaticSample && &n == wrappedMainSoundNode;
-            double startBeat = beatToDouble(n["beat"]);
-            if ( !isWrappedMainSample ) {
-                startBeat -= malodyNoteBeatShift;
+        if ( isAutomaticSample ) {
+            if ( r.sound == NO_SOUND || noteSounds[r.sound].empty() ) {
+                continue;
             }
-            double startTime = getAbsTime(startBeat);
-
-            if ( isAutomaticSample ) {
-                const auto soundIt = n.find("sound");
-                if ( soundIt == n.end() || !soundIt->is_string() ||
-                     soundIt->get_ref<const std::string&>().empty() ) {
-                    continue;
-                }
-
-                AudioSampleEvent& sample =
-                    beatMap.m_audioSamples.emplace_back();
-                if ( isWrappedMainSample ) {
-                    // 成对字段只描述歌曲相位；MMM 内部将主音频物化在
-                    // 时间零点，避免把 Malody 的相位编码误当成局部 offset。
-                    sample.m_timestamp = 0.0;
-                    sample.m_offsetMs  = 0;
-                } else {
-                    sample.m_timestamp = startTime;
-                    sample.m_offsetMs  = readMalodyJsonInt64(n, "offset", 0);
-                }
-                sample.m_audioResourceId =
-                    soundIt->get_ref<const std::string&>();
-                sample.m_volume = Internal::malodyGainPercentToVolume(
-                    readMalodyJsonDouble(n, "vol", 0.0));
-
-                auto& props =
-                    sample.m_metadata
-                        .sample_properties[SampleMetadataType::MALODY];
-                for ( auto it = n.begin(); it != n.end(); ++it ) {
-                    if ( it.key() != "type" && it.key() != "sound" &&
-                         it.key() != "offset" && it.key() != "x" &&
-                         it.key() != "vol" ) {
-                        props[it.key()] = it.value().dump();
-                    }
+            SampleRecord& sampleRecord = sampleRecords[r.sample];
+
+            AudioSampleEvent& sample =
+                beatMap.m_audioSamples.emplace_back();
+            if ( isWrappedMainSample ) {
+                // 成对字段只描述歌曲相位；MMM 内部将主音频物化在
+                // 时间零点，避免把 Malody 的相位编码误当成局部 offset。
+                sample.m_timestamp = 0.0;
+                sample.m_offsetMs  = 0;
+            } else {
+                sample.m_timestamp = startTime;
+                sample.m_offsetMs  = sampleRecord.offsetMs;
+            }
+            sample.m_audioResourceId = std::move(noteSounds[r.sound]);
+            sample.m_volume = Internal::malodyGainPercentToVolume(r.vol);
+
+            auto& props =
+                sample.m_metadata
+                    .sample_properties[SampleMetadataType::MALODY];
+            for ( auto& [key, value] : recordProps ) {
+                props[key] = std::move(value);
+            }
+            const double parsedX  = sampleRecord.x;
+            const double roundedX = std::round(parsedX);
+            const bool   validBgmTrack =
+                std::isfinite(parsedX) &&
+                std::abs(parsedX - roundedX) <= 1e-6 &&
+                roundedX >= static_cast<double>(finalK) &&
+                roundedX <=
+                    static_cast<double>(std::numeric_limits<int>::max());
+            if ( !r.hasX ) {
+                const std::int64_t effectiveTimestampMs =
+                    static_cast<std::int64_t>(
+                        std::llround(sample.effectiveTimestamp()));
+                if ( !legacySampleEffectiveTimestampMs.has_value() ||
+                     *legacySampleEffectiveTimestampMs !=
+                         effectiveTimestampMs ) {
+                    legacySampleEffectiveTimestampMs = effectiveTimestampMs;
+                    nextLegacySampleTrack            = std::max(
+                        MALODY_LEGACY_SAMPLE_TRACK_BEGIN,
+                        static_cast<std::uint32_t>(std::max(0, finalK)));
                 }
-                const auto   xIt = n.find("x");
-                const double parsedX =
-                    xIt == n.end()
-                        ? std::numeric_limits<double>::quiet_NaN()
-                        : parseMalodyJsonDouble(
-                              *xIt, std::numeric_limits<double>::quiet_NaN());
-                const double roundedX = std::round(parsedX);
-                const bool   validBgmTrack =
-                    std::isfinite(parsedX) &&
-                    std::abs(parsedX - roundedX) <= 1e-6 &&
-                    roundedX >= static_cast<double>(finalK) &&
-                    roundedX <=
-                        static_cast<double>(std::numeric_limits<int>::max());
-                if ( xIt == n.end() ) {
-                    const std::int64_t effectiveTimestampMs =
-                        static_cast<std::int64_t>(
-                            std::llround(sample.effectiveTimestamp()));
-                    if ( !legacySampleEffectiveTimestampMs.has_value() ||
-                         *legacySampleEffectiveTimestampMs !=
-                             effectiveTimestampMs ) {
-                        legacySampleEffectiveTimestampMs = effectiveTimestampMs;
-                        nextLegacySampleTrack            = std::max(
-                            MALODY_LEGACY_SAMPLE_TRACK_BEGIN,
-                            static_cast<std::uint32_t>(std::max(0, finalK)));
-                    }
-                    sample.m_track = nextLegacySampleTrack;
-                    if ( nextLegacySampleTrack <
-                         std::numeric_limits<std::uint32_t>::max() ) {
-                        ++nextLegacySampleTrack;
-                    }
-                    props["original_x"] = "null";
-                    ++legacyAutoPositionedSampleCount;
-                } else if ( validBgmTrack ) {
-                    sample.m_track =
-                        static_cast<uint32_t>(static_cast<int>(roundedX));
-                } else {
-                    sample.m_track      = static_cast<uint32_t>(finalK);
-                    props["original_x"] = xIt == n.end() ? "null" : xIt->dump();
-                    beatMap.m_loadDiagnostics.push_back(
-                        { .m_code = BeatmapLoadDiagnosticCode::
-                              AUDIO_SAMPLE_TRACK_RELOCATED,
-                          .m_severity = BeatmapLoadDiagnosticSeverity::
-                              BEATMAP_LOAD_DIAGNOSTIC_SEVERITY_WARNING,
-                          .m_message = fmt::format(
-                              "Malody 自动采样 '{}' 的轨道 x={} 不属于 "
-                              "BGM 区，已迁移到首条 BGM 轨 {}",
-                              sample.m_audioResourceId,
-                              props["original_x"],
-                              finalK),
-                          .m_relatedPath = basemeta.map_path });
-                    XWARN(
-                        "Malody 自动采样 '{}' 的 BGM 轨道 x={} "
-                        "非法，已归入首个 "
-                        "BGM 轨道 {}",
-                        sample.m_audioResourceId,
-                        props["original_x"],
-                        finalK);
+                sample.m_track = nextLegacySampleTrack;
+                if ( nextLegacySampleTrack <
+                     std::numeric_limits<std::uint32_t>::max() ) {
+                    ++nextLegacySampleTrack;
                 }
-
-                const std::uint64_t requiredBgmTrackCount64 =
-                    static_cast<std::uint64_t>(sample.m_track) -
-                    static_cast<std::uint64_t>(finalK) + 1;
-                const int requiredBgmTrackCount =
-                    static_cast<int>(std::min<std::uint64_t>(
-                        requiredBgmTrackCount64,
-                        static_cast<std::uint64_t>(
-                            std::numeric_limits<int>::max())));
-                basemeta.bgm_track_count =
-                    std::max(basemeta.bgm_track_count, requiredBgmTrackCount);
-                basemeta.map_length =
-                    std::max(basemeta.map_length, sample.effectiveTimestamp());
-                continue;
+                props["original_x"] = "null";
+                ++legacyAutoPositionedSampleCount;
+            } else if ( validBgmTrack ) {
+                sample.m_track =
+                    static_cast<uint32_t>(static_cast<int>(roundedX));
+            } else {
+                sample.m_track      = static_cast<uint32_t>(finalK);
+                props["original_x"] = std::move(sampleRecord.xDump);
+                beatMap.m_loadDiagnostics.push_back(
+                    { .m_code = BeatmapLoadDiagnosticCode::
+                          AUDIO_SAMPLE_TRACK_RELOCATED,
+                      .m_severity = BeatmapLoadDiagnosticSeverity::
+                          BEATMAP_LOAD_DIAGNOSTIC_SEVERITY_WARNING,
+                      .m_message = fmt::format(
+                          "Malody 自动采样 '{}' 的轨道 x={} 不属于 "
+                          "BGM 区，已迁移到首条 BGM 轨 {}",
+                          sample.m_audioResourceId,
+                          props["original_x"],
+                          finalK),
+                      .m_relatedPath = basemeta.map_path });
+                XWARN(
+                    "Malody 自动采样 '{}' 的 BGM 轨道 x={} "
+                    "非法，已归入首个 "
+                    "BGM 轨道 {}",
+                    sample.m_audioResourceId,
+                    props["original_x"],
+                    finalK);
             }
 
-            uint32_t track =
-                std::clamp(getNoteTrackIndex(n),
+            const std::uint64_t requiredBgmTrackCount64 =
+                static_cast<std::uint64_t>(sample.m_track) -
+                static_cast<std::uint64_t>(finalK) + 1;
+            const int requiredBgmTrackCount =
+                static_cast<int>(std::min<std::uint64_t>(
+                    requiredBgmTrackCount64,
+                    static_cast<std::uint64_t>(
+                        std::numeric_limits<int>::max())));
+            basemeta.bgm_track_count =
+                std::max(basemeta.bgm_track_count, requiredBgmTrackCount);
+            basemeta.map_length =
+                std::max(basemeta.map_length, sample.effectiveTimestamp());
+            continue;
+        }
+
+        uint32_t track =
+            std::clamp(getNoteTrackIndex(r),
+                       0u,
+                       (uint32_t)std::max(0, basemeta.track_count - 1));
+
+        Note* notePtr = nullptr;
+
+        if ( r.hasSeg ) {
+            const auto segs =
+                std::span(noteSegments).subspan(r.segBegin, r.segCount);
+            double rootBeatRaw  = startBeat;
+            double firstSegBeat = rootBeatRaw + segs[0].beat;
+            double firstTime    = getAbsTime(firstSegBeat);
+
+            int      rootX   = r.hasX ? r.x : 0;
+            int      xOffset = segs[0].x;
+            int      firstX  = rootX + xOffset;
+            uint32_t firstSegTrack =
+                std::clamp(getTrackIndexFromX(firstX),
                            0u,
                            (uint32_t)std::max(0, basemeta.track_count - 1));
 
-            Note* notePtr = nullptr;
-
-            if ( n.contains("seg") ) {
-                auto   segs         = n["seg"];
-                double rootBeatRaw  = startBeat;
-                double firstSegBeat = rootBeatRaw + beatToDouble(segs[0].value(
-                                                        "beat", json::array()));
-                double firstTime    = getAbsTime(firstSegBeat);
-
-                int      rootX   = n.value("x", 0);
-                int      xOffset = segs[0].value("x", 0);
-                int      firstX  = rootX + xOffset;
-                uint32_t firstSegTrack =
-                    std::clamp(getTrackIndexFromX(firstX),
-                               0u,
-                               (uint32_t)std::max(0, basemeta.track_count - 1));
-
-                if ( segs.size() == 1 ) {
-                    if ( firstSegTrack == track ) {
-                        Hold& h       = beatMap.m_noteData.holds.emplace_back();
-                        h.m_type      = NoteType::HOLD;
-                        h.m_timestamp = startTime;
-                        h.m_track     = track;
-                        h.m_duration  = std::max(0.0, firstTime - startTime);
-                        notePtr       = &h;
-                    } else if ( firstTime == startTime ) {
-                        Flick& f = beatMap.m_noteData.flicks.emplace_back();
-                        f.m_type = NoteType::FLICK;
-                        f.m_timestamp = startTime;
-                        f.m_track     = track;
-                        f.m_dtrack    = (int32_t)firstSegTrack - (int32_t)track;
-                        notePtr       = &f;
-                    }
+            if ( segs.size() == 1 ) {
+                if ( firstSegTrack == track ) {
+                    Hold& h       = beatMap.m_noteData.holds.emplace_back();
+                    h.m_type      = NoteType::HOLD;
+                    h.m_timestamp = startTime;
+                    h.m_track     = track;
+                    h.m_duration  = std::max(0.0, firstTime - startTime);
+                    notePtr       = &h;
+                } else if ( firstTime == startTime ) {
+                    Flick& f = beatMap.m_noteData.flicks.emplace_back();
+                    f.m_type = NoteType::FLICK;
+                    f.m_timestamp = startTime;
+                    f.m_track     = track;
+                    f.m_dtrack    = (int32_t)firstSegTrack - (int32_t)track;
+                    notePtr       = &f;
                 }
+            }
 
-                if ( !notePtr ) {
-                    Polyline& poly =
-                        beatMap.m_noteData.polylines.emplace_back();
-                    poly.m_type      = NoteType::POLYLINE;
-                    poly.m_timestamp = startTime;
-                    poly.m_track     = track;
-
-                    uint32_t runningTrack = track;
-                    double   runningTime  = startTime;
-
-                    for ( size_t i = 0; i < segs.size(); ++i ) {
-                        const auto& s = segs[i];
-                        double      stepBeatValue =
-                            rootBeatRaw +
-                            beatToDouble(s.value("beat", json::array()));
-                        double stepTime = getAbsTime(stepBeatValue);
-
-                        int      stepAbsX  = rootX + s.value("x", 0);
-                        uint32_t stepTrack = std::clamp(
-                            getTrackIndexFromX(stepAbsX),
-                            0u,
-                            (uint32_t)std::max(0, basemeta.track_count - 1));
-
-                        if ( stepTime > runningTime + 1e-7 ) {
-                            // 长按段。
-                            Hold& h  = beatMap.m_noteData.holds.emplace_back();
-                            h.m_type = NoteType::HOLD;
-                            h.m_timestamp = runningTime;
-                            h.m_track     = runningTrack;
-                            h.m_duration =
-                                std::max(0.0, stepTime - runningTime);
-                            h.m_isSubNote = true;
-
-                            poly.m_subNotes.push_back(h);
-                            poly.m_subHolds.push_back(h);
-
-                            if ( stepTrack != runningTrack ) {
-                                Flick& f =
-                                    beatMap.m_noteData.flicks.emplace_back();
-                                f.m_type      = NoteType::FLICK;
-                                f.m_timestamp = stepTime;
-                                f.m_track     = runningTrack;
-                                f.m_dtrack =
-                                    (int32_t)stepTrack - (int32_t)runningTrack;
-                                f.m_isSubNote = true;
-                                poly.m_subNotes.push_back(f);
-                                poly.m_subFlicks.push_back(f);
-                            }
-                        } else if ( stepTrack != runningTrack ) {
-                            // 瞬时 Flick，仅在轨道发生变化时创建。
-                            Flick& f = beatMap.m_noteData.flicks.emplace_back();
-                            f.m_type = NoteType::FLICK;
-                            f.m_timestamp = runningTime;
+            if ( !notePtr ) {
+                Polyline& poly =
+                    beatMap.m_noteData.polylines.emplace_back();
+                poly.m_type      = NoteType::POLYLINE;
+                poly.m_timestamp = startTime;
+                poly.m_track     = track;
+
+                uint32_t runningTrack = track;
+                double   runningTime  = startTime;
+
+                for ( size_t i = 0; i < segs.size(); ++i ) {
+                    const auto& s             = segs[i];
+                    double      stepBeatValue = rootBeatRaw + s.beat;
+                    double      stepTime      = getAbsTime(stepBeatValue);
+
+                    int      stepAbsX  = rootX + s.x;
+                    uint32_t stepTrack = std::clamp(
+                        getTrackIndexFromX(stepAbsX),
+                        0u,
+                        (uint32_t)std::max(0, basemeta.track_count - 1));
+
+                    if ( stepTime > runningTime + 1e-7 ) {
+                        // 长按段。
+                        Hold& h  = beatMap.m_noteData.holds.emplace_back();
+                        h.m_type = NoteType::HOLD;
+                        h.m_timestamp = runningTime;
+                        h.m_track     = runningTrack;
+                        h.m_duration =
+                            std::max(0.0, stepTime - runningTime);
+                        h.m_isSubNote = true;
+
+                        poly.m_subNotes.push_back(h);
+                        poly.m_subHolds.push_back(h);
+
+                        if ( stepTrack != runningTrack ) {
+                            Flick& f =
+                                beatMap.m_noteData.flicks.emplace_back();
+                            f.m_type      = NoteType::FLICK;
+                            f.m_timestamp = stepTime;
                             f.m_track     = runningTrack;
                             f.m_dtrack =
                                 (int32_t)stepTrack - (int32_t)runningTrack;
@@ -825,107 +1027,109 @@ inline BeatMap loadMalodyMap(std::filesystem::path path)
                             poly.m_subNotes.push_back(f);
                             poly.m_subFlicks.push_back(f);
                         }
-                        runningTime  = stepTime;
-                        runningTrack = stepTrack;
+                    } else if ( stepTrack != runningTrack ) {
+                        // 瞬时 Flick，仅在轨道发生变化时创建。
+                        Flick& f = beatMap.m_noteData.flicks.emplace_back();
+                        f.m_type = NoteType::FLICK;
+                        f.m_timestamp = runningTime;
+                        f.m_track     = runningTrack;
+                        f.m_dtrack =
+                            (int32_t)stepTrack - (int32_t)runningTrack;
+                        f.m_isSubNote = true;
+                        poly.m_subNotes.push_back(f);
+                        poly.m_subFlicks.push_back(f);
                     }
-                    notePtr = &poly;
-                }
-            } else if ( n.contains("endbeat") ) {
-                // 处理长条 Hold
-                double endBeat =
-                    beatToDouble(n["endbeat"]) - malodyNoteBeatShift;
-                double endTime   = getAbsTime(endBeat);
-                Hold&  hold      = beatMap.m_noteData.holds.emplace_back();
-                hold.m_type      = NoteType::HOLD;
-                hold.m_timestamp = startTime;
-                hold.m_track     = track;
-                hold.m_duration  = endTime - startTime;
-                notePtr          = &hold;
-            } else if ( n.contains("dir") ) {
-                int trackCount = basemeta.track_count;
-                int flickWidthBase =
-                    trackCount == 4   ? 60
-                    : trackCount == 5 ? 50
-                    : trackCount == 6 ? 40
-                    : trackCount == 7 ? 30
-                    : trackCount == 8
-                        ? 20
-                        : static_cast<int>(std::round(256.0 / trackCount));
-
-                // Flick 的 w
-                // 个位表示跨轨数；十位基数同时落在皮肤的键数识别区间。
-                Flick& flick      = beatMap.m_noteData.flicks.emplace_back();
-                flick.m_type      = NoteType::FLICK;
-                flick.m_timestamp = startTime;
-                flick.m_track     = track;
-
-                int wVal = n.value("w", flickWidthBase);
-                int distance;
-                if ( trackCount == 7 && wVal >= 37 ) {
-                    // 兼容旧写出器使用 37 作为 7K Flick 基数的文件。
-                    distance = wVal - 37;
-                } else if ( trackCount == 8 && wVal >= 32 ) {
-                    // 兼容旧写出器使用 32 作为 8K Flick 基数的文件。
-                    distance = wVal - 32;
-                } else {
-                    distance = wVal - flickWidthBase;
+                    runningTime  = stepTime;
+                    runningTrack = stepTrack;
                 }
-                distance = std::max(0, distance);
-
-                int direction = n.value("dir", 0);
-                // 8 为左 (-)，2 为右 (+)
-                flick.m_dtrack = (direction == 8) ? -distance : distance;
-                notePtr        = &flick;
+                notePtr = &poly;
+            }
+        } else if ( r.hasEndBeat ) {
+            // 处理长条 Hold
+            double endBeat   = r.endBeat - malodyNoteBeatShift;
+            double endTime   = getAbsTime(endBeat);
+            Hold&  hold      = beatMap.m_noteData.holds.emplace_back();
+            hold.m_type      = NoteType::HOLD;
+            hold.m_timestamp = startTime;
+            hold.m_track     = track;
+            hold.m_duration  = endTime - startTime;
+            notePtr          = &hold;
+        } else if ( r.hasDir ) {
+            int trackCount = basemeta.track_count;
+            int flickWidthBase =
+                trackCount == 4   ? 60
+                : trackCount == 5 ? 50
+                : trackCount == 6 ? 40
+                : trackCount == 7 ? 30
+                : trackCount == 8
+                    ? 20
+                    : static_cast<int>(std::round(256.0 / trackCount));
+
+            // Flick 的 w
+            // 个位表示跨轨数；十位基数同时落在皮肤的键数识别区间。
+            Flick& flick      = beatMap.m_noteData.flicks.emplace_back();
+            flick.m_type      = NoteType::FLICK;
+            flick.m_timestamp = startTime;
+            flick.m_track     = track;
+
+            int wVal = r.hasW ? r.w : flickWidthBase;
+            int distance;
+            if ( trackCount == 7 && wVal >= 37 ) {
+                // 兼容旧写出器使用 37 作为 7K Flick 基数的文件。
+                distance = wVal - 37;
+            } else if ( trackCount == 8 && wVal >= 32 ) {
+                // 兼容旧写出器使用 32 作为 8K Flick 基数的文件。
+                distance = wVal - 32;
             } else {
-                // 普通点点击 Note
-                Note& note       = beatMap.m_noteData.notes.emplace_back();
-                note.m_type      = NoteType::NOTE;
-                note.m_timestamp = startTime;
-                note.m_track     = track;
-                notePtr          = &note;
+                distance = wVal - flickWidthBase;
             }
+            distance = std::max(0, distance);
 
-            // 物件元数据存储
-            if ( notePtr ) {
-                if ( auto sound = n.find("sound");
-                     sound != n.end() && sound->is_string() ) {
-                    notePtr->setSampleBinding(
-                        { sound->get_ref<const std::string&>(),
-                          Internal::malodyGainPercentToVolume(
-                              readMalodyJsonDouble(n, "vol", 0.0)) });
-                }
+            int direction = r.dir;
+            // 8 为左 (-)，2 为右 (+)
+            flick.m_dtrack = (direction == 8) ? -distance : distance;
+            notePtr        = &flick;
+        } else {
+            // 普通点点击 Note
+            Note& note       = beatMap.m_noteData.notes.emplace_back();
+            note.m_type      = NoteType::NOTE;
+            note.m_timestamp = startTime;
+            note.m_track     = track;
+            notePtr          = &note;
+        }
 
-                auto& props = notePtr->m_metadata
-                                  .note_properties[NoteMetadataType::MALODY];
+        // 物件元数据存储
+        if ( notePtr ) {
+            if ( r.sound != NO_SOUND ) {
+                notePtr->setSampleBinding(
+                    { std::move(noteSounds[r.sound]),
+                      Internal::malodyGainPercentToVolume(r.vol) });
+            }
 
-                for ( auto it = n.begin(); it != n.end(); ++it ) {
-                    if ( it.key() != "beat" && it.key() != "column" &&
-                         it.key() != "x" && it.key() != "w" &&
-                         it.key() != "type" && it.key() != "dir" &&
-                         it.key() != "endbeat" && it.key() != "seg" &&
-                         it.key() != "sound" && it.key() != "vol" ) {
-                        props[it.key()] = it.value().dump();
-                    }
-                }
-                // beatMap.m_allNotes.push_back(*notePtr); // 统一由 sync() 处理
-
-                // 更新谱面最大长度
-                double noteEnd = notePtr->m_timestamp;
-                if ( notePtr->m_type == NoteType::HOLD ) {
-                    noteEnd += static_cast<Hold*>(notePtr)->m_duration;
-                } else if ( notePtr->m_type == NoteType::POLYLINE ) {
-                    Polyline& p = *static_cast<Polyline*>(notePtr);
-                    if ( !p.m_subNotes.empty() ) {
-                        Note& finalSub = p.m_subNotes.back();
-                        noteEnd        = finalSub.m_timestamp;
-                        if ( finalSub.m_type == NoteType::HOLD ) {
-                            noteEnd += static_cast<Hold&>(finalSub).m_duration;
-                        }
+            auto& props = notePtr->m_metadata
+                              .note_properties[NoteMetadataType::MALODY];
+
+            for ( auto& [key, value] : recordProps ) {
+                props[key] = std::move(value);
+            }
+            // beatMap.m_allNotes.push_back(*notePtr); // 统一由 sync() 处理
+
+            // 更新谱面最大长度
+            double noteEnd = notePtr->m_timestamp;
+            if ( notePtr->m_type == NoteType::HOLD ) {
+                noteEnd += static_cast<Hold*>(notePtr)->m_duration;
+            } else if ( notePtr->m_type == NoteType::POLYLINE ) {
+                Polyline& p = *static_cast<Polyline*>(notePtr);
+                if ( !p.m_subNotes.empty() ) {
+                    Note& finalSub = p.m_subNotes.back();
+                    noteEnd        = finalSub.m_timestamp;
+                    if ( finalSub.m_type == NoteType::HOLD ) {
+                        noteEnd += static_cast<Hold&>(finalSub).m_duration;
                     }
                 }
-                if ( noteEnd > basemeta.map_length ) {
-                    basemeta.map_length = noteEnd;
-                }
+            }
+            if ( noteEnd > basemeta.map_length ) {
+                basemeta.map_length = noteEnd;
             }
         }
     }
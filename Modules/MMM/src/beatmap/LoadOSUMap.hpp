@@ -1,5 +1,8 @@
 #pragma once
 
+#include "FileBuffer.h"
+#include "MappedFile.h"
+
 #include "config/Utf8Path.h"
 #include "log/colorful-log.h"
 #include "mmm/SafeParse.h"
@@ -9,8 +12,9 @@
 #include <cmath>
 #include <cstdint>
 #include <filesystem>
-#include <fstream>
 #include <string>
+#include <string_view>
+#include <vector>
 
 namespace MMM
 {
@@ -40,6 +44,30 @@ static inline void trim(std::string& s)
     rtrim(s);
 }
 
+/// @brief 把逗号分隔的 osu! 字段切分为视图。
+/// @details 与 `std::getline(iss, token, ',')` 的切分语义一致：空串不产生字段，
+/// 末尾逗号之后的空字段被丢弃，中间的空字段保留。
+/// @param line 待切分的一行。
+/// @param fields 输出字段列表，调用前会被清空以复用容量。
+static inline void splitOsuFields(std::string_view               line,
+                                  std::vector<std::string_view>& fields)
+{
+    fields.clear();
+    std::size_t start = 0;
+    while ( start < line.size() ) {
+        const std::size_t end = line.find(',', start);
+        if ( end == std::string_view::npos ) {
+            fields.emplace_back(line.substr(start));
+            break;
+        }
+        fields.emplace_back(line.substr(start, end - start));
+        start = end + 1;
+    }
+}
+
+/// @brief osu! 文本读取器。
+/// @details 所有章节、键、值与物件行都是指向调用方文件缓冲区的视图，
+/// 解析过程中不为单行分配内存；缓冲区必须比读取器活得更久。
 class OsuFileReader
 {
 public:
@@ -48,23 +76,28 @@ public:
     // 析构OsuFileReader
     ~OsuFileReader() = default;
 
-    // 格式化过的属性
-    std::unordered_map<std::string,
-                       std::unordered_map<std::string, std::string, StringHash,
-                                          std::equal_to<>>,
-                       StringHash, std::equal_to<>>
-        map_properties;
+    /// @brief 一条 `键:值` 属性。
+    struct Property {
+        std::string_view chapter;
+        std::string_view key;
+        std::string_view value;
+    };
+
+    // 按出现顺序记录的属性，同名键以最后一次出现为准
+    std::vector<Property> map_properties;
+
+    // TimingPoints 与 HitObjects 段的原始行
+    std::vector<std::string_view> timing_lines;
+    std::vector<std::string_view> hitobject_lines;
 
     // 当前索引
-    uint32_t current_timing_index{ 0 };
-    uint32_t current_hitobject_index{ 0 };
     uint32_t current_breaks_index{ 0 };
 
     // 当前章节
-    std::string current_chapter;
+    std::string_view current_chapter;
 
     // 格式化行
-    void parse_line(const std::string& line)
+    void parse_line(std::string_view line)
     {
         if ( line.empty() ) return;
         if ( line.front() == '[' && line.back() == ']' ) {
@@ -75,70 +108,58 @@ public:
             //[HitObjects]	击打物件	逗号分隔的列表
 
             if ( current_chapter == "Events" ) {
-                auto start_5_string = line.substr(0, 5);
-                auto start_1_char   = line.front();
                 // 并非一定五个参数
                 if ( line.starts_with("Video,") || line.starts_with("1,") ) {
-                    map_properties[current_chapter]["background video"] = line;
-                } else if ( start_5_string == "Break" ) {
-                    map_properties[current_chapter]
-                                  ["Break" +
-                                   std::to_string(current_breaks_index++)] =
-                                      line;
-                } else if ( start_1_char == '0' ) {
+                    map_properties.push_back(
+                        { current_chapter, "background video", line });
+                } else if ( line.starts_with("Break") ) {
+                    ++current_breaks_index;
+                } else if ( line.front() == '0' ) {
                     // 通用背景事件。
-                    map_properties[current_chapter]["background"] = line;
+                    map_properties.push_back(
+                        { current_chapter, "background", line });
                 }
             } else if ( current_chapter == "TimingPoints" ) {
-                map_properties[current_chapter]
-                              [std::to_string(current_timing_index++)] = line;
+                timing_lines.push_back(line);
             } else if ( current_chapter == "HitObjects" ) {
-                map_properties[current_chapter]
-                              [std::to_string(current_hitobject_index++)] =
-                                  line;
+                hitobject_lines.push_back(line);
             } else {
                 size_t eq_pos = line.find(':');
-                if ( eq_pos != std::string::npos ) {
-                    std::string key   = line.substr(0, eq_pos);
-                    std::string value = line.substr(eq_pos + 1);
+                if ( eq_pos != std::string_view::npos ) {
+                    auto key   = line.substr(0, eq_pos);
+                    auto value = line.substr(eq_pos + 1);
                     // 去掉前导空格
-                    value.erase(0, value.find_first_not_of(" \t\n\r\f\v"));
+                    value.remove_prefix(
+                        std::min(value.find_first_not_of(" \t\n\r\f\v"),
+                                 value.size()));
                     // 去掉尾随空格
-                    value.erase(value.find_last_not_of(" \t\n\r\f\v") + 1);
+                    value = value.substr(
+                        0, value.find_last_not_of(" \t\n\r\f\v") + 1);
 
-                    map_properties[current_chapter][key] = value;
+                    map_properties.push_back({ current_chapter, key, value });
                 }
             }
         }
     }
 
     // 获取数据
-    template<typename T>
-    T get_value(const std::string& chapter, const std::string& key,
-                T default_value = T())
+    std::string_view get_value(std::string_view chapter, std::string_view key,
+                               std::string_view default_value = {}) const
     {
-        auto chapter_it = map_properties.find(chapter);
-        if ( chapter_it == map_properties.end() ) return default_value;
-
-        auto key_it = chapter_it->second.find(key);
-        if ( key_it == chapter_it->second.end() ) return default_value;
-
-        if constexpr ( std::is_same_v<T, std::string> ) {
-            // 类型为字符串时整个返回
-            return key_it->second;
-        } else {
-            std::istringstream iss(key_it->second);
-            T                  value;
-            iss >> value;
-            return value;
+        for ( auto it = map_properties.rbegin(); it != map_properties.rend();
+              ++it ) {
+            if ( it->chapter == chapter && it->key == key ) return it->value;
         }
+        return default_value;
     }
 };
 
 /// @brief 加载 osu! 谱面并迁移其单音频字段。
 /// @param path 谱面文件路径。
+/// @param headerOnly 读到 [TimingPoints] 或 [HitObjects] 段即停止，只解析
+/// 其前的 [General]、[Metadata]、[Difficulty] 与 [Events] 等段。
 /// @return 解析出的谱面数据。
-inline BeatMap loadOSUMap(std::filesystem::path path)
+inline BeatMap loadOSUMap(std::filesystem::path path, bool headerOnly = false)
 {
     BeatMap beatMap;
     beatMap.m_baseMapMetadata.map_path = path;
@@ -153,8 +174,14 @@ inline BeatMap loadOSUMap(std::filesystem::path path)
     }
     auto fname = basemeta.map_path.filename();
     XINFO("载入osu谱面路径:" + Config::pathToUtf8(basemeta.map_path));
-    std::ifstream ifs(basemeta.map_path);
-    if ( !ifs.is_open() ) {
+    // 整个文件一次读入单块缓冲区，后续所有解析都只持有指向它的视图。
+    // 头部探测改用内存映射，物件段所在的页不会被读入。
+    std::string          file_buffer;
+    Internal::MappedFile mapped_file;
+    const bool           opened =
+        headerOnly ? mapped_file.open(basemeta.map_path)
+                   : Internal::readFileBuffer(basemeta.map_path, file_buffer);
+    if ( !opened ) {
         XWARN("打开文件[{}]失败", Config::pathToUtf8(basemeta.map_path));
         return {};
     }
@@ -164,41 +191,62 @@ inline BeatMap loadOSUMap(std::filesystem::path path)
     auto& osumeta_props = beatMap.m_metadata.map_properties[OSU];
 
     /// 开始解析osu文件
-    OsuFileReader osureader;
-    std::string   read_buffer;
-    std::getline(ifs, read_buffer);
+    OsuFileReader    osureader;
+    std::string_view text =
+        headerOnly ? mapped_file.bytes() : std::string_view(file_buffer);
+    std::size_t      read_pos = 0;
+    std::string_view read_line;
+
+    // 与 std::getline 一致：按 '\n' 切分，末尾无换行的最后一行同样返回。
+    auto next_line = [&]() {
+        if ( read_pos >= text.size() ) return false;
+        std::size_t end = text.find('\n', read_pos);
+        if ( end == std::string_view::npos ) end = text.size();
+        read_line = text.substr(read_pos, end - read_pos);
+        read_pos  = end + 1;
+        return true;
+    };
+
+    next_line();
+#if defined(_WIN32)
+    // 文本模式流在 Windows 上会吞掉 "\r\n" 中的 '\r'，二进制读取需手动去掉。
+    if ( !read_line.empty() && read_line.back() == '\r' ) {
+        read_line.remove_suffix(1);
+    }
+#endif
 
-    auto cpos = read_buffer.find("format");
-    if ( cpos != std::string::npos ) {
+    auto cpos = read_line.find("format");
+    if ( cpos != std::string_view::npos ) {
         // 取出osu版本
-        auto vnum = read_buffer.substr(cpos + 8, read_buffer.size() - 1);
+        auto vnum = read_line.substr(cpos + 8);
         osumeta_props["file_format_version"] = vnum;
     } else {
-        // 清除可能的 EOF 标志
-        ifs.clear();
         // 回到文件开头
-        ifs.seekg(0, std::ios::beg);
+        read_pos = 0;
     }
 
-    while ( std::getline(ifs, read_buffer) ) {
-        if ( !read_buffer.empty() && read_buffer.back() == '\r' ) {
-            read_buffer.pop_back();
+    while ( next_line() ) {
+        if ( !read_line.empty() && read_line.back() == '\r' ) {
+            read_line.remove_suffix(1);
         }
         if (  // 未读到内容
-            read_buffer.empty() ||
+            read_line.empty() ||
             // 直接结束
-            read_buffer[0] == ';' ||
+            read_line[0] == ';' ||
             // 注释
-            (read_buffer.size() >= 2 && read_buffer[0] == '/' &&
-             read_buffer[1] == '/') )
+            read_line.starts_with("//") )
             continue;
-        osureader.parse_line(read_buffer);
+        osureader.parse_line(read_line);
+        if ( headerOnly && (osureader.current_chapter == "TimingPoints" ||
+                            osureader.current_chapter == "HitObjects") ) {
+            break;
+        }
     }
 
     // 读取 osu 谱面的 General 段。
     // 主音频文件相对路径
-    auto main_audio_rpath =
-        osureader.get_value("General", "AudioFilename", std::string(""));
+    std::string main_audio_rpath(
+        osureader.get_value("General", "AudioFilename"));
     // 去掉路径两端空白。
     trim(main_audio_rpath);
     osumeta_props["General::AudioFilename"] = main_audio_rpath;
@@ -207,111 +255,111 @@ inline BeatMap loadOSUMap(std::filesystem::path path)
     basemeta.song_file_hint  = basemeta.main_audio_path;
 
     osumeta_props["General::AudioLeadIn"] =
-        osureader.get_value("General", "AudioLeadIn", std::string("0"));
+        osureader.get_value("General", "AudioLeadIn", "0");
     osumeta_props["General::AudioHash"] =
-        osureader.get_value("General", "AudioHash", std::string(""));
+        osureader.get_value("General", "AudioHash", "");
     osumeta_props["General::PreviewTime"] =
-        osureader.get_value("General", "PreviewTime", std::string("-1"));
+        osureader.get_value("General", "PreviewTime", "-1");
     osumeta_props["General::Countdown"] =
-        osureader.get_value("General", "Countdown", std::string("1"));
+        osureader.get_value("General", "Countdown", "1");
 
     osumeta_props["General::SampleSet"] =
-        osureader.get_value("General", "SampleSet", std::string(""));
+        osureader.get_value("General", "SampleSet", "");
 
     osumeta_props["General::StackLeniency"] =
-        osureader.get_value("General", "StackLeniency", std::string("0.0"));
+        osureader.get_value("General", "StackLeniency", "0.0");
     osumeta_props["General::Mode"] =
-        osureader.get_value("General", "Mode", std::string("0"));
-    osumeta_props["General::LetterboxInBreaks"] = osureader.get_value(
-        "General", "LetterboxInBreaks", std::string("false"));
+        osureader.get_value("General", "Mode", "0");
+    osumeta_props["General::LetterboxInBreaks"] =
+        osureader.get_value("General", "LetterboxInBreaks", "false");
     osumeta_props["General::StoryFireInFront"] =
-        osureader.get_value("General", "StoryFireInFront", std::string("true"));
+        osureader.get_value("General", "StoryFireInFront", "true");
     osumeta_props["General::UseSkinSprites"] =
-        osureader.get_value("General", "UseSkinSprites", std::string("false"));
-    osumeta_props["General::AlwaysShowPlayfield"] = osureader.get_value(
-        "General", "AlwaysShowPlayfield", std::string("false"));
-    osumeta_props["General::OverlayPosition"] = osureader.get_value(
-        "General", "OverlayPosition", std::string("NoChange"));
+        osureader.get_value("General", "UseSkinSprites", "false");
+    osumeta_props["General::AlwaysShowPlayfield"] =
+        osureader.get_value("General", "AlwaysShowPlayfield", "false");
+    osumeta_props["General::OverlayPosition"] =
+        osureader.get_value("General", "OverlayPosition", "NoChange");
     osumeta_props["General::SkinPreference"] =
-        osureader.get_value("General", "SkinPreference", std::string(""));
+        osureader.get_value("General", "SkinPreference", "");
     osumeta_props["General::EpilepsyWarning"] =
-        osureader.get_value("General", "EpilepsyWarning", std::string("false"));
+        osureader.get_value("General", "EpilepsyWarning", "false");
     osumeta_props["General::CountdownOffset"] =
-        osureader.get_value("General", "CountdownOffset", std::string("0"));
+        osureader.get_value("General", "CountdownOffset", "0");
     osumeta_props["General::SpecialStyle"] =
-        osureader.get_value("General", "SpecialStyle", std::string("false"));
-    osumeta_props["General::WidescreenStoryboard"] = osureader.get_value(
-        "General", "WidescreenStoryboard", std::string("false"));
-    osumeta_props["General::SamplesMatchPlaybackRate"] = osureader.get_value(
-        "General", "SamplesMatchPlaybackRate", std::string("false"));
+        osureader.get_value("General", "SpecialStyle", "false");
+    osumeta_props["General::WidescreenStoryboard"] =
+        osureader.get_value("General", "WidescreenStoryboard", "false");
+    osumeta_props["General::SamplesMatchPlaybackRate"] =
+        osureader.get_value("General", "SamplesMatchPlaybackRate", "false");
 
     // 读取 osu 谱面的 Editor 段。
     // Bookmarks 是逗号分隔的 Integer（整型）数组。
     // 书签（蓝线）的位置（毫秒）
     osumeta_props["Editor::Bookmarks"] =
-        osureader.get_value("Editor", "Bookmarks", std::string(""));
+        osureader.get_value("Editor", "Bookmarks", "");
     osumeta_props["Editor::DistanceSpacing"] =
-        osureader.get_value("Editor", "DistanceSpacing", std::string("0.0"));
+        osureader.get_value("Editor", "DistanceSpacing", "0.0");
     osumeta_props["Editor::BeatDivisor"] =
-        osureader.get_value("Editor", "BeatDivisor", std::string("0"));
+        osureader.get_value("Editor", "BeatDivisor", "0");
     osumeta_props["Editor::GridSize"] =
-        osureader.get_value("Editor", "GridSize", std::string("0"));
+        osureader.get_value("Editor", "GridSize", "0");
     osumeta_props["Editor::TimelineZoom"] =
-        osureader.get_value("Editor", "TimelineZoom", std::string("0.0"));
+        osureader.get_value("Editor", "TimelineZoom", "0.0");
 
     // 读取 osu 谱面的 Metadata 段。
     osumeta_props["Metadata::Title"] =
-        osureader.get_value("Metadata", "Title", std::string(""));
+        osureader.get_value("Metadata", "Title", "");
     basemeta.title = osumeta_props["Metadata::Title"];
 
     osumeta_props["Metadata::TitleUnicode"] =
-        osureader.get_value("Metadata", "TitleUnicode", std::string(""));
+        osureader.get_value("Metadata", "TitleUnicode", "");
     basemeta.title_unicode = osumeta_props["Metadata::TitleUnicode"];
 
     osumeta_props["Metadata::Artist"] =
-        osureader.get_value("Metadata", "Artist", std::string(""));
+        osureader.get_value("Metadata", "Artist", "");
     basemeta.artist = osumeta_props["Metadata::Artist"];
 
     osumeta_props["Metadata::ArtistUnicode"] =
-        osureader.get_value("Metadata", "ArtistUnicode", std::string(""));
+        osureader.get_value("Metadata", "ArtistUnicode", "");
     basemeta.artist_unicode = osumeta_props["Metadata::ArtistUnicode"];
 
     osumeta_props["Metadata::Creator"] =
-        osureader.get_value("Metadata", "Creator", std::string("mmm"));
+        osureader.get_value("Metadata", "Creator", "mmm");
     basemeta.author = osumeta_props["Metadata::Creator"];
 
     osumeta_props["Metadata::Version"] =
-        osureader.get_value("Metadata", "Version", std::string("[mmm]"));
+        osureader.get_value("Metadata", "Version", "[mmm]");
     basemeta.version = osumeta_props["Metadata::Version"];
 
     osumeta_props["Metadata::Source"] =
-        osureader.get_value("Metadata", "Source", std::string(""));
+        osureader.get_value("Metadata", "Source", "");
     // ***Tags	空格分隔的 String（字符串）数组	易于搜索的标签
     osumeta_props["Metadata::Tags"] =
-        osureader.get_value("Metadata", "Tags", std::string(""));
+        osureader.get_value("Metadata", "Tags", "");
     osumeta_props["Metadata::BeatmapID"] =
-        osureader.get_value("Metadata", "BeatmapID", std::string("-1"));
+        osureader.get_value("Metadata", "BeatmapID", "-1");
     osumeta_props["Metadata::BeatmapSetID"] =
-        osureader.get_value("Metadata", "BeatmapSetID", std::string("-1"));
+        osureader.get_value("Metadata", "BeatmapSetID", "-1");
 
     // 读取 osu 谱面的 Difficulty 段。
     osumeta_props["Difficulty::HPDrainRate"] =
-        osureader.get_value("Difficulty", "HPDrainRate", std::string("5.0"));
-    auto raw_circle_size =
-        osureader.get_value("Difficulty", "CircleSize", std::string("4.0"));
+        osureader.get_value("Difficulty", "HPDrainRate", "5.0");
+    std::string raw_circle_size(
+        osureader.get_value("Difficulty", "CircleSize", "4.0"));
     trim(raw_circle_size);
     osumeta_props["Difficulty::CircleSize"] = raw_circle_size;
     basemeta.track_count                    = static_cast<int32_t>(
         std::round(MMM::Internal::safeStod(raw_circle_size, 4.0)));
 
-    osumeta_props["Difficulty::OverallDifficulty"] = osureader.get_value(
-        "Difficulty", "OverallDifficulty", std::string("8.0"));
+    osumeta_props["Difficulty::OverallDifficulty"] =
+        osureader.get_value("Difficulty", "OverallDifficulty", "8.0");
     osumeta_props["Difficulty::ApproachRate"] =
-        osureader.get_value("Difficulty", "ApproachRate", std::string("0.0"));
-    osumeta_props["Difficulty::SliderMultiplier"] = osureader.get_value(
-        "Difficulty", "SliderMultiplier", std::string("0.0"));
+        osureader.get_value("Difficulty", "ApproachRate", "0.0");
+    osumeta_props["Difficulty::SliderMultiplier"] =
+        osureader.get_value("Difficulty", "SliderMultiplier", "0.0");
     osumeta_props["Difficulty::SliderTickRate"] =
-        osureader.get_value("Difficulty", "SliderTickRate", std::string("0.0"));
+        osureader.get_value("Difficulty", "SliderTickRate", "0.0");
 
     // 生成图名
     basemeta.name =
@@ -321,20 +369,15 @@ inline BeatMap loadOSUMap(std::filesystem::path path)
 
     // 读取 Events 段中的背景配置。
     // osu! 同时存在图片和视频事件时以视频为准；数字 1 与 Video 均表示视频。
-    auto background_des =
-        osureader.get_value("Events", "background video", std::string{});
+    auto background_des = osureader.get_value("Events", "background video");
     if ( background_des.empty() ) {
         background_des = osureader.get_value(
-            "Events", "background", std::string("0,0,\"bg.png\",0,0"));
+            "Events", "background", "0,0,\"bg.png\",0,0");
     }
     osumeta_props["Events::background"] = background_des;
-    std::string              token;
-    std::istringstream       biss(background_des);
-    std::vector<std::string> background_paras;
-    while ( std::getline(biss, token, ',') ) {
-        background_paras.emplace_back(token);
-    }
-    auto backgroundType = MMM::Internal::safeAt(background_paras, 0);
+    std::vector<std::string_view> background_paras;
+    splitOsuFields(background_des, background_paras);
+    std::string backgroundType(MMM::Internal::safeAt(background_paras, 0));
     trim(backgroundType);
     if ( backgroundType != "Video" && backgroundType != "1" ) {
         // 是图片
@@ -345,7 +388,8 @@ inline BeatMap loadOSUMap(std::filesystem::path path)
     }
     basemeta.video_starttime =
         MMM::Internal::safeStoi(MMM::Internal::safeAt(background_paras, 1));
-    auto cover_path = MMM::Internal::safeAt(background_paras, 2, "\"bg.png\"");
+    std::string cover_path(
+        MMM::Internal::safeAt(background_paras, 2, "\"bg.png\""));
     trim(cover_path);
     // 去引号
     if ( cover_path.starts_with('\"') ) {
@@ -369,70 +413,48 @@ inline BeatMap loadOSUMap(std::filesystem::path path)
     // 读取 Events 段中的休息段。
     auto& break_events = osumeta_props["Events::breaks"];
     for ( int i = 0; i < osureader.current_breaks_index; i++ ) {
-        auto breaks_des = osureader.get_value(
-            "Events", std::to_string(i), std::string("2,0,0"));
+        auto breaks_des =
+            osureader.get_value("Events", std::to_string(i), "2,0,0");
         // 添加一个休息段
         break_events.insert(
             break_events.end(), breaks_des.begin(), breaks_des.end());
         break_events.push_back('\n');
     }
 
+    // 逗号字段视图列表在所有物件与时间点之间复用，稳定后不再分配。
+    std::vector<std::string_view> paras;
+
     // 读取创建物件
-    for ( int i = 0; i < osureader.current_hitobject_index; i++ ) {
-        // 按顺序读取物件
-        auto note_des =
-            osureader.get_value("HitObjects",
-                                std::to_string(i),
-                                std::string("469,192,1846,1,0,0:0:0:0:"));
-        std::istringstream       noteiss(note_des);
-        std::vector<std::string> note_paras;
-        while ( std::getline(noteiss, token, ',') ) {
-            note_paras.emplace_back(token);
-        }
+    for ( const auto note_des : osureader.hitobject_lines ) {
+        splitOsuFields(note_des, paras);
 
-        // 创建物件
+        // 创建物件，直接在容器中原地构造
         if ( static_cast<int32_t>(MMM::Internal::safeStod(
-                 MMM::Internal::safeAt(note_paras, 3))) == 128 ) {
-            Hold hold;
-            hold.from_osu_description(note_paras, basemeta.track_count);
+                 MMM::Internal::safeAt(paras, 3))) == 128 ) {
+            Hold& hold = beatMap.m_noteData.holds.emplace_back();
+            hold.from_osu_description(paras, basemeta.track_count);
             // 更新谱面时长
             if ( hold.m_timestamp + hold.m_duration > basemeta.map_length )
                 basemeta.map_length = hold.m_timestamp + hold.m_duration;
-            // 把长条物件加入列表
-            beatMap.m_noteData.holds.push_back(hold);
         } else {
-            Note note;
+            Note& note = beatMap.m_noteData.notes.emplace_back();
             // 使用读取出的参数初始化物件
-            note.from_osu_description(note_paras, basemeta.track_count);
+            note.from_osu_description(paras, basemeta.track_count);
             // 更新谱面时长
             if ( int64_t(note.m_timestamp) > basemeta.map_length )
                 basemeta.map_length = note.m_timestamp;
-
-            // 加入物件列表
-            beatMap.m_noteData.notes.push_back(note);
         }
     }
 
     // 创建timing
     bool firstBpmSet = false;
-    for ( int i = 0; i < osureader.current_timing_index; i++ ) {
-        // 按顺序读取timing点
-        auto timing_point_des =
-            osureader.get_value("TimingPoints",
-                                std::to_string(i),
-                                std::string("10000,333.33,4,0,0,100,1,1"));
-        std::istringstream       timingiss(timing_point_des);
-        std::vector<std::string> timing_point_paras;
-        while ( std::getline(timingiss, token, ',') ) {
-            timing_point_paras.emplace_back(token);
-        }
+    beatMap.m_timings.reserve(osureader.timing_lines.size());
+    for ( const auto timing_point_des : osureader.timing_lines ) {
+        splitOsuFields(timing_point_des, paras);
 
-        // 创建timing
-        Timing timing;
-        // 使用读取出的参数初始化timing
-        timing.from_osu_description(timing_point_paras);
-        // 添加到timing表
-        beatMap.m_timings.push_back(timing);
+        // 创建timing并使用读取出的参数初始化
+        Timing& timing = beatMap.m_timings.emplace_back();
+        timing.from_osu_description(paras);
 
         // 设置预设 BPM (取第一个红线点)
         if ( !firstBpmSet && timing.m_timingEffect == TimingEffect::BPM ) {
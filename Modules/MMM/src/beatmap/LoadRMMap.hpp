@@ -65,8 +65,10 @@ inline std::filesystem::path resolveRMAudioPath(
 
 /// @brief 加载 RM/imd 谱面文件。
 /// @param path 谱面文件路径。
+/// @param headerOnly 只读取文件名信息、同名资源与开头的谱面时长，不读取
+/// 时间线与物件。
 /// @return 解析出的谱面数据。
-inline BeatMap loadRMMap(std::filesystem::path path)
+inline BeatMap loadRMMap(std::filesystem::path path, bool headerOnly = false)
 {
     // 创建谱面
     BeatMap beatMap;
@@ -165,6 +167,14 @@ inline BeatMap loadRMMap(std::filesystem::path path)
         }
     }
 
+    /// @brief 由文件名前缀、轨道数与版本组成的谱面显示名。
+    const auto makeMapName = [&]() {
+        return fmt::format("[rm] {} [{}k] {}",
+                           (file_presuffix.empty() ? "Map" : file_presuffix),
+                           basemeta.track_count,
+                           basemeta.version);
+    };
+
     // 实际执行二进制imd文件读取
     std::ifstream file(basemeta.map_path, std::ios::binary);
     if ( !file ) {
@@ -172,6 +182,21 @@ inline BeatMap loadRMMap(std::filesystem::path path)
         return {};
     }
 
+    // 头部探测只读取与完整加载相同的 8 字节最小头部，其后即为时间线与物件。
+    if ( headerOnly ) {
+        std::array<char, 8> header{};
+        if ( !file.read(header.data(), header.size()) ) {
+            XWARN("imd文件太小，格式不合法: {}",
+                  Config::pathToUtf8(basemeta.map_path));
+            return {};
+        }
+        basemeta.map_length = BinaryReader{}.read_value<int32_t>(header.data());
+        beatMap.m_metadata.map_properties[MapMetadataType::RM]["mapLength"] =
+            std::to_string(static_cast<int32_t>(basemeta.map_length));
+        basemeta.name = makeMapName();
+        return beatMap;
+    }
+
     // 获取文件大小
     file.seekg(0, std::ios::end);
     size_t fileSize = file.tellg();
@@ -392,11 +417,7 @@ inline BeatMap loadRMMap(std::filesystem::path path)
 
     beatMap.sync();
 
-    basemeta.name =
-        fmt::format("[rm] {} [{}k] {}",
-                    (file_presuffix.empty() ? "Map" : file_presuffix),
-                    basemeta.track_count,
-                    basemeta.version);
+    basemeta.name = makeMapName();
 
     return beatMap;
 }
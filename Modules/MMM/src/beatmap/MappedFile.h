@@ -0,0 +1,124 @@
+#pragma once
+
+#include <cstddef>
+#include <filesystem>
+#include <string_view>
+
+#ifdef _WIN32
+#    ifndef WIN32_LEAN_AND_MEAN
+#        define WIN32_LEAN_AND_MEAN
+#    endif
+#    ifndef NOMINMAX
+#        define NOMINMAX
+#    endif
+#    include <windows.h>
+#else
+#    include <fcntl.h>
+#    include <sys/mman.h>
+#    include <sys/stat.h>
+#    include <unistd.h>
+#endif
+
+namespace MMM::Internal
+{
+
+/// @brief 只读内存映射文件；空文件视为打开成功的空视图。
+class MappedFile
+{
+public:
+    MappedFile() = default;
+    explicit MappedFile(const std::filesystem::path& path) { open(path); }
+    ~MappedFile() { close(); }
+
+    MappedFile(const MappedFile&)            = delete;
+    MappedFile& operator=(const MappedFile&) = delete;
+
+    /// @brief 映射整个文件，替换当前映射。
+    /// @return 文件可以打开并映射时返回 true。
+    bool open(const std::filesystem::path& path)
+    {
+        close();
+#ifdef _WIN32
+        HANDLE file = CreateFileW(path.c_str(),
+                                  GENERIC_READ,
+                                  FILE_SHARE_READ | FILE_SHARE_DELETE,
+                                  nullptr,
+                                  OPEN_EXISTING,
+                                  FILE_ATTRIBUTE_NORMAL,
+                                  nullptr);
+        if ( file == INVALID_HANDLE_VALUE ) return false;
+        LARGE_INTEGER size{};
+        if ( !GetFileSizeEx(file, &size) ) {
+            CloseHandle(file);
+            return false;
+        }
+        if ( size.QuadPart > 0 ) {
+            HANDLE mapping =
+                CreateFileMappingW(file, nullptr, PAGE_READONLY, 0, 0, nullptr);
+            if ( mapping != nullptr ) {
+                m_data = static_cast<const char*>(
+                    MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0));
+                CloseHandle(mapping);
+            }
+            if ( m_data == nullptr ) {
+                CloseHandle(file);
+                return false;
+            }
+            m_size = static_cast<std::size_t>(size.QuadPart);
+        }
+        CloseHandle(file);
+#else
+        const int file = ::open(path.c_str(), O_RDONLY | O_CLOEXEC);
+        if ( file < 0 ) return false;
+        struct stat status {};
+        if ( ::fstat(file, &status) != 0 ) {
+            ::close(file);
+            return false;
+        }
+        if ( status.st_size > 0 ) {
+            void* data = ::mmap(nullptr,
+                                static_cast<std::size_t>(status.st_size),
+                                PROT_READ,
+                                MAP_PRIVATE,
+                                file,
+                                0);
+            if ( data == MAP_FAILED ) {
+                ::close(file);
+                return false;
+            }
+            m_data = static_cast<const char*>(data);
+            m_size = static_cast<std::size_t>(status.st_size);
+        }
+        ::close(file);
+#endif
+        m_open = true;
+        return true;
+    }
+
+    /// @brief 解除映射。
+    void close()
+    {
+        if ( m_data != nullptr ) {
+#ifdef _WIN32
+            UnmapViewOfFile(m_data);
+#else
+            ::munmap(const_cast<char*>(m_data), m_size);
+#endif
+        }
+        m_data = nullptr;
+        m_size = 0;
+        m_open = false;
+    }
+
+    [[nodiscard]] bool isOpen() const { return m_open; }
+
+    /// @brief 映射内容；仅在下一次 open() 或 close() 之前有效。
+    [[nodiscard]] std::string_view bytes() const { return { m_data, m_size }; }
+
+private:
+    const char* m_data{ nullptr };
+    std::size_t m_size{ 0 };
+    bool        m_open{ false };
+};
+
+}  // namespace MMM::Internal
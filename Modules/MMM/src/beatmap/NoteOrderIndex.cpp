@@ -0,0 +1,270 @@
+#include "mmm/beatmap/NoteOrderIndex.h"
+
+#include <algorithm>
+#include <cmath>
+
+namespace MMM
+{
+
+bool NoteOrderIndex::keyLess(const Note& lhs, const Note& rhs)
+{
+    if ( std::abs(lhs.m_timestamp - rhs.m_timestamp) > TIMESTAMP_EPSILON )
+        return lhs.m_timestamp < rhs.m_timestamp;
+    if ( lhs.m_track != rhs.m_track ) return lhs.m_track < rhs.m_track;
+    return lhs.m_type < rhs.m_type;
+}
+
+void NoteOrderIndex::assign(std::vector<value_type> refs)
+{
+    std::stable_sort(refs.begin(),
+                     refs.end(),
+                     [](const value_type& a, const value_type& b) {
+                         return keyLess(a.get(), b.get());
+                     });
+
+    m_chunks.clear();
+    m_chunks.reserve((refs.size() + FILL_CHUNK_SIZE - 1) / FILL_CHUNK_SIZE);
+    for ( size_type begin = 0; begin < refs.size(); begin += FILL_CHUNK_SIZE ) {
+        const size_type end = std::min(refs.size(), begin + FILL_CHUNK_SIZE);
+        m_chunks.emplace_back(refs.begin() + static_cast<difference_type>(begin),
+                              refs.begin() + static_cast<difference_type>(end));
+    }
+    m_size = refs.size();
+    updateChunkStarts(0);
+}
+
+NoteOrderIndex::iterator NoteOrderIndex::insert(Note& note)
+{
+    if ( m_chunks.empty() ) {
+        m_chunks.emplace_back().push_back(std::ref(note));
+        m_chunkStarts.assign(1, 0);
+        m_size = 1;
+        return begin();
+    }
+
+    auto [chunk, offset] = insertPosition(note);
+    auto& target         = m_chunks[chunk];
+    target.insert(target.begin() + static_cast<difference_type>(offset),
+                  std::ref(note));
+    ++m_size;
+
+    if ( target.size() > MAX_CHUNK_SIZE ) {
+        const size_type half = target.size() / 2;
+        splitIfNeeded(chunk);
+        if ( offset >= half ) {
+            ++chunk;
+            offset -= half;
+        }
+    } else {
+        updateChunkStarts(chunk + 1);
+    }
+    return { this, chunk, offset };
+}
+
+bool NoteOrderIndex::erase(const Note& note)
+{
+    const auto found = find(note);
+    if ( found == cend() ) return false;
+
+    auto& target = m_chunks[found.m_chunk];
+    target.erase(target.begin() + static_cast<difference_type>(found.m_offset));
+    --m_size;
+    compactAfterErase(found.m_chunk);
+    return true;
+}
+
+bool NoteOrderIndex::retime(Note& note, double timestamp)
+{
+    const bool indexed = erase(note);
+    note.m_timestamp   = timestamp;
+    if ( indexed ) insert(note);
+    return indexed;
+}
+
+void NoteOrderIndex::push_back(value_type ref)
+{
+    if ( m_chunks.empty() || m_chunks.back().size() >= FILL_CHUNK_SIZE ) {
+        m_chunks.emplace_back().reserve(FILL_CHUNK_SIZE);
+        m_chunkStarts.push_back(m_size);
+    }
+    m_chunks.back().push_back(ref);
+    ++m_size;
+}
+
+void NoteOrderIndex::reserve(size_type count)
+{
+    const size_type chunks = count / FILL_CHUNK_SIZE + 1;
+    m_chunks.reserve(chunks);
+    m_chunkStarts.reserve(chunks);
+}
+
+void NoteOrderIndex::clear()
+{
+    m_chunks.clear();
+    m_chunkStarts.clear();
+    m_size = 0;
+}
+
+void NoteOrderIndex::swap(NoteOrderIndex& other) noexcept
+{
+    m_chunks.swap(other.m_chunks);
+    m_chunkStarts.swap(other.m_chunkStarts);
+    std::swap(m_size, other.m_size);
+}
+
+NoteOrderIndex::const_iterator NoteOrderIndex::find(const Note& note) const
+{
+    // 排序键相同的引用相邻，先在键相同的区间内按地址查找。
+    for ( auto it = lowerBound(note); it != end(); ++it ) {
+        const Note& candidate = it->get();
+        if ( &candidate == &note ) return it;
+        if ( keyLess(note, candidate) ) break;
+    }
+
+    // 调用方在索引外修改了排序键时退化为线性查找，保证仍能删除。
+    for ( size_type chunk = 0; chunk < m_chunks.size(); ++chunk ) {
+        const auto& refs = m_chunks[chunk];
+        for ( size_type offset = 0; offset < refs.size(); ++offset ) {
+            if ( &refs[offset].get() == &note ) return { this, chunk, offset };
+        }
+    }
+    return end();
+}
+
+NoteOrderIndex::const_iterator NoteOrderIndex::lowerBound(
+    const Note& note) const
+{
+    const auto chunk = std::partition_point(
+        m_chunks.begin(), m_chunks.end(), [&note](const Chunk& refs) {
+            return keyLess(refs.back().get(), note);
+        });
+    if ( chunk == m_chunks.end() ) return end();
+
+    const auto offset = std::partition_point(
+        chunk->begin(), chunk->end(), [&note](const value_type& ref) {
+            return keyLess(ref.get(), note);
+        });
+    return { this,
+             static_cast<size_type>(chunk - m_chunks.begin()),
+             static_cast<size_type>(offset - chunk->begin()) };
+}
+
+bool NoteOrderIndex::isConsistent() const
+{
+    if ( m_chunkStarts.size() != m_chunks.size() ) return false;
+    size_type   expectedStart = 0;
+    const Note* previous      = nullptr;
+    for ( size_type chunk = 0; chunk < m_chunks.size(); ++chunk ) {
+        if ( m_chunks[chunk].empty() ||
+             m_chunks[chunk].size() > MAX_CHUNK_SIZE ||
+             m_chunkStarts[chunk] != expectedStart ) {
+            return false;
+        }
+        for ( const auto& ref : m_chunks[chunk] ) {
+            if ( previous && keyLess(ref.get(), *previous) ) return false;
+            previous = &ref.get();
+        }
+        expectedStart += m_chunks[chunk].size();
+    }
+    return expectedStart == m_size;
+}
+
+NoteOrderIndex::reference NoteOrderIndex::operator[](size_type index)
+{
+    const size_type chunk = chunkContaining(index);
+    return m_chunks[chunk][index - m_chunkStarts[chunk]];
+}
+
+NoteOrderIndex::const_reference NoteOrderIndex::operator[](
+    size_type index) const
+{
+    const size_type chunk = chunkContaining(index);
+    return m_chunks[chunk][index - m_chunkStarts[chunk]];
+}
+
+NoteOrderIndex::size_type NoteOrderIndex::chunkContaining(
+    size_type index) const
+{
+    const auto next =
+        std::upper_bound(m_chunkStarts.begin(), m_chunkStarts.end(), index);
+    return static_cast<size_type>(next - m_chunkStarts.begin()) - 1;
+}
+
+void NoteOrderIndex::updateChunkStarts(size_type firstChunk)
+{
+    m_chunkStarts.resize(m_chunks.size());
+    for ( size_type chunk = firstChunk; chunk < m_chunks.size(); ++chunk ) {
+        m_chunkStarts[chunk] =
+            chunk == 0 ? 0
+                       : m_chunkStarts[chunk - 1] + m_chunks[chunk - 1].size();
+    }
+}
+
+void NoteOrderIndex::splitIfNeeded(size_type chunk)
+{
+    if ( m_chunks[chunk].size() <= MAX_CHUNK_SIZE ) return;
+
+    auto&           source = m_chunks[chunk];
+    const size_type half   = source.size() / 2;
+    Chunk           upper(source.begin() + static_cast<difference_type>(half),
+                source.end());
+    source.erase(source.begin() + static_cast<difference_type>(half),
+                 source.end());
+    m_chunks.insert(m_chunks.begin() + static_cast<difference_type>(chunk + 1),
+                    std::move(upper));
+    updateChunkStarts(chunk + 1);
+}
+
+void NoteOrderIndex::compactAfterErase(size_type chunk)
+{
+    if ( m_chunks[chunk].empty() ) {
+        m_chunks.erase(m_chunks.begin() + static_cast<difference_type>(chunk));
+        updateChunkStarts(chunk);
+        return;
+    }
+
+    // 过小的分块并入相邻分块，避免大量删除后二分分块表退化。
+    if ( m_chunks[chunk].size() < MAX_CHUNK_SIZE / 4 ) {
+        if ( chunk + 1 < m_chunks.size() &&
+             m_chunks[chunk].size() + m_chunks[chunk + 1].size() <=
+                 MAX_CHUNK_SIZE ) {
+            auto& next = m_chunks[chunk + 1];
+            m_chunks[chunk].insert(
+                m_chunks[chunk].end(), next.begin(), next.end());
+            m_chunks.erase(m_chunks.begin() +
+                           static_cast<difference_type>(chunk + 1));
+        } else if ( chunk > 0 && m_chunks[chunk - 1].size() +
+                                         m_chunks[chunk].size() <=
+                                     MAX_CHUNK_SIZE ) {
+            auto& current = m_chunks[chunk];
+            m_chunks[chunk - 1].insert(
+                m_chunks[chunk - 1].end(), current.begin(), current.end());
+            m_chunks.erase(m_chunks.begin() +
+                           static_cast<difference_type>(chunk));
+            --chunk;
+        }
+    }
+    updateChunkStarts(chunk);
+}
+
+std::pair<NoteOrderIndex::size_type, NoteOrderIndex::size_type>
+NoteOrderIndex::insertPosition(const Note& note) const
+{
+    // 第一个末元素大于 note 的分块；都不大于时追加到最后一个分块。
+    const auto chunk = std::partition_point(
+        m_chunks.begin(), m_chunks.end(), [&note](const Chunk& refs) {
+            return !keyLess(note, refs.back().get());
+        });
+    if ( chunk == m_chunks.end() ) {
+        return { m_chunks.size() - 1, m_chunks.back().size() };
+    }
+
+    const auto offset = std::partition_point(
+        chunk->begin(), chunk->end(), [&note](const value_type& ref) {
+            return !keyLess(note, ref.get());
+        });
+    return { static_cast<size_type>(chunk - m_chunks.begin()),
+             static_cast<size_type>(offset - chunk->begin()) };
+}
+
+}  // namespace MMM
@@ -1,5 +1,8 @@
 #pragma once
 
+#include "FileBuffer.h"
+#include "SaveOutput.h"
+
 #include "config/Utf8Path.h"
 #include "log/colorful-log.h"
 #include "mmm/beatmap/BeatMap.h"
@@ -7,10 +10,11 @@
 #include <algorithm>
 #include <cmath>
 #include <filesystem>
-#include <fstream>
 #include <nlohmann/json.hpp>
+#include <numeric>
 #include <optional>
 #include <set>
+#include <string>
 #include <unordered_set>
 #include <vector>
 
@@ -172,9 +176,7 @@ inline bool saveMMMMap(const BeatMap&               beatMap,
         sampleArr.push_back(sampleJson);
     }
 
-    // 4. 玩家物件。
-    auto& noteArr = root["note"];
-    noteArr       = json::array();
+    // 4. 玩家物件。文本在最后与其余字段拼接。
 
     std::unordered_set<std::string> annotatedObjectIds;
     for ( const auto& annotation : beatMap.m_annotations ) {
@@ -423,33 +425,51 @@ inline bool saveMMMMap(const BeatMap&               beatMap,
         }
     }
 
-    std::vector<json> serializedNotes;
+    std::vector<const Note*> topLevelNotes;
+    topLevelNotes.reserve(beatMap.m_allNotes.size());
     for ( const auto& note : beatMap.m_noteData.notes ) {
         if ( subNotesSet.find(&note) == subNotesSet.end() )
-            serializedNotes.push_back(serializeNote(note));
+            topLevelNotes.push_back(&note);
     }
     for ( const auto& hold : beatMap.m_noteData.holds ) {
         if ( subNotesSet.find(&hold) == subNotesSet.end() )
-            serializedNotes.push_back(serializeNote(hold));
+            topLevelNotes.push_back(&hold);
     }
     for ( const auto& flick : beatMap.m_noteData.flicks ) {
         if ( subNotesSet.find(&flick) == subNotesSet.end() )
-            serializedNotes.push_back(serializeNote(flick));
+            topLevelNotes.push_back(&flick);
     }
     for ( const auto& poly : beatMap.m_noteData.polylines ) {
-        serializedNotes.push_back(serializeNote(poly));
+        topLevelNotes.push_back(&poly);
     }
 
-    // 按时间戳排序，保证写出稳定。
-    std::sort(serializedNotes.begin(),
-              serializedNotes.end(),
-              [](const json& a, const json& b) {
-                  return a["timestamp"].get<double>() <
-                         b["timestamp"].get<double>();
-              });
+    // 分片并行序列化并排版每个音符，同时记下排序用的写出时间戳。
+    std::vector<std::string> noteTexts(topLevelNotes.size());
+    std::vector<double>      noteTimestamps(topLevelNotes.size());
+    Internal::forEachSaveShard(
+        topLevelNotes.size(),
+        Internal::saveShardCount(topLevelNotes.size()),
+        [&](std::size_t, std::size_t begin, std::size_t end) {
+            for ( std::size_t i = begin; i < end; ++i ) {
+                const json n      = serializeNote(*topLevelNotes[i]);
+                noteTimestamps[i] = n["timestamp"].get<double>();
+                noteTexts[i]      = Internal::dumpJsonArrayElement(n);
+            }
+        });
 
-    for ( auto& n : serializedNotes ) {
-        noteArr.push_back(n);
+    // 按时间戳排序，保证写出稳定。对下标做与原先相同的 std::sort，
+    // 时间戳相同的音符保持与整体排序 JSON 数组时相同的相对顺序。
+    std::vector<std::size_t> noteOrder(topLevelNotes.size());
+    std::iota(noteOrder.begin(), noteOrder.end(), std::size_t{ 0 });
+    std::sort(noteOrder.begin(),
+              noteOrder.end(),
+              [&noteTimestamps](std::size_t a, std::size_t b) {
+                  return noteTimestamps[a] < noteTimestamps[b];
+              });
+    std::vector<std::string> orderedNoteTexts;
+    orderedNoteTexts.reserve(noteOrder.size());
+    for ( const std::size_t index : noteOrder ) {
+        orderedNoteTexts.push_back(std::move(noteTexts[index]));
     }
 
     // 5. 批注。按回退时间和稳定标识排序，保证写出稳定。
@@ -486,14 +506,12 @@ inline bool saveMMMMap(const BeatMap&               beatMap,
                                     { "content", annotation->m_content } });
     }
 
-    std::ofstream file(path);
-    if ( !file.is_open() ) {
-        XERROR("Failed to open file for saving mmm map: {}",
-               Config::pathToUtf8(path));
+    const std::string text =
+        Internal::dumpJsonWithArrayField(root, "note", orderedNoteTexts);
+    if ( !Internal::writeFileBufferAtomically(path, text, {}) ) {
+        XERROR("Failed to write mmm map: {}", Config::pathToUtf8(path));
         return false;
     }
-
-    file << root.dump(4);
     return true;
 }
 
@@ -1,6 +1,8 @@
 #pragma once
 
+#include "FileBuffer.h"
 #include "MalodyVolume.h"
+#include "SaveOutput.h"
 
 #include "mmm/beatmap/MalodyMode.h"
 
@@ -14,12 +16,12 @@
 #include <cmath>
 #include <cstdint>
 #include <filesystem>
-#include <fstream>
 #include <limits>
 #include <nlohmann/json.hpp>
 #include <numeric>
 #include <optional>
 #include <set>
+#include <string>
 #include <string_view>
 #include <system_error>
 #include <utility>
@@ -963,8 +965,8 @@ inline bool saveMalodyMap(const BeatMap& beatMap, std::filesystem::path path)
         return nj;
     };
 
-    auto& noteArr = fileData["note"];
-    noteArr       = json::array();
+    // note[] 先写自动采样、再写玩家物件；文本在最后与其余字段拼接。
+    std::vector<std::string> noteTexts;
 
     /// @brief 按当前模式序列化 Malody 自动采样对象。
     auto serializeAudioSample = [&](const AudioSampleEvent& sample) {
@@ -1055,8 +1057,10 @@ inline bool saveMalodyMap(const BeatMap& beatMap, std::filesystem::path path)
             }
             return lhs->m_offsetMs < rhs->m_offsetMs;
         });
+    noteTexts.reserve(sortedSamples.size());
     for ( const AudioSampleEvent* sample : sortedSamples ) {
-        noteArr.push_back(serializeAudioSample(*sample));
+        noteTexts.push_back(
+            Internal::dumpJsonArrayElement(serializeAudioSample(*sample)));
     }
 
     std::vector<const Note*> sortedNotes;
@@ -1088,17 +1092,26 @@ inline bool saveMalodyMap(const BeatMap& beatMap, std::filesystem::path path)
                   return a->m_track < b->m_track;
               });
 
-    for ( const Note* note : sortedNotes ) {
-        noteArr.push_back(serializeToMalody(*note));
-    }
+    // 玩家物件按已排好的顺序分片并行序列化与排版。
+    const std::size_t sampleTextCount = noteTexts.size();
+    noteTexts.resize(sampleTextCount + sortedNotes.size());
+    Internal::forEachSaveShard(
+        sortedNotes.size(),
+        Internal::saveShardCount(sortedNotes.size()),
+        [&](std::size_t, std::size_t begin, std::size_t end) {
+            for ( std::size_t i = begin; i < end; ++i ) {
+                noteTexts[sampleTextCount + i] = Internal::dumpJsonArrayElement(
+                    serializeToMalody(*sortedNotes[i]));
+            }
+        });
 
-    std::ofstream ofs(path);
-    if ( !ofs.is_open() ) {
-        XERROR("Failed to open file [{}] for Malody map write",
+    const std::string text =
+        Internal::dumpJsonWithArrayField(fileData, "note", noteTexts);
+    if ( !Internal::writeFileBufferAtomically(path, text, {}) ) {
+        XERROR("Failed to write Malody map file [{}]",
                Config::pathToUtf8(path));
         return false;
     }
-    ofs << fileData.dump(4);
     XINFO("Successfully saved map to {}", Config::pathToUtf8(path));
     return true;
 }
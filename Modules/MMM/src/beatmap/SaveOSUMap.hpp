@@ -1,5 +1,8 @@
 #pragma once
 
+#include "FileBuffer.h"
+#include "SaveOutput.h"
+
 #include "config/Utf8Path.h"
 #include "log/colorful-log.h"
 #include "mmm/beatmap/BeatMap.h"
@@ -9,8 +12,8 @@
 #include <cmath>
 #include <cstdint>
 #include <filesystem>
-#include <fstream>
 #include <functional>
+#include <sstream>
 #include <string>
 #include <unordered_set>
 #include <vector>
@@ -67,8 +70,7 @@ inline bool saveOSUMap(const BeatMap& beatMap, std::filesystem::path path)
     }
 
     auto map_it = beatMap.m_metadata.map_properties.find(OSU);
-    std::unordered_map<std::string, std::string, StringHash, std::equal_to<>>
-                empty_props;
+    MetadataProperties empty_props;
     const auto& osumeta_props =
         (map_it != beatMap.m_metadata.map_properties.end()) ? map_it->second
                                                             : empty_props;
@@ -113,11 +115,8 @@ inline bool saveOSUMap(const BeatMap& beatMap, std::filesystem::path path)
         }
     }
 
-    std::ofstream ofs(path);
-    if ( !ofs.is_open() ) {
-        XWARN("打开文件[{}]进行写出失败", Config::pathToUtf8(path));
-        return false;
-    }
+    // 文件头与时间点很短，仍用字符串流；物件段直接追加到同一缓冲区。
+    std::ostringstream ofs;
 
     auto format_ver = get_prop("file_format_version", "v14");
     if ( !format_ver.starts_with("v") ) format_ver = "v" + format_ver;
@@ -314,18 +313,33 @@ inline bool saveOSUMap(const BeatMap& beatMap, std::filesystem::path path)
                          return a.m_type < b.m_type;
                      });
 
-    for ( const auto& noteRef : export_notes ) {
-        Note& note = noteRef.get();
-        if ( note.m_type == NoteType::HOLD ) {
-            Hold& hold = static_cast<Hold&>(note);
-            ofs << hold.to_osu_description(
-                       beatMap.m_baseMapMetadata.track_count)
-                << "\n";
-        } else {
-            ofs << note.to_osu_description(
-                       beatMap.m_baseMapMetadata.track_count)
-                << "\n";
-        }
+    // 物件行按分片并行格式化到各自的缓冲区，再按顺序拼接。
+    constexpr std::size_t HIT_OBJECT_LINE_RESERVE = 48;
+    const std::size_t     shardCount =
+        Internal::saveShardCount(export_notes.size());
+    std::vector<std::string> shardTexts(shardCount);
+    Internal::forEachSaveShard(
+        export_notes.size(),
+        shardCount,
+        [&](std::size_t shard, std::size_t begin, std::size_t end) {
+            std::string& text = shardTexts[shard];
+            text.reserve((end - begin) * HIT_OBJECT_LINE_RESERVE);
+            for ( std::size_t i = begin; i < end; ++i ) {
+                export_notes[i].get().append_osu_description(
+                    text, beatMap.m_baseMapMetadata.track_count);
+                text += '\n';
+            }
+        });
+
+    std::string output = std::move(ofs).str();
+    std::size_t total  = output.size();
+    for ( const auto& text : shardTexts ) total += text.size();
+    output.reserve(total);
+    for ( const auto& text : shardTexts ) output += text;
+
+    if ( !Internal::writeFileBufferAtomically(path, output, {}) ) {
+        XWARN("打开文件[{}]进行写出失败", Config::pathToUtf8(path));
+        return false;
     }
 
     XINFO("Successfully saved osu map to {}", Config::pathToUtf8(path));
@@ -0,0 +1,117 @@
+#pragma once
+
+#include "mmm/ParallelExecutor.h"
+
+#include <algorithm>
+#include <cstddef>
+#include <nlohmann/json.hpp>
+#include <span>
+#include <string>
+#include <string_view>
+
+namespace MMM::Internal
+{
+
+/// @brief 单个保存分片的最少元素数；元素更少时在调用线程内串行处理。
+inline constexpr std::size_t SAVE_SHARD_MIN_ITEMS = 4096;
+
+/// @brief 处理 count 个元素时使用的分片数。
+/// @details 不超过注入执行器的并发数，且每片至少 SAVE_SHARD_MIN_ITEMS 个
+/// 元素；没有注入执行器（命令行工具与测试）时不分片。
+inline std::size_t saveShardCount(std::size_t count)
+{
+    return std::clamp<std::size_t>(
+        count / SAVE_SHARD_MIN_ITEMS, 1, parallelConcurrency());
+}
+
+/**
+ * @brief 把 [0, count) 切成 shardCount 个连续分片，经注入的执行器并行处理。
+ * @details 调度、死锁规避与异常传播见 parallelFor()；没有注入执行器时按
+ * 顺序串行处理。
+ * @param count 元素总数。
+ * @param shardCount 分片数，通常来自 saveShardCount()。
+ * @param work 以 (分片序号, 起始下标, 结束下标) 调用。
+ */
+template<typename Work>
+void forEachSaveShard(std::size_t count, std::size_t shardCount, Work&& work)
+{
+    shardCount = std::max<std::size_t>(1, shardCount);
+    if ( shardCount == 1 ) {
+        work(std::size_t{ 0 }, std::size_t{ 0 }, count);
+        return;
+    }
+    parallelFor(shardCount, [&](std::size_t shard) {
+        work(shard,
+             count * shard / shardCount,
+             count * (shard + 1) / shardCount);
+    });
+}
+
+/// @brief 根对象数组字段中元素所在层级的缩进（dump(4) 下为两层）。
+inline constexpr std::string_view JSON_ARRAY_ELEMENT_INDENT = "        ";
+
+/**
+ * @brief 以 dump(4) 排版单个数组元素，并缩进到根对象数组字段的层级。
+ * @details nlohmann 的缩进逐层累加，字符串内的换行均已转义，因此在每个
+ * 裸换行后补足外层缩进即得到与整体 dump 相同的文本。
+ * @param element 数组元素。
+ * @return 不含首行缩进的元素文本。
+ */
+inline std::string dumpJsonArrayElement(const nlohmann::json& element)
+{
+    const std::string text = element.dump(4);
+    std::string       nested;
+    nested.reserve(text.size() + text.size() / 4);
+    std::size_t start = 0;
+    for ( std::size_t end = text.find('\n'); end != std::string::npos;
+          end             = text.find('\n', start) ) {
+        nested.append(text, start, end + 1 - start);
+        nested += JSON_ARRAY_ELEMENT_INDENT;
+        start = end + 1;
+    }
+    nested.append(text, start);
+    return nested;
+}
+
+/**
+ * @brief 生成与 root.dump(4) 逐字节一致的文本，其中根字段 key 的数组
+ * 元素已由 dumpJsonArrayElement() 预先排版。
+ * @details 大数组的元素可以分片并行排版，其余字段仍由 nlohmann 输出；
+ * 拼接结果写入一块预留好容量的缓冲区。
+ * @param root 根对象；key 字段会被置为空数组。
+ * @param key 根对象中的数组字段名。
+ * @param elements 按输出顺序排列的元素文本。
+ * @return 完整的 JSON 文本。
+ */
+inline std::string dumpJsonWithArrayField(nlohmann::json&              root,
+                                          const std::string&           key,
+                                          std::span<const std::string> elements)
+{
+    root[key]                = nlohmann::json::array();
+    const std::string text   = root.dump(4);
+    const std::string anchor = "\n    " + nlohmann::json(key).dump() + ": []";
+    const std::size_t found  = text.find(anchor);
+    if ( found == std::string::npos || elements.empty() ) return text;
+
+    // 根对象第一层的字段行以换行加四个空格开头，键在同层内唯一。
+    const std::size_t arrayBegin = found + anchor.size() - 2;
+    std::size_t       total      = text.size();
+    for ( const auto& element : elements ) {
+        total += element.size() + JSON_ARRAY_ELEMENT_INDENT.size() + 2;
+    }
+
+    std::string output;
+    output.reserve(total + 8);
+    output.append(text, 0, arrayBegin);
+    output += "[\n";
+    for ( std::size_t i = 0; i < elements.size(); ++i ) {
+        if ( i > 0 ) output += ",\n";
+        output += JSON_ARRAY_ELEMENT_INDENT;
+        output += elements[i];
+    }
+    output += "\n    ]";
+    output.append(text, arrayBegin + 2);
+    return output;
+}
+
+}  // namespace MMM::Internal
@@ -1,5 +1,7 @@
 #pragma once
 
+#include "FileBuffer.h"
+
 #include "config/Utf8Path.h"
 #include "log/colorful-log.h"
 #include "mmm/beatmap/BeatMap.h"
@@ -9,7 +11,6 @@
 #include <cmath>
 #include <cstdint>
 #include <filesystem>
-#include <fstream>
 #include <functional>
 #include <limits>
 #include <optional>
@@ -145,14 +146,11 @@ inline bool saveRMMap(const BeatMap& beatMap, std::filesystem::path path)
         }
     }
 
-    std::ofstream ofs(path, std::ios::binary);
-    if ( !ofs ) {
-        XWARN("无法打开文件 [{}] 进行 RM/IMD 写出", Config::pathToUtf8(path));
-        return false;
-    }
+    // 全部字段先写入内存缓冲区，最后一次性原子替换目标文件。
+    std::string output;
 
-    auto write_value = [&ofs](auto value) {
-        ofs.write(reinterpret_cast<const char*>(&value), sizeof(value));
+    auto write_value = [&output](auto value) {
+        output.append(reinterpret_cast<const char*>(&value), sizeof(value));
     };
 
     auto get_rm_map_property =
@@ -394,6 +392,9 @@ inline bool saveRMMap(const BeatMap& beatMap, std::filesystem::path path)
     }
     write_value(table_rows);
 
+    // 每行固定 11 字节：类型 1、填充 1、时间 4、轨道 1、参数 4。
+    constexpr std::size_t RM_RECORD_BYTES = 11;
+    output.reserve(output.size() + writable_record_count * RM_RECORD_BYTES);
     for ( size_t i = 0; i < writable_record_count; ++i ) {
         const auto& rec = rm_records[i];
         write_value(rec.note_type_info);
@@ -404,6 +405,12 @@ inline bool saveRMMap(const BeatMap& beatMap, std::filesystem::path path)
         write_value(rec.note_parameter);
     }
 
+    if ( !Internal::writeFileBufferAtomically(
+             path, output, std::ios::binary) ) {
+        XWARN("无法打开文件 [{}] 进行 RM/IMD 写出", Config::pathToUtf8(path));
+        return false;
+    }
+
     auto pathToStr = [](const std::filesystem::path& p) {
         auto u8 = p.u8string();
         return std::string(reinterpret_cast<const char*>(u8.c_str()),
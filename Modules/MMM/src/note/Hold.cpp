@@ -1,56 +1,33 @@
 #include "mmm/note/Hold.h"
 #include "mmm/SafeParse.h"
+#include "mmm/TextAppend.h"
 #include <cmath>
-#include <iomanip>
-#include <sstream>
 #include <string_view>
 
 namespace MMM
 {
 namespace
 {
-/// @brief 按冒号拆分 osu! Hold 参数，并保留结尾空字段。
-/// @param value 待拆分的 Hold 参数字符串。
-/// @return 包含结束时间和 HitSample 参数的字段列表。
-std::vector<std::string> splitOsuHoldParameters(std::string_view value)
-{
-    std::vector<std::string> fields;
-    std::size_t              start = 0;
-    while ( start <= value.size() ) {
-        const std::size_t end = value.find(':', start);
-        fields.emplace_back(value.substr(start,
-                                         end == std::string_view::npos
-                                             ? value.size() - start
-                                             : end - start));
-        if ( end == std::string_view::npos ) break;
-        start = end + 1;
-    }
-    return fields;
-}
-
-/// @brief 将 osu! Hold 的 HitSample 参数与自定义音效文件名重新组合。
-/// @param original 原始 Hold 参数字符串。
+/// @brief 追加 osu! Hold 的 HitSample：结束时间之后的前四个参数加自定义
+/// 音效文件名。
+/// @param out 输出缓冲区。
+/// @param original 原始 Hold 参数字符串（首段为结束时间）；缺少的参数补空。
 /// @param sampleFile 通用物件字段保存的自定义音效文件名。
-/// @return 不含结束时间、固定包含五段参数的 HitSample 字符串。
-std::string composeOsuHoldHitSample(std::string_view original,
-                                    std::string_view sampleFile)
+void appendOsuHoldHitSample(std::string& out, std::string_view original,
+                            std::string_view sampleFile)
 {
-    auto fields = splitOsuHoldParameters(original);
-    fields.resize(6);
-    fields[5] = sampleFile;
-
-    std::ostringstream stream;
-    for ( std::size_t index = 1; index < fields.size(); ++index ) {
-        if ( index > 1 ) stream << ':';
-        stream << fields[index];
+    for ( std::size_t index = 1; index < 5; ++index ) {
+        if ( index > 1 ) out += ':';
+        out += MMM::Internal::delimitedFieldAt(original, ':', index);
     }
-    return stream.str();
+    out += ':';
+    out += sampleFile;
 }
 }  // namespace
 
 /// @brief 从osu描述加载
-void Hold::from_osu_description(const std::vector<std::string>& description,
-                                int32_t                         orbit_count)
+void Hold::from_osu_description(std::span<const std::string_view> description,
+                                int32_t orbit_count)
 {
     using enum NoteMetadataType;
     auto& osunote_prop = m_metadata.note_properties[OSU];
@@ -83,27 +60,41 @@ void Hold::from_osu_description(const std::vector<std::string>& description,
 
     // 长条结束时间
     // 结束时间和音效组参数粘一起了
-    const std::string sampleGroup = MMM::Internal::safeAt(description, 5);
-    const auto        last_paras  = splitOsuHoldParameters(sampleGroup);
+    const auto sampleGroup = MMM::Internal::safeAt(description, 5);
 
     osunote_prop["samplegroup"] = sampleGroup;
-    const auto sampleFile       = MMM::Internal::safeAt(last_paras, 5);
+
+    // 自定义音效文件是结束时间之后 HitSample 的第五段
+    const auto sampleFile =
+        MMM::Internal::delimitedFieldAt(sampleGroup, ':', 5);
     if ( sampleFile.empty() ) {
         clearSampleBinding();
     } else {
-        setSampleBinding(AudioSampleBinding{ sampleFile, 1.0F });
+        setSampleBinding(AudioSampleBinding{ std::string(sampleFile), 1.0F });
     }
 
     m_duration = static_cast<int32_t>(MMM::Internal::safeStod(
-                     MMM::Internal::safeAt(last_paras, 0))) -
+                     MMM::Internal::delimitedFieldAt(sampleGroup, ':', 0))) -
                  m_timestamp;
 }
 
 /// @brief 转换为osu描述
 std::string Hold::to_osu_description(int32_t orbit_count)
+{
+    std::string description;
+    append_osu_description(description, orbit_count);
+    return description;
+}
+
+/// @brief 将osu描述追加到输出缓冲区
+void Hold::append_osu_description(std::string& out, int32_t orbit_count) const
 {
     using enum NoteMetadataType;
-    auto& osunote_prop = m_metadata.note_properties[OSU];
+    static const MetadataProperties empty_props;
+    const auto  props_it = m_metadata.note_properties.find(OSU);
+    const auto& osunote_prop = props_it != m_metadata.note_properties.end()
+                                   ? props_it->second
+                                   : empty_props;
     /*
      * 长键格式:
      * x,y,开始时间,物件类型,长键音效,结束时间:音效组:附加音效组:音效参数:音量:[自定义音效文件]
@@ -112,46 +103,44 @@ std::string Hold::to_osu_description(int32_t orbit_count)
      *   - 结束时间 = 开始时间 + hold_time
      */
 
-    std::ostringstream oss;
-    oss << std::fixed << std::setprecision(0);
-
     // x 坐标 (根据轨道数计算)
     // 原公式: orbit = floor(x * orbit_count / 512)
     // 反推: x = orbit * 512 / orbit_count
     int x = static_cast<int>((double(m_track) + 0.5) * 512 / orbit_count);
-    oss << x << ",";
+    MMM::Internal::appendInteger(out, x);
 
     // y 坐标 (固定192)
-    oss << "192,";
+    out += ",192,";
 
-    // 开始时间
-    oss << m_timestamp << ",";
+    // 开始时间（定点、零位小数）
+    MMM::Internal::appendFixed(out, m_timestamp, 0);
 
     // 物件类型 (HOLD=128)
-    oss << "128,";
+    out += ",128,";
 
     // 长键音效 (NoteSample枚举值)
     if ( auto it = osunote_prop.find("sample"); it != osunote_prop.end() ) {
-        oss << it->second << ",";
+        out += it->second;
     } else {
-        oss << "0" << ",";
+        out += '0';
     }
+    out += ',';
 
     // 结束时间和音效组参数
     int end_time = m_timestamp + m_duration;
-    oss << end_time << ":";
+    MMM::Internal::appendInteger(out, end_time);
+    out += ':';
 
     // 音效组参数
-    const auto             sampleGroup = osunote_prop.contains("samplegroup")
-                                             ? osunote_prop.at("samplegroup")
-                                             : std::string("0:0:0:0:0:");
+    const auto             group_it    = osunote_prop.find("samplegroup");
+    const std::string_view sampleGroup = group_it != osunote_prop.end()
+                                             ? std::string_view(group_it->second)
+                                             : std::string_view("0:0:0:0:0:");
     const auto&            binding     = getSampleBinding();
     const std::string_view sampleFile =
         binding ? std::string_view(binding->m_audioResourceId)
                 : std::string_view{};
-    oss << composeOsuHoldHitSample(sampleGroup, sampleFile);
-
-    return oss.str();
+    appendOsuHoldHitSample(out, sampleGroup, sampleFile);
 }
 
 }  // namespace MMM
@@ -1,50 +1,26 @@
 #include "mmm/note/Note.h"
 #include "mmm/SafeParse.h"
+#include "mmm/TextAppend.h"
 #include <cmath>
-#include <iomanip>
-#include <sstream>
 #include <string_view>
 
 namespace MMM
 {
 namespace
 {
-/// @brief 按冒号拆分 osu! HitSample，并保留结尾空字段。
-/// @param value 待拆分的 HitSample 字符串。
-/// @return HitSample 字段列表。
-std::vector<std::string> splitOsuHitSample(std::string_view value)
-{
-    std::vector<std::string> fields;
-    std::size_t              start = 0;
-    while ( start <= value.size() ) {
-        const std::size_t end = value.find(':', start);
-        fields.emplace_back(value.substr(start,
-                                         end == std::string_view::npos
-                                             ? value.size() - start
-                                             : end - start));
-        if ( end == std::string_view::npos ) break;
-        start = end + 1;
-    }
-    return fields;
-}
-
-/// @brief 将 osu! HitSample 的前四个参数与自定义音效文件名重新组合。
-/// @param original 原始 HitSample 字符串。
+/// @brief 追加 osu! HitSample：原始值的前四个参数加自定义音效文件名。
+/// @param out 输出缓冲区。
+/// @param original 原始 HitSample 字符串；缺少的参数补空，多余的参数丢弃。
 /// @param sampleFile 通用物件字段保存的自定义音效文件名。
-/// @return 固定包含五段参数的 HitSample 字符串。
-std::string composeOsuHitSample(std::string_view original,
-                                std::string_view sampleFile)
+void appendOsuHitSample(std::string& out, std::string_view original,
+                        std::string_view sampleFile)
 {
-    auto fields = splitOsuHitSample(original);
-    fields.resize(5);
-    fields[4] = sampleFile;
-
-    std::ostringstream stream;
-    for ( std::size_t index = 0; index < fields.size(); ++index ) {
-        if ( index > 0 ) stream << ':';
-        stream << fields[index];
+    for ( std::size_t index = 0; index < 4; ++index ) {
+        if ( index > 0 ) out += ':';
+        out += MMM::Internal::delimitedFieldAt(original, ':', index);
     }
-    return stream.str();
+    out += ':';
+    out += sampleFile;
 }
 }  // namespace
 
@@ -53,8 +29,8 @@ Note::Note() {}
 Note::~Note() {}
 
 /// @brief 从osu描述加载
-void Note::from_osu_description(const std::vector<std::string>& description,
-                                int32_t                         orbit_count)
+void Note::from_osu_description(std::span<const std::string_view> description,
+                                int32_t orbit_count)
 {
     using enum NoteMetadataType;
     auto& osunote_prop = m_metadata.note_properties[OSU];
@@ -74,21 +50,45 @@ void Note::from_osu_description(const std::vector<std::string>& description,
         MMM::Internal::safeStoi(MMM::Internal::safeAt(description, 4)));
 
     // 音效组
-    osunote_prop["samplegroup"] = MMM::Internal::safeAt(description, 5);
-    const auto hitSampleFields = splitOsuHitSample(osunote_prop["samplegroup"]);
-    const auto sampleFile      = MMM::Internal::safeAt(hitSampleFields, 4);
+    const auto sampleGroup      = MMM::Internal::safeAt(description, 5);
+    osunote_prop["samplegroup"] = sampleGroup;
+
+    // 自定义音效文件是 HitSample 的第五段
+    const auto sampleFile =
+        MMM::Internal::delimitedFieldAt(sampleGroup, ':', 4);
     if ( sampleFile.empty() ) {
         clearSampleBinding();
     } else {
-        setSampleBinding(AudioSampleBinding{ sampleFile, 1.0F });
+        setSampleBinding(AudioSampleBinding{ std::string(sampleFile), 1.0F });
     }
 }
 
+/// @brief 从osu描述加载
+void Note::from_osu_description(const std::vector<std::string>& description,
+                                int32_t                         orbit_count)
+{
+    const std::vector<std::string_view> fields(description.begin(),
+                                               description.end());
+    from_osu_description(fields, orbit_count);
+}
+
 /// @brief 转换为osu描述
 std::string Note::to_osu_description(int32_t orbit_count)
+{
+    std::string description;
+    append_osu_description(description, orbit_count);
+    return description;
+}
+
+/// @brief 将osu描述追加到输出缓冲区
+void Note::append_osu_description(std::string& out, int32_t orbit_count) const
 {
     using enum NoteMetadataType;
-    auto& osunote_prop = m_metadata.note_properties[OSU];
+    static const MetadataProperties empty_props;
+    const auto  props_it = m_metadata.note_properties.find(OSU);
+    const auto& osunote_prop = props_it != m_metadata.note_properties.end()
+                                   ? props_it->second
+                                   : empty_props;
     /*
      * 格式:
      * x,y,开始时间,物件类型,长键音效,结束时间:音效组:附加音效组:音效参数:音量[:自定义音效文件]
@@ -98,41 +98,38 @@ std::string Note::to_osu_description(int32_t orbit_count)
      * normalSet:additionalSet:sampleSetParameter:volume:[sampleFile]
      */
 
-    std::ostringstream oss;
-    oss << std::fixed << std::setprecision(0);
-
     // x 坐标 (根据轨道数计算)
     // 原公式: orbit = floor(x * orbit_count / 512)
     // 反推: x = orbit * 512 / orbit_count
     auto x = static_cast<int>((double(m_track) + 0.5) * 512 / orbit_count);
-    oss << x << ",";
+    MMM::Internal::appendInteger(out, x);
 
     // y 坐标 (固定192)
-    oss << "192,";
+    out += ",192,";
 
-    // 开始时间
-    oss << m_timestamp << ",";
+    // 开始时间（定点、零位小数）
+    MMM::Internal::appendFixed(out, m_timestamp, 0);
 
     // 物件类型 (NOTE=1)
-    oss << "1,";
+    out += ",1,";
 
     // 长键音效 (NoteSample枚举值)
     if ( auto it = osunote_prop.find("sample"); it != osunote_prop.end() ) {
-        oss << it->second << ",";
+        out += it->second;
     } else {
-        oss << "0" << ",";
+        out += '0';
     }
+    out += ',';
 
     // 音效组参数
-    const auto             sampleGroup = osunote_prop.contains("samplegroup")
-                                             ? osunote_prop.at("samplegroup")
-                                             : std::string("0:0:0:0:");
+    const auto             group_it    = osunote_prop.find("samplegroup");
+    const std::string_view sampleGroup = group_it != osunote_prop.end()
+                                             ? std::string_view(group_it->second)
+                                             : std::string_view("0:0:0:0:");
     const auto&            binding     = getSampleBinding();
     const std::string_view sampleFile =
         binding ? std::string_view(binding->m_audioResourceId)
                 : std::string_view{};
-    oss << composeOsuHitSample(sampleGroup, sampleFile);
-
-    return oss.str();
+    appendOsuHitSample(out, sampleGroup, sampleFile);
 }
 }  // namespace MMM
@@ -49,6 +49,14 @@ double scrollMultiplierToOsuInheritedBeatLength(double scrollMultiplier)
 
 /// @brief 从osu的字符串读取
 void Timing::from_osu_description(std::vector<std::string>& description)
+{
+    const std::vector<std::string_view> fields(description.begin(),
+                                               description.end());
+    from_osu_description(fields);
+}
+
+/// @brief 从osu的字符串读取
+void Timing::from_osu_description(std::span<const std::string_view> description)
 {
     using enum TimingMetadataType;
     auto& osutiming_prop = m_metadata.timing_properties[OSU];
@@ -0,0 +1,132 @@
+#include "BenchmarkSupport.h"
+#include "SyntheticBeatmap.hpp"
+#include "log/colorful-log.h"
+#include "mmm/beatmap/BeatMap.h"
+#include "mmm/beatmap/BeatmapCache.h"
+#include <algorithm>
+#include <cstddef>
+#include <cstdlib>
+#include <filesystem>
+#include <string>
+
+/**
+ * @brief 谱面二进制缓存的冷/热加载耗时基准。
+ *
+ * 用法: BeatmapCacheBenchmark <output_dir> [note_count] [iterations]
+ * 把同一份合成谱面分别保存为 .osu、.mc、.imd 与 .mmm，每种格式先测量
+ * 不经缓存的解析耗时（冷加载，包含首次写入缓存的一次额外统计），再测量
+ * 命中缓存的还原耗时（热加载），并给出条目大小与加速比。
+ */
+
+namespace fs = std::filesystem;
+
+namespace
+{
+
+using Clock = MMM::Test::BenchmarkClock;
+using MMM::Test::elapsedMs;
+
+/// @brief 测量一种格式的冷、热加载。
+/// @param chartPath 谱面文件路径。
+/// @param cache 使用的缓存，测量前清空。
+/// @param iterations 重复加载次数。
+/// @return 热加载全部命中且物件数一致时返回 true。
+bool runFormat(const fs::path& chartPath, MMM::BeatmapCache& cache,
+               std::size_t iterations)
+{
+    const auto parse = [](const fs::path& path) {
+        return MMM::BeatMap::loadFromFile(path);
+    };
+    cache.clear();
+
+    double      coldMs    = 0.0;
+    std::size_t coldNotes = 0;
+    for ( std::size_t i = 0; i < iterations; ++i ) {
+        const auto   begin   = Clock::now();
+        MMM::BeatMap beatMap = parse(chartPath);
+        coldMs += elapsedMs(begin);
+        coldNotes = beatMap.m_allNotes.size();
+    }
+
+    const auto storeBegin = Clock::now();
+    cache.load(chartPath, parse);
+    const double storeMs = elapsedMs(storeBegin);
+
+    const auto  hitsBefore = cache.statistics().hits;
+    double      warmMs     = 0.0;
+    std::size_t warmNotes  = 0;
+    for ( std::size_t i = 0; i < iterations; ++i ) {
+        const auto   begin   = Clock::now();
+        MMM::BeatMap beatMap = cache.load(chartPath, parse);
+        warmMs += elapsedMs(begin);
+        warmNotes = beatMap.m_allNotes.size();
+    }
+    if ( cache.statistics().hits - hitsBefore != iterations ||
+         warmNotes != coldNotes || coldNotes == 0 ) {
+        XERROR("Warm loads of {} did not hit the cache",
+               chartPath.extension().string());
+        return false;
+    }
+
+    std::error_code ec;
+    const auto      fileBytes  = fs::file_size(chartPath, ec);
+    const auto      entryBytes = fs::file_size(cache.entryPath(chartPath), ec);
+    const double    coldAverage = coldMs / double(iterations);
+    const double    warmAverage = warmMs / double(iterations);
+    XINFO("  {}: file={:.1f}KiB entry={:.1f}KiB notes={} cold={:.2f}ms "
+          "miss+store={:.2f}ms warm={:.2f}ms speedup={:.1f}x",
+          chartPath.extension().string(),
+          double(fileBytes) / 1024.0,
+          double(entryBytes) / 1024.0,
+          coldNotes,
+          coldAverage,
+          storeMs,
+          warmAverage,
+          coldAverage / std::max(warmAverage, 1e-6));
+    return true;
+}
+
+}  // namespace
+
+int main(int argc, char* argv[])
+{
+    if ( argc < 2 ) {
+        XERROR("Usage: BeatmapCacheBenchmark <output_dir> [note_count] "
+               "[iterations]");
+        return 1;
+    }
+
+    const fs::path    outputDir = argv[1];
+    const std::size_t noteCount =
+        argc > 2 ? std::strtoull(argv[2], nullptr, 10) : 50000;
+    const std::size_t iterations =
+        argc > 3 ? std::max<std::size_t>(1, std::strtoull(argv[3], nullptr, 10))
+                 : 3;
+
+    std::error_code ec;
+    fs::create_directories(outputDir, ec);
+
+    MMM::Test::SyntheticBeatmapSpec spec;
+    spec.noteCount           = noteCount * 7 / 10;
+    spec.holdCount           = noteCount * 2 / 10;
+    spec.polylineCount       = noteCount / 10 / 4;
+    spec.subNotesPerPolyline = 3;
+    spec.timingCount         = std::max<std::size_t>(1, noteCount / 100);
+
+    const MMM::BeatMap beatMap = MMM::Test::makeSyntheticBeatMap(spec);
+    MMM::BeatmapCache  cache(outputDir / "cache");
+
+    XINFO("Beatmap cache benchmark: notes={} iterations={}",
+          beatMap.m_allNotes.size(),
+          iterations);
+    for ( const char* extension : { ".osu", ".mc", ".imd", ".mmm" } ) {
+        const fs::path chartPath =
+            outputDir / (std::string("cache_benchmark") + extension);
+        if ( !beatMap.saveToFile(chartPath) ) {
+            XERROR("Failed to save benchmark chart: {}", chartPath.string());
+            return 1;
+        }
+        if ( !runFormat(chartPath, cache, iterations) ) return 1;
+    }
+    return 0;
+}
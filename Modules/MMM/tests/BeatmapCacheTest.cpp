@@ -0,0 +1,350 @@
+#include "SyntheticBeatmap.hpp"
+#include "TestHelper.hpp"
+#include "log/colorful-log.h"
+#include "mmm/beatmap/BeatMap.h"
+#include "mmm/beatmap/BeatmapCache.h"
+#include <algorithm>
+#include <chrono>
+#include <filesystem>
+#include <fstream>
+#include <iterator>
+#include <memory>
+#include <string>
+#include <unordered_set>
+
+namespace fs = std::filesystem;
+
+namespace
+{
+
+/// @brief 读取文件全部内容。
+std::string readFileBytes(const fs::path& path)
+{
+    std::ifstream file(path, std::ios::binary);
+    return { std::istreambuf_iterator<char>(file),
+             std::istreambuf_iterator<char>() };
+}
+
+/// @brief 两份谱面以同一扩展名保存后必须逐字节一致。
+bool sameSavedBytes(const MMM::BeatMap& parsed, const MMM::BeatMap& cached,
+                    const fs::path& outputDir, const std::string& extension)
+{
+    const auto parsedPath = outputDir / ("parsed" + extension);
+    const auto cachedPath = outputDir / ("cached" + extension);
+    if ( !parsed.saveToFile(parsedPath) || !cached.saveToFile(cachedPath) ) {
+        XERROR("Failed to save {} outputs", extension);
+        return false;
+    }
+    if ( readFileBytes(parsedPath) != readFileBytes(cachedPath) ) {
+        XERROR("Cached beatmap saves differently as {}", extension);
+        return false;
+    }
+    return true;
+}
+
+/// @brief 折线子物件引用必须指回还原后谱面自己的容器。
+bool verifyPolylineReferences(const MMM::BeatMap& beatMap)
+{
+    const auto&                          data = beatMap.m_noteData;
+    std::unordered_set<const MMM::Note*> owned;
+    for ( const auto& note : data.notes ) owned.insert(&note);
+    for ( const auto& hold : data.holds ) owned.insert(&hold);
+    for ( const auto& flick : data.flicks ) owned.insert(&flick);
+    for ( const auto& polyline : data.polylines ) {
+        for ( const auto& subNote : polyline.m_subNotes ) {
+            if ( !owned.contains(&subNote.get()) ) {
+                XERROR("Polyline sub-note points outside the restored map");
+                return false;
+            }
+        }
+    }
+    return true;
+}
+
+/// @brief 第二次加载命中缓存，且结果与直接解析一致。
+bool verifyFixture(const fs::path& input, const fs::path& outputDir)
+{
+    MMM::BeatMap parsed = MMM::BeatMap::loadFromFile(input);
+    if ( parsed.m_allNotes.empty() ) {
+        XERROR("Fixture has no notes: {}", input.string());
+        return false;
+    }
+
+    MMM::BeatmapCache cache(outputDir / "cache");
+    cache.clear();
+    MMM::BeatmapCache::setActive(std::shared_ptr<MMM::BeatmapCache>(
+        &cache, [](MMM::BeatmapCache*) {}));
+    MMM::BeatMap first  = MMM::BeatMap::loadFromFile(input);
+    MMM::BeatMap cached = MMM::BeatMap::loadFromFile(input);
+    MMM::BeatmapCache::setActive(nullptr);
+
+    const auto statistics = cache.statistics();
+    if ( statistics.misses != 1 || statistics.hits != 1 ||
+         statistics.stores != 1 ) {
+        XERROR("Unexpected cache statistics for {}: hits={} misses={} "
+               "stores={}",
+               input.string(),
+               statistics.hits,
+               statistics.misses,
+               statistics.stores);
+        return false;
+    }
+    return MMM::Test::compareBeatMaps(parsed, first, true) &&
+           MMM::Test::compareBeatMaps(parsed, cached, true) &&
+           verifyPolylineReferences(cached) &&
+           sameSavedBytes(
+               parsed, cached, outputDir, input.extension().string()) &&
+           sameSavedBytes(parsed, cached, outputDir, ".mmm");
+}
+
+/// @brief 源文件内容变化使条目失效；只有修改时间变化时按内容哈希复用。
+bool verifyInvalidation(const fs::path& fixture, const fs::path& outputDir)
+{
+    const fs::path  mapPath = outputDir / "invalidation.osu";
+    std::error_code ec;
+    fs::copy_file(fixture, mapPath, fs::copy_options::overwrite_existing, ec);
+    if ( ec ) {
+        XERROR("Failed to copy fixture: {}", ec.message());
+        return false;
+    }
+
+    MMM::BeatmapCache cache(outputDir / "invalidation_cache");
+    cache.clear();
+    const auto parse = [](const fs::path& path) {
+        return MMM::BeatMap::loadFromFile(path);
+    };
+    cache.load(mapPath, parse);
+    if ( !cache.find(mapPath) ) {
+        XERROR("Stored entry was not found");
+        return false;
+    }
+
+    // 只改修改时间：内容哈希一致，仍然命中。
+    fs::last_write_time(
+        mapPath, fs::last_write_time(mapPath) + std::chrono::hours(1));
+    if ( !cache.find(mapPath) ) {
+        XERROR("Touched but unchanged source was not revalidated");
+        return false;
+    }
+
+    // 改写内容：大小变化，条目失效。
+    {
+        std::ofstream append(mapPath, std::ios::binary | std::ios::app);
+        append << "\n";
+    }
+    if ( cache.find(mapPath) ) {
+        XERROR("Modified source still hit the cache");
+        return false;
+    }
+
+    // 改写内容但保持大小：修改时间变化触发哈希比对，条目失效。
+    const auto writeTime = fs::last_write_time(mapPath);
+    cache.load(mapPath, parse);
+    std::string content = readFileBytes(mapPath);
+    content.back()      = ' ';
+    {
+        std::ofstream rewrite(mapPath, std::ios::binary | std::ios::trunc);
+        rewrite << content;
+    }
+    fs::last_write_time(mapPath, writeTime + std::chrono::seconds(1));
+    if ( cache.find(mapPath) ) {
+        XERROR("Same-size rewrite still hit the cache");
+        return false;
+    }
+    return true;
+}
+
+/// @brief 总开关关闭后不再读写缓存。
+bool verifyKillSwitch(const fs::path& fixture, const fs::path& outputDir)
+{
+    auto cache = std::make_shared<MMM::BeatmapCache>(outputDir / "kill_cache");
+    cache->clear();
+    MMM::BeatmapCache::setActive(cache);
+
+    MMM::BeatmapCache::setEnabled(false);
+    const bool disabledActive = MMM::BeatmapCache::active() != nullptr;
+    MMM::BeatMap::loadFromFile(fixture);
+    const bool storedWhileDisabled = fs::exists(cache->entryPath(fixture));
+    MMM::BeatmapCache::setEnabled(true);
+
+    const bool enabledActive = MMM::BeatmapCache::active() == cache;
+    MMM::BeatmapCache::setActive(nullptr);
+    if ( disabledActive || storedWhileDisabled || !enabledActive ) {
+        XERROR("Kill switch did not bypass the cache");
+        return false;
+    }
+    return true;
+}
+
+/// @brief 条目数超过上限时淘汰最久未访问的条目。
+bool verifyEviction(const fs::path& outputDir)
+{
+    MMM::Test::SyntheticBeatmapSpec spec;
+    spec.noteCount = 200;
+    spec.holdCount = 50;
+
+    MMM::BeatmapCacheOptions options;
+    options.maxEntries = 2;
+    MMM::BeatmapCache cache(outputDir / "eviction_cache", options);
+    cache.clear();
+
+    const auto parse = [](const fs::path& path) {
+        return MMM::BeatMap::loadFromFile(path);
+    };
+    fs::path paths[3];
+    for ( int i = 0; i < 3; ++i ) {
+        spec.seed = 0x1000 + i;
+        paths[i]  = outputDir / ("eviction_" + std::to_string(i) + ".mc");
+        if ( !MMM::Test::makeSyntheticBeatMap(spec).saveToFile(paths[i]) ) {
+            XERROR("Failed to save eviction fixture");
+            return false;
+        }
+        cache.load(paths[i], parse);
+        // 条目修改时间即访问时间，拉开间隔避免文件系统时间精度影响排序。
+        fs::last_write_time(cache.entryPath(paths[i]),
+                            fs::file_time_type::clock::now() -
+                                std::chrono::minutes(10 - i));
+    }
+
+    if ( cache.statistics().evictions != 1 ||
+         fs::exists(cache.entryPath(paths[0])) ||
+         !fs::exists(cache.entryPath(paths[2])) ) {
+        XERROR("Oldest entry was not evicted (evictions={})",
+               cache.statistics().evictions);
+        return false;
+    }
+
+    options.maxEntries = 1024;
+    options.maxBytes   = 1;
+    MMM::BeatmapCache tiny(outputDir / "eviction_cache", options);
+    tiny.trim();
+    if ( fs::exists(cache.entryPath(paths[2])) ) {
+        XERROR("Byte limit did not evict entries");
+        return false;
+    }
+    return true;
+}
+
+/// @brief 批量写入只在占用超出限制时淘汰，且一次淘汰到限制的 90%。
+bool verifyBatchEviction(const fs::path& outputDir)
+{
+    MMM::Test::SyntheticBeatmapSpec spec;
+    spec.noteCount = 50;
+    spec.seed      = 0x2000;
+    const fs::path source = outputDir / "batch_source.mc";
+    if ( !MMM::Test::makeSyntheticBeatMap(spec).saveToFile(source) ) {
+        XERROR("Failed to save batch fixture");
+        return false;
+    }
+
+    MMM::BeatmapCacheOptions options;
+    options.maxEntries = 10;
+    MMM::BeatmapCache cache(outputDir / "batch_cache", options);
+    cache.clear();
+
+    const auto parse = [](const fs::path& path) {
+        return MMM::BeatMap::loadFromFile(path);
+    };
+    const auto countEntries = [&cache]() {
+        std::size_t count = 0;
+        for ( const auto& entry : fs::directory_iterator(cache.directory()) ) {
+            count += entry.path().extension() ==
+                     MMM::BeatmapCache::ENTRY_EXTENSION;
+        }
+        return count;
+    };
+
+    // 第 11 次写入超出上限，淘汰到 9 条；第 12 次写入回到 10 条，不再淘汰。
+    for ( int i = 0; i < 12; ++i ) {
+        const fs::path path =
+            outputDir / ("batch_" + std::to_string(i) + ".mc");
+        std::error_code ec;
+        fs::copy_file(source, path, fs::copy_options::overwrite_existing, ec);
+        if ( ec ) {
+            XERROR("Failed to copy batch fixture");
+            return false;
+        }
+        cache.load(path, parse);
+        const std::size_t expected = i == 10 ? 9 : std::min(i + 1, 10);
+        if ( countEntries() != expected ) {
+            XERROR("Batch store {} left {} entries, expected {}",
+                   i,
+                   countEntries(),
+                   expected);
+            return false;
+        }
+    }
+    if ( cache.statistics().evictions != 2 ) {
+        XERROR("Batch stores evicted {} entries, expected 2",
+               cache.statistics().evictions);
+        return false;
+    }
+    return true;
+}
+
+/// @brief 损坏的条目被拒绝并删除，随后回退到解析器。
+bool verifyCorruptEntry(const fs::path& fixture, const fs::path& outputDir)
+{
+    MMM::BeatmapCache cache(outputDir / "corrupt_cache");
+    cache.clear();
+    const auto parse = [](const fs::path& path) {
+        return MMM::BeatMap::loadFromFile(path);
+    };
+    const MMM::BeatMap parsed = cache.load(fixture, parse);
+
+    const fs::path entry   = cache.entryPath(fixture);
+    std::string    content = readFileBytes(entry);
+    const auto     keep    = content.size() - content.size() / 2;
+    for ( std::size_t i = keep; i < content.size(); ++i ) content[i] = '\xff';
+    {
+        std::ofstream rewrite(entry, std::ios::binary | std::ios::trunc);
+        rewrite << content;
+    }
+
+    if ( cache.find(fixture) || fs::exists(entry) ) {
+        XERROR("Corrupted cache entry was accepted");
+        return false;
+    }
+    const MMM::BeatMap reparsed = cache.load(fixture, parse);
+    return MMM::Test::compareBeatMaps(parsed, reparsed, true);
+}
+
+}  // namespace
+
+int main(int argc, char* argv[])
+{
+    if ( argc < 3 ) {
+        XERROR("Usage: BeatmapCacheTest <output_dir> <fixture>...");
+        return 1;
+    }
+
+    const fs::path  outputDir = argv[1];
+    std::error_code ec;
+    fs::create_directories(outputDir, ec);
+
+    // 原生 .mmm 由首个 .mc 夹具转换得到，覆盖全部四种格式。
+    for ( int i = 2; i < argc; ++i ) {
+        const fs::path input = argv[i];
+        if ( !verifyFixture(input, outputDir) ) return 1;
+        if ( input.extension() == ".mc" &&
+             !fs::exists(outputDir / "native.mmm") ) {
+            const fs::path native = outputDir / "native.mmm";
+            if ( !MMM::BeatMap::loadFromFile(input).saveToFile(native) ||
+                 !verifyFixture(native, outputDir) ) {
+                return 1;
+            }
+        }
+    }
+
+    const fs::path osuFixture = argv[2];
+    if ( !verifyInvalidation(osuFixture, outputDir) ||
+         !verifyKillSwitch(osuFixture, outputDir) ||
+         !verifyEviction(outputDir) ||
+         !verifyBatchEviction(outputDir) ||
+         !verifyCorruptEntry(osuFixture, outputDir) ) {
+        return 1;
+    }
+
+    XINFO("Beatmap cache test PASSED");
+    return 0;
+}
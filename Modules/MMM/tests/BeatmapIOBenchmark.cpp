@@ -0,0 +1,241 @@
+#include "BenchmarkSupport.h"
+#include "SyntheticBeatmap.hpp"
+#include "log/colorful-log.h"
+#include "mmm/beatmap/BeatMap.h"
+#include "mmm/beatmap/BeatmapSpeedTransform.h"
+#include <algorithm>
+#include <array>
+#include <charconv>
+#include <cstddef>
+#include <cstdlib>
+#include <filesystem>
+#include <fstream>
+#include <limits>
+#include <nlohmann/json.hpp>
+#include <string>
+#include <string_view>
+#include <vector>
+
+/**
+ * @brief 谱面 I/O 综合基准：四种格式的加载、保存、sync() 与倍速变换。
+ *
+ * 用法: BeatmapIOBenchmark <output_dir> [sizes] [iterations] [results.jsonl]
+ * sizes 为逗号分隔的对象总数（默认 1000,10000,100000,1000000）。每个规模
+ * 生成确定性合成谱面：普通物件、长条、每条 5 个子物件的折线、每 16 个
+ * 物件一条 SV 时间线，以及大量谱面级附加属性与物件注释；格式无法表达的
+ * 内容（osu! 的折线、imd 的命中采样绑定）按格式裁剪。
+ *
+ * 每个 (格式, 规模, 操作) 输出一行 JSON 到 results.jsonl（默认
+ * <output_dir>/beatmap_io_results.jsonl），字段为 format、objects、
+ * operation、iterations、mean_ms、min_ms、bytes、objects_per_s 与
+ * mb_per_s，便于脚本比较不同提交的结果。
+ */
+
+namespace fs = std::filesystem;
+using json   = nlohmann::json;
+
+namespace
+{
+
+using Clock = MMM::Test::BenchmarkClock;
+using MMM::Test::elapsedMs;
+
+/// @brief 每条折线的子物件数量。
+constexpr std::size_t SUB_NOTES_PER_POLYLINE = 5;
+
+/// @brief 单种格式的可表达能力。
+struct FormatProfile {
+    std::string_view extension;
+    bool             polylines;
+    bool             sampleBindings;
+};
+
+constexpr std::array<FormatProfile, 4> FORMATS{
+    FormatProfile{ ".osu", false, true },
+    FormatProfile{ ".mc", true, true },
+    FormatProfile{ ".mmm", true, true },
+    FormatProfile{ ".imd", true, false },
+};
+
+/// @brief 单项操作的耗时统计。
+struct Timing {
+    double meanMs{ 0.0 };
+    double minMs{ std::numeric_limits<double>::max() };
+};
+
+/// @brief 重复执行 iterations 次并统计耗时；operation 返回 false 表示失败。
+template<typename Operation>
+bool measure(std::size_t iterations, Timing& timing, Operation&& operation)
+{
+    double totalMs = 0.0;
+    for ( std::size_t i = 0; i < iterations; ++i ) {
+        const auto begin = Clock::now();
+        if ( !operation() ) return false;
+        const double ms = elapsedMs(begin);
+        totalMs += ms;
+        timing.minMs = std::min(timing.minMs, ms);
+    }
+    timing.meanMs = totalMs / static_cast<double>(iterations);
+    return true;
+}
+
+/// @brief 按对象总数与格式能力生成合成谱面参数。
+MMM::Test::SyntheticBeatmapSpec specFor(std::size_t          objects,
+                                        const FormatProfile& format)
+{
+    MMM::Test::SyntheticBeatmapSpec spec;
+    spec.subNotesPerPolyline = SUB_NOTES_PER_POLYLINE;
+    spec.polylineCount =
+        format.polylines ? objects / 10 / SUB_NOTES_PER_POLYLINE : 0;
+    const std::size_t remaining =
+        objects - spec.polylineCount * SUB_NOTES_PER_POLYLINE;
+    spec.holdCount          = remaining / 4;
+    spec.noteCount          = remaining - spec.holdCount;
+    spec.timingCount        = std::max<std::size_t>(1, objects / 16);
+    spec.mapPropertyCount   = 256;
+    spec.annotationEvery    = 50;
+    spec.sampleBindingEvery = format.sampleBindings ? 20 : 0;
+    return spec;
+}
+
+/// @brief 解析逗号分隔的规模列表。
+std::vector<std::size_t> parseSizes(std::string_view text)
+{
+    std::vector<std::size_t> sizes;
+    while ( !text.empty() ) {
+        const auto        comma = text.find(',');
+        const auto        token = text.substr(0, comma);
+        std::size_t       value = 0;
+        const auto        end   = token.data() + token.size();
+        const auto [ptr, error] = std::from_chars(token.data(), end, value);
+        if ( error == std::errc{} && ptr == end && value > 0 ) {
+            sizes.push_back(value);
+        }
+        if ( comma == std::string_view::npos ) break;
+        text.remove_prefix(comma + 1);
+    }
+    return sizes;
+}
+
+/// @brief 执行全部规模与格式的基准；失败时返回非零。
+int runBenchmark(int argc, char* argv[])
+{
+    if ( argc < 2 ) {
+        XERROR("Usage: BeatmapIOBenchmark <output_dir> [sizes] [iterations] "
+               "[results.jsonl]");
+        return 1;
+    }
+
+    const fs::path outputDir = argv[1];
+    const auto     sizes =
+        parseSizes(argc > 2 ? argv[2] : "1000,10000,100000,1000000");
+    const std::size_t iterations =
+        argc > 3 ? std::max<std::size_t>(1, std::strtoull(argv[3], nullptr, 10))
+                 : 3;
+    const fs::path resultsPath =
+        argc > 4 ? fs::path(argv[4]) : outputDir / "beatmap_io_results.jsonl";
+    if ( sizes.empty() ) {
+        XERROR("No valid benchmark sizes were given");
+        return 1;
+    }
+
+    std::error_code ec;
+    fs::create_directories(outputDir, ec);
+    std::ofstream results(resultsPath, std::ios::trunc);
+    if ( !results ) {
+        XERROR("Failed to open benchmark results: {}", resultsPath.string());
+        return 1;
+    }
+
+    for ( const std::size_t objects : sizes ) {
+        for ( const FormatProfile& format : FORMATS ) {
+            const auto    spec    = specFor(objects, format);
+            MMM::BeatMap  beatMap = MMM::Test::makeSyntheticBeatMap(spec);
+            // imd 从 "名称_7k_难度" 形式的文件名读取轨道数。
+            fs::path      chartPath = outputDir / "benchmark_7k_io";
+            chartPath += format.extension;
+
+            const auto report = [&](std::string_view operation,
+                                    const Timing&    timing,
+                                    std::uintmax_t   bytes) {
+                const double seconds = std::max(timing.meanMs, 1e-6) / 1000.0;
+                json         record{
+                    { "format", format.extension.substr(1) },
+                    { "objects", objects },
+                    { "operation", operation },
+                    { "iterations", iterations },
+                    { "mean_ms", timing.meanMs },
+                    { "min_ms", timing.minMs },
+                    { "bytes", bytes },
+                    { "objects_per_s", static_cast<double>(objects) / seconds },
+                    { "mb_per_s",
+                      static_cast<double>(bytes) / 1048576.0 / seconds },
+                };
+                results << record.dump() << '\n';
+                XWARN("  {:<4} {:>8} {:<14} mean={:.2f}ms min={:.2f}ms",
+                      format.extension,
+                      objects,
+                      operation,
+                      timing.meanMs,
+                      timing.minMs);
+            };
+
+            Timing save;
+            if ( !measure(iterations, save, [&] {
+                     return beatMap.saveToFile(chartPath);
+                 }) ) {
+                XERROR("Save failed: {}", chartPath.string());
+                return 1;
+            }
+            const auto fileBytes = fs::file_size(chartPath, ec);
+            report("save", save, ec ? 0 : fileBytes);
+
+            MMM::BeatMap loaded;
+            Timing       load;
+            measure(iterations, load, [&] {
+                loaded = MMM::BeatMap::loadFromFile(chartPath);
+                return true;
+            });
+            if ( loaded.m_allNotes.empty() || loaded.m_timings.empty() ) {
+                XERROR("Load produced an empty beatmap: {}", chartPath.string());
+                return 1;
+            }
+            report("load", load, ec ? 0 : fileBytes);
+
+            Timing sync;
+            measure(iterations, sync, [&] {
+                loaded.sync();
+                return true;
+            });
+            report("sync", sync, 0);
+
+            MMM::BeatmapSpeedTransformOptions options;
+            options.speed = 1.5;
+            Timing transform;
+            if ( !measure(iterations, transform, [&] {
+                     return MMM::BeatmapSpeedTransform::createSpeedVersion(
+                                loaded, options)
+                         .success;
+                 }) ) {
+                XERROR("Speed transform failed: {}", chartPath.string());
+                return 1;
+            }
+            report("speed_transform", transform, 0);
+        }
+    }
+
+    XWARN("Benchmark results written to {}", resultsPath.string());
+    return 0;
+}
+
+}  // namespace
+
+int main(int argc, char* argv[])
+{
+    XLogger::init("BeatmapIOBenchmark");
+    // 加载器与保存器每次调用都会输出 info 日志，计时期间只保留警告。
+    XLogger::setlevel(spdlog::level::warn);
+    const int result = runBenchmark(argc, argv);
+    XLogger::shutdown();
+    return result;
+}
@@ -0,0 +1,234 @@
+#include "SyntheticBeatmap.hpp"
+#include "log/colorful-log.h"
+#include "mmm/ParallelExecutor.h"
+#include "mmm/beatmap/BeatMap.h"
+#include "mmm/beatmap/BeatmapIndex.h"
+#include <chrono>
+#include <filesystem>
+#include <fstream>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace fs = std::filesystem;
+
+namespace
+{
+
+/// @brief 为每个后台任务启动一个线程的测试执行器，析构时回收全部线程。
+class ThreadExecutor
+{
+public:
+    ThreadExecutor()
+    {
+        MMM::setParallelExecutor({
+            .submit =
+                [this](std::function<void()> task) {
+                    std::lock_guard<std::mutex> lock(m_mutex);
+                    m_threads.emplace_back(std::move(task));
+                },
+            .concurrency = 4,
+        });
+    }
+
+    ~ThreadExecutor()
+    {
+        MMM::setParallelExecutor({});
+        for ( auto& thread : m_threads ) thread.join();
+    }
+
+private:
+    std::mutex               m_mutex;
+    std::vector<std::thread> m_threads;
+};
+
+/// @brief 比较刷新统计。
+bool expectStatistics(const char* stage,
+                      const MMM::BeatmapIndexStatistics& statistics,
+                      std::size_t reused, std::size_t rebuilt,
+                      std::size_t removed)
+{
+    if ( statistics.reused == reused && statistics.rebuilt == rebuilt &&
+         statistics.removed == removed && statistics.failed == 0 ) {
+        return true;
+    }
+    XERROR("{}: reused={} rebuilt={} removed={} failed={}, expected {}/{}/{}",
+           stage,
+           statistics.reused,
+           statistics.rebuilt,
+           statistics.removed,
+           statistics.failed,
+           reused,
+           rebuilt,
+           removed);
+    return false;
+}
+
+/// @brief 索引中的摘要必须与直接加载谱面计算的摘要一致。
+bool verifySummaries(MMM::BeatmapIndex&           index,
+                     const std::vector<fs::path>& mapPaths)
+{
+    for ( const auto& mapPath : mapPaths ) {
+        const auto indexed  = index.find(mapPath);
+        const auto expected = MMM::BeatmapSummary::fromBeatMap(
+            MMM::BeatMap::loadFromFile(mapPath));
+        if ( !indexed || !(*indexed == expected) ) {
+            XERROR("Indexed summary differs for {}", mapPath.string());
+            return false;
+        }
+        if ( indexed->noteCount == 0 ||
+             indexed->maxCombo < indexed->noteCount ||
+             indexed->durationMs <= 0.0 || indexed->maxBpm <= 0.0 ) {
+            XERROR("Implausible summary for {}: notes={} combo={} "
+                   "duration={} bpm={}",
+                   mapPath.string(),
+                   indexed->noteCount,
+                   indexed->maxCombo,
+                   indexed->durationMs,
+                   indexed->maxBpm);
+            return false;
+        }
+    }
+    return true;
+}
+
+}  // namespace
+
+int main(int argc, char* argv[])
+{
+    if ( argc < 3 ) {
+        XERROR("Usage: BeatmapIndexTest <output_dir> <fixture>...");
+        return 1;
+    }
+
+    const fs::path  projectRoot = fs::path(argv[1]) / "project";
+    std::error_code ec;
+    fs::remove_all(projectRoot, ec);
+    fs::create_directories(projectRoot / "charts", ec);
+
+    std::vector<fs::path> mapPaths;
+    for ( int i = 2; i < argc; ++i ) {
+        const fs::path input  = argv[i];
+        const fs::path target = projectRoot / "charts" / input.filename();
+        fs::copy_file(input, target, fs::copy_options::overwrite_existing, ec);
+        if ( ec ) {
+            XERROR("Failed to copy fixture: {}", ec.message());
+            return 1;
+        }
+        mapPaths.push_back(target);
+    }
+    MMM::Test::SyntheticBeatmapSpec spec;
+    spec.noteCount     = 400;
+    spec.holdCount     = 100;
+    spec.polylineCount = 20;
+    const fs::path nativePath = projectRoot / "native.mmm";
+    if ( !MMM::Test::makeSyntheticBeatMap(spec).saveToFile(nativePath) ) {
+        XERROR("Failed to save synthetic map");
+        return 1;
+    }
+    mapPaths.push_back(nativePath);
+
+    const fs::path    indexFile = projectRoot / ".mmm" / "beatmap_index.json";
+    const std::size_t mapCount  = mapPaths.size();
+
+    // 冷启动：全部重建并写回。
+    {
+        MMM::BeatmapIndex index(projectRoot, indexFile);
+        if ( index.load() || index.isReady() ) {
+            XERROR("Missing index file was reported as loaded");
+            return 1;
+        }
+        MMM::BeatmapIndexStatistics statistics;
+        {
+            ThreadExecutor executor;
+            statistics = index.refresh(mapPaths, 4);
+        }
+        if ( !expectStatistics("cold", statistics, 0, mapCount, 0) ||
+             !index.isReady() || !verifySummaries(index, mapPaths) ||
+             !index.save() ) {
+            return 1;
+        }
+        if ( index.entryKey(nativePath) != "native.mmm" ||
+             index.entryKey("charts/../native.mmm") != "native.mmm" ) {
+            XERROR("Unexpected entry key: {}", index.entryKey(nativePath));
+            return 1;
+        }
+    }
+
+    // 重新打开：全部复用，只修改时间变化的文件按内容哈希复用。
+    fs::last_write_time(mapPaths.front(),
+                        fs::last_write_time(mapPaths.front()) +
+                            std::chrono::hours(1));
+    {
+        MMM::BeatmapIndex index(projectRoot, indexFile);
+        if ( !index.load() || index.size() != mapCount ||
+             !expectStatistics(
+                 "warm", index.refresh(mapPaths), mapCount, 0, 0) ||
+             !index.isDirty() || !index.save() ) {
+            return 1;
+        }
+    }
+
+    // 内容变化只重建对应条目；移出项目的谱面删除条目。
+    {
+        std::ofstream append(mapPaths.front(),
+                             std::ios::binary | std::ios::app);
+        append << "\n";
+    }
+    std::vector<fs::path> remaining(mapPaths.begin(), mapPaths.end() - 1);
+    {
+        MMM::BeatmapIndex index(projectRoot, indexFile);
+        index.load();
+        if ( !expectStatistics("incremental",
+                               index.refresh(remaining),
+                               mapCount - 2,
+                               1,
+                               1) ||
+             !verifySummaries(index, remaining) || !index.save() ) {
+            return 1;
+        }
+    }
+
+    // 保存后按写出的文件重建条目。
+    {
+        MMM::BeatmapIndex index(projectRoot, indexFile);
+        index.load();
+        spec.noteCount = 600;
+        spec.seed      = 0x5eed;
+        if ( !MMM::Test::makeSyntheticBeatMap(spec).saveToFile(nativePath) ) {
+            XERROR("Failed to save edited map");
+            return 1;
+        }
+        MMM::BeatMap edited = MMM::BeatMap::loadFromFile(nativePath);
+        edited.m_baseMapMetadata.version = "Edited";
+        if ( !edited.saveToFile(nativePath) || !index.reload("native.mmm") ) {
+            XERROR("Failed to update edited map");
+            return 1;
+        }
+        const auto updated  = index.find(nativePath);
+        const auto reloaded = MMM::BeatmapSummary::fromBeatMap(
+            MMM::BeatMap::loadFromFile(nativePath));
+        if ( !updated || updated->version != "Edited" ||
+             !(*updated == reloaded) ) {
+            XERROR("Updated entry does not match the saved map");
+            return 1;
+        }
+    }
+
+    // 损坏的索引文件被丢弃。
+    {
+        std::ofstream corrupt(indexFile, std::ios::binary | std::ios::trunc);
+        corrupt << "{\"format_version\":1,\"beatmaps\":{\"x\":{}}}";
+    }
+    {
+        MMM::BeatmapIndex index(projectRoot, indexFile);
+        if ( index.load() || index.size() != 0 ) {
+            XERROR("Corrupted index was accepted");
+            return 1;
+        }
+    }
+
+    XINFO("Beatmap index test PASSED");
+    return 0;
+}
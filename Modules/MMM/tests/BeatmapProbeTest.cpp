@@ -0,0 +1,87 @@
+#include "log/colorful-log.h"
+#include "mmm/beatmap/BeatMap.h"
+#include <filesystem>
+#include <string>
+
+namespace fs = std::filesystem;
+
+namespace
+{
+
+/// @brief 比较头部探测与完整加载共同提供的一个字段。
+template<typename T>
+bool sameField(const char* field, const T& probed, const T& loaded)
+{
+    if ( probed == loaded ) return true;
+    XERROR("Probed header differs in {}", field);
+    return false;
+}
+
+/// @brief 头部探测不解析物件，且显示与排序用到的字段与完整加载一致。
+bool verifyProbe(const fs::path& input)
+{
+    const MMM::BeatMap loaded = MMM::BeatMap::loadFromFile(input);
+    const MMM::BeatMap probed = MMM::BeatMap::probeHeader(input);
+    if ( loaded.m_allNotes.empty() ) {
+        XERROR("Fixture has no notes: {}", input.string());
+        return false;
+    }
+    if ( !probed.m_allNotes.empty() || !probed.m_timings.empty() ) {
+        XERROR("Header probe parsed notes or timings: {}", input.string());
+        return false;
+    }
+
+    const auto& lhs = probed.m_baseMapMetadata;
+    const auto& rhs = loaded.m_baseMapMetadata;
+    bool        ok  = sameField("title", lhs.title, rhs.title) &&
+             sameField("artist", lhs.artist, rhs.artist) &&
+             sameField("version", lhs.version, rhs.version) &&
+             sameField("author", lhs.author, rhs.author) &&
+             sameField("map_path", lhs.map_path, rhs.map_path) &&
+             sameField(
+                 "song_file_hint", lhs.song_file_hint, rhs.song_file_hint) &&
+             sameField("cover_path", lhs.cover_path, rhs.cover_path);
+    // imd 的轨道数由物件的最大轨道推导，Malody 坐标模式可能未声明轨道数，
+    // 这两种情况下头部中没有该信息，名称也随之不同。
+    if ( ok && input.extension() != ".imd" && lhs.track_count > 0 ) {
+        ok = sameField("track_count", lhs.track_count, rhs.track_count) &&
+             sameField("name", lhs.name, rhs.name);
+    }
+    if ( !ok ) XERROR("  while probing {}", input.string());
+    return ok;
+}
+
+}  // namespace
+
+int main(int argc, char* argv[])
+{
+    if ( argc < 3 ) {
+        XERROR("Usage: BeatmapProbeTest <output_dir> <fixture>...");
+        return 1;
+    }
+
+    const fs::path  outputDir = argv[1];
+    std::error_code ec;
+    fs::create_directories(outputDir, ec);
+
+    // 原生 .mmm 由首个 .mc 夹具转换得到，覆盖全部四种格式。
+    for ( int i = 2; i < argc; ++i ) {
+        const fs::path input = argv[i];
+        if ( !verifyProbe(input) ) return 1;
+        if ( input.extension() == ".mc" ) {
+            const fs::path native = outputDir / "native.mmm";
+            if ( !MMM::BeatMap::loadFromFile(input).saveToFile(native) ||
+                 !verifyProbe(native) ) {
+                return 1;
+            }
+        }
+    }
+
+    if ( !MMM::BeatMap::probeHeader(outputDir / "missing.osu")
+              .m_allNotes.empty() ) {
+        return 1;
+    }
+
+    XINFO("Beatmap probe test PASSED");
+    return 0;
+}
@@ -0,0 +1,202 @@
+#include "BenchmarkSupport.h"
+#include <atomic>
+#include <cstdint>
+#include <cstdlib>
+#include <new>
+
+/**
+ * 替换全局 operator new/delete 的全部可替换形式（普通、数组、nothrow、
+ * 带尺寸与对齐版本），统一经由 malloc/free 并记录分配次数与存活字节。
+ *
+ * 这些定义必须放在独立的翻译单元里：与调用方同一翻译单元时，GCC 会把
+ * 内联后的 free() 与 operator new 返回的指针配对检查，从而报出
+ * -Wmismatched-new-delete。
+ */
+
+namespace
+{
+
+std::atomic<std::size_t> g_allocationCount{ 0 };
+std::atomic<std::size_t> g_liveBytes{ 0 };
+std::atomic<std::size_t> g_peakBytes{ 0 };
+
+/// @brief 紧邻用户指针之前的分配头，记录原始块与请求大小。
+struct AllocationHeader {
+    void*       block;
+    std::size_t size;
+};
+
+void* allocate(std::size_t size, std::size_t alignment) noexcept
+{
+    if ( alignment < alignof(std::max_align_t) ) {
+        alignment = alignof(std::max_align_t);
+    }
+    // 头部之后向上对齐到 alignment；多申请 alignment 字节保证总能放下。
+    void* block = std::malloc(size + sizeof(AllocationHeader) + alignment);
+    if ( block == nullptr ) return nullptr;
+
+    auto address = reinterpret_cast<std::uintptr_t>(block) +
+                   sizeof(AllocationHeader);
+    address = (address + alignment - 1) & ~(std::uintptr_t(alignment) - 1);
+    auto* header = reinterpret_cast<AllocationHeader*>(address) - 1;
+    header->block = block;
+    header->size  = size;
+
+    g_allocationCount.fetch_add(1, std::memory_order_relaxed);
+    const std::size_t live =
+        g_liveBytes.fetch_add(size, std::memory_order_relaxed) + size;
+    std::size_t peak = g_peakBytes.load(std::memory_order_relaxed);
+    while ( live > peak &&
+            !g_peakBytes.compare_exchange_weak(
+                peak, live, std::memory_order_relaxed) ) {
+    }
+    return reinterpret_cast<void*>(address);
+}
+
+void* allocateOrThrow(std::size_t size, std::size_t alignment)
+{
+    void* pointer = allocate(size, alignment);
+    if ( pointer == nullptr ) throw std::bad_alloc();
+    return pointer;
+}
+
+void release(void* pointer) noexcept
+{
+    if ( pointer == nullptr ) return;
+    const auto* header = static_cast<AllocationHeader*>(pointer) - 1;
+    g_liveBytes.fetch_sub(header->size, std::memory_order_relaxed);
+    std::free(header->block);
+}
+
+}  // namespace
+
+namespace MMM::Test
+{
+
+std::size_t allocationCount()
+{
+    return g_allocationCount.load(std::memory_order_relaxed);
+}
+
+std::size_t liveHeapBytes()
+{
+    return g_liveBytes.load(std::memory_order_relaxed);
+}
+
+std::size_t peakHeapBytes()
+{
+    return g_peakBytes.load(std::memory_order_relaxed);
+}
+
+std::size_t resetHeapPeak()
+{
+    const std::size_t live = g_liveBytes.load(std::memory_order_relaxed);
+    g_peakBytes.store(live, std::memory_order_relaxed);
+    return live;
+}
+
+}  // namespace MMM::Test
+
+void* operator new(std::size_t size)
+{
+    return allocateOrThrow(size, 0);
+}
+
+void* operator new[](std::size_t size)
+{
+    return allocateOrThrow(size, 0);
+}
+
+void* operator new(std::size_t size, const std::nothrow_t&) noexcept
+{
+    return allocate(size, 0);
+}
+
+void* operator new[](std::size_t size, const std::nothrow_t&) noexcept
+{
+    return allocate(size, 0);
+}
+
+void* operator new(std::size_t size, std::align_val_t alignment)
+{
+    return allocateOrThrow(size, static_cast<std::size_t>(alignment));
+}
+
+void* operator new[](std::size_t size, std::align_val_t alignment)
+{
+    return allocateOrThrow(size, static_cast<std::size_t>(alignment));
+}
+
+void* operator new(std::size_t size, std::align_val_t alignment,
+                   const std::nothrow_t&) noexcept
+{
+    return allocate(size, static_cast<std::size_t>(alignment));
+}
+
+void* operator new[](std::size_t size, std::align_val_t alignment,
+                     const std::nothrow_t&) noexcept
+{
+    return allocate(size, static_cast<std::size_t>(alignment));
+}
+
+void operator delete(void* pointer) noexcept
+{
+    release(pointer);
+}
+
+void operator delete[](void* pointer) noexcept
+{
+    release(pointer);
+}
+
+void operator delete(void* pointer, const std::nothrow_t&) noexcept
+{
+    release(pointer);
+}
+
+void operator delete[](void* pointer, const std::nothrow_t&) noexcept
+{
+    release(pointer);
+}
+
+void operator delete(void* pointer, std::size_t) noexcept
+{
+    release(pointer);
+}
+
+void operator delete[](void* pointer, std::size_t) noexcept
+{
+    release(pointer);
+}
+
+void operator delete(void* pointer, std::align_val_t) noexcept
+{
+    release(pointer);
+}
+
+void operator delete[](void* pointer, std::align_val_t) noexcept
+{
+    release(pointer);
+}
+
+void operator delete(void* pointer, std::size_t, std::align_val_t) noexcept
+{
+    release(pointer);
+}
+
+void operator delete[](void* pointer, std::size_t, std::align_val_t) noexcept
+{
+    release(pointer);
+}
+
+void operator delete(void* pointer, std::align_val_t,
+                     const std::nothrow_t&) noexcept
+{
+    release(pointer);
+}
+
+void operator delete[](void* pointer, std::align_val_t,
+                       const std::nothrow_t&) noexcept
+{
+    release(pointer);
+}
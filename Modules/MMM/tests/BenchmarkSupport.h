@@ -0,0 +1,47 @@
+#pragma once
+
+#include <chrono>
+#include <cstddef>
+
+/**
+ * @brief MMM 基准程序共用的计时与堆分配统计。
+ *
+ * elapsedMs() 等计时工具只依赖本头文件。分配统计由 BenchmarkSupport.cpp
+ * 中替换的全局 operator new/delete 全集提供，只有需要分配数据的基准才把
+ * 该源文件加入可执行目标；未链接时调用下面的统计函数会产生链接错误。
+ */
+
+namespace MMM::Test
+{
+
+/// @brief 基准计时使用的单调时钟。
+using BenchmarkClock = std::chrono::steady_clock;
+
+/// @brief 从 begin 到现在经过的毫秒数。
+inline double elapsedMs(BenchmarkClock::time_point begin)
+{
+    return std::chrono::duration<double, std::milli>(BenchmarkClock::now() -
+                                                     begin)
+        .count();
+}
+
+/// @brief 字节数换算为 MiB。
+inline double toMiB(std::size_t bytes)
+{
+    return double(bytes) / 1048576.0;
+}
+
+/// @brief 进程启动以来的堆分配次数（含数组与对齐形式）。
+std::size_t allocationCount();
+
+/// @brief 当前存活的堆字节数。
+std::size_t liveHeapBytes();
+
+/// @brief 自上次 resetHeapPeak() 以来的存活字节高水位。
+std::size_t peakHeapBytes();
+
+/// @brief 把高水位重置为当前存活字节数，作为一个测量阶段的起点。
+/// @return 阶段开始时的存活字节数。
+std::size_t resetHeapPeak();
+
+}  // namespace MMM::Test
@@ -0,0 +1,152 @@
+#include "BenchmarkSupport.h"
+#include "SyntheticBeatmap.hpp"
+#include "log/colorful-log.h"
+#include "mmm/beatmap/BeatMap.h"
+#include <algorithm>
+#include <cstddef>
+#include <cstdlib>
+#include <filesystem>
+#include <fstream>
+#include <iterator>
+#include <nlohmann/json.hpp>
+#include <string>
+
+/**
+ * @brief Malody .mc 与原生 .mmm 谱面加载的耗时与堆峰值基准。
+ *
+ * 用法: JsonLoadBenchmark <output_dir> [note_count] [iterations]
+ * 先把合成谱面（普通物件、长条与折线混合）分别保存为 .mc 与 .mmm，
+ * 默认 250k 物件，.mc 约 50MB。随后重复加载，统计平均耗时与加载期间的
+ * 堆峰值；同时给出整份文件解析为 nlohmann DOM 时的堆峰值作为参照。
+ *
+ * 进程 RSS 峰值（ru_maxrss）无法在同一进程内按阶段重置，这里改用计数
+ * 分配器记录的堆高水位，每个阶段开始前把高水位重置为当前存活字节数。
+ */
+
+namespace fs = std::filesystem;
+
+namespace
+{
+
+using Clock = MMM::Test::BenchmarkClock;
+using MMM::Test::elapsedMs;
+using MMM::Test::liveHeapBytes;
+using MMM::Test::peakHeapBytes;
+using MMM::Test::resetHeapPeak;
+using MMM::Test::toMiB;
+
+}  // namespace
+
+/// @brief 加载并统计一种格式的谱面文件。
+/// @param chartPath 谱面文件路径。
+/// @param iterations 重复加载次数。
+/// @return 成功加载出物件时返回 true。
+bool runFormat(const fs::path& chartPath, std::size_t iterations)
+{
+    std::error_code ec;
+    const auto      fileBytes = fs::file_size(chartPath, ec);
+    if ( ec || fileBytes == 0 ) {
+        XERROR("Benchmark chart is empty: {}", chartPath.string());
+        return false;
+    }
+
+    // 1. 参照：整份文件读入后构建完整 DOM，即逐元素解析之前的内存形态。
+    std::size_t domPeak = 0;
+    {
+        const std::size_t base = resetHeapPeak();
+        std::ifstream     ifs(chartPath, std::ios::binary);
+        const std::string content((std::istreambuf_iterator<char>(ifs)),
+                                  std::istreambuf_iterator<char>());
+        const auto        document =
+            nlohmann::json::parse(content, nullptr, false, true);
+        if ( document.is_discarded() ) {
+            XERROR("Benchmark chart is not valid JSON: {}", chartPath.string());
+            return false;
+        }
+        domPeak = peakHeapBytes() - base;
+    }
+
+    // 2. 实际加载：统计耗时、加载期间堆峰值与加载结果的存活字节数。
+    double      totalMs     = 0.0;
+    std::size_t loadPeak    = 0;
+    std::size_t outputBytes = 0;
+    std::size_t loadedNotes = 0;
+    for ( std::size_t i = 0; i < iterations; ++i ) {
+        const std::size_t base  = resetHeapPeak();
+        const auto        begin = Clock::now();
+        MMM::BeatMap      beatMap = MMM::BeatMap::loadFromFile(chartPath);
+        totalMs += elapsedMs(begin);
+        loadPeak = std::max(loadPeak,
+                            peakHeapBytes() - base);
+        outputBytes = liveHeapBytes() - base;
+        loadedNotes = beatMap.m_allNotes.size();
+    }
+    if ( loadedNotes == 0 ) {
+        XERROR("No notes loaded from {}", chartPath.string());
+        return false;
+    }
+
+    const double averageMs = totalMs / double(iterations);
+    XINFO("  {}: file={:.1f}MiB notes={} average={:.2f}ms "
+          "throughput={:.1f}MB/s",
+          chartPath.extension().string(),
+          toMiB(fileBytes),
+          loadedNotes,
+          averageMs,
+          toMiB(fileBytes) / (averageMs / 1000.0));
+    XINFO("    heap peak: load={:.1f}MiB full-dom={:.1f}MiB "
+          "loaded-beatmap={:.1f}MiB",
+          toMiB(loadPeak),
+          toMiB(domPeak),
+          toMiB(outputBytes));
+    return true;
+}
+
+int main(int argc, char* argv[])
+{
+    if ( argc < 2 ) {
+        XERROR("Usage: JsonLoadBenchmark <output_dir> [note_count] "
+               "[iterations]");
+        return 1;
+    }
+
+    const fs::path    outputDir = argv[1];
+    const std::size_t noteCount =
+        argc > 2 ? std::strtoull(argv[2], nullptr, 10) : 250000;
+    const std::size_t iterations =
+        argc > 3 ? std::max<std::size_t>(1, std::strtoull(argv[3], nullptr, 10))
+                 : 3;
+
+    std::error_code ec;
+    fs::create_directories(outputDir, ec);
+
+    MMM::Test::SyntheticBeatmapSpec spec;
+    spec.noteCount           = noteCount * 7 / 10;
+    spec.holdCount           = noteCount * 2 / 10;
+    spec.polylineCount       = noteCount / 10 / 4;
+    spec.subNotesPerPolyline = 3;
+    spec.timingCount         = std::max<std::size_t>(1, noteCount / 100);
+    spec.annotationEvery     = 200;
+    spec.sampleBindingEvery  = 20;
+
+    const MMM::BeatMap beatMap = MMM::Test::makeSyntheticBeatMap(spec);
+    for ( const char* extension : { ".mc", ".mmm" } ) {
+        const fs::path chartPath =
+            outputDir / (std::string("json_load_benchmark") + extension);
+        if ( !beatMap.saveToFile(chartPath) ) {
+            XERROR("Failed to save benchmark chart: {}", chartPath.string());
+            return 1;
+        }
+    }
+
+    XINFO("JSON load benchmark: notes={} timings={} iterations={}",
+          beatMap.m_allNotes.size(),
+          spec.timingCount,
+          iterations);
+    for ( const char* extension : { ".mc", ".mmm" } ) {
+        const fs::path chartPath =
+            outputDir / (std::string("json_load_benchmark") + extension);
+        if ( !runFormat(chartPath, iterations) ) return 1;
+    }
+    return 0;
+}
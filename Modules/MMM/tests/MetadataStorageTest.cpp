@@ -0,0 +1,212 @@
+#include "mmm/Metadata.h"
+#include "log/colorful-log.h"
+
+#include <array>
+#include <cstdlib>
+#include <cstring>
+#include <sstream>
+#include <stdexcept>
+#include <string>
+#include <utility>
+#include <vector>
+
+namespace
+{
+
+/// @brief 旧版 get_value 的 istringstream 参考实现。
+template<typename T> bool referenceParse(const std::string& text, T& value)
+{
+    std::istringstream iss(text);
+    return static_cast<bool>(iss >> value);
+}
+
+/// @brief 验证同名键驻留为同一 id，空键固定为 0。
+/// @return 驻留语义正确时返回 true。
+bool testKeyInterning()
+{
+    const auto sample      = MMM::MetadataKey::intern("sample");
+    const auto sampleAgain = MMM::MetadataKey::intern(std::string("sample"));
+    const auto group       = MMM::MetadataKey::intern("samplegroup");
+    if ( sample != sampleAgain || sample.id() == 0 ||
+         sample.id() == group.id() || sample.name() != "sample" ) {
+        XERROR("Interned keys are not stable");
+        return false;
+    }
+    if ( MMM::MetadataKey::intern("").id() != 0 ||
+         MMM::MetadataKey{}.name() != "" ) {
+        XERROR("Empty key must map to id 0");
+        return false;
+    }
+    return true;
+}
+
+/// @brief 验证内联容量内不分配、溢出后保持插入顺序及删除行为。
+/// @return 小表布局行为正确时返回 true。
+bool testInlineAndSpill()
+{
+    MMM::MetadataProperties props;
+    props["a"] = "1";
+    props["b"] = "2";
+    props["c"] = "3";
+    props["d"] = "4";
+    if ( props.size() != 4 || props.heapBytes() != 0 ) {
+        XERROR("Four short properties must stay inline, heap={}",
+               props.heapBytes());
+        return false;
+    }
+
+    props["e"] = "5";
+    props["f"] = "6";
+    props.erase("b");
+    std::string order;
+    for ( const auto& [key, value] : props ) {
+        order += key + "=" + value + ";";
+    }
+    if ( order != "a=1;c=3;d=4;e=5;f=6;" || props.heapBytes() == 0 ) {
+        XERROR("Spilled properties lost insertion order: {}", order);
+        return false;
+    }
+
+    if ( props.try_emplace("a", "changed").second ||
+         props.at("a") != "1" || !props.emplace("g", "7").second ||
+         props.find("missing") != props.end() || !props.contains("g") ) {
+        XERROR("try_emplace/emplace/find semantics changed");
+        return false;
+    }
+    try {
+        static_cast<void>(std::as_const(props).at("missing"));
+        XERROR("at() must throw for missing keys");
+        return false;
+    } catch ( const std::out_of_range& ) {
+    }
+
+    for ( auto it = props.begin(); it != props.end(); ) {
+        it = it->key() == "c" || it->key() == "f" ? props.erase(it) : ++it;
+    }
+    if ( props.size() != 4 || props.contains("c") || props.contains("f") ) {
+        XERROR("Iterator erase removed wrong entries");
+        return false;
+    }
+    props.clear();
+    return props.empty() && props.heapBytes() == 0;
+}
+
+/// @brief 验证属性表与来源表的相等比较与插入顺序无关，且复制为深拷贝。
+/// @return 比较与复制语义正确时返回 true。
+bool testEqualityAndCopy()
+{
+    MMM::NoteMetadata lhs;
+    MMM::NoteMetadata rhs;
+    lhs.note_properties[MMM::NoteMetadataType::OSU]["x"] = "1";
+    lhs.note_properties[MMM::NoteMetadataType::OSU]["y"] = "2";
+    lhs.note_properties[MMM::NoteMetadataType::MMM]["z"] = "3";
+    rhs.note_properties[MMM::NoteMetadataType::MMM]["z"] = "3";
+    rhs.note_properties[MMM::NoteMetadataType::OSU]["y"] = "2";
+    rhs.note_properties[MMM::NoteMetadataType::OSU]["x"] = "1";
+    if ( !(lhs.note_properties == rhs.note_properties) ) {
+        XERROR("Equality must not depend on insertion order");
+        return false;
+    }
+
+    MMM::NoteMetadata copy = lhs;
+    copy.note_properties[MMM::NoteMetadataType::OSU]["x"] = "9";
+    if ( lhs.note_properties == copy.note_properties ||
+         lhs.note_properties.at(MMM::NoteMetadataType::OSU).at("x") != "1" ) {
+        XERROR("Copy must not share storage with the source");
+        return false;
+    }
+
+    // 来源表节点地址稳定：插入其他来源后既有引用仍然有效。
+    auto& osu = copy.note_properties[MMM::NoteMetadataType::OSU];
+    copy.note_properties[MMM::NoteMetadataType::MALODY]["w"] = "4";
+    copy.note_properties.erase(MMM::NoteMetadataType::MMM);
+    if ( osu.at("y") != "2" || copy.note_properties.size() != 2 ||
+         copy.note_properties.contains(MMM::NoteMetadataType::MMM) ) {
+        XERROR("Source table references were invalidated");
+        return false;
+    }
+    return true;
+}
+
+/// @brief 验证 get_value 与旧版 istringstream 结果逐位一致，缓存随写入失效。
+/// @return 所有样本解析一致时返回 true。
+bool testCachedValueParity()
+{
+    // 覆盖快速路径以及前导空白、正号、尾随字符、溢出等回落路径。
+    const std::vector<std::string> samples = {
+        "0",   "42",  "-17",  "+5",   " 12",  "12abc",       "3.75",
+        "-.5", "1e3", ".5",   "abc",  "",     "1e400",       "inf",
+        "0x1", "1",   "true", "-0.5", "1e-3", "99999999999", "-2147483649",
+    };
+
+    bool ok = true;
+    for ( const auto& text : samples ) {
+        MMM::NoteMetadata   note;
+        MMM::TimingMetadata timing;
+        note.note_properties[MMM::NoteMetadataType::OSU]["v"]       = text;
+        timing.timing_properties[MMM::TimingMetadataType::OSU]["v"] = text;
+
+        const auto check = [&](auto probe) {
+            using T             = decltype(probe);
+            T          expected = T{};
+            const bool parsedOk = referenceParse(text, expected);
+            // 连续两次读取分别覆盖解析路径和缓存命中路径。
+            for ( int pass = 0; pass < 2; ++pass ) {
+                const T noteValue = note.get_value<T>(
+                    MMM::NoteMetadataType::OSU, "v", T(7));
+                const T timingValue = timing.get_value<T>(
+                    MMM::TimingMetadataType::OSU, "v", T(7));
+                const T timingExpected = parsedOk ? expected : T(7);
+                if ( std::memcmp(&noteValue, &expected, sizeof(T)) != 0 ||
+                     std::memcmp(&timingValue, &timingExpected, sizeof(T)) !=
+                         0 ) {
+                    XERROR("get_value mismatch for '{}' (pass {})",
+                           text,
+                           pass);
+                    ok = false;
+                }
+            }
+        };
+        check(int{});
+        check(int64_t{});
+        check(uint32_t{});
+        check(double{});
+        check(float{});
+        check(bool{});
+    }
+
+    // 写入后缓存必须失效。
+    MMM::NoteMetadata note;
+    auto& props = note.note_properties[MMM::NoteMetadataType::MALODY];
+    props["vol"] = "80";
+    if ( note.get_value<int>(MMM::NoteMetadataType::MALODY, "vol") != 80 ) {
+        ok = false;
+    }
+    props["vol"] = "65";
+    if ( note.get_value<int>(MMM::NoteMetadataType::MALODY, "vol") != 65 ) {
+        XERROR("operator[] did not invalidate the cached value");
+        ok = false;
+    }
+    for ( auto& [key, value] : props ) {
+        value = "30";
+    }
+    if ( note.get_value<int>(MMM::NoteMetadataType::MALODY, "vol") != 30 ) {
+        XERROR("Mutable iteration did not invalidate the cached value");
+        ok = false;
+    }
+    if ( note.get_value<std::string>(MMM::NoteMetadataType::MALODY,
+                                     "vol") != "30" ) {
+        ok = false;
+    }
+    return ok;
+}
+
+}  // namespace
+
+int main()
+{
+    return testKeyInterning() && testInlineAndSpill() &&
+                   testEqualityAndCopy() && testCachedValueParity()
+               ? EXIT_SUCCESS
+               : EXIT_FAILURE;
+}
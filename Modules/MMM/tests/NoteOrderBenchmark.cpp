@@ -0,0 +1,121 @@
+#include "BenchmarkSupport.h"
+#include "SyntheticBeatmap.hpp"
+#include "log/colorful-log.h"
+#include "mmm/beatmap/BeatMap.h"
+#include "mmm/beatmap/NoteOrderIndex.h"
+#include <algorithm>
+#include <cstddef>
+#include <cstdlib>
+#include <vector>
+
+/**
+ * @brief 单物件编辑后整体 sync() 与增量维护引用表的耗时对比。
+ *
+ * 用法: NoteOrderBenchmark [note_count] [edit_count]
+ * 默认在 100k 物件的合成谱面上做 10k 次随机单物件改时。整体重建每次
+ * 都要重新排序整张谱面，只抽样前若干次编辑并按平均值外推；增量路径
+ * 执行全部编辑，最后与整体重建结果逐项比较排序键。
+ */
+
+namespace
+{
+
+using Clock = MMM::Test::BenchmarkClock;
+using MMM::Test::elapsedMs;
+
+/// @brief 整体重建路径最多抽样的编辑次数。
+constexpr std::size_t MAX_SYNC_SAMPLES = 200;
+
+/// @brief 一次随机编辑：物件下标与新时间戳。
+struct Edit {
+    std::size_t note{ 0 };
+    double      timestamp{ 0.0 };
+};
+
+}  // namespace
+
+int main(int argc, char* argv[])
+{
+    const std::size_t noteCount =
+        argc > 1 ? std::strtoull(argv[1], nullptr, 10) : 100000;
+    const std::size_t editCount =
+        argc > 2 ? std::strtoull(argv[2], nullptr, 10) : 10000;
+    if ( noteCount == 0 ) return 1;
+
+    MMM::Test::SyntheticBeatmapSpec spec;
+    spec.noteCount       = noteCount * 8 / 10;
+    spec.holdCount       = noteCount - spec.noteCount;
+    spec.osuNoteMetadata = false;
+    MMM::BeatMap beatMap = MMM::Test::makeSyntheticBeatMap(spec);
+
+    // 编辑序列对两条路径相同；只改普通物件，避免长条时长影响结果。
+    MMM::Test::SyntheticRandom random(0xed17ULL);
+    const double span = beatMap.m_allNotes.back().get().m_timestamp;
+    std::vector<Edit> edits(editCount);
+    for ( auto& edit : edits ) {
+        edit.note = random.below(
+            static_cast<uint32_t>(beatMap.m_noteData.notes.size()));
+        edit.timestamp =
+            static_cast<double>(random.below(static_cast<uint32_t>(span)));
+    }
+
+    // 1. 整体重建：改时间戳后调用 sync()。
+    MMM::BeatMap      rebuilt     = MMM::Test::makeSyntheticBeatMap(spec);
+    const std::size_t syncSamples = std::min(editCount, MAX_SYNC_SAMPLES);
+    const auto        syncBegin   = Clock::now();
+    for ( std::size_t i = 0; i < syncSamples; ++i ) {
+        rebuilt.m_noteData.notes[edits[i].note].m_timestamp =
+            edits[i].timestamp;
+        rebuilt.sync();
+    }
+    const double syncMs = elapsedMs(syncBegin);
+    const double syncPerEditUs =
+        syncSamples == 0 ? 0.0 : syncMs * 1000.0 / double(syncSamples);
+
+    // 2. 增量维护：retime() 只移动受影响分块内的引用。
+    const auto retimeBegin = Clock::now();
+    for ( const auto& edit : edits ) {
+        beatMap.m_allNotes.retime(beatMap.m_noteData.notes[edit.note],
+                                  edit.timestamp);
+    }
+    const double retimeMs = elapsedMs(retimeBegin);
+    const double retimePerEditUs =
+        editCount == 0 ? 0.0 : retimeMs * 1000.0 / double(editCount);
+
+    XINFO("NoteOrder benchmark: notes={} edits={} chunks={}",
+          beatMap.m_allNotes.size(),
+          editCount,
+          beatMap.m_allNotes.chunkCount());
+    XINFO("  full sync()  : {:.2f}us/edit ({} sampled, ~{:.0f}ms for all)",
+          syncPerEditUs,
+          syncSamples,
+          syncPerEditUs * double(editCount) / 1000.0);
+    XINFO("  retime()     : {:.2f}us/edit ({:.2f}ms total)",
+          retimePerEditUs,
+          retimeMs);
+    if ( retimePerEditUs > 0.0 ) {
+        XINFO("  speedup      : {:.1f}x", syncPerEditUs / retimePerEditUs);
+    }
+
+    // 3. 增量结果必须与对全部编辑做一次整体重建的结果同序。
+    for ( std::size_t i = syncSamples; i < editCount; ++i ) {
+        rebuilt.m_noteData.notes[edits[i].note].m_timestamp =
+            edits[i].timestamp;
+    }
+    rebuilt.sync();
+    if ( !beatMap.m_allNotes.isConsistent() ||
+         beatMap.m_allNotes.size() != rebuilt.m_allNotes.size() ||
+         !std::equal(beatMap.m_allNotes.begin(),
+                     beatMap.m_allNotes.end(),
+                     rebuilt.m_allNotes.begin(),
+                     [](const auto& a, const auto& b) {
+                         return !MMM::NoteOrderIndex::keyLess(a.get(),
+                                                              b.get()) &&
+                                !MMM::NoteOrderIndex::keyLess(b.get(),
+                                                              a.get());
+                     }) ) {
+        XERROR("Incremental order differs from full rebuild");
+        return 1;
+    }
+    return 0;
+}
@@ -0,0 +1,186 @@
+#include "SyntheticBeatmap.hpp"
+#include "log/colorful-log.h"
+#include "mmm/beatmap/BeatMap.h"
+#include "mmm/beatmap/NoteOrderIndex.h"
+#include <algorithm>
+#include <cstddef>
+#include <deque>
+#include <functional>
+#include <vector>
+
+namespace
+{
+
+/// @brief 两个物件的排序键相同。
+bool sameKey(const MMM::Note& lhs, const MMM::Note& rhs)
+{
+    return !MMM::NoteOrderIndex::keyLess(lhs, rhs) &&
+           !MMM::NoteOrderIndex::keyLess(rhs, lhs);
+}
+
+/// @brief 增量维护的引用表必须与整体重建结果逐项同键、同数量。
+bool verifyAgainstRebuild(const char*                    stage,
+                          const MMM::NoteOrderIndex&     index,
+                          const std::vector<MMM::Note*>& live)
+{
+    if ( !index.isConsistent() ) {
+        XERROR("{}: index invariants broken", stage);
+        return false;
+    }
+    std::vector<std::reference_wrapper<MMM::Note>> refs;
+    refs.reserve(live.size());
+    for ( auto* note : live ) refs.push_back(std::ref(*note));
+    MMM::NoteOrderIndex rebuilt;
+    rebuilt.assign(std::move(refs));
+
+    if ( rebuilt.size() != index.size() ) {
+        XERROR("{}: size {} vs rebuilt {}", stage, index.size(), rebuilt.size());
+        return false;
+    }
+    auto expected = rebuilt.begin();
+    for ( const auto& ref : index ) {
+        if ( !sameKey(ref.get(), expected->get()) ) {
+            XERROR("{}: order differs at {}",
+                   stage,
+                   expected - rebuilt.begin());
+            return false;
+        }
+        ++expected;
+    }
+    for ( std::size_t i = 0; i < index.size(); i += 97 ) {
+        if ( !sameKey(index[i].get(), rebuilt[i].get()) ||
+             &*(index.begin() + static_cast<std::ptrdiff_t>(i)) !=
+                 &index[i] ) {
+            XERROR("{}: random access differs at {}", stage, i);
+            return false;
+        }
+    }
+    return true;
+}
+
+/// @brief assign() 与 sync() 对合成谱面得到与稳定排序相同的顺序。
+bool verifySyncOrder()
+{
+    MMM::Test::SyntheticBeatmapSpec spec;
+    spec.noteCount     = 5000;
+    spec.holdCount     = 1500;
+    spec.polylineCount = 100;
+    MMM::BeatMap beatMap = MMM::Test::makeSyntheticBeatMap(spec);
+
+    std::vector<std::reference_wrapper<MMM::Note>> expected;
+    for ( auto& note : beatMap.m_noteData.notes ) expected.push_back(note);
+    for ( auto& hold : beatMap.m_noteData.holds ) {
+        if ( !hold.m_isSubNote ) expected.push_back(hold);
+    }
+    for ( auto& flick : beatMap.m_noteData.flicks ) {
+        if ( !flick.m_isSubNote ) expected.push_back(flick);
+    }
+    for ( auto& polyline : beatMap.m_noteData.polylines ) {
+        expected.push_back(polyline);
+    }
+    std::stable_sort(expected.begin(),
+                     expected.end(),
+                     [](const auto& a, const auto& b) {
+                         return MMM::NoteOrderIndex::keyLess(a.get(), b.get());
+                     });
+
+    if ( expected.size() != beatMap.m_allNotes.size() ||
+         !beatMap.m_allNotes.isConsistent() ||
+         !std::equal(expected.begin(),
+                     expected.end(),
+                     beatMap.m_allNotes.begin(),
+                     [](const auto& a, const auto& b) {
+                         return &a.get() == &b.get();
+                     }) ) {
+        XERROR("sync() order differs from stable sort");
+        return false;
+    }
+    return true;
+}
+
+/// @brief 随机插入、删除与改时后，引用表与整体重建保持一致。
+bool verifyRandomEdits()
+{
+    MMM::Test::SyntheticRandom random(0x0bdeULL);
+    std::deque<MMM::Note>      storage;
+    std::vector<MMM::Note*>    live;
+    MMM::NoteOrderIndex        index;
+
+    auto makeNote = [&]() -> MMM::Note& {
+        MMM::Note& note  = storage.emplace_back();
+        note.m_timestamp = static_cast<double>(random.below(20000)) * 0.5;
+        note.m_track     = random.below(7);
+        note.m_type      = random.below(4) == 0 ? MMM::NoteType::HOLD
+                                                : MMM::NoteType::NOTE;
+        return note;
+    };
+
+    // 逐个插入，覆盖分块拆分与大量相同键。
+    for ( int i = 0; i < 6000; ++i ) {
+        MMM::Note& note = makeNote();
+        auto       it   = index.insert(note);
+        if ( &it->get() != &note ) {
+            XERROR("insert() returned a different element");
+            return false;
+        }
+        live.push_back(&note);
+    }
+    if ( !verifyAgainstRebuild("insert", index, live) ) return false;
+
+    for ( int edit = 0; edit < 20000; ++edit ) {
+        const std::size_t pick =
+            random.below(static_cast<uint32_t>(live.size()));
+        switch ( random.below(3) ) {
+        case 0: {
+            MMM::Note& note = makeNote();
+            index.insert(note);
+            live.push_back(&note);
+            break;
+        }
+        case 1:
+            if ( !index.erase(*live[pick]) ) {
+                XERROR("erase() did not find a live note");
+                return false;
+            }
+            live[pick] = live.back();
+            live.pop_back();
+            break;
+        default:
+            if ( !index.retime(*live[pick],
+                               static_cast<double>(random.below(20000)) *
+                                   0.5) ) {
+                XERROR("retime() did not find a live note");
+                return false;
+            }
+            break;
+        }
+    }
+    if ( !verifyAgainstRebuild("edits", index, live) ) return false;
+
+    // 删空后分块全部释放。
+    for ( auto* note : live ) index.erase(*note);
+    live.clear();
+    if ( !index.empty() || index.chunkCount() != 0 ||
+         !verifyAgainstRebuild("drain", index, live) ) {
+        XERROR("Drained index is not empty");
+        return false;
+    }
+
+    // 不在表中的物件：erase 失败，retime 只修改时间戳。
+    MMM::Note stray;
+    if ( index.erase(stray) || index.retime(stray, 42.0) ||
+         stray.m_timestamp != 42.0 || !index.empty() ) {
+        XERROR("Stray note handling is wrong");
+        return false;
+    }
+    return true;
+}
+
+}  // namespace
+
+int main()
+{
+    if ( !verifySyncOrder() || !verifyRandomEdits() ) return 1;
+    XINFO("NoteOrderIndex test PASSED");
+    return 0;
+}
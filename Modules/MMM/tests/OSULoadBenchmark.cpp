@@ -0,0 +1,94 @@
+#include "BenchmarkSupport.h"
+#include "SyntheticBeatmap.hpp"
+#include "log/colorful-log.h"
+#include "mmm/beatmap/BeatMap.h"
+#include <algorithm>
+#include <cstddef>
+#include <cstdlib>
+#include <filesystem>
+#include <string>
+
+/**
+ * @brief osu! 谱面加载吞吐量基准。
+ *
+ * 用法: OSULoadBenchmark <output_dir> [note_count] [iterations]
+ * 先把合成谱面保存为 .osu 文件（默认 200k 物件，普通物件与长条混合），
+ * 再重复加载该文件，统计 MB/s、物件/s 与每行平均堆分配次数。
+ */
+
+namespace fs = std::filesystem;
+
+using Clock = MMM::Test::BenchmarkClock;
+using MMM::Test::allocationCount;
+using MMM::Test::elapsedMs;
+
+int main(int argc, char* argv[])
+{
+    if ( argc < 2 ) {
+        XERROR("Usage: OSULoadBenchmark <output_dir> [note_count] "
+               "[iterations]");
+        return 1;
+    }
+
+    const fs::path    outputDir = argv[1];
+    const std::size_t noteCount =
+        argc > 2 ? std::strtoull(argv[2], nullptr, 10) : 200000;
+    const std::size_t iterations =
+        argc > 3 ? std::max<std::size_t>(1, std::strtoull(argv[3], nullptr, 10))
+                 : 5;
+
+    std::error_code ec;
+    fs::create_directories(outputDir, ec);
+
+    // osu!mania 没有折线，只生成普通物件与长条。
+    MMM::Test::SyntheticBeatmapSpec spec;
+    spec.noteCount   = noteCount * 8 / 10;
+    spec.holdCount   = noteCount - spec.noteCount;
+    spec.timingCount = std::max<std::size_t>(1, noteCount / 100);
+    spec.trackCount  = 7;
+
+    const fs::path chartPath = outputDir / "osu_load_benchmark.osu";
+    if ( !MMM::Test::makeSyntheticBeatMap(spec).saveToFile(chartPath) ) {
+        XERROR("Failed to save benchmark chart: {}", chartPath.string());
+        return 1;
+    }
+    const auto fileBytes = fs::file_size(chartPath, ec);
+    if ( ec || fileBytes == 0 ) {
+        XERROR("Benchmark chart is empty: {}", chartPath.string());
+        return 1;
+    }
+
+    // 预热一次，排除首次打开文件与键驻留的开销。
+    std::size_t loadedNotes =
+        MMM::BeatMap::loadFromFile(chartPath).m_allNotes.size();
+    if ( loadedNotes != noteCount ) {
+        XERROR("Loaded {} notes, expected {}", loadedNotes, noteCount);
+        return 1;
+    }
+
+    double      totalMs          = 0.0;
+    std::size_t totalAllocations = 0;
+    for ( std::size_t i = 0; i < iterations; ++i ) {
+        const auto   allocationsBefore = allocationCount();
+        const auto   begin             = Clock::now();
+        MMM::BeatMap beatMap           = MMM::BeatMap::loadFromFile(chartPath);
+        totalMs += elapsedMs(begin);
+        totalAllocations += allocationCount() - allocationsBefore;
+        loadedNotes = beatMap.m_allNotes.size();
+    }
+
+    const double averageMs = totalMs / double(iterations);
+    const double lines     = double(noteCount + spec.timingCount);
+    XINFO("osu! load benchmark: file={}B notes={} timings={} iterations={}",
+          fileBytes,
+          loadedNotes,
+          spec.timingCount,
+          iterations);
+    XINFO("  average={:.2f}ms throughput={:.1f}MB/s {:.0f}notes/s "
+          "allocations/line={:.2f}",
+          averageMs,
+          double(fileBytes) / 1048576.0 / (averageMs / 1000.0),
+          double(loadedNotes) / (averageMs / 1000.0),
+          double(totalAllocations) / double(iterations) / lines);
+    return 0;
+}
@@ -0,0 +1,159 @@
+#include "BenchmarkSupport.h"
+#include "SyntheticBeatmap.hpp"
+#include "log/colorful-log.h"
+#include "mmm/ParallelExecutor.h"
+#include "mmm/beatmap/BeatMap.h"
+#include "runtime/AppThreadPool.h"
+#include <algorithm>
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <cstdlib>
+#include <filesystem>
+#include <fstream>
+#include <functional>
+#include <ice/thread/ThreadPool.hpp>
+#include <iterator>
+#include <string>
+#include <string_view>
+
+/**
+ * @brief 四种谱面格式的保存吞吐量基准。
+ *
+ * 用法: SaveBenchmark <output_dir> [note_count] [iterations]
+ * 合成谱面默认 200k 物件（普通物件与长条混合，不含各格式无法共同表达的
+ * 折线与采样绑定），依次重复保存为 .osu、.mc、.mmm 与 .imd，统计平均
+ * 耗时、MB/s、物件/s 与每个物件的平均堆分配次数。计时前先在未注入
+ * 并行执行器时串行保存一次，确认分片并行保存的输出与之逐字节一致。
+ */
+
+namespace fs = std::filesystem;
+
+using Clock = MMM::Test::BenchmarkClock;
+using MMM::Test::allocationCount;
+using MMM::Test::elapsedMs;
+
+namespace
+{
+
+/// @brief 读取文件全部内容。
+std::string readFileBytes(const fs::path& path)
+{
+    std::ifstream file(path, std::ios::binary);
+    return { std::istreambuf_iterator<char>(file),
+             std::istreambuf_iterator<char>() };
+}
+
+}  // namespace
+
+int main(int argc, char* argv[])
+{
+    if ( argc < 2 ) {
+        XERROR("Usage: SaveBenchmark <output_dir> [note_count] [iterations]");
+        return 1;
+    }
+
+    const fs::path    outputDir = argv[1];
+    const std::size_t noteCount =
+        argc > 2 ? std::strtoull(argv[2], nullptr, 10) : 200000;
+    const std::size_t iterations =
+        argc > 3 ? std::max<std::size_t>(1, std::strtoull(argv[3], nullptr, 10))
+                 : 5;
+
+    std::error_code ec;
+    fs::create_directories(outputDir, ec);
+
+    MMM::Test::SyntheticBeatmapSpec spec;
+    spec.noteCount   = noteCount * 8 / 10;
+    spec.holdCount   = noteCount - spec.noteCount;
+    spec.timingCount = std::max<std::size_t>(1, noteCount / 100);
+    spec.trackCount  = 7;
+    const MMM::BeatMap beatMap = MMM::Test::makeSyntheticBeatMap(spec);
+
+    constexpr std::array<std::string_view, 4> EXTENSIONS{
+        ".osu", ".mc", ".mmm", ".imd"
+    };
+    XINFO("Save benchmark: notes={} timings={} iterations={}",
+          beatMap.m_allNotes.size(),
+          spec.timingCount,
+          iterations);
+
+    // 串行基准输出：此时共享线程池尚未初始化，保存不分片。
+    for ( const std::string_view extension : EXTENSIONS ) {
+        fs::path serialPath = outputDir / "save_benchmark_serial";
+        serialPath += extension;
+        if ( !beatMap.saveToFile(serialPath) ) {
+            XERROR("Failed to save benchmark chart: {}", serialPath.string());
+            return 1;
+        }
+    }
+    // 与编辑器启动阶段相同，把共享线程池注入为谱面格式库的并行执行器。
+    auto& appThreadPool = MMM::Runtime::AppThreadPool::instance();
+    appThreadPool.init();
+    MMM::ParallelExecutor executor;
+    executor.submit = [&appThreadPool](std::function<void()> task) {
+        appThreadPool.get()->enqueue_void(std::move(task));
+    };
+    executor.concurrency = static_cast<std::size_t>(
+        std::max<std::int32_t>(1, appThreadPool.requestedWorkerCount()));
+    MMM::setParallelExecutor(std::move(executor));
+
+    for ( const std::string_view extension : EXTENSIONS ) {
+        fs::path chartPath = outputDir / "save_benchmark";
+        chartPath += extension;
+        fs::path serialPath = outputDir / "save_benchmark_serial";
+        serialPath += extension;
+
+        // 预热一次，同时确认分片保存与串行保存的输出一致。
+        if ( !beatMap.saveToFile(chartPath) ) {
+            XERROR("Failed to save benchmark chart: {}", chartPath.string());
+            return 1;
+        }
+        if ( readFileBytes(chartPath) != readFileBytes(serialPath) ) {
+            XERROR("Sharded save differs from serial save: {}",
+                   chartPath.string());
+            return 1;
+        }
+
+        double      totalMs          = 0.0;
+        std::size_t totalAllocations = 0;
+        for ( std::size_t i = 0; i < iterations; ++i ) {
+            const auto allocationsBefore = allocationCount();
+            const auto begin             = Clock::now();
+            if ( !beatMap.saveToFile(chartPath) ) {
+                XERROR("Save failed: {}", chartPath.string());
+                return 1;
+            }
+            totalMs += elapsedMs(begin);
+            totalAllocations += allocationCount() - allocationsBefore;
+        }
+
+        const auto fileBytes = fs::file_size(chartPath, ec);
+        if ( ec || fileBytes == 0 ) {
+            XERROR("Benchmark chart is empty: {}", chartPath.string());
+            return 1;
+        }
+
+        // 原子替换不得留下临时文件。
+        for ( const auto& entry : fs::directory_iterator(outputDir) ) {
+            if ( entry.path().extension() == ".tmp" ) {
+                XERROR("Leftover temporary file: {}", entry.path().string());
+                return 1;
+            }
+        }
+
+        const double averageMs = std::max(totalMs / double(iterations), 1e-6);
+        XINFO("  {:<4} file={}B average={:.2f}ms throughput={:.1f}MB/s "
+              "{:.0f}notes/s allocations/note={:.2f}",
+              extension,
+              fileBytes,
+              averageMs,
+              double(fileBytes) / 1048576.0 / (averageMs / 1000.0),
+              double(noteCount) / (averageMs / 1000.0),
+              double(totalAllocations) / double(iterations) /
+                  double(std::max<std::size_t>(1, noteCount)));
+    }
+    MMM::setParallelExecutor({});
+    appThreadPool.shutdown();
+    return 0;
+}
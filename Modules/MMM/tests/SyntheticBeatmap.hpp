@@ -0,0 +1,183 @@
+#pragma once
+
+#include "mmm/beatmap/BeatMap.h"
+#include <cstddef>
+#include <cstdint>
+#include <string>
+
+namespace MMM::Test
+{
+
+/// @brief 确定性合成谱面的规模参数。
+struct SyntheticBeatmapSpec {
+    /// @brief 普通物件数量。
+    std::size_t noteCount{ 0 };
+    /// @brief 长条物件数量。
+    std::size_t holdCount{ 0 };
+    /// @brief 折线物件数量。
+    std::size_t polylineCount{ 0 };
+    /// @brief 每条折线的子物件数量（Hold 与 Flick 交替）。
+    std::size_t subNotesPerPolyline{ 3 };
+    /// @brief 时间线数量；首条为 BPM，其余为 SV。
+    std::size_t timingCount{ 1 };
+    /// @brief 是否为每个顶层物件写入 osu! 风格音效元数据。
+    bool osuNoteMetadata{ true };
+    /// @brief 每多少个物件附带一条编辑器注释；0 表示不附带。
+    std::size_t annotationEvery{ 0 };
+    /// @brief 每多少个物件绑定一个命中采样；0 表示不绑定。
+    std::size_t sampleBindingEvery{ 0 };
+    /// @brief osu! 与 Malody 谱面级附加属性各写入的条数，用于模拟重元数据。
+    std::size_t mapPropertyCount{ 0 };
+    /// @brief 主轨道数量。
+    int32_t trackCount{ 7 };
+    /// @brief 随机种子。
+    uint64_t seed{ 0x4D4D4DULL };
+};
+
+/// @brief 跨平台稳定的 SplitMix64 伪随机数，避免标准分布实现差异。
+class SyntheticRandom
+{
+public:
+    explicit SyntheticRandom(uint64_t seed) : m_state(seed) {}
+
+    /// @brief 生成下一个 64 位随机数。
+    uint64_t next()
+    {
+        uint64_t z = (m_state += 0x9E3779B97F4A7C15ULL);
+        z          = (z ^ (z >> 30U)) * 0xBF58476D1CE4E5B9ULL;
+        z          = (z ^ (z >> 27U)) * 0x94D049BB133111EBULL;
+        return z ^ (z >> 31U);
+    }
+
+    /// @brief 生成 [0, bound) 内的整数。
+    uint32_t below(uint32_t bound)
+    {
+        return bound == 0 ? 0 : static_cast<uint32_t>(next() % bound);
+    }
+
+private:
+    uint64_t m_state;
+};
+
+/// @brief 写入合成物件共享的冷字段。
+inline void decorateSyntheticNote(Note& note, std::size_t ordinal,
+                                  const SyntheticBeatmapSpec& spec)
+{
+    if ( spec.osuNoteMetadata ) {
+        auto& props = note.m_metadata.note_properties[NoteMetadataType::OSU];
+        props["sample"]      = "0";
+        props["samplegroup"] = "0:0:0:0:";
+    }
+    if ( spec.annotationEvery != 0 && ordinal % spec.annotationEvery == 0 ) {
+        note.m_annotation = "synthetic annotation #" + std::to_string(ordinal);
+    }
+    if ( spec.sampleBindingEvery != 0 &&
+         ordinal % spec.sampleBindingEvery == 0 ) {
+        note.setSampleBinding(AudioSampleBinding{
+            "keysound_" + std::to_string(ordinal % 64U) + ".wav", 0.8F });
+    }
+}
+
+/**
+ * @brief 按规模参数生成确定性谱面。
+ * @param spec 规模参数。
+ * @return 已调用 sync() 的谱面。
+ */
+inline BeatMap makeSyntheticBeatMap(const SyntheticBeatmapSpec& spec)
+{
+    BeatMap         beatMap;
+    SyntheticRandom random(spec.seed);
+
+    beatMap.m_baseMapMetadata.name           = "Synthetic";
+    beatMap.m_baseMapMetadata.title          = "Synthetic";
+    beatMap.m_baseMapMetadata.artist         = "MMM";
+    beatMap.m_baseMapMetadata.version        = "Synthetic";
+    beatMap.m_baseMapMetadata.track_count    = spec.trackCount;
+    beatMap.m_baseMapMetadata.preference_bpm = 180.0;
+
+    for ( std::size_t i = 0; i < spec.mapPropertyCount; ++i ) {
+        const std::string key   = "SyntheticProperty" + std::to_string(i);
+        const std::string value = "synthetic metadata value #" +
+                                  std::to_string(random.next()) +
+                                  " with a long free-form description";
+        beatMap.m_metadata.map_properties[MapMetadataType::OSU][key] = value;
+        beatMap.m_metadata.map_properties[MapMetadataType::MALODY][key] =
+            value;
+    }
+    if ( spec.mapPropertyCount != 0 ) {
+        beatMap.m_baseMapMetadata.title_unicode  = "合成谱面 · Synthetic";
+        beatMap.m_baseMapMetadata.artist_unicode = "合成艺术家 · MMM";
+        beatMap.m_baseMapMetadata.author         = "Synthetic Mapper";
+    }
+
+    const auto   tracks     = static_cast<uint32_t>(spec.trackCount);
+    const double beatLength = 60000.0 / 180.0;
+    const double step       = beatLength / 4.0;
+
+    for ( std::size_t i = 0; i < spec.timingCount; ++i ) {
+        Timing& timing       = beatMap.m_timings.emplace_back();
+        timing.m_timestamp   = static_cast<double>(i) * step * 8.0;
+        timing.m_bpm         = 180.0;
+        timing.m_beat_length = beatLength;
+        if ( i == 0 ) {
+            timing.m_timingEffect          = TimingEffect::BPM;
+            timing.m_timingEffectParameter = 180.0;
+        } else {
+            timing.m_timingEffect = TimingEffect::SCROLL;
+            timing.m_timingEffectParameter =
+                0.5 + static_cast<double>(random.below(150)) / 100.0;
+        }
+    }
+
+    std::size_t ordinal = 0;
+    for ( std::size_t i = 0; i < spec.noteCount; ++i, ++ordinal ) {
+        Note& note       = beatMap.m_noteData.notes.emplace_back();
+        note.m_timestamp = static_cast<double>(i) * step;
+        note.m_track     = random.below(tracks);
+        decorateSyntheticNote(note, ordinal, spec);
+    }
+    for ( std::size_t i = 0; i < spec.holdCount; ++i, ++ordinal ) {
+        Hold& hold       = beatMap.m_noteData.holds.emplace_back();
+        hold.m_timestamp = static_cast<double>(i) * step * 2.0 + step / 2.0;
+        hold.m_track     = random.below(tracks);
+        hold.m_duration  = step * static_cast<double>(1 + random.below(8));
+        decorateSyntheticNote(hold, ordinal, spec);
+    }
+    for ( std::size_t i = 0; i < spec.polylineCount; ++i, ++ordinal ) {
+        Polyline& polyline = beatMap.m_noteData.polylines.emplace_back();
+        double    cursor   = static_cast<double>(i) * step * 16.0;
+        uint32_t  track    = random.below(tracks);
+        for ( std::size_t sub = 0; sub < spec.subNotesPerPolyline; ++sub ) {
+            if ( sub % 2 == 0 ) {
+                Hold& hold       = beatMap.m_noteData.holds.emplace_back();
+                hold.m_timestamp = cursor;
+                hold.m_track     = track;
+                hold.m_duration  = step * 2.0;
+                hold.m_isSubNote = true;
+                cursor += hold.m_duration;
+                polyline.m_subNotes.push_back(std::ref<Note>(hold));
+                polyline.m_subHolds.push_back(std::ref(hold));
+            } else {
+                Flick& flick      = beatMap.m_noteData.flicks.emplace_back();
+                flick.m_timestamp = cursor;
+                flick.m_track     = track;
+                flick.m_dtrack    = track + 1 < tracks ? 1 : -1;
+                flick.m_isSubNote = true;
+                track             = track + flick.m_dtrack;
+                polyline.m_subNotes.push_back(std::ref<Note>(flick));
+                polyline.m_subFlicks.push_back(std::ref(flick));
+            }
+        }
+        if ( !polyline.m_subNotes.empty() ) {
+            const Note& head     = polyline.m_subNotes.front().get();
+            polyline.m_timestamp = head.m_timestamp;
+            polyline.m_track     = head.m_track;
+        }
+        decorateSyntheticNote(polyline, ordinal, spec);
+    }
+
+    beatMap.sync();
+    return beatMap;
+}
+
+}  // namespace MMM::Test
@@ -149,11 +149,8 @@ std::expected<Json, BeatmapDocumentError> decodeDocumentPayload(
     return document;
 }
 
-template<typename Enum>
-Json encodePropertyMap(
-    const std::unordered_map<
-        Enum, std::unordered_map<std::string, std::string, ::MMM::StringHash,
-                                 std::equal_to<>>>& properties)
+template<typename PropertyMap>
+Json encodePropertyMap(const PropertyMap& properties)
 {
     Json result = Json::array();
     for ( const auto& [source, values] : properties ) {
@@ -169,13 +166,10 @@ Json encodePropertyMap(
     return result;
 }
 
-template<typename Enum>
-bool decodePropertyMap(
-    const Json& source,
-    std::unordered_map<
-        Enum, std::unordered_map<std::string, std::string, ::MMM::StringHash,
-                                 std::equal_to<>>>& properties)
+template<typename PropertyMap>
+bool decodePropertyMap(const Json& source, PropertyMap& properties)
 {
+    using Enum = typename PropertyMap::key_type;
     if ( !source.is_array() ) return false;
     properties.clear();
     for ( const auto& entry : source ) {
@@ -340,12 +334,9 @@ void mixFingerprint(ObjectFingerprint& fingerprint, std::string_view value)
 }
 
 /// @brief 把无序属性表以顺序无关方式混入物件指纹。
-template<typename Enum>
-void mixPropertyMapFingerprint(
-    ObjectFingerprint& fingerprint,
-    const std::unordered_map<
-        Enum, std::unordered_map<std::string, std::string, ::MMM::StringHash,
-                                 std::equal_to<>>>& properties)
+template<typename PropertyMap>
+void mixPropertyMapFingerprint(ObjectFingerprint& fingerprint,
+                               const PropertyMap& properties)
 {
     std::uint64_t aggregateFirst  = 0;
     std::uint64_t aggregateSecond = 0;
@@ -22,6 +22,7 @@ return {
 	["ui.exit.confirm_msg_fmt"] = "Beatmap '{}' has unsaved changes.\nDo you want to save before exiting?",
 	["ui.exit.dont_save"] = "Don't Save",
 	["ui.menu.frame_stats_fmt"] = "FT: {:.2f} ms | FPS: {:.1f} | UPS: {:.1f}",
+	["ui.menu.command_stats_fmt"] = "Commands per tick (peak): {} queued | {} coalesced | {} applied",
 
 	["ui.edit"] = "&Edit",
 	["ui.edit.undo"] = "Undo",
@@ -248,6 +249,7 @@ return {
 	["ui.settings.software.picker_native"] = "Native File Picker",
 	["ui.settings.software.picker_unified"] = "Unified File Picker",
 	["ui.settings.software.recent_limit"] = "Recent Projects Limit",
+	["ui.settings.software.undo_memory_budget"] = "Undo History Memory Budget",
 	["ui.settings.software.sync"] = "Sync & Clock",
 	["ui.settings.software.sync_mode"] = "Audio Sync Mode",
 	["ui.settings.software.sync_mode.none"] = "None",
@@ -1017,8 +1019,7 @@ return {
 	["ui.tools.overlap_jump_header"] = "Jump To",
 	["ui.tools.no_active_session"] = "No active session loaded",
 	["ui.tools.no_active_beatmap"] = "No active beatmap loaded",
-	["ui.tools.scan_now"] = "Scan Now",
-	["ui.tools.rescan"] = "Rescan",
+	["ui.tools.overlap_scanning"] = "Updating results in the background...",
 	["ui.tools.scan_summary"] = "Found {} definite overlaps (red), {} suspected overlaps (orange)",
 	["ui.tools.no_overlaps"] = "No overlapping notes found! The beatmap is clean.",
 	["ui.tools.definite"] = "Definite",
@@ -1185,6 +1186,8 @@ return {
 	["ui.status.mouse_time"] = "Mouse",
 	["ui.status.max_combo"] = "Max Combo",
 	["ui.status.note_count"] = "Objects",
+	["ui.status.undo_memory"] = "Undo",
+	["ui.status.undo_history_lost"] = "Undo history unavailable; older steps were discarded",
 	["ui.status.project_loading.validating"] = "Validating project",
 	["ui.status.project_loading.extracting_package"] = "Extracting package",
 	["ui.status.project_loading.closing_current_project"] = "Closing current project",
@@ -22,6 +22,7 @@ return {
 	["ui.exit.confirm_msg_fmt"] = "谱面 '{}' 尚有未保存的修改。\n您想在退出前保存吗？",
 	["ui.exit.dont_save"] = "不保存",
 	["ui.menu.frame_stats_fmt"] = "ft: {:.2f} ms | fps: {:.1f} | ups: {:.1f}",
+	["ui.menu.command_stats_fmt"] = "单 tick 命令峰值：入队 {} | 合并 {} | 执行 {}",
 	["ui.edit"] = "编辑(&E)",
 	["ui.edit.undo"] = "撤销",
 	["ui.edit.redo"] = "重做",
@@ -247,6 +248,7 @@ return {
 	["ui.settings.software.picker_native"] = "系统原生选择器",
 	["ui.settings.software.picker_unified"] = "编辑器统一选择器",
 	["ui.settings.software.recent_limit"] = "最近项目显示上限",
+	["ui.settings.software.undo_memory_budget"] = "撤销历史内存预算",
 	["ui.settings.software.sync"] = "同步与时钟",
 	["ui.settings.software.sync_mode"] = "音频同步模式",
 	["ui.settings.software.sync_mode.none"] = "无 (None)",
@@ -1016,8 +1018,7 @@ return {
 	["ui.tools.overlap_jump_header"] = "跳转至",
 	["ui.tools.no_active_session"] = "当前未加载任何谱面项目",
 	["ui.tools.no_active_beatmap"] = "当前未加载任何谱面",
-	["ui.tools.scan_now"] = "开始检测",
-	["ui.tools.rescan"] = "重新检测",
+	["ui.tools.overlap_scanning"] = "正在后台更新检测结果…",
 	["ui.tools.scan_summary"] = "检测到 {} 个确定重叠 (红色)，{} 个疑似重叠 (橙色)",
 	["ui.tools.no_overlaps"] = "未发现任何重叠物件！谱面很干净。",
 	["ui.tools.definite"] = "确定重叠",
@@ -1184,6 +1185,8 @@ return {
 	["ui.status.mouse_time"] = "鼠标",
 	["ui.status.max_combo"] = "最大连击数",
 	["ui.status.note_count"] = "物件数",
+	["ui.status.undo_memory"] = "撤销历史",
+	["ui.status.undo_history_lost"] = "撤销历史已损坏，已丢弃更早的步骤",
 	["ui.status.project_loading.validating"] = "正在校验项目",
 	["ui.status.project_loading.extracting_package"] = "正在解压谱面包",
 	["ui.status.project_loading.closing_current_project"] = "正在关闭当前项目",
@@ -0,0 +1,153 @@
+#!/usr/bin/env bash
+set -euo pipefail
+
+showUsage() {
+    cat <<'EOF'
+Usage: scripts/ci/cross/aarch64-mix-kernels-check.sh [options]
+
+Cross-compile the audio mix kernel test for aarch64 Linux so the NEON path is
+built on every CI run, then execute it under qemu when an emulator is present.
+The test only depends on Modules/Audio/src/AudioMixKernels.h. When the aarch64
+compiler is missing the check is skipped with a warning, so runners without
+the cross toolchain still reach the native builds.
+
+Options:
+  --cxx <path>            aarch64 C++ compiler. Default: aarch64-linux-gnu-g++
+  --qemu <path>           aarch64 user-mode emulator. Default: qemu-aarch64-static,
+                          then qemu-aarch64
+  --build-dir <path>      Output directory. Default: build_cross_aarch64_kernels
+  --require-compiler      Fail when the aarch64 compiler is missing instead of
+                          skipping the check
+  --require-run           Fail when no emulator is available instead of only
+                          compiling
+  -h, --help              Show this help
+
+Environment overrides:
+  AARCH64_CXX             Default aarch64 C++ compiler
+  AARCH64_QEMU            Default aarch64 emulator
+EOF
+}
+
+requireCompiler() {
+    local commandName="$1"
+
+    if command -v "${commandName}" >/dev/null 2>&1; then
+        return
+    fi
+    if (( requireCompiler )); then
+        printf "error: required command not found: %s\n" "${commandName}" >&2
+        printf "hint: install g++-aarch64-linux-gnu (and qemu-user-static to run the test)\n" >&2
+        exit 1
+    fi
+    printf "warning: aarch64 compiler not found (%s); skipping NEON mix kernel check\n" "${commandName}" >&2
+    printf "hint: install g++-aarch64-linux-gnu (and qemu-user-static to run the test)\n" >&2
+    exit 0
+}
+
+projectPath() {
+    local inputPath="$1"
+
+    if [[ "${inputPath}" = /* ]]; then
+        printf "%s\n" "${inputPath}"
+    else
+        printf "%s/%s\n" "${projectRoot}" "${inputPath}"
+    fi
+}
+
+scriptDir="$(cd "$(dirname "${BASH_SOURCE[0]}")" && pwd)"
+projectRoot="$(cd "${scriptDir}/../../.." && pwd)"
+
+cxxCompiler="${AARCH64_CXX:-aarch64-linux-gnu-g++}"
+qemuRunner="${AARCH64_QEMU:-}"
+buildDir="build_cross_aarch64_kernels"
+requireCompiler=0
+requireRun=0
+
+while (( $# > 0 )); do
+    case "$1" in
+        --cxx)
+            if (( $# < 2 )); then
+                printf "error: --cxx requires a value\n" >&2
+                exit 1
+            fi
+            cxxCompiler="$2"
+            shift 2
+            ;;
+        --qemu)
+            if (( $# < 2 )); then
+                printf "error: --qemu requires a value\n" >&2
+                exit 1
+            fi
+            qemuRunner="$2"
+            shift 2
+            ;;
+        --build-dir)
+            if (( $# < 2 )); then
+                printf "error: --build-dir requires a value\n" >&2
+                exit 1
+            fi
+            buildDir="$2"
+            shift 2
+            ;;
+        --require-compiler)
+            requireCompiler=1
+            shift
+            ;;
+        --require-run)
+            requireRun=1
+            shift
+            ;;
+        -h|--help)
+            showUsage
+            exit 0
+            ;;
+        *)
+            printf "error: unknown option: %s\n" "$1" >&2
+            showUsage >&2
+            exit 1
+            ;;
+    esac
+done
+
+requireCompiler "${cxxCompiler}"
+
+if [[ -z "${qemuRunner}" ]]; then
+    for candidate in qemu-aarch64-static qemu-aarch64; do
+        if command -v "${candidate}" >/dev/null 2>&1; then
+            qemuRunner="${candidate}"
+            break
+        fi
+    done
+fi
+
+buildDir="$(projectPath "${buildDir}")"
+mkdir -p "${buildDir}"
+testBinary="${buildDir}/AudioMixKernelsTest"
+
+# 静态链接，qemu 运行时无需 aarch64 sysroot。
+"${cxxCompiler}" \
+    -std=c++23 -O2 -Wall -Wextra -Werror -static \
+    -I "${projectRoot}/Modules/Audio/src" \
+    "${projectRoot}/Modules/Audio/tests/AudioMixKernelsTest.cpp" \
+    -o "${testBinary}"
+
+# 预处理结果必须选中 NEON 路径，防止宏条件变化后悄悄退回标量实现。
+if ! printf '#include "AudioMixKernels.h"\n#ifndef MMM_AUDIO_MIX_NEON\n#error NEON path not selected\n#endif\n' \
+    | "${cxxCompiler}" -std=c++23 -fsyntax-only -x c++ \
+        -I "${projectRoot}/Modules/Audio/src" -; then
+    printf "error: aarch64 build did not select the NEON mix kernels\n" >&2
+    exit 1
+fi
+printf "built NEON mix kernel test: %s\n" "${testBinary}"
+
+if [[ -z "${qemuRunner}" ]]; then
+    if (( requireRun )); then
+        printf "error: no aarch64 emulator found (qemu-aarch64-static or qemu-aarch64)\n" >&2
+        exit 1
+    fi
+    printf "warning: no aarch64 emulator found; compiled without running\n" >&2
+    exit 0
+fi
+
+"${qemuRunner}" "${testBinary}"
+printf "NEON mix kernel test passed under %s\n" "${qemuRunner}"